@@ -126,6 +126,12 @@ private:
     std::vector<CollisionVoxelsState>       m_voxels_states;
     std::vector<CollisionGroupState>        m_group_states;
 
+    // map from spheres/voxels state index to the index of the attachment link
+    // in the parent robot state, resolved once per model version so that
+    // per-sphere updates avoid repeated attached body lookups
+    std::vector<int>                        m_spheres_state_links;
+    std::vector<int>                        m_voxels_state_links;
+
     // version number to stay in sync with parent AttachedBodiesCollisionModel
     int m_version;
 
@@ -133,8 +139,6 @@ private:
 
     void reinitCollisionState() const;
     void reinitCollisionState();
-
-    int attachedBodyTransformVersion(int abidx) const;
 };
 
 typedef std::shared_ptr<AttachedBodiesCollisionState> AttachedBodiesCollisionStatePtr;
@@ -229,9 +233,9 @@ bool AttachedBodiesCollisionState::voxelsStateDirty(int vsidx) const
 {
     reinitCollisionState();
     ASSERT_VECTOR_RANGE(m_voxels_states, vsidx);
-    int abidx = m_voxels_states[vsidx].model->link_index;
-    int body_version = attachedBodyTransformVersion(abidx);
-    return attachedBodyTransformDirty(abidx) || m_voxels_state_versions[vsidx] != body_version;
+    const int lidx = m_voxels_state_links[vsidx];
+    const int body_version = m_state->linkTransformVersion(lidx);
+    return m_state->linkTransformDirty(lidx) || m_voxels_state_versions[vsidx] != body_version;
 }
 
 inline
@@ -284,9 +288,9 @@ bool AttachedBodiesCollisionState::sphereStateDirty(
     reinitCollisionState();
     ASSERT_VECTOR_RANGE(m_spheres_states, sidx.ss);
     const CollisionSpheresState& spheres_state = m_spheres_states[sidx.ss];
-    const int bidx = spheres_state.model->link_index;
-    int body_version = attachedBodyTransformVersion(bidx);
-    return attachedBodyTransformDirty(bidx) || spheres_state.spheres[sidx.s].version != body_version;
+    const int lidx = m_spheres_state_links[sidx.ss];
+    const int body_version = m_state->linkTransformVersion(lidx);
+    return m_state->linkTransformDirty(lidx) || spheres_state.spheres[sidx.s].version != body_version;
 }
 
 inline
@@ -304,10 +308,26 @@ inline
 bool AttachedBodiesCollisionState::updateSphereStates(int ssidx)
 {
     reinitCollisionState();
+
+    // A grasped body is rigid in its attachment link's frame, so the link
+    // transform is resolved once and every stale sphere of the body is
+    // refreshed against it, rather than re-deriving the attachment transform
+    // per sphere.
+    CollisionSpheresState& spheres_state = m_spheres_states[ssidx];
+    const int lidx = m_spheres_state_links[ssidx];
+
+    m_state->updateLinkTransform(lidx);
+    const int body_version = m_state->linkTransformVersion(lidx);
+    const Eigen::Affine3d& T_model_body = m_state->linkTransform(lidx);
+
     bool updated = false;
-    const CollisionSpheresState& spheres_state = m_spheres_states[ssidx];
     for (size_t sidx = 0; sidx < spheres_state.spheres.size(); ++sidx) {
-        updated |= updateSphereState(SphereIndex(ssidx, sidx));
+        CollisionSphereState& sphere_state = spheres_state.spheres[sidx];
+        if (sphere_state.version != body_version) {
+            sphere_state.pos = T_model_body * sphere_state.model->center;
+            sphere_state.version = body_version;
+            updated = true;
+        }
     }
     return updated;
 }
@@ -415,13 +435,6 @@ void AttachedBodiesCollisionState::reinitCollisionState() const
     return mm->reinitCollisionState();
 }
 
-inline
-int AttachedBodiesCollisionState::attachedBodyTransformVersion(int abidx) const
-{
-    int lidx = m_model->attachedBodyLinkIndex(abidx);
-    return m_state->linkTransformVersion(lidx);
-}
-
 } // namespace collision
 } // namespace smpl
 
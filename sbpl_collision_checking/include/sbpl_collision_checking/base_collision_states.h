@@ -173,6 +173,31 @@ struct CollisionGroupState
 
 std::ostream& operator<<(std::ostream& o, const CollisionGroupState& cgs);
 
+/// \brief Structure-of-arrays mirror of the leaf spheres of a collision group
+///
+/// Sphere centers and radii are stored in contiguous parallel arrays so that
+/// batch proximity tests (distance field lookups, pairwise broadphase) can
+/// iterate over them without chasing sphere tree pointers and with
+/// vectorization-friendly access patterns. sphere_states maps each entry back
+/// to its originating sphere state. The positions are refreshed lazily from
+/// the owning collision state's link transform versions; versions records, per
+/// spheres state, the link transform version at the last refresh.
+struct CollisionGroupSphereArrays
+{
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> r;
+    std::vector<const CollisionSphereState*> sphere_states;
+
+    // per spheres state: first entry in the arrays and link transform version
+    // at the last position refresh (-1 = never refreshed)
+    std::vector<int> offsets;
+    std::vector<int> versions;
+
+    size_t size() const { return sphere_states.size(); }
+};
+
 inline
 int CollisionSphereState::index() const
 {
@@ -36,6 +36,7 @@
 // standard includes
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 // system includes
@@ -95,6 +96,147 @@ public:
 
     void setPadding(double padding);
 
+    /// \name Parallel Motion Validation
+    ///@{
+    /// Enable or disable parallel validation of interpolated motions. When
+    /// enabled, isStateToStateValid() fans interpolated waypoints across a
+    /// pool of workers, each owning a private copy of the robot collision
+    /// state and self collision model, and terminates early on the first
+    /// colliding waypoint. The occupancy grid is shared between workers and
+    /// is only read during checks. A \p num_threads value of 0 selects the
+    /// hardware concurrency.
+    void setParallelMotionValidation(bool enable, int num_threads = 0);
+    bool parallelMotionValidation() const { return m_parallel_motion_validation; }
+
+    /// Enable or disable clearance-adaptive validation of interpolated
+    /// motions. When enabled, isStateToStateValid() sweeps the waypoints in
+    /// order and skips the waypoints provably covered by the clearance of
+    /// the last validated one, so wide-open segments are validated with a
+    /// few checks while tight segments fall back to every waypoint. Takes
+    /// effect when parallel motion validation is disabled.
+    void setClearanceAdaptiveMotionValidation(bool enable);
+    bool clearanceAdaptiveMotionValidation() const
+    { return m_clearance_adaptive_motion_validation; }
+    ///@}
+
+    /// \name Deferred Collision Refinement
+    ///@{
+
+    /// Enable or disable two-tier state validation. When enabled,
+    /// isStateValid() validates states against only the voxel checks --
+    /// robot and attached body spheres against the occupancy grid -- and
+    /// records accepted states whose clearance falls within
+    /// \p borderline_dist into a refinement queue. The sphere-model self
+    /// collision tests are skipped during search, so call
+    /// processRefinementQueue() to re-validate the recorded states with full
+    /// checks before committing a path to execution. Takes effect on
+    /// isStateValid() and the serial motion validation path; parallel and
+    /// clearance-adaptive motion validation always run full checks.
+    void setDeferredCollisionRefinement(bool enable, double borderline_dist);
+    bool deferredCollisionRefinement() const
+    { return m_deferred_collision_refinement; }
+
+    size_t refinementQueueSize() const { return m_refinement_queue.size(); }
+
+    /// Re-validate every state recorded in the refinement queue with full
+    /// collision checks and clear the queue. Returns false if any recorded
+    /// state is in collision under the full model.
+    bool processRefinementQueue();
+
+    void clearRefinementQueue() { m_refinement_queue.clear(); }
+
+    ///@}
+
+    /// \name Pose Pre-Filtering
+    ///@{
+
+    /// Cheaply filter a set of candidate poses -- e.g. grasp poses for an
+    /// end effector -- before planning by probing a small set of spheres
+    /// against the occupancy grid. \p spheres gives the sphere centers in
+    /// the pose frame and \p sphere_radius their common radius. On return,
+    /// \p valid holds one entry per pose, true when every probe sphere
+    /// clears the grid by more than \p sphere_radius. Returns the number of
+    /// valid poses. The probe spheres are only tested against the world;
+    /// this is a pre-filter, not a substitute for full collision checking
+    /// of the states that reach the surviving poses.
+    size_t filterPoses(
+        const Affine3dVector& poses,
+        const std::vector<Eigen::Vector3d>& spheres,
+        double sphere_radius,
+        std::vector<bool>& valid) const;
+
+    ///@}
+
+    /// \name Collision State Contexts
+    ///@{
+
+    /// A private copy of the mutable collision checking state: a robot
+    /// collision state and attached bodies collision state sharing the
+    /// immutable robot collision models, plus a self collision model sharing
+    /// the occupancy grid. Contexts give parallel callers thread-local
+    /// scratch for collision checks without mutating the state owned by the
+    /// collision space.
+    struct CollisionStateContext
+    {
+        RobotCollisionStatePtr          rcs;
+        AttachedBodiesCollisionStatePtr abcs;
+        SelfCollisionModelPtr           scm;
+        std::vector<double>             joint_vars;
+        int                             config_version;
+    };
+
+    using CollisionStateContextPtr = std::unique_ptr<CollisionStateContext>;
+
+    /// Check out a collision state context, reusing one from the pool of
+    /// checked-in contexts when available. The context is seeded with the
+    /// current allowed collision matrix, padding, world-to-model transform,
+    /// and joint variables of the collision space; configuration changes made
+    /// while a context is checked out are not reflected until the context is
+    /// checked in and checked out again. Safe to call concurrently with
+    /// checks against other contexts, but not with mutations of the
+    /// collision space.
+    auto checkoutCollisionState() -> CollisionStateContextPtr;
+
+    /// Return a context to the pool for reuse by later checkouts.
+    void checkinCollisionState(CollisionStateContextPtr ctx);
+
+    /// Context-local counterparts to the check functions below. Only the
+    /// given context is mutated, so concurrent calls with distinct contexts
+    /// are safe as long as the collision space itself is not modified.
+    bool checkCollision(
+        CollisionStateContext& ctx,
+        const double* state,
+        double& dist);
+    bool isStateValid(CollisionStateContext& ctx, const RobotState& state);
+
+    ///@}
+
+    /// \name Contact Export
+    ///@{
+
+    /// Return the limiting sphere of the voxels tiers of the most recent
+    /// collision check: the colliding sphere if the state struck the world,
+    /// otherwise the minimum-clearance sphere. The sphere tree traversal
+    /// records this in passing, so cost functions and debugging tools that
+    /// want proximity-weighted values can consume it without re-querying the
+    /// grid per edge. Context-local checks record into their own context;
+    /// use the overload below for those.
+    auto lastContact() const -> const VoxelsContact&
+    { return m_scm->lastVoxelsContact(); }
+
+    auto lastContact(const CollisionStateContext& ctx) const
+        -> const VoxelsContact&
+    { return ctx.scm->lastVoxelsContact(); }
+
+    /// Locate the occupied cell nearest to the limiting sphere of the most
+    /// recent collision check, using a single fused distance-and-gradient
+    /// lookup to step from the sphere center onto the obstacle. Returns
+    /// false if no contact has been recorded or the gradient is undefined at
+    /// the sphere center.
+    bool lastContactObstacleCell(int& x, int& y, int& z) const;
+
+    ///@}
+
     /// \name Self Collisions
     ///@{
     auto allowedCollisionMatrix() const -> const AllowedCollisionMatrix&;
@@ -120,8 +262,24 @@ public:
         const std::string& link_name);
 
     bool detachObject(const std::string& id);
+
+    bool attachObjectFromWorld(
+        const CollisionObject* object,
+        const std::vector<shapes::ShapeConstPtr>& shapes,
+        const Affine3dVector& transforms,
+        const std::string& link_name);
+
+    bool detachObjectToWorld(const CollisionObject* object);
     ///@}
 
+    /// The epoch of the collision model configuration, bumped by world
+    /// object mutations, allowed collision matrix updates, padding, attached
+    /// bodies, and world-to-model transform changes, so caches of collision
+    /// verdicts can validate their entries against it (together with the
+    /// occupancy grid epoch for distance-derived values); see
+    /// CacheEntryHeader.
+    Epoch epoch() const { return m_epoch; }
+
     auto getReferenceFrame() const -> const std::string&
     { return m_grid->getReferenceFrame(); }
 
@@ -239,6 +397,38 @@ private:
     // Planning Joint Information
     std::vector<int>                m_planning_joint_to_collision_model_indices;
 
+    // per-worker collision checking contexts for parallel motion validation;
+    // each worker owns private collision states and a private self collision
+    // model sharing the immutable robot models and the occupancy grid
+    bool                                    m_parallel_motion_validation = false;
+    int                                     m_num_motion_validation_threads = 1;
+    std::vector<CollisionStateContext>      m_motion_validation_contexts;
+
+    // skip interpolated waypoints covered by the clearance of a validated
+    // one; see isStateToStateValidAdaptive()
+    bool                            m_clearance_adaptive_motion_validation = false;
+
+    // validate states against the voxel checks only and queue borderline
+    // states for later full checks; see setDeferredCollisionRefinement()
+    bool                            m_deferred_collision_refinement = false;
+    double                          m_refinement_band = 0.0;
+    std::vector<RobotState>         m_refinement_queue;
+
+    // free list of checked-in contexts; see checkoutCollisionState()
+    std::mutex                              m_context_pool_mutex;
+    std::vector<CollisionStateContextPtr>   m_context_pool;
+
+    // mirrored model configuration for seeding lazily-built contexts; the
+    // version is bumped on each configuration change so that stale pooled
+    // contexts are re-seeded on checkout
+    double                                  m_padding = 0.0;
+    Eigen::Affine3d                         m_world_to_model =
+            Eigen::Affine3d::Identity();
+    int                                     m_context_config_version = 1;
+
+    // collision model configuration epoch; see epoch()
+    Epoch                                   m_epoch = 1;
+
     size_t planningVariableCount() const {
         return m_planning_joint_to_collision_model_indices.size();
     }
@@ -256,7 +446,17 @@ private:
     void updateState(std::vector<double>& state, const double* vals);
     void copyState();
 
-    bool withinJointPositionLimits(const std::vector<double>& positions) const;
+    void seedContextConfiguration(CollisionStateContext& ctx) const;
+    void ensureMotionValidationContexts();
+    bool isStateToStateValidParallel(
+        const MotionInterpolation& interp,
+        bool verbose);
+    bool isStateToStateValidAdaptive(
+        const MotionInterpolation& interp,
+        double res,
+        bool verbose);
+
+    bool withinJointPositionLimits(const RobotState& positions) const;
 };
 
 typedef std::shared_ptr<CollisionSpace> CollisionSpacePtr;
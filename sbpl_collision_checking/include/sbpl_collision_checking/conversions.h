@@ -24,6 +24,38 @@ void ConvertCollisionObjectMsgToCollisionObject(
     const moveit_msgs::CollisionObject& in,
     CollisionObject& out);
 
+/// A CollisionObject whose mesh shapes reference the vertex and triangle
+/// buffers of the originating message in place, with the message pinned for
+/// the lifetime of the view. Use for transient consumers -- voxelization,
+/// distance field updates -- that are done with the object before the view is
+/// released; call MaterializeCollisionObjectView() to produce an
+/// independently-owned deep copy when the object must outlive the message.
+struct CollisionObjectView
+{
+    CollisionObject object;
+    moveit_msgs::CollisionObjectConstPtr message; ///< lifetime pin
+};
+
+/// moveit_msgs::CollisionObject -> scdl::CollisionObject view. Mesh vertex
+/// and triangle arrays are referenced in place rather than duplicated;
+/// primitive and plane shapes are small and constructed as owned. The view
+/// holds a reference to the message, so the buffers remain valid until the
+/// view is freed.
+void ConvertCollisionObjectMsgToCollisionObjectView(
+    const moveit_msgs::CollisionObjectConstPtr& in,
+    CollisionObjectView& out);
+
+/// Deep-copy a view's shapes into an independently-owned CollisionObject,
+/// for objects that persist beyond the originating message. The copy is
+/// freed with FreeManagedCollisionObject().
+void MaterializeCollisionObjectView(
+    const CollisionObjectView& in,
+    CollisionObject& out);
+
+/// Release a view's shapes and unpin the originating message. The referenced
+/// buffers must no longer be in use.
+void FreeCollisionObjectView(CollisionObjectView& view);
+
 /// collision_detection::World::Object -> moveit_msgs::CollisionObject
 void ConvertWorldObjectToCollisionObjectMsg(
     const collision_detection::World::Object& in,
@@ -34,6 +34,7 @@
 #define sbpl_collision_robot_collision_model_h
 
 // standard includes
+#include <cstdint>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -93,6 +94,18 @@ public:
 
     ~RobotCollisionModel();
 
+    /// \name Voxels Model Cache
+    ///@{
+
+    /// Set the directory used to persist voxelized link models between runs.
+    /// An empty directory (the default) disables the cache. Cache files are
+    /// versioned and keyed by a hash of the voxelized links' collision
+    /// geometry and the voxel model configuration, so entries are regenerated
+    /// whenever either changes.
+    static void SetVoxelsCacheDirectory(const std::string& dir);
+    static auto VoxelsCacheDirectory() -> const std::string&;
+    ///@}
+
     /// \name Robot Model - General Information
     ///@{
     auto   name() const -> const std::string&;
@@ -317,6 +330,20 @@ private:
         const Eigen::Affine3d& pose,
         double res,
         std::vector<Eigen::Vector3d>& voxels) const;
+
+    std::uint64_t hashVoxelsModelInputs(
+        const ::urdf::ModelInterface& urdf,
+        const CollisionModelConfig& config) const;
+
+    bool loadVoxelsModels(
+        const std::string& path,
+        std::uint64_t key,
+        const CollisionModelConfig& config);
+
+    bool saveVoxelsModels(
+        const std::string& path,
+        std::uint64_t key,
+        const CollisionModelConfig& config) const;
 };
 
 auto LoadRobotCollisionModel(
@@ -42,6 +42,7 @@
 #include <visualization_msgs/MarkerArray.h>
 
 // project includes
+#include <smpl/spatial_batch.h>
 #include <sbpl_collision_checking/base_collision_states.h>
 #include <sbpl_collision_checking/robot_collision_model.h>
 
@@ -111,6 +112,13 @@ public:
     bool updateSphereStates(int ssidx);
     bool updateSphereState(const SphereIndex& sidx);
 
+    /// \brief Update the sphere states of the spheres states belonging to
+    ///        this group; a no-op when no variable influencing the group's
+    ///        links has changed since the last update
+    bool updateGroupSphereStates(const std::string& group_name);
+    bool updateGroupSphereStates(int gidx);
+    bool groupSphereStatesDirty(int gidx) const;
+
     /// \brief Return the indices of the collision sphere states belonging to
     ///        this group
     auto groupSpheresStateIndices(const std::string& group_name) const
@@ -118,6 +126,12 @@ public:
     auto groupSpheresStateIndices(int gidx) const
         -> const std::vector<int>&;
 
+    /// \brief Return the structure-of-arrays mirror of the leaf spheres of
+    ///        this group, with sphere positions refreshed to the current state
+    auto groupSphereArrays(const std::string& group_name)
+        -> const CollisionGroupSphereArrays&;
+    auto groupSphereArrays(int gidx) -> const CollisionGroupSphereArrays&;
+
     /// \brief Return the indices of the collision voxels states NOT belonging
     ///        to this group.
     auto groupOutsideVoxelsStateIndices(const std::string& group_name) const
@@ -157,12 +171,37 @@ private:
     // per group model
     std::vector<CollisionGroupState>        m_group_states;
 
+    // per group model, refreshed lazily by groupSphereArrays()
+    std::vector<CollisionGroupSphereArrays> m_group_sphere_arrays;
+
+    // per link, the groups with a spheres state on the link; per group,
+    // whether any joint variable influencing one of the group's links has
+    // changed since the group's sphere states (respectively sphere arrays)
+    // were last refreshed — joint updates outside a group's subtree leave
+    // the group clean and its refresh a no-op
+    std::vector<std::vector<int>>           m_link_sphere_groups;
+    std::vector<bool>                       m_dirty_group_spheres;
+    std::vector<bool>                       m_dirty_group_sphere_arrays;
+
     // per-link references to corresponding spheres and voxels states
     std::vector<CollisionVoxelsState*>      m_link_voxels_states;
     std::vector<CollisionSpheresState*>     m_link_spheres_states;
 
     std::vector<int> m_q;
     std::vector<int> m_ancestors;
+
+    // memo of the link and voxels states dirtied by the last call to
+    // setJointVarPositions, keyed by the most ancestral moved joints; the
+    // waypoints of an interpolated motion move the same variables, so the
+    // subtree walk deriving the affected set is shared across them
+    std::vector<int> m_last_ancestors;
+    std::vector<int> m_affected_links;
+    std::vector<int> m_affected_voxel_states;
+    std::vector<int> m_affected_groups;
+
+    // gather/scatter scratch for the batched sphere position updates
+    std::vector<int> m_stale_spheres;
+    std::vector<double> m_sphere_scratch;
     ///@}
 
     void initRobotState();
@@ -188,6 +227,7 @@ inline RobotCollisionState::RobotCollisionState(
     m_dirty_voxels_states(),
     m_voxels_states(),
     m_group_states(),
+    m_group_sphere_arrays(),
     m_link_voxels_states(),
     m_link_spheres_states()
 {
@@ -293,6 +333,8 @@ inline bool RobotCollisionState::setWorldToModelTransform(
         m_dirty_link_transforms[0] = false;
         ++m_link_transform_versions[0];
         std::fill(m_dirty_voxels_states.begin(), m_dirty_voxels_states.end(), true);
+        std::fill(m_dirty_group_spheres.begin(), m_dirty_group_spheres.end(), true);
+        std::fill(m_dirty_group_sphere_arrays.begin(), m_dirty_group_sphere_arrays.end(), true);
         return true;
     } else {
         return false;
@@ -526,12 +568,46 @@ inline bool RobotCollisionState::updateSphereStates()
 
 inline bool RobotCollisionState::updateSphereStates(int ssidx)
 {
-    bool updated = false;
-    const CollisionSpheresState& spheres_state = m_spheres_states[ssidx];
-    for (size_t sidx = 0; sidx < spheres_state.spheres.size(); ++sidx) {
-        updated |= updateSphereState(SphereIndex(ssidx, sidx));
+    CollisionSpheresState& spheres_state = m_spheres_states[ssidx];
+    const int lidx = spheres_state.model->link_index;
+    updateLinkTransform(lidx);
+    const int link_version = m_link_transform_versions[lidx];
+
+    // gather the out-of-date spheres; they all share the link transform, so
+    // their centers are brought to the model frame by one batched transform
+    auto& spheres = spheres_state.spheres;
+    m_stale_spheres.clear();
+    for (size_t sidx = 0; sidx < spheres.size(); ++sidx) {
+        if (spheres[sidx].version != link_version) {
+            m_stale_spheres.push_back((int)sidx);
+        }
     }
-    return updated;
+    if (m_stale_spheres.empty()) {
+        return false;
+    }
+
+    ROS_DEBUG_NAMED(RCS_LOGGER, "Updating positions of %zu spheres on link '%s'", m_stale_spheres.size(), m_model->linkName(lidx).c_str());
+
+    const int count = (int)m_stale_spheres.size();
+    m_sphere_scratch.resize(3 * count);
+    double* xs = m_sphere_scratch.data();
+    double* ys = xs + count;
+    double* zs = ys + count;
+    for (int i = 0; i < count; ++i) {
+        const Eigen::Vector3d& center = spheres[m_stale_spheres[i]].model->center;
+        xs[i] = center.x();
+        ys[i] = center.y();
+        zs[i] = center.z();
+    }
+
+    TransformPoints(m_link_transforms[lidx], xs, ys, zs, xs, ys, zs, count);
+
+    for (int i = 0; i < count; ++i) {
+        CollisionSphereState& sphere_state = spheres[m_stale_spheres[i]];
+        sphere_state.pos = Eigen::Vector3d(xs[i], ys[i], zs[i]);
+        sphere_state.version = link_version;
+    }
+    return true;
 }
 
 inline bool RobotCollisionState::updateSphereState(const SphereIndex& sidx)
@@ -556,6 +632,34 @@ inline bool RobotCollisionState::updateSphereState(const SphereIndex& sidx)
     return true;
 }
 
+inline bool RobotCollisionState::updateGroupSphereStates(
+    const std::string& group_name)
+{
+    const int gidx = m_model->groupIndex(group_name);
+    return updateGroupSphereStates(gidx);
+}
+
+inline bool RobotCollisionState::updateGroupSphereStates(int gidx)
+{
+    ASSERT_VECTOR_RANGE(m_dirty_group_spheres, gidx);
+    if (!m_dirty_group_spheres[gidx]) {
+        return false;
+    }
+
+    bool updated = false;
+    for (int ssidx : m_group_states[gidx].spheres_indices) {
+        updated |= updateSphereStates(ssidx);
+    }
+    m_dirty_group_spheres[gidx] = false;
+    return updated;
+}
+
+inline bool RobotCollisionState::groupSphereStatesDirty(int gidx) const
+{
+    ASSERT_VECTOR_RANGE(m_dirty_group_spheres, gidx);
+    return m_dirty_group_spheres[gidx];
+}
+
 inline auto RobotCollisionState::groupSpheresStateIndices(
     const std::string& group_name) const
     -> const std::vector<int>&
@@ -571,6 +675,59 @@ inline auto RobotCollisionState::groupSpheresStateIndices(int gidx) const
     return m_group_states[gidx].spheres_indices;
 }
 
+inline auto RobotCollisionState::groupSphereArrays(
+    const std::string& group_name)
+    -> const CollisionGroupSphereArrays&
+{
+    const int gidx = m_model->groupIndex(group_name);
+    return groupSphereArrays(gidx);
+}
+
+inline auto RobotCollisionState::groupSphereArrays(int gidx)
+    -> const CollisionGroupSphereArrays&
+{
+    ASSERT_VECTOR_RANGE(m_group_sphere_arrays, gidx);
+    CollisionGroupSphereArrays& arrays = m_group_sphere_arrays[gidx];
+    const std::vector<int>& ssindices = m_group_states[gidx].spheres_indices;
+
+    // joint updates since the last refresh left the group's links untouched
+    if (!m_dirty_group_sphere_arrays[gidx]) {
+        return arrays;
+    }
+
+    // refresh the positions of spheres whose link transforms changed since
+    // the last call; the arrays themselves were laid out in
+    // initCollisionState()
+    for (size_t i = 0; i < ssindices.size(); ++i) {
+        const int ssidx = ssindices[i];
+        const CollisionSpheresState& spheres_state = m_spheres_states[ssidx];
+        const int lidx = spheres_state.model->link_index;
+        if (!m_dirty_link_transforms[lidx] &&
+            arrays.versions[i] == m_link_transform_versions[lidx])
+        {
+            continue;
+        }
+
+        const int first = arrays.offsets[i];
+        const int last = arrays.offsets[i + 1];
+        for (int j = first; j < last; ++j) {
+            const CollisionSphereState* sphere_state = arrays.sphere_states[j];
+            updateSphereState(SphereIndex(ssidx, sphere_state->index()));
+            arrays.x[j] = sphere_state->pos.x();
+            arrays.y[j] = sphere_state->pos.y();
+            arrays.z[j] = sphere_state->pos.z();
+        }
+
+        // read back after updateSphereState, which may have bumped the
+        // version by updating the link transform
+        arrays.versions[i] = m_link_transform_versions[lidx];
+    }
+
+    m_dirty_group_sphere_arrays[gidx] = false;
+
+    return arrays;
+}
+
 inline auto RobotCollisionState::groupOutsideVoxelsStateIndices(
     const std::string& group_name) const
     -> const std::vector<int>&
@@ -33,8 +33,10 @@
 #define sbpl_collision_self_collision_model_h
 
 // standard includes
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 // system includes
 #include <smpl/forward.h>
@@ -87,6 +89,17 @@ public:
         const int gidx,
         double& dist);
 
+    /// Check only the voxel tiers of a full collision check -- robot and
+    /// attached body spheres against the occupancy grid -- skipping the
+    /// sphere-model self collision tests. A successful check reports the
+    /// minimum clearance found against the grid, which upper bounds the
+    /// clearance a full check would report.
+    bool checkVoxelsCollision(
+        const RobotCollisionState& state,
+        const AttachedBodiesCollisionState& ab_state,
+        const int gidx,
+        double& dist);
+
     bool checkMotionCollision(
         RobotCollisionState& state,
         AttachedBodiesCollisionState& ab_state,
@@ -130,6 +143,13 @@ public:
         const int gidx,
         CollisionDetails& details);
 
+    /// Return the limiting sphere of the voxels tiers of the most recent
+    /// collision check: the colliding sphere if a voxels tier failed,
+    /// otherwise the sphere whose clearance against the occupancy grid was
+    /// smallest. Invalid until a check exercising the voxels tiers has run.
+    const VoxelsContact& lastVoxelsContact() const
+    { return m_last_voxels_contact; }
+
     // TODO: contacts checks
     // TODO: detailed checks
 
@@ -154,15 +174,37 @@ private:
     std::vector<std::pair<int, int>>        m_checked_attached_body_spheres_states;
     std::vector<std::pair<int, int>>        m_checked_attached_body_robot_spheres_states;
 
+    // per-pair collision counts, parallel to the checked spheres state pair
+    // arrays above; used to keep each array ordered by descending collision
+    // count so that historically-colliding pairs are tested first and
+    // colliding states are rejected with as few narrowphase descents as
+    // possible
+    std::vector<std::uint32_t>              m_checked_spheres_hits;
+    std::vector<std::uint32_t>              m_checked_attached_body_spheres_hits;
+    std::vector<std::uint32_t>              m_checked_attached_body_robot_spheres_hits;
+
     AllowedCollisionMatrix                  m_acm;
     double                                  m_padding;
 
+    // bitmask rows compiled from the last caller-supplied allowed collisions
+    // interface; entity i is allowed to collide with entity j iff bit j of
+    // row i is set. Robot links occupy entities [0, linkCount()) and attached
+    // bodies are assigned entities past the links during compilation.
+    const AllowedCollisionsInterface*       m_aci;
+    int                                     m_aci_abcm_version;
+    std::vector<std::uint64_t>              m_aci_mask_rows;
+    size_t                                  m_aci_mask_stride;
+    std::vector<int>                        m_aci_body_entities;
+
     // queue storage for sphere hierarchy traversal
     using SpherePair =
             std::pair<const CollisionSphereState*, const CollisionSphereState*>;
     std::vector<SpherePair> m_q;
     std::vector<const CollisionSphereState*>    m_vq;
 
+    // limiting sphere recorded by the voxels tiers of the last check
+    VoxelsContact m_last_voxels_contact;
+
     std::vector<Eigen::Vector3d> m_v_rem;
     std::vector<Eigen::Vector3d> m_v_ins;
 
@@ -193,6 +235,10 @@ private:
     bool checkRobotVoxelsStateCollisions(double& dist);
     bool checkAttachedBodyVoxelsStateCollisions(double& dist);
 
+    // fold a limiting sphere reported by CheckVoxelsCollisions into the
+    // contact record, keeping the sphere with the smallest clearance
+    void recordVoxelsContact(const CollisionSphereState* s, double dist);
+
     // check for collisions between inside-group spheres
     bool checkRobotSpheresStateCollisions(double& dist);
     bool checkRobotSpheresStateCollisions(
@@ -225,6 +271,24 @@ private:
         const CollisionSpheresState& ss2,
         double& dist);
 
+    template <typename StateTypeA, typename StateTypeB>
+    bool spheresStateRootsSeparated(
+        StateTypeA& stateA,
+        StateTypeB& stateB,
+        const int ss1i, const int ss2i,
+        const CollisionSpheresState& ss1,
+        const CollisionSpheresState& ss2,
+        double& dist);
+
+    void updateAllowedCollisionsMasks(const AllowedCollisionsInterface& aci);
+    bool maskedCollisionAllowed(int entity1, int entity2) const;
+
+    void diffAllowedCollisionMatrix(
+        const AllowedCollisionMatrix& acm,
+        std::vector<std::pair<std::string, std::string>>& changed) const;
+    void patchCheckedSpheresIndices(
+        const std::vector<std::pair<std::string, std::string>>& changed);
+
     void updateCheckedSpheresIndices();
     void updateRobotCheckedSphereIndices();
     void updateRobotAttachedBodyCheckedSphereIndices();
@@ -107,6 +107,19 @@ struct CollisionDetails
     int voxels_collision_count;
 };
 
+/// The limiting sphere of the voxels (robot vs. world) tiers of a collision
+/// check: the colliding sphere if the check failed, otherwise the sphere
+/// whose clearance against the occupancy grid was smallest. The sphere tree
+/// traversal computes this data in passing, so exporting it costs no
+/// additional distance map queries.
+struct VoxelsContact
+{
+    Eigen::Vector3d sphere_center;  ///< sphere center, in the grid frame
+    double sphere_radius;           ///< sphere radius, including padding
+    double distance;                ///< center distance to the nearest occupied voxel
+    bool valid = false;             ///< whether any voxels check has run
+};
+
 } // namespace collision
 } // namespace smpl
 
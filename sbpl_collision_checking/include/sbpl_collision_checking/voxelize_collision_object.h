@@ -91,6 +91,12 @@ bool VoxelizeOcTree(
     const Eigen::Vector3d& go,
     std::vector<Eigen::Vector3d>& voxels);
 
+void TranslateVoxels(
+    const Eigen::Vector3d& shift,
+    const Eigen::Vector3d& gmin,
+    const Eigen::Vector3d& gmax,
+    std::vector<Eigen::Vector3d>& voxels);
+
 } // namespace collision
 } // namespace smpl
 
@@ -33,6 +33,7 @@
 #define SBPL_COLLISION_WORLD_COLLISION_DETECTOR_H
 
 // standard includes
+#include <cstdint>
 #include <vector>
 
 // system includes
@@ -92,6 +93,14 @@ private:
 
     mutable std::vector<const CollisionSphereState*> m_vq;
 
+    // per-spheres-state collision counts, indexed by spheres state index, for
+    // robot and attached body states respectively; used to order per-link
+    // sphere tree checks so that historically-colliding links are tested
+    // first
+    mutable std::vector<std::uint32_t> m_robot_hits;
+    mutable std::vector<std::uint32_t> m_ab_hits;
+    mutable std::vector<int> m_check_order;
+
     bool checkRobotSpheresStateCollisions(
         RobotCollisionState& state,
         int gidx,
@@ -33,8 +33,10 @@
 #define SBPL_COLLISION_CHECKING_WORLD_COLLISION_MODEL_H
 
 // standard includes
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // system includes
@@ -42,6 +44,9 @@
 #include <smpl/occupancy_grid.h>
 #include <visualization_msgs/MarkerArray.h>
 
+// project includes
+#include <sbpl_collision_checking/types.h>
+
 namespace smpl {
 namespace collision {
 
@@ -60,6 +65,11 @@ public:
     bool insertObject(const CollisionObject* object);
     bool removeObject(const CollisionObject* object);
 
+    bool extractObject(const CollisionObject* object);
+    bool restoreObject(const CollisionObject* object);
+
+    bool syncObject(const CollisionObject* object);
+
     bool moveShapes(const CollisionObject* object);
     bool insertShapes(const CollisionObject* object);
     bool removeShapes(const CollisionObject* object);
@@ -71,6 +81,19 @@ public:
 
     void reset();
 
+    /// \name Broadphase
+    ///@{
+
+    /// Gather the objects whose bounding boxes intersect a bounding sphere.
+    /// Queries only visit objects hashed into the broadphase cells the sphere
+    /// overlaps, rather than every object in the model.
+    void gatherCandidateObjects(
+        const Eigen::Vector3d& center,
+        double radius,
+        std::vector<const CollisionObject*>& objects) const;
+
+    ///@}
+
     auto getWorldVisualization() const -> visualization_msgs::MarkerArray;
     auto getCollisionWorldVisualization() const -> visualization_msgs::MarkerArray;
 
@@ -88,20 +111,84 @@ private:
         // occupied voxels for this object in the grid reference frame, one
         // list for each shape in the object
         std::vector<VoxelList> cached_voxels;
+
+        // the shape poses the voxels were computed at, for diffing against
+        // the object's current poses when it moves
+        Affine3dVector cached_shape_poses;
     };
     std::vector<ObjectCollisionModel> m_object_models;
 
+    // Models of objects removed from the world via extractObject(), e.g.
+    // while attached to the robot, keyed by object id. Each retains the
+    // object's voxel lists so that restoreObject() reuses them instead of
+    // re-voxelizing.
+    std::vector<ObjectCollisionModel> m_detached_models;
+
+    // Cache of shape voxelizations in the shape's local frame, keyed by shape
+    // geometry so that repeated instances of the same shape share one entry.
+    // An object changing pose then costs a rigid transform of the cached
+    // samples instead of a run of the voxelization pipeline. Samples are
+    // taken at half the grid resolution so that the rotated sample lattice
+    // still covers every grid cell the shape meaningfully overlaps.
+    struct LocalShapeVoxels {
+        const CollisionShape* shape;    // representative shape
+        VoxelList voxels;               // local-frame sample points
+    };
+    std::vector<LocalShapeVoxels> m_local_voxels;
+
     double m_padding;
 
+    // Uniform spatial hash over object bounding boxes. Each object is entered
+    // into every broadphase cell overlapped by its bounding box, maintained
+    // incrementally as objects are inserted and removed, so candidate queries
+    // only visit the objects hashed into the cells they overlap.
+    struct ObjectBounds {
+        Eigen::Vector3d min;    // world-frame bounding box of the object
+        Eigen::Vector3d max;
+        Eigen::Vector3i cmin;   // covered broadphase cell range, inclusive;
+        Eigen::Vector3i cmax;   // empty if cmin > cmax on any axis
+    };
+
+    double m_bp_cell_res;
+    std::unordered_map<const CollisionObject*, ObjectBounds> m_object_bounds;
+    std::unordered_map<std::uint64_t, std::vector<const CollisionObject*>> m_broadphase;
+
     ////////////////////
     // Generic Shapes //
     ////////////////////
 
     bool haveObject(const CollisionObject* object) const;
 
+    void insertObjectBounds(
+        const CollisionObject* object,
+        const std::vector<VoxelList>& all_voxels);
+    void removeObjectBounds(const CollisionObject* object);
+
     auto getObjectCollisionModel(const CollisionObject* object) const
         -> const ObjectCollisionModel*;
 
+    auto findModelWithName(const std::string& id) -> ObjectCollisionModel*;
+
+    auto getLocalShapeVoxels(const CollisionShape* shape)
+        -> const LocalShapeVoxels*;
+    void evictLocalShapeVoxels(const CollisionObject* object);
+
+    bool translateObject(
+        ObjectCollisionModel* model,
+        const Eigen::Vector3d& shift);
+
+    bool transformObject(
+        ObjectCollisionModel* model,
+        const Affine3dVector& poses);
+
+    void rasterizeFromLocalVoxels(
+        ObjectCollisionModel* model,
+        const Affine3dVector& poses);
+
+    void rebindObject(
+        ObjectCollisionModel* model,
+        const CollisionObject* object);
+
     bool checkObjectInsert(const CollisionObject* object) const;
     bool checkObjectRemove(const CollisionObject* object) const;
     bool checkObjectMoveShape(const CollisionObject* object) const;
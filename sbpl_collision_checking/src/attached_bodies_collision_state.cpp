@@ -63,10 +63,10 @@ bool AttachedBodiesCollisionState::updateVoxelsState(int vsidx)
 
     CollisionVoxelsState& state = m_voxels_states[vsidx];
 
-    const int bidx = state.model->link_index;
-    updateAttachedBodyTransform(bidx);
+    const int lidx = m_voxels_state_links[vsidx];
+    m_state->updateLinkTransform(lidx);
 
-    const Eigen::Affine3d& T_model_body = attachedBodyTransform(bidx);
+    const Eigen::Affine3d& T_model_body = m_state->linkTransform(lidx);
 
     // transform voxels into the model frame
     std::vector<Eigen::Vector3d> new_voxels(state.model->voxels.size());
@@ -75,7 +75,7 @@ bool AttachedBodiesCollisionState::updateVoxelsState(int vsidx)
     }
 
     state.voxels = std::move(new_voxels);
-    m_voxels_state_versions[vsidx] = attachedBodyTransformVersion(bidx);
+    m_voxels_state_versions[vsidx] = m_state->linkTransformVersion(lidx);
     return true;
 }
 
@@ -85,23 +85,22 @@ bool AttachedBodiesCollisionState::updateSphereState(
     reinitCollisionState();
 
     CollisionSpheresState& spheres_state = m_spheres_states[sidx.ss];
-    const int bidx = spheres_state.model->link_index;
-    const int body_version = attachedBodyTransformVersion(bidx);
+    const int lidx = m_spheres_state_links[sidx.ss];
     CollisionSphereState& sphere_state = spheres_state.spheres[sidx.s];
 
-    if (!attachedBodyTransformDirty(bidx) &&
-        sphere_state.version == body_version)
+    if (!m_state->linkTransformDirty(lidx) &&
+        sphere_state.version == m_state->linkTransformVersion(lidx))
     {
         return false;
     }
 
-    updateAttachedBodyTransform(bidx);
+    m_state->updateLinkTransform(lidx);
 
     ROS_DEBUG_NAMED(ABS_LOGGER, "Updating position of sphere '%s'", sphere_state.model->name.c_str());
-    const Eigen::Affine3d& T_model_body = attachedBodyTransform(bidx);
+    const Eigen::Affine3d& T_model_body = m_state->linkTransform(lidx);
     sphere_state.pos = T_model_body * sphere_state.model->center;
 
-    sphere_state.version = attachedBodyTransformVersion(bidx);
+    sphere_state.version = m_state->linkTransformVersion(lidx);
     return true;
 }
 
@@ -124,6 +123,7 @@ void AttachedBodiesCollisionState::reinitCollisionState()
 
     // initialize voxels states
     m_voxels_states.assign(m_model->voxelsModelCount(), CollisionVoxelsState());
+    m_voxels_state_versions.assign(m_model->voxelsModelCount(), -1);
 
     for (size_t i = 0; i < m_model->voxelsModelCount(); ++i) {
         const CollisionVoxelsModel& voxels_model = m_model->voxelsModel(i);
@@ -133,6 +133,20 @@ void AttachedBodiesCollisionState::reinitCollisionState()
         voxels_state.voxels = voxels_model.voxels;
     }
 
+    // resolve the attachment link of each spheres/voxels state; the states'
+    // model link indices name attached bodies, not robot links, and looking
+    // them up here keeps attached body lookups out of per-sphere updates
+    m_spheres_state_links.assign(m_spheres_states.size(), -1);
+    for (size_t i = 0; i < m_spheres_states.size(); ++i) {
+        const int abidx = m_spheres_states[i].model->link_index;
+        m_spheres_state_links[i] = m_model->attachedBodyLinkIndex(abidx);
+    }
+    m_voxels_state_links.assign(m_voxels_states.size(), -1);
+    for (size_t i = 0; i < m_voxels_states.size(); ++i) {
+        const int abidx = m_voxels_states[i].model->link_index;
+        m_voxels_state_links[i] = m_model->attachedBodyLinkIndex(abidx);
+    }
+
     // initialize group states
     m_group_states.assign(m_model->groupCount(), CollisionGroupState());
     for (size_t i = 0; i < m_model->groupCount(); ++i) {
@@ -29,6 +29,9 @@
 
 /// \author Andrew Dornbush
 
+#include <assert.h>
+#include <algorithm>
+
 #include <ros/console.h>
 
 #include "collision_operations.h"
@@ -70,5 +73,64 @@ std::vector<SphereIndex> GatherSphereIndices(
     return sphere_indices;
 }
 
+uint64_t CheckSpheresCollisions(
+    const OccupancyGrid& grid,
+    const double* xs,
+    const double* ys,
+    const double* zs,
+    const double* radii,
+    size_t count,
+    double padding)
+{
+    assert(count <= 64);
+
+    uint64_t mask = 0;
+    size_t base = 0;
+    while (base < count) {
+        const size_t block = std::min(count - base, (size_t)8);
+
+        // gather squared distances for this block
+        double d2[8];
+        for (size_t i = 0; i < block; ++i) {
+            d2[i] = grid.getSquaredDist(
+                    xs[base + i], ys[base + i], zs[base + i]);
+        }
+
+        // compare against effective radii; kept free of branches and calls so
+        // the compiler can vectorize the block
+        uint64_t block_mask = 0;
+        for (size_t i = 0; i < block; ++i) {
+            const double r = radii[base + i] + padding;
+            block_mask |= (uint64_t)(d2[i] < r * r) << i;
+        }
+
+        mask |= block_mask << base;
+        base += block;
+    }
+
+    return mask;
+}
+
+void GatherSphereArrays(
+    const CollisionSphereState* const* spheres,
+    size_t count,
+    std::vector<double>& xs,
+    std::vector<double>& ys,
+    std::vector<double>& zs,
+    std::vector<double>& radii)
+{
+    xs.resize(count);
+    ys.resize(count);
+    zs.resize(count);
+    radii.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        const CollisionSphereState* s = spheres[i];
+        xs[i] = s->pos.x();
+        ys[i] = s->pos.y();
+        zs[i] = s->pos.z();
+        radii[i] = s->model->radius;
+    }
+}
+
 } // namespace collision
 } // namespace smpl
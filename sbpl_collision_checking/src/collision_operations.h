@@ -32,6 +32,11 @@
 #ifndef sbpl_collision_collision_operations_h
 #define sbpl_collision_collision_operations_h
 
+// standard includes
+#include <math.h>
+#include <stdint.h>
+#include <limits>
+
 // system includes
 #include <ros/console.h>
 #include <smpl/occupancy_grid.h>
@@ -91,6 +96,31 @@ double SphereCollisionDistance(
 std::vector<SphereIndex> GatherSphereIndices(
     const RobotCollisionState& state, int gidx);
 
+/// Check a contiguous batch of spheres against an occupancy grid. Sphere
+/// centers are given in struct-of-arrays layout. Returns a bitmask with bit i
+/// set if sphere i penetrates the distance field; a return of 0 means all
+/// spheres are collision free. At most 64 spheres may be checked per call.
+/// Distance field lookups are gathered in blocks of 8 so the radius
+/// comparisons compile down to vector operations.
+uint64_t CheckSpheresCollisions(
+    const OccupancyGrid& grid,
+    const double* xs,
+    const double* ys,
+    const double* zs,
+    const double* radii,
+    size_t count,
+    double padding);
+
+/// Fill struct-of-arrays buffers for a batch sphere check from an array of
+/// sphere states. The buffers are resized to match the number of spheres.
+void GatherSphereArrays(
+    const CollisionSphereState* const* spheres,
+    size_t count,
+    std::vector<double>& xs,
+    std::vector<double>& ys,
+    std::vector<double>& zs,
+    std::vector<double>& radii);
+
 /// Check sphere hierarchies for collisions against an occupancy grid
 ///
 /// \param state The aggregate state of the collision trees. Must have a method
@@ -100,15 +130,27 @@ std::vector<SphereIndex> GatherSphereIndices(
 /// \param grid The distance map to check spheres against
 /// \param padding Padding to be applied to each sphere
 /// \param dist The distance to the occupancy grid that caused the check to
-///     fail, if any
+///     fail, if any; on success, a conservative (lower-bound) estimate of the
+///     clearance between all spheres and the nearest occupied voxel
+/// \param limiting_sphere The sphere that bounded the check: the colliding
+///     sphere on failure, or the sphere whose clearance was smallest on
+///     success (possibly an internal bounding sphere where the traversal
+///     pruned); null if the queue was empty
+/// \param limiting_dist The distance from the limiting sphere's center to the
+///     nearest occupied voxel
 template <typename StateType>
 bool CheckVoxelsCollisions(
     StateType& state,
     std::vector<const CollisionSphereState*>& q,
     const OccupancyGrid& grid,
     double padding,
-    double& dist)
+    double& dist,
+    const CollisionSphereState*& limiting_sphere,
+    double& limiting_dist)
 {
+    double clearance = std::numeric_limits<double>::max();
+    limiting_sphere = NULL;
+    limiting_dist = std::numeric_limits<double>::max();
     while (!q.empty()) {
         const CollisionSphereState* s = q.back();
         q.pop_back();
@@ -122,6 +164,15 @@ bool CheckVoxelsCollisions(
         double obs_dist;
         if (CheckSphereCollision(grid, *s, padding, obs_dist)) {
             ROS_DEBUG_NAMED(COP_LOGGER, " dist^2: %0.3f -> ok!", obs_dist);
+            // the traversal stops here; every sphere bounded by this sphere
+            // is at least this far from the nearest occupied voxel
+            const double d_obs = sqrt(obs_dist);
+            const double d = d_obs - (s->model->radius + padding);
+            if (d < clearance) {
+                clearance = d;
+                limiting_sphere = s;
+                limiting_dist = d_obs;
+            }
             continue; // no collision -> ok!
         }
 
@@ -146,6 +197,8 @@ bool CheckVoxelsCollisions(
             } else { // normal leaf
                 const CollisionSphereModel* sm = s->model;
                 dist = obs_dist;
+                limiting_sphere = s;
+                limiting_dist = sqrt(obs_dist);
                 ROS_DEBUG_NAMED(COP_LOGGER, "    *collision* name: %s, pos: (%0.3f, %0.3f, %0.3f), radius: %0.3fm, dist: %0.3fm", sm->name.c_str(), s->pos.x(), s->pos.y(), s->pos.z(), sm->radius, obs_dist);
                 return false;
             }
@@ -161,9 +214,24 @@ bool CheckVoxelsCollisions(
     }
 
     ROS_DEBUG_NAMED(COP_LOGGER, "No voxels collisions");
+    dist = clearance;
     return true;
 }
 
+template <typename StateType>
+bool CheckVoxelsCollisions(
+    StateType& state,
+    std::vector<const CollisionSphereState*>& q,
+    const OccupancyGrid& grid,
+    double padding,
+    double& dist)
+{
+    const CollisionSphereState* limiting_sphere;
+    double limiting_dist;
+    return CheckVoxelsCollisions(
+            state, q, grid, padding, dist, limiting_sphere, limiting_dist);
+}
+
 } // namespace collision
 } // namespace smpl
 
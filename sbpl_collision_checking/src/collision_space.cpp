@@ -34,7 +34,10 @@
 
 // standard includes
 #include <assert.h>
+#include <atomic>
 #include <limits>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <queue>
 
@@ -107,6 +110,13 @@ void CollisionSpace::setWorldToModelTransform(
             m_rcs->getJointVarPositions() + vlidx,
             m_joint_vars.data() + vfidx);
     m_scm->setWorldToModelTransform(transform);
+    m_world_to_model = transform;
+    ++m_context_config_version;
+    ++m_epoch;
+    for (auto& ctx : m_motion_validation_contexts) {
+        ctx.rcs->setWorldToModelTransform(transform);
+        ctx.scm->setWorldToModelTransform(transform);
+    }
 }
 
 /// \brief Set the padding applied to the collision model
@@ -114,6 +124,122 @@ void CollisionSpace::setPadding(double padding)
 {
     m_wcm->setPadding(padding);
     m_scm->setPadding(padding);
+    m_padding = padding;
+    ++m_context_config_version;
+    ++m_epoch;
+    for (auto& ctx : m_motion_validation_contexts) {
+        ctx.scm->setPadding(padding);
+    }
+}
+
+/// \brief Enable or disable parallel validation of interpolated motions
+void CollisionSpace::setParallelMotionValidation(bool enable, int num_threads)
+{
+    m_parallel_motion_validation = enable;
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
+    }
+    if (num_threads != m_num_motion_validation_threads) {
+        m_num_motion_validation_threads = num_threads;
+        m_motion_validation_contexts.clear(); // rebuilt on the next edge check
+    }
+}
+
+/// \brief Enable or disable two-tier state validation
+void CollisionSpace::setDeferredCollisionRefinement(
+    bool enable,
+    double borderline_dist)
+{
+    m_deferred_collision_refinement = enable;
+    m_refinement_band = borderline_dist;
+    m_refinement_queue.clear();
+}
+
+/// \brief Re-validate the queued borderline states with full checks
+/// \return true if every queued state passes a full collision check
+bool CollisionSpace::processRefinementQueue()
+{
+    bool valid = true;
+    double dist;
+    for (const RobotState& state : m_refinement_queue) {
+        updateState(state.data());
+        if (!m_scm->checkCollision(*m_rcs, *m_abcs, m_gidx, dist)) {
+            valid = false;
+            break;
+        }
+    }
+    m_refinement_queue.clear();
+    return valid;
+}
+
+size_t CollisionSpace::filterPoses(
+    const Affine3dVector& poses,
+    const std::vector<Eigen::Vector3d>& spheres,
+    double sphere_radius,
+    std::vector<bool>& valid) const
+{
+    // transform every probe sphere of every pose into one flat point buffer
+    // and resolve all distances in a single batched grid query; distances
+    // beyond the sphere radius are irrelevant and may be clamped
+    std::vector<Vector3> centers;
+    centers.reserve(poses.size() * spheres.size());
+    for (const Eigen::Affine3d& pose : poses) {
+        for (const Eigen::Vector3d& s : spheres) {
+            centers.push_back(pose * s);
+        }
+    }
+
+    // clamp strictly above the radius so clamped entries are distinguishable
+    // from exact distances at the radius itself
+    std::vector<double> dists;
+    const double thresh = sphere_radius + m_grid->resolution();
+    m_grid->getDistancesFromPoints(centers, dists, thresh);
+
+    valid.assign(poses.size(), true);
+    size_t valid_count = poses.size();
+    for (size_t pidx = 0; pidx < poses.size(); ++pidx) {
+        const double* d = &dists[pidx * spheres.size()];
+        for (size_t sidx = 0; sidx < spheres.size(); ++sidx) {
+            if (d[sidx] <= sphere_radius) {
+                valid[pidx] = false;
+                --valid_count;
+                break;
+            }
+        }
+    }
+    return valid_count;
+}
+
+bool CollisionSpace::lastContactObstacleCell(int& x, int& y, int& z) const
+{
+    const VoxelsContact& contact = m_scm->lastVoxelsContact();
+    if (!contact.valid) {
+        return false;
+    }
+
+    // one fused lookup gives the distance to the nearest obstacle and a unit
+    // vector pointing away from it; stepping back along the gradient by that
+    // distance lands on the obstacle surface
+    Eigen::Vector3d gradient;
+    const double d = m_grid->getDistanceField()->getMetricDistanceGradient(
+            contact.sphere_center.x(),
+            contact.sphere_center.y(),
+            contact.sphere_center.z(),
+            gradient);
+    if (gradient.squaredNorm() == 0.0) {
+        // within an obstacle or beyond the propagation distance; the sphere
+        // center's own cell is the best available answer in the former case
+        if (d != 0.0) {
+            return false;
+        }
+    }
+
+    const Eigen::Vector3d obstacle = contact.sphere_center - d * gradient;
+    m_grid->worldToGrid(obstacle.x(), obstacle.y(), obstacle.z(), x, y, z);
+    return m_grid->isInBounds(x, y, z);
 }
 
 /// \brief Return the allowed collision matrix
@@ -128,7 +254,12 @@ const AllowedCollisionMatrix& CollisionSpace::allowedCollisionMatrix() const
 void CollisionSpace::updateAllowedCollisionMatrix(
     const AllowedCollisionMatrix& acm)
 {
-    return m_scm->updateAllowedCollisionMatrix(acm);
+    m_scm->updateAllowedCollisionMatrix(acm);
+    ++m_context_config_version;
+    ++m_epoch;
+    for (auto& ctx : m_motion_validation_contexts) {
+        ctx.scm->updateAllowedCollisionMatrix(acm);
+    }
 }
 
 /// \brief Set the allowed collision matrix
@@ -137,6 +268,11 @@ void CollisionSpace::setAllowedCollisionMatrix(
     const AllowedCollisionMatrix& acm)
 {
     m_scm->setAllowedCollisionMatrix(acm);
+    ++m_context_config_version;
+    ++m_epoch;
+    for (auto& ctx : m_motion_validation_contexts) {
+        ctx.scm->setAllowedCollisionMatrix(acm);
+    }
 }
 
 /// \brief Insert an object into the world
@@ -149,6 +285,7 @@ bool CollisionSpace::insertObject(const CollisionObject* object)
         return false;
     }
 
+    ++m_epoch;
     return true;
 }
 
@@ -164,6 +301,7 @@ bool CollisionSpace::removeObject(const CollisionObject* object)
         return false;
     }
 
+    ++m_epoch;
     return true;
 }
 
@@ -172,7 +310,12 @@ bool CollisionSpace::removeObject(const CollisionObject* object)
 /// \return true if the object was moved; false otherwise
 bool CollisionSpace::moveShapes(const CollisionObject* object)
 {
-    return m_wcm->moveShapes(object);
+    if (!m_wcm->moveShapes(object)) {
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
 }
 
 /// \brief Append shapes to an object
@@ -180,7 +323,12 @@ bool CollisionSpace::moveShapes(const CollisionObject* object)
 /// \return true if the shapes were appended to the object; false otherwise
 bool CollisionSpace::insertShapes(const CollisionObject* object)
 {
-    return m_wcm->insertShapes(object);
+    if (!m_wcm->insertShapes(object)) {
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
 }
 
 /// \brief Remove shapes from an object
@@ -188,7 +336,12 @@ bool CollisionSpace::insertShapes(const CollisionObject* object)
 /// \return true if the shapes were removed; false otherwise
 bool CollisionSpace::removeShapes(const CollisionObject* object)
 {
-    return m_wcm->removeShapes(object);
+    if (!m_wcm->removeShapes(object)) {
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
 }
 
 /// \brief Attach a collision object to the robot
@@ -203,7 +356,12 @@ bool CollisionSpace::attachObject(
     const Affine3dVector& transforms,
     const std::string& link_name)
 {
-    return m_abcm->attachBody(id, shapes, transforms, link_name);
+    if (!m_abcm->attachBody(id, shapes, transforms, link_name)) {
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
 }
 
 /// \brief Detach a collision object from the robot
@@ -211,7 +369,67 @@ bool CollisionSpace::attachObject(
 /// \return true if the object was detached; false otherwise
 bool CollisionSpace::detachObject(const std::string& id)
 {
-    return m_abcm->detachBody(id);
+    if (!m_abcm->detachBody(id)) {
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
+}
+
+/// \brief Transition a world object to an attachment on the robot
+///
+/// The object is removed from the world model using its stored voxel lists,
+/// with its collision model retained for a later detachObjectToWorld(), and
+/// the given shapes are attached to the robot. No re-voxelization of the
+/// object's world representation takes place.
+///
+/// \param object The world object to remove
+/// \param shapes The shapes composing the attached body
+/// \param transforms The pose of each shape with respect to the attached link
+/// \param link_name The link to attach the object to
+/// \return true if the object was transitioned; false otherwise
+bool CollisionSpace::attachObjectFromWorld(
+    const CollisionObject* object,
+    const std::vector<shapes::ShapeConstPtr>& shapes,
+    const Affine3dVector& transforms,
+    const std::string& link_name)
+{
+    if (!m_wcm->extractObject(object)) {
+        return false;
+    }
+
+    if (!m_abcm->attachBody(object->id, shapes, transforms, link_name)) {
+        // put the world back the way it was
+        m_wcm->restoreObject(object);
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
+}
+
+/// \brief Transition an attached object back into the world
+///
+/// The attached body is detached from the robot and the object is restored
+/// to the world model. An object restored with unchanged geometry reuses the
+/// voxel lists retained by attachObjectFromWorld() rather than being
+/// re-voxelized.
+///
+/// \param object The object to restore, at its current world poses
+/// \return true if the object was transitioned; false otherwise
+bool CollisionSpace::detachObjectToWorld(const CollisionObject* object)
+{
+    if (!m_abcm->detachBody(object->id)) {
+        return false;
+    }
+
+    if (!m_wcm->restoreObject(object)) {
+        return false;
+    }
+
+    ++m_epoch;
+    return true;
 }
 
 /// \brief Return a visualization of the current world
@@ -249,9 +467,7 @@ auto CollisionSpace::getCollisionRobotVisualization()
     -> visualization_msgs::MarkerArray
 {
     // update the spheres within the group
-    for (int ssidx : m_rcs->groupSpheresStateIndices(m_gidx)) {
-        m_rcs->updateSphereStates(ssidx);
-    }
+    m_rcs->updateGroupSphereStates(m_gidx);
     auto markers = m_rcs->getVisualization(m_gidx);
     for (auto& m : markers.markers) {
         m.header.frame_id = m_grid->getReferenceFrame();
@@ -266,9 +482,7 @@ auto CollisionSpace::getCollisionRobotVisualization(
 {
     updateState(vals);
     // update the spheres within the group
-    for (int ssidx : m_rcs->groupSpheresStateIndices(m_gidx)) {
-        m_rcs->updateSphereStates(ssidx);
-    }
+    m_rcs->updateGroupSphereStates(m_gidx);
     auto markers = m_rcs->getVisualization(m_gidx);
     for (auto& m : markers.markers) {
         m.header.frame_id = m_grid->getReferenceFrame();
@@ -281,9 +495,7 @@ auto CollisionSpace::getCollisionRobotVisualization(const double* vals)
 {
     updateState(vals);
     // update the spheres within the group
-    for (int ssidx : m_rcs->groupSpheresStateIndices(m_gidx)) {
-        m_rcs->updateSphereStates(ssidx);
-    }
+    m_rcs->updateGroupSphereStates(m_gidx);
     auto markers = m_rcs->getVisualization(m_gidx);
     for (auto& m : markers.markers) {
         m.header.frame_id = m_grid->getReferenceFrame();
@@ -403,7 +615,19 @@ Extension* CollisionSpace::getExtension(size_t class_code)
 bool CollisionSpace::isStateValid(const RobotState& state, bool verbose)
 {
     double dist = std::numeric_limits<double>::max();
-    return checkCollision(state, dist);
+
+    if (m_deferred_collision_refinement) {
+        updateState(state.data());
+        if (!m_scm->checkVoxelsCollision(*m_rcs, *m_abcs, m_gidx, dist)) {
+            return false;
+        }
+        if (dist < m_refinement_band) {
+            m_refinement_queue.push_back(state);
+        }
+        return true;
+    }
+
+    return checkCollision(state.data(), dist);
 }
 
 bool CollisionSpace::isStateToStateValid(
@@ -422,6 +646,14 @@ bool CollisionSpace::isStateToStateValid(
             res,
             interp);
 
+    if (m_parallel_motion_validation && m_num_motion_validation_threads > 1) {
+        return isStateToStateValidParallel(interp, verbose);
+    }
+
+    if (m_clearance_adaptive_motion_validation) {
+        return isStateToStateValidAdaptive(interp, res, verbose);
+    }
+
     const int inc_cc = 5;
 
     RobotState interm;
@@ -453,6 +685,201 @@ bool CollisionSpace::isStateToStateValid(
     return true;
 }
 
+// Mirror the current model configuration into a context's private collision
+// states and self collision model.
+void CollisionSpace::seedContextConfiguration(CollisionStateContext& ctx) const
+{
+    ctx.scm->setAllowedCollisionMatrix(m_scm->allowedCollisionMatrix());
+    ctx.scm->setPadding(m_padding);
+    ctx.rcs->setWorldToModelTransform(m_world_to_model);
+    ctx.scm->setWorldToModelTransform(m_world_to_model);
+    ctx.config_version = m_context_config_version;
+}
+
+auto CollisionSpace::checkoutCollisionState() -> CollisionStateContextPtr
+{
+    CollisionStateContextPtr ctx;
+    {
+        std::lock_guard<std::mutex> lock(m_context_pool_mutex);
+        if (!m_context_pool.empty()) {
+            ctx = std::move(m_context_pool.back());
+            m_context_pool.pop_back();
+        }
+    }
+
+    if (!ctx) {
+        ctx.reset(new CollisionStateContext);
+        ctx->rcs = std::make_shared<RobotCollisionState>(m_rcm.get());
+        ctx->abcs = std::make_shared<AttachedBodiesCollisionState>(
+                m_abcm.get(), ctx->rcs.get());
+        ctx->scm = std::make_shared<SelfCollisionModel>(
+                m_grid, m_rcm.get(), m_abcm.get());
+        ctx->config_version = 0;
+    }
+
+    if (ctx->config_version != m_context_config_version) {
+        seedContextConfiguration(*ctx);
+    }
+
+    // seed the full variable state so that non-planning variables match the
+    // current state of the collision space
+    ctx->joint_vars = m_joint_vars;
+
+    return ctx;
+}
+
+void CollisionSpace::checkinCollisionState(CollisionStateContextPtr ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_context_pool_mutex);
+    m_context_pool.push_back(std::move(ctx));
+}
+
+bool CollisionSpace::checkCollision(
+    CollisionStateContext& ctx,
+    const double* state,
+    double& dist)
+{
+    updateState(ctx.joint_vars, state);
+    ctx.rcs->setJointVarPositions(ctx.joint_vars.data());
+    return ctx.scm->checkCollision(*ctx.rcs, *ctx.abcs, m_gidx, dist);
+}
+
+bool CollisionSpace::isStateValid(
+    CollisionStateContext& ctx,
+    const RobotState& state)
+{
+    assert(state.size() == m_planning_joint_to_collision_model_indices.size());
+    double dist = std::numeric_limits<double>::max();
+    return checkCollision(ctx, state.data(), dist);
+}
+
+// Build the per-worker collision checking contexts if they do not exist yet
+// or the requested worker count has changed.
+void CollisionSpace::ensureMotionValidationContexts()
+{
+    if ((int)m_motion_validation_contexts.size() ==
+            m_num_motion_validation_threads)
+    {
+        return;
+    }
+
+    ROS_DEBUG_NAMED(LOG, "Build %d motion validation contexts", m_num_motion_validation_threads);
+
+    m_motion_validation_contexts.clear();
+    m_motion_validation_contexts.resize(m_num_motion_validation_threads);
+    for (auto& ctx : m_motion_validation_contexts) {
+        ctx.rcs = std::make_shared<RobotCollisionState>(m_rcm.get());
+        ctx.abcs = std::make_shared<AttachedBodiesCollisionState>(
+                m_abcm.get(), ctx.rcs.get());
+        ctx.scm = std::make_shared<SelfCollisionModel>(
+                m_grid, m_rcm.get(), m_abcm.get());
+        seedContextConfiguration(ctx);
+    }
+}
+
+/// \brief Enable or disable clearance-adaptive validation of interpolated
+///     motions
+void CollisionSpace::setClearanceAdaptiveMotionValidation(bool enable)
+{
+    m_clearance_adaptive_motion_validation = enable;
+}
+
+// Validate the waypoints of an interpolated motion, skipping the waypoints
+// provably covered by the clearance of an already-validated one. The
+// interpolation bounds the motion of every sphere between consecutive
+// waypoints by its resolution, so k steps past a waypoint validated with
+// clearance c, no sphere has moved more than k * res toward a world obstacle
+// and no sphere pair has closed by more than 2 * k * res; waypoints with
+// 2 * k * res below the clearance, less one grid resolution of margin for
+// the discretization of the distance map, cannot collide. Open segments then
+// cost a few checks while tight segments degrade to checking every waypoint.
+bool CollisionSpace::isStateToStateValidAdaptive(
+    const MotionInterpolation& interp,
+    double res,
+    bool verbose)
+{
+    const double margin = m_grid->resolution();
+
+    RobotState interm;
+    const int count = interp.waypointCount();
+    int i = 0;
+    while (i < count) {
+        interp.interpolate(i, interm, m_planning_joint_to_collision_model_indices);
+
+        double dist = std::numeric_limits<double>::max();
+        if (!checkCollision(interm.data(), dist)) {
+            return false;
+        }
+
+        int skip = 1;
+        if (dist > margin) {
+            skip = std::max(1, (int)((dist - margin) / (2.0 * res)));
+        }
+        i += skip;
+    }
+
+    return true;
+}
+
+// Validate the waypoints of an interpolated motion across the worker contexts.
+// Waypoints are handed out through a shared counter and workers abandon the
+// remaining waypoints once any worker finds a collision.
+bool CollisionSpace::isStateToStateValidParallel(
+    const MotionInterpolation& interp,
+    bool verbose)
+{
+    ensureMotionValidationContexts();
+
+    std::atomic<bool> invalid(false);
+    std::atomic<int> next(0);
+
+    auto worker = [&](CollisionStateContext& ctx) {
+        // seed the full variable state so that non-planning variables match
+        // the current state of the collision space
+        ctx.joint_vars = m_joint_vars;
+
+        RobotState interm;
+        while (!invalid.load(std::memory_order_relaxed)) {
+            const int i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= interp.waypointCount()) {
+                break;
+            }
+
+            interp.interpolate(
+                    i, interm, m_planning_joint_to_collision_model_indices);
+            for (size_t vi = 0;
+                vi < m_planning_joint_to_collision_model_indices.size(); ++vi)
+            {
+                const int jidx = m_planning_joint_to_collision_model_indices[vi];
+                ctx.joint_vars[jidx] = interm[vi];
+            }
+            ctx.rcs->setJointVarPositions(ctx.joint_vars.data());
+
+            double dist;
+            if (!ctx.scm->checkCollision(*ctx.rcs, *ctx.abcs, m_gidx, dist)) {
+                invalid.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(m_motion_validation_contexts.size() - 1);
+    for (size_t i = 1; i < m_motion_validation_contexts.size(); ++i) {
+        threads.emplace_back(worker, std::ref(m_motion_validation_contexts[i]));
+    }
+    worker(m_motion_validation_contexts[0]);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return !invalid.load();
+}
+
 bool CollisionSpace::interpolatePath(
     const RobotState& start,
     const RobotState& finish,
@@ -638,7 +1065,7 @@ void CollisionSpace::copyState()
 /// \brief Check whether the planning joint variables are within limits
 /// \return true if all variables are within limits; false otherwise
 bool CollisionSpace::withinJointPositionLimits(
-    const std::vector<double>& positions) const
+    const RobotState& positions) const
 {
     assert(positions.size() == planningVariableCount());
     for (size_t vidx = 0; vidx < planningVariableCount(); ++vidx) {
@@ -368,6 +368,172 @@ void ConvertCollisionObjectMsgToCollisionObject(
     out = std::move(o);
 }
 
+// The message layouts store each vertex as three contiguous float64 and each
+// triangle as three contiguous uint32, so the message buffers may be
+// referenced as packed coordinate and index arrays without copying.
+static_assert(sizeof(geometry_msgs::Point) == 3 * sizeof(double),
+        "geometry_msgs::Point is not a packed double triple");
+static_assert(sizeof(shape_msgs::MeshTriangle) == 3 * sizeof(std::uint32_t),
+        "shape_msgs::MeshTriangle is not a packed index triple");
+
+// Construct a CollisionShape referencing the vertex and index buffers of a
+// Mesh message in place. Only the mesh shape itself is allocated; the caller
+// must keep the message alive for the lifetime of the shape and free the
+// shape without freeing the referenced arrays.
+static auto ConstructShapeViewFromMsg(const shape_msgs::Mesh& mesh)
+    -> CollisionShape*
+{
+    auto* m = new MeshShape;
+    if (!mesh.vertices.empty()) {
+        // the view is read-only by convention
+        m->vertices = const_cast<double*>(&mesh.vertices[0].x);
+    }
+    if (!mesh.triangles.empty()) {
+        m->triangles = const_cast<std::uint32_t*>(
+                &mesh.triangles[0].vertex_indices[0]);
+    }
+    m->vertex_count = mesh.vertices.size();
+    m->triangle_count = mesh.triangles.size();
+    return m;
+}
+
+// moveit_msgs::CollisionObject -> scdl::CollisionObject view
+void ConvertCollisionObjectMsgToCollisionObjectView(
+    const moveit_msgs::CollisionObjectConstPtr& in,
+    CollisionObjectView& out)
+{
+    assert(in->primitives.size() == in->primitive_poses.size());
+    assert(in->meshes.size() == in->mesh_poses.size());
+    assert(in->planes.size() == in->plane_poses.size());
+
+    CollisionObjectView v;
+    v.object.id = in->id;
+    v.message = in;
+
+    auto shape_count =
+            in->planes.size() + in->primitives.size() + in->meshes.size();
+    v.object.shapes.reserve(shape_count);
+    v.object.shape_poses.reserve(shape_count);
+
+    for (size_t pidx = 0; pidx < in->primitives.size(); ++pidx) {
+        auto& prim = in->primitives[pidx];
+        auto& pose = in->primitive_poses[pidx];
+
+        auto* sp = ConstructShapeFromMsg(prim);
+        if (!sp) {
+            ROS_WARN("Failed to construct shape from primitive message");
+            continue;
+        }
+
+        Eigen::Affine3d transform;
+        tf::poseMsgToEigen(pose, transform);
+
+        v.object.shapes.push_back(sp);
+        v.object.shape_poses.push_back(transform);
+    }
+
+    for (size_t midx = 0; midx < in->meshes.size(); ++midx) {
+        auto& mesh = in->meshes[midx];
+        auto& pose = in->mesh_poses[midx];
+
+        auto* sp = ConstructShapeViewFromMsg(mesh);
+
+        Eigen::Affine3d transform;
+        tf::poseMsgToEigen(pose, transform);
+
+        v.object.shapes.push_back(sp);
+        v.object.shape_poses.push_back(transform);
+    }
+
+    for (size_t pidx = 0; pidx < in->planes.size(); ++pidx) {
+        auto& plane = in->planes[pidx];
+        auto& pose = in->plane_poses[pidx];
+
+        auto* sp = ConstructShapeFromMsg(plane);
+        if (!sp) {
+            ROS_ERROR("Failed to construct shape from plane message");
+            continue;
+        }
+
+        Eigen::Affine3d transform;
+        tf::poseMsgToEigen(pose, transform);
+
+        v.object.shapes.push_back(sp);
+        v.object.shape_poses.push_back(transform);
+    }
+
+    out = std::move(v);
+}
+
+// Deep-copy a view's shapes into an independently-owned CollisionObject.
+void MaterializeCollisionObjectView(
+    const CollisionObjectView& in,
+    CollisionObject& out)
+{
+    CollisionObject o;
+    o.id = in.object.id;
+
+    o.shapes.reserve(in.object.shapes.size());
+    o.shape_poses.reserve(in.object.shapes.size());
+    for (size_t i = 0; i < in.object.shapes.size(); ++i) {
+        auto* shape = in.object.shapes[i];
+        auto& pose = in.object.shape_poses[i];
+
+        if (shape->type == ShapeType::Mesh) {
+            auto* s = static_cast<const MeshShape*>(shape);
+
+            auto vertices = new double[3 * s->vertex_count];
+            auto triangles = new std::uint32_t[3 * s->triangle_count];
+
+            std::copy(s->vertices, s->vertices + 3 * s->vertex_count, vertices);
+            std::copy(s->triangles, s->triangles + 3 * s->triangle_count, triangles);
+
+            auto* ms = new MeshShape;
+            ms->vertices = vertices;
+            ms->vertex_count = s->vertex_count;
+            ms->triangles = triangles;
+            ms->triangle_count = s->triangle_count;
+            o.shapes.push_back(ms);
+        } else {
+            // primitives and planes carry no external data
+            switch (shape->type) {
+            case ShapeType::Sphere:
+                o.shapes.push_back(new SphereShape(
+                        *static_cast<const SphereShape*>(shape)));
+                break;
+            case ShapeType::Cylinder:
+                o.shapes.push_back(new CylinderShape(
+                        *static_cast<const CylinderShape*>(shape)));
+                break;
+            case ShapeType::Cone:
+                o.shapes.push_back(new ConeShape(
+                        *static_cast<const ConeShape*>(shape)));
+                break;
+            case ShapeType::Box:
+                o.shapes.push_back(new BoxShape(
+                        *static_cast<const BoxShape*>(shape)));
+                break;
+            case ShapeType::Plane:
+                o.shapes.push_back(new PlaneShape(
+                        *static_cast<const PlaneShape*>(shape)));
+                break;
+            default:
+                continue;
+            }
+        }
+        o.shape_poses.push_back(pose);
+    }
+
+    out = std::move(o);
+}
+
+void FreeCollisionObjectView(CollisionObjectView& view)
+{
+    // the mesh vertex and index arrays belong to the pinned message
+    FreeManagedCollisionObjectShallow(view.object);
+    view.message.reset();
+}
+
 // collision_detection::World -> moveit_msgs::CollisionObject
 void ConvertWorldObjectToCollisionObjectMsg(
     const collision_detection::World::Object& in,
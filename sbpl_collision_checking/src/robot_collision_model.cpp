@@ -34,9 +34,19 @@
 
 // standard includes
 #include <assert.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <stack>
+#include <thread>
 #include <utility>
 
 // system includes
@@ -58,6 +68,63 @@ namespace collision {
 
 static const char* LOG = "robot_model";
 
+// Version of the voxels model cache file format. Bump whenever the layout of
+// the cache file or the meaning of the key hash changes.
+static const uint32_t VoxelsCacheVersion = 1;
+static const uint32_t VoxelsCacheMagic = 0x4C504D53; // "SMPL"
+
+static std::string g_voxels_cache_dir;
+
+static uint64_t HashBytes(uint64_t h, const void* data, size_t len)
+{
+    // FNV-1a
+    const unsigned char* s = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (uint64_t)s[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+static uint64_t HashString(uint64_t h, const std::string& s)
+{
+    return HashBytes(h, s.data(), s.size());
+}
+
+static uint64_t HashDouble(uint64_t h, double d)
+{
+    return HashBytes(h, &d, sizeof(d));
+}
+
+// Cursor over a read-only mapping of a cache file, bounds-checked so that a
+// truncated or corrupt file fails the load instead of reading past the end.
+struct CacheCursor
+{
+    const char* pos;
+    size_t remaining;
+};
+
+static bool CacheRead(CacheCursor& c, void* out, size_t len)
+{
+    if (c.remaining < len) {
+        return false;
+    }
+    memcpy(out, c.pos, len);
+    c.pos += len;
+    c.remaining -= len;
+    return true;
+}
+
+void RobotCollisionModel::SetVoxelsCacheDirectory(const std::string& dir)
+{
+    g_voxels_cache_dir = dir;
+}
+
+const std::string& RobotCollisionModel::VoxelsCacheDirectory()
+{
+    return g_voxels_cache_dir;
+}
+
 auto RobotCollisionModel::Load(
     const ::urdf::ModelInterface& urdf,
     const CollisionModelConfig& config)
@@ -581,11 +648,61 @@ bool RobotCollisionModel::initCollisionModel(
     m_voxels_models.resize(config.voxel_models.size());
     for (size_t i = 0; i < m_voxels_models.size(); ++i) {
         CollisionVoxelsModel& voxels_model = m_voxels_models[i];
-        const std::string& link_name = config.voxel_models[i].link_name;
-        voxels_model.link_index = linkIndex(link_name);
+        voxels_model.link_index = linkIndex(config.voxel_models[i].link_name);
         voxels_model.voxel_res = config.voxel_models[i].res;
-        if (!voxelizeLink(urdf, link_name, voxels_model)) {
-            ROS_ERROR_NAMED(LOG, "Failed to voxelize link '%s'", link_name.c_str());
+    }
+
+    uint64_t cache_key = 0;
+    std::string cache_path;
+    bool cached = false;
+    if (!VoxelsCacheDirectory().empty()) {
+        cache_key = hashVoxelsModelInputs(urdf, config);
+        char key_str[17];
+        snprintf(key_str, sizeof(key_str), "%016" PRIx64, cache_key);
+        cache_path = VoxelsCacheDirectory() + "/" + urdf.getName() + "." +
+                key_str + ".voxels";
+        cached = loadVoxelsModels(cache_path, cache_key, config);
+        if (cached) {
+            ROS_INFO_NAMED(LOG, "Loaded voxels models from cache '%s'", cache_path.c_str());
+        }
+    }
+
+    if (!cached) {
+        // links voxelize independently of one another; workers claim link
+        // indices from a shared counter and write only their own model
+        auto voxelize = [&](size_t i) {
+            CollisionVoxelsModel& voxels_model = m_voxels_models[i];
+            const std::string& link_name = config.voxel_models[i].link_name;
+            if (!voxelizeLink(urdf, link_name, voxels_model)) {
+                ROS_ERROR_NAMED(LOG, "Failed to voxelize link '%s'", link_name.c_str());
+            }
+        };
+
+        const size_t num_threads = std::min(
+                m_voxels_models.size(),
+                (size_t)std::thread::hardware_concurrency());
+        if (num_threads > 1) {
+            std::atomic<size_t> next(0);
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < num_threads; ++t) {
+                workers.emplace_back([&]() {
+                    size_t i;
+                    while ((i = next.fetch_add(1)) < m_voxels_models.size()) {
+                        voxelize(i);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        } else {
+            for (size_t i = 0; i < m_voxels_models.size(); ++i) {
+                voxelize(i);
+            }
+        }
+
+        if (!cache_path.empty() && !saveVoxelsModels(cache_path, cache_key, config)) {
+            ROS_WARN_NAMED(LOG, "Failed to save voxels models to cache '%s'", cache_path.c_str());
         }
     }
 
@@ -1189,6 +1306,23 @@ bool RobotCollisionModel::voxelizeGeometry(
 
         ROS_DEBUG_NAMED(LOG, "mesh: %s  triangles: %zu  vertices: %zu", mesh->filename.c_str(), triangles.size(), vertices.size());
 
+        // pre-size from the mesh bounds: surface voxelization yields on the
+        // order of one voxel per res^2 patch of bounding box surface
+        if (!vertices.empty()) {
+            Eigen::Vector3d bb_min = vertices.front();
+            Eigen::Vector3d bb_max = vertices.front();
+            for (const Eigen::Vector3d& v : vertices) {
+                bb_min = bb_min.cwiseMin(v);
+                bb_max = bb_max.cwiseMax(v);
+            }
+            const Eigen::Vector3d extents = bb_max - bb_min;
+            const double surface_area = 2.0 *
+                    (extents.x() * extents.y() +
+                    extents.y() * extents.z() +
+                    extents.z() * extents.x());
+            voxels.reserve(voxels.size() + (size_t)(surface_area / (res * res)));
+        }
+
         geometry::VoxelizeMesh(vertices, triangles, pose, res, voxels, false);
         ROS_DEBUG_NAMED(LOG, " -> voxels: %zu", voxels.size());
     }
@@ -1218,5 +1352,193 @@ bool RobotCollisionModel::voxelizeGeometry(
     return true;
 }
 
+std::uint64_t RobotCollisionModel::hashVoxelsModelInputs(
+    const ::urdf::ModelInterface& urdf,
+    const CollisionModelConfig& config) const
+{
+    // Hash everything voxelization depends on: the voxel model configuration
+    // and, for each voxelized link, the poses and shape parameters of its
+    // collision elements. Mesh contents are keyed by resource name, so a
+    // mesh edited in place without renaming will hit a stale cache entry.
+    uint64_t h = 0xCBF29CE484222325ull; // FNV offset basis
+
+    auto hash_geometry = [&](const ::urdf::Geometry& geom) {
+        uint32_t type = (uint32_t)geom.type;
+        h = HashBytes(h, &type, sizeof(type));
+        if (geom.type == ::urdf::Geometry::MESH) {
+            ::urdf::Mesh* mesh = (::urdf::Mesh*)&geom;
+            h = HashString(h, mesh->filename);
+            h = HashDouble(h, mesh->scale.x);
+            h = HashDouble(h, mesh->scale.y);
+            h = HashDouble(h, mesh->scale.z);
+        } else if (geom.type == ::urdf::Geometry::BOX) {
+            ::urdf::Box* box = (::urdf::Box*)&geom;
+            h = HashDouble(h, box->dim.x);
+            h = HashDouble(h, box->dim.y);
+            h = HashDouble(h, box->dim.z);
+        } else if (geom.type == ::urdf::Geometry::CYLINDER) {
+            ::urdf::Cylinder* cyl = (::urdf::Cylinder*)&geom;
+            h = HashDouble(h, cyl->radius);
+            h = HashDouble(h, cyl->length);
+        } else if (geom.type == ::urdf::Geometry::SPHERE) {
+            ::urdf::Sphere* sph = (::urdf::Sphere*)&geom;
+            h = HashDouble(h, sph->radius);
+        }
+    };
+
+    auto hash_collision = [&](const ::urdf::Collision& collision) {
+        const ::urdf::Pose& pose = collision.origin;
+        h = HashDouble(h, pose.position.x);
+        h = HashDouble(h, pose.position.y);
+        h = HashDouble(h, pose.position.z);
+        h = HashDouble(h, pose.rotation.x);
+        h = HashDouble(h, pose.rotation.y);
+        h = HashDouble(h, pose.rotation.z);
+        h = HashDouble(h, pose.rotation.w);
+        if (collision.geometry) {
+            hash_geometry(*collision.geometry);
+        }
+    };
+
+    for (const auto& voxels_config : config.voxel_models) {
+        h = HashString(h, voxels_config.link_name);
+        h = HashDouble(h, voxels_config.res);
+
+        auto link = urdf.getLink(voxels_config.link_name);
+        if (!link) {
+            continue;
+        }
+        if (link->collision) {
+            hash_collision(*link->collision);
+        }
+        for (const auto& collision : link->collision_array) {
+            if (collision) {
+                hash_collision(*collision);
+            }
+        }
+    }
+
+    return h;
+}
+
+bool RobotCollisionModel::loadVoxelsModels(
+    const std::string& path,
+    std::uint64_t key,
+    const CollisionModelConfig& config)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+
+    size_t file_size = (size_t)st.st_size;
+    void* base = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    CacheCursor c = { (const char*)base, file_size };
+
+    bool valid = false;
+    uint32_t magic, version, count;
+    uint64_t file_key;
+    if (CacheRead(c, &magic, sizeof(magic)) &&
+        CacheRead(c, &version, sizeof(version)) &&
+        CacheRead(c, &file_key, sizeof(file_key)) &&
+        CacheRead(c, &count, sizeof(count)) &&
+        magic == VoxelsCacheMagic &&
+        version == VoxelsCacheVersion &&
+        file_key == key &&
+        count == (uint32_t)config.voxel_models.size())
+    {
+        valid = true;
+        for (uint32_t i = 0; valid && i < count; ++i) {
+            uint32_t name_len;
+            valid = CacheRead(c, &name_len, sizeof(name_len));
+            valid = valid && name_len == config.voxel_models[i].link_name.size();
+
+            std::string link_name(name_len, '\0');
+            valid = valid && CacheRead(c, &link_name[0], name_len);
+            valid = valid && link_name == config.voxel_models[i].link_name;
+
+            double res;
+            uint64_t voxel_count;
+            valid = valid && CacheRead(c, &res, sizeof(res));
+            valid = valid && res == config.voxel_models[i].res;
+            valid = valid && CacheRead(c, &voxel_count, sizeof(voxel_count));
+            valid = valid && c.remaining >= 3 * voxel_count * sizeof(double);
+
+            if (valid) {
+                CollisionVoxelsModel& model = m_voxels_models[i];
+                model.voxels.resize(voxel_count);
+                for (uint64_t j = 0; j < voxel_count; ++j) {
+                    double v[3];
+                    CacheRead(c, v, sizeof(v));
+                    model.voxels[j] = Eigen::Vector3d(v[0], v[1], v[2]);
+                }
+            }
+        }
+    }
+
+    munmap(base, file_size);
+
+    if (!valid) {
+        for (CollisionVoxelsModel& model : m_voxels_models) {
+            model.voxels.clear();
+        }
+    }
+    return valid;
+}
+
+bool RobotCollisionModel::saveVoxelsModels(
+    const std::string& path,
+    std::uint64_t key,
+    const CollisionModelConfig& config) const
+{
+    // write to a temporary alongside the target and rename it into place so
+    // that concurrent starts never observe a partially written cache file
+    std::string tmp_path = path + ".tmp";
+    FILE* f = fopen(tmp_path.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+
+    bool ok = true;
+    uint32_t count = (uint32_t)m_voxels_models.size();
+    ok = ok && fwrite(&VoxelsCacheMagic, sizeof(VoxelsCacheMagic), 1, f) == 1;
+    ok = ok && fwrite(&VoxelsCacheVersion, sizeof(VoxelsCacheVersion), 1, f) == 1;
+    ok = ok && fwrite(&key, sizeof(key), 1, f) == 1;
+    ok = ok && fwrite(&count, sizeof(count), 1, f) == 1;
+
+    for (size_t i = 0; ok && i < m_voxels_models.size(); ++i) {
+        const CollisionVoxelsModel& model = m_voxels_models[i];
+        const std::string& link_name = config.voxel_models[i].link_name;
+        uint32_t name_len = (uint32_t)link_name.size();
+        uint64_t voxel_count = (uint64_t)model.voxels.size();
+        ok = ok && fwrite(&name_len, sizeof(name_len), 1, f) == 1;
+        ok = ok && fwrite(link_name.data(), 1, name_len, f) == name_len;
+        ok = ok && fwrite(&model.voxel_res, sizeof(model.voxel_res), 1, f) == 1;
+        ok = ok && fwrite(&voxel_count, sizeof(voxel_count), 1, f) == 1;
+        for (const Eigen::Vector3d& voxel : model.voxels) {
+            double v[3] = { voxel.x(), voxel.y(), voxel.z() };
+            ok = ok && fwrite(v, sizeof(v), 1, f) == 1;
+        }
+    }
+
+    ok = fclose(f) == 0 && ok;
+    ok = ok && rename(tmp_path.c_str(), path.c_str()) == 0;
+    if (!ok) {
+        remove(tmp_path.c_str());
+    }
+    return ok;
+}
+
 } // namespace collision
 } // namespace smpl
@@ -89,6 +89,12 @@ bool RobotCollisionState::setJointVarPosition(int vidx, double position)
                 m_dirty_voxels_states[dvsidx] = true;
             }
 
+            // dirty the sphere state of any group containing the link
+            for (int gidx : m_link_sphere_groups[lidx]) {
+                m_dirty_group_spheres[gidx] = true;
+                m_dirty_group_sphere_arrays[gidx] = true;
+            }
+
             // add child links to the queue
             for (int cjidx : m_model->linkChildJointIndices(lidx)) {
                 q.push_back(m_model->jointChildLinkIndex(cjidx));
@@ -135,31 +141,67 @@ bool RobotCollisionState::setJointVarPositions(const double* positions)
         return false;
     }
 
-    std::vector<int>& q = m_q;
-    q.clear();
-    for (int ancestor : ancestors) {
-        q.push_back(m_model->jointChildLinkIndex(ancestor));
-    }
-    while (!q.empty()) {
-        int lidx = q.back();
-        q.pop_back();
+    if (ancestors != m_last_ancestors) {
+        // Rebuild the affected-set memo by walking the subtrees below the
+        // most ancestral moved joints. Consecutive waypoints of an
+        // interpolated motion move the same variables, so the subtree walk
+        // is paid once per motion rather than once per waypoint.
+        m_affected_links.clear();
+        m_affected_voxel_states.clear();
 
-        ROS_DEBUG_NAMED(RCS_LOGGER, "Dirtying transform to link '%s'", m_model->linkName(lidx).c_str());
+        std::vector<int>& q = m_q;
+        q.clear();
+        for (int ancestor : ancestors) {
+            q.push_back(m_model->jointChildLinkIndex(ancestor));
+        }
+        while (!q.empty()) {
+            int lidx = q.back();
+            q.pop_back();
 
-        // dirty the transform of the affected link
-        m_dirty_link_transforms[lidx] = true;
+            ROS_DEBUG_NAMED(RCS_LOGGER, "Dirtying transform to link '%s'", m_model->linkName(lidx).c_str());
+
+            // the transform of the affected link
+            m_affected_links.push_back(lidx);
 
-        // dirty the voxels states of any attached voxels model
-        CollisionVoxelsState* voxels_state = m_link_voxels_states[lidx];
-        if (voxels_state) {
-            int dvsidx = std::distance(m_voxels_states.data(), voxels_state);
-            m_dirty_voxels_states[dvsidx] = true;
+            // the voxels states of any attached voxels model
+            CollisionVoxelsState* voxels_state = m_link_voxels_states[lidx];
+            if (voxels_state) {
+                int dvsidx = std::distance(m_voxels_states.data(), voxels_state);
+                m_affected_voxel_states.push_back(dvsidx);
+            }
+
+            // add child links to the queue
+            for (int cjidx : m_model->linkChildJointIndices(lidx)) {
+                q.push_back(m_model->jointChildLinkIndex(cjidx));
+            }
         }
 
-        // add child links to the queue
-        for (int cjidx : m_model->linkChildJointIndices(lidx)) {
-            q.push_back(m_model->jointChildLinkIndex(cjidx));
+        // the groups with a spheres state on any affected link
+        m_affected_groups.clear();
+        for (int lidx : m_affected_links) {
+            for (int gidx : m_link_sphere_groups[lidx]) {
+                if (std::find(
+                        m_affected_groups.begin(),
+                        m_affected_groups.end(),
+                        gidx) == m_affected_groups.end())
+                {
+                    m_affected_groups.push_back(gidx);
+                }
+            }
         }
+
+        m_last_ancestors = ancestors;
+    }
+
+    for (int lidx : m_affected_links) {
+        m_dirty_link_transforms[lidx] = true;
+    }
+    for (int dvsidx : m_affected_voxel_states) {
+        m_dirty_voxels_states[dvsidx] = true;
+    }
+    for (int gidx : m_affected_groups) {
+        m_dirty_group_spheres[gidx] = true;
+        m_dirty_group_sphere_arrays[gidx] = true;
     }
 
     return true;
@@ -335,6 +377,50 @@ void RobotCollisionState::initCollisionState()
         }
     }
 
+    // map link -> groups with a spheres state on the link, so that joint
+    // updates dirty exactly the groups whose spheres they can move
+    m_link_sphere_groups.assign(m_model->linkCount(), std::vector<int>());
+    for (size_t gidx = 0; gidx < m_model->groupCount(); ++gidx) {
+        for (int ssidx : m_group_states[gidx].spheres_indices) {
+            const int lidx = m_spheres_states[ssidx].model->link_index;
+            m_link_sphere_groups[lidx].push_back((int)gidx);
+        }
+    }
+    m_dirty_group_spheres.assign(m_model->groupCount(), true);
+    m_dirty_group_sphere_arrays.assign(m_model->groupCount(), true);
+
+    // lay out the structure-of-arrays sphere mirror of each group; the leaf
+    // spheres of every spheres state in the group occupy a contiguous range
+    // of the arrays, so groupSphereArrays() can refresh them per spheres
+    // state; positions are left stale here (versions = -1) and filled in on
+    // first access
+    m_group_sphere_arrays.assign(
+            m_model->groupCount(), CollisionGroupSphereArrays());
+    for (size_t gidx = 0; gidx < m_model->groupCount(); ++gidx) {
+        CollisionGroupSphereArrays& arrays = m_group_sphere_arrays[gidx];
+        const std::vector<int>& ssindices =
+                m_group_states[gidx].spheres_indices;
+        arrays.versions.assign(ssindices.size(), -1);
+        for (const int ssidx : ssindices) {
+            arrays.offsets.push_back((int)arrays.sphere_states.size());
+            const CollisionSpheresState& spheres_state =
+                    m_spheres_states[ssidx];
+            for (const CollisionSphereState& sphere_state :
+                    spheres_state.spheres)
+            {
+                if (!sphere_state.isLeaf()) {
+                    continue;
+                }
+                arrays.sphere_states.push_back(&sphere_state);
+                arrays.r.push_back(sphere_state.model->radius);
+            }
+        }
+        arrays.offsets.push_back((int)arrays.sphere_states.size());
+        arrays.x.assign(arrays.sphere_states.size(), 0.0);
+        arrays.y.assign(arrays.sphere_states.size(), 0.0);
+        arrays.z.assign(arrays.sphere_states.size(), 0.0);
+    }
+
     // initialize link voxels states
     m_link_voxels_states.assign(m_model->linkCount(), nullptr);
     for (int i = 0; i < m_voxels_states.size(); ++i) {
@@ -31,6 +31,11 @@
 
 #include <sbpl_collision_checking/self_collision_model.h>
 
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 // system includes
 #include <leatherman/print.h>
 #include <smpl/geometry/triangle.h>
@@ -60,8 +65,16 @@ SelfCollisionModel::SelfCollisionModel(
     m_checked_spheres_states(),
     m_checked_attached_body_spheres_states(),
     m_checked_attached_body_robot_spheres_states(),
+    m_checked_spheres_hits(),
+    m_checked_attached_body_spheres_hits(),
+    m_checked_attached_body_robot_spheres_hits(),
     m_acm(),
     m_padding(0.0),
+    m_aci(nullptr),
+    m_aci_abcm_version(-1),
+    m_aci_mask_rows(),
+    m_aci_mask_stride(0),
+    m_aci_body_entities(),
 #if SCDL_USE_META_TREE
     m_model_state_map(),
     m_root_models(),
@@ -154,6 +167,18 @@ SelfCollisionModel::allowedCollisionMatrix() const
     return m_acm;
 }
 
+// Test whether collisions between a pair of entities are allowed by an
+// allowed collision matrix; pairs without an entry are checked.
+static bool CollisionAllowed(
+    const AllowedCollisionMatrix& acm,
+    const std::string& entry1,
+    const std::string& entry2)
+{
+    collision_detection::AllowedCollision::Type type;
+    return acm.getEntry(entry1, entry2, type) &&
+            type == collision_detection::AllowedCollision::ALWAYS;
+}
+
 /// Update the allowed collision matrix, removing entries specified as NEVER and
 /// adding entries specified as ALWAYS in the input matrix
 void SelfCollisionModel::updateAllowedCollisionMatrix(
@@ -164,30 +189,47 @@ void SelfCollisionModel::updateAllowedCollisionMatrix(
 
     acm.getAllEntryNames(all_entries);
 
+    // apply only the entries whose effective allowed value differs from the
+    // current matrix and patch the checked sphere indices for those pairs,
+    // rather than rebuilding the full pair structure; per-request matrices
+    // usually differ from the previous one by a handful of entries
+    std::vector<std::pair<std::string, std::string>> changed;
+
     collision_detection::AllowedCollision::Type type;
     for (size_t i = 0; i < all_entries.size(); ++i) {
         for (size_t j = i + 1; j < all_entries.size(); ++j) {
             const std::string& entry1 = all_entries[i];
             const std::string& entry2 = all_entries[j];
             if (acm.getEntry(entry1, entry2, type)) {
-                if (type != collision_detection::AllowedCollision::NEVER) {
-                    m_acm.setEntry(entry1, entry2, false);
-                }
-                else {
-                    m_acm.setEntry(entry1, entry2, true);
+                const bool allowed =
+                        type == collision_detection::AllowedCollision::NEVER;
+                if (allowed == CollisionAllowed(m_acm, entry1, entry2)) {
+                    continue;
                 }
+                m_acm.setEntry(entry1, entry2, allowed);
+                changed.emplace_back(entry1, entry2);
             }
         }
     }
-    updateCheckedSpheresIndices();
+
+    if (!changed.empty()) {
+        patchCheckedSpheresIndices(changed);
+    }
 }
 
 void SelfCollisionModel::setAllowedCollisionMatrix(
     const AllowedCollisionMatrix& acm)
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Overwrite allowed collision matrix");
+
+    std::vector<std::pair<std::string, std::string>> changed;
+    diffAllowedCollisionMatrix(acm, changed);
+
     m_acm = acm;
-    updateCheckedSpheresIndices();
+
+    if (!changed.empty()) {
+        patchCheckedSpheresIndices(changed);
+    }
 }
 
 /// Set the padding to be applied to spheres. No padding is applied to voxels
@@ -215,6 +257,10 @@ bool SelfCollisionModel::checkCollision(
 
     prepareState(gidx, state.getJointVarPositions());
 
+    // each check lowers dist to a conservative clearance estimate when it
+    // finds no collision, so a successful check reports the minimum clearance
+    // found over all checks
+    dist = std::numeric_limits<double>::max();
     if (!checkRobotVoxelsStateCollisions(dist) ||
         !checkAttachedBodyVoxelsStateCollisions(dist) ||
         !checkRobotSpheresStateCollisions(dist) ||
@@ -239,6 +285,8 @@ bool SelfCollisionModel::checkCollision(
 
     prepareState(gidx, state.getJointVarPositions());
 
+    // see note in the overload above
+    dist = std::numeric_limits<double>::max();
     if (!checkRobotVoxelsStateCollisions(dist) ||
         !checkAttachedBodyVoxelsStateCollisions(dist) ||
         !checkRobotSpheresStateCollisions(aci, dist) ||
@@ -250,6 +298,28 @@ bool SelfCollisionModel::checkCollision(
     return true;
 }
 
+bool SelfCollisionModel::checkVoxelsCollision(
+    const RobotCollisionState& state,
+    const AttachedBodiesCollisionState& ab_state,
+    const int gidx,
+    double& dist)
+{
+    if (!checkCommonInputs(state, ab_state, gidx)) {
+        return false;
+    }
+
+    prepareState(gidx, state.getJointVarPositions());
+
+    dist = std::numeric_limits<double>::max();
+    if (!checkRobotVoxelsStateCollisions(dist) ||
+        !checkAttachedBodyVoxelsStateCollisions(dist))
+    {
+        return false;
+    }
+
+    return true;
+}
+
 bool SelfCollisionModel::checkMotionCollision(
     RobotCollisionState& state,
     AttachedBodiesCollisionState& ab_state,
@@ -263,13 +333,24 @@ bool SelfCollisionModel::checkMotionCollision(
     MotionInterpolation interp(m_rcm);
     rmcm.fillMotionInterpolation(start, finish, res, interp);
 
+    // conservative advancement: adjacent waypoints are spaced so that no
+    // sphere moves by more than res between them, and successful checks
+    // report a conservative clearance, so any waypoint within the clearance
+    // of the last checked waypoint is also collision free and may be skipped
     RobotState interm;
-    for (int i = 0; i < interp.waypointCount(); ++i) {
+    int i = 0;
+    while (i < interp.waypointCount()) {
         interp.interpolate(i, interm);
         state.setJointVarPositions(interm.data());
         if (!checkCollision(state, ab_state, gidx, dist)) {
             return false;
         }
+
+        const double skip = dist / res;
+        if (skip >= (double)(interp.waypointCount() - i)) {
+            break; // the remaining waypoints lie within the clearance
+        }
+        i += std::max(1, (int)skip);
     }
     return true;
 }
@@ -288,13 +369,21 @@ bool SelfCollisionModel::checkMotionCollision(
     MotionInterpolation interp(m_rcm);
     rmcm.fillMotionInterpolation(start, finish, res, interp);
 
+    // see notes on conservative advancement above
     RobotState interm;
-    for (int i = 0; i < interp.waypointCount(); ++i) {
+    int i = 0;
+    while (i < interp.waypointCount()) {
         interp.interpolate(i, interm);
         state.setJointVarPositions(interm.data());
         if (!checkCollision(state, ab_state, aci, gidx, dist)) {
             return false;
         }
+
+        const double skip = dist / res;
+        if (skip >= (double)(interp.waypointCount() - i)) {
+            break; // the remaining waypoints lie within the clearance
+        }
+        i += std::max(1, (int)skip);
     }
     return true;
 }
@@ -656,7 +745,21 @@ bool SelfCollisionModel::checkRobotVoxelsStateCollisions(double& dist)
     }
 #endif
 
-    return CheckVoxelsCollisions(m_rcs, q, *m_grid, m_padding, dist);
+    // the robot tier runs first in every check; start a fresh contact record
+    m_last_voxels_contact.valid = false;
+
+    double d;
+    const CollisionSphereState* ls;
+    double ld;
+    if (!CheckVoxelsCollisions(m_rcs, q, *m_grid, m_padding, d, ls, ld)) {
+        recordVoxelsContact(ls, ld);
+        dist = d;
+        return false;
+    }
+
+    recordVoxelsContact(ls, ld);
+    dist = std::min(dist, d);
+    return true;
 }
 
 bool SelfCollisionModel::checkAttachedBodyVoxelsStateCollisions(
@@ -673,27 +776,104 @@ bool SelfCollisionModel::checkAttachedBodyVoxelsStateCollisions(
         q.push_back(s);
     }
 
-    return CheckVoxelsCollisions(m_abcs, q, *m_grid, m_padding, dist);
+    double d;
+    const CollisionSphereState* ls;
+    double ld;
+    if (!CheckVoxelsCollisions(m_abcs, q, *m_grid, m_padding, d, ls, ld)) {
+        recordVoxelsContact(ls, ld);
+        dist = d;
+        return false;
+    }
+
+    recordVoxelsContact(ls, ld);
+    dist = std::min(dist, d);
+    return true;
+}
+
+void SelfCollisionModel::recordVoxelsContact(
+    const CollisionSphereState* s,
+    double dist)
+{
+    if (!s) {
+        return;
+    }
+
+    const double radius = s->model->radius + m_padding;
+    if (m_last_voxels_contact.valid &&
+        m_last_voxels_contact.distance - m_last_voxels_contact.sphere_radius <=
+                dist - radius)
+    {
+        return;
+    }
+
+    m_last_voxels_contact.sphere_center = s->pos;
+    m_last_voxels_contact.sphere_radius = radius;
+    m_last_voxels_contact.distance = dist;
+    m_last_voxels_contact.valid = true;
+}
+
+// Record a collision between the k'th checked spheres state pair and restore
+// the descending-count ordering of the pair array by bubbling the pair past
+// its lower-count predecessors. Pairs that collide often migrate toward the
+// front of the array, so that checks against colliding states early-out after
+// testing as few pairs as possible. Counts are halved when any count
+// saturates, allowing the ordering to adapt when the set of colliding links
+// changes.
+static void RecordCheckedPairHit(
+    std::vector<std::pair<int, int>>& pairs,
+    std::vector<std::uint32_t>& hits,
+    size_t k)
+{
+    ++hits[k];
+
+    while (k > 0 && hits[k - 1] < hits[k]) {
+        std::swap(hits[k - 1], hits[k]);
+        std::swap(pairs[k - 1], pairs[k]);
+        --k;
+    }
+
+    if (hits[k] == (std::uint32_t(1) << 24)) {
+        for (auto& h : hits) {
+            h >>= 1;
+        }
+    }
 }
 
 bool SelfCollisionModel::checkRobotSpheresStateCollisions(double& dist)
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Check robot links vs robot links");
 
-    for (const auto& ss_pair : m_checked_spheres_states) {
+    double clearance = std::numeric_limits<double>::max();
+    for (size_t k = 0; k < m_checked_spheres_states.size(); ++k) {
+        const auto& ss_pair = m_checked_spheres_states[k];
         int ss1i = ss_pair.first;
         int ss2i = ss_pair.second;
         auto& ss1 = m_rcs.spheresState(ss1i);
         auto& ss2 = m_rcs.spheresState(ss2i);
 
+        double margin;
+        if (spheresStateRootsSeparated(
+                m_rcs, m_rcs, ss1i, ss2i, ss1, ss2, margin))
+        {
+            // broadphase: bounding spheres separated -> skip this link pair
+            clearance = std::min(clearance, margin);
+            continue;
+        }
+
+        // the narrowphase descent reports no clearance on success
+        clearance = 0.0;
+
         if (!checkSpheresStateCollision(
                 m_rcs, m_rcs, ss1i, ss2i, ss1, ss2, dist))
         {
+            RecordCheckedPairHit(
+                    m_checked_spheres_states, m_checked_spheres_hits, k);
             return false;
         }
     }
 
     ROS_DEBUG_NAMED(SCM_LOGGER, "No spheres collisions");
+    dist = std::min(dist, clearance);
     return true;
 }
 
@@ -703,6 +883,9 @@ bool SelfCollisionModel::checkRobotSpheresStateCollisions(
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Check robot links vs robot links");
 
+    updateAllowedCollisionsMasks(aci);
+
+    double clearance = std::numeric_limits<double>::max();
     const auto& group_link_indices = m_rcm->groupLinkIndices(m_gidx);
     for (int l1 = 0; l1 < group_link_indices.size(); ++l1) {
         const int lidx1 = group_link_indices[l1];
@@ -710,18 +893,13 @@ bool SelfCollisionModel::checkRobotSpheresStateCollisions(
             continue;
         }
 
-        auto& l1_name = m_rcm->linkName(lidx1);
         for (int l2 = l1 + 1; l2 < group_link_indices.size(); ++l2) {
             const int lidx2 = group_link_indices[l2];
             if (!m_rcm->hasSpheresModel(lidx2)) {
                 continue;
             }
-            auto& l2_name = m_rcm->linkName(lidx2);
 
-            AllowedCollision::Type type;
-            if (aci.getEntry(l2_name, l1_name, type) &&
-                type == AllowedCollision::Type::ALWAYS)
-            {
+            if (maskedCollisionAllowed(lidx1, lidx2)) {
                 // collisions allowed between this pair of links
                 continue;
             }
@@ -730,6 +908,17 @@ bool SelfCollisionModel::checkRobotSpheresStateCollisions(
             const int ss2i = m_rcs.linkSpheresStateIndex(lidx2);
             auto& ss1 = m_rcs.spheresState(ss1i);
             auto& ss2 = m_rcs.spheresState(ss2i);
+
+            double margin;
+            if (spheresStateRootsSeparated(
+                    m_rcs, m_rcs, ss1i, ss2i, ss1, ss2, margin))
+            {
+                clearance = std::min(clearance, margin);
+                continue;
+            }
+
+            clearance = 0.0;
+
             if (!checkSpheresStateCollision(
                     m_rcs, m_rcs, ss1i, ss2i, ss1, ss2, dist))
             {
@@ -739,6 +928,7 @@ bool SelfCollisionModel::checkRobotSpheresStateCollisions(
     }
 
     ROS_DEBUG_NAMED(SCM_LOGGER, "No spheres collisions");
+    dist = std::min(dist, clearance);
     return true;
 }
 
@@ -747,19 +937,37 @@ bool SelfCollisionModel::checkAttachedBodySpheresStateCollisions(
 {
     ROS_DEBUG(SCM_LOGGER, "Check attached bodies vs attached bodies");
 
-    for (const auto& ss_pair : m_checked_attached_body_spheres_states) {
+    double clearance = std::numeric_limits<double>::max();
+    for (size_t k = 0; k < m_checked_attached_body_spheres_states.size(); ++k) {
+        const auto& ss_pair = m_checked_attached_body_spheres_states[k];
         int ss1i = ss_pair.first;
         int ss2i = ss_pair.second;
         const CollisionSpheresState& ss1 = m_abcs.spheresState(ss1i);
         const CollisionSpheresState& ss2 = m_abcs.spheresState(ss2i);
 
+        double margin;
+        if (spheresStateRootsSeparated(
+                m_abcs, m_abcs, ss1i, ss2i, ss1, ss2, margin))
+        {
+            clearance = std::min(clearance, margin);
+            continue;
+        }
+
+        clearance = 0.0;
+
         if (!checkSpheresStateCollision(
                 m_abcs, m_abcs, ss1i, ss2i, ss1, ss2, dist))
         {
+            RecordCheckedPairHit(
+                    m_checked_attached_body_spheres_states,
+                    m_checked_attached_body_spheres_hits,
+                    k);
             return false;
         }
     }
 
+    dist = std::min(dist, clearance);
+
     if (!checkRobotAttachedBodySpheresStateCollisions(dist)) {
         return false;
     }
@@ -772,6 +980,10 @@ bool SelfCollisionModel::checkAttachedBodySpheresStateCollisions(
     double& dist)
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Check attached bodies vs attached bodies");
+
+    updateAllowedCollisionsMasks(aci);
+
+    double clearance = std::numeric_limits<double>::max();
     const auto& group_body_indices = m_abcm->groupLinkIndices(m_gidx);
     for (int b1 = 0; b1 < group_body_indices.size(); ++b1) {
         const int bidx1 = group_body_indices[b1];
@@ -779,18 +991,14 @@ bool SelfCollisionModel::checkAttachedBodySpheresStateCollisions(
             continue;
         }
 
-        const std::string& b1_name = m_abcm->attachedBodyName(bidx1);
         for (int b2 = b1 + 1; b2 < group_body_indices.size(); ++b2) {
             const int bidx2 = group_body_indices[b2];
             if (!m_abcm->hasSpheresModel(bidx2)) {
                 continue;
             }
 
-            const std::string& b2_name = m_abcm->attachedBodyName(bidx2);
-
-            AllowedCollision::Type type;
-            if (aci.getEntry(b1_name, b2_name, type) &&
-                type == AllowedCollision::Type::ALWAYS)
+            if (maskedCollisionAllowed(
+                    m_aci_body_entities[bidx1], m_aci_body_entities[bidx2]))
             {
                 // collisions between this pair of links
                 continue;
@@ -800,6 +1008,17 @@ bool SelfCollisionModel::checkAttachedBodySpheresStateCollisions(
             const int ss2i = m_abcs.attachedBodySpheresStateIndex(bidx2);
             const CollisionSpheresState& ss1 = m_abcs.spheresState(ss1i);
             const CollisionSpheresState& ss2 = m_abcs.spheresState(ss2i);
+
+            double margin;
+            if (spheresStateRootsSeparated(
+                    m_abcs, m_abcs, ss1i, ss2i, ss1, ss2, margin))
+            {
+                clearance = std::min(clearance, margin);
+                continue;
+            }
+
+            clearance = 0.0;
+
             if (!checkSpheresStateCollision(
                     m_abcs, m_abcs, ss1i, ss2i, ss1, ss2, dist))
             {
@@ -808,6 +1027,8 @@ bool SelfCollisionModel::checkAttachedBodySpheresStateCollisions(
         }
     }
 
+    dist = std::min(dist, clearance);
+
     if (!checkRobotAttachedBodySpheresStateCollisions(aci, dist)) {
         return false;
     }
@@ -820,19 +1041,38 @@ bool SelfCollisionModel::checkRobotAttachedBodySpheresStateCollisions(
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Check attached bodies vs robot links");
 
-    for (const auto& ss_pair : m_checked_attached_body_robot_spheres_states) {
+    double clearance = std::numeric_limits<double>::max();
+    for (size_t k = 0;
+        k < m_checked_attached_body_robot_spheres_states.size(); ++k)
+    {
+        const auto& ss_pair = m_checked_attached_body_robot_spheres_states[k];
         int ss1i = ss_pair.first;
         int ss2i = ss_pair.second;
         const CollisionSpheresState& ss1 = m_abcs.spheresState(ss1i);
         const CollisionSpheresState& ss2 = m_rcs.spheresState(ss2i);
 
+        double margin;
+        if (spheresStateRootsSeparated(
+                m_abcs, m_rcs, ss1i, ss2i, ss1, ss2, margin))
+        {
+            clearance = std::min(clearance, margin);
+            continue;
+        }
+
+        clearance = 0.0;
+
         if (!checkSpheresStateCollision(
                 m_abcs, m_rcs, ss1i, ss2i, ss1, ss2, dist))
         {
+            RecordCheckedPairHit(
+                    m_checked_attached_body_robot_spheres_states,
+                    m_checked_attached_body_robot_spheres_hits,
+                    k);
             return false;
         }
     }
 
+    dist = std::min(dist, clearance);
     return true;
 }
 
@@ -841,6 +1081,10 @@ bool SelfCollisionModel::checkRobotAttachedBodySpheresStateCollisions(
     double& dist)
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Check attached bodies vs robot links");
+
+    updateAllowedCollisionsMasks(aci);
+
+    double clearance = std::numeric_limits<double>::max();
     const auto& group_link_indices = m_rcm->groupLinkIndices(m_gidx);
     const auto& group_body_indices = m_abcm->groupLinkIndices(m_gidx);
     for (int b1 = 0; b1 < group_body_indices.size(); ++b1) {
@@ -849,19 +1093,13 @@ bool SelfCollisionModel::checkRobotAttachedBodySpheresStateCollisions(
             continue;
         }
 
-        const std::string& body_name = m_abcm->attachedBodyName(bidx);
         for (int l1 = 0; l1 < group_link_indices.size(); ++l1) {
             const int lidx = group_link_indices[l1];
             if (!m_rcm->hasSpheresModel(lidx)) {
                 continue;
             }
 
-            const std::string& link_name = m_rcm->linkName(lidx);
-
-            AllowedCollision::Type type;
-            if (aci.getEntry(body_name, link_name, type) &&
-                type == AllowedCollision::Type::ALWAYS)
-            {
+            if (maskedCollisionAllowed(m_aci_body_entities[bidx], lidx)) {
                 // collisions between this pair of links
                 continue;
             }
@@ -870,6 +1108,17 @@ bool SelfCollisionModel::checkRobotAttachedBodySpheresStateCollisions(
             const int ss2i = m_rcs.linkSpheresStateIndex(lidx);
             const CollisionSpheresState& ss1 = m_abcs.spheresState(ss1i);
             const CollisionSpheresState& ss2 = m_rcs.spheresState(ss2i);
+
+            double margin;
+            if (spheresStateRootsSeparated(
+                    m_abcs, m_rcs, ss1i, ss2i, ss1, ss2, margin))
+            {
+                clearance = std::min(clearance, margin);
+                continue;
+            }
+
+            clearance = 0.0;
+
             if (!checkSpheresStateCollision(
                     m_abcs, m_rcs, ss1i, ss2i, ss1, ss2, dist))
             {
@@ -878,6 +1127,7 @@ bool SelfCollisionModel::checkRobotAttachedBodySpheresStateCollisions(
         }
     }
 
+    dist = std::min(dist, clearance);
     return true;
 }
 
@@ -942,6 +1192,37 @@ bool CheckGeometryCollision(
     return true;
 }
 
+/// Broadphase culling test between two sphere tree hierarchies. Updates only
+/// the root bounding sphere of each hierarchy and reports whether the root
+/// spheres are separated. Separated roots imply that no pair of leaf spheres
+/// can overlap, and so the pairwise descent through both hierarchies may be
+/// skipped for this pair of links. When the roots are separated, \p dist is
+/// set to the separation margin between them, a lower bound on the distance
+/// between any pair of leaf spheres; it is unmodified otherwise.
+template <typename StateA, typename StateB>
+bool SelfCollisionModel::spheresStateRootsSeparated(
+    StateA& stateA,
+    StateB& stateB,
+    const int ss1i, const int ss2i,
+    const CollisionSpheresState& ss1,
+    const CollisionSpheresState& ss2,
+    double& dist)
+{
+    const CollisionSphereState* r1 = ss1.spheres.root();
+    const CollisionSphereState* r2 = ss2.spheres.root();
+
+    stateA.updateSphereState(SphereIndex(ss1i, r1->index()));
+    stateB.updateSphereState(SphereIndex(ss2i, r2->index()));
+
+    const double cr = r1->model->radius + r2->model->radius;
+    const double cd2 = (r2->pos - r1->pos).squaredNorm();
+    if (cd2 > cr * cr) {
+        dist = std::sqrt(cd2) - cr;
+        return true;
+    }
+    return false;
+}
+
 /// \tparam StateA RobotCollisionState or AttachedBodiesCollisionState
 /// \tparam StateB RobotCollisionState or AttachedBodiesCollisionState
 /// \param ss1i The index of the first spheres state
@@ -1227,6 +1508,223 @@ bool SelfCollisionModel::checkSpheresStateCollision(
     return true;
 }
 
+// Compile a caller-supplied allowed collisions interface into flat bitmask
+// rows over robot links and attached bodies so that the pair filter inside
+// the self collision loops is a single bit probe rather than a string-keyed
+// map lookup. The rows are recompiled only when a different interface
+// instance is supplied or the set of attached bodies has changed; the
+// interface is assumed not to mutate while it is reused across checks.
+void SelfCollisionModel::updateAllowedCollisionsMasks(
+    const AllowedCollisionsInterface& aci)
+{
+    if (m_aci == &aci && m_aci_abcm_version == m_abcm->version()) {
+        return;
+    }
+
+    ROS_DEBUG_NAMED(SCM_LOGGER, "Compile allowed collisions interface into bitmask rows");
+
+    m_aci = &aci;
+    m_aci_abcm_version = m_abcm->version();
+
+    const size_t link_count = m_rcm->linkCount();
+
+    // assign the entities following the robot links to the attached bodies
+    std::vector<int> body_indices;
+    m_abcm->attachedBodyIndices(body_indices);
+    m_aci_body_entities.clear();
+    size_t entity_count = link_count;
+    for (int bidx : body_indices) {
+        if (bidx >= (int)m_aci_body_entities.size()) {
+            m_aci_body_entities.resize(bidx + 1, -1);
+        }
+        m_aci_body_entities[bidx] = (int)entity_count++;
+    }
+
+    m_aci_mask_stride = (entity_count + 63) >> 6;
+    m_aci_mask_rows.assign(entity_count * m_aci_mask_stride, 0);
+
+    auto mark_allowed = [this](int e1, int e2) {
+        m_aci_mask_rows[(size_t)e1 * m_aci_mask_stride + (e2 >> 6)] |=
+                ((std::uint64_t)1 << (e2 & 0x3F));
+        m_aci_mask_rows[(size_t)e2 * m_aci_mask_stride + (e1 >> 6)] |=
+                ((std::uint64_t)1 << (e1 & 0x3F));
+    };
+
+    AllowedCollision::Type type;
+    for (size_t l1 = 0; l1 < link_count; ++l1) {
+        const std::string& l1_name = m_rcm->linkName(l1);
+        for (size_t l2 = l1 + 1; l2 < link_count; ++l2) {
+            const std::string& l2_name = m_rcm->linkName(l2);
+            if (aci.getEntry(l1_name, l2_name, type) &&
+                type == AllowedCollision::Type::ALWAYS)
+            {
+                mark_allowed((int)l1, (int)l2);
+            }
+        }
+    }
+
+    for (size_t b1 = 0; b1 < body_indices.size(); ++b1) {
+        const int bidx1 = body_indices[b1];
+        const std::string& b1_name = m_abcm->attachedBodyName(bidx1);
+        const int be1 = m_aci_body_entities[bidx1];
+        for (size_t l1 = 0; l1 < link_count; ++l1) {
+            const std::string& l1_name = m_rcm->linkName(l1);
+            if (aci.getEntry(b1_name, l1_name, type) &&
+                type == AllowedCollision::Type::ALWAYS)
+            {
+                mark_allowed(be1, (int)l1);
+            }
+        }
+        for (size_t b2 = b1 + 1; b2 < body_indices.size(); ++b2) {
+            const int bidx2 = body_indices[b2];
+            const std::string& b2_name = m_abcm->attachedBodyName(bidx2);
+            if (aci.getEntry(b1_name, b2_name, type) &&
+                type == AllowedCollision::Type::ALWAYS)
+            {
+                mark_allowed(be1, m_aci_body_entities[bidx2]);
+            }
+        }
+    }
+}
+
+// Test whether collisions are allowed between a pair of entities in the
+// compiled allowed collisions masks.
+bool SelfCollisionModel::maskedCollisionAllowed(int entity1, int entity2) const
+{
+    return (m_aci_mask_rows[(size_t)entity1 * m_aci_mask_stride + (entity2 >> 6)] &
+            ((std::uint64_t)1 << (entity2 & 0x3F))) != 0;
+}
+
+// Gather the pairs of entities whose allowed collision value differs between
+// the current matrix and an incoming replacement, considering entries present
+// in either matrix.
+void SelfCollisionModel::diffAllowedCollisionMatrix(
+    const AllowedCollisionMatrix& acm,
+    std::vector<std::pair<std::string, std::string>>& changed) const
+{
+    std::vector<std::string> entries;
+    m_acm.getAllEntryNames(entries);
+
+    std::vector<std::string> new_entries;
+    acm.getAllEntryNames(new_entries);
+    entries.insert(entries.end(), new_entries.begin(), new_entries.end());
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        for (size_t j = i + 1; j < entries.size(); ++j) {
+            if (CollisionAllowed(m_acm, entries[i], entries[j]) !=
+                CollisionAllowed(acm, entries[i], entries[j]))
+            {
+                changed.emplace_back(entries[i], entries[j]);
+            }
+        }
+    }
+}
+
+// Patch the checked sphere index lists for a set of entity pairs whose
+// allowed collision value changed in m_acm, adding or removing only the
+// affected pairs instead of rebuilding the full pair structure. Hit counters
+// of unaffected pairs are preserved.
+void SelfCollisionModel::patchCheckedSpheresIndices(
+    const std::vector<std::pair<std::string, std::string>>& changed)
+{
+    if (m_gidx == -1) {
+        return;
+    }
+
+    ROS_DEBUG_NAMED(SCM_LOGGER, "Patch checked sphere indices for %zu entry pairs", changed.size());
+
+    const auto& group_link_indices = m_rcm->groupLinkIndices(m_gidx);
+    const auto& group_body_indices = m_abcm->groupLinkIndices(m_gidx);
+
+    // the spheres state index of an entity name, if it names a robot link or
+    // attached body that is in the active group and has a spheres model;
+    // body = whether the name resolved to an attached body
+    auto resolve = [&](const std::string& name, int& ssidx, bool& body) {
+        if (m_rcm->hasLink(name)) {
+            const int lidx = m_rcm->linkIndex(name);
+            if (std::find(
+                    group_link_indices.begin(),
+                    group_link_indices.end(),
+                    lidx) == group_link_indices.end() ||
+                !m_rcm->hasSpheresModel(lidx))
+            {
+                return false;
+            }
+            ssidx = m_rcs.linkSpheresStateIndex(lidx);
+            body = false;
+            return true;
+        }
+        if (m_abcm->hasAttachedBody(name)) {
+            const int bidx = m_abcm->attachedBodyIndex(name);
+            if (std::find(
+                    group_body_indices.begin(),
+                    group_body_indices.end(),
+                    bidx) == group_body_indices.end() ||
+                !m_abcm->hasSpheresModel(bidx))
+            {
+                return false;
+            }
+            ssidx = m_abcs.attachedBodySpheresStateIndex(bidx);
+            body = true;
+            return true;
+        }
+        return false;
+    };
+
+    auto patch = [](
+        std::vector<std::pair<int, int>>& pairs,
+        std::vector<std::uint32_t>& hits,
+        int ssidx1, int ssidx2,
+        bool allowed)
+    {
+        auto it = std::find(
+                pairs.begin(), pairs.end(), std::make_pair(ssidx1, ssidx2));
+        if (it == pairs.end()) {
+            it = std::find(
+                    pairs.begin(), pairs.end(), std::make_pair(ssidx2, ssidx1));
+        }
+        if (allowed) {
+            if (it != pairs.end()) {
+                hits.erase(hits.begin() + std::distance(pairs.begin(), it));
+                pairs.erase(it);
+            }
+        } else if (it == pairs.end()) {
+            pairs.emplace_back(ssidx1, ssidx2);
+            hits.push_back(0);
+        }
+    };
+
+    for (const auto& entry : changed) {
+        int ssidx1, ssidx2;
+        bool body1, body2;
+        if (!resolve(entry.first, ssidx1, body1) ||
+            !resolve(entry.second, ssidx2, body2))
+        {
+            continue;
+        }
+
+        const bool allowed =
+                CollisionAllowed(m_acm, entry.first, entry.second);
+        if (body1 && body2) {
+            patch(m_checked_attached_body_spheres_states,
+                    m_checked_attached_body_spheres_hits,
+                    ssidx1, ssidx2, allowed);
+        } else if (body1 || body2) {
+            // the body's spheres state index leads in this list
+            patch(m_checked_attached_body_robot_spheres_states,
+                    m_checked_attached_body_robot_spheres_hits,
+                    body1 ? ssidx1 : ssidx2,
+                    body1 ? ssidx2 : ssidx1,
+                    allowed);
+        } else {
+            patch(m_checked_spheres_states, m_checked_spheres_hits,
+                    ssidx1, ssidx2, allowed);
+        }
+    }
+}
+
 void SelfCollisionModel::updateCheckedSpheresIndices()
 {
     ROS_DEBUG_NAMED(SCM_LOGGER, "Update checked sphere indices");
@@ -1275,6 +1773,8 @@ void SelfCollisionModel::updateRobotCheckedSphereIndices()
             }
         }
     }
+
+    m_checked_spheres_hits.assign(m_checked_spheres_states.size(), 0);
 }
 
 void SelfCollisionModel::updateRobotAttachedBodyCheckedSphereIndices()
@@ -1314,6 +1814,9 @@ void SelfCollisionModel::updateRobotAttachedBodyCheckedSphereIndices()
             }
         }
     }
+
+    m_checked_attached_body_robot_spheres_hits.assign(
+            m_checked_attached_body_robot_spheres_states.size(), 0);
 }
 
 void SelfCollisionModel::updateAttachedBodyCheckedSphereIndices()
@@ -1352,6 +1855,9 @@ void SelfCollisionModel::updateAttachedBodyCheckedSphereIndices()
             }
         }
     }
+
+    m_checked_attached_body_spheres_hits.assign(
+            m_checked_attached_body_spheres_states.size(), 0);
 }
 
 void SelfCollisionModel::updateMetaSphereTrees()
@@ -555,6 +555,31 @@ bool VoxelizeOcTree(
     return VoxelizeOcTree(*tree, pose, res, go, voxels);
 }
 
+/// Translate a set of voxel centers by a fixed offset, dropping any voxels
+/// that leave the bounding volume [gmin, gmax]. Allows the voxelization of a
+/// rigidly translated shape to be reused rather than recomputed; note that
+/// the shifted centers generally fall off the voxel lattice and incur up to
+/// half a cell of rounding when re-discretized.
+void TranslateVoxels(
+    const Eigen::Vector3d& shift,
+    const Eigen::Vector3d& gmin,
+    const Eigen::Vector3d& gmax,
+    std::vector<Eigen::Vector3d>& voxels)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < voxels.size(); ++i) {
+        const Eigen::Vector3d v = voxels[i] + shift;
+        if (v.x() < gmin.x() || v.x() > gmax.x() ||
+            v.y() < gmin.y() || v.y() > gmax.y() ||
+            v.z() < gmin.z() || v.z() > gmax.z())
+        {
+            continue;
+        }
+        voxels[count++] = v;
+    }
+    voxels.resize(count);
+}
+
 bool VoxelizeShape(
     const shapes::Shape& shape,
     const Eigen::Affine3d& pose,
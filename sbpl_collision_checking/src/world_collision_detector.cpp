@@ -31,6 +31,11 @@
 
 #include <sbpl_collision_checking/world_collision_detector.h>
 
+// standard includes
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
 // system includes
 #include <ros/console.h>
 
@@ -47,7 +52,10 @@ WorldCollisionDetector::WorldCollisionDetector(
 :
     m_rcm(rcm),
     m_wcm(wcm),
-    m_vq()
+    m_vq(),
+    m_robot_hits(),
+    m_ab_hits(),
+    m_check_order()
 {
 }
 
@@ -77,8 +85,19 @@ bool WorldCollisionDetector::checkCollision(
         return false;
     }
 
-    return checkRobotSpheresStateCollisions(state, gidx, dist) &&
-            checkAttachedBodySpheresStateCollisions(ab_state, gidx, dist);
+    if (!checkRobotSpheresStateCollisions(state, gidx, dist)) {
+        return false;
+    }
+
+    double ab_dist;
+    if (!checkAttachedBodySpheresStateCollisions(ab_state, gidx, ab_dist)) {
+        dist = ab_dist;
+        return false;
+    }
+
+    // report the minimum clearance found over both checks
+    dist = std::min(dist, ab_dist);
+    return true;
 }
 
 bool WorldCollisionDetector::checkMotionCollision(
@@ -93,13 +112,24 @@ bool WorldCollisionDetector::checkMotionCollision(
     MotionInterpolation interp(m_rcm);
     rmcm.fillMotionInterpolation(start, finish, res, interp);
 
+    // conservative advancement: adjacent waypoints are spaced so that no
+    // sphere moves by more than res between them, and successful checks
+    // report a conservative clearance, so any waypoint within the clearance
+    // of the last checked waypoint is also collision free and may be skipped
     RobotState interm;
-    for (int i = 0; i < interp.waypointCount(); ++i) {
+    int i = 0;
+    while (i < interp.waypointCount()) {
         interp.interpolate(i, interm);
         state.setJointVarPositions(interm.data());
         if (!checkCollision(state, gidx, dist)) {
             return false;
         }
+
+        const double skip = dist / res;
+        if (skip >= (double)(interp.waypointCount() - i)) {
+            break; // the remaining waypoints lie within the clearance
+        }
+        i += std::max(1, (int)skip);
     }
     return true;
 }
@@ -117,14 +147,73 @@ bool WorldCollisionDetector::checkMotionCollision(
     MotionInterpolation interp(m_rcm);
     rmcm.fillMotionInterpolation(start, finish, res, interp);
 
+    // see notes on conservative advancement above
     RobotState interm;
-    for (int i = 0; i < interp.waypointCount(); ++i) {
+    int i = 0;
+    while (i < interp.waypointCount()) {
         interp.interpolate(i, interm);
         state.setJointVarPositions(interm.data());
         if (!checkCollision(state, ab_state, gidx, dist)) {
             return false;
         }
+
+        const double skip = dist / res;
+        if (skip >= (double)(interp.waypointCount() - i)) {
+            break; // the remaining waypoints lie within the clearance
+        }
+        i += std::max(1, (int)skip);
+    }
+    return true;
+}
+
+// Check each spheres state in a group against the occupancy grid, one sphere
+// tree at a time, in descending order of historical collision counts, so that
+// historically-colliding links are tested first and colliding states are
+// rejected after descending as few sphere trees as possible. Counts are
+// halved when any count saturates, allowing the ordering to adapt as the
+// scene changes.
+template <typename StateType>
+static bool CheckOrderedVoxelsCollisions(
+    StateType& state,
+    int gidx,
+    const OccupancyGrid& grid,
+    double padding,
+    std::vector<const CollisionSphereState*>& q,
+    std::vector<int>& order,
+    std::vector<std::uint32_t>& hits,
+    double& dist)
+{
+    const auto& ss_indices = state.groupSpheresStateIndices(gidx);
+
+    order.assign(ss_indices.begin(), ss_indices.end());
+    for (const int ssidx : order) {
+        if (ssidx >= (int)hits.size()) {
+            hits.resize(ssidx + 1, 0);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+            [&](int i, int j) { return hits[i] > hits[j]; });
+
+    double clearance = std::numeric_limits<double>::max();
+    for (const int ssidx : order) {
+        const auto& ss = state.spheresState(ssidx);
+        q.clear();
+        q.push_back(ss.spheres.root());
+
+        double d;
+        if (!CheckVoxelsCollisions(state, q, grid, padding, d)) {
+            dist = d;
+            if (++hits[ssidx] == (std::uint32_t(1) << 24)) {
+                for (auto& h : hits) {
+                    h >>= 1;
+                }
+            }
+            return false;
+        }
+        clearance = std::min(clearance, d);
     }
+
+    dist = clearance;
     return true;
 }
 
@@ -136,16 +225,9 @@ bool WorldCollisionDetector::checkRobotSpheresStateCollisions(
     double& dist) const
 {
     // TODO: refactor commonality with self collision model here
-    auto& q = m_vq;
-    q.clear();
-
-    for (const int ssidx : state.groupSpheresStateIndices(gidx)) {
-        const auto& ss = state.spheresState(ssidx);
-        const CollisionSphereState* s = ss.spheres.root();
-        q.push_back(s);
-    }
-
-    return CheckVoxelsCollisions(state, q, *m_wcm->grid(), m_wcm->padding(), dist);
+    return CheckOrderedVoxelsCollisions(
+            state, gidx, *m_wcm->grid(), m_wcm->padding(),
+            m_vq, m_check_order, m_robot_hits, dist);
 }
 
 bool WorldCollisionDetector::checkAttachedBodySpheresStateCollisions(
@@ -154,16 +236,9 @@ bool WorldCollisionDetector::checkAttachedBodySpheresStateCollisions(
     double& dist) const
 {
     // TODO: see note in checkRobotSpheresStateCollisions()
-    auto& q = m_vq;
-    q.clear();
-
-    for (const int ssidx : state.groupSpheresStateIndices(gidx)) {
-        const auto& ss = state.spheresState(ssidx);
-        const CollisionSphereState* s = ss.spheres.root();
-        q.push_back(s);
-    }
-
-    return CheckVoxelsCollisions(state, q, *m_wcm->grid(), m_wcm->padding(), dist);
+    return CheckOrderedVoxelsCollisions(
+            state, gidx, *m_wcm->grid(), m_wcm->padding(),
+            m_vq, m_check_order, m_ab_hits, dist);
 }
 
 } // namespace collision
@@ -33,6 +33,9 @@
 
 // standard includes
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <utility>
 
 // system includes
@@ -49,6 +52,118 @@ namespace collision {
 
 static const char* LOG = "world";
 
+// edge length of a broadphase cell, coarse relative to the occupancy grid so
+// small objects hash into few cells while queries still discriminate between
+// objects on opposite sides of the workspace
+static const double BroadphaseCellRes = 0.25;
+
+// Pack signed broadphase cell coordinates into a hashable key.
+static std::uint64_t MakeBroadphaseCellKey(int x, int y, int z)
+{
+    return ((std::uint64_t)((std::uint32_t)x & 0x1FFFFF) << 42) |
+            ((std::uint64_t)((std::uint32_t)y & 0x1FFFFF) << 21) |
+            ((std::uint64_t)((std::uint32_t)z & 0x1FFFFF));
+}
+
+// tolerance for comparing shape poses when diffing object states
+static const double PoseEps = 1.0e-6;
+
+// Return true if two shapes describe identical geometry. Mesh and octree
+// shapes are compared by the identity of their referenced data, which is
+// shared between copies of the same scene rather than duplicated.
+static bool SameShapeGeometry(
+    const CollisionShape* a,
+    const CollisionShape* b)
+{
+    if (a == b) {
+        return true;
+    }
+    if (a->type != b->type) {
+        return false;
+    }
+    switch (a->type) {
+    case ShapeType::Sphere:
+        return static_cast<const SphereShape*>(a)->radius ==
+                static_cast<const SphereShape*>(b)->radius;
+    case ShapeType::Cylinder:
+        return static_cast<const CylinderShape*>(a)->radius ==
+                static_cast<const CylinderShape*>(b)->radius &&
+                static_cast<const CylinderShape*>(a)->height ==
+                static_cast<const CylinderShape*>(b)->height;
+    case ShapeType::Cone:
+        return static_cast<const ConeShape*>(a)->radius ==
+                static_cast<const ConeShape*>(b)->radius &&
+                static_cast<const ConeShape*>(a)->height ==
+                static_cast<const ConeShape*>(b)->height;
+    case ShapeType::Box:
+        return std::equal(
+                static_cast<const BoxShape*>(a)->size,
+                static_cast<const BoxShape*>(a)->size + 3,
+                static_cast<const BoxShape*>(b)->size);
+    case ShapeType::Plane:
+        return static_cast<const PlaneShape*>(a)->a == static_cast<const PlaneShape*>(b)->a &&
+                static_cast<const PlaneShape*>(a)->b == static_cast<const PlaneShape*>(b)->b &&
+                static_cast<const PlaneShape*>(a)->c == static_cast<const PlaneShape*>(b)->c &&
+                static_cast<const PlaneShape*>(a)->d == static_cast<const PlaneShape*>(b)->d;
+    case ShapeType::Mesh:
+        return static_cast<const MeshShape*>(a)->vertices ==
+                static_cast<const MeshShape*>(b)->vertices &&
+                static_cast<const MeshShape*>(a)->triangles ==
+                static_cast<const MeshShape*>(b)->triangles &&
+                static_cast<const MeshShape*>(a)->vertex_count ==
+                static_cast<const MeshShape*>(b)->vertex_count &&
+                static_cast<const MeshShape*>(a)->triangle_count ==
+                static_cast<const MeshShape*>(b)->triangle_count;
+    case ShapeType::OcTree:
+        return static_cast<const OcTreeShape*>(a)->octree ==
+                static_cast<const OcTreeShape*>(b)->octree;
+    }
+    return false;
+}
+
+// Return true if two objects reference identical shape geometry, shape for
+// shape, regardless of their poses.
+static bool SameObjectGeometry(
+    const CollisionObject* a,
+    const CollisionObject* b)
+{
+    if (a->shapes.size() != b->shapes.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a->shapes.size(); ++i) {
+        if (!SameShapeGeometry(a->shapes[i], b->shapes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return true if every pose in $to differs from its counterpart in $from by
+// the same pure translation, stored in $shift; rotations must be unchanged.
+static bool GetCommonTranslation(
+    const Affine3dVector& from,
+    const Affine3dVector& to,
+    Eigen::Vector3d* shift)
+{
+    if (from.size() != to.size() || from.empty()) {
+        return false;
+    }
+
+    const Eigen::Vector3d t = to[0].translation() - from[0].translation();
+    for (size_t i = 0; i < from.size(); ++i) {
+        if (!from[i].linear().isApprox(to[i].linear(), PoseEps)) {
+            return false;
+        }
+        const Eigen::Vector3d ti = to[i].translation() - from[i].translation();
+        if ((ti - t).squaredNorm() > PoseEps * PoseEps) {
+            return false;
+        }
+    }
+
+    *shift = t;
+    return true;
+}
+
 /// \class WorldCollisionModel
 ///
 /// This class manages the collision representations for a set of objects in a
@@ -66,7 +181,8 @@ static const char* LOG = "world";
 
 WorldCollisionModel::WorldCollisionModel(OccupancyGrid* grid) :
     m_grid(grid),
-    m_padding(0.0)
+    m_padding(0.0),
+    m_bp_cell_res(BroadphaseCellRes)
 {
 }
 
@@ -76,7 +192,12 @@ WorldCollisionModel::WorldCollisionModel(
 :
     m_grid(grid),
     m_object_models(o.m_object_models),
-    m_padding(o.m_padding)
+    m_detached_models(o.m_detached_models),
+    m_local_voxels(o.m_local_voxels),
+    m_padding(o.m_padding),
+    m_bp_cell_res(o.m_bp_cell_res),
+    m_object_bounds(o.m_object_bounds),
+    m_broadphase(o.m_broadphase)
 {
     // TODO: check for different voxel origin/resolution/etc here...if they
     // differ, need to do a deep copy + revoxelization of the objects over just
@@ -115,6 +236,7 @@ bool WorldCollisionModel::insertObject(const CollisionObject* object)
         ObjectCollisionModel model;
         model.object = object;
         model.cached_voxels = std::move(all_voxels);
+        model.cached_shape_poses = object->shape_poses;
         m_object_models.push_back(std::move(model));
     }
 
@@ -123,6 +245,8 @@ bool WorldCollisionModel::insertObject(const CollisionObject* object)
         m_grid->addPointsToField(voxel_list);
     }
 
+    insertObjectBounds(object, m_object_models.back().cached_voxels);
+
     return true;
 }
 
@@ -148,14 +272,189 @@ bool WorldCollisionModel::removeObject(const CollisionObject* object)
                 return model.object == object;
             });
     m_object_models.erase(rit, end(m_object_models));
+
+    removeObjectBounds(object);
+    evictLocalShapeVoxels(object);
+
+    return true;
+}
+
+/// Remove an object from the collision model while retaining its collision
+/// model for a later restoreObject(). The voxels occupied by the object are
+/// cleared from the distance map using the stored lists, and the stored lists
+/// and cached local shape voxelizations are kept so that restoring the object
+/// costs at most a rigid transform of stored samples instead of a run of the
+/// voxelization pipeline. Intended for objects temporarily leaving the world,
+/// e.g. while attached to the robot.
+bool WorldCollisionModel::extractObject(const CollisionObject* object)
+{
+    if (!checkObjectRemove(object)) {
+        ROS_ERROR_NAMED(LOG, "Rejecting extraction of collision object '%s'", object->id.c_str());
+        return false;
+    }
+
+    auto it = std::find_if(begin(m_object_models), end(m_object_models),
+            [object](const ObjectCollisionModel& model) {
+                return model.object == object;
+            });
+    assert(it != end(m_object_models));
+
+    for (auto& voxel_list : it->cached_voxels) {
+        ROS_DEBUG_NAMED(LOG, "Removing %zu grid cells from the distance transform", voxel_list.size());
+        m_grid->removePointsFromField(voxel_list);
+    }
+
+    // ids are unique among world objects; drop any stale stash with this id
+    // so it cannot shadow this one on restore
+    auto sit = std::remove_if(begin(m_detached_models), end(m_detached_models),
+            [&](const ObjectCollisionModel& model) {
+                return model.object->id == object->id;
+            });
+    m_detached_models.erase(sit, end(m_detached_models));
+
+    m_detached_models.push_back(std::move(*it));
+    m_object_models.erase(it);
+
+    removeObjectBounds(object);
+    // NOTE: local shape voxelizations are deliberately retained; the object
+    // and its shape storage live on outside the world model
+
+    return true;
+}
+
+/// Return an object previously removed with extractObject() to the collision
+/// model. When the object's geometry is unchanged, the stored voxel lists are
+/// reused: directly when the object has not moved, or regenerated from the
+/// cached local-frame shape voxelizations when it was set down at a new pose.
+/// Falls back to a full insertObject() when no usable model was retained.
+bool WorldCollisionModel::restoreObject(const CollisionObject* object)
+{
+    if (!checkObjectInsert(object)) {
+        ROS_ERROR_NAMED(LOG, "Rejecting restoration of collision object '%s'", object->id.c_str());
+        return false;
+    }
+
+    auto it = std::find_if(begin(m_detached_models), end(m_detached_models),
+            [&](const ObjectCollisionModel& model) {
+                return model.object->id == object->id;
+            });
+    if (it == end(m_detached_models)) {
+        return insertObject(object);
+    }
+
+    if (!SameObjectGeometry(it->object, object)) {
+        m_detached_models.erase(it);
+        return insertObject(object);
+    }
+
+    ObjectCollisionModel model = std::move(*it);
+    m_detached_models.erase(it);
+    model.object = object;
+
+    Eigen::Vector3d shift;
+    if (GetCommonTranslation(
+            model.cached_shape_poses, object->shape_poses, &shift) &&
+        shift.squaredNorm() <= PoseEps * PoseEps)
+    {
+        // unmoved: the stored world-frame voxels are still valid
+        ROS_DEBUG_NAMED(LOG, "Object '%s' restored in place, reuse stored voxels", object->id.c_str());
+        model.cached_shape_poses = object->shape_poses;
+        m_object_models.push_back(std::move(model));
+        for (auto& voxel_list : m_object_models.back().cached_voxels) {
+            m_grid->addPointsToField(voxel_list);
+        }
+        insertObjectBounds(object, m_object_models.back().cached_voxels);
+        return true;
+    }
+
+    // moved: regenerate the voxel lists by rigidly transforming the cached
+    // local-frame voxelizations; nothing needs removing from the grid
+    for (auto* shape : object->shapes) {
+        if (getLocalShapeVoxels(shape) == NULL) {
+            return insertObject(object);
+        }
+    }
+
+    ROS_DEBUG_NAMED(LOG, "Object '%s' restored at a new pose, transform cached local voxels", object->id.c_str());
+    model.cached_shape_poses = object->shape_poses;
+    m_object_models.push_back(std::move(model));
+    rasterizeFromLocalVoxels(&m_object_models.back(), object->shape_poses);
+    insertObjectBounds(object, m_object_models.back().cached_voxels);
     return true;
 }
 
+/// Synchronize the collision model with the current state of an object,
+/// diffing against a previously inserted object with the same id. Objects
+/// whose geometry and poses are unchanged are rebound to the new instance
+/// without touching the grid, objects moved by a pure translation have their
+/// voxel sets translated in place, and anything else is removed and
+/// re-voxelized. Inserts the object outright when no object with its id is
+/// present.
+bool WorldCollisionModel::syncObject(const CollisionObject* object)
+{
+    auto* model = findModelWithName(object->id);
+    if (model == NULL) {
+        return insertObject(object);
+    }
+
+    if (SameObjectGeometry(model->object, object)) {
+        Eigen::Vector3d shift;
+        if (GetCommonTranslation(
+                model->cached_shape_poses, object->shape_poses, &shift))
+        {
+            if (shift.squaredNorm() <= PoseEps * PoseEps) {
+                ROS_DEBUG_NAMED(LOG, "Object '%s' unchanged, keep cached voxels", object->id.c_str());
+                rebindObject(model, object);
+                return true;
+            }
+
+            if (translateObject(model, shift)) {
+                ROS_DEBUG_NAMED(LOG, "Object '%s' translated, shift cached voxels", object->id.c_str());
+                rebindObject(model, object);
+                return true;
+            }
+        }
+
+        if (transformObject(model, object->shape_poses)) {
+            ROS_DEBUG_NAMED(LOG, "Object '%s' moved, transform cached local voxels", object->id.c_str());
+            rebindObject(model, object);
+            return true;
+        }
+    }
+
+    auto* old_object = model->object;
+    return removeObject(old_object) && insertObject(object);
+}
+
 /// Update the collision model in response to a collision object moving or
-/// shapes moving with a collision object.
+/// shapes moving with a collision object. Objects moved by a pure translation
+/// have their cached voxel sets translated rather than re-voxelized.
 bool WorldCollisionModel::moveShapes(const CollisionObject* object)
 {
-    // TODO: optimized version
+    if (!checkObjectMoveShape(object)) {
+        ROS_ERROR_NAMED(LOG, "Rejecting move of collision object '%s'", object->id.c_str());
+        return false;
+    }
+
+    auto* model = const_cast<ObjectCollisionModel*>(
+            getObjectCollisionModel(object));
+    assert(model != NULL);
+
+    Eigen::Vector3d shift;
+    if (GetCommonTranslation(
+            model->cached_shape_poses, object->shape_poses, &shift) &&
+        translateObject(model, shift))
+    {
+        model->cached_shape_poses = object->shape_poses;
+        return true;
+    }
+
+    if (transformObject(model, object->shape_poses)) {
+        ROS_DEBUG_NAMED(LOG, "Object '%s' moved, transform cached local voxels", object->id.c_str());
+        model->cached_shape_poses = object->shape_poses;
+        return true;
+    }
+
     return removeObject(object) && insertObject(object);
 }
 
@@ -192,6 +491,54 @@ bool WorldCollisionModel::hasObjectWithName(const std::string& id) const
     return false;
 }
 
+/// Gather the objects whose bounding boxes intersect the bounding sphere at
+/// \p center with radius \p radius. Appends to \p objects without clearing it.
+void WorldCollisionModel::gatherCandidateObjects(
+    const Eigen::Vector3d& center,
+    double radius,
+    std::vector<const CollisionObject*>& objects) const
+{
+    const double cell_res_inv = 1.0 / m_bp_cell_res;
+    const int cminx = (int)std::floor((center.x() - radius) * cell_res_inv);
+    const int cminy = (int)std::floor((center.y() - radius) * cell_res_inv);
+    const int cminz = (int)std::floor((center.z() - radius) * cell_res_inv);
+    const int cmaxx = (int)std::floor((center.x() + radius) * cell_res_inv);
+    const int cmaxy = (int)std::floor((center.y() + radius) * cell_res_inv);
+    const int cmaxz = (int)std::floor((center.z() + radius) * cell_res_inv);
+
+    const double radius_sqrd = radius * radius;
+    const size_t first = objects.size();
+    for (int x = cminx; x <= cmaxx; ++x) {
+    for (int y = cminy; y <= cmaxy; ++y) {
+    for (int z = cminz; z <= cmaxz; ++z) {
+        auto bit = m_broadphase.find(MakeBroadphaseCellKey(x, y, z));
+        if (bit == end(m_broadphase)) {
+            continue;
+        }
+
+        for (const CollisionObject* object : bit->second) {
+            // skip objects gathered from a previously visited cell
+            if (std::find(begin(objects) + first, end(objects), object) !=
+                    end(objects))
+            {
+                continue;
+            }
+
+            // test the sphere against the object bounding box
+            auto& bounds = m_object_bounds.at(object);
+            const Eigen::Vector3d closest(
+                    std::max(bounds.min.x(), std::min(center.x(), bounds.max.x())),
+                    std::max(bounds.min.y(), std::min(center.y(), bounds.max.y())),
+                    std::max(bounds.min.z(), std::min(center.z(), bounds.max.z())));
+            if ((closest - center).squaredNorm() <= radius_sqrd) {
+                objects.push_back(object);
+            }
+        }
+    }
+    }
+    }
+}
+
 /// Reset the occupancy grid and distance map by removing all occupied voxels,
 /// reinserting all object occupied voxels, and updating the distance map
 void WorldCollisionModel::reset()
@@ -306,6 +653,83 @@ bool WorldCollisionModel::haveObject(const CollisionObject* object) const
     return it != end(m_object_models);
 }
 
+// Compute the bounding box of an object from its cached voxels and enter the
+// object into every broadphase cell the box overlaps.
+void WorldCollisionModel::insertObjectBounds(
+    const CollisionObject* object,
+    const std::vector<VoxelList>& all_voxels)
+{
+    ObjectBounds bounds;
+    bounds.min = Eigen::Vector3d::Constant(std::numeric_limits<double>::max());
+    bounds.max = Eigen::Vector3d::Constant(std::numeric_limits<double>::lowest());
+    bool empty = true;
+    for (auto& voxel_list : all_voxels) {
+        for (auto& voxel : voxel_list) {
+            bounds.min = bounds.min.cwiseMin(voxel);
+            bounds.max = bounds.max.cwiseMax(voxel);
+            empty = false;
+        }
+    }
+
+    if (empty) {
+        // store an empty cell range so removal is well-defined
+        bounds.cmin = Eigen::Vector3i::Ones();
+        bounds.cmax = -Eigen::Vector3i::Ones();
+        m_object_bounds[object] = bounds;
+        return;
+    }
+
+    // expand voxel centers to cover their extents
+    const double half_res = 0.5 * m_grid->resolution();
+    bounds.min -= Eigen::Vector3d::Constant(half_res);
+    bounds.max += Eigen::Vector3d::Constant(half_res);
+
+    const double cell_res_inv = 1.0 / m_bp_cell_res;
+    for (int i = 0; i < 3; ++i) {
+        bounds.cmin[i] = (int)std::floor(bounds.min[i] * cell_res_inv);
+        bounds.cmax[i] = (int)std::floor(bounds.max[i] * cell_res_inv);
+    }
+
+    for (int x = bounds.cmin.x(); x <= bounds.cmax.x(); ++x) {
+    for (int y = bounds.cmin.y(); y <= bounds.cmax.y(); ++y) {
+    for (int z = bounds.cmin.z(); z <= bounds.cmax.z(); ++z) {
+        m_broadphase[MakeBroadphaseCellKey(x, y, z)].push_back(object);
+    }
+    }
+    }
+
+    m_object_bounds[object] = bounds;
+}
+
+// Remove the object from every broadphase cell recorded when it was inserted.
+void WorldCollisionModel::removeObjectBounds(const CollisionObject* object)
+{
+    auto it = m_object_bounds.find(object);
+    if (it == end(m_object_bounds)) {
+        return;
+    }
+
+    const ObjectBounds& bounds = it->second;
+    for (int x = bounds.cmin.x(); x <= bounds.cmax.x(); ++x) {
+    for (int y = bounds.cmin.y(); y <= bounds.cmax.y(); ++y) {
+    for (int z = bounds.cmin.z(); z <= bounds.cmax.z(); ++z) {
+        auto bit = m_broadphase.find(MakeBroadphaseCellKey(x, y, z));
+        if (bit == end(m_broadphase)) {
+            continue;
+        }
+
+        auto rit = std::remove(begin(bit->second), end(bit->second), object);
+        bit->second.erase(rit, end(bit->second));
+        if (bit->second.empty()) {
+            m_broadphase.erase(bit);
+        }
+    }
+    }
+    }
+
+    m_object_bounds.erase(it);
+}
+
 auto WorldCollisionModel::getObjectCollisionModel(
     const CollisionObject* object) const
     -> const ObjectCollisionModel*
@@ -318,6 +742,215 @@ auto WorldCollisionModel::getObjectCollisionModel(
     return NULL;
 }
 
+auto WorldCollisionModel::findModelWithName(const std::string& id)
+    -> ObjectCollisionModel*
+{
+    for (auto& model : m_object_models) {
+        if (model.object->id == id) {
+            return &model;
+        }
+    }
+    return NULL;
+}
+
+// Translate an object's cached voxels by a rigid shift, updating the distance
+// map and broadphase, without re-voxelizing its shapes. Returns false,
+// leaving the model untouched, when the voxelization may have been clipped
+// at the grid boundary before or after the shift, in which case the caller
+// must re-voxelize.
+bool WorldCollisionModel::translateObject(
+    ObjectCollisionModel* model,
+    const Eigen::Vector3d& shift)
+{
+    auto bit = m_object_bounds.find(model->object);
+    if (bit == end(m_object_bounds)) {
+        return false;
+    }
+
+    const Eigen::Vector3d gmin(
+            m_grid->originX(), m_grid->originY(), m_grid->originZ());
+    const Eigen::Vector3d gmax(
+            m_grid->originX() + m_grid->sizeX(),
+            m_grid->originY() + m_grid->sizeY(),
+            m_grid->originZ() + m_grid->sizeZ());
+
+    // require a full cell of clearance from the grid boundary at both the old
+    // and the new position; a voxelization flush against the boundary may
+    // have been clipped and must be recomputed rather than shifted
+    const double res = m_grid->resolution();
+    auto inside = [&](const Eigen::Vector3d& lo, const Eigen::Vector3d& hi) {
+        return (lo - gmin).minCoeff() >= res && (gmax - hi).minCoeff() >= res;
+    };
+
+    auto& bounds = bit->second;
+    if (!inside(bounds.min, bounds.max) ||
+        !inside(bounds.min + shift, bounds.max + shift))
+    {
+        return false;
+    }
+
+    for (auto& voxel_list : model->cached_voxels) {
+        ROS_DEBUG_NAMED(LOG, "Shifting %zu voxels from collision object '%s' in the distance transform", voxel_list.size(), model->object->id.c_str());
+        m_grid->removePointsFromField(voxel_list);
+        TranslateVoxels(shift, gmin, gmax, voxel_list);
+        m_grid->addPointsToField(voxel_list);
+    }
+
+    removeObjectBounds(model->object);
+    insertObjectBounds(model->object, model->cached_voxels);
+
+    return true;
+}
+
+// Return the local-frame voxelization of a shape, computing and caching it on
+// the first reference. Entries are matched by geometry, so repeated instances
+// of the same shape resolve to one voxelization. Samples are taken at half
+// the grid resolution; after an arbitrary rigid transform the sample lattice
+// is then still dense enough to land in every grid cell the shape overlaps
+// beyond the half-cell rounding already accepted when translating voxel sets.
+// Planes are not cached since their voxelization is clipped against the grid
+// bounds at a specific pose.
+auto WorldCollisionModel::getLocalShapeVoxels(const CollisionShape* shape)
+    -> const LocalShapeVoxels*
+{
+    if (shape->type == ShapeType::Plane) {
+        return NULL;
+    }
+
+    for (auto& entry : m_local_voxels) {
+        if (SameShapeGeometry(entry.shape, shape)) {
+            return &entry;
+        }
+    }
+
+    LocalShapeVoxels entry;
+    entry.shape = shape;
+    if (!VoxelizeShape(
+            *shape,
+            Eigen::Affine3d::Identity(),
+            0.5 * m_grid->resolution(),
+            Eigen::Vector3d::Zero(),
+            entry.voxels))
+    {
+        return NULL;
+    }
+
+    ROS_DEBUG_NAMED(LOG, "Cached %zu local-frame voxels for a shape", entry.voxels.size());
+    m_local_voxels.push_back(std::move(entry));
+    return &m_local_voxels.back();
+}
+
+// Drop cached local voxelizations represented by one of this object's shapes;
+// shape storage is managed externally and may go away with the object.
+void WorldCollisionModel::evictLocalShapeVoxels(const CollisionObject* object)
+{
+    auto rit = std::remove_if(begin(m_local_voxels), end(m_local_voxels),
+            [&](const LocalShapeVoxels& entry) {
+                return std::find(
+                        begin(object->shapes), end(object->shapes),
+                        entry.shape) != end(object->shapes);
+            });
+    m_local_voxels.erase(rit, end(m_local_voxels));
+}
+
+// Re-rasterize an object at new shape poses by rigidly transforming the
+// cached local-frame voxelization of each shape instead of running the
+// voxelization pipeline again. The transformed samples are snapped to grid
+// cells and deduplicated so the cached world-frame voxels keep grid density.
+// Returns false, leaving the model untouched, when some shape has no reusable
+// local voxelization.
+bool WorldCollisionModel::transformObject(
+    ObjectCollisionModel* model,
+    const Affine3dVector& poses)
+{
+    auto* object = model->object;
+    assert(object->shapes.size() == poses.size());
+    assert(model->cached_voxels.size() == object->shapes.size());
+
+    // resolve every local voxelization before touching the grid so that
+    // failures fall back to removal + re-voxelization with the model
+    // unmodified
+    for (auto* shape : object->shapes) {
+        if (getLocalShapeVoxels(shape) == NULL) {
+            return false;
+        }
+    }
+
+    for (auto& voxel_list : model->cached_voxels) {
+        m_grid->removePointsFromField(voxel_list);
+    }
+
+    rasterizeFromLocalVoxels(model, poses);
+
+    removeObjectBounds(object);
+    insertObjectBounds(object, model->cached_voxels);
+
+    return true;
+}
+
+// Rebuild an object's cached world-frame voxel lists from the cached
+// local-frame voxelization of each shape and add them to the distance map.
+// The caller must have resolved local voxels for every shape and removed any
+// previous voxels of the object from the grid.
+void WorldCollisionModel::rasterizeFromLocalVoxels(
+    ObjectCollisionModel* model,
+    const Affine3dVector& poses)
+{
+    auto* object = model->object;
+
+    std::vector<std::uint64_t> cells;
+    for (size_t i = 0; i < object->shapes.size(); ++i) {
+        auto* entry = getLocalShapeVoxels(object->shapes[i]);
+
+        cells.clear();
+        cells.reserve(entry->voxels.size());
+        for (auto& v : entry->voxels) {
+            const Eigen::Vector3d p = poses[i] * v;
+            int gx, gy, gz;
+            m_grid->worldToGrid(p.x(), p.y(), p.z(), gx, gy, gz);
+            if (m_grid->isInBounds(gx, gy, gz)) {
+                cells.push_back(
+                        ((std::uint64_t)gx << 42) |
+                        ((std::uint64_t)gy << 21) |
+                        ((std::uint64_t)gz));
+            }
+        }
+        std::sort(begin(cells), end(cells));
+        cells.erase(std::unique(begin(cells), end(cells)), end(cells));
+
+        auto& voxel_list = model->cached_voxels[i];
+        voxel_list.clear();
+        voxel_list.reserve(cells.size());
+        for (const std::uint64_t cell : cells) {
+            double wx, wy, wz;
+            m_grid->gridToWorld(
+                    (int)(cell >> 42),
+                    (int)((cell >> 21) & 0x1FFFFF),
+                    (int)(cell & 0x1FFFFF),
+                    wx, wy, wz);
+            voxel_list.push_back(Eigen::Vector3d(wx, wy, wz));
+        }
+
+        ROS_DEBUG_NAMED(LOG, "Transformed %zu cached local voxels into %zu grid cells for collision object '%s'", entry->voxels.size(), voxel_list.size(), object->id.c_str());
+        m_grid->addPointsToField(voxel_list);
+    }
+}
+
+// Rebind an object's collision model, bounds, and broadphase entries to a new
+// CollisionObject instance describing the same object, and refresh the cached
+// shape poses from it.
+void WorldCollisionModel::rebindObject(
+    ObjectCollisionModel* model,
+    const CollisionObject* object)
+{
+    if (model->object != object) {
+        removeObjectBounds(model->object);
+        model->object = object;
+        insertObjectBounds(object, model->cached_voxels);
+    }
+    model->cached_shape_poses = object->shape_poses;
+}
+
 // Return true if the model does not already contain this object and the object
 // is not malformed.
 bool WorldCollisionModel::checkObjectInsert(const CollisionObject* object) const
@@ -36,8 +36,10 @@
 // standard includes
 #include <memory>
 #include <string>
+#include <vector>
 
 // system includes
+#include <Eigen/StdVector>
 #include <kdl/chain.hpp>
 #include <kdl/chainfksolverpos_recursive.hpp>
 #include <kdl/chainiksolverpos_nr_jl.hpp>
@@ -98,6 +100,22 @@ public:
         const RobotState& start,
         std::vector<RobotState>& solutions,
         ik_option::IkOption option = ik_option::UNRESTRICTED) override;
+
+    int computeIKBatch(
+        const Eigen::Affine3d* poses,
+        const RobotState* seeds,
+        int count,
+        std::vector<RobotState>& solutions,
+        std::vector<bool>& valid,
+        bool first_success = false,
+        ik_option::IkOption option = ik_option::UNRESTRICTED) override;
+    ///@}
+
+    /// \name ForwardKinematicsInterface
+    ///@{
+    /// Forward kinematics over the chain compiled at init when possible,
+    /// falling back to the generic link-tree update otherwise.
+    auto computeFK(const smpl::RobotState& state) -> Eigen::Affine3d override;
     ///@}
 
     /// \name Extension Interface
@@ -135,6 +153,43 @@ public:
     int m_free_angle;
     double m_search_discretization;
     double m_timeout;
+
+    // per-worker solver stacks for batched ik queries; the position solver
+    // holds references to its fk and velocity solvers, so each worker needs
+    // its own copies
+    struct BatchIKSolver
+    {
+        std::unique_ptr<KDL::ChainFkSolverPos_recursive>    fk_solver;
+        std::unique_ptr<KDL::ChainIkSolverVel_pinv>         ik_vel_solver;
+        std::unique_ptr<KDL::ChainIkSolverPos_NR_JL>        ik_solver;
+        KDL::JntArray                                       jnt_pos_in;
+        KDL::JntArray                                       jnt_pos_out;
+    };
+    std::vector<BatchIKSolver> m_batch_solvers;
+
+    // forward kinematics compiled at init: the base-to-tip chain flattened
+    // into one step per driven joint, each carrying the composition of all
+    // preceding fixed-joint transforms, so computeFK() walks a short
+    // contiguous array with one rotation (or translation) per planning
+    // variable and no tree traversal
+    struct CompiledFkStep
+    {
+        Eigen::Affine3d fixed;  // fixed-joint composition preceding the joint
+        Eigen::Vector3d axis;   // joint axis, in the frame after \p fixed
+        int vidx;               // planning variable driving this step
+        bool prismatic;         // translate along the axis instead of rotating
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+    std::vector<CompiledFkStep, Eigen::aligned_allocator<CompiledFkStep>>
+            m_compiled_fk;
+
+    // fixed-joint composition after the last driven joint
+    Eigen::Affine3d m_compiled_fk_tail;
+
+    // whether the chain admitted compilation; when false, computeFK()
+    // defers to the generic URDFRobotModel implementation
+    bool m_fk_compiled = false;
 };
 
 } // namespace smpl
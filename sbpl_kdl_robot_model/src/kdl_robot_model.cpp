@@ -32,6 +32,11 @@
 
 #include <sbpl_kdl_robot_model/kdl_robot_model.h>
 
+// standard includes
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 // system includes
 #include <eigen_conversions/eigen_kdl.h>
 #include <kdl/frames.hpp>
@@ -71,6 +76,93 @@ bool getCount(int& count, int max_count, int min_count)
     }
 }
 
+static
+void GetSolverJointLimits(
+    const KDLRobotModel* model,
+    KDL::JntArray& q_min,
+    KDL::JntArray& q_max)
+{
+    q_min.resize(model->jointVariableCount());
+    q_max.resize(model->jointVariableCount());
+    for (size_t i = 0; i < model->jointVariableCount(); ++i) {
+        if (model->vprops[i].continuous) {
+            q_min(i) = -M_PI;
+            q_max(i) = M_PI;
+        } else {
+            q_min(i) = model->vprops[i].min_position;
+            q_max(i) = model->vprops[i].max_position;
+        }
+    }
+}
+
+// Flatten the base-to-tip chain into the compiled step sequence executed by
+// computeFK(). Consecutive fixed joints are composed into the fixed prefix of
+// the next driven joint at compile time, so the hot path performs exactly one
+// transform concatenation and one axis rotation (or translation) per planning
+// variable. Compilation requires every driven joint in the chain to be a
+// single-variable revolute or prismatic joint in the planning group; returns
+// false, leaving the generic path in effect, otherwise.
+static
+bool CompileChainFK(KDLRobotModel* model)
+{
+    auto* base_link = GetLink(&model->m_robot_model, &model->m_base_link);
+    auto* tip_link = GetLink(&model->m_robot_model, &model->m_tip_link);
+    if (base_link == NULL || tip_link == NULL) {
+        return false;
+    }
+
+    // gather the joints from tip to base...
+    std::vector<const urdf::Joint*> joints;
+    auto* link = tip_link;
+    while (link != base_link) {
+        auto* joint = link->parent;
+        if (joint == NULL) {
+            return false; // base link is not an ancestor of the tip link
+        }
+        joints.push_back(joint);
+        link = joint->parent;
+    }
+
+    // ...and walk them in base-to-tip order
+    model->m_compiled_fk.clear();
+    auto fixed = Eigen::Affine3d::Identity();
+    for (auto it = joints.rbegin(); it != joints.rend(); ++it) {
+        auto* joint = *it;
+        fixed = fixed * joint->origin;
+        if (joint->type == urdf::JointType::Fixed) {
+            continue;
+        }
+        if (joint->type != urdf::JointType::Revolute &&
+            joint->type != urdf::JointType::Prismatic)
+        {
+            return false;
+        }
+
+        // map the joint's variable to its planning variable index
+        auto state_vidx = (int)GetVariableIndex(
+                &model->m_robot_model, joint->vfirst);
+        auto pit = std::find(
+                begin(model->planning_to_state_variable),
+                end(model->planning_to_state_variable),
+                state_vidx);
+        if (pit == end(model->planning_to_state_variable)) {
+            return false;
+        }
+
+        KDLRobotModel::CompiledFkStep step;
+        step.fixed = fixed;
+        step.axis = joint->axis;
+        step.vidx = (int)std::distance(
+                begin(model->planning_to_state_variable), pit);
+        step.prismatic = joint->type == urdf::JointType::Prismatic;
+        model->m_compiled_fk.push_back(step);
+
+        fixed = Eigen::Affine3d::Identity();
+    }
+    model->m_compiled_fk_tail = fixed;
+    return true;
+}
+
 static
 bool Init(
     KDLRobotModel* model,
@@ -151,17 +243,9 @@ bool Init(
     model->m_ik_vel_solver = make_unique<KDL::ChainIkSolverVel_pinv>(model->m_chain);
 
     // IK solver
-    KDL::JntArray q_min(model->jointVariableCount());
-    KDL::JntArray q_max(model->jointVariableCount());
-    for (size_t i = 0; i < model->jointVariableCount(); ++i) {
-        if (model->vprops[i].continuous) {
-            q_min(i) = -M_PI;
-            q_max(i) = M_PI;
-        } else {
-            q_min(i) = model->vprops[i].min_position;
-            q_max(i) = model->vprops[i].max_position;
-        }
-    }
+    KDL::JntArray q_min;
+    KDL::JntArray q_max;
+    GetSolverJointLimits(model, q_min, q_max);
 
     model->m_max_iterations = 200;
     model->m_kdl_eps = 0.001;
@@ -179,6 +263,12 @@ bool Init(
     model->m_free_angle = free_angle;
     model->m_search_discretization = 0.02;
     model->m_timeout = 0.005;
+
+    model->m_fk_compiled = CompileChainFK(model);
+    ROS_INFO("Compiled FK %s for chain (%s, %s)",
+            model->m_fk_compiled ? "enabled" : "unavailable",
+            base_link.c_str(), tip_link.c_str());
+
     return true;
 }
 
@@ -221,56 +311,60 @@ double GetSolverMinPosition(KDLRobotModel* model, int vidx)
     }
 }
 
-bool KDLRobotModel::computeIKSearch(
-    const Eigen::Affine3d& pose,
+// Search for an IK solution to a pose given in the kinematics frame by
+// sweeping the free angle away from the seed configuration. The solver and
+// scratch joint arrays are passed in so that concurrent searches may each
+// use their own.
+static
+bool SearchFreeAngle(
+    KDLRobotModel* model,
+    KDL::ChainIkSolverPos_NR_JL* ik_solver,
+    KDL::JntArray* jnt_pos_in,
+    KDL::JntArray* jnt_pos_out,
+    const KDL::Frame& frame_des,
     const RobotState& start,
     RobotState& solution)
 {
-    // transform into kinematics and convert to kdl
-    auto* T_map_kinematics = GetLinkTransform(&this->robot_state, m_kinematics_link);
-    KDL::Frame frame_des;
-    tf::transformEigenToKDL(T_map_kinematics->inverse() * pose, frame_des);
-
     // seed configuration
     for (size_t i = 0; i < start.size(); i++) {
-        m_jnt_pos_in(i) = start[i];
+        (*jnt_pos_in)(i) = start[i];
     }
 
     // must be normalized for CartToJntSearch
-    NormalizeAngles(this, &m_jnt_pos_in);
+    NormalizeAngles(model, jnt_pos_in);
 
-    auto initial_guess = m_jnt_pos_in(m_free_angle);
+    auto initial_guess = (*jnt_pos_in)(model->m_free_angle);
 
     auto start_time = smpl::clock::now();
     auto loop_time = 0.0;
     auto count = 0;
 
     auto num_positive_increments =
-            (int)((GetSolverMinPosition(this, m_free_angle) - initial_guess) /
-                    this->m_search_discretization);
+            (int)((GetSolverMinPosition(model, model->m_free_angle) - initial_guess) /
+                    model->m_search_discretization);
     auto num_negative_increments =
-            (int)((initial_guess - GetSolverMinPosition(this, m_free_angle)) /
-                    this->m_search_discretization);
+            (int)((initial_guess - GetSolverMinPosition(model, model->m_free_angle)) /
+                    model->m_search_discretization);
 
-    while (loop_time < this->m_timeout) {
-        if (m_ik_solver->CartToJnt(m_jnt_pos_in, frame_des, m_jnt_pos_out) >= 0) {
-            NormalizeAngles(this, &m_jnt_pos_out);
+    while (loop_time < model->m_timeout) {
+        if (ik_solver->CartToJnt(*jnt_pos_in, frame_des, *jnt_pos_out) >= 0) {
+            NormalizeAngles(model, jnt_pos_out);
             solution.resize(start.size());
             for (size_t i = 0; i < solution.size(); ++i) {
-                solution[i] = m_jnt_pos_out(i);
+                solution[i] = (*jnt_pos_out)(i);
             }
             return true;
         }
         if (!getCount(count, num_positive_increments, -num_negative_increments)) {
             return false;
         }
-        m_jnt_pos_in(m_free_angle) = initial_guess + this->m_search_discretization * count;
-        ROS_DEBUG("%d, %f", count, m_jnt_pos_in(m_free_angle));
+        (*jnt_pos_in)(model->m_free_angle) = initial_guess + model->m_search_discretization * count;
+        ROS_DEBUG("%d, %f", count, (*jnt_pos_in)(model->m_free_angle));
         loop_time = to_seconds(smpl::clock::now() - start_time);
     }
 
-    if (loop_time >= this->m_timeout) {
-        ROS_DEBUG("IK Timed out in %f seconds", this->m_timeout);
+    if (loop_time >= model->m_timeout) {
+        ROS_DEBUG("IK Timed out in %f seconds", model->m_timeout);
         return false;
     } else {
         ROS_DEBUG("No IK solution was found");
@@ -279,6 +373,26 @@ bool KDLRobotModel::computeIKSearch(
     return false;
 }
 
+bool KDLRobotModel::computeIKSearch(
+    const Eigen::Affine3d& pose,
+    const RobotState& start,
+    RobotState& solution)
+{
+    // transform into kinematics and convert to kdl
+    auto* T_map_kinematics = GetLinkTransform(&this->robot_state, m_kinematics_link);
+    KDL::Frame frame_des;
+    tf::transformEigenToKDL(T_map_kinematics->inverse() * pose, frame_des);
+
+    return SearchFreeAngle(
+            this,
+            m_ik_solver.get(),
+            &m_jnt_pos_in,
+            &m_jnt_pos_out,
+            frame_des,
+            start,
+            solution);
+}
+
 bool KDLRobotModel::computeIK(
     const Eigen::Affine3d& pose,
     const RobotState& start,
@@ -306,6 +420,126 @@ bool KDLRobotModel::computeIK(
     return solutions.size() > 0;
 }
 
+// Grow the pool of per-worker solver stacks to at least the given size.
+static
+void EnsureBatchSolvers(KDLRobotModel* model, int count)
+{
+    if ((int)model->m_batch_solvers.size() >= count) {
+        return;
+    }
+
+    KDL::JntArray q_min;
+    KDL::JntArray q_max;
+    GetSolverJointLimits(model, q_min, q_max);
+
+    while ((int)model->m_batch_solvers.size() < count) {
+        KDLRobotModel::BatchIKSolver solver;
+        solver.fk_solver =
+                make_unique<KDL::ChainFkSolverPos_recursive>(model->m_chain);
+        solver.ik_vel_solver =
+                make_unique<KDL::ChainIkSolverVel_pinv>(model->m_chain);
+        solver.ik_solver = make_unique<KDL::ChainIkSolverPos_NR_JL>(
+                model->m_chain,
+                q_min,
+                q_max,
+                *solver.fk_solver,
+                *solver.ik_vel_solver,
+                model->m_max_iterations,
+                model->m_kdl_eps);
+        solver.jnt_pos_in.resize(model->m_chain.getNrOfJoints());
+        solver.jnt_pos_out.resize(model->m_chain.getNrOfJoints());
+        model->m_batch_solvers.push_back(std::move(solver));
+    }
+}
+
+int KDLRobotModel::computeIKBatch(
+    const Eigen::Affine3d* poses,
+    const RobotState* seeds,
+    int count,
+    std::vector<RobotState>& solutions,
+    std::vector<bool>& valid,
+    bool first_success,
+    ik_option::IkOption option)
+{
+    if (option != ik_option::UNRESTRICTED) {
+        solutions.assign(count, RobotState());
+        valid.assign(count, false);
+        return -1;
+    }
+
+    auto num_threads = (int)std::min(
+            (unsigned)count, std::thread::hardware_concurrency());
+    if (num_threads <= 1) {
+        return InverseKinematicsInterface::computeIKBatch(
+                poses, seeds, count, solutions, valid, first_success, option);
+    }
+
+    EnsureBatchSolvers(this, num_threads);
+
+    solutions.assign(count, RobotState());
+    valid.assign(count, false);
+
+    // transform targets into the kinematics frame up front; the kinematics
+    // link transform is shared by every query
+    auto* T_map_kinematics = GetLinkTransform(&this->robot_state, m_kinematics_link);
+    auto T_kinematics_map = T_map_kinematics->inverse();
+    std::vector<KDL::Frame> frames(count);
+    for (auto i = 0; i < count; ++i) {
+        tf::transformEigenToKDL(T_kinematics_map * poses[i], frames[i]);
+    }
+
+    std::vector<unsigned char> solved(count, 0);
+    std::atomic<int> next(0);
+    std::atomic<int> found(-1);
+
+    auto work = [&](int rank) {
+        auto& solver = m_batch_solvers[rank];
+        for (;;) {
+            if (first_success && found.load() != -1) {
+                return;
+            }
+            auto i = next.fetch_add(1);
+            if (i >= count) {
+                return;
+            }
+            if (SearchFreeAngle(
+                    this,
+                    solver.ik_solver.get(),
+                    &solver.jnt_pos_in,
+                    &solver.jnt_pos_out,
+                    frames[i],
+                    seeds[i],
+                    solutions[i]))
+            {
+                solved[i] = 1;
+                if (first_success) {
+                    auto expected = -1;
+                    found.compare_exchange_strong(expected, i);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (auto rank = 0; rank < num_threads; ++rank) {
+        threads.emplace_back(work, rank);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto result = -1;
+    for (auto i = 0; i < count; ++i) {
+        if (solved[i]) {
+            valid[i] = true;
+            if (result == -1) {
+                result = i;
+            }
+        }
+    }
+    return result;
+}
+
 bool KDLRobotModel::computeFastIK(
     const Eigen::Affine3d& pose,
     const RobotState& start,
@@ -343,6 +577,28 @@ void KDLRobotModel::printRobotModelInformation()
     leatherman::printKDLChain(m_chain, "robot_model");
 }
 
+auto KDLRobotModel::computeFK(const smpl::RobotState& state) -> Eigen::Affine3d
+{
+    if (!m_fk_compiled) {
+        return URDFRobotModel::computeFK(state);
+    }
+
+    // the kinematics link moves only with the reference state, so this is a
+    // dirty-flag check unless a reference variable has changed
+    UpdateLinkTransform(&this->robot_state, this->m_kinematics_link);
+    auto t = *GetLinkTransform(&this->robot_state, this->m_kinematics_link);
+
+    for (auto& step : m_compiled_fk) {
+        t = t * step.fixed;
+        if (step.prismatic) {
+            t.translate(step.axis * state[step.vidx]);
+        } else {
+            t.rotate(Eigen::AngleAxisd(state[step.vidx], step.axis));
+        }
+    }
+    return t * m_compiled_fk_tail;
+}
+
 auto KDLRobotModel::getExtension(size_t class_code) -> Extension*
 {
     if (class_code == GetClassCode<InverseKinematicsInterface>()) return this;
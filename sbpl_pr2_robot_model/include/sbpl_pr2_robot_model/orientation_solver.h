@@ -40,6 +40,9 @@
 #include <string>
 #include <vector>
 
+// project includes
+#include <smpl/types.h>
+
 namespace smpl {
 
 class RPYSolver
@@ -56,11 +59,11 @@ class RPYSolver
     /// \param solution Joint variable vector of the solution
     bool computeRPYOnly(
         const std::vector<double>& rpy,
-        const std::vector<double>& start,
+        const RobotState& start,
         const std::vector<double>& forearm_roll_link_pose,
         const std::vector<double>& endeff_link_pose,
         int solution_num,
-        std::vector<double>& solution) const;
+        RobotState& solution) const;
 
   private:
 
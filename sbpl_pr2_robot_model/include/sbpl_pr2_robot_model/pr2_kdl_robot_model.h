@@ -33,6 +33,8 @@
 #define SBPL_PR2_ROBOT_MODEL_PR2_KDL_ROBOT_MODEL_H
 
 // standard includes
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -73,6 +75,12 @@ public:
         RobotState& solution) override;
     ///@}
 
+    /// Set the discretization used to key cached IK solutions. Choose values
+    /// matching the planning lattice discretization so that queries for
+    /// adjacent lattice cells seed from one another's solutions. Clears the
+    /// cache.
+    void setIKCacheResolution(double xyz_res, double rpy_res);
+
 private:
 
     std::unique_ptr<pr2_arm_kinematics::PR2ArmIKSolver> pr2_ik_solver_;
@@ -82,6 +90,18 @@ private:
     std::string m_forearm_roll_link_name;
     std::string m_wrist_pitch_joint_name;
     std::string m_end_effector_link_name;
+
+    // Successful IK solutions keyed by the discretized end effector pose in
+    // the kinematics frame. Consecutive queries during successor generation
+    // differ by one lattice cell, so the solution cached for the same or a
+    // neighboring cell seeds the iterative solver a few steps from
+    // convergence.
+    hash_map<std::uint64_t, RobotState> m_ik_cache;
+    double m_ik_cache_xyz_res = 0.02;           // meters
+    double m_ik_cache_rpy_res = M_PI / 36.0;    // radians
+
+    bool seedFromIKCache(const KDL::Frame& frame_des, const RobotState& start);
+    void cacheIKSolution(const KDL::Frame& frame_des, const RobotState& solution);
 };
 
 } // namespace smpl
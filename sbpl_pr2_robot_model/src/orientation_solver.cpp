@@ -56,11 +56,11 @@ RPYSolver::RPYSolver(double wrist_pitch_min_limit, double wrist_pitch_max_limit)
 
 bool RPYSolver::computeRPYOnly(
     const std::vector<double>& rpy,
-    const std::vector<double>& start,
+    const RobotState& start,
     const std::vector<double>& forearm_roll_link_pose,
     const std::vector<double>& endeff_link_pose,
     int solution_num,
-    std::vector<double>& solution) const
+    RobotState& solution) const
 {
     double hand_rotations[4];
 
@@ -31,6 +31,10 @@
 
 #include <sbpl_pr2_robot_model/pr2_kdl_robot_model.h>
 
+// standard includes
+#include <algorithm>
+#include <cmath>
+
 // system includes
 #include <eigen_conversions/eigen_kdl.h>
 #include <kdl/tree.hpp>
@@ -97,6 +101,37 @@ static void NormalizeAngles(KDLRobotModel* model, KDL::JntArray* q)
     }
 }
 
+// Discretize a pose in the kinematics frame into (x, y, z, R, P, Y) cell
+// coordinates for the IK solution cache.
+static void GetIKCacheCells(
+    const KDL::Frame& frame,
+    double xyz_res,
+    double rpy_res,
+    int cells[6])
+{
+    double rpy[3];
+    frame.M.GetRPY(rpy[0], rpy[1], rpy[2]);
+    cells[0] = (int)std::floor(frame.p.x() / xyz_res);
+    cells[1] = (int)std::floor(frame.p.y() / xyz_res);
+    cells[2] = (int)std::floor(frame.p.z() / xyz_res);
+    cells[3] = (int)std::floor(rpy[0] / rpy_res);
+    cells[4] = (int)std::floor(rpy[1] / rpy_res);
+    cells[5] = (int)std::floor(rpy[2] / rpy_res);
+}
+
+// Pack pose cell coordinates into a hashable cache key. Each coordinate is
+// clamped to a signed 10-bit cell range, large enough to span the reachable
+// workspace at centimeter resolutions.
+static std::uint64_t PackIKCacheKey(const int cells[6])
+{
+    std::uint64_t key = 0;
+    for (int i = 0; i < 6; ++i) {
+        auto c = std::max(-512, std::min(511, cells[i]));
+        key = (key << 10) | (std::uint64_t)((std::uint32_t)c & 0x3FF);
+    }
+    return key;
+}
+
 bool PR2KDLRobotModel::computeIK(
     const Eigen::Affine3d& pose,
     const RobotState& start,
@@ -155,6 +190,7 @@ bool PR2KDLRobotModel::computeIK(
     if (pr2_ik_solver_) {
         auto timeout = 0.2;
         auto consistency_limit = 2.0 * M_PI;
+        auto seeded = seedFromIKCache(frame_des, start);
         if (pr2_ik_solver_->CartToJntSearch(
                 m_jnt_pos_in,
                 frame_des,
@@ -162,13 +198,31 @@ bool PR2KDLRobotModel::computeIK(
                 timeout,
                 consistency_limit) < 0)
         {
-            return false;
+            if (!seeded) {
+                return false;
+            }
+
+            // fall back to the caller's seed configuration
+            for (size_t i = 0; i < start.size(); i++) {
+                m_jnt_pos_in(i) = start[i];
+            }
+            NormalizeAngles(this, &m_jnt_pos_in);
+            if (pr2_ik_solver_->CartToJntSearch(
+                    m_jnt_pos_in,
+                    frame_des,
+                    m_jnt_pos_out,
+                    timeout,
+                    consistency_limit) < 0)
+            {
+                return false;
+            }
         }
 
         solution.resize(start.size());
         for (size_t i = 0; i < solution.size(); ++i) {
             solution[i] = m_jnt_pos_out(i);
         }
+        cacheIKSolution(frame_des, solution);
     }
 
     return KDLRobotModel::computeIK(pose, start, solution, option);
@@ -190,16 +244,104 @@ bool PR2KDLRobotModel::computeFastIK(
 
     NormalizeAngles(this, &m_jnt_pos_in);
 
+    auto seeded = seedFromIKCache(frame_des, start);
+
     if (pr2_ik_solver_->CartToJnt(m_jnt_pos_in, frame_des, m_jnt_pos_out) < 0) {
-        return false;
+        if (!seeded) {
+            return false;
+        }
+
+        // fall back to the caller's seed configuration
+        for (size_t i = 0; i < start.size(); i++) {
+            m_jnt_pos_in(i) = start[i];
+        }
+        NormalizeAngles(this, &m_jnt_pos_in);
+        if (pr2_ik_solver_->CartToJnt(m_jnt_pos_in, frame_des, m_jnt_pos_out) < 0) {
+            return false;
+        }
     }
 
     solution.resize(start.size());
     for (size_t i = 0; i < solution.size(); ++i) {
         solution[i] = m_jnt_pos_out(i);
     }
+    cacheIKSolution(frame_des, solution);
 
     return true;
 }
 
+void PR2KDLRobotModel::setIKCacheResolution(double xyz_res, double rpy_res)
+{
+    m_ik_cache_xyz_res = xyz_res;
+    m_ik_cache_rpy_res = rpy_res;
+    m_ik_cache.clear();
+}
+
+// Seed the solver from the solution cached for the cell containing the query
+// pose, or for one of its six position neighbors. Returns true if the seed
+// was replaced; the caller must fall back to its own seed on failure.
+bool PR2KDLRobotModel::seedFromIKCache(
+    const KDL::Frame& frame_des,
+    const RobotState& start)
+{
+    int cells[6];
+    GetIKCacheCells(frame_des, m_ik_cache_xyz_res, m_ik_cache_rpy_res, cells);
+
+    const RobotState* cached = NULL;
+    auto it = m_ik_cache.find(PackIKCacheKey(cells));
+    if (it != end(m_ik_cache)) {
+        cached = &it->second;
+    } else {
+        for (int i = 0; i < 3 && cached == NULL; ++i) {
+            for (int d = -1; d <= 1 && cached == NULL; d += 2) {
+                cells[i] += d;
+                auto nit = m_ik_cache.find(PackIKCacheKey(cells));
+                cells[i] -= d;
+                if (nit != end(m_ik_cache)) {
+                    cached = &nit->second;
+                }
+            }
+        }
+    }
+
+    if (cached == NULL || cached->size() != start.size()) {
+        return false;
+    }
+
+    // only adopt a cached seed on the same solution branch as the caller's
+    // seed; a distant seed would converge to a discontinuous solution
+    const double MaxSeedDist = 0.35; // radians, per joint
+    for (size_t i = 0; i < start.size(); ++i) {
+        auto dist = this->vprops[i].continuous ?
+                angles::shortest_angle_dist((*cached)[i], start[i]) :
+                std::fabs((*cached)[i] - start[i]);
+        if (dist > MaxSeedDist) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < cached->size(); ++i) {
+        m_jnt_pos_in(i) = (*cached)[i];
+    }
+    NormalizeAngles(this, &m_jnt_pos_in);
+    return true;
+}
+
+// Record a successful solution for the cell containing the query pose,
+// overwriting any previous solution for that cell. The cache is dropped
+// wholesale when it grows past a fixed bound.
+void PR2KDLRobotModel::cacheIKSolution(
+    const KDL::Frame& frame_des,
+    const RobotState& solution)
+{
+    const size_t MaxCacheSize = 100000;
+    if (m_ik_cache.size() >= MaxCacheSize) {
+        m_ik_cache.clear();
+    }
+
+    int cells[6];
+    GetIKCacheCells(frame_des, m_ik_cache_xyz_res, m_ik_cache_rpy_res, cells);
+    m_ik_cache[PackIKCacheKey(cells)] = solution;
+}
+
 } // namespace smpl
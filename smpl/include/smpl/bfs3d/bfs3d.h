@@ -34,19 +34,39 @@
 #define SMPL_BFS3D_H
 
 #include <stdio.h>
+#include <cstdint>
+#include <functional>
 #include <queue>
 #include <thread>
 #include <tuple>
+#include <vector>
 #include <iostream>
 
+// select the width of the distance grid cells; distances are measured in
+// cells and rarely exceed a few thousand, so 16-bit cells suffice for most
+// workspaces while quartering the memory footprint of the distance grid and
+// packing four times as many cells into each cache line touched by the
+// wavefront and by getDistance()
+#ifndef SMPL_BFS3D_CELL_BITS
+#define SMPL_BFS3D_CELL_BITS 32
+#endif
+
 namespace smpl {
 
 class BFS_3D
 {
 public:
 
-    static const int WALL = 0x7FFFFFFF;
-    static const int UNDISCOVERED = 0xFFFFFFFF;
+#if SMPL_BFS3D_CELL_BITS == 16
+    typedef std::int16_t Cell;
+    static const Cell WALL = 0x7FFF;
+#elif SMPL_BFS3D_CELL_BITS == 32
+    typedef std::int32_t Cell;
+    static const Cell WALL = 0x7FFFFFFF;
+#else
+#error "Unrecognized BFS3D cell width configuration"
+#endif
+    static const Cell UNDISCOVERED = -1;
 
     BFS_3D(int length, int width, int height);
     ~BFS_3D();
@@ -55,6 +75,31 @@ public:
 
     void setWall(int x, int y, int z);
 
+    /// \brief Copy the wall cells of another grid of identical dimensions.
+    ///
+    /// All distances become undiscovered, as if the walls had been set on a
+    /// fresh grid. This lets several searches over the same obstacle snapshot
+    /// pay the occupancy scan only once. The search must not be running on
+    /// either grid.
+    ///
+    /// \return false if the dimensions differ or either search is running
+    bool copyWalls(const BFS_3D& other);
+
+    /// \name Incremental Wall Updates
+    ///
+    /// Locally repair the distance grid after a batch of cells becomes
+    /// occupied or free, re-propagating the wavefront only from the affected
+    /// frontier rather than re-running the full search. The search must not
+    /// be running. Input iterators dereference to a flattened sequence of
+    /// (x, y, z) cell coordinate triples, as with run().
+    ///@{
+    template <typename InputIt>
+    void addWalls(InputIt cells_begin, InputIt cells_end);
+
+    template <typename InputIt>
+    void removeWalls(InputIt cells_begin, InputIt cells_end);
+    ///@}
+
     // \brief Clear cells around a given cell until freespace is encountered.
     //
     // Clear cells around a given cell, in bfs-fashion, until a path has been
@@ -64,6 +109,17 @@ public:
     //         otherwise
     bool escapeCell(int x, int y, int z);
 
+    /// \brief Set the number of threads used to propagate the wavefront.
+    ///
+    /// With more than one thread, run() expands each wavefront level in
+    /// parallel: the frontier is partitioned across threads, discovered cells
+    /// are claimed with atomic compare-and-swap so each cell is queued exactly
+    /// once, and the next frontier is gathered from per-thread queues. Cells
+    /// still transition directly from UNDISCOVERED to their final distance, so
+    /// concurrent getDistance() calls behave as in the single-threaded mode.
+    /// Values less than 1 are clamped to 1.
+    void setNumThreads(int num_threads);
+
     void run(int x, int y, int z);
 
     /// \brief Run the BFS starting from a variable number of cells
@@ -72,6 +128,30 @@ public:
 
     void run_components(int gx, int gy, int gz);
 
+    /// \name Free-Space Component Labels
+    ///
+    /// Label the 26-connected components of free space, so that reachability
+    /// between two cells is a label comparison. Labeling is block-parallel:
+    /// each z-slab is labeled independently across the wavefront threads and
+    /// the slab-local labels are then merged with a union-find pass over the
+    /// slab interfaces. Wall updates mark their slab dirty, and
+    /// updateComponentLabels() relabels only the dirty slabs before
+    /// repeating the merge, so incremental map updates cost a few slabs
+    /// rather than a sweep of the grid. The search must not be running.
+    ///@{
+    void computeComponentLabels();
+    void updateComponentLabels();
+
+    /// \brief Return the component label of a cell.
+    ///
+    /// Returns -1 for walls, out-of-bounds cells, and when no labeling has
+    /// been computed.
+    int getComponentLabel(int x, int y, int z) const;
+
+    /// \brief Return whether two free cells lie in the same component.
+    bool sameComponent(int x1, int y1, int z1, int x2, int y2, int z2) const;
+    ///@}
+
     bool inBounds(int x, int y, int z) const;
 
     /// \brief Return the distance, in cells, to the nearest occupied cell.
@@ -80,6 +160,22 @@ public:
     /// has not yet been computed for this cell.
     int getDistance(int x, int y, int z) const;
 
+    /// \brief Non-blocking variant of getDistance().
+    ///
+    /// Returns the final distance once the wavefront has closed the cell,
+    /// WALL for wall cells, and UNDISCOVERED, without waiting, while the
+    /// search is still running and has not yet reached the cell. Cells
+    /// transition directly from UNDISCOVERED to their final distance, so a
+    /// non-negative return value is never provisional.
+    int tryGetDistance(int x, int y, int z) const;
+
+    /// \brief Install a callback invoked when the wavefront exhausts.
+    ///
+    /// The callback runs on the background search thread at the end of each
+    /// subsequent run(). Install an empty function to remove it. Must not be
+    /// called while the search is running.
+    void setCompletionCallback(std::function<void()> callback);
+
     /// \brief Return whether this cell has been discovered.
     ///
     /// This function is blocking if the BFS is running. Once the BFS has
@@ -96,6 +192,9 @@ public:
     int countUndiscovered() const;
     int countDiscovered() const;
 
+    /// \brief Return the approximate number of bytes held by the grid.
+    size_t memUsage() const;
+
 private:
 
     std::thread m_search_thread;
@@ -103,21 +202,42 @@ private:
     int m_dim_x, m_dim_y, m_dim_z;
     int m_dim_xy, m_dim_xyz;
 
-    int volatile* m_distance_grid;
+    Cell volatile* m_distance_grid;
 
     int* m_queue;
     int m_queue_head, m_queue_tail;
 
     volatile bool m_running;
 
+    int m_num_threads;
+
+    std::function<void()> m_completion_callback;
+
     int m_neighbor_offsets[26];
     std::vector<bool> m_closed;
     std::vector<int> m_distances;
 
+    // free-space component labeling: slab-local labels per node (-1 for
+    // walls and unlabeled cells), the slab thickness in z-planes, per-slab
+    // label counts and global id offsets, the flattened union-find parents
+    // over global ids, and per-slab dirty marks; the label grid is null
+    // until a labeling is requested
+    int* m_comp_labels;
+    int m_comp_slab;
+    std::vector<int> m_comp_counts;
+    std::vector<int> m_comp_offsets;
+    std::vector<int> m_comp_uf;
+    std::vector<std::uint8_t> m_comp_dirty;
+
     int getNode(int x, int y, int z) const;
     bool getCoord(int node, int& x, int& y, int& z) const;
+    void addWallNodes(const std::vector<int>& nodes);
+    void removeWallNodes(const std::vector<int>& nodes);
+    void repairDistances(std::vector<int>& seeds);
     void setWall(int node);
     void unsetWall(int node);
+    int labelSlab(int slab);
+    void markComponentSlabDirty(int node);
     bool isWall(int node) const;
     int isUndiscovered(int node) const;
     int neighbor(int node, int neighbor) const;
@@ -125,7 +245,7 @@ private:
     void search(
         int width,
         int planeSize,
-        int volatile* distance_grid,
+        Cell volatile* distance_grid,
         int* queue,
         int& queue_head,
         int& queue_tail);
@@ -133,15 +253,19 @@ private:
     void search(
         int width,
         int planeSize,
-        int volatile* distance_grid,
+        Cell volatile* distance_grid,
         int* queue,
         int& queue_head,
         int& queue_tail,
-        int volatile* frontier_grid,
+        Cell volatile* frontier_grid,
         int* frontier_queue,
         int& frontier_queue_head,
         int& frontier_queue_tail);
 
+    void searchParallel(int num_threads);
+
+    void launchSearch();
+
     template <typename Visitor>
     void visit_free_cells(int node, const Visitor& visitor);
 };
@@ -184,13 +308,45 @@ void BFS_3D::run(InputIt cells_begin, InputIt cells_end)
 
     m_queue_tail = start_count;
 
-    // fire off background thread to compute bfs
-    m_search_thread = std::thread([&]()
-    {
-        this->search(m_dim_x, m_dim_xy, m_distance_grid, m_queue, m_queue_head, m_queue_tail);
-    });
+    launchSearch();
+}
+
+template <typename InputIt>
+void BFS_3D::addWalls(InputIt cells_begin, InputIt cells_end)
+{
+    std::vector<int> nodes;
+    int xyz[3];
+    int ind = 0;
+    for (auto it = cells_begin; it != cells_end;) {
+        xyz[ind++] = *it++;
+        if (ind == 3) {
+            int node = getNode(xyz[0], xyz[1], xyz[2]);
+            if (node >= 0) {
+                nodes.push_back(node);
+            }
+            ind = 0;
+        }
+    }
+    addWallNodes(nodes);
+}
 
-    m_running = true;
+template <typename InputIt>
+void BFS_3D::removeWalls(InputIt cells_begin, InputIt cells_end)
+{
+    std::vector<int> nodes;
+    int xyz[3];
+    int ind = 0;
+    for (auto it = cells_begin; it != cells_end;) {
+        xyz[ind++] = *it++;
+        if (ind == 3) {
+            int node = getNode(xyz[0], xyz[1], xyz[2]);
+            if (node >= 0) {
+                nodes.push_back(node);
+            }
+            ind = 0;
+        }
+    }
+    removeWallNodes(nodes);
 }
 
 inline int BFS_3D::getNode(int x, int y, int z) const
@@ -220,11 +376,20 @@ inline bool BFS_3D::getCoord(int node, int& x, int& y, int& z) const
 inline void BFS_3D::setWall(int node)
 {
     m_distance_grid[node] = WALL;
+    markComponentSlabDirty(node);
 }
 
 inline void BFS_3D::unsetWall(int node)
 {
     m_distance_grid[node] = UNDISCOVERED;
+    markComponentSlabDirty(node);
+}
+
+inline void BFS_3D::markComponentSlabDirty(int node)
+{
+    if (m_comp_labels != NULL) {
+        m_comp_dirty[(node / m_dim_xy) / m_comp_slab] = 1;
+    }
 }
 
 inline bool BFS_3D::isWall(int node) const
@@ -242,6 +407,15 @@ inline int BFS_3D::neighbor(int node, int neighbor) const
     return node + m_neighbor_offsets[neighbor];
 }
 
+inline size_t BFS_3D::memUsage() const
+{
+    return (size_t)m_dim_xyz * sizeof(Cell) +      // distance grid
+            (size_t)m_dim_xyz * sizeof(int) +       // search queue
+            (m_comp_labels != NULL ? (size_t)m_dim_xyz * sizeof(int) : 0) +
+            m_closed.capacity() / 8 +
+            m_distances.capacity() * sizeof(int);
+}
+
 } // namespace smpl
 
 #endif
@@ -76,6 +76,28 @@ public:
         const RobotState& finish,
         bool verbose = false) = 0;
 
+    /// \brief Return the validity of the motions from one state to each of a
+    /// set of states.
+    ///
+    /// Results are returned in the order of \p finishes. The default
+    /// implementation checks each motion in turn; collision checkers whose
+    /// motion validations are independent may override this to evaluate them
+    /// concurrently.
+    ///
+    /// \param[in] start The starting configuration of the joint group
+    /// \param[in] finishes The ending configurations of the joint group
+    /// \param[out] valid The validity of each motion
+    virtual void isStateToStatesValid(
+        const RobotState& start,
+        const std::vector<RobotState>& finishes,
+        std::vector<bool>& valid)
+    {
+        valid.resize(finishes.size());
+        for (size_t i = 0; i < finishes.size(); ++i) {
+            valid[i] = isStateToStateValid(start, finishes[i]);
+        }
+    }
+
     /// \brief Return a linearly interpolated path between two joint states.
     ///
     /// This intended use is for this member function should return the path
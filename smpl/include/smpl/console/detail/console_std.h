@@ -49,6 +49,23 @@ void InitializeLogLocation(
   #endif
 #endif
 
+// Severity constants for compile-time filtering. Statements below
+// SMPL_LOG_LEVEL compile to nothing: their location lookup, argument
+// evaluation, and formatting are all removed, not just filtered at runtime.
+// Define SMPL_LOG_LEVEL on the compile line (e.g.
+// -DSMPL_LOG_LEVEL=SMPL_LOG_LEVEL_WARN) to strip debug and info statements
+// from hot paths in release builds.
+#define SMPL_LOG_LEVEL_DEBUG 0
+#define SMPL_LOG_LEVEL_INFO 1
+#define SMPL_LOG_LEVEL_WARN 2
+#define SMPL_LOG_LEVEL_ERROR 3
+#define SMPL_LOG_LEVEL_FATAL 4
+#define SMPL_LOG_LEVEL_NONE 5
+
+#ifndef SMPL_LOG_LEVEL
+#define SMPL_LOG_LEVEL SMPL_LOG_LEVEL_DEBUG
+#endif
+
 void print(Level level, const char* filename, int line, const char* fmt, ...);
 void print(Level level, const char* filename, int line, const std::stringstream& ss);
 
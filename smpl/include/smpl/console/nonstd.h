@@ -5,6 +5,8 @@
 #include <utility>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 namespace std {
 
 template <class T, class Allocator>
@@ -21,6 +23,24 @@ ostream& operator<<(ostream& o, const vector<T, Allocator>& v)
     return o;
 }
 
+// variadic trailing parameters to span boost versions with and without the
+// options template parameter
+template <class T, size_t N, class... Rest>
+ostream& operator<<(
+    ostream& o,
+    const boost::container::small_vector<T, N, Rest...>& v)
+{
+    o << "[ ";
+    for (size_t i = 0; i < v.size(); ++i) {
+        o << v[i];
+        if (i != v.size() - 1) {
+            o << ", ";
+        }
+    }
+    o << " ]";
+    return o;
+}
+
 template <class T1, class T2>
 ostream& operator<<(ostream& o, const pair<T1, T2>& p)
 {
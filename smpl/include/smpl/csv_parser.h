@@ -123,6 +123,63 @@ private:
         std::string& name);
 };
 
+/// Non-owning view of a field's text within a record buffer. Views remain
+/// valid only until the buffer that produced them is modified.
+struct CSVFieldView
+{
+    const char* data = NULL;
+    size_t size = 0;
+
+    std::string str() const { return std::string(data, data + size); }
+};
+
+/// Streaming record-at-a-time CSV reader. In contrast to CSVParser, which
+/// materializes a string for every field of the whole input, the reader holds
+/// one record's text in an internal buffer and exposes its fields as views
+/// into that buffer, with no per-field allocation once the buffer is warm.
+/// Views are invalidated by the next call to nextRecord(). Quoted fields are
+/// unescaped in place and may span multiple lines; blank records are skipped.
+class CSVStreamReader
+{
+public:
+
+    ~CSVStreamReader();
+
+    bool open(const std::string& filepath);
+    void close();
+    bool isOpen() const { return m_file != NULL; }
+
+    /// Advance to the next record. Returns false at the end of input or on a
+    /// malformed record.
+    bool nextRecord();
+
+    size_t fieldCount() const { return m_views.size(); }
+    const CSVFieldView& fieldAt(size_t fi) const { return m_views[fi]; }
+
+private:
+
+    FILE* m_file = NULL;
+    std::vector<char> m_line;           // current record's raw text
+    std::vector<CSVFieldView> m_views;  // fields of the current record
+
+    bool readLine(bool append);
+};
+
+/// Parse a file of numeric records into a flat row-major value array. The
+/// file is read into one buffer and split at record boundaries into
+/// contiguous chunks parsed by separate threads, so well-formed numeric files
+/// (experience logs, motion primitive tables) skip the per-field string
+/// machinery entirely. An optional header record, detected by its first field
+/// failing to parse as a number, is skipped, and blank records are ignored.
+/// Returns false if the file cannot be read, any field fails to parse, or a
+/// record disagrees with the field count of the first record, which is
+/// returned in \p field_count.
+bool ParseNumericCSV(
+    const std::string& filepath,
+    std::vector<double>& values,
+    size_t& field_count,
+    int num_threads = 1);
+
 } // namespace smpl
 
 #endif
@@ -80,6 +80,9 @@ public:
 #endif
 };
 
+/// Install the global visualizer. While no visualizer is attached, all
+/// visualization locations are disabled and the SV_SHOW macros skip marker
+/// construction entirely.
 void set_visualizer(VisualizerBase* visualizer);
 void unset_visualizer();
 auto visualizer() -> VisualizerBase*;
@@ -94,6 +97,12 @@ void get_visualizations(VisualizationMap& visualizations);
 
 bool set_visualization_level(const std::string& name, Level level);
 
+/// Limit the rate of visualizations published through a channel and its
+/// non-overridden descendants to \p rate messages per second. Visualizations
+/// beyond the limit are dropped before their markers are constructed. A rate
+/// of 0 removes the limit.
+bool set_visualization_rate(const std::string& name, double rate);
+
 ///@}
 
 /// \name Internal
@@ -118,6 +127,11 @@ void InitializeVizLocation(
     VizLocation* loc,
     const std::string& name,
     Level level);
+
+// Return true if the location's channel rate limit admits a visualization
+// now, recording the hit. Called by the SV_SHOW macros after all other
+// enablement checks pass.
+bool CheckVizRate(VizLocation* loc);
 ///@}
 
 } // namespace viz
@@ -157,7 +171,8 @@ namespace viz = visual;
         InitializeVizLocation(&__sv_define_location__loc, name_, level_); \
     } \
     bool __sv_define_location__enabled = \
-            __sv_define_location__loc.enabled && (cond_)
+            __sv_define_location__loc.enabled && (cond_) && \
+            ::smpl::visual::CheckVizRate(&__sv_define_location__loc)
 
 #define SV_SHOW_COND(cond, level, name, markers) \
     do { \
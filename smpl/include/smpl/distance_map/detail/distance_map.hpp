@@ -38,6 +38,7 @@
 #include <cmath>
 #include <algorithm>
 #include <set>
+#include <thread>
 
 namespace smpl {
 
@@ -128,10 +129,16 @@ DistanceMap<Derived>::DistanceMap(
     m_neighbors(),
     m_indices(),
     m_neighbor_ranges(),
+    m_neighbor_face_ends(),
     m_neighbor_offsets(),
     m_neighbor_dirs(),
+    m_neighbor_dx(),
+    m_neighbor_dy(),
+    m_neighbor_dz(),
+    m_neighbor_off_len2(),
     m_open(),
-    m_rem_stack()
+    m_rem_stack(),
+    m_num_threads(1)
 {
     int cell_count_x = (int)(size_x * m_inv_res + 0.5) + 2;
     int cell_count_y = (int)(size_y * m_inv_res + 0.5) + 2;
@@ -146,7 +153,8 @@ DistanceMap<Derived>::DistanceMap(
     }
 
     // init neighbors for forward propagation
-    CreateNeighborUpdateList(m_neighbors, m_indices, m_neighbor_ranges);
+    CreateNeighborUpdateList(
+            m_neighbors, m_indices, m_neighbor_ranges, m_neighbor_face_ends);
 
     for (size_t i = 0; i < m_indices.size(); ++i) {
         auto& neighbor = m_neighbors[m_indices[i]];
@@ -155,6 +163,14 @@ DistanceMap<Derived>::DistanceMap(
         m_neighbor_offsets[i] += neighbor.y() * cell_count_z;
         m_neighbor_offsets[i] += neighbor.z() * 1;
 
+        m_neighbor_dx[i] = neighbor.x();
+        m_neighbor_dy[i] = neighbor.y();
+        m_neighbor_dz[i] = neighbor.z();
+        m_neighbor_off_len2[i] =
+                neighbor.x() * neighbor.x() +
+                neighbor.y() * neighbor.y() +
+                neighbor.z() * neighbor.z();
+
         if (i < NON_BORDER_NEIGHBOR_LIST_SIZE) {
             m_neighbor_dirs[i] = dirnum(neighbor.x(), neighbor.y(), neighbor.z());
         } else {
@@ -192,11 +208,17 @@ DistanceMap<Derived>::DistanceMap(const DistanceMap& o) :
     m_neighbors(o.m_neighbors),
     m_indices(o.m_indices),
     m_neighbor_ranges(o.m_neighbor_ranges),
+    m_neighbor_face_ends(o.m_neighbor_face_ends),
     m_neighbor_offsets(o.m_neighbor_offsets),
     m_neighbor_dirs(o.m_neighbor_dirs),
+    m_neighbor_dx(o.m_neighbor_dx),
+    m_neighbor_dy(o.m_neighbor_dy),
+    m_neighbor_dz(o.m_neighbor_dz),
+    m_neighbor_off_len2(o.m_neighbor_off_len2),
     m_sqrt_table(o.m_sqrt_table),
     m_open(o.m_open),
-    m_rem_stack(o.m_rem_stack)
+    m_rem_stack(o.m_rem_stack),
+    m_num_threads(o.m_num_threads)
 {
     rewire(o);
 }
@@ -213,11 +235,17 @@ DistanceMap<Derived>::DistanceMap(DistanceMap&& o) :
     m_neighbors(std::move(o.m_neighbors)),
     m_indices(std::move(o.m_indices)),
     m_neighbor_ranges(std::move(o.m_neighbor_ranges)),
+    m_neighbor_face_ends(std::move(o.m_neighbor_face_ends)),
     m_neighbor_offsets(std::move(o.m_neighbor_offsets)),
     m_neighbor_dirs(std::move(o.m_neighbor_dirs)),
+    m_neighbor_dx(std::move(o.m_neighbor_dx)),
+    m_neighbor_dy(std::move(o.m_neighbor_dy)),
+    m_neighbor_dz(std::move(o.m_neighbor_dz)),
+    m_neighbor_off_len2(std::move(o.m_neighbor_off_len2)),
     m_sqrt_table(std::move(o.m_sqrt_table)),
     m_open(std::move(o.m_open)),
-    m_rem_stack(std::move(o.m_rem_stack))
+    m_rem_stack(std::move(o.m_rem_stack)),
+    m_num_threads(o.m_num_threads)
 {
 }
 
@@ -235,11 +263,17 @@ auto DistanceMap<Derived>::operator=(const DistanceMap& rhs) -> DistanceMap&
         m_neighbors = rhs.m_neighbors;
         m_indices = rhs.m_indices;
         m_neighbor_ranges = rhs.m_neighbor_ranges;
+        m_neighbor_face_ends = rhs.m_neighbor_face_ends;
         m_neighbor_offsets = rhs.m_neighbor_offsets;
         m_neighbor_dirs = rhs.m_neighbor_dirs;
+        m_neighbor_dx = rhs.m_neighbor_dx;
+        m_neighbor_dy = rhs.m_neighbor_dy;
+        m_neighbor_dz = rhs.m_neighbor_dz;
+        m_neighbor_off_len2 = rhs.m_neighbor_off_len2;
         m_sqrt_table = rhs.m_sqrt_table;
         m_open = rhs.m_open;
         m_rem_stack = rhs.m_rem_stack;
+        m_num_threads = rhs.m_num_threads;
         rewire(rhs);
     }
     return *this;
@@ -259,15 +293,31 @@ auto DistanceMap<Derived>::operator=(DistanceMap&& rhs) -> DistanceMap&
         m_neighbors = std::move(rhs.m_neighbors);
         m_indices = std::move(rhs.m_indices);
         m_neighbor_ranges = std::move(rhs.m_neighbor_ranges);
+        m_neighbor_face_ends = std::move(rhs.m_neighbor_face_ends);
         m_neighbor_offsets = std::move(rhs.m_neighbor_offsets);
         m_neighbor_dirs = std::move(rhs.m_neighbor_dirs);
+        m_neighbor_dx = std::move(rhs.m_neighbor_dx);
+        m_neighbor_dy = std::move(rhs.m_neighbor_dy);
+        m_neighbor_dz = std::move(rhs.m_neighbor_dz);
+        m_neighbor_off_len2 = std::move(rhs.m_neighbor_off_len2);
         m_sqrt_table = std::move(rhs.m_sqrt_table);
         m_open = std::move(rhs.m_open);
         m_rem_stack = std::move(rhs.m_rem_stack);
+        m_num_threads = rhs.m_num_threads;
     }
     return *this;
 }
 
+/// Set the number of threads used to propagate distance updates. Values less
+/// than 2 select the serial propagation engine. The parallel engine is only
+/// engaged for large batches of obstacle insertions; removals and small
+/// batches retain the serial engine.
+template <typename Derived>
+void DistanceMap<Derived>::setPropagationThreadCount(int num_threads)
+{
+    m_num_threads = std::max(1, num_threads);
+}
+
 /// Return the distance value for an invalid cell.
 template <typename Derived>
 double DistanceMap<Derived>::maxDistance() const
@@ -492,6 +542,123 @@ double DistanceMap<Derived>::getCellDistance(int x, int y, int z) const
     return getDistance(x, y, z);
 }
 
+/// Append the coordinates of all cells within \p radius of their nearest
+/// obstacle cell as packed (x, y, z) triples. The radius is converted once to
+/// a threshold on the squared cell-distance index stored per cell, so the
+/// scan is a single integer comparison pass over the grid with no distance
+/// table lookups. Uninitialized cells carry the maximum distance index and
+/// compare correctly against the threshold.
+template <typename Derived>
+void DistanceMap<Derived>::getCellsWithinDistance(
+    double radius,
+    std::vector<int>& cells) const
+{
+    // index of the largest tabulated distance not exceeding the radius
+    auto it = std::upper_bound(m_sqrt_table.begin(), m_sqrt_table.end(), radius);
+    if (it == m_sqrt_table.begin()) {
+        return;
+    }
+    const int d_thresh = (int)std::distance(m_sqrt_table.begin(), it) - 1;
+
+    const int xlast = (int)m_cells.xsize() - 1;
+    const int ylast = (int)m_cells.ysize() - 1;
+    const int zlast = (int)m_cells.zsize() - 1;
+    for (int x = 1; x < xlast; ++x) {
+    for (int y = 1; y < ylast; ++y) {
+    for (int z = 1; z < zlast; ++z) {
+        if (m_cells(x, y, z).dist <= d_thresh) {
+            cells.push_back(x - 1);
+            cells.push_back(y - 1);
+            cells.push_back(z - 1);
+        }
+    }
+    }
+    }
+}
+
+/// Return the distances to the nearest obstacle cell for a batch of points.
+/// The coordinate conversion and cell fetch are inlined into one tight loop,
+/// avoiding the per-point virtual dispatch of repeated getMetricDistance()
+/// calls. When \p thresh is non-negative it is converted once to a squared
+/// cell-distance index and points beyond it report \p thresh without
+/// touching the distance table.
+template <typename Derived>
+void DistanceMap<Derived>::getMetricDistances(
+    const std::vector<Vector3>& points,
+    std::vector<double>& distances,
+    double thresh) const
+{
+    distances.resize(points.size());
+
+    int d_thresh = -1;
+    if (thresh >= 0.0) {
+        auto it = std::upper_bound(
+                m_sqrt_table.begin(), m_sqrt_table.end(), thresh);
+        d_thresh = (int)std::distance(m_sqrt_table.begin(), it) - 1;
+    }
+
+    const int xc = (int)m_cells.xsize() - 2;
+    const int yc = (int)m_cells.ysize() - 2;
+    const int zc = (int)m_cells.zsize() - 2;
+    const double ox = m_origin_x - m_res;
+    const double oy = m_origin_y - m_res;
+    const double oz = m_origin_z - m_res;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const int x = (int)(m_inv_res * (points[i].x() - ox) + 0.5) - 1;
+        const int y = (int)(m_inv_res * (points[i].y() - oy) + 0.5) - 1;
+        const int z = (int)(m_inv_res * (points[i].z() - oz) + 0.5) - 1;
+        if (x < 0 || x >= xc || y < 0 || y >= yc || z < 0 || z >= zc) {
+            distances[i] = 0.0;
+            continue;
+        }
+        const int d2 = m_cells(x + 1, y + 1, z + 1).dist;
+        if (d_thresh >= 0 && d2 > d_thresh) {
+            distances[i] = thresh;
+        } else {
+            distances[i] = m_sqrt_table[d2];
+        }
+    }
+}
+
+/// Return the distance of a cell from its nearest obstacle cell along with
+/// the gradient of the distance field, read from the nearest-obstacle pointer
+/// maintained during propagation, in one cell fetch. The gradient is the unit
+/// vector from the nearest obstacle cell toward the query cell, or zero for
+/// obstacle cells, cells outside the bounding volume, and cells beyond the
+/// propagation distance, where no nearest obstacle is recorded.
+template <typename Derived>
+double DistanceMap<Derived>::getCellDistanceGradient(
+    int x, int y, int z,
+    Vector3& gradient) const
+{
+    if (!isCellValid(x, y, z)) {
+        gradient = Vector3::Zero();
+        return 0.0;
+    }
+
+    const Cell& c = m_cells(x + 1, y + 1, z + 1);
+    if (c.obs == nullptr || c.obs == &c) {
+        gradient = Vector3::Zero();
+    } else {
+        gradient = Vector3(
+                (double)(c.x - c.obs->x),
+                (double)(c.y - c.obs->y),
+                (double)(c.z - c.obs->z));
+        gradient.normalize();
+    }
+    return m_sqrt_table[c.dist];
+}
+
+template <typename Derived>
+double DistanceMap<Derived>::getMetricDistanceGradient(
+    double x, double y, double z,
+    Vector3& gradient) const
+{
+    int gx, gy, gz;
+    worldToGrid(x, y, z, gx, gy, gz);
+    return getCellDistanceGradient(gx, gy, gz, gradient);
+}
+
 /// Return the point in world coordinates marking the center of the cell at the
 /// given effective grid coordinates.
 template <typename Derived>
@@ -613,22 +780,65 @@ int DistanceMap<Derived>::distance(const Cell& n, const Cell& s)
     return static_cast<Derived*>(this)->distance(n, s);
 }
 
+// Compute candidate distances for cell s's neighbors at offset indices
+// [nfirst, nlast), one output entry per neighbor. A derived class whose
+// distance function depends on the neighbor cell only through its offset from
+// s or from s's nearest obstacle may shadow this function with a vectorized
+// kernel over the unpacked offset component tables.
+template <typename Derived>
+void DistanceMap<Derived>::distances(
+    const Cell& s,
+    int nfirst,
+    int nlast,
+    int* out)
+{
+    for (int i = nfirst; i != nlast; ++i) {
+        const Cell* n = &s + m_neighbor_offsets[i];
+        out[i - nfirst] = distance(*n, s);
+    }
+}
+
 template <typename Derived>
 void DistanceMap<Derived>::lower(Cell* s)
 {
     int nfirst, nlast;
     std::tie(nfirst, nlast) = m_neighbor_ranges[s->dir];
-    for (int i = nfirst; i != nlast; ++i) {
+    const int nsplit = m_neighbor_face_ends[s->dir];
+
+    // fast pass over the face-adjacent prefix of the update list, which
+    // accounts for nearly all successful improvements
+    int dists[27];
+    static_cast<Derived*>(this)->distances(*s, nfirst, nsplit, dists);
+
+    for (int i = nfirst; i != nsplit; ++i) {
         Cell* n = s + m_neighbor_offsets[i];
-//        if (n->dist_new > s->dist_new)
-        {
-            int dp = distance(*n, *s);
-            if (dp < n->dist_new) {
-                n->dist_new = dp;
-                n->obs = s->obs;
-                n->dir = m_neighbor_dirs[i];
-                updateVertex(n);
-            }
+        int dp = dists[i - nfirst];
+        if (dp < n->dist_new) {
+            n->dist_new = dp;
+            n->obs = s->obs;
+            n->dir = m_neighbor_dirs[i];
+            updateVertex(n);
+        }
+    }
+
+    // Diagonal remainder. The pruned neighborhood of a directed update lies
+    // ahead of the wavefront, so by the bucket queue's monotone settlement no
+    // candidate can improve a neighbor already at or below the source
+    // distance; skip those without computing their candidates. Undirected
+    // updates (fresh obstacles and cells re-seeded by a raise wave) keep the
+    // full evaluation.
+    const bool directed = s->dir != NO_UPDATE_DIR;
+    for (int i = nsplit; i != nlast; ++i) {
+        Cell* n = s + m_neighbor_offsets[i];
+        if (directed && n->dist_new <= s->dist_new) {
+            continue;
+        }
+        int dp = distance(*n, *s);
+        if (dp < n->dist_new) {
+            n->dist_new = dp;
+            n->obs = s->obs;
+            n->dir = m_neighbor_dirs[i];
+            updateVertex(n);
         }
     }
 }
@@ -680,6 +890,19 @@ void DistanceMap<Derived>::waveout(Cell* n)
 template <typename Derived>
 void DistanceMap<Derived>::propagate()
 {
+    // Divert large monotone workloads to the parallel engine. Workloads with
+    // queued raise updates retain the serial engine, whose bucket ordering
+    // bounds the extent of each raise wave.
+    const size_t min_parallel_cell_count = 1024;
+    size_t queued;
+    if (m_num_threads > 1 &&
+        queuedLowersOnly(queued) &&
+        queued >= min_parallel_cell_count)
+    {
+        propagateParallel();
+        return;
+    }
+
     int iter_count = 0;
     while (m_bucket < (int)m_open.size()) {
         while (!m_open[m_bucket].empty()) {
@@ -713,6 +936,179 @@ void DistanceMap<Derived>::propagate()
     }
 }
 
+/// Test whether every queued update is a lowering update, i.e. no removals
+/// are pending, and count the queued cells. Only such workloads are eligible
+/// for parallel propagation.
+template <typename Derived>
+bool DistanceMap<Derived>::queuedLowersOnly(size_t& count) const
+{
+    count = 0;
+    for (int b = m_bucket; b < (int)m_open.size(); ++b) {
+        for (const Cell* s : m_open[b]) {
+            if (s->dist_new >= s->dist) {
+                return false;
+            }
+        }
+        count += m_open[b].size();
+    }
+    return true;
+}
+
+template <typename Derived>
+void DistanceMap<Derived>::tileUpdateVertex(PropagationTile& tile, Cell* o)
+{
+    const int key = std::min(o->dist, o->dist_new);
+    assert(key < (int)tile.open.size());
+    if (o->bucket >= 0) { // in this tile's queue
+        tile.open[o->bucket][o->pos] = tile.open[o->bucket].back();
+        tile.open[o->bucket][o->pos]->pos = o->pos;
+        tile.open[o->bucket].pop_back();
+    }
+    o->pos = tile.open[key].size();
+    tile.open[key].push_back(o);
+    o->bucket = key;
+    if (key < tile.bucket) {
+        tile.bucket = key;
+    }
+}
+
+/// Equivalent to lower(), except updates to cells outside the tile's slab are
+/// recorded in the tile's outbox rather than applied, so that a tile only
+/// ever writes to cells it owns.
+template <typename Derived>
+void DistanceMap<Derived>::lowerTiled(PropagationTile& tile, Cell* s)
+{
+    int nfirst, nlast;
+    std::tie(nfirst, nlast) = m_neighbor_ranges[s->dir];
+
+    int dists[27];
+    static_cast<Derived*>(this)->distances(*s, nfirst, nlast, dists);
+
+    for (int i = nfirst; i != nlast; ++i) {
+        Cell* n = s + m_neighbor_offsets[i];
+        if (n->x < tile.xfirst || n->x >= tile.xlast) {
+            tile.outbox.push_back(std::make_pair(s, i));
+            continue;
+        }
+
+        int dp = dists[i - nfirst];
+        if (dp < n->dist_new) {
+            n->dist_new = dp;
+            n->obs = s->obs;
+            n->dir = m_neighbor_dirs[i];
+            tileUpdateVertex(tile, n);
+        }
+    }
+}
+
+template <typename Derived>
+void DistanceMap<Derived>::propagateTile(PropagationTile& tile)
+{
+    while (tile.bucket < (int)tile.open.size()) {
+        while (!tile.open[tile.bucket].empty()) {
+            Cell* s = tile.open[tile.bucket].back();
+            tile.open[tile.bucket].pop_back();
+            s->bucket = -1;
+
+            // The parallel engine only runs when every queued update is a
+            // lowering update. Out-of-order processing across tiles may
+            // re-queue a cell, but only ever with a smaller dist_new, so the
+            // raise branch of the serial engine has no counterpart here.
+            if (s->dist_new < s->dist) {
+                s->dist = s->dist_new;
+                lowerTiled(tile, s);
+#if SMPL_DMAP_RETURN_CHANGED_CELLS
+                if (s->dist != s->dist_old) {
+                    s->dist_old = s->dist;
+                }
+#endif
+            }
+        }
+        ++tile.bucket;
+    }
+}
+
+/// Propagate queued lowering updates over slab tiles run on worker threads.
+/// Each tile runs the wavefront over the cells it owns; updates crossing a
+/// slab boundary are deferred to the owning tile and reconciled serially
+/// between rounds, which re-opens the affected tiles until no update crosses
+/// a boundary. Tiles settle cells out of global bucket order, so a cell may
+/// be re-expanded when a neighboring tile's wave arrives late; distances only
+/// ever decrease, so the engine converges to the same fixed point as the
+/// serial engine.
+template <typename Derived>
+void DistanceMap<Derived>::propagateParallel()
+{
+    const int xsize = (int)m_cells.xsize();
+    const int num_tiles = std::min(m_num_threads, xsize);
+
+    std::vector<PropagationTile> tiles(num_tiles);
+    for (auto& tile : tiles) {
+        tile.open.resize(m_open.size());
+        tile.bucket = (int)m_open.size();
+    }
+
+    // partition cells into equal slabs along the x axis
+    for (int x = 0; x < xsize; ++x) {
+        const int t = (int)((long)x * num_tiles / xsize);
+        if (x == 0 || t != (int)((long)(x - 1) * num_tiles / xsize)) {
+            tiles[t].xfirst = x;
+        }
+        tiles[t].xlast = x + 1;
+    }
+
+    auto owner = [&](const Cell* c) -> PropagationTile& {
+        return tiles[(long)c->x * num_tiles / xsize];
+    };
+
+    // move the queued cells into their owner tiles
+    for (int b = m_bucket; b < (int)m_open.size(); ++b) {
+        for (Cell* s : m_open[b]) {
+            s->bucket = -1;
+            tileUpdateVertex(owner(s), s);
+        }
+        m_open[b].clear();
+    }
+    m_bucket = (int)m_open.size();
+
+    for (;;) {
+        // run the wavefront within each tile
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_tiles; ++t) {
+            threads.emplace_back(
+                    &DistanceMap::propagateTile, this, std::ref(tiles[t]));
+        }
+        propagateTile(tiles[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // apply the updates that crossed slab boundaries, re-opening the
+        // owning tiles
+        bool reopened = false;
+        for (auto& tile : tiles) {
+            for (const auto& entry : tile.outbox) {
+                Cell* s = entry.first;
+                const int i = entry.second;
+                Cell* n = s + m_neighbor_offsets[i];
+                int dp = distance(*n, *s);
+                if (dp < n->dist_new) {
+                    n->dist_new = dp;
+                    n->obs = s->obs;
+                    n->dir = m_neighbor_dirs[i];
+                    tileUpdateVertex(owner(n), n);
+                    reopened = true;
+                }
+            }
+            tile.outbox.clear();
+        }
+
+        if (!reopened) {
+            return;
+        }
+    }
+}
+
 template <typename Derived>
 void DistanceMap<Derived>::lowerBounded(Cell* s)
 {
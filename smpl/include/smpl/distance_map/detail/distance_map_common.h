@@ -60,7 +60,8 @@ constexpr int dirnum(int dx, int dy, int dz, int edge = 0)
 void CreateNeighborUpdateList(
     std::array<Eigen::Vector3i, 27>& neighbors,
     std::array<int, NEIGHBOR_LIST_SIZE>& indices,
-    std::array<std::pair<int, int>, NUM_DIRECTIONS>& ranges);
+    std::array<std::pair<int, int>, NUM_DIRECTIONS>& ranges,
+    std::array<int, NUM_DIRECTIONS>& face_ends);
 
 struct Eigen_Vector3i_compare
 {
@@ -73,6 +73,8 @@ public:
     double getDistance(double x, double y, double z) const;
     double getDistance(int x, int y, int z) const;
 
+    void setPropagationThreadCount(int num_threads);
+
     /// \name Required Functions from DistanceMapInterface
     ///@{
     void addPointsToMap(const std::vector<Vector3>& points) override;
@@ -92,6 +94,22 @@ public:
     double getMetricDistance(double x, double y, double z) const override;
     double getCellDistance(int x, int y, int z) const override;
 
+    void getCellsWithinDistance(
+        double radius,
+        std::vector<int>& cells) const override;
+
+    void getMetricDistances(
+        const std::vector<Vector3>& points,
+        std::vector<double>& distances,
+        double thresh = -1.0) const override;
+
+    double getCellDistanceGradient(
+        int x, int y, int z,
+        Vector3& gradient) const override;
+    double getMetricDistanceGradient(
+        double x, double y, double z,
+        Vector3& gradient) const override;
+
     void gridToWorld(
         int x, int y, int z,
         double& world_x, double& world_y, double& world_z) const override;
@@ -155,6 +173,10 @@ private:
     // to which distance values must be propagated upon insertion
     std::array<std::pair<int, int>, NUM_DIRECTIONS> m_neighbor_ranges;
 
+    // One-past-the-end of the face-adjacent prefix of each neighbor range;
+    // see CreateNeighborUpdateList()
+    std::array<int, NUM_DIRECTIONS> m_neighbor_face_ends;
+
     // Map from a (source, target) update direction pair (obtained from
     // dirnum(x, y, z, e)) to a precomputed offsets into the grid for its target
     // neighbor offsets
@@ -164,6 +186,14 @@ private:
     // index
     std::array<int, NEIGHBOR_LIST_SIZE> m_neighbor_dirs;
 
+    // Map from a (source, target) update direction pair to the components of
+    // its target neighbor offset and their squared length, stored unpacked so
+    // that batched distance kernels may read them with vector loads
+    std::array<int, NEIGHBOR_LIST_SIZE> m_neighbor_dx;
+    std::array<int, NEIGHBOR_LIST_SIZE> m_neighbor_dy;
+    std::array<int, NEIGHBOR_LIST_SIZE> m_neighbor_dz;
+    std::array<int, NEIGHBOR_LIST_SIZE> m_neighbor_off_len2;
+
     std::vector<double> m_sqrt_table;
 
     typedef std::vector<Cell*> bucket_type;
@@ -172,6 +202,24 @@ private:
 
     std::vector<Cell*> m_rem_stack;
 
+    int m_num_threads;
+
+    // Transient per-thread state for parallel propagation. Each tile owns a
+    // slab of cells along the x axis and runs a wavefront over its own bucket
+    // queue; updates that cross a slab boundary are deferred to the owning
+    // tile through the outbox and reconciled between rounds.
+    struct PropagationTile
+    {
+        int xfirst; // first slab coordinate owned by this tile
+        int xlast;  // one past the last slab coordinate owned by this tile
+        bucket_list open;
+        int bucket;
+
+        // deferred updates to cells owned by other tiles, recorded as
+        // (source cell, neighbor index) pairs
+        std::vector<std::pair<Cell*, int>> outbox;
+    };
+
     void rewire(const DistanceMap& o);
 
     void initBorderCells();
@@ -179,12 +227,19 @@ private:
     void updateVertex(Cell* c);
 
     int distance(const Cell& n, const Cell& s);
+    void distances(const Cell& s, int nfirst, int nlast, int* out);
 
     void lower(Cell* s);
     void raise(Cell* s);
     void waveout(Cell* n);
     void propagate();
 
+    bool queuedLowersOnly(size_t& count) const;
+    void tileUpdateVertex(PropagationTile& tile, Cell* c);
+    void lowerTiled(PropagationTile& tile, Cell* s);
+    void propagateTile(PropagationTile& tile);
+    void propagateParallel();
+
     void lowerBounded(Cell* s);
     void propagateRemovals();
     void propagateBorder();
@@ -33,6 +33,7 @@
 #define SMPL_DISTANCE_MAP_INTERFACE_H
 
 // standard includes
+#include <algorithm>
 #include <vector>
 
 // system includes
@@ -88,6 +89,21 @@ public:
     virtual void reset() = 0;
     ///@}
 
+    /// \name Buffered Modifiers
+    ///@{
+    /// Buffer a set of obstacle additions or removals to be applied on the
+    /// next call to flushUpdates(). Implementations which can amortize
+    /// distance propagation over many buffered changes should override these
+    /// functions; the default implementations apply each change immediately.
+    virtual void bufferPointsToMap(const std::vector<Vector3>& points)
+    { addPointsToMap(points); }
+
+    virtual void bufferPointsFromMap(const std::vector<Vector3>& points)
+    { removePointsFromMap(points); }
+
+    virtual void flushUpdates() { }
+    ///@}
+
     /// \name Properties
     ///@{
     double originX() const { return m_origin_x; }
@@ -114,6 +130,94 @@ public:
 
     virtual double getCellSquaredDistance(int x, int y, int z) const
     { double d = getCellDistance(x, y, z); return d * d; }
+
+    /// Append the grid coordinates of every cell whose distance to the
+    /// nearest occupied cell is less than or equal to \p radius, as packed
+    /// (x, y, z) triples. Useful for consumers that inflate obstacles by a
+    /// fixed radius and want the swept volume in one pass rather than one
+    /// distance lookup per cell. The default implementation performs that
+    /// per-cell scan; implementations with direct access to per-cell
+    /// distance storage should override it with a single comparison pass.
+    virtual void getCellsWithinDistance(
+        double radius,
+        std::vector<int>& cells) const
+    {
+        const int xc = numCellsX();
+        const int yc = numCellsY();
+        const int zc = numCellsZ();
+        for (int x = 0; x < xc; ++x) {
+        for (int y = 0; y < yc; ++y) {
+        for (int z = 0; z < zc; ++z) {
+            if (getCellDistance(x, y, z) <= radius) {
+                cells.push_back(x);
+                cells.push_back(y);
+                cells.push_back(z);
+            }
+        }
+        }
+        }
+    }
+
+    /// Return the distances to the nearest occupied cell for a batch of
+    /// points, one output distance per input point. If \p thresh is
+    /// non-negative, the caller only needs distances up to \p thresh and
+    /// entries for points farther than that may be reported as \p thresh,
+    /// allowing implementations to skip exact distance reconstruction for
+    /// points known to be clear. The default implementation performs one
+    /// getMetricDistance() lookup per point and returns exact distances.
+    virtual void getMetricDistances(
+        const std::vector<Vector3>& points,
+        std::vector<double>& distances,
+        double thresh = -1.0) const
+    {
+        distances.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            distances[i] = getMetricDistance(
+                    points[i].x(), points[i].y(), points[i].z());
+        }
+    }
+    ///@}
+
+    /// \name Distance and Gradient Lookups
+    ///@{
+    /// Return the distance to the nearest occupied cell along with the
+    /// gradient of the distance field, a unit vector pointing away from the
+    /// nearest obstacle. The gradient is zero where it is undefined: within
+    /// obstacle cells and in regions beyond the propagation distance. The
+    /// default implementations estimate the gradient by central differences,
+    /// at the cost of six additional distance lookups; implementations that
+    /// record nearest-obstacle information per cell should override them with
+    /// a fused single-fetch query.
+    virtual double getCellDistanceGradient(
+        int x, int y, int z,
+        Vector3& gradient) const
+    {
+        const double d = getCellDistance(x, y, z);
+        const double dx =
+                getCellDistance(std::min(x + 1, numCellsX() - 1), y, z) -
+                getCellDistance(std::max(x - 1, 0), y, z);
+        const double dy =
+                getCellDistance(x, std::min(y + 1, numCellsY() - 1), z) -
+                getCellDistance(x, std::max(y - 1, 0), z);
+        const double dz =
+                getCellDistance(x, y, std::min(z + 1, numCellsZ() - 1)) -
+                getCellDistance(x, y, std::max(z - 1, 0));
+        gradient = Vector3(dx, dy, dz);
+        const double norm = gradient.norm();
+        if (norm > 0.0) {
+            gradient /= norm;
+        }
+        return d;
+    }
+
+    virtual double getMetricDistanceGradient(
+        double x, double y, double z,
+        Vector3& gradient) const
+    {
+        int gx, gy, gz;
+        worldToGrid(x, y, z, gx, gy, gz);
+        return getCellDistanceGradient(gx, gy, gz, gradient);
+    }
     ///@}
 
     /// \name Conversions Between Cell and Metric Coordinates
@@ -51,6 +51,7 @@ public:
 private:
 
     int distance(const Cell& n, const Cell& s);
+    void distances(const Cell& s, int nfirst, int nlast, int* out);
 };
 
 } // namespace smpl
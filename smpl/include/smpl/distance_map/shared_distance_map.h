@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_SHARED_DISTANCE_MAP_H
+#define SMPL_SHARED_DISTANCE_MAP_H
+
+// standard includes
+#include <cstdint>
+#include <string>
+
+// project includes
+#include <smpl/distance_map/distance_map_interface.h>
+
+namespace smpl {
+
+/// Publish the propagated distance values of a distance map into a named
+/// shared-memory segment, so that several planner processes working against
+/// the same static map may share one copy instead of each building and
+/// propagating its own. The segment stores one single-precision distance per
+/// cell alongside the map's metadata and a publication counter; consumers
+/// attach with SharedDistanceMap::open() and may wrap the result in an
+/// OccupancyGrid like any other distance map.
+///
+/// Republishing under the same name overwrites the segment in place and
+/// increments the publication counter. The counter is zeroed while a
+/// publication is in progress, so a consumer never attaches to a partially
+/// written segment, but distances read during an overlapping republication
+/// may mix old and new values; for non-static maps, republish while the
+/// consumers are quiescent, in the manner of the occupancy grid's
+/// double-buffered publication. The segment persists until
+/// UnlinkSharedDistanceMap() removes its name.
+///
+/// Only available on Linux; on other platforms publication fails.
+bool PublishDistanceMap(
+    const DistanceMapInterface& map,
+    const std::string& name);
+
+/// Remove a published segment's name. Existing mappings remain valid until
+/// the last consumer closes.
+bool UnlinkSharedDistanceMap(const std::string& name);
+
+/// A read-only distance map backed by a segment published by
+/// PublishDistanceMap(). Distance lookups read the shared cell array in
+/// place; the modifier interface is unsupported and reports an error, since
+/// consumers do not own the map.
+class SharedDistanceMap : public DistanceMapInterface
+{
+public:
+
+    SharedDistanceMap();
+    ~SharedDistanceMap();
+
+    SharedDistanceMap(const SharedDistanceMap&) = delete;
+    SharedDistanceMap& operator=(const SharedDistanceMap&) = delete;
+
+    /// Attach to a published segment. Returns false if the segment does not
+    /// exist, is malformed, or has no completed publication.
+    bool open(const std::string& name);
+    void close();
+
+    bool isOpen() const { return m_distances != NULL; }
+
+    /// The publication counter of the attached segment, read live; zero
+    /// while detached. Consumers may poll this between episodes to detect
+    /// republications.
+    std::uint64_t version() const;
+
+    /// \name Required Functions from DistanceMapInterface
+    ///@{
+    DistanceMapInterface* clone() const override;
+
+    void addPointsToMap(const std::vector<Vector3>& points) override;
+    void removePointsFromMap(const std::vector<Vector3>& points) override;
+    void updatePointsInMap(
+        const std::vector<Vector3>& old_points,
+        const std::vector<Vector3>& new_points) override;
+    void reset() override;
+
+    int numCellsX() const override { return m_cell_count_x; }
+    int numCellsY() const override { return m_cell_count_y; }
+    int numCellsZ() const override { return m_cell_count_z; }
+
+    double getUninitializedDistance() const override { return m_max_dist; }
+
+    double getMetricDistance(double x, double y, double z) const override;
+    double getCellDistance(int x, int y, int z) const override;
+
+    void gridToWorld(
+        int x, int y, int z,
+        double& world_x, double& world_y, double& world_z) const override;
+
+    void worldToGrid(
+        double world_x, double world_y, double world_z,
+        int& x, int& y, int& z) const override;
+
+    bool isCellValid(int x, int y, int z) const override;
+    ///@}
+
+private:
+
+    std::string m_name;
+
+    void* m_addr = NULL;
+    std::size_t m_map_size = 0;
+
+    const float* m_distances = NULL;
+
+    int m_cell_count_x = 0;
+    int m_cell_count_y = 0;
+    int m_cell_count_z = 0;
+
+    double m_max_dist = 0.0;
+    double m_inv_res = 0.0;
+};
+
+} // namespace smpl
+
+#endif
@@ -89,6 +89,10 @@ public:
     double getDistance(double x, double y, double z) const;
     double getDistance(int x, int y, int z) const;
 
+    void getCellDistances(
+        const std::vector<Eigen::Vector3i>& cells,
+        std::vector<double>& distances) const;
+
     bool isCellValid(const Eigen::Vector3i& gp) const;
 
     /// \name Required Functions from DistanceMapInterface
@@ -103,6 +107,10 @@ public:
 
     void reset() override;
 
+    void bufferPointsToMap(const std::vector<Vector3>& points) override;
+    void bufferPointsFromMap(const std::vector<Vector3>& points) override;
+    void flushUpdates() override;
+
     int numCellsX() const override;
     int numCellsY() const override;
     int numCellsZ() const override;
@@ -167,6 +175,10 @@ public:
     // to which distance values must be propagated upon insertion
     std::array<std::pair<int, int>, NUM_DIRECTIONS> m_neighbor_ranges;
 
+    // One-past-the-end of the face-adjacent prefix of each neighbor range;
+    // see CreateNeighborUpdateList()
+    std::array<int, NUM_DIRECTIONS> m_neighbor_face_ends;
+
     // Map from a (source, target) update direction pair to the update direction
     // index
     std::array<int, NEIGHBOR_LIST_SIZE> m_neighbor_dirs;
@@ -200,8 +212,35 @@ public:
     };
     std::vector<GridCoord> m_rem_stack;
 
+    // cells buffered by bufferPointsToMap()/bufferPointsFromMap(), applied in
+    // a single combined propagation pass by flushUpdates()
+    std::vector<GridCoord> m_pending_additions;
+    std::vector<GridCoord> m_pending_removals;
+
     double m_error;
 
+    // Most recently resolved tree leaves, consulted before descending the
+    // tree on each cell distance query. Successive queries from sphere-model
+    // collision checking are strongly spatially clustered, so they usually
+    // resolve to a leaf already in the cache. Note the cache keeps distance
+    // queries logically const, but mutating it makes them unsafe to call
+    // concurrently on the same instance.
+    struct LeafCacheEntry
+    {
+        int xfirst, yfirst, zfirst; // first cell covered by the leaf
+        int xlast, ylast, zlast;    // one past the last cell covered
+        int dist;                   // squared cell distance over the leaf
+    };
+    static const int LeafCacheSize = 8;
+    mutable std::array<LeafCacheEntry, LeafCacheSize> m_leaf_cache;
+    mutable int m_leaf_cache_count;
+    mutable int m_leaf_cache_next;
+
+    void invalidateLeafCache();
+    int leafCellDistance(int x, int y, int z) const;
+
+    void sortCellsByMortonCode(std::vector<GridCoord>& cells) const;
+
     void updateVertex(Cell* c, int cx, int cy, int cz);
 
     /// DistanceMap
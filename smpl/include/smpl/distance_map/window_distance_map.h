@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_WINDOW_DISTANCE_MAP_H
+#define SMPL_WINDOW_DISTANCE_MAP_H
+
+// standard includes
+#include <memory>
+
+// project includes
+#include <smpl/distance_map/distance_map_interface.h>
+
+namespace smpl {
+
+/// A view of an axis-aligned sub-volume of a parent distance map, with grid
+/// coordinates translated so that the window's minimum corner is cell
+/// (0, 0, 0). No cell data is copied; every lookup reads the parent map in
+/// place. Consumers sized by the map extents -- the bfs heuristics in
+/// particular -- then allocate and propagate over the window volume rather
+/// than the full facility map, while distances remain those of the parent
+/// and so account for obstacles outside the window.
+///
+/// The requested bounds are snapped outward to the parent's cell grid and
+/// clamped to its extents. Point modifiers forward to the parent, in the
+/// shared world frame, so every window over a parent observes its updates;
+/// reset() is unsupported, since a window cannot reset a sub-volume of the
+/// parent's data.
+class WindowDistanceMap : public DistanceMapInterface
+{
+public:
+
+    /// Construct a window over \p parent spanning the axis-aligned box with
+    /// minimum corner (\p origin_x, \p origin_y, \p origin_z) and dimensions
+    /// (\p size_x, \p size_y, \p size_z), in world coordinates.
+    WindowDistanceMap(
+        const std::shared_ptr<DistanceMapInterface>& parent,
+        double origin_x, double origin_y, double origin_z,
+        double size_x, double size_y, double size_z);
+
+    auto parent() const -> const std::shared_ptr<DistanceMapInterface>&
+    { return m_parent; }
+
+    /// \name Required Functions from DistanceMapInterface
+    ///@{
+    DistanceMapInterface* clone() const override;
+
+    void addPointsToMap(const std::vector<Vector3>& points) override;
+    void removePointsFromMap(const std::vector<Vector3>& points) override;
+    void updatePointsInMap(
+        const std::vector<Vector3>& old_points,
+        const std::vector<Vector3>& new_points) override;
+    void reset() override;
+
+    int numCellsX() const override { return m_cell_count_x; }
+    int numCellsY() const override { return m_cell_count_y; }
+    int numCellsZ() const override { return m_cell_count_z; }
+
+    double getUninitializedDistance() const override
+    { return m_parent->getUninitializedDistance(); }
+
+    double getMetricDistance(double x, double y, double z) const override;
+    double getCellDistance(int x, int y, int z) const override;
+
+    void gridToWorld(
+        int x, int y, int z,
+        double& world_x, double& world_y, double& world_z) const override;
+
+    void worldToGrid(
+        double world_x, double world_y, double world_z,
+        int& x, int& y, int& z) const override;
+
+    bool isCellValid(int x, int y, int z) const override;
+    ///@}
+
+    /// \name Forwarded Buffered Modifiers and Batched Lookups
+    ///@{
+    void bufferPointsToMap(const std::vector<Vector3>& points) override;
+    void bufferPointsFromMap(const std::vector<Vector3>& points) override;
+    void flushUpdates() override;
+
+    void getMetricDistances(
+        const std::vector<Vector3>& points,
+        std::vector<double>& distances,
+        double thresh = -1.0) const override;
+
+    double getCellDistanceGradient(
+        int x, int y, int z,
+        Vector3& gradient) const override;
+    ///@}
+
+private:
+
+    std::shared_ptr<DistanceMapInterface> m_parent;
+
+    // grid coordinates, in the parent map, of the window's minimum corner
+    int m_offset_x;
+    int m_offset_y;
+    int m_offset_z;
+
+    int m_cell_count_x;
+    int m_cell_count_y;
+    int m_cell_count_z;
+};
+
+} // namespace smpl
+
+#endif
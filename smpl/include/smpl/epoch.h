@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_EPOCH_H
+#define SMPL_EPOCH_H
+
+// standard includes
+#include <cstdint>
+#include <cstdlib>
+
+namespace smpl {
+
+/// A monotonically increasing version counter published by objects whose
+/// mutations invalidate derived caches. Sources begin at 1 and bump their
+/// epoch on every mutation; 0 is reserved to mark cache entries that have
+/// never been stamped, so a default-constructed entry never reads as current.
+typedef std::uint64_t Epoch;
+
+/// Header embedded in cache entries derived from \p N epoch sources. An
+/// entry is stamped with the source epochs it was computed against and is
+/// current only while every source still reports the same epoch, so a cached
+/// value is coherently discarded when any of its inputs changes.
+template <size_t N>
+struct CacheEntryHeader
+{
+    Epoch epochs[N];
+
+    CacheEntryHeader() {
+        for (size_t i = 0; i < N; ++i) {
+            epochs[i] = 0;
+        }
+    }
+
+    template <typename... Epochs>
+    bool current(Epochs... es) const {
+        static_assert(sizeof...(Epochs) == N, "one epoch per source required");
+        const Epoch in[N] = { (Epoch)es... };
+        for (size_t i = 0; i < N; ++i) {
+            if (epochs[i] != in[i]) {
+                return false;
+            }
+        }
+        return epochs[0] != 0;
+    }
+
+    template <typename... Epochs>
+    void stamp(Epochs... es) {
+        static_assert(sizeof...(Epochs) == N, "one epoch per source required");
+        const Epoch in[N] = { (Epoch)es... };
+        for (size_t i = 0; i < N; ++i) {
+            epochs[i] = in[i];
+        }
+    }
+};
+
+} // namespace smpl
+
+#endif
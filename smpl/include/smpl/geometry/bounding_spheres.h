@@ -85,6 +85,13 @@ void ComputeMeshBoundingSpheres(
     std::vector<Vector3>& centers,
     std::vector<std::uint32_t>& triangle_indices);
 
+double ComputeMeshBoundingSpheres(
+    const std::vector<Vector3>& vertices,
+    const std::vector<std::uint32_t>& indices,
+    double radius,
+    size_t max_spheres,
+    std::vector<Vector3>& centers);
+
 } // namespace geometry
 } // namespace smpl
 
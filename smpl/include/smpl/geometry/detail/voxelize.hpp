@@ -136,12 +136,19 @@ void VoxelizeTriangle(
 
         const WorldCoord wc = vg.gridToWorld(gc);
 
-        // TODO: shortcut based off of distance to triangle plane?
-
         // check if the voxel point is in the plane of the triangle and
         // within the edges
         const Vector3 voxel_p(wc.x, wc.y, wc.z);
 
+        // every fill condition below implies the voxel center lies within
+        // the voxel circumradius of the triangle plane; cull against the
+        // plane with a single dot product before the vertex, edge, and face
+        // tests
+        const double dplane = n.dot(voxel_p) + d;
+        if (dplane > rc || dplane < -rc) {
+            continue;
+        }
+
         Vector3 dx1 = voxel_p - p1;
         Vector3 dx2 = voxel_p - p2;
         Vector3 dx3 = voxel_p - p3;
@@ -114,6 +114,11 @@ public:
     const Vector3& size() const { return m_size; }
     const Vector3& res() const { return m_res; }
 
+    /// Direct access to the underlying cell storage, laid out with z the
+    /// fastest-varying dimension so that each (x, y) column is contiguous.
+    value_type* data() { return m_grid.data(); }
+    const value_type* data() const { return m_grid.data(); }
+
 protected:
 
     Vector3 m_min;
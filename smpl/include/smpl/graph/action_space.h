@@ -60,12 +60,49 @@ public:
     /// CollisionChecker's isStateToStateValid function during a search.
     virtual bool apply(const RobotState& parent, std::vector<Action>& actions) = 0;
 
+    /// \brief Return the set of actions which may arrive at a state.
+    ///
+    /// The returned actions mirror those returned by apply(): each is a
+    /// sequence of waypoints rooted at \p child whose final waypoint is a
+    /// candidate predecessor state. The default implementation reports that
+    /// inverse application is unsupported.
+    virtual bool applyInverse(const RobotState& child, std::vector<Action>& actions)
+    { return false; }
+
+    /// \brief Return the set of actions available from a state, reusing
+    /// storage owned by the action space.
+    ///
+    /// Equivalent to apply(), but writes the actions into a buffer owned by
+    /// the action space and retires them into a pool when the next query
+    /// arrives. Implementations of apply() may repopulate actions drawn from
+    /// the pool via recycledAction(), in which case repeated queries reuse the
+    /// waypoint storage acquired by earlier ones rather than allocating fresh
+    /// vectors on every expansion. The returned actions are valid until the
+    /// next call to applyReusable() on this action space.
+    auto applyReusable(const RobotState& parent) -> const std::vector<Action>*;
+
     virtual void updateStart(const RobotState& state) { }
     virtual void updateGoal(const GoalConstraint& goal) { }
 
+protected:
+
+    /// \brief Return an action whose storage is recycled from a previous
+    /// query, when available.
+    ///
+    /// The returned action may still contain the waypoints of a retired
+    /// action. It must be overwritten by assignment, which reuses both the
+    /// waypoint array and the capacity of each waypoint, rather than cleared
+    /// and appended to.
+    Action recycledAction();
+
 private:
 
     RobotPlanningSpace* m_space = nullptr;
+
+    // reusable storage for applyReusable(); actions from the previous query
+    // are retired to the pool and handed back out through recycledAction()
+    std::vector<Action> m_action_buf;
+    std::vector<Action> m_action_pool;
 };
 
 } // namespace smpl
@@ -42,7 +42,7 @@
 #include <smpl/graph/adaptive_graph_extension.h>
 #include <smpl/graph/motion_primitive.h>
 #include <smpl/graph/workspace_lattice_base.h>
-#include <smpl/grid/grid.h>
+#include <smpl/grid/sparse_grid.h>
 #include <smpl/occupancy_grid.h>
 #include <smpl/time.h>
 #include <smpl/types.h>
@@ -77,6 +77,17 @@ struct AdaptiveWorkspaceState : public AdaptiveState
 {
     RobotState state;
     WorkspaceCoord coord;
+
+    // 3-d projection of the coord, computed once at creation: the workspace
+    // position and the occupancy grid cell containing it. projectToPoint and
+    // the region/tunnel updates reread these instead of reconverting the
+    // coord every planner iteration
+    double px;
+    double py;
+    double pz;
+    int gx;
+    int gy;
+    int gz;
 };
 
 std::ostream& operator<<(std::ostream& o, const AdaptiveWorkspaceState& s);
@@ -225,8 +236,22 @@ private:
         bool trak_hd;
 
         AdaptiveGridCell() : grow_count(0), plan_hd(false), trak_hd(false) { }
+
+        bool operator==(const AdaptiveGridCell& o) const {
+            return grow_count == o.grow_count &&
+                    plan_hd == o.plan_hd &&
+                    trak_hd == o.trak_hd;
+        }
     };
-    Grid3<AdaptiveGridCell> m_dim_grid;
+
+    // High-dimensional region labels, stored sparsely since regions cover a
+    // small fraction of the workspace; low-dimensional space compresses to a
+    // handful of octree nodes
+    SparseGrid<AdaptiveGridCell> m_dim_grid;
+
+    // cells marked by the last tunnel, so the next tunnel clears only those
+    // rather than sweeping the grid
+    std::vector<Eigen::Vector3i> m_tunnel_cells;
 
     bool initMotionPrimitives();
 
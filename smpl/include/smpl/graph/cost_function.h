@@ -32,18 +32,48 @@
 #ifndef SMPL_COST_FUNCTION_H
 #define SMPL_COST_FUNCTION_H
 
+// project includes
+#include <smpl/types.h>
+
 namespace smpl {
 
+/// Interface for custom action cost functions over joint-space transitions.
+///
+/// Costs are integer fixed-point: a cost of FixedPointRatio units corresponds
+/// to a real-valued cost of 1.0. Keeping edge costs as small integers
+/// preserves exact accumulation along paths and lets searches key their open
+/// lists on integer values.
 class CostFunction
 {
 public:
 
-    CostFunction();
+    /// The number of integer cost units per unit of real-valued cost.
+    static const int FixedPointRatio = 1000;
+
     virtual ~CostFunction() { }
 
-    virtual int getCost(const RobotState& state, const RobotState& state) const = 0;
+    /// Return the fixed-point cost of the transition between two states.
+    virtual int getCost(const RobotState& from, const RobotState& to) const = 0;
+};
+
+inline int ToFixedPoint(double cost)
+{
+    return (int)(CostFunction::FixedPointRatio * cost + 0.5);
+}
+
+inline double FromFixedPoint(int cost)
+{
+    return (double)cost / CostFunction::FixedPointRatio;
+}
+
+/// Cost function assigning a uniform unit cost to every transition.
+class UniformCostFunction : public CostFunction
+{
+public:
 
-private:
+    int getCost(const RobotState& from, const RobotState& to) const override {
+        return FixedPointRatio;
+    }
 };
 
 } // namespace smpl
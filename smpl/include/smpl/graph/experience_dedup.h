@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_EXPERIENCE_DEDUP_H
+#define SMPL_EXPERIENCE_DEDUP_H
+
+// standard includes
+#include <vector>
+
+// project includes
+#include <smpl/types.h>
+#include <smpl/graph/experience_graph.h>
+#include <smpl/graph/experience_graph_index.h>
+
+namespace smpl {
+
+/// Policy thresholds for rejecting candidate paths that near-duplicate
+/// experience already in the graph. A candidate is a duplicate of a reference
+/// path when either similarity kernel falls under its threshold.
+struct PathDedupParams
+{
+    /// Mean per-step dynamic time warping cost, measured by euclidean
+    /// distance over the joint variables, below which a candidate duplicates
+    /// a reference path.
+    double dtw_threshold = 0.1;
+
+    /// Discrete frechet distance below which a candidate duplicates a
+    /// reference path.
+    double frechet_threshold = 0.1;
+
+    /// Radius of the spatial prefilter. A similarity kernel only runs
+    /// against a reference path when at least min_overlap of the candidate
+    /// waypoints have one of the path's nodes within this radius.
+    double prune_radius = 0.25;
+
+    /// Fraction of candidate waypoints that must pass the radius prefilter
+    /// before a kernel runs.
+    double min_overlap = 0.9;
+
+    /// Threads for the batch filter; 0 uses the hardware concurrency.
+    int num_threads = 0;
+};
+
+/// The demonstrated paths of an experience graph, flattened for the
+/// similarity kernels: each path is the concatenation of its waypoints, dof
+/// variables per waypoint, with edge waypoints spliced between the node
+/// states they connect.
+struct ExperiencePathSet
+{
+    int dof = 0;
+    std::vector<std::vector<double>> paths;
+
+    /// The path containing each graph node, by node id. Junction nodes
+    /// shared by several paths record only one of them; the prefilter is
+    /// approximate there and the kernels decide.
+    std::vector<int> node_to_path;
+};
+
+/// Decompose an experience graph into its demonstrated paths by walking
+/// maximal degree-2 chains between endpoints and junctions.
+void ExtractExperiencePaths(
+    const ExperienceGraph& eg,
+    ExperiencePathSet* paths);
+
+/// \name Similarity Kernels
+///@{
+
+/// Total dynamic time warping cost between two flattened paths of n and m
+/// waypoints with dof variables each. Divide by (n + m) for the mean
+/// per-step cost the threshold policy uses.
+double DynamicTimeWarpingCost(
+    const double* a, int n,
+    const double* b, int m,
+    int dof);
+
+/// Discrete frechet distance between two flattened paths.
+double DiscreteFrechetDistance(
+    const double* a, int n,
+    const double* b, int m,
+    int dof);
+
+double DynamicTimeWarpingCost(
+    const std::vector<RobotState>& a,
+    const std::vector<RobotState>& b);
+
+double DiscreteFrechetDistance(
+    const std::vector<RobotState>& a,
+    const std::vector<RobotState>& b);
+
+///@}
+
+/// Test whether a candidate path near-duplicates any path in the set. The
+/// index, when given, restricts the kernels to reference paths the candidate
+/// overlaps spatially; without it every reference path is tested. Reports
+/// the duplicated path through duplicate_of when non-NULL.
+bool IsDuplicatePath(
+    const std::vector<RobotState>& candidate,
+    const ExperiencePathSet& paths,
+    ExperienceGraphIndex* index,
+    const PathDedupParams& params,
+    int* duplicate_of = NULL);
+
+/// Remove the candidates that duplicate experience already in the graph or
+/// an earlier surviving candidate, preserving order. Candidates are tested
+/// against the graph's paths in parallel, then survivors are deduplicated
+/// against each other in submission order.
+void FilterExperiencePaths(
+    std::vector<std::vector<RobotState>>* candidates,
+    const ExperienceGraph& eg,
+    ExperienceGraphIndex* index,
+    const PathDedupParams& params);
+
+/// Remove the paths of an experience graph dominated by cheaper experience:
+/// a path is dominated when a surviving path of no greater joint-space
+/// length near-duplicates it under the similarity kernels. The dominated
+/// paths' edges are erased along with the nodes that isolates, renumbering
+/// the surviving ids compactly. The index, when given, prefilters the kernel
+/// pairs and is re-attached to the compacted graph before returning. Returns
+/// the number of paths removed.
+int CompactExperienceGraph(
+    ExperienceGraph* eg,
+    ExperienceGraphIndex* index,
+    const PathDedupParams& params);
+
+} // namespace smpl
+
+#endif
@@ -153,6 +153,14 @@ struct ExperienceGraph
     std::vector<Node> m_nodes;
     std::vector<Edge> m_edges;
 
+    // compressed-sparse-row copy of the per-node adjacency lists, rebuilt by
+    // rebuild_adjacency() and invalidated by any mutation; row i spans
+    // [m_csr_offsets[i], m_csr_offsets[i + 1]) of m_csr_adjacency, so sweeps
+    // over many adjacency lists stream one contiguous array instead of
+    // chasing one heap-allocated list per node
+    std::vector<degree_size_type> m_csr_offsets;
+    Node::adjacent_edge_container m_csr_adjacency;
+
     // cached storage for mapping edge ids to their id adjustments during node
     // removal
     std::vector<std::ptrdiff_t> m_shift;
@@ -172,9 +180,13 @@ struct ExperienceGraph
     auto num_nodes() const -> nodes_size_type { return m_nodes.size(); }
     auto num_edges() const -> edges_size_type { return m_edges.size(); }
 
+    /// Return the approximate number of bytes held by the graph.
+    auto mem_usage() const -> size_t;
+
     bool edge(node_id uid, node_id vid) const;
 
     auto insert_node(const RobotState& state) -> node_id;
+    auto insert_nodes(const std::vector<RobotState>& states) -> node_id;
     void erase_node(node_id id);
 
     auto insert_edge(node_id uid, node_id vid) -> edge_id;
@@ -183,6 +195,9 @@ struct ExperienceGraph
         node_id vid,
         const std::vector<RobotState>& path)
         -> edge_id;
+    void insert_edges(const std::vector<std::pair<node_id, node_id>>& edges);
+
+    void rebuild_adjacency();
 
     void erase_edge(node_id uid, node_id vid);
     void erase_edge(edge_id id);
@@ -54,6 +54,28 @@ public:
 
     virtual bool snap(int first_id, int second_id, int& cost) = 0;
 
+    /// Evaluate the snap motions from \p first_id to each state in \p
+    /// second_ids. Costs are returned in the order of \p second_ids; a
+    /// negative cost marks an invalid snap. The default implementation
+    /// evaluates each snap in turn; graphs whose snap evaluations reduce to
+    /// independent validity checks may override this to evaluate them
+    /// together.
+    virtual void snap(
+        int first_id,
+        const std::vector<int>& second_ids,
+        std::vector<int>& costs)
+    {
+        costs.resize(second_ids.size());
+        for (size_t i = 0; i < second_ids.size(); ++i) {
+            int cost;
+            if (snap(first_id, second_ids[i], cost)) {
+                costs[i] = cost;
+            } else {
+                costs[i] = -1;
+            }
+        }
+    }
+
     virtual const ExperienceGraph* getExperienceGraph() const = 0;
     virtual ExperienceGraph* getExperienceGraph() = 0;
 
@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_EXPERIENCE_GRAPH_INDEX_H
+#define SMPL_EXPERIENCE_GRAPH_INDEX_H
+
+// standard includes
+#include <cstdint>
+#include <vector>
+
+// project includes
+#include <smpl/spatial.h>
+#include <smpl/types.h>
+#include <smpl/graph/experience_graph.h>
+
+namespace smpl {
+
+/// Spatial index over the node states of an ExperienceGraph, replacing linear
+/// scans over all nodes during heuristic setup and snap-candidate enumeration.
+///
+/// Two structures are maintained:
+///
+/// * a k-d tree over node states, ordered by unweighted euclidean distance
+///   over the raw joint variables (the same metric as JointDistHeuristic),
+///   answering radius and k-nearest-neighbor queries
+///
+/// * a uniform grid over caller-provided 3-d projections of node states
+///   (e.g. the end effector positions computed by a projection heuristic),
+///   answering radius queries over the projected points
+///
+/// The k-d tree is rebuilt lazily: queries compare the number of indexed
+/// nodes against the attached graph and rebuild when nodes have been
+/// appended. Node removal is not tracked; callers that erase nodes must
+/// attach() again to force a rebuild. The point grid is filled incrementally
+/// through setNodePoint() as the caller computes projections.
+class ExperienceGraphIndex
+{
+public:
+
+    using node_id = ExperienceGraph::node_id;
+
+    /// Attach the index to a graph, dropping any previously indexed nodes.
+    /// The graph must outlive the index.
+    void attach(const ExperienceGraph* eg);
+
+    auto graph() const -> const ExperienceGraph* { return m_eg; }
+
+    /// \name Joint-Space Queries
+    ///@{
+
+    /// Gather all nodes whose states lie within \p radius of \p state,
+    /// measured by euclidean distance over the joint variables.
+    void nodesInRadius(
+        const RobotState& state,
+        double radius,
+        std::vector<node_id>& nodes);
+
+    /// Gather the (at most) \p k nodes nearest to \p state, ordered
+    /// nearest-first.
+    void kNearestNodes(
+        const RobotState& state,
+        int k,
+        std::vector<node_id>& nodes);
+
+    ///@}
+
+    /// \name Projected-Point Queries
+    ///@{
+
+    /// Set the cell size of the projected-point grid. Clears any previously
+    /// recorded projections. The cell size should be on the order of the
+    /// radii later queried for.
+    void setPointCellSize(double size);
+
+    /// Record the 3-d projection of a node's state, inserting it into the
+    /// point grid.
+    void setNodePoint(node_id id, const Vector3& point);
+
+    /// Gather all nodes whose recorded projections lie within \p radius of
+    /// \p point. Nodes without a recorded projection are never returned.
+    void nodesInRadius(
+        const Vector3& point,
+        double radius,
+        std::vector<node_id>& nodes);
+
+    ///@}
+
+private:
+
+    struct TreeNode
+    {
+        node_id node;       // the graph node stored at this tree node
+        int left;           // index of the left subtree or -1
+        int right;          // index of the right subtree or -1
+        int dim;            // joint variable this tree node splits on
+    };
+
+    const ExperienceGraph* m_eg = nullptr;
+
+    // balanced k-d tree over the first m_indexed_nodes nodes of the graph;
+    // m_tree[0] is the root when non-empty
+    std::vector<TreeNode> m_tree;
+    ExperienceGraph::nodes_size_type m_indexed_nodes = 0;
+
+    // projected-point grid: node ids bucketed by the cell containing their
+    // recorded projection
+    hash_map<uint64_t, std::vector<node_id>> m_point_cells;
+    std::vector<Vector3> m_points;          // recorded projections by node id
+    std::vector<bool> m_point_known;
+    double m_point_cell_size = 0.1;
+
+    void rebuildIfStale();
+    int buildTree(node_id* ids, size_t count, int dim);
+
+    void searchRadius(
+        int n,
+        const RobotState& q,
+        double radius_sq,
+        std::vector<node_id>& nodes) const;
+
+    void searchNearest(
+        int n,
+        const RobotState& q,
+        int k,
+        std::vector<std::pair<double, node_id>>& best) const;
+};
+
+} // namespace smpl
+
+#endif
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_EXPERIENCE_GRAPH_IO_H
+#define SMPL_EXPERIENCE_GRAPH_IO_H
+
+// standard includes
+#include <string>
+
+// project includes
+#include <smpl/graph/experience_graph.h>
+
+namespace smpl {
+
+/// \name Binary Experience Graph Format
+///
+/// A binary serialization of ExperienceGraph with a fixed header followed by
+/// contiguous node and edge arrays:
+///
+///     char     magic[8];          // "SMPLEGPH"
+///     uint32_t version;           // currently 1
+///     uint32_t num_variables;     // variables per robot state
+///     uint64_t num_nodes;
+///     uint64_t num_edges;
+///     double   node_states[num_nodes * num_variables];
+///     struct {
+///         uint64_t snode;
+///         uint64_t tnode;
+///         uint64_t num_waypoints;
+///         double   waypoints[num_waypoints * num_variables];
+///     } edges[num_edges];
+///
+/// All fields are stored in host byte order. The reader memory-maps the file
+/// and copies node and edge data directly out of the mapping, avoiding the
+/// text parse and intermediate buffering of the CSV demonstration format.
+///@{
+
+/// Write an experience graph to a file in the binary format. Returns false if
+/// the file cannot be written or the graph's states have inconsistent sizes.
+bool WriteExperienceGraph(const ExperienceGraph& eg, const std::string& path);
+
+/// Read an experience graph from a file in the binary format, appending its
+/// nodes and edges to \p eg. Returns false if the file cannot be mapped or is
+/// malformed.
+bool ReadExperienceGraph(const std::string& path, ExperienceGraph& eg);
+
+///@}
+
+} // namespace smpl
+
+#endif
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_FACTORED_PLANNING_SPACE_H
+#define SMPL_FACTORED_PLANNING_SPACE_H
+
+// standard includes
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// project includes
+#include <smpl/types.h>
+#include <smpl/graph/manip_lattice.h>
+#include <smpl/graph/robot_planning_space.h>
+
+namespace smpl {
+
+/// A composite planning space over two independently modeled kinematic
+/// chains, e.g. the two arms of a bimanual robot, presented to a graph
+/// search as a single space.
+///
+/// Rather than discretizing the combined configuration space, which
+/// multiplies the branching factors of the chains together, each successor of
+/// a composite state moves exactly one chain through one of its component
+/// lattice's actions while the other chain holds its configuration, keeping
+/// the branching factor additive. Each component lattice validates its own
+/// motions against the world; the interaction between the chains is validated
+/// lazily by the composite collision checker, and only for motions where the
+/// chains may actually interact when an interaction radius is configured (see
+/// setInteractionRadius()).
+///
+/// The composite goal is a joint state goal over the concatenated variables,
+/// split between the component lattices; the goal is reached when both
+/// components have reached their joint goals. Component lattice states,
+/// starts, and goals are managed by this class through the component
+/// lattices' public interfaces, so the component lattices must not be shared
+/// with another search.
+class FactoredPlanningSpace :
+    public RobotPlanningSpace,
+    public ExtractRobotStateExtension
+{
+public:
+
+    bool init(
+        RobotModel* robot,
+        CollisionChecker* checker,
+        ManipLattice* first,
+        ManipLattice* second);
+
+    auto firstLattice() -> ManipLattice* { return m_parts[0].lattice; }
+    auto secondLattice() -> ManipLattice* { return m_parts[1].lattice; }
+
+    /// Set the radius of the conservative interaction test. When
+    /// non-negative, the composite collision check for a single-chain motion
+    /// is skipped whenever the chains' projected points (e.g. end effector
+    /// positions) are separated by more than this radius, so it must cover
+    /// the maximum extent of either chain about its projected point plus the
+    /// extent of one action. Negative disables the test and every motion is
+    /// checked. The composite checker should validate only the interaction
+    /// between the chains; the component lattices have already validated each
+    /// chain against the world.
+    void setInteractionRadius(double radius) { m_interaction_radius = radius; }
+    double interactionRadius() const { return m_interaction_radius; }
+
+    /// \name Required Public Functions from ExtractRobotStateExtension
+    ///@{
+    auto extractState(int state_id) -> const RobotState& override;
+    ///@}
+
+    /// \name Required Public Functions from RobotPlanningSpace
+    ///@{
+    bool setStart(const RobotState& state) override;
+    bool setGoal(const GoalConstraint& goal) override;
+
+    int getStartStateID() const override;
+    int getGoalStateID() const override;
+
+    bool extractPath(
+        const std::vector<int>& ids,
+        std::vector<RobotState>& path) override;
+    ///@}
+
+    /// \name Required Public Functions from Extension
+    ///@{
+    virtual Extension* getExtension(size_t class_code) override;
+    ///@}
+
+    /// \name Required Public Functions from DiscreteSpaceInformation
+    ///@{
+    void GetSuccs(
+        int state_id,
+        std::vector<int>* succs,
+        std::vector<int>* costs) override;
+
+    void GetPreds(
+        int state_id,
+        std::vector<int>* preds,
+        std::vector<int>* costs) override;
+
+    void PrintState(int state_id, bool verbose, FILE* fout = nullptr) override;
+    ///@}
+
+private:
+
+    struct Part
+    {
+        ManipLattice* lattice = nullptr;
+        PointProjectionExtension* proj = nullptr;
+        int jvar_count = 0;
+        RobotState goal_state;  // the component's joint goal configuration
+    };
+
+    Part m_parts[2];
+
+    struct FactoredState
+    {
+        int part_ids[2];    // component lattice state ids
+        RobotState state;   // concatenated component states
+    };
+
+    std::vector<FactoredState> m_states;
+    std::unordered_map<std::uint64_t, int> m_state_to_id;
+
+    int m_start_state_id = -1;
+    int m_goal_state_id = -1;
+
+    double m_interaction_radius = -1.0;
+
+    // scratch successor buffers for component expansions
+    std::vector<int> m_succs;
+    std::vector<int> m_costs;
+
+    auto componentState(int pidx, int part_state_id) -> const RobotState&;
+
+    int getOrCreateState(int first_id, int second_id, const RobotState& state);
+
+    bool interactionValid(
+        const FactoredState& from,
+        int pidx,
+        int moved_part_id,
+        const RobotState& to);
+};
+
+} // namespace smpl
+
+#endif
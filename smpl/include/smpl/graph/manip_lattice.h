@@ -34,10 +34,12 @@
 #define SMPL_MANIP_LATTICE_H
 
 // standard includes
+#include <stdint.h>
 #include <time.h>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 // system includes
@@ -50,9 +52,12 @@
 #include <smpl/occupancy_grid.h>
 #include <smpl/planning_params.h>
 #include <smpl/robot_model.h>
+#include <smpl/stats.h>
 #include <smpl/types.h>
 #include <smpl/graph/robot_planning_space.h>
 #include <smpl/graph/action_space.h>
+#include <smpl/graph/cost_function.h>
+#include <smpl/search/lazy_search_interface.h>
 
 namespace smpl {
 
@@ -60,10 +65,11 @@ class RobotHeuristic;
 
 typedef std::vector<int> RobotCoord;
 
+// The state table stores only the discrete coordinate; continuous states are
+// materialized on demand through ManipLattice::contState().
 struct ManipLatticeState
 {
     RobotCoord coord;   // discrete coordinate
-    RobotState state;   // corresponding continuous coordinate
 };
 
 inline
@@ -92,7 +98,9 @@ namespace smpl {
 class ManipLattice :
     public RobotPlanningSpace,
     public PoseProjectionExtension,
-    public ExtractRobotStateExtension
+    public ExtractRobotStateExtension,
+    public ILazySuccFun,
+    public MemoryUsageProvider
 {
 public:
 
@@ -108,6 +116,13 @@ public:
     auto actionSpace() -> ActionSpace* { return m_actions; }
     auto actionSpace() const -> const ActionSpace* { return m_actions; }
 
+    /// Install a custom cost function evaluated over the endpoints of each
+    /// action. Costs are fixed-point integers (see CostFunction); when no
+    /// cost function is installed every action receives a uniform unit cost.
+    /// The cost function must outlive the lattice; null restores the default.
+    void setCostFunction(CostFunction* cost_fun) { m_cost_fun = cost_fun; }
+    auto costFunction() const -> CostFunction* { return m_cost_fun; }
+
     auto getStartConfiguration() const -> RobotState;
 
     void setVisualizationFrameId(const std::string& frame_id);
@@ -117,6 +132,46 @@ public:
 
     void clearStates();
 
+    /// Drop all cached action validity results. Must be called when the
+    /// underlying world model changes (e.g. the occupancy grid backing the
+    /// collision checker is updated) between queries; start and goal changes
+    /// invalidate the cache automatically. Also drops the frozen graph,
+    /// whose edges were validated against the old world model.
+    void invalidateActionCache();
+
+    /// \name Frozen Graph Queries
+    ///@{
+
+    /// Freeze the realized portion of the lattice into an explicit graph:
+    /// every state allocated so far is expanded once and its validated
+    /// successor edges and costs are packed into a flat adjacency table.
+    /// While frozen, GetSuccs() serves these states by array indexing, with
+    /// no action generation or collision checks; states discovered past the
+    /// freeze (the frontier) keep generating successors dynamically. Goal
+    /// tests still run per query, so the goal may change between frozen
+    /// searches. The frozen edges are only valid for the world model they
+    /// were validated against; changing the map thaws the graph through
+    /// invalidateActionCache().
+    bool freezeGraph();
+
+    /// Drop the frozen graph and resume dynamic successor generation
+    /// everywhere.
+    void thawGraph();
+
+    bool frozen() const { return !m_frozen_row.empty(); }
+
+    /// Serialize the frozen graph -- state coordinates and configurations
+    /// plus the packed adjacency table -- to a file, so repeat-query
+    /// workloads on a static map can skip re-exploration entirely.
+    bool saveFrozenGraph(const std::string& filepath) const;
+
+    /// Discard all states and load a frozen graph saved by
+    /// saveFrozenGraph(). The lattice must be initialized with the same
+    /// robot model and discretization the graph was built with.
+    bool loadFrozenGraph(const std::string& filepath);
+
+    ///@}
+
     /// \name Reimplemented Public Functions from RobotPlanningSpace
     ///@{
     void GetLazySuccs(
@@ -125,6 +180,17 @@ public:
         std::vector<int>* costs,
         std::vector<bool>* true_costs) override;
     int GetTrueCost(int parent_id, int child_id) override;
+    auto succStream(int state_id) -> std::unique_ptr<SuccessorStream> override;
+    ///@}
+
+    /// \name Required Public Functions from ILazySuccFun
+    ///@{
+    void GetLazySuccs(
+        int state_id,
+        std::vector<int>& succs,
+        std::vector<int>& costs,
+        std::vector<bool>& true_costs) override;
+    int GetSuccTrueCost(int state_id, int succ_id) override;
     ///@}
 
     /// \name Required Public Functions from ExtractRobotStateExtension
@@ -153,6 +219,11 @@ public:
     virtual Extension* getExtension(size_t class_code) override;
     ///@}
 
+    /// \name Required Public Functions from MemoryUsageProvider
+    ///@{
+    auto memUsage() const -> size_t override;
+    ///@}
+
     /// \name Required Public Functions from DiscreteSpaceInformation
     ///@{
     void GetSuccs(
@@ -177,28 +248,42 @@ protected:
     ManipLatticeState* getHashEntry(int state_id) const;
 
     int getHashEntry(const RobotCoord& coord);
-    int createHashEntry(const RobotCoord& coord, const RobotState& state);
-    int getOrCreateState(const RobotCoord& coord, const RobotState& state);
+    int createHashEntry(const RobotCoord& coord);
+    int getOrCreateState(const RobotCoord& coord);
     int reserveHashEntry();
 
+    auto contState(int state_id) -> const RobotState&;
+    void setContState(int state_id, const RobotState& state);
+
     Affine3 computePlanningFrameFK(const RobotState& state) const;
 
-    int cost(
-        ManipLatticeState* HashEntry1,
-        ManipLatticeState* HashEntry2,
-        bool bState2IsGoal) const;
+    int cost(int state_id1, int state_id2, bool bState2IsGoal);
+
+    void computeActionCosts(
+        const RobotState& parent,
+        const std::vector<Action>& actions);
 
     bool checkAction(const RobotState& state, const Action& action);
 
     bool isGoal(const RobotState& state);
+    bool isGoal(const RobotState& state, const Affine3& pose);
 
     auto getStateVisualization(const RobotState& vars, const std::string& ns)
         -> std::vector<visual::Marker>;
 
 private:
 
+    class ActionSuccStream;
+
     ForwardKinematicsInterface* m_fk_iface = nullptr;
     ActionSpace* m_actions = nullptr;
+    CostFunction* m_cost_fun = nullptr;
+
+    // per-expansion table of integer action costs, filled once from the
+    // action list so the per-successor cost is an array load; costs depend
+    // only on the action endpoints today, so the table needs no per-successor
+    // state lookups
+    std::vector<int> m_action_costs;
 
     // cached from robot model
     std::vector<double> m_min_limits;
@@ -209,6 +294,13 @@ private:
     std::vector<int> m_coord_vals;
     std::vector<double> m_coord_deltas;
 
+    // per-variable discretization mode and affine offset, precomputed from
+    // the limits so the coord<->state conversions are tight loops over flat
+    // arrays, dispatched through fixed-trip-count kernels the compiler
+    // unrolls for common variable counts
+    std::vector<unsigned char> m_coord_modes;
+    std::vector<double> m_coord_offsets;
+
     int m_goal_state_id = -1;
     int m_start_state_id = -1;
 
@@ -218,11 +310,107 @@ private:
     typedef PointerValueEqual<StateKey> StateEqual;
     hash_map<StateKey*, int, StateHash, StateEqual> m_state_to_id;
 
+    // packed-key state index, used in place of m_state_to_id when every
+    // coordinate fits within 8 bits and there are at most 8 joint variables;
+    // coordinates are encoded into a single 64-bit key and looked up in a
+    // flat open-addressing table to avoid hashing and pointer chasing on
+    // every successor lookup
+    bool m_packed_coords = false;
+    std::vector<std::pair<uint64_t, int>> m_coord_to_id;    // (key, state id)
+    size_t m_coord_to_id_count = 0;
+
+    // bloom filter front over m_state_to_id, used when coordinates are too
+    // wide for the packed index; two bits per coordinate are tested before
+    // the exact lookup so that queries for coordinates that have never been
+    // allocated usually return without touching the hash map; rebuilt at
+    // double capacity when the state count outgrows the size it was built
+    // for, so its false positive rate stays low as searches accumulate states
+    std::vector<uint64_t> m_coord_filter;
+    size_t m_coord_filter_cap = 0;  // state count the filter was sized for
+
     // maps from stateID to coords
     std::vector<ManipLatticeState*> m_states;
 
+    // continuous states whose values carry information beyond their discrete
+    // coordinate: the start configuration, experience waypoints, and
+    // goal-satisfying action endpoints recorded for path extraction; all
+    // other states materialize the center of their coordinate on first touch
+    // through contState(), so the state table holds coords only and the
+    // frontier (the bulk of the states a search allocates) carries no
+    // continuous copy at all
+    hash_map<int, RobotState> m_exact_states;
+
+    // memo of the materialized coordinate centers, filled by contState()
+    hash_map<int, RobotState> m_cont_state_cache;
+
+    // per-episode cache of checkAction() results, keyed by the parent state
+    // id and indexed by action number (-1 = unknown); anytime searches
+    // re-expand states at each suboptimality bound and would otherwise repeat
+    // identical collision checks
+    hash_map<int, std::vector<signed char>> m_action_validity;
+
+    // reused buffers for batched planning frame FK over the valid successors
+    // of an expansion
+    std::vector<RobotState> m_fk_batch_states;
+    std::vector<Affine3, Eigen::aligned_allocator<Affine3>> m_fk_batch_poses;
+
+    // planning frame poses keyed by state id, filled when a state's pose is
+    // first computed (batched fk during expansions or the first projection);
+    // heuristics projecting a state through PoseProjectionExtension then
+    // share one fk evaluation per state instead of each re-running fk
+    hash_map<
+        int,
+        Affine3,
+        std::hash<int>,
+        std::equal_to<int>,
+        Eigen::aligned_allocator<std::pair<const int, Affine3>>> m_pose_cache;
+
+    // map from state id to the concrete successor state id and edge cost of
+    // the cheapest valid transition to the virtual goal state found so far,
+    // recorded during successor generation so that path extraction recovers
+    // the goal waypoint by lookup instead of re-applying and re-validating
+    // actions
+    hash_map<int, std::pair<int, int>> m_goal_succ_cache;
+
     std::string m_viz_frame_id;
 
+    // spatial index over the candidate poses of a MULTIPLE_POSE_GOAL; each
+    // candidate is binned into its position cell and the 26 surrounding cells
+    // at the resolution of the largest per-axis position tolerance, so a goal
+    // test probes the single bucket containing the query position instead of
+    // scanning every candidate pose
+    hash_map<uint64_t, std::vector<int>> m_goal_pose_bins;
+    double m_goal_bin_res = 0.0;
+
+    // pose-goal fast path, precomputed at goal-set time: the unit quaternion
+    // of each candidate goal pose and the quaternion dot-product threshold
+    // equivalent to the orientation tolerance, so a per-successor goal test
+    // needs no rotation decomposition and no trigonometry (see isGoal())
+    std::vector<Quaternion, Eigen::aligned_allocator<Quaternion>> m_goal_quats;
+    double m_goal_dot_thresh = 1.0;
+
+    // frozen explicit graph over the states realized at freeze time: CSR
+    // adjacency rows of concrete (successor, cost) edges validated at freeze
+    // time, served by GetSuccs() in place of action generation while
+    // non-empty; states without a row are the frontier and keep generating
+    // successors dynamically
+    std::vector<int> m_frozen_row;      // per-state offsets, frozen count + 1
+    std::vector<int> m_frozen_succs;
+    std::vector<int> m_frozen_costs;
+
+    uint64_t packCoord(const RobotCoord& coord) const;
+    int packedGetState(uint64_t key) const;
+    void packedInsertState(uint64_t key, int state_id);
+
+    uint64_t coordFilterKey(const RobotCoord& coord) const;
+    bool coordFilterContains(uint64_t key) const;
+    void coordFilterInsert(uint64_t key);
+
+    void getFrozenSuccs(
+        int state_id,
+        std::vector<int>* succs,
+        std::vector<int>* costs);
+
     bool setGoalPose(const GoalConstraint& goal);
     bool setGoalPoses(const GoalConstraint& goal);
     bool setGoalConfiguration(const GoalConstraint& goal);
@@ -34,6 +34,7 @@
 #define SMPL_MANIP_LATTICE_ACTION_SPACE_H
 
 // standard includes
+#include <cstdint>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -43,6 +44,7 @@
 
 // system includes
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 // project includes
 #include <smpl/graph/action_space.h>
@@ -81,31 +83,101 @@ public:
     bool useAmp(MotionPrimitive::Type type) const;
     bool useMultipleIkSolutions() const;
     bool useLongAndShortPrims() const;
+    bool useActionTiers() const;
     double ampThresh(MotionPrimitive::Type type) const;
 
     void useAmp(MotionPrimitive::Type type, bool enable);
     void useMultipleIkSolutions(bool enable);
     void useLongAndShortPrims(bool enable);
+    void useActionTiers(bool enable);
     void ampThresh(MotionPrimitive::Type type, double thresh);
 
+    /// \name Primitive Usage Profiling
+    ///@{
+
+    /// Attribute the edges of a final path to the primitives that produced
+    /// them, tallying each primitive's on-path usage. Edges produced by
+    /// adaptive motions have no matching joint-space primitive and are
+    /// ignored.
+    void recordPathUsage(const std::vector<RobotState>& path);
+
+    /// Append one episode record of the per-primitive usage tallies, keyed by
+    /// source row within the loaded action file, to a usage log consumable by
+    /// the offline primitive set compiler (see mprim_profile.h), then reset
+    /// the tallies. Returns false if no primitives were loaded from a file.
+    bool writeUsageLog(const std::string& path);
+    ///@}
+
     /// \name Required Public Functions from ActionSpace
     ///@{
     bool apply(const RobotState& parent, std::vector<Action>& actions) override;
     ///@}
 
+    /// \name Reimplemented Public Functions from ActionSpace
+    ///@{
+    bool applyInverse(const RobotState& child, std::vector<Action>& actions) override;
+    void updateGoal(const GoalConstraint& goal) override;
+    ///@}
+
 protected:
 
     std::vector<MotionPrimitive> m_mprims;
 
+    // flat delta table compiled from the joint-space motion primitives; the
+    // entry at index i locates the waypoint deltas of m_mprims[i] within
+    // m_packed_deltas, with zero waypoints for adaptive motions, so that
+    // applying a primitive is a single pass over contiguous storage
+    struct PackedPrim
+    {
+        std::size_t offset;     ///< first delta within m_packed_deltas
+        std::size_t waypoints;  ///< number of waypoints
+        std::size_t width;      ///< variables per waypoint
+    };
+    std::vector<PackedPrim> m_packed_prims;
+    std::vector<double> m_packed_deltas;
+
     ForwardKinematicsInterface* m_fk_iface = nullptr;
     InverseKinematicsInterface* m_ik_iface = nullptr;
 
     bool m_mprim_enabled[MotionPrimitive::NUMBER_OF_MPRIM_TYPES];
     double m_mprim_thresh[MotionPrimitive::NUMBER_OF_MPRIM_TYPES];
 
+    // per-primitive usage tallies (successors generated during expansions and
+    // edges on final paths) and the source row of each primitive within the
+    // loaded action file, -1 for primitives not read from a file; tallies are
+    // aggregated by source row when written to an episode log
+    std::vector<std::uint64_t> m_prim_expansions;
+    std::vector<std::uint64_t> m_prim_path_uses;
+    std::vector<int> m_prim_source_rows;
+    int m_load_row = -1;
+
     bool m_use_multiple_ik_solutions        = false;
     bool m_use_long_and_short_dist_mprims   = false;
 
+    // tiered action evaluation: far from the goal only the long-distance
+    // primitives are evaluated, while near the goal or start the
+    // short-distance set is layered on top of them along with any enabled
+    // goal-directed ik motions; the tier is decided once per expansion from
+    // the metric start/goal distances queried from the heuristic
+    bool m_use_action_tiers                 = false;
+
+    // memoized adaptive motion results, keyed by the parent state with the
+    // ik restriction appended; parent states are the lattice's canonical
+    // cell representatives, so keys recur exactly across the repeated goal
+    // snaps of the end-game. Empty action sets record failed snaps; cleared
+    // when the goal changes
+    struct IkActionCacheHash
+    {
+        std::size_t operator()(const RobotState& key) const
+        {
+            return boost::hash_range(key.begin(), key.end());
+        }
+    };
+    hash_map<RobotState, std::vector<Action>, IkActionCacheHash>
+            m_ik_action_cache;
+
+    void packMotionPrim(const MotionPrimitive& mp);
+
     bool applyMotionPrimitive(
         const RobotState& state,
         const MotionPrimitive& mp,
@@ -130,6 +202,8 @@ protected:
         double goal_dist,
         MotionPrimitive::Type type) const;
 
+    int matchPrimitive(const RobotState& from, const RobotState& to) const;
+
     auto getStartGoalDistances(const RobotState& state)
         -> std::pair<double, double>;
 };
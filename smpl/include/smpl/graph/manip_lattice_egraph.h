@@ -32,8 +32,13 @@
 #ifndef SMPL_MANIP_LATTICE_EGRAPH_H
 #define SMPL_MANIP_LATTICE_EGRAPH_H
 
+#include <mutex>
+#include <utility>
+
+#include <smpl/graph/experience_dedup.h>
 #include <smpl/graph/experience_graph.h>
 #include <smpl/graph/experience_graph_extension.h>
+#include <smpl/graph/experience_graph_index.h>
 #include <smpl/graph/manip_lattice.h>
 
 namespace smpl {
@@ -47,6 +52,39 @@ public:
     bool extractPath(
         const std::vector<int>& ids,
         std::vector<RobotState>& path) override;
+    auto memUsage() const -> size_t override;
+    ///@}
+
+    /// Write the experience graph to a file in the binary format read by
+    /// loadExperienceGraph(). Used to convert demonstration libraries parsed
+    /// from the CSV format into the binary format for fast startup.
+    bool saveExperienceGraph(const std::string& path) const;
+
+    /// \name Online Experience Accumulation
+    ///@{
+
+    /// Stage an executed path for inclusion in the experience graph. Safe to
+    /// call from any thread, including while a search is running: the path
+    /// is only queued here and folded into the graph at the next query
+    /// boundary, so searches and heuristics never observe the graph
+    /// mid-mutation and never wait on the submitter.
+    void submitExperiencePath(std::vector<RobotState> path);
+
+    /// Fold all staged paths into the experience graph. Called automatically
+    /// by setGoal(), before the heuristics are notified of the new goal;
+    /// must not be called while a search is running.
+    void syncExperienceGraph();
+
+    /// Reject staged paths that near-duplicate experience already in the
+    /// graph, under the given thresholds, before they are spliced in by
+    /// syncExperienceGraph(). Off by default.
+    void setExperienceDedup(const PathDedupParams& params);
+    void disableExperienceDedup();
+    ///@}
+
+    /// \name Reimplemented Public Functions from RobotPlanningSpace
+    ///@{
+    bool setGoal(const GoalConstraint& goal) override;
     ///@}
 
     /// \name Required Public Functions from ExperienceGraphExtension
@@ -78,6 +116,12 @@ public:
     Extension* getExtension(size_t class_code) override;
     ///@}
 
+    /// Invalidate cached snap motion evaluations. Snap motions are evaluated
+    /// against the collision model, so this must be called whenever the
+    /// planning scene changes between queries; cached results remain valid
+    /// across search iterations and queries against the same scene.
+    void invalidateSnapCache();
+
 private:
 
     struct RobotCoordHash
@@ -94,14 +138,48 @@ private:
             RobotCoordHash>
     CoordToExperienceGraphNodeMap;
 
+    struct StateIdPairHash
+    {
+        typedef std::pair<int, int> argument_type;
+        typedef std::size_t result_type;
+
+        result_type operator()(const argument_type& s) const;
+    };
+
+    // cached snap motion evaluations, keyed by (source, destination) state
+    // pair; entries recorded under an older cache version than
+    // m_snap_cache_version are stale and re-evaluated on lookup
+    struct SnapCacheEntry
+    {
+        int version;
+        int cost;
+        bool valid;
+    };
+
     CoordToExperienceGraphNodeMap m_coord_to_nodes;
     hash_map<int, ExperienceGraph::node_id> m_state_to_node;
 
+    hash_map<std::pair<int, int>, SnapCacheEntry, StateIdPairHash> m_snap_cache;
+    int m_snap_cache_version = 0;
+
     ExperienceGraph m_egraph;
 
     // map from experience graph node ids to state ids
     std::vector<int> m_egraph_state_ids;
 
+    // executed paths staged by submitExperiencePath(), spliced into the
+    // graph by syncExperienceGraph(); guarded by m_pending_mutex
+    std::mutex m_pending_mutex;
+    std::vector<std::vector<RobotState>> m_pending_paths;
+
+    // near-duplicate rejection of staged paths, applied on insertion when
+    // enabled; the index serves the spatial prefilter of the kernels
+    bool m_dedup_enabled = false;
+    PathDedupParams m_dedup_params;
+    ExperienceGraphIndex m_dedup_index;
+
+    void appendExperiencePath(const std::vector<RobotState>& egraph_states);
+
     bool findShortestExperienceGraphPath(
         ExperienceGraph::node_id u,
         ExperienceGraph::node_id s,
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_MPRIM_PROFILE_H
+#define SMPL_MPRIM_PROFILE_H
+
+// standard includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace smpl {
+
+/// Per-file-row usage tallies accumulated over planning episodes, as written
+/// by ManipLatticeActionSpace::writeUsageLog. A row's tallies include those of
+/// its converse primitive.
+struct MotionPrimitiveUsage
+{
+    std::size_t episodes = 0;
+    std::vector<std::uint64_t> expansions;
+    std::vector<std::uint64_t> path_uses;
+};
+
+/// Load and accumulate all episode records from a usage log. Returns false if
+/// the file cannot be read or records disagree on the number of rows.
+bool LoadMotionPrimitiveUsageLog(
+    const std::string& path,
+    MotionPrimitiveUsage& usage);
+
+struct MotionPrimitiveCompileOptions
+{
+    /// Rows appearing on fewer final paths than this across all recorded
+    /// episodes are pruned from the compiled set.
+    std::uint64_t min_path_uses = 1;
+};
+
+/// Compile a pruned and reordered action set file from a hand-authored action
+/// set and the usage recorded while planning with it. Rows are kept if their
+/// on-path usage meets the pruning threshold and each of the long- and
+/// short-distance groups is ordered by descending on-path usage, breaking
+/// ties by expansion count, so that the most profitable primitives are
+/// evaluated first. The output file is loadable by
+/// ManipLatticeActionSpace::load. Returns false on i/o or format errors, if
+/// the usage record does not cover the action set's rows, or if no
+/// long-distance rows survive pruning.
+bool CompileMotionPrimitiveSet(
+    const std::string& mprim_in_path,
+    const MotionPrimitiveUsage& usage,
+    const MotionPrimitiveCompileOptions& options,
+    const std::string& mprim_out_path);
+
+} // namespace smpl
+
+#endif
@@ -33,6 +33,7 @@
 #define SMPL_ROBOT_PLANNING_SPACE_H
 
 // standard includes
+#include <memory>
 #include <vector>
 
 // system includes
@@ -40,6 +41,7 @@
 
 // project includes
 #include <smpl/collision_checker.h>
+#include <smpl/epoch.h>
 #include <smpl/extension.h>
 #include <smpl/forward.h>
 #include <smpl/planning_params.h>
@@ -52,6 +54,26 @@ namespace smpl {
 
 class RobotHeuristic;
 
+/// A pull-based generator of the successor edges of a state, yielding edges in
+/// ascending order of an optimistic cost estimate so that a search may stop
+/// generating successors once the cheapest remaining edge cannot satisfy its
+/// current bound. The stream is invalidated by any subsequent successor
+/// generation on the owning planning space.
+class SuccessorStream
+{
+public:
+
+    virtual ~SuccessorStream();
+
+    /// Return a lower bound on the cost of every successor edge not yet
+    /// returned by next(), or std::numeric_limits<int>::max() when none
+    /// remain.
+    virtual int minRemainingCost() const = 0;
+
+    /// Yield the next successor edge. Returns false when none remain.
+    virtual bool next(int* succ_id, int* cost) = 0;
+};
+
 class RobotPlanningSpace :
     public DiscreteSpaceInformation,
     public virtual Extension
@@ -85,6 +107,11 @@ public:
     const RobotState& startState() const { return m_start; }
     const GoalConstraint& goal() const { return m_goal; }
 
+    /// The epoch of the goal constraint, bumped by every setGoal() call so
+    /// goal-derived caches (heuristic values, snap results) can validate
+    /// their entries against it; see CacheEntryHeader.
+    Epoch goalEpoch() const { return m_goal_epoch; }
+
     size_t numHeuristics() const;
     RobotHeuristic* heuristic(size_t i);
     const RobotHeuristic* heuristic(size_t i) const;
@@ -92,6 +119,12 @@ public:
     void notifyStartChanged(const RobotState& state);
     void notifyGoalChanged(const GoalConstraint& goal);
 
+    /// Return a stream over the successor edges of a state. The default
+    /// implementation materializes all successors through GetSuccs and
+    /// replays them in ascending cost order; derived spaces may override it
+    /// to defer per-successor work until the successor is pulled.
+    virtual auto succStream(int state_id) -> std::unique_ptr<SuccessorStream>;
+
     /// \name DiscreteSpaceInformation Interface Overrides
     ///@{
     virtual int GetGoalHeuristic(int state_id) override;
@@ -133,6 +166,9 @@ private:
     RobotState m_start;
     GoalConstraint m_goal;
 
+    // goal constraint epoch; see goalEpoch()
+    Epoch m_goal_epoch = 1;
+
     std::vector<RobotHeuristic*> m_heuristics;
 
     // Make all attempts to hide the set of useless functions from
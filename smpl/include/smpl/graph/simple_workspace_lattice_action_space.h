@@ -18,6 +18,20 @@ public:
     bool m_ik_amp_enabled = true;
     double m_ik_amp_thresh = 0.2;
 
+    // flat waypoint-delta table compiled from m_prims by
+    // InitSimpleWorkspaceLatticeActions(); the entry for each primitive
+    // locates its deltas and records whether any orientation variable moves,
+    // so apply() sweeps contiguous storage and skips euler renormalization
+    // for pure position and free-angle motions
+    struct PackedPrim
+    {
+        int offset;
+        int waypoints;
+        bool rotates;
+    };
+    std::vector<PackedPrim> m_packed_prims;
+    std::vector<double> m_packed_deltas;
+
     void apply(
         const WorkspaceLatticeState& state,
         std::vector<WorkspaceAction>& actions) override;
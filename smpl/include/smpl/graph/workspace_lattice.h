@@ -83,6 +83,10 @@ struct WorkspaceLattice :
 
     std::string m_viz_frame_id;
 
+    // SoA euler-angle/quaternion scratch for the batched waypoint orientation
+    // conversions in checkAction/checkLazyAction
+    std::vector<double> m_wp_rot_scratch;
+
     ~WorkspaceLattice();
 
     void setVisualizationFrameId(const std::string& frame_id);
@@ -33,6 +33,7 @@
 #define SMPL_WORKSPACE_LATTICE_BASE_H
 
 // project includes
+#include <smpl/spatial.h>
 #include <smpl/graph/robot_planning_space.h>
 #include <smpl/graph/workspace_lattice_types.h>
 
@@ -52,6 +53,7 @@ public:
     RedundantManipulatorInterface* m_rm_iface = NULL;
 
     std::vector<double> m_res;
+    std::vector<double> m_res_inv;
     std::vector<int> m_val_count;
     int m_dof_count = 0;
     std::vector<std::size_t> m_fangle_indices;
@@ -60,6 +62,16 @@ public:
     std::vector<bool> m_fangle_continuous;
     std::vector<bool> m_fangle_bounded;
 
+    // discretization tables for the angular dimensions, indexed by discrete
+    // coordinate: the continuous value at each rotation bin along with its
+    // sine and cosine, and the continuous value at each bin of the free
+    // angles with a finite bin count; computed once at init() since the
+    // resolutions and bin counts are fixed
+    std::vector<double> m_rot_vals[3];
+    std::vector<double> m_rot_sins[3];
+    std::vector<double> m_rot_coss[3];
+    std::vector<std::vector<double>> m_fav_vals;
+
     struct Params
     {
         double res_x;
@@ -96,6 +108,14 @@ public:
     bool stateWorkspaceToRobot(
         const WorkspaceState& state, const RobotState& seed, RobotState& ostate) const;
 
+    // variant taking the workspace state's orientation as a prebuilt
+    // quaternion, for callers that batch-convert waypoint orientations
+    bool stateWorkspaceToRobot(
+        const WorkspaceState& state,
+        const Quaternion& rot,
+        const RobotState& seed,
+        RobotState& ostate) const;
+
     // TODO: variants of workspace -> robot that don't restrict redundant angles
     // TODO: variants of workspace -> robot that take in a full seed state
 
@@ -106,6 +126,12 @@ public:
     void rotCoordToWorkspace(const int* gr, double* wr) const;
     void poseWorkspaceToCoord(const double* wp, int* gp) const;
     void poseCoordToWorkspace(const int* gp, double* wp) const;
+
+    // fused conversion from a discrete pose coordinate to a pose, building
+    // the rotation directly from the tabulated sines and cosines of the
+    // rotation bins rather than going through intermediate euler angles and
+    // axis-angle products
+    void poseCoordToPose(const int* gp, Affine3& pose) const;
     void favWorkspaceToCoord(const double* wa, int* ga) const;
     void favCoordToWorkspace(const int* ga, double* wa) const;
 };
@@ -86,6 +86,11 @@ public:
 
     bool snap(int first_id, int second_id, int& cost) override;
 
+    void snap(
+        int first_id,
+        const std::vector<int>& second_ids,
+        std::vector<int>& costs) override;
+
     auto getExperienceGraph() const -> const ExperienceGraph* override;
     auto getExperienceGraph() -> ExperienceGraph* override;
 
@@ -22,7 +22,9 @@ enum WorkspaceVariable
 };
 
 /// continuous state ( x, y, z, R, P, Y, j1, ..., jn )
-using WorkspaceState = std::vector<double>;
+/// shares the inline-storage vector type with RobotState so that workspace
+/// and joint states remain interchangeable where the two overlap
+using WorkspaceState = RobotState;
 
 /// discrete coordinate ( x, y, z, R, P, Y, j1, ..., jn )
 using WorkspaceCoord = std::vector<int>;
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_BLOCK_GRID_H
+#define SMPL_BLOCK_GRID_H
+
+// standard includes
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace smpl {
+
+/// This class represents a resizeable three-dimensional array of sparse data.
+/// It is an alternative backing to SparseGrid with the same interface: instead
+/// of a compressed octree, data is stored in dense cubic leaf blocks (8^3 by
+/// default) referenced from a flat block table, so that element access is a
+/// single indirection plus an offset rather than a tree descent. Compared to
+/// SparseGrid, per-node overhead is amortized over whole blocks and no pointer
+/// chain is walked on lookups, at the cost of a coarser unit of compression.
+///
+/// Blocks are allocated on the first write of a value differing from the
+/// background value and are filled from the background value. References
+/// returned by the non-const operator() remain valid until the containing
+/// block is reclaimed.
+///
+/// Unlike SparseGrid, set() does not eagerly reclaim blocks that become
+/// uniform; storage is reclaimed by an explicit call to prune(), which frees
+/// every block whose cells all compare equal to the background value. The
+/// predicate form of prune() frees every block whose cells all satisfy the
+/// predicate, provided the background value also satisfies it; cells in
+/// reclaimed blocks subsequently read as the background value, so the
+/// predicate should treat all satisfying values as interchangeable.
+template <class T, class Allocator = std::allocator<T>>
+class BlockGrid
+{
+public:
+
+    using value_type        = T;
+    using size_type         = std::uint64_t;
+    using reference         = value_type&;
+    using const_reference   = const value_type&;
+    using index_type        = int;
+
+    /// base-2 logarithm of the edge length of a leaf block
+    static const int block_dim_log2 = 3;
+
+    static const index_type block_dim = 1 << block_dim_log2;
+    static const size_type block_volume =
+            (size_type)1 << (3 * block_dim_log2);
+
+    BlockGrid();
+    BlockGrid(const T& value);
+    BlockGrid(size_type size_x, size_type size_y, size_type size_z);
+    BlockGrid(
+        size_type size_x, size_type size_y, size_type size_z,
+        const T& value);
+
+    explicit BlockGrid(const Allocator& alloc);
+    explicit BlockGrid(const T& value, const Allocator& alloc);
+    explicit BlockGrid(
+        size_type size_x, size_type size_y, size_type size_z,
+        const Allocator& alloc);
+    explicit BlockGrid(
+        size_type size_x, size_type size_y, size_type size_z,
+        const T& value, const Allocator& alloc);
+
+    BlockGrid(const BlockGrid& o);
+    BlockGrid(BlockGrid&& o);
+    BlockGrid& operator=(const BlockGrid& rhs);
+    BlockGrid& operator=(BlockGrid&& rhs);
+
+    ~BlockGrid();
+
+    /// \name Size Properties
+    ///@{
+    size_type size() const;
+    size_type max_size() const;
+    size_type size_x() const;
+    size_type size_y() const;
+    size_type size_z() const;
+
+    size_type mem_usage() const;
+    ///@}
+
+    /// \name Element Access
+    ///@{
+    const_reference operator()(index_type x, index_type y, index_type z) const;
+
+    reference operator()(index_type x, index_type y, index_type z);
+
+    const_reference get(index_type x, index_type y, index_type z) const;
+    ///@}
+
+    /// \name Modifiers
+    ///@{
+    void reset(const T& value);
+    void assign(const T& value);
+
+    void set(index_type x, index_type y, index_type z, const T& data);
+    void set_lazy(index_type x, index_type y, index_type z, const T& data);
+
+    void prune();
+
+    template <class UnaryPredicate>
+    void prune(UnaryPredicate p);
+
+    void resize(size_type size_x, size_type size_y, size_type size_z);
+    void resize(size_type size_x, size_type size_y, size_type size_z, const T& value);
+    ///@}
+
+    template <class Pred>
+    size_type mem_usage_full(const Pred& pred);
+
+    template <typename Callable>
+    void accept_coords(Callable c);
+
+    /// Return the number of currently allocated leaf blocks.
+    size_type num_blocks() const;
+
+private:
+
+    // per-coarse-cell pointers to leaf blocks of block_volume cells each;
+    // null entries denote blocks whose cells all hold the background value
+    std::vector<T*> m_blocks;
+
+    // value of all cells within unallocated blocks
+    T m_background;
+
+    Allocator m_alloc;
+
+    size_type m_size[3];
+    size_type m_bcount[3];  // dimensions of the block table
+
+    size_type block_index(index_type x, index_type y, index_type z) const;
+    size_type cell_offset(index_type x, index_type y, index_type z) const;
+
+    T* create_block(size_type bidx);
+    void destroy_block(size_type bidx);
+    void destroy_blocks();
+    void copy_blocks(const BlockGrid& o);
+
+    void init_table(size_type size_x, size_type size_y, size_type size_z);
+};
+
+/// A two-level bit grid with the same interface as SparseBinaryGrid, backed by
+/// a BlockGrid of bit-packed 2^3 regions in place of the compressed octree.
+template <class Allocator = std::allocator<std::uint8_t>>
+class BlockBinaryGrid
+{
+    struct packed_bool_ref;
+
+public:
+
+    using GridType = BlockGrid<std::uint8_t, Allocator>;
+
+    using value_type        = bool;
+    using size_type         = typename GridType::size_type;
+    using reference         = packed_bool_ref;
+    using const_reference   = bool;
+    using index_type        = int;
+
+    BlockBinaryGrid();
+    BlockBinaryGrid(bool value);
+    BlockBinaryGrid(size_type size_x, size_type size_y, size_type size_z);
+    BlockBinaryGrid(
+        size_type size_x, size_type size_y, size_type size_z,
+        bool value);
+
+    /// \name Size Properties
+    ///@{
+    size_type size() const;
+    size_type max_size() const;
+    size_type size_x() const;
+    size_type size_y() const;
+    size_type size_z() const;
+
+    size_type mem_usage() const;
+    ///@}
+
+    /// \name Element Access
+    ///@{
+    const_reference operator()(index_type x, index_type y, index_type z) const;
+
+    reference operator()(index_type x, index_type y, index_type z);
+
+    const_reference get(index_type x, index_type y, index_type z) const;
+    ///@}
+
+    /// \name Modifiers
+    ///@{
+    void reset(bool value);
+    void assign(bool value);
+
+    void set(index_type x, index_type y, index_type z, bool data);
+    void set_lazy(index_type x, index_type y, index_type z, bool data);
+
+    void prune();
+
+    template <class UnaryPredicate>
+    void prune(UnaryPredicate p);
+
+    void resize(size_type size_x, size_type size_y, size_type size_z);
+    void resize(size_type size_x, size_type size_y, size_type size_z, bool value);
+    ///@}
+
+    template <typename Callable>
+    void accept_coords(Callable c);
+
+private:
+
+    struct packed_bool_ref
+    {
+        std::uint8_t*   fptr; // pointer to field
+        std::uint8_t    mask; // offset into field
+
+        operator bool() const { return (bool)(*fptr & mask); }
+
+        packed_bool_ref& operator=(bool rhs) {
+            if (rhs) {
+                *fptr |= mask;
+            } else {
+                *fptr &= ~mask;
+            }
+            return *this;
+        }
+    };
+
+    GridType m_grid;
+    size_type m_osize[3];
+
+    std::uint8_t initval(bool value) const;
+    size_type reduced(size_type s) const;
+    std::uint8_t get_mask(int x, int y, int z) const;
+};
+
+} // namespace smpl
+
+#include "detail/block_grid.hpp"
+
+#endif
@@ -0,0 +1,834 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_BLOCK_GRID_HPP
+#define SMPL_BLOCK_GRID_HPP
+
+#include "../block_grid.h"
+
+// standard includes
+#include <algorithm>
+#include <utility>
+
+namespace smpl {
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid() :
+    m_blocks(),
+    m_background(),
+    m_alloc()
+{
+    init_table(64, 64, 64);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(const T& value) :
+    m_blocks(),
+    m_background(value),
+    m_alloc()
+{
+    init_table(64, 64, 64);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z)
+:
+    m_blocks(),
+    m_background(),
+    m_alloc()
+{
+    init_table(size_x, size_y, size_z);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z,
+    const T& value)
+:
+    m_blocks(),
+    m_background(value),
+    m_alloc()
+{
+    init_table(size_x, size_y, size_z);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(const Allocator& alloc) :
+    m_blocks(),
+    m_background(),
+    m_alloc(alloc)
+{
+    init_table(64, 64, 64);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(const T& value, const Allocator& alloc) :
+    m_blocks(),
+    m_background(value),
+    m_alloc(alloc)
+{
+    init_table(64, 64, 64);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z,
+    const Allocator& alloc)
+:
+    m_blocks(),
+    m_background(),
+    m_alloc(alloc)
+{
+    init_table(size_x, size_y, size_z);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z,
+    const T& value,
+    const Allocator& alloc)
+:
+    m_blocks(),
+    m_background(value),
+    m_alloc(alloc)
+{
+    init_table(size_x, size_y, size_z);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(const BlockGrid& o) :
+    m_blocks(),
+    m_background(o.m_background),
+    m_alloc(o.m_alloc)
+{
+    m_size[0] = o.m_size[0];
+    m_size[1] = o.m_size[1];
+    m_size[2] = o.m_size[2];
+    m_bcount[0] = o.m_bcount[0];
+    m_bcount[1] = o.m_bcount[1];
+    m_bcount[2] = o.m_bcount[2];
+    copy_blocks(o);
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::BlockGrid(BlockGrid&& o) :
+    m_blocks(std::move(o.m_blocks)),
+    m_background(std::move(o.m_background)),
+    m_alloc(std::move(o.m_alloc))
+{
+    m_size[0] = o.m_size[0];
+    m_size[1] = o.m_size[1];
+    m_size[2] = o.m_size[2];
+    m_bcount[0] = o.m_bcount[0];
+    m_bcount[1] = o.m_bcount[1];
+    m_bcount[2] = o.m_bcount[2];
+    o.m_blocks.clear();
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>&
+BlockGrid<T, Allocator>::operator=(const BlockGrid& rhs)
+{
+    if (this != &rhs) {
+        destroy_blocks();
+        m_background = rhs.m_background;
+        m_size[0] = rhs.m_size[0];
+        m_size[1] = rhs.m_size[1];
+        m_size[2] = rhs.m_size[2];
+        m_bcount[0] = rhs.m_bcount[0];
+        m_bcount[1] = rhs.m_bcount[1];
+        m_bcount[2] = rhs.m_bcount[2];
+        copy_blocks(rhs);
+    }
+    return *this;
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>&
+BlockGrid<T, Allocator>::operator=(BlockGrid&& rhs)
+{
+    if (this != &rhs) {
+        destroy_blocks();
+        m_blocks = std::move(rhs.m_blocks);
+        m_background = std::move(rhs.m_background);
+        m_alloc = std::move(rhs.m_alloc);
+        m_size[0] = rhs.m_size[0];
+        m_size[1] = rhs.m_size[1];
+        m_size[2] = rhs.m_size[2];
+        m_bcount[0] = rhs.m_bcount[0];
+        m_bcount[1] = rhs.m_bcount[1];
+        m_bcount[2] = rhs.m_bcount[2];
+        rhs.m_blocks.clear();
+    }
+    return *this;
+}
+
+template <class T, class Allocator>
+BlockGrid<T, Allocator>::~BlockGrid()
+{
+    destroy_blocks();
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::size() const
+{
+    return m_size[0] * m_size[1] * m_size[2];
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::max_size() const
+{
+    return m_blocks.max_size() * block_volume;
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::size_x() const
+{
+    return m_size[0];
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::size_y() const
+{
+    return m_size[1];
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::size_z() const
+{
+    return m_size[2];
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::mem_usage() const
+{
+    return sizeof(*this) +
+            m_blocks.size() * sizeof(T*) +
+            num_blocks() * block_volume * sizeof(T);
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::const_reference
+BlockGrid<T, Allocator>::operator()(
+    index_type x,
+    index_type y,
+    index_type z) const
+{
+    const T* block = m_blocks[block_index(x, y, z)];
+    if (!block) {
+        return m_background;
+    }
+    return block[cell_offset(x, y, z)];
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::reference
+BlockGrid<T, Allocator>::operator()(index_type x, index_type y, index_type z)
+{
+    auto bidx = block_index(x, y, z);
+    T* block = m_blocks[bidx];
+    if (!block) {
+        block = create_block(bidx);
+    }
+    return block[cell_offset(x, y, z)];
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::const_reference
+BlockGrid<T, Allocator>::get(index_type x, index_type y, index_type z) const
+{
+    return (*this)(x, y, z);
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::reset(const T& value)
+{
+    destroy_blocks();
+    std::fill(m_blocks.begin(), m_blocks.end(), nullptr);
+    m_background = value;
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::assign(const T& value)
+{
+    reset(value);
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::set(
+    index_type x,
+    index_type y,
+    index_type z,
+    const T& data)
+{
+    auto bidx = block_index(x, y, z);
+    T* block = m_blocks[bidx];
+    if (!block) {
+        if (data == m_background) {
+            return;
+        }
+        block = create_block(bidx);
+    }
+    block[cell_offset(x, y, z)] = data;
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::set_lazy(
+    index_type x,
+    index_type y,
+    index_type z,
+    const T& data)
+{
+    set(x, y, z, data);
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::prune()
+{
+    for (size_type bidx = 0; bidx < m_blocks.size(); ++bidx) {
+        T* block = m_blocks[bidx];
+        if (!block) {
+            continue;
+        }
+        bool uniform = true;
+        for (size_type i = 0; i < block_volume; ++i) {
+            if (!(block[i] == m_background)) {
+                uniform = false;
+                break;
+            }
+        }
+        if (uniform) {
+            destroy_block(bidx);
+        }
+    }
+}
+
+template <class T, class Allocator>
+template <class UnaryPredicate>
+void BlockGrid<T, Allocator>::prune(UnaryPredicate p)
+{
+    if (!p(m_background)) {
+        return;
+    }
+    for (size_type bidx = 0; bidx < m_blocks.size(); ++bidx) {
+        T* block = m_blocks[bidx];
+        if (!block) {
+            continue;
+        }
+        bool prunable = true;
+        for (size_type i = 0; i < block_volume; ++i) {
+            if (!p(block[i])) {
+                prunable = false;
+                break;
+            }
+        }
+        if (prunable) {
+            destroy_block(bidx);
+        }
+    }
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::resize(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z)
+{
+    resize(size_x, size_y, size_z, m_background);
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::resize(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z,
+    const T& value)
+{
+    destroy_blocks();
+    m_background = value;
+    init_table(size_x, size_y, size_z);
+}
+
+template <class T, class Allocator>
+template <class Pred>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::mem_usage_full(const Pred& pred)
+{
+    // bounding box of all cells whose values satisfy pred
+    index_type min_coords[3] = { 0, 0, 0 };
+    index_type max_coords[3] = { 0, 0, 0 };
+    bool inited = false;
+
+    accept_coords([&](
+        const T& val,
+        index_type xfirst, index_type yfirst, index_type zfirst,
+        index_type xlast, index_type ylast, index_type zlast)
+    {
+        if (!pred(val)) {
+            return;
+        }
+        if (!inited) {
+            min_coords[0] = xfirst; max_coords[0] = xlast;
+            min_coords[1] = yfirst; max_coords[1] = ylast;
+            min_coords[2] = zfirst; max_coords[2] = zlast;
+            inited = true;
+        } else {
+            min_coords[0] = std::min(min_coords[0], xfirst);
+            min_coords[1] = std::min(min_coords[1], yfirst);
+            min_coords[2] = std::min(min_coords[2], zfirst);
+            max_coords[0] = std::max(max_coords[0], xlast);
+            max_coords[1] = std::max(max_coords[1], ylast);
+            max_coords[2] = std::max(max_coords[2], zlast);
+        }
+    });
+
+    if (!inited) {
+        return 0;
+    }
+
+    return sizeof(T) *
+            (size_type)(max_coords[0] - min_coords[0]) *
+            (size_type)(max_coords[1] - min_coords[1]) *
+            (size_type)(max_coords[2] - min_coords[2]);
+}
+
+template <class T, class Allocator>
+template <typename Callable>
+void BlockGrid<T, Allocator>::accept_coords(Callable c)
+{
+    for (size_type bx = 0; bx < m_bcount[0]; ++bx) {
+    for (size_type by = 0; by < m_bcount[1]; ++by) {
+    for (size_type bz = 0; bz < m_bcount[2]; ++bz) {
+        auto bidx = (bx * m_bcount[1] + by) * m_bcount[2] + bz;
+        auto xfirst = (index_type)(bx << block_dim_log2);
+        auto yfirst = (index_type)(by << block_dim_log2);
+        auto zfirst = (index_type)(bz << block_dim_log2);
+        const T* block = m_blocks[bidx];
+        if (!block) {
+            // report unallocated blocks as uniform background regions
+            c(m_background,
+                    xfirst, yfirst, zfirst,
+                    xfirst + block_dim, yfirst + block_dim, zfirst + block_dim);
+            continue;
+        }
+        for (index_type x = 0; x < block_dim; ++x) {
+        for (index_type y = 0; y < block_dim; ++y) {
+        for (index_type z = 0; z < block_dim; ++z) {
+            auto offset = ((size_type)x << (2 * block_dim_log2)) |
+                    ((size_type)y << block_dim_log2) | (size_type)z;
+            c(block[offset],
+                    xfirst + x, yfirst + y, zfirst + z,
+                    xfirst + x + 1, yfirst + y + 1, zfirst + z + 1);
+        }
+        }
+        }
+    }
+    }
+    }
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::num_blocks() const
+{
+    size_type count = 0;
+    for (const T* block : m_blocks) {
+        if (block) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::block_index(
+    index_type x,
+    index_type y,
+    index_type z) const
+{
+    auto bx = (size_type)x >> block_dim_log2;
+    auto by = (size_type)y >> block_dim_log2;
+    auto bz = (size_type)z >> block_dim_log2;
+    return (bx * m_bcount[1] + by) * m_bcount[2] + bz;
+}
+
+template <class T, class Allocator>
+typename BlockGrid<T, Allocator>::size_type
+BlockGrid<T, Allocator>::cell_offset(
+    index_type x,
+    index_type y,
+    index_type z) const
+{
+    const index_type mask = block_dim - 1;
+    return ((size_type)(x & mask) << (2 * block_dim_log2)) |
+            ((size_type)(y & mask) << block_dim_log2) |
+            (size_type)(z & mask);
+}
+
+// Allocate the block at \p bidx and fill it with the background value. Blocks
+// are allocated individually so that references into neighboring blocks remain
+// valid.
+template <class T, class Allocator>
+T* BlockGrid<T, Allocator>::create_block(size_type bidx)
+{
+    T* block = std::allocator_traits<Allocator>::allocate(
+            m_alloc, block_volume);
+    for (size_type i = 0; i < block_volume; ++i) {
+        std::allocator_traits<Allocator>::construct(
+                m_alloc, block + i, m_background);
+    }
+    m_blocks[bidx] = block;
+    return block;
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::destroy_block(size_type bidx)
+{
+    T* block = m_blocks[bidx];
+    for (size_type i = 0; i < block_volume; ++i) {
+        std::allocator_traits<Allocator>::destroy(m_alloc, block + i);
+    }
+    std::allocator_traits<Allocator>::deallocate(m_alloc, block, block_volume);
+    m_blocks[bidx] = nullptr;
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::destroy_blocks()
+{
+    for (size_type bidx = 0; bidx < m_blocks.size(); ++bidx) {
+        if (m_blocks[bidx]) {
+            destroy_block(bidx);
+        }
+    }
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::copy_blocks(const BlockGrid& o)
+{
+    m_blocks.assign(o.m_blocks.size(), nullptr);
+    for (size_type bidx = 0; bidx < o.m_blocks.size(); ++bidx) {
+        const T* oblock = o.m_blocks[bidx];
+        if (!oblock) {
+            continue;
+        }
+        T* block = std::allocator_traits<Allocator>::allocate(
+                m_alloc, block_volume);
+        for (size_type i = 0; i < block_volume; ++i) {
+            std::allocator_traits<Allocator>::construct(
+                    m_alloc, block + i, oblock[i]);
+        }
+        m_blocks[bidx] = block;
+    }
+}
+
+template <class T, class Allocator>
+void BlockGrid<T, Allocator>::init_table(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z)
+{
+    m_size[0] = size_x;
+    m_size[1] = size_y;
+    m_size[2] = size_z;
+    m_bcount[0] = (size_x + block_dim - 1) >> block_dim_log2;
+    m_bcount[1] = (size_y + block_dim - 1) >> block_dim_log2;
+    m_bcount[2] = (size_z + block_dim - 1) >> block_dim_log2;
+    m_blocks.assign(m_bcount[0] * m_bcount[1] * m_bcount[2], nullptr);
+}
+
+template <class Allocator>
+BlockBinaryGrid<Allocator>::BlockBinaryGrid() :
+    m_grid()
+{
+    m_osize[0] = m_grid.size_x() << 1;
+    m_osize[1] = m_grid.size_y() << 1;
+    m_osize[2] = m_grid.size_z() << 1;
+}
+
+template <class Allocator>
+BlockBinaryGrid<Allocator>::BlockBinaryGrid(bool value) :
+    m_grid(initval(value))
+{
+    m_osize[0] = m_grid.size_x() << 1;
+    m_osize[1] = m_grid.size_y() << 1;
+    m_osize[2] = m_grid.size_z() << 1;
+}
+
+template <class Allocator>
+BlockBinaryGrid<Allocator>::BlockBinaryGrid(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z)
+:
+    m_grid(reduced(size_x), reduced(size_y), reduced(size_z))
+{
+    m_osize[0] = size_x;
+    m_osize[1] = size_y;
+    m_osize[2] = size_z;
+}
+
+template <class Allocator>
+BlockBinaryGrid<Allocator>::BlockBinaryGrid(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z,
+    bool value)
+:
+    m_grid(reduced(size_x), reduced(size_y), reduced(size_z), initval(value))
+{
+    m_osize[0] = size_x;
+    m_osize[1] = size_y;
+    m_osize[2] = size_z;
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::size() const
+{
+    return m_osize[0] * m_osize[1] * m_osize[2];
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::max_size() const
+{
+    return m_grid.max_size() << 3;
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::size_x() const
+{
+    return m_osize[0];
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::size_y() const
+{
+    return m_osize[1];
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::size_z() const
+{
+    return m_osize[2];
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::mem_usage() const
+{
+    return m_grid.mem_usage();
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::const_reference
+BlockBinaryGrid<Allocator>::operator()(
+    index_type x,
+    index_type y,
+    index_type z) const
+{
+    return get(x, y, z);
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::reference
+BlockBinaryGrid<Allocator>::operator()(index_type x, index_type y, index_type z)
+{
+    packed_bool_ref ref;
+    ref.fptr = &m_grid(x >> 1, y >> 1, z >> 1);
+    ref.mask = get_mask(x, y, z);
+    return ref;
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::const_reference
+BlockBinaryGrid<Allocator>::get(index_type x, index_type y, index_type z) const
+{
+    return (bool)(m_grid.get(x >> 1, y >> 1, z >> 1) & get_mask(x, y, z));
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::reset(bool value)
+{
+    m_grid.reset(initval(value));
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::assign(bool value)
+{
+    m_grid.assign(initval(value));
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::set(
+    index_type x,
+    index_type y,
+    index_type z,
+    bool data)
+{
+    auto mask = get_mask(x, y, z);
+    auto val = m_grid.get(x >> 1, y >> 1, z >> 1);
+    decltype(val) nval;
+    if (data) {
+        nval = val | mask;
+    } else {
+        nval = val & ~mask;
+    }
+    if (nval != val) {
+        m_grid.set(x >> 1, y >> 1, z >> 1, nval);
+    }
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::set_lazy(
+    index_type x,
+    index_type y,
+    index_type z,
+    bool data)
+{
+    set(x, y, z, data);
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::prune()
+{
+    m_grid.prune();
+}
+
+template <class Allocator>
+template <class UnaryPredicate>
+void BlockBinaryGrid<Allocator>::prune(UnaryPredicate p)
+{
+    m_grid.prune(p);
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::resize(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z)
+{
+    m_grid.resize(reduced(size_x), reduced(size_y), reduced(size_z));
+    m_osize[0] = size_x;
+    m_osize[1] = size_y;
+    m_osize[2] = size_z;
+}
+
+template <class Allocator>
+void BlockBinaryGrid<Allocator>::resize(
+    size_type size_x,
+    size_type size_y,
+    size_type size_z,
+    bool value)
+{
+    m_grid.resize(reduced(size_x), reduced(size_y), reduced(size_z), initval(value));
+    m_osize[0] = size_x;
+    m_osize[1] = size_y;
+    m_osize[2] = size_z;
+}
+
+template <class Allocator>
+template <typename Callable>
+void BlockBinaryGrid<Allocator>::accept_coords(Callable c)
+{
+    m_grid.accept_coords([&](
+        std::uint8_t val,
+        index_type xfirst, index_type yfirst, index_type zfirst,
+        index_type xlast, index_type ylast, index_type zlast)
+    {
+        if (val == 0x00 || val == 0xFF) {
+            c((bool)(val & 1),
+                    xfirst << 1, yfirst << 1, zfirst << 1,
+                    xlast << 1, ylast << 1, zlast << 1);
+        } else {
+            for (index_type x = 0; x < 2; ++x) {
+            for (index_type y = 0; y < 2; ++y) {
+            for (index_type z = 0; z < 2; ++z) {
+                auto mask = (std::uint8_t)(1 << ((x << 2) | (y << 1) | z));
+                auto ox = (xfirst << 1) + x;
+                auto oy = (yfirst << 1) + y;
+                auto oz = (zfirst << 1) + z;
+                c((bool)(val & mask), ox, oy, oz, ox + 1, oy + 1, oz + 1);
+            }
+            }
+            }
+        }
+    });
+}
+
+template <class Allocator>
+std::uint8_t BlockBinaryGrid<Allocator>::initval(bool value) const
+{
+    if (value) {
+        return 0xFF;
+    } else {
+        return 0x00;
+    }
+}
+
+template <class Allocator>
+typename BlockBinaryGrid<Allocator>::size_type
+BlockBinaryGrid<Allocator>::reduced(size_type s) const
+{
+    return (s >> 1) + (s & 1);
+}
+
+template <class Allocator>
+std::uint8_t BlockBinaryGrid<Allocator>::get_mask(int x, int y, int z) const
+{
+    auto cx = x & 1;
+    auto cy = y & 1;
+    auto cz = z & 1;
+    return (std::uint8_t)(1 << ((cx << 2) | (cy << 1) | cz));
+}
+
+} // namespace smpl
+
+#endif
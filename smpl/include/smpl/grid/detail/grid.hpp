@@ -35,95 +35,245 @@
 #include "../grid.h"
 
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 
+#include <smpl/stl/memory.h>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
 namespace smpl {
 
-template <typename T>
-Grid3<T>::Grid3() : m_data(nullptr), m_dims()
+inline
+void RowMajorIndexing::init(size_type xdim, size_type ydim, size_type zdim)
+{
+    m_dims[0] = xdim;
+    m_dims[1] = ydim;
+    m_dims[2] = zdim;
+}
+
+inline
+RowMajorIndexing::size_type RowMajorIndexing::size() const
+{
+    return m_dims[0] * m_dims[1] * m_dims[2];
+}
+
+inline
+RowMajorIndexing::size_type
+RowMajorIndexing::index(size_type x, size_type y, size_type z) const
+{
+    return m_dims[2] * (x * m_dims[1] + y) + z;
+}
+
+inline
+void RowMajorIndexing::coord(
+    size_type i,
+    size_type& x,
+    size_type& y,
+    size_type& z) const
+{
+    x = i / (m_dims[1] * m_dims[2]);
+    y = (i - x * m_dims[1] * m_dims[2]) / m_dims[2];
+    z = i - (x * m_dims[1] * m_dims[2]) - y * m_dims[2];
+}
+
+inline
+void MortonIndexing::init(size_type xdim, size_type ydim, size_type zdim)
+{
+    size_type dims[3] = { xdim, ydim, zdim };
+    size_type bits[3] = { 0, 0, 0 };
+    for (int i = 0; i < 3; ++i) {
+        while ((size_type(1) << bits[i]) < dims[i]) {
+            ++bits[i];
+        }
+    }
+
+    // assign bits to dimensions round-robin, z in the least significant
+    // position to mirror the z-fastest ordering of RowMajorIndexing; once a
+    // dimension has all the bits it needs, the remaining dimensions pack
+    // contiguously
+    m_masks[0] = m_masks[1] = m_masks[2] = 0;
+    size_type need[3] = { bits[0], bits[1], bits[2] };
+    size_type pos = 0;
+    while (need[0] | need[1] | need[2]) {
+        for (int i = 2; i >= 0; --i) {
+            if (need[i]) {
+                m_masks[i] |= size_type(1) << pos++;
+                --need[i];
+            }
+        }
+    }
+
+    if (xdim && ydim && zdim) {
+        m_size = size_type(1) << (bits[0] + bits[1] + bits[2]);
+    } else {
+        m_size = 0;
+    }
+}
+
+inline
+MortonIndexing::size_type MortonIndexing::size() const
 {
+    return m_size;
+}
+
+inline
+MortonIndexing::size_type
+MortonIndexing::index(size_type x, size_type y, size_type z) const
+{
+    return scatter(x, m_masks[0]) | scatter(y, m_masks[1]) | scatter(z, m_masks[2]);
+}
+
+inline
+void MortonIndexing::coord(
+    size_type i,
+    size_type& x,
+    size_type& y,
+    size_type& z) const
+{
+    x = gather(i, m_masks[0]);
+    y = gather(i, m_masks[1]);
+    z = gather(i, m_masks[2]);
+}
+
+/// Deposit the low-order bits of \p v into the positions of the set bits of
+/// \p mask, in order from least to most significant.
+inline
+MortonIndexing::size_type
+MortonIndexing::scatter(size_type v, size_type mask)
+{
+#ifdef __BMI2__
+    return _pdep_u64(v, mask);
+#else
+    size_type r = 0;
+    size_type b = 1;
+    for (size_type m = mask; m; m &= m - 1) {
+        if (v & b) {
+            r |= m & (~m + 1);
+        }
+        b <<= 1;
+    }
+    return r;
+#endif
+}
+
+/// Extract the bits of \p v at the positions of the set bits of \p mask and
+/// pack them into the low-order bits of the result.
+inline
+MortonIndexing::size_type
+MortonIndexing::gather(size_type v, size_type mask)
+{
+#ifdef __BMI2__
+    return _pext_u64(v, mask);
+#else
+    size_type r = 0;
+    size_type b = 1;
+    for (size_type m = mask; m; m &= m - 1) {
+        if (v & (m & (~m + 1))) {
+            r |= b;
+        }
+        b <<= 1;
+    }
+    return r;
+#endif
+}
+
+template <typename T, typename Indexing>
+Grid3<T, Indexing>::Grid3() : m_index(), m_data(nullptr), m_dims()
+{
+    m_index.init(0, 0, 0);
     m_dims[0] = 0;
     m_dims[1] = 0;
     m_dims[2] = 0;
 }
 
-template <typename T>
-Grid3<T>::Grid3(
+template <typename T, typename Indexing>
+Grid3<T, Indexing>::Grid3(
     size_type xdim,
     size_type ydim,
     size_type zdim,
     const T& value)
 :
-    m_data(new T[xdim * ydim * zdim]),
+    m_index(),
+    m_data(nullptr),
     m_dims()
 {
-    std::fill(m_data, m_data + (xdim * ydim * zdim), value);
+    m_index.init(xdim, ydim, zdim);
+    m_data = grid_new<T>(storage_size());
+    std::fill(m_data, m_data + storage_size(), value);
     m_dims[0] = xdim;
     m_dims[1] = ydim;
     m_dims[2] = zdim;
 }
 
-template <typename T>
-Grid3<T>::Grid3(
+template <typename T, typename Indexing>
+Grid3<T, Indexing>::Grid3(
     size_type xdim,
     size_type ydim,
     size_type zdim)
 :
-    m_data(new T[xdim * ydim * zdim]),
+    m_index(),
+    m_data(nullptr),
     m_dims()
 {
+    m_index.init(xdim, ydim, zdim);
+    m_data = grid_new<T>(storage_size());
     m_dims[0] = xdim;
     m_dims[1] = ydim;
     m_dims[2] = zdim;
 }
 
-template <typename T>
-Grid3<T>::Grid3(const Grid3& other) :
-    m_data(new T[other.m_dims[0] * other.m_dims[1] * other.m_dims[2]]),
+template <typename T, typename Indexing>
+Grid3<T, Indexing>::Grid3(const Grid3& other) :
+    m_index(other.m_index),
+    m_data(grid_new<T>(other.storage_size())),
     m_dims()
 {
-    size_type total_size = other.m_dims[0] * other.m_dims[1] * other.m_dims[2];
-    std::copy(other.m_data, other.m_data + total_size, m_data);
+    std::copy(other.m_data, other.m_data + other.storage_size(), m_data);
     m_dims[0] = other.m_dims[0];
     m_dims[1] = other.m_dims[1];
     m_dims[2] = other.m_dims[2];
 }
 
-template <typename T>
-Grid3<T>::Grid3(Grid3&& other)
+template <typename T, typename Indexing>
+Grid3<T, Indexing>::Grid3(Grid3&& other)
 {
+    m_index = other.m_index;
     m_data = other.m_data;
     m_dims[0] = other.m_dims[0];
     m_dims[1] = other.m_dims[1];
     m_dims[2] = other.m_dims[2];
+    other.m_index.init(0, 0, 0);
     other.m_data = nullptr;
     other.m_dims[0] = 0;
     other.m_dims[1] = 0;
     other.m_dims[2] = 0;
 }
 
-template <typename T>
-Grid3<T>::~Grid3()
+template <typename T, typename Indexing>
+Grid3<T, Indexing>::~Grid3()
 {
      if (m_data) {
-         delete [] m_data;
+         grid_delete(m_data, storage_size());
      }
      m_dims[0] = 0;
      m_dims[1] = 0;
      m_dims[2] = 0;
 }
 
-template <typename T>
-Grid3<T>& Grid3<T>::operator=(const Grid3& rhs)
+template <typename T, typename Indexing>
+Grid3<T, Indexing>& Grid3<T, Indexing>::operator=(const Grid3& rhs)
 {
     if (this != &rhs) {
         if (m_data) {
-            delete [] m_data;
+            grid_delete(m_data, storage_size());
         }
 
-        size_type total_size = rhs.m_dims[0] * rhs.m_dims[1] * rhs.m_dims[2];
-        m_data = new T[total_size];
-        std::copy(rhs.m_data, rhs.m_data + total_size, m_data);
+        m_index = rhs.m_index;
+        m_data = grid_new<T>(storage_size());
+        std::copy(rhs.m_data, rhs.m_data + rhs.storage_size(), m_data);
         m_dims[0] = rhs.m_dims[0];
         m_dims[1] = rhs.m_dims[1];
         m_dims[2] = rhs.m_dims[2];
@@ -131,18 +281,20 @@ Grid3<T>& Grid3<T>::operator=(const Grid3& rhs)
     return *this;
 }
 
-template <typename T>
-Grid3<T>& Grid3<T>::operator=(Grid3&& rhs)
+template <typename T, typename Indexing>
+Grid3<T, Indexing>& Grid3<T, Indexing>::operator=(Grid3&& rhs)
 {
     if (this != &rhs) {
         if (m_data) {
-            delete [] m_data;
+            grid_delete(m_data, storage_size());
         }
 
+        m_index = rhs.m_index;
         m_data = rhs.m_data;
         m_dims[0] = rhs.m_dims[0];
         m_dims[1] = rhs.m_dims[1];
         m_dims[2] = rhs.m_dims[2];
+        rhs.m_index.init(0, 0, 0);
         rhs.m_data = nullptr;
         rhs.m_dims[0] = 0;
         rhs.m_dims[1] = 0;
@@ -151,24 +303,30 @@ Grid3<T>& Grid3<T>::operator=(Grid3&& rhs)
     return *this;
 }
 
-template <typename T>
-void Grid3<T>::assign(
+template <typename T, typename Indexing>
+void Grid3<T, Indexing>::assign(
     size_type xdim,
     size_type ydim,
     size_type zdim,
     const T& value)
 {
-    size_type total_size = xdim * ydim * zdim;
-    resize(total_size);
+    size_type prev_size = storage_size();
+    m_index.init(xdim, ydim, zdim);
+    if (storage_size() != prev_size) {
+        if (m_data) {
+            grid_delete(m_data, prev_size);
+        }
+        m_data = grid_new<T>(storage_size());
+    }
     m_dims[0] = xdim;
     m_dims[1] = ydim;
     m_dims[2] = zdim;
-    std::fill(m_data, m_data + total_size, value);
+    std::fill(m_data, m_data + storage_size(), value);
 }
 
-template <typename T>
-typename Grid3<T>::reference
-Grid3<T>::at(size_type x, size_type y, size_type z)
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::reference
+Grid3<T, Indexing>::at(size_type x, size_type y, size_type z)
 {
     if (!in_bounds(x, y, z)) {
         throw std::out_of_range("Grid3<T>::at called with invalid coordinates");
@@ -176,9 +334,9 @@ Grid3<T>::at(size_type x, size_type y, size_type z)
     return m_data[coord_to_index(x, y, z)];
 }
 
-template <typename T>
-typename Grid3<T>::const_reference
-Grid3<T>::at(size_type x, size_type y, size_type z) const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reference
+Grid3<T, Indexing>::at(size_type x, size_type y, size_type z) const
 {
     if (!in_bounds(x, y, z)) {
         throw std::out_of_range("Grid3<T>::at called with invalid coordinates");
@@ -186,164 +344,171 @@ Grid3<T>::at(size_type x, size_type y, size_type z) const
     return m_data[coord_to_index(x, y, z)];
 }
 
-template <typename T>
-typename Grid3<T>::reference
-Grid3<T>::operator[](size_type pos)
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::reference
+Grid3<T, Indexing>::operator[](size_type pos)
 {
     return m_data[pos];
 }
 
-template <typename T>
-typename Grid3<T>::const_reference
-Grid3<T>::operator[](size_type pos) const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reference
+Grid3<T, Indexing>::operator[](size_type pos) const
 {
     return m_data[pos];
 }
 
-template <typename T>
-typename Grid3<T>::reference
-Grid3<T>::operator()(size_type x, size_type y, size_type z)
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::reference
+Grid3<T, Indexing>::operator()(size_type x, size_type y, size_type z)
 {
     return m_data[coord_to_index(x, y, z)];
 }
 
-template <typename T>
-typename Grid3<T>::const_reference
-Grid3<T>::operator()(size_type x, size_type y, size_type z) const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reference
+Grid3<T, Indexing>::operator()(size_type x, size_type y, size_type z) const
 {
     return m_data[coord_to_index(x, y, z)];
 }
 
-template <typename T>
-T* Grid3<T>::data()
+template <typename T, typename Indexing>
+T* Grid3<T, Indexing>::data()
 {
     return m_data;
 }
 
-template <typename T>
-const T* Grid3<T>::data() const
+template <typename T, typename Indexing>
+const T* Grid3<T, Indexing>::data() const
 {
     return m_data;
 }
 
-template <typename T>
-typename Grid3<T>::iterator Grid3<T>::begin()
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::iterator Grid3<T, Indexing>::begin()
 {
     return m_data;
 }
 
-template <typename T>
-typename Grid3<T>::const_iterator Grid3<T>::begin() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_iterator Grid3<T, Indexing>::begin() const
 {
     return m_data;
 }
 
-template <typename T>
-typename Grid3<T>::const_iterator Grid3<T>::cbegin() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_iterator Grid3<T, Indexing>::cbegin() const
 {
     return m_data;
 }
 
-template <typename T>
-typename Grid3<T>::iterator Grid3<T>::end()
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::iterator Grid3<T, Indexing>::end()
 {
-    return m_data + size();
+    return m_data + storage_size();
 }
 
-template <typename T>
-typename Grid3<T>::const_iterator Grid3<T>::end() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_iterator Grid3<T, Indexing>::end() const
 {
-    return m_data + size();
+    return m_data + storage_size();
 }
 
-template <typename T>
-typename Grid3<T>::const_iterator Grid3<T>::cend() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_iterator Grid3<T, Indexing>::cend() const
 {
-    return m_data + size();
+    return m_data + storage_size();
 }
 
-template <typename T>
-typename Grid3<T>::reverse_iterator Grid3<T>::rbegin()
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::reverse_iterator Grid3<T, Indexing>::rbegin()
 {
     // TODO: implement
     return reverse_iterator(begin());
 }
 
-template <typename T>
-typename Grid3<T>::const_reverse_iterator
-Grid3<T>::rbegin() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reverse_iterator
+Grid3<T, Indexing>::rbegin() const
 {
     // TODO: implement
     return const_reverse_iterator(begin());
 }
 
-template <typename T>
-typename Grid3<T>::const_reverse_iterator
-Grid3<T>::crbegin() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reverse_iterator
+Grid3<T, Indexing>::crbegin() const
 {
     // TODO: implement
     return const_reverse_iterator(begin());
 }
 
-template <typename T>
-typename Grid3<T>::reverse_iterator Grid3<T>::rend()
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::reverse_iterator Grid3<T, Indexing>::rend()
 {
     // TODO: implement
     return reverse_iterator(end());
 }
 
-template <typename T>
-typename Grid3<T>::const_reverse_iterator
-Grid3<T>::rend() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reverse_iterator
+Grid3<T, Indexing>::rend() const
 {
     // TODO: implement
     return const_reverse_iterator(end());
 }
 
-template <typename T>
-typename Grid3<T>::const_reverse_iterator
-Grid3<T>::crend() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::const_reverse_iterator
+Grid3<T, Indexing>::crend() const
 {
     // TODO: implement
     return const_reverse_iterator(end());
 }
 
-template <typename T>
-typename Grid3<T>::size_type Grid3<T>::size() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::size_type Grid3<T, Indexing>::size() const
 {
     return m_dims[0] * m_dims[1] * m_dims[2];
 }
 
-template <typename T>
-typename Grid3<T>::size_type Grid3<T>::max_size() const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::size_type Grid3<T, Indexing>::max_size() const
 {
     return std::numeric_limits<size_type>::max();
 }
 
-template <typename T>
-void Grid3<T>::clear()
+template <typename T, typename Indexing>
+void Grid3<T, Indexing>::clear()
 {
     if (m_data) {
-        delete [] m_data;
+        grid_delete(m_data, storage_size());
         m_data = nullptr;
     }
+    m_index.init(0, 0, 0);
     m_dims[0] = 0;
     m_dims[1] = 0;
     m_dims[2] = 0;
 }
 
-template <typename T>
-void Grid3<T>::resize(size_type xdim, size_type ydim, size_type zdim)
+template <typename T, typename Indexing>
+void Grid3<T, Indexing>::resize(size_type xdim, size_type ydim, size_type zdim)
 {
-    size_type total_size = xdim * ydim * zdim;
-    resize(total_size);
+    size_type prev_size = storage_size();
+    m_index.init(xdim, ydim, zdim);
+    if (storage_size() != prev_size) {
+        if (m_data) {
+            grid_delete(m_data, prev_size);
+        }
+        m_data = grid_new<T>(storage_size());
+    }
     m_dims[0] = xdim;
     m_dims[1] = ydim;
     m_dims[2] = zdim;
 }
 
-template <typename T>
-void Grid3<T>::resize(
+template <typename T, typename Indexing>
+void Grid3<T, Indexing>::resize(
     size_type xdim,
     size_type ydim,
     size_type zdim,
@@ -352,49 +517,36 @@ void Grid3<T>::resize(
     assign(xdim, ydim, zdim, value);
 }
 
-template <typename T>
-void Grid3<T>::swap(Grid3& other)
+template <typename T, typename Indexing>
+void Grid3<T, Indexing>::swap(Grid3& other)
 {
     // TODO: implement
 }
 
-template <typename T>
-typename Grid3<T>::size_type
-Grid3<T>::coord_to_index(size_type x, size_type y, size_type z) const
+template <typename T, typename Indexing>
+typename Grid3<T, Indexing>::size_type
+Grid3<T, Indexing>::coord_to_index(size_type x, size_type y, size_type z) const
 {
-    return m_dims[2] * (x * m_dims[1] + y) + z;
+    return m_index.index(x, y, z);
 }
 
-template <typename T>
+template <typename T, typename Indexing>
 void
-Grid3<T>::index_to_coord(
+Grid3<T, Indexing>::index_to_coord(
     size_type i,
     size_type& x,
     size_type& y,
     size_type& z) const
 {
-    x = i / (m_dims[1] * m_dims[2]);
-    y = (i - x * m_dims[1] * m_dims[2]) / m_dims[2];
-    z = i - (x * m_dims[1] * m_dims[2]) - y * m_dims[2];
+    m_index.coord(i, x, y, z);
 }
 
-template <typename T>
-bool Grid3<T>::in_bounds(size_type x, size_type y, size_type z) const
+template <typename T, typename Indexing>
+bool Grid3<T, Indexing>::in_bounds(size_type x, size_type y, size_type z) const
 {
     return x < m_dims[0] & y < m_dims[1] & z < m_dims[2];
 }
 
-template <typename T>
-void Grid3<T>::resize(size_type count)
-{
-    if (size() != count) {
-        if (m_data) {
-            delete [] m_data;
-        }
-        m_data = new T[count];
-    }
-}
-
 } // namespace smpl
 
 #endif
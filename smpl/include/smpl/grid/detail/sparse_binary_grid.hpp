@@ -145,7 +145,8 @@ auto SparseBinaryGrid<Allocator>::operator()(
     y >>= 1;
     z >>= 1;
 
-    std::uint8_t curr = m_grid(x, y, z);
+    const CacheBlock& block = cache_block(x, y, z);
+    std::uint8_t curr = block.cells[cache_offset(x, y, z)];
 
     return (bool)(curr & mask);
 }
@@ -162,6 +163,10 @@ auto SparseBinaryGrid<Allocator>::operator()(
     y >>= 1;
     z >>= 1;
 
+    // the returned reference writes into the tree directly, behind the back
+    // of the query cache
+    cache_invalidate(x, y, z);
+
     std::uint8_t &curr = m_grid(x, y, z);
     return { &curr, mask };
 }
@@ -179,12 +184,14 @@ template <class Allocator>
 void SparseBinaryGrid<Allocator>::reset(bool value)
 {
     m_grid.reset(initval(value));
+    clear_query_cache();
 }
 
 template <class Allocator>
 void SparseBinaryGrid<Allocator>::assign(bool value)
 {
     m_grid.assign(initval(value));
+    clear_query_cache();
 }
 
 template <class Allocator>
@@ -204,6 +211,7 @@ void SparseBinaryGrid<Allocator>::set(
     // TODO(Andrew): should be able to check this within the call to set_lazy
     if (curr != next) {
         m_grid.set(x, y, z, next);
+        cache_update(x, y, z, next);
     }
 }
 
@@ -222,6 +230,7 @@ void SparseBinaryGrid<Allocator>::set_lazy(
     std::uint8_t next = data ? (curr | mask) : (curr & ~mask);
     if (curr != next) {
         m_grid.set_lazy(x, y, z, next);
+        cache_update(x, y, z, next);
     }
 }
 
@@ -245,6 +254,7 @@ void SparseBinaryGrid<Allocator>::resize(
     size_type size_z)
 {
     m_grid.resize(reduced(size_x), reduced(size_y), reduced(size_z));
+    clear_query_cache();
 }
 
 template <class Allocator>
@@ -255,6 +265,7 @@ void SparseBinaryGrid<Allocator>::resize(
     bool value)
 {
     m_grid.resize(reduced(size_x), reduced(size_y), reduced(size_z), initval(value));
+    clear_query_cache();
 }
 
 template <class Allocator>
@@ -293,6 +304,133 @@ std::uint8_t SparseBinaryGrid<Allocator>::get_mask(int x, int y, int z) const
     return 1 << ((cx << 2) | (cy << 1) | (cz));
 }
 
+template <class Allocator>
+const typename SparseBinaryGrid<Allocator>::index_type
+SparseBinaryGrid<Allocator>::CacheBlockDim;
+
+template <class Allocator>
+const typename SparseBinaryGrid<Allocator>::size_type
+SparseBinaryGrid<Allocator>::CacheCapacity;
+
+template <class Allocator>
+void SparseBinaryGrid<Allocator>::clear_query_cache() const
+{
+    m_cache_blocks.clear();
+    m_cache_index.clear();
+}
+
+// Pack reduced block coordinates into a cache key.
+template <class Allocator>
+std::uint64_t SparseBinaryGrid<Allocator>::cache_key(
+    index_type x,
+    index_type y,
+    index_type z)
+{
+    const std::uint64_t bx = (std::uint64_t)(x / CacheBlockDim);
+    const std::uint64_t by = (std::uint64_t)(y / CacheBlockDim);
+    const std::uint64_t bz = (std::uint64_t)(z / CacheBlockDim);
+    return (bx << 42) | (by << 21) | bz;
+}
+
+// Return the position of a reduced cell within its block's dense storage.
+template <class Allocator>
+auto SparseBinaryGrid<Allocator>::cache_offset(
+    index_type x,
+    index_type y,
+    index_type z) -> size_type
+{
+    return ((x & (CacheBlockDim - 1)) << 6) |
+            ((y & (CacheBlockDim - 1)) << 3) |
+            (z & (CacheBlockDim - 1));
+}
+
+// Return the cached block covering a reduced cell, materializing it from the
+// tree on a miss and evicting the least-recently-used block at capacity.
+template <class Allocator>
+auto SparseBinaryGrid<Allocator>::cache_block(
+    index_type x,
+    index_type y,
+    index_type z) const -> const CacheBlock&
+{
+    const std::uint64_t key = cache_key(x, y, z);
+
+    auto it = m_cache_index.find(key);
+    if (it != m_cache_index.end()) {
+        CacheBlock& block = m_cache_blocks[it->second];
+        block.stamp = ++m_cache_stamp;
+        return block;
+    }
+
+    size_type slot;
+    if (m_cache_blocks.size() < CacheCapacity) {
+        slot = m_cache_blocks.size();
+        m_cache_blocks.emplace_back();
+    } else {
+        slot = 0;
+        for (size_type i = 1; i < m_cache_blocks.size(); ++i) {
+            if (m_cache_blocks[i].stamp < m_cache_blocks[slot].stamp) {
+                slot = i;
+            }
+        }
+        m_cache_index.erase(m_cache_blocks[slot].key);
+    }
+
+    CacheBlock& block = m_cache_blocks[slot];
+    block.key = key;
+    block.stamp = ++m_cache_stamp;
+
+    const index_type bx = (x / CacheBlockDim) * CacheBlockDim;
+    const index_type by = (y / CacheBlockDim) * CacheBlockDim;
+    const index_type bz = (z / CacheBlockDim) * CacheBlockDim;
+    std::uint8_t* cell = block.cells;
+    for (index_type dx = 0; dx < CacheBlockDim; ++dx) {
+    for (index_type dy = 0; dy < CacheBlockDim; ++dy) {
+    for (index_type dz = 0; dz < CacheBlockDim; ++dz) {
+        *cell++ = m_grid.get(bx + dx, by + dy, bz + dz);
+    }
+    }
+    }
+
+    m_cache_index[key] = slot;
+    return block;
+}
+
+// Write a reduced cell's new value through to its block, if cached.
+template <class Allocator>
+void SparseBinaryGrid<Allocator>::cache_update(
+    index_type x,
+    index_type y,
+    index_type z,
+    std::uint8_t val) const
+{
+    auto it = m_cache_index.find(cache_key(x, y, z));
+    if (it != m_cache_index.end()) {
+        m_cache_blocks[it->second].cells[cache_offset(x, y, z)] = val;
+    }
+}
+
+// Drop the block covering a reduced cell, if cached.
+template <class Allocator>
+void SparseBinaryGrid<Allocator>::cache_invalidate(
+    index_type x,
+    index_type y,
+    index_type z) const
+{
+    auto it = m_cache_index.find(cache_key(x, y, z));
+    if (it == m_cache_index.end()) {
+        return;
+    }
+
+    const size_type slot = it->second;
+    const size_type last = m_cache_blocks.size() - 1;
+    m_cache_index.erase(it);
+    if (slot != last) {
+        m_cache_blocks[slot] = m_cache_blocks[last];
+        m_cache_index[m_cache_blocks[slot].key] = slot;
+    }
+    m_cache_blocks.pop_back();
+}
+
 } // namespace smpl
 
 #endif
@@ -205,6 +205,7 @@ SparseGrid<T, Allocator>::reset(const T& value)
 {
     m_tree.clear();
     m_tree.root()->value = value;
+    m_prune_queue.clear();
 }
 
 template <class T, class Allocator>
@@ -230,10 +231,117 @@ SparseGrid<T, Allocator>::set_lazy(
     set_node_lazy(m_max_depth, m_tree.root(), x, y, z, data);
 }
 
+/// Reset the grid so that all cells have the value \p background, then set the
+/// cells in [first, last) to \p value, building the underlying octree in a
+/// single streaming pass. The cells must be unique and sorted by morton code
+/// (bits of x, y, and z interleaved with x most significant), so that cells
+/// sharing a subtree at any level are adjacent in the sequence. The cell type
+/// must provide x, y, and z members. Subtrees completely covered by the input
+/// cells are represented by a single node, so the resulting octree is fully
+/// pruned without ever expanding nodes inside uniform regions.
+template <class T, class Allocator>
+template <class RandomIt>
+void
+SparseGrid<T, Allocator>::assign_sorted(
+    RandomIt first, RandomIt last,
+    const T& background, const T& value)
+{
+    reset(background);
+    if (first == last || std::equal_to<T>()(background, value)) {
+        return;
+    }
+    build_sorted(m_max_depth, m_tree.root(), first, last, value);
+}
+
+template <class T, class Allocator>
+void
+SparseGrid<T, Allocator>::set_incremental(
+    index_type x, index_type y, index_type z, const T& data)
+{
+    node_type* n = m_tree.root();
+    node_type* parent = nullptr;
+    int rdepth = m_max_depth;
+
+    for (;;) {
+        if (!rdepth) {
+            if (!std::equal_to<T>()(n->value, data)) {
+                n->value = data;
+                if (parent != nullptr && collapsible_leaves(parent)) {
+                    m_prune_queue.push_back(PruneCandidate{ x, y, z, 1 });
+                }
+            }
+            break;
+        }
+
+        if (!n->children) {
+            if (std::equal_to<T>()(data, n->value)) {
+                break; // the whole subtree already holds this value
+            }
+            m_tree.expand_node(n);
+        }
+
+        parent = n;
+        --rdepth;
+        index_type cidx =
+                (((x >> rdepth) & 1) << 2) |
+                (((y >> rdepth) & 1) << 1) |
+                ((z >> rdepth) & 1);
+        n = &n->children[cidx];
+    }
+
+    prune_incremental(DrainPerWrite);
+}
+
+template <class T, class Allocator>
+auto SparseGrid<T, Allocator>::prune_incremental(size_type max_candidates)
+    -> size_type
+{
+    size_type collapsed = 0;
+    while (max_candidates != 0 && !m_prune_queue.empty()) {
+        --max_candidates;
+        PruneCandidate c = m_prune_queue.back();
+        m_prune_queue.pop_back();
+
+        node_type* n = m_tree.root();
+        int rdepth = m_max_depth;
+        while (rdepth > c.rdepth && n->children) {
+            --rdepth;
+            index_type cidx =
+                    (((c.x >> rdepth) & 1) << 2) |
+                    (((c.y >> rdepth) & 1) << 1) |
+                    ((c.z >> rdepth) & 1);
+            n = &n->children[cidx];
+        }
+
+        // stale if an ancestor collapsed first or the siblings diverged
+        // again after the candidate was recorded
+        if (rdepth != c.rdepth || !n->children || !collapsible_leaves(n)) {
+            continue;
+        }
+
+        m_tree.collapse_node(n, n->children[0].value);
+        ++collapsed;
+
+        // the collapse may have made the parent's children uniform
+        if (c.rdepth + 1 <= m_max_depth) {
+            m_prune_queue.push_back(
+                    PruneCandidate{ c.x, c.y, c.z, c.rdepth + 1 });
+        }
+    }
+    return collapsed;
+}
+
+template <class T, class Allocator>
+auto SparseGrid<T, Allocator>::pending_prune_candidates() const -> size_type
+{
+    return m_prune_queue.size();
+}
+
 template <class T, class Allocator>
 void SparseGrid<T, Allocator>::prune()
 {
     prune(m_tree.root());
+    m_prune_queue.clear();
 }
 
 template <class T, class Allocator>
@@ -255,6 +363,7 @@ SparseGrid<T, Allocator>::resize(
     m_size[1] = size_y;
     m_size[2] = size_z;
     m_max_depth = compute_max_depth(size_x, size_y, size_z);
+    m_prune_queue.clear();
 }
 
 template <class T, class Allocator>
@@ -276,6 +385,90 @@ SparseGrid<T, Allocator>::get(index_type x, index_type y, index_type z) const
     return get_node(m_max_depth, m_tree.root(), x, y, z)->value;
 }
 
+/// Return the value of the cell at (x, y, z), along with the coordinate range
+/// [first, last) of the leaf node storing it. All cells within the returned
+/// range share the returned value. The range is invalidated by any subsequent
+/// modification of the grid.
+template <class T, class Allocator>
+typename SparseGrid<T, Allocator>::const_reference
+SparseGrid<T, Allocator>::get_leaf(
+    index_type x, index_type y, index_type z,
+    index_type& first_x, index_type& first_y, index_type& first_z,
+    index_type& last_x, index_type& last_y, index_type& last_z) const
+{
+    int rdepth = m_max_depth;
+    const node_type* n = m_tree.root();
+    first_x = first_y = first_z = 0;
+    while (rdepth && n->children) {
+        --rdepth;
+
+        index_type x_loc = x >> rdepth;
+        index_type y_loc = y >> rdepth;
+        index_type z_loc = z >> rdepth;
+        index_type cidx = x_loc << 2 | y_loc << 1 | z_loc;
+
+        n = &n->children[cidx];
+        first_x += x_loc << rdepth;
+        first_y += y_loc << rdepth;
+        first_z += z_loc << rdepth;
+        x -= x_loc << rdepth;
+        y -= y_loc << rdepth;
+        z -= z_loc << rdepth;
+    }
+
+    last_x = first_x + (1 << rdepth);
+    last_y = first_y + (1 << rdepth);
+    last_z = first_z + (1 << rdepth);
+    return n->value;
+}
+
+template <class T, class Allocator>
+SparseGrid<T, Allocator>::unique_cursor::unique_cursor(SparseGrid* grid) :
+    m_grid(grid),
+    m_x(-1), // force a full descent on the first access
+    m_y(-1),
+    m_z(-1)
+{
+    m_path[0] = grid->m_tree.root();
+}
+
+template <class T, class Allocator>
+typename SparseGrid<T, Allocator>::reference
+SparseGrid<T, Allocator>::unique_cursor::operator()(
+    index_type x, index_type y, index_type z)
+{
+    const int max_depth = m_grid->m_max_depth;
+
+    // depth of the deepest retained node whose subtree contains (x, y, z),
+    // from the highest differing coordinate bit against the previous access
+    const unsigned diff =
+            (unsigned)(x ^ m_x) | (unsigned)(y ^ m_y) | (unsigned)(z ^ m_z);
+    int rdepth = 0;
+    while (rdepth < max_depth && (diff >> rdepth)) {
+        ++rdepth;
+    }
+
+    node_type* n = m_path[max_depth - rdepth];
+    while (rdepth) {
+        --rdepth;
+
+        if (!n->children) {
+            m_grid->m_tree.expand_node(n);
+        }
+
+        index_type x_loc = (x >> rdepth) & 1;
+        index_type y_loc = (y >> rdepth) & 1;
+        index_type z_loc = (z >> rdepth) & 1;
+        n = &n->children[x_loc << 2 | y_loc << 1 | z_loc];
+        m_path[max_depth - rdepth] = n;
+    }
+
+    m_x = x;
+    m_y = y;
+    m_z = z;
+    return n->value;
+}
+
 /// Return the approximate number of bytes used by an equivalent dense grid.
 template <class T, class Allocator>
 template <class Pred>
@@ -454,7 +647,9 @@ SparseGrid<T, Allocator>::set_node(
             z - (z_loc << rdepth),
             value))
     {
-        if (collapsible(n)) {
+        // the siblings must be leaves: an internal sibling carries a stale
+        // value, and collapsing through it would discard its subtree
+        if (collapsible_leaves(n)) {
             m_tree.collapse_node(n, value);
             return true;
         }
@@ -536,6 +731,47 @@ SparseGrid<T, Allocator>::create_node(
             z - (z_loc << rdepth));
 }
 
+template <class T, class Allocator>
+template <class RandomIt>
+void
+SparseGrid<T, Allocator>::build_sorted(
+    int rdepth,
+    node_type* n,
+    RandomIt first,
+    RandomIt last,
+    const T& value)
+{
+    // a subtree completely covered by input cells becomes a single leaf; the
+    // covered check relies on the input cells being unique
+    const size_type span = (size_type)(last - first);
+    if (!rdepth || span == (size_type)1 << (3 * rdepth)) {
+        n->value = value;
+        return;
+    }
+
+    --rdepth;
+
+    // cells are morton-sorted, so the cells of each child subtree occupy a
+    // contiguous subrange, found by scanning for the next change in child
+    // index; children receiving no cells retain the background value
+    m_tree.expand_node(n);
+    RandomIt it = first;
+    while (it != last) {
+        const index_type cidx =
+                (((it->x >> rdepth) & 1) << 2) |
+                (((it->y >> rdepth) & 1) << 1) |
+                ((it->z >> rdepth) & 1);
+        RandomIt cfirst = it;
+        do {
+            ++it;
+        } while (it != last &&
+                ((((it->x >> rdepth) & 1) << 2) |
+                (((it->y >> rdepth) & 1) << 1) |
+                ((it->z >> rdepth) & 1)) == cidx);
+        build_sorted(rdepth, &n->children[cidx], cfirst, it, value);
+    }
+}
+
 template <class T, class Allocator>
 bool SparseGrid<T, Allocator>::collapsible(node_type* n) const
 {
@@ -548,6 +784,22 @@ bool SparseGrid<T, Allocator>::collapsible(node_type* n) const
     return true;
 }
 
+// Like collapsible(), but additionally require every child to be a leaf, the
+// precondition for collapse_node() to reclaim the subtree without leaking
+// grandchildren. Incremental collapses check this directly rather than
+// relying on a bottom-up sweep to have pruned the children first.
+template <class T, class Allocator>
+bool SparseGrid<T, Allocator>::collapsible_leaves(node_type* n) const
+{
+    assert(n->children);
+    for (node_type* c = n->children; c != n->children + 8; ++c) {
+        if (c->children) {
+            return false;
+        }
+    }
+    return collapsible(n);
+}
+
 template <class T, class Allocator>
 bool SparseGrid<T, Allocator>::prune(node_type* n)
 {
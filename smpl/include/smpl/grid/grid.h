@@ -37,7 +37,61 @@
 
 namespace smpl {
 
-template <typename T>
+/// Indexing policy for Grid3 which lays out elements in row-major order, with
+/// z the fastest-varying coordinate.
+class RowMajorIndexing
+{
+public:
+
+    typedef std::size_t size_type;
+
+    void init(size_type xdim, size_type ydim, size_type zdim);
+
+    /// Return the number of storage elements required for the grid.
+    size_type size() const;
+
+    size_type index(size_type x, size_type y, size_type z) const;
+    void coord(size_type i, size_type& x, size_type& y, size_type& z) const;
+
+private:
+
+    size_type m_dims[3];
+};
+
+/// Indexing policy for Grid3 which lays out elements along a Morton (Z-order)
+/// curve, so that coordinates nearby in all three dimensions map to nearby
+/// storage locations. Encoding and decoding use the BMI2 pdep/pext
+/// instructions when available and a mask-walking fallback otherwise.
+///
+/// Each dimension is padded to the next power of two, so the storage size
+/// reported by size() may exceed the product of the grid dimensions; the
+/// padding elements are initialized alongside the rest of the storage but
+/// correspond to no valid coordinate.
+class MortonIndexing
+{
+public:
+
+    typedef std::size_t size_type;
+
+    void init(size_type xdim, size_type ydim, size_type zdim);
+
+    /// Return the number of storage elements required for the grid, including
+    /// the padding introduced by rounding each dimension up to a power of two.
+    size_type size() const;
+
+    size_type index(size_type x, size_type y, size_type z) const;
+    void coord(size_type i, size_type& x, size_type& y, size_type& z) const;
+
+private:
+
+    size_type m_masks[3];   // per-dimension bit scatter masks
+    size_type m_size;
+
+    static size_type scatter(size_type v, size_type mask);
+    static size_type gather(size_type v, size_type mask);
+};
+
+template <typename T, typename Indexing = RowMajorIndexing>
 class Grid3
 {
 public:
@@ -130,15 +184,13 @@ public:
 
 private:
 
+    Indexing m_index;
     value_type* m_data;
     size_type m_dims[3];
 
-    void resize(size_type count);
+    size_type storage_size() const { return m_index.size(); }
 };
 
-template <typename T>
-void swap(Grid3<T>& lhs, Grid3<T>& rhs);
-
 } // namespace smpl
 
 #include "detail/grid.hpp"
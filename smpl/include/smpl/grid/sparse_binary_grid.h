@@ -35,13 +35,15 @@
 // standard includes
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 // project includes
 #include <smpl/grid/sparse_grid.h>
 
 namespace smpl {
 
-template <class Allocator = std::allocator<std::uint8_t>>
+template <class Allocator = PoolAllocator<std::uint8_t>>
 class SparseBinaryGrid
 {
     struct packed_bool_ref;
@@ -118,6 +120,19 @@ public:
     template <typename Callable>
     void accept_coords(Callable c);
 
+    /// \name Query Cache
+    ///@{
+
+    /// \brief Drop all cached query blocks.
+    ///
+    /// Const queries read through a small cache of dense blocks materialized
+    /// from recently-touched regions of the tree (see CacheBlock). The cache
+    /// is maintained automatically by the modifiers; manual clearing is only
+    /// useful to release the cache storage.
+    void clear_query_cache() const;
+
+    ///@}
+
     const TreeType& tree() const { return m_grid.tree(); }
 
 private:
@@ -142,9 +157,34 @@ private:
     SparseGrid<std::uint8_t, Allocator> m_grid;
     size_type m_osize[3];
 
+    // Read-through cache of recently queried regions. Each block is a dense
+    // copy of the 8^3 reduced cells spanning a 16^3 voxel region, so
+    // wavefront algorithms and sphere sweeps that revisit a region pay the
+    // tree walk once per block rather than once per query. Blocks are evicted
+    // least-recently-used; at the default capacity the cache holds 32 KB.
+    struct CacheBlock
+    {
+        std::uint64_t key;      // packed block coordinates
+        std::uint64_t stamp;    // last access time for lru eviction
+        std::uint8_t cells[8 * 8 * 8];
+    };
+
+    static const index_type CacheBlockDim = 8;  // reduced cells per side
+    static const size_type CacheCapacity = 64;  // blocks retained
+
+    mutable std::vector<CacheBlock> m_cache_blocks;
+    mutable std::unordered_map<std::uint64_t, size_type> m_cache_index;
+    mutable std::uint64_t m_cache_stamp = 0;
+
     std::uint8_t initval(bool value) const;
     size_type reduced(size_type s) const;
     std::uint8_t get_mask(int x, int y, int z) const;
+
+    static std::uint64_t cache_key(index_type x, index_type y, index_type z);
+    static size_type cache_offset(index_type x, index_type y, index_type z);
+    const CacheBlock& cache_block(index_type x, index_type y, index_type z) const;
+    void cache_update(index_type x, index_type y, index_type z, std::uint8_t val) const;
+    void cache_invalidate(index_type x, index_type y, index_type z) const;
 };
 
 } // namespace smpl
@@ -34,9 +34,11 @@
 
 // standard includes
 #include <memory>
+#include <vector>
 
 // project includes
 #include <smpl/octree/octree.h>
+#include <smpl/octree/pool_allocator.h>
 
 namespace smpl {
 
@@ -68,7 +70,13 @@ namespace smpl {
 /// set() to skip automatic pruning of nodes. The underlying octree may then be
 /// explicitly pruned by calling the prune() function, which will prune all
 /// nodes where applicable for maximum compression.
-template <class T, class Allocator = std::allocator<T>>
+///
+/// For long-running updates where neither per-write pruning nor periodic
+/// full-tree sweeps are acceptable, set_incremental() queues subtrees that a
+/// write makes uniform and drains a bounded number of queued collapses per
+/// write, holding the tree near-minimal with O(1) amortized pruning work per
+/// update.
+template <class T, class Allocator = PoolAllocator<T>>
 class SparseGrid
 {
 public:
@@ -118,6 +126,37 @@ public:
     reference operator()(index_type x, index_type y, index_type z);
 
     const_reference get(index_type x, index_type y, index_type z) const;
+
+    const_reference get_leaf(
+        index_type x, index_type y, index_type z,
+        index_type& first_x, index_type& first_y, index_type& first_z,
+        index_type& last_x, index_type& last_y, index_type& last_z) const;
+
+    /// A cursor for sequences of unique leaf accesses, as through the
+    /// non-const operator(). The cursor retains the path of nodes visited on
+    /// the way to the most recently accessed cell, so that accesses to
+    /// nearby cells (e.g. cells visited in morton order) only expand and
+    /// descend the unshared suffix of the path. Accesses through a cursor
+    /// never collapse nodes, so cursor accesses do not invalidate one
+    /// another; any other modification of the grid invalidates the cursor.
+    class unique_cursor
+    {
+    public:
+
+        reference operator()(index_type x, index_type y, index_type z);
+
+    private:
+
+        friend class SparseGrid<T, Allocator>;
+
+        explicit unique_cursor(SparseGrid* grid);
+
+        SparseGrid* m_grid;
+        node_type* m_path[1 + 8 * sizeof(index_type)];
+        index_type m_x, m_y, m_z;
+    };
+
+    unique_cursor make_unique_cursor() { return unique_cursor(this); }
     ///@}
 
     /// \name Modifiers
@@ -128,6 +167,28 @@ public:
     void set(index_type x, index_type y, index_type z, const T& data);
     void set_lazy(index_type x, index_type y, index_type z, const T& data);
 
+    /// Set the value of a cell, deferring compression to a small work queue
+    /// instead of pruning in place: when the write makes the cell's siblings
+    /// uniform, the parent subtree is queued as a collapse candidate, and a
+    /// bounded number of queued candidates is drained before returning. Each
+    /// collapse queues the collapsed node's parent in turn, so uniform
+    /// regions converge to single nodes across subsequent writes and the
+    /// tree stays near-minimal continuously, without the full-tree sweep of
+    /// prune() and without the per-write path collapses of set().
+    void set_incremental(index_type x, index_type y, index_type z, const T& data);
+
+    /// Drain up to \p max_candidates queued collapse candidates, collapsing
+    /// those still uniform and skipping those invalidated by later writes.
+    /// Returns the number of nodes collapsed.
+    size_type prune_incremental(size_type max_candidates);
+
+    size_type pending_prune_candidates() const;
+
+    template <class RandomIt>
+    void assign_sorted(
+        RandomIt first, RandomIt last,
+        const T& background, const T& value);
+
     void prune();
 
     template <class UnaryPredicate>
@@ -197,8 +258,33 @@ private:
         index_type y,
         index_type z);
 
+    template <class RandomIt>
+    void build_sorted(
+        int rdepth,
+        node_type* n,
+        RandomIt first,
+        RandomIt last,
+        const T& value);
+
+    // a collapse candidate recorded during set_incremental(): any cell of
+    // the candidate subtree and the height of the subtree root above the
+    // cell level; candidates are re-descended when drained, so collapses
+    // elsewhere in the tree only ever make a candidate stale, never wrong
+    struct PruneCandidate
+    {
+        index_type x, y, z;
+        int rdepth;
+    };
+
+    std::vector<PruneCandidate> m_prune_queue;
+
+    // candidates drained per set_incremental() call
+    static const size_type DrainPerWrite = 2;
+
     bool collapsible(node_type* n) const;
 
+    bool collapsible_leaves(node_type* n) const;
+
     bool prune(node_type* n);
 
     template <class UnaryPredicate>
@@ -0,0 +1,325 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_INTRUSIVE_DARY_HEAP_HPP
+#define SMPL_INTRUSIVE_DARY_HEAP_HPP
+
+#include "../intrusive_dary_heap.h"
+
+#include <assert.h>
+#include <algorithm>
+
+namespace smpl {
+
+template <class T, int D, class Compare>
+intrusive_dary_heap<T, D, Compare>::intrusive_dary_heap(const compare& comp) :
+    m_data(1, nullptr),
+    m_comp(comp)
+{
+}
+
+template <class T, int D, class Compare>
+template <class InputIt>
+intrusive_dary_heap<T, D, Compare>::intrusive_dary_heap(
+    const compare& comp,
+    InputIt first,
+    InputIt last)
+:
+    m_data(),
+    m_comp(comp)
+{
+    make_heap(first, last);
+}
+
+template <class T, int D, class Compare>
+template <class InputIt>
+intrusive_dary_heap<T, D, Compare>::intrusive_dary_heap(
+    InputIt first,
+    InputIt last)
+:
+    m_data(),
+    m_comp()
+{
+    make_heap(first, last);
+}
+
+template <class T, int D, class Compare>
+intrusive_dary_heap<T, D, Compare>::intrusive_dary_heap(
+    intrusive_dary_heap&& o)
+:
+    m_data(std::move(o.m_data)),
+    m_comp(std::move(o.m_comp))
+{
+}
+
+template <class T, int D, class Compare>
+intrusive_dary_heap<T, D, Compare>&
+intrusive_dary_heap<T, D, Compare>::operator=(intrusive_dary_heap&& rhs)
+{
+    if (this != &rhs) {
+        m_data = std::move(rhs.m_data);
+        m_comp = std::move(rhs.m_comp);
+    }
+    return *this;
+}
+
+template <class T, int D, class Compare>
+T* intrusive_dary_heap<T, D, Compare>::min() const
+{
+    assert(m_data.size() > 1);
+    return m_data[1];
+}
+
+template <class T, int D, class Compare>
+typename intrusive_dary_heap<T, D, Compare>::const_iterator
+intrusive_dary_heap<T, D, Compare>::begin() const
+{
+    return m_data.begin() + 1;
+}
+
+template <class T, int D, class Compare>
+typename intrusive_dary_heap<T, D, Compare>::const_iterator
+intrusive_dary_heap<T, D, Compare>::end() const
+{
+    return m_data.end();
+}
+
+template <class T, int D, class Compare>
+bool intrusive_dary_heap<T, D, Compare>::empty() const
+{
+    return m_data.size() == 1;
+}
+
+template <class T, int D, class Compare>
+typename intrusive_dary_heap<T, D, Compare>::size_type
+intrusive_dary_heap<T, D, Compare>::size() const
+{
+    return m_data.size() - 1;
+}
+
+template <class T, int D, class Compare>
+typename intrusive_dary_heap<T, D, Compare>::size_type
+intrusive_dary_heap<T, D, Compare>::max_size() const
+{
+    return m_data.max_size() - 1;
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::reserve(size_type new_cap)
+{
+    m_data.reserve(new_cap + 1);
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::clear()
+{
+    for (size_t i = 1; i < m_data.size(); ++i) {
+        m_data[i]->m_heap_index = 0;
+    }
+    m_data.resize(1);
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::push(T* e)
+{
+    assert(e);
+    e->m_heap_index = m_data.size();
+    m_data.push_back(e);
+    percolate_up(m_data.size() - 1);
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::pop()
+{
+    assert(!empty());
+    m_data[1]->m_heap_index = 0;
+    m_data[1] = m_data.back();
+    m_data.pop_back();
+    percolate_down(1);
+}
+
+template <class T, int D, class Compare>
+bool intrusive_dary_heap<T, D, Compare>::contains(T* e)
+{
+    assert(e);
+    return e->m_heap_index != 0;
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::update(T* e)
+{
+    assert(e && contains(e));
+    erase(e);
+    push(e);
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::increase(T* e)
+{
+    assert(e && contains(e));
+    percolate_down(e->m_heap_index);
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::decrease(T* e)
+{
+    assert(e && contains(e));
+    percolate_up(e->m_heap_index);
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::erase(T* e)
+{
+    assert(e && contains(e));
+    size_type pos = e->m_heap_index;
+    m_data[pos] = m_data.back();
+    m_data[pos]->m_heap_index = pos;
+    e->m_heap_index = 0;
+    m_data.pop_back();
+    if (pos < m_data.size()) {
+        percolate_down(pos);
+        percolate_up(pos);
+    }
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::make()
+{
+    if (m_data.size() < 2) {
+        return;
+    }
+    for (auto i = parent(m_data.size() - 1); i >= 1; --i) {
+        percolate_down(i);
+    }
+}
+
+template <class T, int D, class Compare>
+void intrusive_dary_heap<T, D, Compare>::swap(intrusive_dary_heap& o)
+{
+    if (this != &o) {
+        using std::swap;
+        swap(m_data, o.m_data);
+        swap(m_comp, o.m_comp);
+    }
+}
+
+template <class T, int D, class Compare>
+template <class InputIt>
+void intrusive_dary_heap<T, D, Compare>::make_heap(InputIt first, InputIt last)
+{
+    auto n = std::distance(first, last);
+
+    m_data.clear();
+    m_data.reserve(n + 1);
+    m_data.push_back(nullptr);
+    m_data.insert(m_data.end(), first, last);
+
+    for (size_type i = 1; i < m_data.size(); ++i) {
+        m_data[i]->m_heap_index = i;
+    }
+
+    make();
+}
+
+template <class T, int D, class Compare>
+inline
+typename intrusive_dary_heap<T, D, Compare>::size_type
+intrusive_dary_heap<T, D, Compare>::parent(size_type index) const
+{
+    return (index - 2) / D + 1;
+}
+
+template <class T, int D, class Compare>
+inline
+typename intrusive_dary_heap<T, D, Compare>::size_type
+intrusive_dary_heap<T, D, Compare>::first_child(size_type index) const
+{
+    return D * (index - 1) + 2;
+}
+
+template <class T, int D, class Compare>
+inline
+void intrusive_dary_heap<T, D, Compare>::percolate_down(size_type pivot)
+{
+    size_type first = first_child(pivot);
+
+    T* tmp = m_data[pivot];
+    while (first < m_data.size()) {
+        // select the min over all children of the pivot
+        size_type last = std::min(first + D, m_data.size());
+        size_type s = first;
+        for (size_type c = first + 1; c < last; ++c) {
+            if (m_comp(*m_data[c], *m_data[s])) {
+                s = c;
+            }
+        }
+
+        if (m_comp(*m_data[s], *tmp)) {
+            m_data[pivot] = m_data[s];
+            m_data[pivot]->m_heap_index = pivot;
+            pivot = s;
+        } else {
+            break;
+        }
+
+        first = first_child(pivot);
+    }
+    m_data[pivot] = tmp;
+    m_data[pivot]->m_heap_index = pivot;
+}
+
+template <class T, int D, class Compare>
+inline
+void intrusive_dary_heap<T, D, Compare>::percolate_up(size_type pivot)
+{
+    T* tmp = m_data[pivot];
+    while (pivot != 1) {
+        size_type p = parent(pivot);
+        if (m_comp(*m_data[p], *tmp)) {
+            break;
+        }
+        m_data[pivot] = m_data[p];
+        m_data[pivot]->m_heap_index = pivot;
+        pivot = p;
+    }
+    m_data[pivot] = tmp;
+    m_data[pivot]->m_heap_index = pivot;
+}
+
+template <class T, int D, class Compare>
+void swap(
+    intrusive_dary_heap<T, D, Compare>& lhs,
+    intrusive_dary_heap<T, D, Compare>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace smpl
+
+#endif
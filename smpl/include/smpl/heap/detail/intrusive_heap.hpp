@@ -151,6 +151,37 @@ void intrusive_heap<T, Compare>::push(T* e)
     percolate_up(m_data.size() - 1);
 }
 
+template <class T, class Compare>
+template <class InputIt>
+void intrusive_heap<T, Compare>::push(InputIt first, InputIt last)
+{
+    const size_type old_size = m_data.size();
+    m_data.insert(m_data.end(), first, last);
+    const size_type n = m_data.size() - old_size;
+    if (n == 0) {
+        return;
+    }
+
+    for (size_type i = old_size; i < m_data.size(); ++i) {
+        assert(m_data[i]);
+        m_data[i]->m_heap_index = i;
+    }
+
+    // sifting the appended elements costs O(n log N) while a bottom-up
+    // rebuild costs O(N); rebuild once the batch is large enough for the
+    // sifts to overtake it
+    const size_type total = m_data.size() - 1;
+    if (n * (ilog2(total) + 1) < total) {
+        for (size_type i = old_size; i < m_data.size(); ++i) {
+            percolate_up(i);
+        }
+    } else {
+        for (auto i = total >> 1; i >= 1; --i) {
+            percolate_down(i);
+        }
+    }
+}
+
 template <class T, class Compare>
 void intrusive_heap<T, Compare>::pop()
 {
@@ -203,7 +234,14 @@ void intrusive_heap<T, Compare>::erase(T* e)
     m_data[pos]->m_heap_index = pos;
     e->m_heap_index = 0;
     m_data.pop_back();
-    percolate_down(pos);
+    // the element moved into the hole may belong either above or below it
+    if (pos < m_data.size()) {
+        if (pos > 1 && m_comp(*m_data[pos], *m_data[parent(pos)])) {
+            percolate_up(pos);
+        } else {
+            percolate_down(pos);
+        }
+    }
 }
 
 template <class T, class Compare>
@@ -0,0 +1,285 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_PAIRING_HEAP_HPP
+#define SMPL_PAIRING_HEAP_HPP
+
+#include "../pairing_heap.h"
+
+#include <assert.h>
+#include <utility>
+
+namespace smpl {
+
+template <class T, class Compare>
+pairing_heap<T, Compare>::pairing_heap(const compare& comp) :
+    m_root(nullptr),
+    m_size(0),
+    m_comp(comp)
+{
+}
+
+template <class T, class Compare>
+pairing_heap<T, Compare>::pairing_heap(pairing_heap&& o) :
+    m_root(o.m_root),
+    m_size(o.m_size),
+    m_comp(std::move(o.m_comp))
+{
+    o.m_root = nullptr;
+    o.m_size = 0;
+}
+
+template <class T, class Compare>
+pairing_heap<T, Compare>&
+pairing_heap<T, Compare>::operator=(pairing_heap&& rhs)
+{
+    if (this != &rhs) {
+        m_root = rhs.m_root;
+        m_size = rhs.m_size;
+        m_comp = std::move(rhs.m_comp);
+        rhs.m_root = nullptr;
+        rhs.m_size = 0;
+    }
+    return *this;
+}
+
+template <class T, class Compare>
+T* pairing_heap<T, Compare>::min() const
+{
+    assert(m_root);
+    return static_cast<T*>(m_root);
+}
+
+template <class T, class Compare>
+bool pairing_heap<T, Compare>::empty() const
+{
+    return m_root == nullptr;
+}
+
+template <class T, class Compare>
+typename pairing_heap<T, Compare>::size_type
+pairing_heap<T, Compare>::size() const
+{
+    return m_size;
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::clear()
+{
+    // reset the links of all elements so that contains() remains correct;
+    // descend through child links, then sibling links, and walk back up
+    // through prev links, which are kept intact until a subtree is done
+    pairing_heap_element* e = m_root;
+    while (e) {
+        pairing_heap_element* next;
+        if (e->m_child) {
+            next = e->m_child;
+            e->m_child = nullptr;
+        } else if (e->m_sibling) {
+            next = e->m_sibling;
+            e->m_sibling = nullptr;
+        } else {
+            next = e->m_prev;
+            e->m_prev = nullptr;
+        }
+        e = next;
+    }
+    m_root = nullptr;
+    m_size = 0;
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::push(T* e)
+{
+    assert(e && !contains(e));
+    m_root = m_root ? meld(m_root, e) : e;
+    ++m_size;
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::pop()
+{
+    assert(!empty());
+    pairing_heap_element* children = m_root->m_child;
+    m_root->m_child = nullptr;
+    if (children) {
+        children->m_prev = nullptr;
+    }
+    m_root = merge_pairs(children);
+    --m_size;
+}
+
+template <class T, class Compare>
+bool pairing_heap<T, Compare>::contains(T* e)
+{
+    assert(e);
+    return e == m_root || e->m_prev != nullptr;
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::update(T* e)
+{
+    assert(e && contains(e));
+    erase(e);
+    push(e);
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::increase(T* e)
+{
+    assert(e && contains(e));
+    erase(e);
+    push(e);
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::decrease(T* e)
+{
+    assert(e && contains(e));
+    if (e == m_root) {
+        return;
+    }
+    cut(e);
+    m_root = meld(m_root, e);
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::erase(T* e)
+{
+    assert(e && contains(e));
+    if (e == m_root) {
+        pop();
+        return;
+    }
+
+    cut(e);
+    pairing_heap_element* children = e->m_child;
+    e->m_child = nullptr;
+    if (children) {
+        children->m_prev = nullptr;
+        pairing_heap_element* sub = merge_pairs(children);
+        m_root = meld(m_root, sub);
+    }
+    --m_size;
+}
+
+template <class T, class Compare>
+void pairing_heap<T, Compare>::swap(pairing_heap& o)
+{
+    if (this != &o) {
+        using std::swap;
+        swap(m_root, o.m_root);
+        swap(m_size, o.m_size);
+        swap(m_comp, o.m_comp);
+    }
+}
+
+template <class T, class Compare>
+inline
+bool pairing_heap<T, Compare>::less(
+    pairing_heap_element* a,
+    pairing_heap_element* b)
+{
+    return m_comp(*static_cast<T*>(a), *static_cast<T*>(b));
+}
+
+// Meld two root elements, making the larger the leftmost child of the smaller.
+template <class T, class Compare>
+inline
+pairing_heap_element* pairing_heap<T, Compare>::meld(
+    pairing_heap_element* a,
+    pairing_heap_element* b)
+{
+    if (less(b, a)) {
+        std::swap(a, b);
+    }
+
+    b->m_sibling = a->m_child;
+    if (a->m_child) {
+        a->m_child->m_prev = b;
+    }
+    b->m_prev = a;
+    a->m_child = b;
+    return a;
+}
+
+// Combine a list of sibling subtrees into a single tree via the standard
+// two-pass pairing scheme: meld adjacent pairs left-to-right, then meld the
+// pair results right-to-left.
+template <class T, class Compare>
+pairing_heap_element* pairing_heap<T, Compare>::merge_pairs(
+    pairing_heap_element* first)
+{
+    if (!first) {
+        return nullptr;
+    }
+
+    pairing_heap_element* second = first->m_sibling;
+    first->m_sibling = nullptr;
+    first->m_prev = nullptr;
+    if (!second) {
+        return first;
+    }
+
+    pairing_heap_element* rest = second->m_sibling;
+    second->m_sibling = nullptr;
+    second->m_prev = nullptr;
+
+    pairing_heap_element* pair = meld(first, second);
+    pairing_heap_element* merged = merge_pairs(rest);
+    return merged ? meld(pair, merged) : pair;
+}
+
+// Unlink a non-root element from its parent and siblings.
+template <class T, class Compare>
+inline
+void pairing_heap<T, Compare>::cut(pairing_heap_element* e)
+{
+    assert(e->m_prev);
+    if (e->m_prev->m_child == e) {
+        e->m_prev->m_child = e->m_sibling;
+    } else {
+        e->m_prev->m_sibling = e->m_sibling;
+    }
+    if (e->m_sibling) {
+        e->m_sibling->m_prev = e->m_prev;
+    }
+    e->m_sibling = nullptr;
+    e->m_prev = nullptr;
+}
+
+template <class T, class Compare>
+void swap(pairing_heap<T, Compare>& lhs, pairing_heap<T, Compare>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // namespace smpl
+
+#endif
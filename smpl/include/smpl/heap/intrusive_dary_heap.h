@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_INTRUSIVE_DARY_HEAP_H
+#define SMPL_INTRUSIVE_DARY_HEAP_H
+
+#include <cstdlib>
+#include <vector>
+
+#include <smpl/heap/intrusive_heap.h>
+
+namespace smpl {
+
+/// Provides an intrusive d-ary heap implementation with the same interface as
+/// intrusive_heap. Objects inserted into the heap must derive from the
+/// \p heap_element class to implement efficient mutability. The implementation
+/// stores pointers to inserted objects, which must remain valid throughout the
+/// lifetime of the heap.
+///
+/// Compared to the binary heap, wider nodes (d = 4 or 8) shorten the tree and
+/// pack all the children examined during a sift-down into one or two cache
+/// lines, which tends to win on expansion-heavy workloads where pops dominate
+/// decrease-key operations.
+template <class T, int D, class Compare>
+class intrusive_dary_heap
+{
+public:
+
+    static_assert(std::is_base_of<heap_element, T>::value, "T must extend heap_element");
+    static_assert(D >= 2, "D must be at least 2");
+
+    typedef Compare compare;
+
+    typedef std::vector<T*> container_type;
+    typedef typename container_type::size_type size_type;
+
+    typedef typename container_type::iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+
+    intrusive_dary_heap(const compare& comp = compare());
+
+    template <class InputIt>
+    intrusive_dary_heap(InputIt first, InputIt last);
+
+    template <class InputIt>
+    intrusive_dary_heap(const compare& comp, InputIt first, InputIt last);
+
+    intrusive_dary_heap(const intrusive_dary_heap&) = delete;
+
+    intrusive_dary_heap(intrusive_dary_heap&& o);
+
+    intrusive_dary_heap& operator=(const intrusive_dary_heap&) = delete;
+    intrusive_dary_heap& operator=(intrusive_dary_heap&& rhs);
+
+    T* min() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    bool empty() const;
+    size_type size() const;
+    size_type max_size() const;
+    void reserve(size_type new_cap);
+
+    void clear();
+    void push(T* e);
+    void pop();
+    bool contains(T* e);
+    void update(T* e);
+    void increase(T* e);
+    void decrease(T* e);
+    void erase(T* e);
+
+    void make();
+
+    void swap(intrusive_dary_heap& o);
+
+private:
+
+    container_type m_data;
+    Compare m_comp;
+
+    template <class InputIt>
+    void make_heap(InputIt first, InputIt last);
+
+    size_type parent(size_type index) const;
+    size_type first_child(size_type index) const;
+
+    void percolate_down(size_type pivot);
+    void percolate_up(size_type pivot);
+};
+
+template <class T, int D, class Compare>
+void swap(
+    intrusive_dary_heap<T, D, Compare>& lhs,
+    intrusive_dary_heap<T, D, Compare>& rhs);
+
+} // namespace smpl
+
+#include "detail/intrusive_dary_heap.hpp"
+
+#endif
@@ -40,6 +40,9 @@ namespace smpl {
 template <class T, class Compare>
 class intrusive_heap;
 
+template <class T, int D, class Compare>
+class intrusive_dary_heap;
+
 struct heap_element
 {
 
@@ -51,6 +54,9 @@ private:
 
     template <class T, class Compare>
     friend class intrusive_heap;
+
+    template <class T, int D, class Compare>
+    friend class intrusive_dary_heap;
 };
 
 /// Provides an intrusive binary heap implementation. Objects inserted into the
@@ -111,6 +117,15 @@ public:
 
     void clear();
     void push(T* e);
+
+    /// Insert a batch of elements, appending them all before restoring the
+    /// heap property in one pass: small batches sift each appended element
+    /// up while large batches rebuild bottom-up, Floyd-style, in time linear
+    /// in the heap size. Cheaper than repeated push() when an expansion
+    /// produces many new elements.
+    template <class InputIt>
+    void push(InputIt first, InputIt last);
+
     void pop();
     bool contains(T* e);
     void update(T* e);
@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_PAIRING_HEAP_H
+#define SMPL_PAIRING_HEAP_H
+
+#include <cstdlib>
+#include <type_traits>
+
+namespace smpl {
+
+template <class T, class Compare>
+class pairing_heap;
+
+struct pairing_heap_element
+{
+
+    pairing_heap_element() :
+        m_child(nullptr), m_sibling(nullptr), m_prev(nullptr) { }
+
+private:
+
+    pairing_heap_element* m_child;      // leftmost child
+    pairing_heap_element* m_sibling;    // next younger sibling
+    // parent, if this is a leftmost child, otherwise the next older sibling;
+    // null if this element is a root or not in a heap
+    pairing_heap_element* m_prev;
+
+    template <class T, class Compare>
+    friend class pairing_heap;
+};
+
+/// Provides an intrusive pairing heap implementation. Objects inserted into
+/// the heap must derive from the \p pairing_heap_element class. The
+/// implementation stores pointers to inserted objects, which must remain valid
+/// throughout the lifetime of the heap.
+///
+/// The pairing heap provides constant time access to the minimum element,
+/// constant time insertion and decrease-key, and amortized logarithmic
+/// erasure of the minimum element. It suits searches where decrease-key
+/// operations outnumber pops, at the cost of pointer-chasing during pops.
+///
+/// The interface mirrors intrusive_heap, except that elements cannot be
+/// iterated and make() is unavailable, as the heap stores no contiguous
+/// element array.
+template <class T, class Compare>
+class pairing_heap
+{
+public:
+
+    static_assert(std::is_base_of<pairing_heap_element, T>::value, "T must extend pairing_heap_element");
+
+    typedef Compare compare;
+    typedef std::size_t size_type;
+
+    pairing_heap(const compare& comp = compare());
+
+    pairing_heap(const pairing_heap&) = delete;
+
+    pairing_heap(pairing_heap&& o);
+
+    pairing_heap& operator=(const pairing_heap&) = delete;
+    pairing_heap& operator=(pairing_heap&& rhs);
+
+    T* min() const;
+
+    bool empty() const;
+    size_type size() const;
+
+    void clear();
+    void push(T* e);
+    void pop();
+    bool contains(T* e);
+    void update(T* e);
+    void increase(T* e);
+    void decrease(T* e);
+    void erase(T* e);
+
+    void swap(pairing_heap& o);
+
+private:
+
+    pairing_heap_element* m_root;
+    size_type m_size;
+    Compare m_comp;
+
+    bool less(pairing_heap_element* a, pairing_heap_element* b);
+
+    pairing_heap_element* meld(
+        pairing_heap_element* a,
+        pairing_heap_element* b);
+
+    pairing_heap_element* merge_pairs(pairing_heap_element* first);
+
+    void cut(pairing_heap_element* e);
+};
+
+template <class T, class Compare>
+void swap(pairing_heap<T, Compare>& lhs, pairing_heap<T, Compare>& rhs);
+
+} // namespace smpl
+
+#include "detail/pairing_heap.hpp"
+
+#endif
@@ -33,6 +33,7 @@
 #define SMPL_BFS_HEURISTIC_H
 
 // standard includes
+#include <functional>
 #include <memory>
 
 // project includes
@@ -40,10 +41,11 @@
 #include <smpl/bfs3d/bfs3d.h>
 #include <smpl/debug/marker.h>
 #include <smpl/heuristic/robot_heuristic.h>
+#include <smpl/stats.h>
 
 namespace smpl {
 
-class BfsHeuristic : public RobotHeuristic
+class BfsHeuristic : public RobotHeuristic, public MemoryUsageProvider
 {
 public:
 
@@ -56,6 +58,50 @@ public:
     int costPerCell() const { return m_cost_per_cell; }
     void setCostPerCell(int cost);
 
+    /// \name Goal Wavefront Store
+    ///@{
+
+    /// Set the number of retired goal wavefronts retained so that returning
+    /// to a recently seen goal swaps its distances back in rather than
+    /// rerunning BFS. Trims the store if it exceeds the new capacity.
+    void setBfsStoreCapacity(size_t capacity);
+    size_t bfsStoreCapacity() const { return m_bfs_store_capacity; }
+    ///@}
+
+    /// \name Cooperative Refinement
+    ///@{
+
+    /// Enable or disable cooperative refinement. When enabled, heuristic
+    /// queries do not block on the background wavefront: cells the wavefront
+    /// has not yet closed report an admissible straight-line lower bound to
+    /// the nearest seed cell, so the search can begin expanding immediately
+    /// and picks up exact BFS values as cells close. Pair with
+    /// setWavefrontCompletionCallback() to have the consuming search refresh
+    /// the h-values it cached under the lower bound once the wavefront
+    /// finishes, e.g. via ARAStar::requestHeuristicRefresh().
+    void setCooperativeRefinement(bool enable);
+    bool cooperativeRefinement() const { return m_coop_refinement; }
+
+    /// Install a callback invoked on the wavefront thread each time a goal
+    /// wavefront exhausts. Takes effect on wavefronts started after the
+    /// call.
+    void setWavefrontCompletionCallback(std::function<void()> callback);
+    ///@}
+
+    /// \name Reachability
+    ///@{
+
+    /// Return true if the goal wavefront has exhausted its free-space
+    /// component without discovering the start cell, in which case no
+    /// corridor of free cells connects the two and no path can exist at the
+    /// grid resolution. Blocks until the wavefront has either reached the
+    /// start cell or run out of frontier, which is fast in the disconnected
+    /// case since a sealed-off goal bounds the component. Conservatively
+    /// returns false when either endpoint is unknown or the start cell lies
+    /// inside an obstacle, where connectivity is ambiguous.
+    bool startUnreachable() const;
+    ///@}
+
     auto grid() const -> const OccupancyGrid* { return m_grid; }
 
     auto getWallsVisualization() const -> visual::Marker;
@@ -74,6 +120,7 @@ public:
 
     /// \name Reimplemented Public Functions from RobotPlanningSpaceObserver
     ///@{
+    void updateStart(const RobotState& state) override;
     void updateGoal(const GoalConstraint& goal) override;
     ///@}
 
@@ -84,26 +131,67 @@ public:
     int GetFromToHeuristic(int from_id, int to_id) override;
     ///@}
 
+    /// \name Reimplemented Public Functions from RobotHeuristic
+    ///@{
+    int GetGoalHeuristic(int state_id, const Vector3& p) override;
+    ///@}
+
+    /// \name Required Public Functions from MemoryUsageProvider
+    ///@{
+    auto memUsage() const -> size_t override;
+    ///@}
+
 private:
 
     const OccupancyGrid* m_grid = nullptr;
 
     std::unique_ptr<BFS_3D> m_bfs;
+
+    // wavefront rooted at the start region, computed on demand for backward
+    // searches; null until the first start update
+    std::unique_ptr<BFS_3D> m_start_bfs;
+
     PointProjectionExtension* m_pp = nullptr;
 
     double m_inflation_radius = 0.0;
     int m_cost_per_cell = 1;
 
+    bool m_coop_refinement = false;
+    std::function<void()> m_wavefront_callback;
+
     struct CellCoord
     {
         int x, y, z;
         CellCoord() = default;
         CellCoord(int x, int y, int z) : x(x), y(y), z(z) { }
+
+        bool operator==(const CellCoord& o) const {
+            return x == o.x && y == o.y && z == o.z;
+        }
     };
     std::vector<CellCoord> m_goal_cells;
 
+    // cell of the last start update, for the reachability prepass
+    CellCoord m_start_cell;
+    bool m_start_cell_valid = false;
+
+    // Retired goal wavefronts, most recently used first, so that returning
+    // to a recently seen goal cell swaps its distances back in rather than
+    // rerunning BFS. Invalidated whenever the wall pattern is rescanned from
+    // the grid.
+    struct StoredBfs
+    {
+        std::vector<CellCoord> goal_cells;
+        std::unique_ptr<BFS_3D> bfs;
+    };
+    std::vector<StoredBfs> m_bfs_store;
+    size_t m_bfs_store_capacity = 4;
+
+    auto makeBfs() const -> std::unique_ptr<BFS_3D>;
     void syncGridAndBfs();
+    bool loadStoredBfs(const std::vector<CellCoord>& cells);
     int getBfsCostToGoal(const BFS_3D& bfs, int x, int y, int z) const;
+    int getUndiscoveredCostToGoal(int x, int y, int z) const;
 };
 
 } // namespace smpl
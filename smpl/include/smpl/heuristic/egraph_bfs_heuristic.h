@@ -39,7 +39,6 @@
 #include <smpl/debug/marker.h>
 #include <smpl/graph/experience_graph_extension.h>
 #include <smpl/grid/grid.h>
-#include <smpl/heap/intrusive_heap.h>
 #include <smpl/heuristic/egraph_heuristic.h>
 #include <smpl/heuristic/robot_heuristic.h>
 #include <smpl/occupancy_grid.h>
@@ -52,6 +51,8 @@ class DijkstraEgraphHeuristic3D :
 {
 public:
 
+    ~DijkstraEgraphHeuristic3D();
+
     bool init(RobotPlanningSpace* space, const OccupancyGrid* grid);
 
     auto grid() const -> const OccupancyGrid* { return m_grid; }
@@ -107,27 +108,52 @@ private:
 
     const OccupancyGrid* m_grid = nullptr;
 
-    struct Cell : public heap_element
+    struct Cell
     {
         int dist;
 
         Cell() = default;
-        explicit Cell(int d) : heap_element(), dist(d) { }
+        explicit Cell(int d) : dist(d) { }
     };
 
-    Grid3<Cell> m_dist_grid;
+    // Morton-ordered storage keeps the cells touched by the Dijkstra wavefront
+    // near each other in memory; all access is by coordinate or decoded via
+    // index_to_coord(), so the cell layout is free to differ from row-major
+    Grid3<Cell, MortonIndexing> m_dist_grid;
+
+    double m_eg_eps = 1.0;
+    double m_inflation_radius = 0.0;
 
-    struct CellCompare
+    // Dial's implementation of the OPEN list. Distances are integral and
+    // edge costs are bounded, so the queue is a cyclic array of buckets
+    // indexed by distance modulo the array size, making pushes and pops
+    // O(1) instead of log-time heap sifts. Decrease-key is handled lazily:
+    // cells are re-pushed on every improvement and entries whose recorded
+    // distance no longer matches the cell's are skipped on pop.
+    struct OpenList
     {
-        bool operator()(const Cell& a, const Cell& b) const {
-            return a.dist < b.dist;
-        }
+        std::vector<std::vector<Cell*>> buckets;
+        int min = 0;        // distance of the current bucket
+        size_t count = 0;   // number of queued entries, including stale ones
+
+        void init(int max_edge_cost);
+        void clear();
+        bool empty() const { return count == 0; }
+        void push(Cell* cell);
+        Cell* pop();
     };
 
-    double m_eg_eps = 1.0;
-    double m_inflation_radius = 0.0;
+    OpenList m_open;
+
+    // span of the bucket queue sized in updateGoal(), reused when the queue
+    // is rebuilt during localized repair
+    int m_max_edge_cost = 0;
+
+    // whether distances have been seeded from a goal cell; repair only
+    // maintains wall status until then
+    bool m_have_goal = false;
 
-    intrusive_heap<Cell, CellCompare> m_open;
+    int m_change_callback_handle = -1;
 
     PointProjectionExtension* m_pp = nullptr;
     ExperienceGraphExtension* m_eg = nullptr;
@@ -161,6 +187,7 @@ private:
     int getGoalHeuristic(const Eigen::Vector3i& dp);
 
     void syncGridAndDijkstra();
+    void repairChangedCells(const OccupancyGrid::OccupancyChanges& changes);
 };
 
 } // namespace smpl
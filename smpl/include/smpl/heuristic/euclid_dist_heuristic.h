@@ -32,7 +32,11 @@
 #ifndef SMPL_EUCLID_DIST_HEURISTIC_H
 #define SMPL_EUCLID_DIST_HEURISTIC_H
 
+// standard includes
+#include <vector>
+
 // project includes
+#include <smpl/heuristic/goal_distance_oracle.h>
 #include <smpl/heuristic/robot_heuristic.h>
 #include <smpl/spatial.h>
 
@@ -55,6 +59,11 @@ public:
     double getMetricStartDistance(double x, double y, double z) override;
     ///@}
 
+    /// \name Reimplemented Public Functions from RobotHeuristic
+    ///@{
+    void updateGoal(const GoalConstraint& goal) override;
+    ///@}
+
     /// \name Required Public Functions from Extension
     ///@{
     Extension* getExtension(size_t class_code) override;
@@ -65,6 +74,11 @@ public:
     int GetGoalHeuristic(int state_id) override;
     int GetStartHeuristic(int state_id) override;
     int GetFromToHeuristic(int from_id, int to_id) override;
+
+    void GetGoalHeuristics(
+        const int* state_ids,
+        int state_count,
+        int* values) override;
     ///@}
 
 private:
@@ -79,6 +93,15 @@ private:
     double m_z_coeff = 1.0;
     double m_rot_coeff = 1.0;
 
+    // scratch buffer for batch evaluation; holds the batch's projected
+    // positions packed as three contiguous blocks of x, y, and z coordinates
+    std::vector<double> m_batch_pts;
+
+    // min-distance-to-any-goal oracle, built when the goal is a pose region
+    // so per-state evaluation stays O(1) instead of a min over every goal
+    // pose; empty for single-pose and non-pose goals
+    GoalDistanceOracle m_goal_oracle;
+
     Affine3 createPose(const std::vector<double>& pose) const;
     Vector3 createPoint(const std::vector<double>& point) const;
 
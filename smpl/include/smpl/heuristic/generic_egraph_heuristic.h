@@ -34,12 +34,15 @@
 
 // project includes
 #include <smpl/graph/experience_graph_extension.h>
+#include <smpl/graph/experience_graph_index.h>
 #include <smpl/heap/intrusive_heap.h>
 #include <smpl/heuristic/robot_heuristic.h>
 #include <smpl/heuristic/egraph_heuristic.h>
 
 namespace smpl {
 
+class JointDistHeuristic;
+
 class GenericEgraphHeuristic :
     public RobotHeuristic,
     public ExperienceGraphHeuristicExtension
@@ -88,8 +91,16 @@ private:
 
     RobotHeuristic* m_orig_h = nullptr;
 
+    // non-null when the original heuristic measures euclidean joint distance,
+    // in which case equivalent-state queries go through the spatial index
+    // instead of scanning every experience graph node
+    JointDistHeuristic* m_jd_h = nullptr;
+
     ExperienceGraphExtension* m_eg = nullptr;
 
+    ExperienceGraphIndex m_index;
+    std::vector<ExperienceGraph::node_id> m_nearby_nodes;
+
     double m_eg_eps = 1.0;
 
     std::vector<int> m_component_ids;
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_GOAL_DISTANCE_ORACLE_H
+#define SMPL_GOAL_DISTANCE_ORACLE_H
+
+// standard includes
+#include <memory>
+#include <vector>
+
+// project includes
+#include <smpl/spatial.h>
+
+namespace smpl {
+
+class EuclidDistanceMap;
+
+/// Answers min-distance-to-any-goal queries in O(1) for a set of goal
+/// positions. One multi-source propagation seeds a coarse distance field over
+/// the bounding box of the goals, so heuristics evaluating against a goal
+/// region pay a single cell lookup per state instead of a min over every
+/// goal. Queries outside the field fall back to the exact min over the goal
+/// set, which only far-flung states pay.
+class GoalDistanceOracle
+{
+public:
+
+    GoalDistanceOracle();
+    ~GoalDistanceOracle();
+
+    /// Build the oracle over a set of goal positions at the given field
+    /// resolution. The field covers the bounding box of the goals, padded so
+    /// that cells around the goal region are answered by the field rather
+    /// than the exact fallback.
+    void build(const std::vector<Vector3>& goals, double res);
+
+    void clear();
+
+    bool initialized() const { return m_map != NULL; }
+
+    size_t goalCount() const { return m_goals.size(); }
+
+    /// Return the distance from a position to the nearest goal, within half
+    /// a field cell of exact for positions covered by the field.
+    double dist(double x, double y, double z) const;
+
+private:
+
+    std::vector<Vector3> m_goals;
+    std::unique_ptr<EuclidDistanceMap> m_map;
+
+    // padded field box; field values that could have been sourced by the
+    // map's border ring rather than a goal are re-answered exactly
+    Vector3 m_min = Vector3::Zero();
+    Vector3 m_max = Vector3::Zero();
+    double m_cell_diag = 0.0;
+
+    double exactDist(double x, double y, double z) const;
+};
+
+} // namespace smpl
+
+#endif
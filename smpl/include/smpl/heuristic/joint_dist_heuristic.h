@@ -32,6 +32,9 @@
 #ifndef SMPL_JOINT_DIST_HEURISTIC_H
 #define SMPL_JOINT_DIST_HEURISTIC_H
 
+// standard includes
+#include <vector>
+
 // project includes
 #include <smpl/heuristic/robot_heuristic.h>
 
@@ -41,6 +44,9 @@ class JointDistHeuristic : public RobotHeuristic
 {
 public:
 
+    /// The number of heuristic units per radian of euclidean joint distance.
+    static constexpr double FIXED_POINT_RATIO = 1000.0;
+
     bool init(RobotPlanningSpace* space);
 
     /// \name Required Public Functions from RobotHeuristic
@@ -59,14 +65,21 @@ public:
     int GetGoalHeuristic(int state_id) override;
     int GetStartHeuristic(int state_id) override;
     int GetFromToHeuristic(int from_id, int to_id) override;
+
+    void GetGoalHeuristics(
+        const int* state_ids,
+        int state_count,
+        int* values) override;
     ///@}
 
 private:
 
-    static constexpr double FIXED_POINT_RATIO = 1000.0;
-
     ExtractRobotStateExtension* m_ers = nullptr;
 
+    // scratch buffer for batch evaluation; holds the batch's joint variables
+    // packed row-major, one row per state
+    std::vector<double> m_batch_joints;
+
     double computeJointDistance(const RobotState &s, const RobotState &t) const;
 };
 
@@ -86,6 +86,11 @@ public:
     int GetFromToHeuristic(int from_id, int to_id) override;
     ///@}
 
+    /// \name Reimplemented Public Functions from RobotHeuristic
+    ///@{
+    int GetGoalHeuristic(int state_id, const Vector3& p) override;
+    ///@}
+
 private:
 
     const OccupancyGrid* m_grid = nullptr;
@@ -102,10 +107,23 @@ private:
     double m_inflation_radius = 0.0;
     int m_cost_per_cell = 1;
 
-    int getGoalHeuristic(int state_id, bool use_ee) const;
+    // Precombined cost grids for the two frames, materialized in one pass
+    // once both wavefronts complete: the wall handling and cost scaling of
+    // getBfsCostToGoal() are folded into one value per cell, so a
+    // steady-state query is a bounds test and an array read per frame.
+    // Empty until materialized and cleared whenever the underlying searches
+    // restart; queries in that window take the direct BFS path.
+    std::vector<int> m_costs;
+    std::vector<int> m_ee_costs;
+    int m_cost_dims[3] = { 0, 0, 0 };
+
+    int getGoalHeuristic(int state_id, const Vector3* p, bool use_ee) const;
 
     void syncGridAndBfs();
+    void materializeCostGrids();
     int getBfsCostToGoal(const BFS_3D& bfs, int x, int y, int z) const;
+    int getPrecombinedCostToGoal(
+        const std::vector<int>& costs, int x, int y, int z) const;
 
     inline
     int combine_costs(int c1, int c2) const;
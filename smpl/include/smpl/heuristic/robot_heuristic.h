@@ -60,6 +60,30 @@ public:
     auto planningSpace() -> RobotPlanningSpace* { return m_space; }
     auto planningSpace() const -> const RobotPlanningSpace* { return m_space; }
 
+    /// \name Cached Planning Space Extensions
+    ///@{
+
+    auto pointProjection() const -> PointProjectionExtension* {
+        return m_point_ext;
+    }
+    auto poseProjection() const -> PoseProjectionExtension* {
+        return m_pose_ext;
+    }
+    auto extractRobotState() const -> ExtractRobotStateExtension* {
+        return m_ers_ext;
+    }
+
+    /// \brief Re-resolve the cached extension pointers.
+    ///
+    /// The common extension interfaces of the planning space are resolved
+    /// once during init() and held as raw pointers so that per-state
+    /// evaluation paths avoid the virtual lookup and dynamic cast of
+    /// getExtension(). Call this if the planning space gains or loses an
+    /// extension after initialization.
+    void refreshExtensions();
+
+    ///@}
+
     /// \brief Return the heuristic distance of the planning link to the start.
     ///
     /// This distance is used by the manipulation lattice to determine whether
@@ -82,11 +106,53 @@ public:
     virtual int GetFromToHeuristic(int from_id, int to_id) = 0;
     ///@}
 
+    /// \brief Return the goal heuristic for a state that has already been
+    /// projected to a point by the planning space.
+    ///
+    /// Heuristics that derive their value from the projected position of the
+    /// planning link should override this overload to avoid repeating the
+    /// projection when several heuristics are evaluated for the same state.
+    /// The default implementation ignores the projected position.
+    virtual int GetGoalHeuristic(int state_id, const Vector3& p) {
+        return GetGoalHeuristic(state_id);
+    }
+
+    /// \brief Return the goal heuristic for a batch of states.
+    ///
+    /// The default implementation evaluates each state independently.
+    /// Heuristics whose values are simple arithmetic over the state, such as
+    /// joint-space or workspace distances, should override this to gather the
+    /// batch into packed arrays and evaluate the distances in flat loops,
+    /// which vectorize where the scattered per-state path cannot.
+    virtual void GetGoalHeuristics(
+        const int* state_ids,
+        int state_count,
+        int* values)
+    {
+        for (int i = 0; i < state_count; ++i) {
+            values[i] = GetGoalHeuristic(state_ids[i]);
+        }
+    }
+
 private:
 
     RobotPlanningSpace* m_space = nullptr;
+
+    PointProjectionExtension* m_point_ext = nullptr;
+    PoseProjectionExtension* m_pose_ext = nullptr;
+    ExtractRobotStateExtension* m_ers_ext = nullptr;
 };
 
+/// Evaluate the goal heuristic of several heuristics for the same state. The
+/// state is projected to a point once and the result shared between
+/// heuristics via the point-aware overload of GetGoalHeuristic, so that
+/// heuristics backed by the same projection do not each recompute it.
+void GetGoalHeuristics(
+    RobotHeuristic* const* heurs,
+    int heur_count,
+    int state_id,
+    int* values);
+
 } // namespace smpl
 
 #endif
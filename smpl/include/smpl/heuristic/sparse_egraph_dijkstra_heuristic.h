@@ -35,12 +35,12 @@
 // standard includes
 #include <cstdlib>
 #include <limits>
+#include <vector>
 
 // system includes
 #include <Eigen/Core>
 
 // project includes
-#include <smpl/heap/intrusive_heap.h>
 #include <smpl/heuristic/robot_heuristic.h>
 #include <smpl/heuristic/egraph_heuristic.h>
 #include <smpl/graph/experience_graph.h>
@@ -110,29 +110,41 @@ private:
 
     const OccupancyGrid* m_grid = nullptr;
 
-    struct Cell : public heap_element
+    struct Cell
     {
         int dist;
 
         Cell() = default;
-        explicit Cell(int d) : heap_element(), dist(d) { }
+        explicit Cell(int d) : dist(d) { }
 
         bool operator==(Cell o) const { return o.dist == dist; }
     };
 
     SparseGrid<Cell> m_dist_grid;
 
-    struct CellCompare
-    {
-        bool operator()(const Cell& a, const Cell& b) const {
-            return a.dist < b.dist;
-        }
-    };
-
     double m_eg_eps = 1.0;
     double m_inflation_radius = 0.0;
 
-    intrusive_heap<Cell, CellCompare> m_open;
+    // Dial's implementation of the OPEN list. Distances are integral and
+    // edge costs are bounded, so the queue is a cyclic array of buckets
+    // indexed by distance modulo the array size, making pushes and pops
+    // O(1) instead of log-time heap sifts. Decrease-key is handled lazily:
+    // cells are re-pushed on every improvement and entries whose recorded
+    // distance no longer matches the cell's are skipped on pop.
+    struct OpenList
+    {
+        std::vector<std::vector<Cell*>> buckets;
+        int min = 0;        // distance of the current bucket
+        size_t count = 0;   // number of queued entries, including stale ones
+
+        void init(int max_edge_cost);
+        void clear();
+        bool empty() const { return count == 0; }
+        void push(Cell* cell);
+        Cell* pop();
+    };
+
+    OpenList m_open;
 
     // we can't use the address of the cell to determine the position within
     // the grid, as we can with dense grids (this isn't entirely true, but it
@@ -35,13 +35,18 @@
 
 // standard includes
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 // system includes
 #include <Eigen/StdVector>
 
 // project includes
+#include <smpl/epoch.h>
 #include <smpl/forward.h>
 #include <smpl/debug/marker.h>
 #include <smpl/distance_map/distance_map_interface.h>
@@ -77,6 +82,12 @@ public:
     /// \name Modifiers
     ///@{
     void addPointsToField(const std::vector<Vector3>& points);
+
+    void addPointsToField(
+        const float* points,
+        size_t count,
+        size_t stride = 3 * sizeof(float));
+
     void removePointsFromField(const std::vector<Vector3>& points);
 
     void updatePointsInField(
@@ -86,6 +97,127 @@ public:
     void reset();
     ///@}
 
+    /// The epoch of the grid contents, bumped by every modifier call so
+    /// caches derived from occupancy or distance values (collision verdicts,
+    /// heuristic grids) can validate their entries against it; see
+    /// CacheEntryHeader.
+    Epoch epoch() const { return m_epoch; }
+
+    /// \name Buffered Modifiers
+    ///@{
+    /// Enable or disable buffering of field updates. While buffering is
+    /// enabled, addPointsToField() and removePointsFromField() record their
+    /// changes with the distance map, deferring distance propagation until
+    /// the next call to flushUpdates(). Distance lookups made in the interim
+    /// reflect the state of the field as of the last flush.
+    void setBufferUpdates(bool buffer) { m_buffer_updates = buffer; }
+    bool bufferUpdates() const { return m_buffer_updates; }
+
+    void flushUpdates() { m_grid->flushUpdates(); }
+    ///@}
+
+    /// \name Change Notification
+    ///@{
+    /// A batch of occupancy changes reported to registered callbacks. The
+    /// cell bounds are inclusive and cover the cells whose occupancy changed;
+    /// distance values may additionally change within the propagation radius
+    /// of the distance map around this region, so consumers repairing derived
+    /// data (heuristic grids, lattice edge costs) should dilate the bounds by
+    /// that radius.
+    struct OccupancyChanges
+    {
+        bool added;                  ///< occupied (true) or freed (false)
+        std::vector<Vector3> points; ///< changed points, in the grid frame
+        int min_cell[3];             ///< minimum changed cell, inclusive
+        int max_cell[3];             ///< maximum changed cell, inclusive
+    };
+
+    typedef std::function<void(const OccupancyChanges&)> ChangeCallback;
+
+    /// Register a callback invoked after each modifier call that changes cell
+    /// occupancy, e.g. for localized repair of heuristic grids or for
+    /// gathering the lattice edges affected between the queries of an
+    /// incremental search. Returns a handle for removeChangeCallback().
+    /// Notifications fire when the modifier is called, even when updates are
+    /// buffered and distance propagation is deferred to flushUpdates().
+    /// Registration is logically const so that observers holding const
+    /// references to the grid may subscribe.
+    int addChangeCallback(const ChangeCallback& callback) const;
+    void removeChangeCallback(int handle) const;
+    ///@}
+
+    /// \name Double-Buffered Publication
+    ///@{
+    /// Enable or disable double-buffered publication. While enabled,
+    /// modifier calls build into a private write map while read accessors
+    /// and getReadDistanceField() serve a published snapshot; the snapshot
+    /// only changes when publishUpdates() is called. Sensor-driven map
+    /// updates may then overlap planning instead of serializing with it.
+    /// Enabling clones the current map, doubling grid memory.
+    void setDoubleBuffered(bool enable);
+    bool doubleBuffered() const { return m_read_grid != NULL; }
+
+    /// Publish the updates applied since the last publication by swapping
+    /// the write map with the published snapshot and replaying the updates
+    /// into the new write map. Must not run concurrently with read accessors
+    /// on this instance; concurrent readers should instead hold the snapshot
+    /// returned by getReadDistanceField() for their entire episode.
+    void publishUpdates();
+
+    /// The distance map readers should reference: the published snapshot
+    /// when double buffering is enabled, the live map otherwise. The
+    /// returned snapshot is immutable until release and safe to read while
+    /// updates build in the write map.
+    auto getReadDistanceField() const
+        -> std::shared_ptr<const DistanceMapInterface>;
+    ///@}
+
+    /// \name Occupancy Pyramid
+    ///@{
+    /// Enable or disable maintenance of a multi-resolution occupancy
+    /// pyramid over the grid. Each level halves the resolution of the
+    /// previous, with each coarse cell counting the occupied cells within
+    /// its block, so that region queries inspect a few coarse cells instead
+    /// of every cell in the region. The pyramid is rebuilt on enable and
+    /// updated incrementally as obstacles are added and removed; when double
+    /// buffering is enabled, it reflects the write map, like change
+    /// notifications do.
+    void enableOccupancyPyramid(bool enable);
+    bool occupancyPyramidEnabled() const { return !m_pyramid.empty(); }
+
+    /// Return true if no cell within the inclusive cell-coordinate region is
+    /// occupied. Exact; the pyramid, when enabled, is used to skip interior
+    /// blocks. Out-of-bounds portions of the region are considered free.
+    bool isRegionFree(
+        int xmin, int ymin, int zmin,
+        int xmax, int ymax, int zmax) const;
+
+    /// Return true if every in-bounds cell within the inclusive
+    /// cell-coordinate region is occupied. Exact, as above.
+    bool isRegionOccupied(
+        int xmin, int ymin, int zmin,
+        int xmax, int ymax, int zmax) const;
+    ///@}
+
+    /// \name Query Profiling
+    ///@{
+    /// Enable or disable counting of distance queries against the grid.
+    /// While enabled, each distance lookup atomically increments a counter
+    /// for the aligned block of cells containing the queried cell, capturing
+    /// the spatial distribution of sphere-model collision checks and
+    /// heuristic queries over an episode at a small fixed overhead. Enabling
+    /// zeroes the counters; disabling releases them.
+    void setQueryProfiling(bool enable);
+    bool queryProfilingEnabled() const { return !m_query_counts.empty(); }
+
+    void resetQueryCounts();
+
+    /// Return the number of queries recorded against the block containing
+    /// the given cell since profiling was enabled or the counts were last
+    /// reset; zero while profiling is disabled.
+    std::uint32_t getQueryCount(int x, int y, int z) const;
+    ///@}
+
     /// \name Properties
     ///@{
     double originX() const { return m_grid->originX(); }
@@ -108,6 +240,13 @@ public:
     ///@{
     size_t getOccupiedVoxelCount() const;
 
+    /// Invoke a function on the world-frame center of every occupied voxel,
+    /// streaming the cells without materializing them. When the underlying
+    /// map is a SparseDistanceMap, free regions are skipped at the
+    /// granularity of its octree leaves rather than visited cell by cell.
+    void iterateOccupiedVoxels(
+        const std::function<void(const Vector3&)>& f) const;
+
     void getOccupiedVoxels(std::vector<Vector3>& voxels) const;
 
     void getOccupiedVoxels(
@@ -127,9 +266,25 @@ public:
     ///@{
     double getDistance(int x, int y, int z) const;
 
+    /// Append the grid coordinates of all cells within the given distance of
+    /// an obstacle, as packed (x, y, z) triples. Bulk variant of a
+    /// getDistance() threshold test over the whole grid; not recorded by
+    /// query profiling.
+    void getCellsWithinDistance(double radius, std::vector<int>& cells) const
+    { readGrid()->getCellsWithinDistance(radius, cells); }
+
     double getDistanceFromPoint(double x, double y, double z) const;
     double getSquaredDist(double x, double y, double z) const;
 
+    /// Look up the distances for a batch of points in one call, one output
+    /// distance per input point. Distances beyond a non-negative \p thresh
+    /// may be clamped to \p thresh. Not recorded by query profiling.
+    void getDistancesFromPoints(
+        const std::vector<Vector3>& points,
+        std::vector<double>& distances,
+        double thresh = -1.0) const
+    { readGrid()->getMetricDistances(points, distances, thresh); }
+
     double getDistanceToBorder(int x, int y, int z) const;
 
     double getDistanceToBorder(double x, double y, double z) const;
@@ -154,6 +309,7 @@ public:
     auto getBoundingBoxVisualization() const -> visual::Marker;
     auto getDistanceFieldVisualization(double max_dist = -1.0) const -> visual::Marker;
     auto getOccupiedVoxelsVisualization() const -> visual::Marker;
+    auto getQueryHeatmapVisualization() const -> visual::Marker;
     ///@}
 
 private:
@@ -162,12 +318,67 @@ private:
     std::string reference_frame_;
 
     bool m_ref_counted;
+    bool m_buffer_updates;
+
+    // registered change callbacks, keyed by their handles; not carried over
+    // by copies, whose cells the subscribers are not observing; mutable so
+    // observers holding const references to the grid may subscribe
+    mutable std::vector<std::pair<int, ChangeCallback>> m_change_callbacks;
+    mutable int m_next_change_callback_handle = 0;
+
+    // double-buffered publication: when set, the published snapshot serving
+    // reads while m_grid accumulates updates; the pending change log records
+    // the write map's lead over the snapshot and is replayed into the old
+    // snapshot when the maps trade roles
+    std::shared_ptr<DistanceMapInterface> m_read_grid;
+    std::vector<std::pair<std::vector<Vector3>, bool>> m_pending_changes;
+    bool m_pending_reset = false;
+
+    // occupancy pyramid: m_pyramid_occ stores one byte of occupancy per grid
+    // cell and m_pyramid[l] counts the occupied cells within each aligned
+    // block of (2 << l)^3 cells; both empty while the pyramid is disabled
+    std::vector<std::uint8_t> m_pyramid_occ;
+    std::vector<std::vector<std::uint32_t>> m_pyramid;
+
+    // query profiling: one counter per aligned block of QueryBlockEdge^3
+    // cells, incremented by each distance lookup; empty while profiling is
+    // disabled. Not carried over by copies, like the change callbacks;
+    // mutable so const distance lookups may record
+    static const int QueryBlockEdge = 4;
+    mutable std::vector<std::atomic<std::uint32_t>> m_query_counts;
+    int m_query_blocks_x = 0;
+    int m_query_blocks_y = 0;
+    int m_query_blocks_z = 0;
+
     int m_x_stride;
     int m_y_stride;
     std::vector<int> m_counts;
 
+    // contents epoch; see epoch()
+    Epoch m_epoch = 1;
+
     void initRefCounts();
 
+    void notifyChanges(const std::vector<Vector3>& points, bool added);
+
+    void rebuildOccupancyPyramid();
+    void updatePyramidCell(int x, int y, int z, bool occupied);
+    int pyramidIndex(int level, int x, int y, int z) const;
+    bool pyramidRegionFree(
+        int level,
+        int xmin, int ymin, int zmin,
+        int xmax, int ymax, int zmax) const;
+    bool pyramidRegionOccupied(
+        int level,
+        int xmin, int ymin, int zmin,
+        int xmax, int ymax, int zmax) const;
+
+    int queryBlockIndex(int x, int y, int z) const;
+    void recordQuery(int x, int y, int z) const;
+
+    DistanceMapInterface* readGrid() const
+    { return m_read_grid != NULL ? m_read_grid.get() : m_grid.get(); }
+
     int coordToIndex(int x, int y, int z) const;
 
     int getCellCount() const;
@@ -210,24 +421,55 @@ void OccupancyGrid::setReferenceFrame(const std::string& frame)
     reference_frame_ = frame;
 }
 
+inline
+int OccupancyGrid::queryBlockIndex(int x, int y, int z) const
+{
+    return ((x / QueryBlockEdge) * m_query_blocks_y + (y / QueryBlockEdge)) *
+            m_query_blocks_z + (z / QueryBlockEdge);
+}
+
+inline
+void OccupancyGrid::recordQuery(int x, int y, int z) const
+{
+    if (m_query_counts.empty()) {
+        return;
+    }
+    if (!isInBounds(x, y, z)) {
+        return;
+    }
+    m_query_counts[queryBlockIndex(x, y, z)].fetch_add(
+            1, std::memory_order_relaxed);
+}
+
 /// Get the distance, in meters, to the nearest occupied cell.
 inline
 double OccupancyGrid::getDistance(int x, int y, int z) const
 {
-    return m_grid->getCellDistance(x, y, z);
+    recordQuery(x, y, z);
+    return readGrid()->getCellDistance(x, y, z);
 }
 
 /// Get the distance, in meters, to the nearest occupied cell
 inline
 double OccupancyGrid::getDistanceFromPoint(double x, double y, double z) const
 {
-    return m_grid->getMetricDistance(x, y, z);
+    if (!m_query_counts.empty()) {
+        int gx, gy, gz;
+        m_grid->worldToGrid(x, y, z, gx, gy, gz);
+        recordQuery(gx, gy, gz);
+    }
+    return readGrid()->getMetricDistance(x, y, z);
 }
 
 inline
 double OccupancyGrid::getSquaredDist(double x, double y, double z) const
 {
-    return m_grid->getMetricSquaredDistance(x, y, z);
+    if (!m_query_counts.empty()) {
+        int gx, gy, gz;
+        m_grid->worldToGrid(x, y, z, gx, gy, gz);
+        recordQuery(gx, gy, gz);
+    }
+    return readGrid()->getMetricSquaredDistance(x, y, z);
 }
 
 /// Get the distance to the, in meters, to the border.
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_POOL_ALLOCATOR_H
+#define SMPL_POOL_ALLOCATOR_H
+
+// standard includes
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace smpl {
+
+namespace detail {
+
+/// Backing storage for PoolAllocator. Allocations are carved bump-pointer
+/// style from geometrically growing chunks; deallocated blocks are pushed
+/// onto per-size free lists for reuse. All memory is returned to the system
+/// at once when the pool is destroyed.
+class AllocatorPool
+{
+public:
+
+    void* allocate(std::size_t bytes)
+    {
+        bytes = round_up(bytes);
+
+        auto fit = m_free.find(bytes);
+        if (fit != m_free.end() && !fit->second.empty()) {
+            void* p = fit->second.back();
+            fit->second.pop_back();
+            return p;
+        }
+
+        if (m_used + bytes > m_cap) {
+            std::size_t chunk_size = m_cap << 1;
+            if (chunk_size < MinChunkSize) {
+                chunk_size = MinChunkSize;
+            }
+            if (chunk_size < bytes) {
+                chunk_size = bytes;
+            }
+            m_chunks.emplace_back(new char[chunk_size]);
+            m_cap = chunk_size;
+            m_used = 0;
+        }
+
+        void* p = m_chunks.back().get() + m_used;
+        m_used += bytes;
+        return p;
+    }
+
+    void deallocate(void* p, std::size_t bytes)
+    {
+        m_free[round_up(bytes)].push_back(p);
+    }
+
+private:
+
+    static const std::size_t MinChunkSize = 4096;
+
+    static std::size_t round_up(std::size_t bytes)
+    {
+        const std::size_t align = alignof(std::max_align_t);
+        return (bytes + align - 1) & ~(align - 1);
+    }
+
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    std::size_t m_cap = 0;      // size of the active (last) chunk
+    std::size_t m_used = 0;     // bytes carved from the active chunk
+
+    // reusable blocks, keyed by rounded block size
+    std::unordered_map<std::size_t, std::vector<void*>> m_free;
+};
+
+} // namespace detail
+
+/// A chunked pool allocator for node-based containers such as OcTree, whose
+/// allocations come in a handful of fixed sizes (e.g. 8-child node arrays).
+/// Individual deallocations recycle blocks within the pool instead of
+/// returning memory to the system, so rebuilding a tree (clearing and
+/// repopulating, as SparseGrid::reset() does) touches the system allocator
+/// only when the pool must grow. Copies and rebound copies share the same
+/// pool, which is released when the last allocator referencing it goes away.
+/// Not thread-safe: containers sharing a pool must not allocate concurrently.
+template <class T>
+class PoolAllocator
+{
+public:
+
+    using value_type = T;
+
+    PoolAllocator() : m_pool(std::make_shared<detail::AllocatorPool>()) { }
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>& other) : m_pool(other.pool()) { }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(m_pool->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        m_pool->deallocate(p, n * sizeof(T));
+    }
+
+    const std::shared_ptr<detail::AllocatorPool>& pool() const
+    { return m_pool; }
+
+private:
+
+    std::shared_ptr<detail::AllocatorPool> m_pool;
+};
+
+template <class T, class U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b)
+{
+    return a.pool() == b.pool();
+}
+
+template <class T, class U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b)
+{
+    return !(a == b);
+}
+
+} // namespace smpl
+
+#endif
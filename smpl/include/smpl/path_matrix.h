@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_PATH_MATRIX_H
+#define SMPL_PATH_MATRIX_H
+
+// standard includes
+#include <cstddef>
+#include <vector>
+
+// project includes
+#include <smpl/types.h>
+
+namespace smpl {
+
+/// A sequence of path waypoints stored as one contiguous
+/// (waypoint x variable) matrix. Appending a waypoint copies its variables
+/// into the flat buffer instead of allocating a RobotState per waypoint;
+/// RobotState copies are materialized only on demand.
+class PathMatrix
+{
+public:
+
+    PathMatrix() = default;
+    explicit PathMatrix(size_t var_count) : m_var_count(var_count) { }
+
+    /// \name Size Properties
+    ///@{
+    size_t size() const {
+        return m_var_count == 0 ? 0 : m_data.size() / m_var_count;
+    }
+    bool empty() const { return m_data.empty(); }
+    size_t var_count() const { return m_var_count; }
+    ///@}
+
+    /// \name Modifiers
+    ///@{
+    void init(size_t var_count) {
+        m_var_count = var_count;
+        m_data.clear();
+    }
+
+    void clear() { m_data.clear(); }
+
+    void reserve(size_t waypoint_count) {
+        m_data.reserve(waypoint_count * m_var_count);
+    }
+
+    void push_back(const RobotState& state) {
+        m_data.insert(m_data.end(), state.begin(), state.end());
+    }
+
+    void push_back(const double* vars) {
+        m_data.insert(m_data.end(), vars, vars + m_var_count);
+    }
+    ///@}
+
+    /// \name Element Access
+    ///@{
+    double* operator[](size_t i) { return m_data.data() + i * m_var_count; }
+    const double* operator[](size_t i) const {
+        return m_data.data() + i * m_var_count;
+    }
+
+    /// Copy the i'th waypoint into an existing RobotState
+    void extract(size_t i, RobotState& state) const {
+        const double* row = (*this)[i];
+        state.assign(row, row + m_var_count);
+    }
+
+    /// Materialize the i'th waypoint as a RobotState
+    auto state(size_t i) const -> RobotState {
+        const double* row = (*this)[i];
+        return RobotState(row, row + m_var_count);
+    }
+
+    /// Materialize every waypoint
+    void extract_path(std::vector<RobotState>& path) const {
+        path.resize(size());
+        for (size_t i = 0; i < path.size(); ++i) {
+            extract(i, path[i]);
+        }
+    }
+    ///@}
+
+private:
+
+    std::vector<double> m_data;
+    size_t m_var_count = 0;
+};
+
+} // namespace smpl
+
+#endif
@@ -34,9 +34,12 @@
 #define SMPL_PLANNING_PARAMS_H
 
 // standard includes
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 // system includes
 #include <boost/variant.hpp>
@@ -70,6 +73,88 @@ struct ParameterException : public std::runtime_error
 
 using Parameter = boost::variant<bool, int, double, std::string>;
 
+/// \name Compiled Configuration
+///@{
+
+/// Typed views over the string-keyed parameter store, baked by
+/// PlanningParams::compiled() so that graph, heuristic, and search
+/// construction read plain struct members instead of hashing parameter names.
+/// Parameters whose consumers distinguish "absent" from any value carry a
+/// has_ flag alongside the value; the remainder hold their documented
+/// defaults when unset.
+
+struct GraphConfig
+{
+    std::string discretization;     // raw "<variable> <resolution>" pairs
+    std::string mprim_filename;
+    std::string egraph_path;
+    bool has_discretization = false;
+    bool has_mprim_filename = false;
+    bool has_egraph_path = false;
+
+    bool use_multiple_ik_solutions = false;
+    bool use_xyz_snap_mprim = false;
+    bool use_rpy_snap_mprim = false;
+    bool use_xyzrpy_snap_mprim = false;
+    bool use_short_dist_mprims = false;
+    bool use_action_tiers = false;
+    double xyz_snap_thresh = 0.0;
+    double rpy_snap_thresh = 0.0;
+    double xyzrpy_snap_thresh = 0.0;
+    double short_dist_mprims_thresh = 0.0;
+};
+
+struct HeuristicConfig
+{
+    double bfs_inflation_radius = 0.0;
+    int bfs_store_capacity = 4;
+    double offset_x = 0.0;
+    double offset_y = 0.0;
+    double offset_z = 0.0;
+    double x_coeff = 1.0;
+    double y_coeff = 1.0;
+    double z_coeff = 1.0;
+    double rot_coeff = 1.0;
+    double egraph_epsilon = 1.0;
+};
+
+struct SearchConfig
+{
+    double epsilon = 1.0;
+    double epsilon_mha = 1.0;
+    double epsilon_plan = 1.0;
+    double epsilon_track = 1.0;
+    bool search_mode = false;
+
+    bool allow_partial_solutions = false;
+    double target_epsilon = 1.0;
+    double delta_epsilon = 1.0;
+    bool improve_solution = false;
+    bool bound_expansions = false;
+    double repair_time = 0.0;
+    bool reuse_search_tree = false;
+    double memory_budget_mb = 0.0;
+    int cost_bound = 0;
+    bool has_allow_partial_solutions = false;
+    bool has_target_epsilon = false;
+    bool has_delta_epsilon = false;
+    bool has_improve_solution = false;
+    bool has_bound_expansions = false;
+    bool has_repair_time = false;
+    bool has_reuse_search_tree = false;
+    bool has_memory_budget_mb = false;
+    bool has_cost_bound = false;
+};
+
+struct CompiledConfig
+{
+    GraphConfig graph;
+    HeuristicConfig heuristic;
+    SearchConfig search;
+};
+
+///@}
+
 class PlanningParams
 {
 public:
@@ -79,6 +164,7 @@ public:
     // post processing parameters
     static const bool DefaultShortcutPath = false;
     static const bool DefaultInterpolatePath = false;
+    static const bool DefaultProfileAccelerations = false;
     static const ShortcutType DefaultShortcutType = ShortcutType::JOINT_SPACE;
 
     // TODO: visualization parameters
@@ -94,6 +180,9 @@ public:
     ///@{
     bool shortcut_path;
     bool interpolate_path;
+    // time waypoints with rest-to-rest trapezoidal profiles under the robot
+    // model's acceleration limits rather than constant-velocity segments
+    bool profile_accelerations;
     ShortcutType shortcut_type;
     ///@}
 
@@ -122,12 +211,32 @@ public:
 
     bool hasParam(const std::string& name) const;
 
+    /// Return the typed view of the parameter store, recompiled lazily after
+    /// any addParam(). Consumers hold the returned reference for the scope
+    /// of a construction pass and read struct members in place of per-name
+    /// lookups.
+    const CompiledConfig& compiled() const;
+
+    /// Register a callback invoked whenever the named parameter is added or
+    /// overwritten, so consumers that cache a runtime-tunable value can
+    /// refresh it without polling the store. Callbacks follow the object
+    /// they were registered on through copies.
+    void subscribe(const std::string& name, std::function<void()> callback);
+
 private:
 
     std::unordered_map<std::string, Parameter> params;
 
     bool m_warn_defaults;
 
+    // lazily rebuilt typed view; see compiled()
+    mutable CompiledConfig m_compiled;
+    mutable bool m_compiled_dirty = true;
+
+    std::vector<std::pair<std::string, std::function<void()>>> m_subscribers;
+
+    void parameterChanged(const std::string& name);
+
     void convertToBool(const Parameter& p, bool& val) const;
     void convertToInt(const Parameter& p, int& val) const;
     void convertToDouble(const Parameter& p, double& val) const;
@@ -38,6 +38,7 @@
 
 // project includes
 #include <smpl/collision_checker.h>
+#include <smpl/path_matrix.h>
 #include <smpl/robot_model.h>
 #include <smpl/planning_params.h>
 #include <smpl/types.h>
@@ -51,10 +52,35 @@ void ShortcutPath(
     std::vector<RobotState>& pout,
     ShortcutType type);
 
+/// Shortcut a path by evaluating candidate shortcuts in parallel rounds.
+/// Each round proposes shortcuts between waypoint pairs at geometrically
+/// decreasing spans, evaluates every candidate concurrently, and commits the
+/// non-overlapping candidates with the greatest savings, repeating until a
+/// round commits nothing. The collision checker must support concurrent
+/// calls to isStateToStateValid() from multiple threads. A thread count of 0
+/// selects the hardware concurrency; a thread count of 1 evaluates serially.
+void ShortcutPathParallel(
+    RobotModel* rm,
+    CollisionChecker* cc,
+    const std::vector<RobotState>& pin,
+    std::vector<RobotState>& pout,
+    ShortcutType type,
+    int num_threads = 0);
+
 bool InterpolatePath(
     CollisionChecker& cc,
     std::vector<RobotState>& path);
 
+/// Interpolate a path into a caller-provided waypoint matrix. The
+/// interpolated waypoints are written to one contiguous buffer rather than
+/// one heap-allocated RobotState each; callers that only read the waypoints
+/// back out (e.g. for trajectory conversion) avoid materializing RobotState
+/// copies entirely.
+bool InterpolatePath(
+    CollisionChecker& cc,
+    const std::vector<RobotState>& path,
+    PathMatrix& opath);
+
 bool CreatePositionVelocityPath(
     RobotModel* rm,
     const std::vector<RobotState>& path,
@@ -100,6 +100,18 @@ public:
     ///
     /// \return true if forward kinematics were computed; false otherwise
     virtual Affine3 computeFK(const RobotState& state) = 0;
+
+    /// \brief Compute forward kinematics of the planning link for a batch of
+    ///        configurations.
+    ///
+    /// One transform is written to \p poses per input configuration, in input
+    /// order. The default implementation evaluates each configuration through
+    /// computeFK(); models whose kinematics have per-call setup costs (state
+    /// conversions, transform chain refreshes) should override this to
+    /// amortize that setup across the batch.
+    virtual void computeFKBatch(
+        const std::vector<RobotState>& states,
+        std::vector<Affine3, Eigen::aligned_allocator<Affine3>>& poses);
 };
 
 namespace ik_option {
@@ -136,6 +148,25 @@ public:
         const RobotState& start,
         std::vector<RobotState>& solutions,
         ik_option::IkOption option = ik_option::UNRESTRICTED) = 0;
+
+    /// \brief Compute inverse kinematics solutions for a batch of queries.
+    ///
+    /// Each query pairs a target pose with a seed state. On return,
+    /// \p solutions holds one entry per query and \p valid reports whether
+    /// the corresponding entry was solved. If \p first_success is true,
+    /// evaluation may stop as soon as any query succeeds, leaving the
+    /// remaining queries marked unsolved. Returns the index of a solved
+    /// query, or -1 if none succeeded. The default implementation solves
+    /// each query in turn via computeIK(); derived models may evaluate
+    /// queries concurrently.
+    virtual int computeIKBatch(
+        const Affine3* poses,
+        const RobotState* seeds,
+        int count,
+        std::vector<RobotState>& solutions,
+        std::vector<bool>& valid,
+        bool first_success = false,
+        ik_option::IkOption option = ik_option::UNRESTRICTED);
 };
 
 class RedundantManipulatorInterface : public virtual RobotModel
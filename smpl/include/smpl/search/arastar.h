@@ -35,7 +35,9 @@
 // standard includes
 #include <assert.h>
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <vector>
 
 // system includes
 #include <sbpl/heuristics/heuristic.h>
@@ -43,6 +45,8 @@
 
 // project includes
 #include <smpl/heap/intrusive_heap.h>
+#include <smpl/stats.h>
+#include <smpl/stl/memory.h>
 #include <smpl/time.h>
 
 namespace smpl {
@@ -71,13 +75,14 @@ namespace smpl {
 ///   Often, many graph representations that support multiple or underdefined
 ///   goal states will represent the goal state given to the planner using a
 ///   single goal state ID. If this is the case, the caller will have to assert
-///   whether or not the goal has changed, and force the planner to reinitialize
-///   by calls for force_planning_from_scratch (TODO: shouldn't require full
-///   reinitialization)
+///   whether or not the goal has changed, and either force the planner to
+///   reinitialize via force_planning_from_scratch() or, when search tree
+///   reuse is enabled, call notifyGoalChanged() to resume over the retained
+///   search tree
 ///
 /// * The heuristics for any encountered states remain constant, unless the goal
 ///   state ID has changed.
-class ARAStar : public SBPLPlanner
+class ARAStar : public SBPLPlanner, public MemoryUsageProvider
 {
 public:
 
@@ -134,6 +139,96 @@ public:
     void setBoundExpansions(bool bound) { m_time_params.bounded = bound; }
     bool boundExpansions() const { return m_time_params.bounded; }
 
+    void setParallelExpansions(bool enabled, int num_threads = 0);
+    bool parallelExpansions() const { return m_parallel_expansions; }
+
+    void setPipelinedExpansions(bool enabled);
+    bool pipelinedExpansions() const { return m_pipelined_expansions; }
+
+    /// Enable partial expansions (PEA*): each expansion inserts only the
+    /// successors whose f-values do not exceed the parent's key and reopens
+    /// the parent keyed by the minimum f-value among the deferred
+    /// successors. Re-expansions regenerate successors, trading repeated
+    /// successor generation for a much smaller open list on high-branching
+    /// graphs. Takes effect only for serial expansions.
+    void setPartialExpansions(bool enabled) { m_partial_expansions = enabled; }
+    bool partialExpansions() const { return m_partial_expansions; }
+
+    /// Enable reuse of the search tree between queries that differ only in
+    /// the goal. When the goal state id changes and the start is unchanged,
+    /// the state table, g-values, and open list from the previous query are
+    /// retained; heuristics are recomputed for the new goal and the open
+    /// list re-sorted, so the search resumes from the previous frontier
+    /// instead of expanding from scratch. Cost-to-come values are
+    /// goal-independent, so the reused tree remains valid as long as the
+    /// graph is unchanged; call force_planning_from_scratch() if edge costs
+    /// or the environment change between queries. Edge costs must be
+    /// goal-independent for the retained g-values to be meaningful.
+    void setSearchTreeReuse(bool enabled) { m_reuse_search_tree = enabled; }
+    bool searchTreeReuse() const { return m_reuse_search_tree; }
+
+    /// Notify the search that the goal constraint changed without a change
+    /// to the goal state id, as with graph representations that funnel all
+    /// goal states into a single id. The next call to replan() refreshes
+    /// heuristics and, with search tree reuse enabled, warm-starts from the
+    /// retained search tree rather than reinitializing.
+    void notifyGoalChanged() { m_goal_changed = true; }
+
+    /// Request that an in-progress call to replan() stop before its next
+    /// expansion. Safe to call from a thread other than the one running the
+    /// search. The search returns as if it had run out of time, reporting any
+    /// incumbent solution subject to allowPartialSolutions(). The request is
+    /// cleared at the start of the next call to replan().
+    void cancel() { m_cancel_requested.store(true, std::memory_order_relaxed); }
+
+    /// Request that heuristic values be recomputed and the open list
+    /// reordered before the next expansion, e.g. after a heuristic has
+    /// refined its estimates in the background (see
+    /// BfsHeuristic::setWavefrontCompletionCallback()). Safe to call from a
+    /// thread other than the one running the search; the refresh itself runs
+    /// on the search thread between expansions, using the same machinery as
+    /// the epsilon-change reorder. The request is cleared at the start of
+    /// the next call to replan().
+    void requestHeuristicRefresh()
+    { m_heur_refresh_requested.store(true, std::memory_order_relaxed); }
+
+    using ImprovedSolutionCallback =
+            std::function<void(const std::vector<int>& path, int cost, double eps)>;
+
+    /// Set a callback to be invoked each time the search finds a solution
+    /// satisfying the current suboptimality bound, delivering the solution
+    /// path, its cost, and the satisfied bound. The callback is invoked from
+    /// within replan() before the search continues improving the solution,
+    /// allowing the caller to begin post-processing an incumbent solution
+    /// while the search runs.
+    void setImprovedSolutionCallback(ImprovedSolutionCallback cb) {
+        m_on_improved_solution = std::move(cb);
+    }
+
+    /// Record a STAT_EVENT_SEARCH_ITER event (satisfied epsilon, cumulative
+    /// expansions) and an open list size counter each time a search iteration
+    /// completes. The recorder must outlive the search; null disables
+    /// recording.
+    void setStatsRecorder(StatsRecorder* stats) { m_stats = stats; }
+
+    /// Record an ExpansionRecord for every state expansion. Partial
+    /// re-expansions of a state (see setPartialExpansions()) are recorded
+    /// once per selection from OPEN. The trace must outlive the search; null
+    /// disables tracing.
+    void setExpansionTrace(ExpansionTrace* trace) { m_trace = trace; }
+
+    /// Limit the bytes of search memory allowed per query. When memUsage()
+    /// reaches the budget, the search stops as if it had run out of time,
+    /// returning the incumbent solution, or a partial solution subject to
+    /// allowPartialSolutions(). 0 disables the budget.
+    void setMemoryBudget(size_t bytes) { m_mem_budget = bytes; }
+    size_t memoryBudget() const { return m_mem_budget; }
+
+    /// \name Required Public Functions from MemoryUsageProvider
+    ///@{
+    auto memUsage() const -> size_t override;
+    ///@}
+
     int replan(
         const TimeParameters &params,
         std::vector<int>* solution,
@@ -184,7 +279,12 @@ private:
     struct SearchStateCompare
     {
         bool operator()(const SearchState& s1, const SearchState& s2) const {
-            return s1.f < s2.f;
+            // break f-value ties by state id so the expansion order does not
+            // depend on heap insertion history
+            if (s1.f != s2.f) {
+                return s1.f < s2.f;
+            }
+            return s1.state_id < s2.state_id;
         }
     };
 
@@ -199,7 +299,15 @@ private:
 
     bool m_allow_partial_solutions;
 
-    std::vector<SearchState*> m_states;
+    ImprovedSolutionCallback m_on_improved_solution;
+    StatsRecorder* m_stats;
+    ExpansionTrace* m_trace;
+
+    // search states, indexed by graph state id; chunked so that growth
+    // preserves the addresses held by the open list and back-pointers, while
+    // states with nearby ids stay contiguous for cache-friendly successor
+    // lookups during expansion
+    StableVector<SearchState> m_states;
 
     int m_start_state_id;   // graph state id for the start state
     int m_goal_state_id;    // graph state id for the goal state
@@ -214,6 +322,28 @@ private:
     std::vector<int> m_succs;
     std::vector<int> m_costs;
 
+    // scratch buffer collecting the states an expansion newly inserts into
+    // OPEN, batch-pushed once all successors have been relaxed
+    std::vector<SearchState*> m_new_open;
+
+    // parallel expansion mode; see setParallelExpansions()
+    bool m_parallel_expansions;
+    int m_num_expansion_threads;
+
+    // partial expansion mode; see setPartialExpansions()
+    bool m_partial_expansions;
+
+    // pipelined expansion mode; see setPipelinedExpansions()
+    bool m_pipelined_expansions;
+
+    // search tree reuse mode; see setSearchTreeReuse()
+    bool m_reuse_search_tree;
+    bool m_goal_changed;
+
+    std::vector<SearchState*> m_batch;
+    std::vector<std::vector<int>> m_batch_succs;
+    std::vector<std::vector<int>> m_batch_costs;
+
     int m_call_number;          // for lazy reinitialization of search states
     int m_last_start_state_id;  // for lazy reinitialization of the search tree
     int m_last_goal_state_id;   // for updating the search tree when the goal changes
@@ -224,8 +354,15 @@ private:
     int m_expand_count;
     clock::duration m_search_time;
 
+    coarse_timer m_timer;   // amortized deadline checking in improvePath()
+
     double m_satisfied_eps;
 
+    std::atomic<bool> m_cancel_requested;
+    std::atomic<bool> m_heur_refresh_requested;
+
+    size_t m_mem_budget;    // see setMemoryBudget(); 0 = unlimited
+
     void convertTimeParamsToReplanParams(
         const TimeParameters& t,
         ReplanParams& r) const;
@@ -237,20 +374,29 @@ private:
         int elapsed_expansions,
         const clock::duration& elapsed_time) const;
 
+    int improvePathPipelined(
+        SearchState* goal_state,
+        int& elapsed_expansions,
+        clock::duration& elapsed_time);
+
     int improvePath(
-        const clock::time_point& start_time,
         SearchState* goal_state,
         int& elapsed_expansions,
         clock::duration& elapsed_time);
 
     void expand(SearchState* s);
+    void expandPartial(SearchState* s);
+    void expandBatch(SearchState* goal_state);
+    void updateSuccs(
+        SearchState* s,
+        const std::vector<int>& succs,
+        const std::vector<int>& costs);
 
     void recomputeHeuristics();
     void reorderOpen();
     int computeKey(SearchState* s) const;
 
     SearchState* getSearchState(int state_id);
-    SearchState* createState(int state_id);
     void reinitSearchState(SearchState* state);
 
     void extractPath(
@@ -32,6 +32,10 @@
 #ifndef SMPL_AWASTAR_H
 #define SMPL_AWASTAR_H
 
+// standard includes
+#include <functional>
+#include <vector>
+
 // system includes
 #include <sbpl/heuristics/heuristic.h>
 #include <sbpl/planners/planner.h>
@@ -78,6 +82,16 @@ struct AWAStar : public SBPLPlanner
     AWAStar(DiscreteSpaceInformation* space, Heuristic* heuristic);
     ~AWAStar();
 
+    using ImprovedSolutionCallback =
+            std::function<void(const std::vector<int>& path, int cost, double eps)>;
+
+    /// Set a callback to be invoked each time the search discovers a new
+    /// incumbent solution, delivering the solution path, its cost, and the
+    /// current suspension bound, without stopping the search.
+    void setImprovedSolutionCallback(ImprovedSolutionCallback cb) {
+        m_on_improved_solution = std::move(cb);
+    }
+
     /// \name Required Functions from SBPLPlanner
     ///@{
     int replan(double allowed_time_secs, std::vector<int>* solution) override {
@@ -137,6 +151,8 @@ struct AWAStar : public SBPLPlanner
     DiscreteSpaceInformation*   m_space = nullptr;
     Heuristic*                  m_heur = nullptr;
 
+    ImprovedSolutionCallback    m_on_improved_solution;
+
     std::vector<SearchState*>   m_states;
     OpenList                    m_open;
     std::vector<SearchState*>   m_suspended;
@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_BOUNDED_COST_SEARCH_H
+#define SMPL_BOUNDED_COST_SEARCH_H
+
+// standard includes
+#include <cstdint>
+#include <vector>
+
+// system includes
+#include <sbpl/heuristics/heuristic.h>
+#include <sbpl/planners/planner.h>
+
+// project includes
+#include <smpl/heap/intrusive_heap.h>
+#include <smpl/time.h>
+
+namespace smpl {
+
+class RobotPlanningSpace;
+
+/// An implementation of the Potential Search algorithm, a bounded-cost
+/// variant of best-first search. Rather than minimizing solution cost within
+/// a suboptimality factor, the search is given an absolute cost bound C and
+/// returns the first solution whose cost does not exceed it, typically far
+/// faster than a weighted A* tuned to an equivalent epsilon.
+///
+/// States are ordered by their potential, the ratio (C - g(s)) / h(s), which
+/// under an admissible heuristic prefers the state most likely to lead to a
+/// solution within the bound. States whose f-value exceeds the bound are
+/// pruned outright; with an admissible heuristic they cannot be part of any
+/// solution within the bound.
+///
+/// The search reuses its effort between calls to replan() as long as the
+/// start, goal, and cost bound are unchanged, under the same state-id and
+/// heuristic assumptions documented for ARAStar.
+struct BoundedCostSearch : public SBPLPlanner
+{
+    BoundedCostSearch(DiscreteSpaceInformation* space, Heuristic* heuristic);
+    ~BoundedCostSearch();
+
+    /// Set the absolute cost bound. Any solution returned by replan() costs
+    /// at most this much. The search restarts when the bound changes.
+    void setCostBound(int bound) { m_cost_bound = bound; }
+    int costBound() const { return m_cost_bound; }
+
+    /// \name Required Functions from SBPLPlanner
+    ///@{
+    int replan(double allowed_time_secs, std::vector<int>* solution) override {
+        return replan(allowed_time_secs, solution, nullptr);
+    }
+
+    int replan(double allowed_time_secs, std::vector<int>* solution, int* solcost) override;
+    int set_goal(int state_id) override;
+    int set_start(int state_id) override;
+    int force_planning_from_scratch() override;
+    int set_search_mode(bool bSearchUntilFirstSolution) override;
+    void costs_changed(const StateChangeQuery& stateChange) override;
+    ///@}
+
+    /// \name Reimplemented Functions from SBPLPlanner
+    ///@{
+    int replan(std::vector<int>* solution, ReplanParams params) override;
+    int replan(std::vector<int>* solution, ReplanParams params, int* solcost) override;
+    int force_planning_from_scratch_and_free_memory() override;
+    double get_solution_eps() const override;
+    int get_n_expands() const override { return m_expands; }
+    double get_initial_eps() override;
+    double get_initial_eps_planning_time() override;
+    double get_final_eps_planning_time() override;
+    int get_n_expands_init_solution() override;
+    double get_final_epsilon() override;
+    void get_search_stats(std::vector<PlannerStats>* s) override;
+    void set_initialsolution_eps(double eps) override { }
+    ///@}
+
+    struct SearchState : public heap_element
+    {
+        SearchState* bp;
+
+        int state_id;
+        int g;      // cost-to-come
+        int h;      // estimated cost-to-go
+        short call_number;
+        bool closed;
+    };
+
+    // order by descending potential (C - g) / h; the comparison is performed
+    // by cross-multiplication to stay in exact integer arithmetic
+    struct SearchStateCompare
+    {
+        const BoundedCostSearch* search;
+
+        bool operator()(const SearchState& s1, const SearchState& s2) const {
+            const int64_t p1 =
+                    (int64_t)(search->m_cost_bound - s1.g) * (int64_t)s2.h;
+            const int64_t p2 =
+                    (int64_t)(search->m_cost_bound - s2.g) * (int64_t)s1.h;
+            if (p1 != p2) {
+                return p1 > p2;
+            }
+            // prefer deeper states among equal potentials
+            return s1.g > s2.g;
+        }
+    };
+
+    using OpenList = intrusive_heap<SearchState, SearchStateCompare>;
+
+    DiscreteSpaceInformation*   m_space = nullptr;
+    // the graph again, when it supports streaming successor generation;
+    // null => fall back to batched GetSuccs
+    RobotPlanningSpace*         m_stream_space = nullptr;
+    Heuristic*                  m_heur = nullptr;
+
+    std::vector<SearchState*>   m_states;
+    OpenList                    m_open;
+
+    int                         m_cost_bound = INFINITECOST;
+
+    int                         m_start_state_id = -1;
+    int                         m_goal_state_id = -1;
+
+    int                         m_call_number = 0;
+    int                         m_last_start_id = -1;
+    int                         m_last_goal_id = -1;
+    int                         m_last_bound = -1;
+
+    int                         m_expands = 0;
+    double                      m_search_time = 0.0;
+
+    SearchState* getSearchState(int state_id);
+    void updateSuccessor(SearchState* state, int succ_id, int cost);
+    void reinitSearchState(SearchState* state);
+
+    void extractPath(
+        SearchState* to_state,
+        std::vector<int>& solution,
+        int& cost) const;
+};
+
+} // namespace smpl
+
+#endif
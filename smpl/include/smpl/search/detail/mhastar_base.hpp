@@ -43,6 +43,7 @@
 // project includes
 #include <smpl/time.h>
 #include <smpl/console/console.h>
+#include <smpl/heuristic/robot_heuristic.h>
 
 namespace smpl {
 
@@ -57,6 +58,8 @@ MHAStarBase<Derived>::MHAStarBase(
     m_hanchor(hanchor),
     m_heurs(heurs),
     m_hcount(hcount),
+    m_robot_heurs(),
+    m_h_values(),
     m_params(0.0),
     m_max_expansions(0),
     m_eps(1.0),
@@ -74,6 +77,18 @@ MHAStarBase<Derived>::MHAStarBase(
 
     m_open = new rank_pq[hcount + 1];
 
+    // if every heuristic is a RobotHeuristic, per-state values may be
+    // evaluated in one batch, sharing intermediate results between searches
+    m_robot_heurs.push_back(dynamic_cast<RobotHeuristic*>(hanchor));
+    for (int i = 0; i < hcount; ++i) {
+        m_robot_heurs.push_back(dynamic_cast<RobotHeuristic*>(heurs[i]));
+    }
+    auto is_null = [](const RobotHeuristic* h) { return h == nullptr; };
+    if (std::any_of(m_robot_heurs.begin(), m_robot_heurs.end(), is_null)) {
+        m_robot_heurs.clear();
+    }
+    m_h_values.resize(num_heuristics());
+
     // Overwrite default members for ReplanParams to represent a single optimal
     // search
     m_params.initial_eps = 1.0;
@@ -182,7 +197,7 @@ int MHAStarBase<Derived>::replan(
     m_num_expansions = 0;
     m_elapsed = 0.0;
 
-    auto start_time = smpl::clock::now();
+    m_timer.start();
 
     ++m_call_number;
     reinit_state(m_goal_state);
@@ -203,11 +218,13 @@ int MHAStarBase<Derived>::replan(
 
     reinitSearch();
 
-    auto end_time = smpl::clock::now();
-    m_elapsed += to_seconds(end_time - start_time);
+    // every queue starts out active; -1 never matches a real key
+    m_queue_last_minf.assign(num_heuristics(), -1);
+    m_queue_idle.assign(num_heuristics(), 0);
+
+    m_elapsed = to_seconds(m_timer.update());
 
     while (!m_open[0].empty() && !time_limit_reached()) {
-        auto start_time = smpl::clock::now();
 
         for (int hidx = 1; hidx < num_heuristics(); ++hidx) {
             if (m_open[0].empty()) {
@@ -222,9 +239,29 @@ int MHAStarBase<Derived>::replan(
             }
 
             if (!m_open[hidx].empty()) {
+                const int minf = get_minf(m_open[hidx]);
+                if (minf != m_queue_last_minf[hidx]) {
+                    // the heap changed since this queue's last round;
+                    // re-activate it
+                    m_queue_idle[hidx] = 0;
+                } else if (m_queue_idle[hidx] >= MaxStaleRounds) {
+                    // same best key and a run of unproductive expansions;
+                    // give this queue's rounds to the others until its heap
+                    // changes
+                    continue;
+                }
+
                 MHASearchState* s = select_state(hidx);
-                expand(s, hidx);
+                if (expand(s, hidx)) {
+                    m_queue_idle[hidx] = 0;
+                } else {
+                    ++m_queue_idle[hidx];
+                }
                 s->closed_in_add = true;
+
+                // the key this queue will present when its next round comes
+                m_queue_last_minf[hidx] =
+                        m_open[hidx].empty() ? -1 : get_minf(m_open[hidx]);
             } else {
                 SMPL_WARN("PSET empty during inadmissible expansions?");
             }
@@ -244,10 +281,11 @@ int MHAStarBase<Derived>::replan(
             onClosedAnchor(s);
         }
 
-        auto end_time = smpl::clock::now();
-        m_elapsed += to_seconds(end_time - start_time);
+        m_elapsed = to_seconds(m_timer.tick());
     }
 
+    m_elapsed = to_seconds(m_timer.update());
+
     if (m_open[0].empty()) {
         SMPL_INFO("Anchor search exhausted");
     }
@@ -437,7 +475,8 @@ MHASearchState* MHAStarBase<Derived>::get_state(int state_id)
         const size_t state_size =
                 sizeof(MHASearchState) +
                 sizeof(MHASearchState::HeapData) * (m_hcount);
-        MHASearchState* s = (MHASearchState*)malloc(state_size);
+        MHASearchState* s = (MHASearchState*)m_arena.allocate(
+                state_size, alignof(MHASearchState));
 
         // force construction to correctly initialize heap position to null
         new (s) MHASearchState;
@@ -464,17 +503,12 @@ void MHAStarBase<Derived>::clear()
 {
     clear_open_lists();
 
-    // free states
-    for (size_t i = 0; i < m_search_states.size(); ++i) {
-        // unmap graph to search state
-        MHASearchState* search_state = m_search_states[i];
-
-        // free search state
-        free(m_search_states[i]);
-    }
+    // free states in bulk; search states are trivially destructible
+    m_arena.release();
 
     // empty state table
     m_search_states.clear();
+    m_graph_to_search_state.clear();
 
     m_start_state = nullptr;
     m_goal_state = nullptr;
@@ -490,15 +524,14 @@ void MHAStarBase<Derived>::init_state(
     state->closed_in_anc = false;
     state->closed_in_add = false;
     for (int i = 0; i < num_heuristics(); ++i) {
-        state->od[i].f = compute_heuristic(state->state_id, i);
         state->od[i].me = state;
     }
+    // heuristic values are filled in by reinit_state when the state is first
+    // touched during a search iteration
 
     SMPL_DEBUG_STREAM("Initialized state: " << *state);
     for (int i = 0; i < num_heuristics(); ++i) {
         SMPL_DEBUG("  me[%d]: %p", i, state->od[i].me);
-        SMPL_DEBUG("  h[%d]: %d", i, state->od[i].h);
-        SMPL_DEBUG("  f[%d]: %d", i, state->od[i].f);
     }
 }
 
@@ -516,8 +549,24 @@ void MHAStarBase<Derived>::reinit_state(MHASearchState* state)
         state->closed_in_anc = false;
         state->closed_in_add = false;
 
+        if (!m_robot_heurs.empty()) {
+            // batched evaluation shares the state's projection between
+            // heuristics instead of recomputing it for every queue
+            GetGoalHeuristics(
+                    m_robot_heurs.data(),
+                    num_heuristics(),
+                    state->state_id,
+                    m_h_values.data());
+            for (int i = 0; i < num_heuristics(); ++i) {
+                state->od[i].h = m_h_values[i];
+            }
+        } else {
+            for (int i = 0; i < num_heuristics(); ++i) {
+                state->od[i].h = compute_heuristic(state->state_id, i);
+            }
+        }
+
         for (int i = 0; i < num_heuristics(); ++i) {
-            state->od[i].h = compute_heuristic(state->state_id, i);
             state->od[i].f = INFINITECOST;
         }
 
@@ -554,8 +603,11 @@ int MHAStarBase<Derived>::compute_key(MHASearchState* state, int hidx)
     }
 }
 
+// Expand a state, relaxing the paths to its successors. Returns true if any
+// successor's g-value improved, the productivity signal for queue staleness
+// tracking.
 template <typename Derived>
-void MHAStarBase<Derived>::expand(MHASearchState* state, int hidx)
+bool MHAStarBase<Derived>::expand(MHASearchState* state, int hidx)
 {
     SMPL_INFO("Expanding state %d in search %d", state->state_id, hidx);
 
@@ -575,6 +627,11 @@ void MHAStarBase<Derived>::expand(MHASearchState* state, int hidx)
     environment_->GetSuccs(state->state_id, &succ_ids, &costs);
     assert(succ_ids.size() == costs.size());
 
+    if (m_pending_open.size() != (size_t)num_heuristics()) {
+        m_pending_open.resize(num_heuristics());
+    }
+
+    bool improved = false;
     for (size_t sidx = 0; sidx < succ_ids.size(); ++sidx)  {
         const int cost = costs[sidx];
         MHASearchState* succ_state = get_state(succ_ids[sidx]);
@@ -582,11 +639,12 @@ void MHAStarBase<Derived>::expand(MHASearchState* state, int hidx)
 
         int new_g = state->g + costs[sidx];
         if (new_g < succ_state->g) {
+            improved = true;
             succ_state->g = new_g;
             succ_state->bp = state;
             if (!closed_in_anc_search(succ_state)) {
                 succ_state->od[0].f = compute_key(succ_state, 0);
-                insert_or_update(succ_state, 0);
+                defer_insert_or_update(succ_state, 0);
 
                 // unless it's been closed in an inadmissible search...
                 if (closed_in_add_search(succ_state)) {
@@ -596,11 +654,20 @@ void MHAStarBase<Derived>::expand(MHASearchState* state, int hidx)
                 // insert into the P-SET for each heuristic
                 for (int hidx = 1; hidx < num_heuristics(); ++hidx) {
                     succ_state->od[hidx].f = compute_key(succ_state, hidx);
-                    insert_or_update(succ_state, hidx);
+                    defer_insert_or_update(succ_state, hidx);
                 }
             }
         }
     }
+
+    // restore each heap in one pass over the deferred insertions
+    for (int hidx = 0; hidx < num_heuristics(); ++hidx) {
+        auto& pending = m_pending_open[hidx];
+        m_open[hidx].push(pending.begin(), pending.end());
+        pending.clear();
+    }
+
+    return improved;
 }
 
 template <typename Derived>
@@ -636,6 +703,25 @@ void MHAStarBase<Derived>::insert_or_update(MHASearchState* state, int hidx)
     }
 }
 
+// Like insert_or_update(), but defer the insertion of new entries to the
+// batch push at the end of the expansion; duplicate successors update the
+// deferred entry in place.
+template <typename Derived>
+void MHAStarBase<Derived>::defer_insert_or_update(MHASearchState* state, int hidx)
+{
+    if (m_open[hidx].contains(&state->od[hidx])) {
+        m_open[hidx].update(&state->od[hidx]);
+        return;
+    }
+
+    auto& pending = m_pending_open[hidx];
+    if (std::find(pending.begin(), pending.end(), &state->od[hidx]) ==
+            pending.end())
+    {
+        pending.push_back(&state->od[hidx]);
+    }
+}
+
 template <typename Derived>
 MHASearchState* MHAStarBase<Derived>::select_state(int hidx)
 {
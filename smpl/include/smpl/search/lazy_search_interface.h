@@ -29,6 +29,9 @@
 
 /// \author Andrew Dornbush
 
+#ifndef SMPL_LAZY_SEARCH_INTERFACE_H
+#define SMPL_LAZY_SEARCH_INTERFACE_H
+
 #include <vector>
 
 namespace smpl {
@@ -61,6 +64,23 @@ struct ILazySuccFun {
         std::vector<bool>& true_costs) = 0;
 
     virtual int GetSuccTrueCost(int state_id, int succ_id) = 0;
+
+    /// Evaluate the true costs of the transitions from each state in \p
+    /// state_ids to \p succ_id. Costs are returned in the order of \p
+    /// state_ids; a negative cost marks an invalid transition. The default
+    /// implementation evaluates each transition in turn; graphs whose edge
+    /// evaluations are independent (e.g. collision sweeps against private
+    /// collision states) may override this to evaluate them concurrently.
+    virtual void GetSuccTrueCosts(
+        const std::vector<int>& state_ids,
+        int succ_id,
+        std::vector<int>& costs)
+    {
+        costs.resize(state_ids.size());
+        for (size_t i = 0; i < state_ids.size(); ++i) {
+            costs[i] = GetSuccTrueCost(state_ids[i], succ_id);
+        }
+    }
 };
 
 struct ILazyPredFun {
@@ -75,3 +95,5 @@ struct ILazyPredFun {
 };
 
 } // namespace smpl
+
+#endif
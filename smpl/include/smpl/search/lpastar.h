@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_LPASTAR_H
+#define SMPL_LPASTAR_H
+
+// standard includes
+#include <utility>
+#include <vector>
+
+// system includes
+#include <sbpl/heuristics/heuristic.h>
+#include <sbpl/planners/planner.h>
+
+// project includes
+#include <smpl/heap/intrusive_heap.h>
+#include <smpl/time.h>
+
+namespace smpl {
+
+/// An implementation of the LPA* (Lifelong Planning A*) search algorithm for
+/// incremental replanning. The search maintains g-values and one-step
+/// lookahead rhs-values between calls to replan() and, when notified of edge
+/// cost changes via costs_changed(), repairs only the states whose values are
+/// invalidated rather than searching from scratch. This is intended for
+/// replanning loops where the map changes incrementally between queries while
+/// the start and goal remain fixed; if the start changes, the search is
+/// reinitialized.
+///
+/// The search only discovers edges through calls to GetSuccs() and maintains
+/// the transpose of the discovered portion of the graph internally, so the
+/// planning space is not required to implement GetPreds(). Consequently,
+/// costs_changed() expects the set of states whose *outgoing* edges have
+/// changed (via StateChangeQuery::getPredecessors()); the search re-evaluates
+/// the outgoing edges of those states and repairs their successors.
+class LPAStar : public SBPLPlanner
+{
+public:
+
+    LPAStar(DiscreteSpaceInformation* space, Heuristic* heur);
+    ~LPAStar();
+
+    /// \name Required Functions from SBPLPlanner
+    ///@{
+    int replan(double allowed_time_secs, std::vector<int>* solution) override;
+    int replan(double allowed_time_secs, std::vector<int>* solution, int* solcost) override;
+    int set_goal(int state_id) override;
+    int set_start(int state_id) override;
+    int force_planning_from_scratch() override;
+    int set_search_mode(bool bSearchUntilFirstSolution) override;
+    void costs_changed(const StateChangeQuery& stateChange) override;
+    ///@}
+
+    /// \name Reimplemented Functions from SBPLPlanner
+    ///@{
+    int force_planning_from_scratch_and_free_memory() override;
+    double get_solution_eps() const override;
+    int get_n_expands() const override;
+    double get_initial_eps() override;
+    double get_initial_eps_planning_time() override;
+    double get_final_eps_planning_time() override;
+    int get_n_expands_init_solution() override;
+    double get_final_epsilon() override;
+    void get_search_stats(std::vector<PlannerStats>* s) override;
+    void set_initialsolution_eps(double eps) override;
+    ///@}
+
+private:
+
+    struct SearchState;
+
+    // a recorded in-edge of a state, discovered during an expansion
+    struct InEdge
+    {
+        SearchState* pred;
+        int cost;
+    };
+
+    struct SearchState : public heap_element
+    {
+        int state_id;       // corresponding graph state
+        unsigned int g;     // cost-to-come
+        unsigned int rhs;   // one-step lookahead cost-to-come
+        unsigned int h;     // estimated cost-to-go
+        unsigned int k1;    // primary key at time of insertion into OPEN
+        unsigned int k2;    // secondary key at time of insertion into OPEN
+        unsigned short call_number;
+        bool expanded;      // have this state's out-edges been discovered
+        std::vector<InEdge> preds;
+    };
+
+    struct SearchStateCompare
+    {
+        bool operator()(const SearchState& s1, const SearchState& s2) const {
+            return (s1.k1 < s2.k1) || (s1.k1 == s2.k1 && s1.k2 < s2.k2);
+        }
+    };
+
+    DiscreteSpaceInformation* m_space;
+    Heuristic* m_heur;
+
+    // states own their discovered in-edge lists, so they are allocated
+    // individually rather than from an arena
+    std::vector<SearchState*> m_states;
+
+    int m_start_state_id;   // graph state id for the start state
+    int m_goal_state_id;    // graph state id for the goal state
+
+    intrusive_heap<SearchState, SearchStateCompare> m_open;
+
+    int m_call_number;          // for lazy reinitialization of search states
+    int m_last_start_state_id;  // for reinitialization when the start changes
+    int m_last_goal_state_id;   // for recomputing heuristics when the goal changes
+
+    std::vector<int> m_succs;
+    std::vector<int> m_costs;
+
+    int m_expand_count;
+    clock::duration m_search_time;
+
+    bool m_first_solution_unbounded;
+
+    int computeShortestPath(
+        SearchState* goal_state,
+        const clock::time_point& start_time,
+        clock::duration allowed_time);
+
+    void expand(SearchState* s);
+    void updateState(SearchState* s);
+    void computeKeys(SearchState* s) const;
+    bool keyLess(const SearchState* s, const SearchState* t) const;
+
+    void reinitSearch();
+    void recomputeHeuristics();
+
+    SearchState* getSearchState(int state_id);
+    SearchState* createState(int state_id);
+    void reinitSearchState(SearchState* state);
+
+    void extractPath(
+        SearchState* goal_state,
+        std::vector<int>& solution,
+        int& cost) const;
+};
+
+} // namespace smpl
+
+#endif
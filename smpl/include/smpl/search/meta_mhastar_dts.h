@@ -33,9 +33,11 @@
 #define SMPL_META_MHASTAR_DTS_H
 
 // standard includes
+#include <fstream>
 #include <iomanip>
 #include <ostream>
 #include <random>
+#include <string>
 
 // system includes
 #include <sbpl/heuristics/heuristic.h>
@@ -123,6 +125,61 @@ public:
 
     ///@}
 
+    /// \name Queue-Selection Posterior
+    ///@{
+
+    /// Return the Dirichlet/beta posterior over queue selection learned
+    /// during the last call to replan().
+    void get_dts_posterior(
+        std::vector<double>& alphas,
+        std::vector<double>& betas) const;
+
+    /// Seed the queue-selection posterior for subsequent calls to replan(),
+    /// in place of the uniform (1, 1) prior. The seed is decayed toward the
+    /// uniform prior as 1 + decay * (seed - 1), with decay in [0, 1]; a decay
+    /// of 0 reproduces the uniform prior and a decay of 1 resumes from the
+    /// seed unchanged. The seed persists across calls to replan() until it is
+    /// replaced or cleared.
+    void seed_dts_posterior(
+        const std::vector<double>& alphas,
+        const std::vector<double>& betas,
+        double decay);
+
+    /// Clear any seed posterior, restoring the uniform prior at the start of
+    /// each call to replan().
+    void clear_dts_posterior_seed();
+
+    ///@}
+
+    /// \name Deterministic Replay
+    ///@{
+
+    /// Set the seed applied to the queue-selection rng at the start of each
+    /// call to replan(). The default seed is 0, so runs with identical
+    /// inputs are already repeatable; distinct seeds produce distinct,
+    /// individually repeatable sampling sequences.
+    void set_rng_seed(unsigned int seed);
+
+    /// Record every queue-selection decision to the given file, one chosen
+    /// queue index per line, flushed as it is made so the log survives an
+    /// interrupted run. Together with the rng seed and stable heap
+    /// tie-breaking, the log allows a production run to be reproduced
+    /// decision-for-decision via replay_decisions(). Returns false if the
+    /// file cannot be opened for writing.
+    bool record_decisions(const std::string& path);
+
+    /// Replay queue-selection decisions from a file written by
+    /// record_decisions(), in place of posterior sampling, until the
+    /// recorded decisions are exhausted; sampling resumes thereafter.
+    /// Returns false, and replays nothing, if the file cannot be read or
+    /// holds an out-of-range queue index.
+    bool replay_decisions(const std::string& path);
+
+    /// Stop recording and discard any unconsumed replay decisions.
+    void clear_decision_io();
+
+    ///@}
+
 private:
 
     // Related objects
@@ -155,13 +212,30 @@ private:
     std::vector<double> m_alphas;
     std::vector<double> m_betas;
 
+    // posterior seed applied at the start of each episode in place of the
+    // uniform (1, 1) prior; see seed_dts_posterior()
+    std::vector<double> m_seed_alphas;
+    std::vector<double> m_seed_betas;
+    double m_seed_decay;
+
+    // deterministic replay state; see set_rng_seed() and record_decisions()
+    unsigned int m_rng_seed;
+    std::ofstream m_record_file;
+    std::vector<int> m_replay_decisions;
+    size_t m_replay_pos;
+
     struct HeapCompare
     {
         bool operator()(
             const MHASearchState::HeapData& s,
             const MHASearchState::HeapData& t) const
         {
-            return s.f < t.f;
+            // break f-value ties by state id so the expansion order does not
+            // depend on heap insertion history
+            if (s.f != t.f) {
+                return s.f < t.f;
+            }
+            return s.me->state_id < t.me->state_id;
         }
     };
 
@@ -35,6 +35,7 @@
 // standard includes
 #include <ostream>
 #include <iomanip>
+#include <vector>
 
 // system includes
 #include <boost/tti/has_member_function.hpp>
@@ -44,9 +45,13 @@
 
 // project includes
 #include <smpl/heap/intrusive_heap.h>
+#include <smpl/stl/memory.h>
+#include <smpl/time.h>
 
 namespace smpl {
 
+class RobotHeuristic;
+
 struct MHASearchState
 {
     int call_number;
@@ -163,6 +168,11 @@ private:
     Heuristic** m_heurs;
     int m_hcount;           // number of additional heuristics used
 
+    // the heuristics, anchor first, when they are all RobotHeuristics, so
+    // that per-state values may be evaluated in one batch; empty otherwise
+    std::vector<RobotHeuristic*> m_robot_heurs;
+    std::vector<int> m_h_values;    // scratch buffer for batched evaluation
+
     ReplanParams m_params;
     int m_max_expansions;
 
@@ -173,6 +183,7 @@ private:
 
     int m_num_expansions;   // current number of expansion
     double m_elapsed;       // current amount of seconds
+    coarse_timer m_timer;   // amortized deadline checking during the search
 
     int m_call_number;
 
@@ -181,6 +192,7 @@ private:
 
     std::vector<MHASearchState*> m_search_states;
     std::vector<int> m_graph_to_search_state;
+    ObjectArena m_arena;    // storage for search states
 
     struct HeapCompare
     {
@@ -188,7 +200,12 @@ private:
             const MHASearchState::HeapData& s,
             const MHASearchState::HeapData& t) const
         {
-            return s.f < t.f;
+            // break f-value ties by state id so the expansion order does not
+            // depend on heap insertion history
+            if (s.f != t.f) {
+                return s.f < t.f;
+            }
+            return s.me->state_id < t.me->state_id;
         }
     };
 
@@ -201,6 +218,23 @@ private:
     // and satisfy the P-CRITERION
     rank_pq* m_open;
 
+    // number of consecutive unproductive rounds, with an unchanged minimum
+    // key, after which an additional queue forfeits its rounds until its heap
+    // changes
+    static const int MaxStaleRounds = 4;
+
+    // queue-level staleness tracking for the additional searches; a queue
+    // whose minimum key is unchanged since its last round and whose recent
+    // expansions improved no path is skipped, concentrating rounds on the
+    // queues making progress; the anchor expands every round regardless, so
+    // the suboptimality bound is unaffected
+    std::vector<int> m_queue_last_minf; // min key after the last round taken
+    std::vector<int> m_queue_idle;      // consecutive unproductive rounds
+
+    // per-queue scratch buffers collecting the heap entries an expansion
+    // newly inserts, batch-pushed once all successors have been relaxed
+    std::vector<std::vector<MHASearchState::HeapData*>> m_pending_open;
+
     bool check_params(const ReplanParams& params);
 
     bool time_limit_reached() const;
@@ -213,11 +247,12 @@ private:
     void clear_open_lists();
     void clear();
     int compute_key(MHASearchState* state, int hidx);
-    void expand(MHASearchState* state, int hidx);
+    bool expand(MHASearchState* state, int hidx);
     MHASearchState* state_from_open_state(MHASearchState::HeapData* open_state);
     int compute_heuristic(int state_id, int hidx);
     int get_minf(rank_pq& pq) const;
     void insert_or_update(MHASearchState* state, int hidx);
+    void defer_insert_or_update(MHASearchState* state, int hidx);
     MHASearchState* select_state(int hidx);
 
     void extract_path(std::vector<int>* solution_path, int* solcost);
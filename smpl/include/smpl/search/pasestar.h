@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_PASESTAR_H
+#define SMPL_PASESTAR_H
+
+// standard includes
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// system includes
+#include <sbpl/heuristics/heuristic.h>
+#include <sbpl/planners/planner.h>
+
+// project includes
+#include <smpl/heap/intrusive_heap.h>
+#include <smpl/time.h>
+
+namespace smpl {
+
+/// A bounded-suboptimal parallel weighted A* search in the style of PA*SE.
+/// Worker threads claim states from a shared open list and evaluate their
+/// outgoing edges concurrently, so that expensive edge evaluations (collision
+/// checks) overlap instead of serializing on one core. The open list and
+/// search state updates are serialized on a single mutex; edge evaluations,
+/// which dominate, run unlocked.
+///
+/// PA*SE preserves its bound by only expanding states whose g-values cannot be
+/// lowered by any state ahead of them, which requires pairwise heuristics
+/// between arbitrary states. Those are not available through the SBPL
+/// heuristic interface, so this search instead allows states to be re-expanded
+/// whenever their g-value improves and accounts for in-flight expansions in
+/// its termination test: the search stops once the cost of the best solution
+/// found is no greater than the priority of any queued or in-flight state.
+/// Under a consistent heuristic inflated by eps this guarantees the returned
+/// solution costs no more than eps times the optimal solution cost, at the
+/// price of occasional re-expansions.
+///
+/// The graph must support concurrent calls to GetSuccs() from multiple threads
+/// (e.g. its collision checker and kinematics must be thread-safe) for this
+/// search to be safe. A thread count of 1 degenerates to serial weighted A*.
+struct PASEStar : public SBPLPlanner
+{
+    /// \param num_threads The number of expansion threads; a value of 0
+    ///     selects the hardware concurrency
+    PASEStar(
+        DiscreteSpaceInformation* space,
+        Heuristic* heuristic,
+        int num_threads = 0);
+    ~PASEStar();
+
+    /// \name Required Functions from SBPLPlanner
+    ///@{
+    int replan(double allowed_time_secs, std::vector<int>* solution) override;
+    int replan(double allowed_time_secs, std::vector<int>* solution, int* solcost) override;
+    int set_goal(int state_id) override;
+    int set_start(int state_id) override;
+    int force_planning_from_scratch() override;
+    int set_search_mode(bool bSearchUntilFirstSolution) override;
+    void costs_changed(const StateChangeQuery& stateChange) override;
+    ///@}
+
+    /// \name Reimplemented Functions from SBPLPlanner
+    ///@{
+    int replan(std::vector<int>* solution, ReplanParams params) override;
+    int replan(std::vector<int>* solution, ReplanParams params, int* solcost) override;
+    int force_planning_from_scratch_and_free_memory() override;
+    double get_solution_eps() const override;
+    int get_n_expands() const override;
+    double get_initial_eps() override;
+    double get_initial_eps_planning_time() override;
+    double get_final_eps_planning_time() override;
+    int get_n_expands_init_solution() override;
+    double get_final_epsilon() override;
+    void get_search_stats(std::vector<PlannerStats>* s) override;
+    void set_initialsolution_eps(double eps) override;
+    ///@}
+
+    struct SearchState : public heap_element
+    {
+        int state_id;       // corresponding graph state
+        int g;              // cost-to-come
+        int h;              // estimated cost-to-go
+        int f;              // g + eps * h at time of insertion into OPEN
+        short call_number;  // for lazy reinitialization of search states
+        SearchState* bp;    // current best predecessor
+    };
+
+    struct SearchStateCompare
+    {
+        bool operator()(const SearchState& s1, const SearchState& s2) const {
+            return s1.f < s2.f;
+        }
+    };
+
+    using OpenList = intrusive_heap<SearchState, SearchStateCompare>;
+
+    DiscreteSpaceInformation*   m_space = nullptr;
+    Heuristic*                  m_heur = nullptr;
+
+    std::vector<SearchState*>   m_states;
+
+    int                         m_start_state_id = -1;
+    int                         m_goal_state_id = -1;
+
+    int                         m_call_number = 0;
+    int                         m_last_start_state_id = -1;
+    int                         m_last_goal_state_id = -1;
+
+    double                      m_eps = 5.0;
+    int                         m_num_threads;
+
+    // shared search state, guarded by m_mutex during the search
+    OpenList                    m_open;
+    std::vector<SearchState*>   m_being_expanded;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_cv;
+    bool                        m_done = false;
+    bool                        m_found = false;
+    bool                        m_timed_out = false;
+
+    int                         m_expand_count = 0;
+    clock::duration             m_search_time = clock::duration::zero();
+
+    void workerLoop(clock::time_point deadline);
+    bool goalConditionMet(const SearchState* min_state) const;
+
+    void reinitSearch();
+
+    SearchState* getSearchState(int state_id);
+    SearchState* createState(int state_id);
+    void reinitSearchState(SearchState* state);
+
+    int computeFval(const SearchState* s) const;
+
+    void extractPath(
+        SearchState* goal_state,
+        std::vector<int>& solution,
+        int& cost) const;
+};
+
+} // namespace smpl
+
+#endif
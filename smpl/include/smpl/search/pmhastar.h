@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SMPL_PMHASTAR_H
+#define SMPL_PMHASTAR_H
+
+// standard includes
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// system includes
+#include <sbpl/heuristics/heuristic.h>
+#include <sbpl/planners/planner.h>
+
+// project includes
+#include <smpl/heap/intrusive_heap.h>
+#include <smpl/time.h>
+
+namespace smpl {
+
+/// A parallel variant of shared multi-heuristic A*. Each inadmissible
+/// heuristic maintains its own open list and each open list is owned by one
+/// worker thread, so that queues which are largely independent between
+/// anchor synchronizations expand concurrently. Workers claim states under a
+/// shared mutex (closed flags double as the claims, so no state is expanded
+/// twice from the same set), evaluate outgoing edges with the mutex released,
+/// and apply successor updates under the mutex. A worker whose own queues
+/// are empty or suspended by the anchor bound steals the best admissible
+/// state from another thread's queue rather than idling.
+///
+/// As in SMHA*, a state may be expanded at most once from the set of
+/// inadmissible queues and at most once from the anchor queue, g-values are
+/// shared between queues, and the search terminates when the cost of the
+/// best solution found is within the anchor suboptimality factor of the
+/// anchor queue's minimum priority, with in-flight expansions accounted for
+/// in the bound.
+///
+/// The graph must support concurrent calls to GetSuccs() from multiple
+/// threads (e.g. its collision checker and kinematics must be thread-safe)
+/// for this search to be safe. A thread count of 1 degenerates to serial
+/// SMHA* with round-robin queue selection.
+struct PMHAStar : public SBPLPlanner
+{
+    /// \param num_threads The number of expansion threads; a value of 0
+    ///     selects the hardware concurrency, capped at the number of
+    ///     inadmissible heuristics
+    PMHAStar(
+        DiscreteSpaceInformation* space,
+        Heuristic* hanchor,
+        Heuristic** heurs,
+        int hcount,
+        int num_threads = 0);
+    ~PMHAStar();
+
+    /// \name Required Functions from SBPLPlanner
+    ///@{
+    int replan(double allowed_time_secs, std::vector<int>* solution) override;
+    int replan(double allowed_time_secs, std::vector<int>* solution, int* solcost) override;
+    int set_goal(int state_id) override;
+    int set_start(int state_id) override;
+    int force_planning_from_scratch() override;
+    int set_search_mode(bool bSearchUntilFirstSolution) override;
+    void costs_changed(const StateChangeQuery& stateChange) override;
+    ///@}
+
+    /// \name Reimplemented Functions from SBPLPlanner
+    ///@{
+    int replan(std::vector<int>* solution, ReplanParams params) override;
+    int replan(std::vector<int>* solution, ReplanParams params, int* solcost) override;
+    int force_planning_from_scratch_and_free_memory() override;
+    double get_solution_eps() const override;
+    int get_n_expands() const override;
+    double get_initial_eps() override;
+    double get_initial_eps_planning_time() override;
+    double get_final_eps_planning_time() override;
+    int get_n_expands_init_solution() override;
+    double get_final_epsilon() override;
+    void get_search_stats(std::vector<PlannerStats>* s) override;
+    void set_initialsolution_eps(double eps) override;
+    ///@}
+
+    /// Set the suboptimality factor applied to the anchor queue's minimum
+    /// priority when deciding whether inadmissible queues may expand
+    void set_anchor_eps(double eps) { m_eps_mha = eps; }
+    double get_anchor_eps() const { return m_eps_mha; }
+
+    struct SearchState
+    {
+        int state_id;       // corresponding graph state
+        int g;              // cost-to-come
+        int call_number;    // for lazy reinitialization of search states
+        SearchState* bp;    // current best predecessor
+        bool closed_in_anc;
+        bool closed_in_add;
+
+        struct HeapData : public heap_element
+        {
+            SearchState* me;
+            int h;
+            int f;
+        };
+
+        // one entry per queue, anchor first; allocated to the number of
+        // queues when the state is created
+        HeapData od[1];
+    };
+
+    struct HeapCompare
+    {
+        bool operator()(
+            const SearchState::HeapData& s,
+            const SearchState::HeapData& t) const
+        {
+            return s.f < t.f;
+        }
+    };
+
+    using OpenList = intrusive_heap<SearchState::HeapData, HeapCompare>;
+
+    DiscreteSpaceInformation*   m_space = nullptr;
+    Heuristic*                  m_hanchor = nullptr;
+    Heuristic**                 m_heurs = nullptr;
+    int                         m_hcount = 0;
+
+    std::vector<SearchState*>   m_states;
+
+    int                         m_start_state_id = -1;
+    int                         m_goal_state_id = -1;
+
+    int                         m_call_number = 0;
+
+    double                      m_eps = 5.0;        // heuristic inflation
+    double                      m_eps_mha = 2.0;    // anchor suboptimality
+    int                         m_num_threads;
+
+    // shared search state, guarded by m_mutex during the search
+    std::vector<OpenList>       m_open;     // [0] anchor, [1..hcount] queues
+    std::vector<SearchState*>   m_being_expanded;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_cv;
+    bool                        m_done = false;
+    bool                        m_found = false;
+    bool                        m_timed_out = false;
+
+    int                         m_expand_count = 0;
+    clock::duration             m_search_time = clock::duration::zero();
+
+    void workerLoop(int rank, clock::time_point deadline);
+
+    SearchState* selectState(int rank, int& qidx);
+    bool goalConditionMet() const;
+    int anchorBound() const;
+
+    void reinitSearch();
+
+    SearchState* getSearchState(int state_id);
+    SearchState* createState(int state_id);
+    void reinitSearchState(SearchState* state);
+
+    int computeHeuristic(int state_id, int hidx) const;
+    int computeFval(const SearchState* s, int hidx) const;
+
+    void extractPath(
+        SearchState* goal_state,
+        std::vector<int>& solution,
+        int& cost) const;
+};
+
+} // namespace smpl
+
+#endif
@@ -32,17 +32,23 @@
 #ifndef SMPL_SMHASTAR_H
 #define SMPL_SMHASTAR_H
 
+#include <vector>
+
 #include <sbpl/heuristics/heuristic.h>
 #include <sbpl/planners/planner.h>
 #include <sbpl/utils/heap.h>
 
 #include <smpl/heap/intrusive_heap.h>
+#include <smpl/stats.h>
+#include <smpl/time.h>
 
 class DiscreteSpaceInformation;
 class Heuristic;
 
 namespace smpl {
 
+class RobotHeuristic;
+
 struct SMHAState
 {
     int call_number;
@@ -53,6 +59,10 @@ struct SMHAState
     bool closed_in_anc;
     bool closed_in_add;
 
+    /// insertion into the anchor open list is buffered; see
+    /// SMHAStar::sync_anchor_open()
+    bool anchor_deferred;
+
     struct HeapData : public heap_element
     {
         // TODO: rather than map back to the state, the heap could know its
@@ -174,6 +184,11 @@ public:
 
     ///@}
 
+    /// Record an ExpansionRecord for every state expansion, with the queue
+    /// field identifying the open list (0 = anchor) the state was selected
+    /// from. The trace must outlive the search; null disables tracing.
+    void set_expansion_trace(ExpansionTrace* trace) { m_trace = trace; }
+
 private:
 
     // Related objects
@@ -181,6 +196,11 @@ private:
     Heuristic** m_heurs = NULL;
     int m_heur_count = 0;           ///< number of additional heuristics used
 
+    /// the heuristics, anchor first, when they are all RobotHeuristics, so
+    /// that per-state values may be evaluated in one batch; empty otherwise
+    std::vector<RobotHeuristic*> m_robot_heurs;
+    std::vector<int> m_h_values;    ///< scratch buffer for batched evaluation
+
     ReplanParams m_params = ReplanParams(0.0);
     double m_initial_eps_mha = 1.0;
     int m_max_expansions = 0;
@@ -194,6 +214,9 @@ private:
     int m_num_expansions = 0;   ///< current number of expansion
     double m_elapsed = 0.0;       ///< current amount of seconds
 
+    ExpansionTrace* m_trace = NULL; ///< see set_expansion_trace()
+    coarse_timer m_timer;         ///< amortized deadline checking
+
     int m_call_number = 0;
 
     SMHAState* m_start_state = NULL;
@@ -213,6 +236,10 @@ private:
     using OpenList = intrusive_heap<SMHAState::HeapData, HeapCompare>;
     OpenList* m_open = NULL; ///< sequence of (m_heur_count + 1) open lists
 
+    /// anchor open list insertions buffered since the anchor queue was last
+    /// consulted, applied in one batch push by sync_anchor_open()
+    std::vector<SMHAState::HeapData*> m_anchor_deferred;
+
     bool check_params(const ReplanParams& params);
 
     bool time_limit_reached() const;
@@ -230,6 +257,8 @@ private:
     int compute_heuristic(int state_id, int hidx);
     int get_minf(OpenList& pq) const;
     void insert_or_update(SMHAState* state, int hidx);
+    void defer_anchor_insert(SMHAState* state);
+    void sync_anchor_open();
 
     void extract_path(std::vector<int>* solution_path, int* solcost);
 
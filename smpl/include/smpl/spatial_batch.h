@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_SPATIAL_BATCH_H
+#define SMPL_SPATIAL_BATCH_H
+
+// project includes
+#include <smpl/spatial.h>
+
+namespace smpl {
+
+/// \name Batched Pose Kernels
+///@{
+
+/// Kernels over structure-of-arrays batches of rigid transforms, for the
+/// inner loops that convert or apply many poses at once. Lanes are processed
+/// independently, with SIMD paths over full vector-width blocks and scalar
+/// tails, so results are identical element-for-element to the corresponding
+/// single-pose Eigen expressions. Output arrays may fully alias input arrays
+/// but must not partially overlap them.
+
+/// Non-owning structure-of-arrays view over a batch of rigid transforms,
+/// stored as a unit quaternion (w, x, y, z) and a translation per element.
+/// Callers point the view at contiguous scratch storage.
+struct PoseArrayView
+{
+    double* qw; double* qx; double* qy; double* qz;
+    double* tx; double* ty; double* tz;
+};
+
+struct ConstPoseArrayView
+{
+    const double* qw; const double* qx; const double* qy; const double* qz;
+    const double* tx; const double* ty; const double* tz;
+
+    ConstPoseArrayView() = default;
+
+    ConstPoseArrayView(
+        const double* qw, const double* qx, const double* qy, const double* qz,
+        const double* tx, const double* ty, const double* tz)
+    :
+        qw(qw), qx(qx), qy(qy), qz(qz), tx(tx), ty(ty), tz(tz)
+    { }
+
+    ConstPoseArrayView(const PoseArrayView& view) :
+        qw(view.qw), qx(view.qx), qy(view.qy), qz(view.qz),
+        tx(view.tx), ty(view.ty), tz(view.tz)
+    { }
+};
+
+/// Compose pose pairs lane-wise, out[i] = a[i] * b[i].
+void ComposePoses(
+    const ConstPoseArrayView& a,
+    const ConstPoseArrayView& b,
+    const PoseArrayView& out,
+    int count);
+
+/// Invert poses lane-wise, out[i] = poses[i]^-1.
+void InvertPoses(
+    const ConstPoseArrayView& poses,
+    const PoseArrayView& out,
+    int count);
+
+/// Renormalize quaternions to unit length, e.g. after a chain of composes
+/// has accumulated rounding drift.
+void NormalizeQuaternions(double* qw, double* qx, double* qy, double* qz, int count);
+
+/// Convert Z-Y-X Euler angle triples to quaternions,
+/// q[i] = Rz(yaw[i]) * Ry(pitch[i]) * Rx(roll[i]).
+void RotationsFromEulerZYX(
+    const double* yaw,
+    const double* pitch,
+    const double* roll,
+    double* qw, double* qx, double* qy, double* qz,
+    int count);
+
+/// Apply a single transform to a batch of points,
+/// (ox, oy, oz)[i] = transform * (x, y, z)[i].
+void TransformPoints(
+    const Affine3& transform,
+    const double* x, const double* y, const double* z,
+    double* ox, double* oy, double* oz,
+    int count);
+
+///@}
+
+} // namespace smpl
+
+#endif
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_STATS_H
+#define SMPL_STATS_H
+
+// standard includes
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// project includes
+#include <smpl/time.h>
+
+namespace smpl {
+
+/// Identifies the meaning of a StatEvent. The tag field of an event further
+/// discriminates events of the same kind; its values are defined by the
+/// component doing the recording.
+enum StatEventKind : std::uint16_t
+{
+    STAT_EVENT_PHASE = 0,   ///< a named phase finished; value = duration (s)
+    STAT_EVENT_SEARCH_ITER, ///< a search iteration finished; value = epsilon,
+                            ///< count = cumulative expansions
+    STAT_EVENT_COUNTER,     ///< a counter sample; count = counter value
+    NUMBER_OF_STAT_EVENT_KINDS
+};
+
+/// A fixed-size instrumentation record. Records are plain data so a buffer of
+/// them may be written out verbatim and parsed offline.
+struct StatEvent
+{
+    double          time;   ///< seconds since the recorder was last cleared
+    double          value;  ///< kind-specific payload
+    std::uint32_t   count;  ///< kind-specific payload
+    std::uint16_t   kind;   ///< one of StatEventKind
+    std::uint16_t   tag;    ///< recorder-defined discriminator
+};
+
+/// A bounded ring buffer of instrumentation events. Recording an event is a
+/// handful of stores plus one clock read, with no formatting or allocation,
+/// so it is cheap enough to leave enabled in production. When the buffer is
+/// full the oldest events are overwritten and counted as dropped. The raw
+/// records may be snapshotted in order or dumped to a file in a single write.
+class StatsRecorder
+{
+public:
+
+    explicit StatsRecorder(size_t capacity = DefaultCapacity);
+
+    void record(
+        std::uint16_t kind,
+        std::uint16_t tag,
+        std::uint32_t count,
+        double value);
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_events.size(); }
+
+    /// Return the number of events overwritten since the last clear().
+    size_t dropped() const { return m_dropped; }
+
+    /// Copy the buffered events into \p events, oldest first.
+    void snapshot(std::vector<StatEvent>& events) const;
+
+    /// Write the buffered events to a file, oldest first, as raw records.
+    bool dump(const char* path) const;
+
+    /// Discard all events and restart the event clock.
+    void clear();
+
+private:
+
+    static const size_t DefaultCapacity = 4096;
+
+    std::vector<StatEvent> m_events;
+    size_t m_head;      // index of the oldest event
+    size_t m_size;
+    size_t m_dropped;
+    clock::time_point m_start;
+};
+
+/// A fixed-size record of a single state expansion. Records are plain data so
+/// a buffer of them may be written out verbatim and parsed offline.
+struct ExpansionRecord
+{
+    std::uint32_t   time_us;    ///< microseconds since the trace was cleared
+    std::int32_t    state_id;   ///< graph state id of the expanded state
+    std::uint32_t   f;          ///< key of the state when it was selected
+    std::uint32_t   g;          ///< cost-to-come at expansion
+    std::uint32_t   h;          ///< estimated cost-to-go at expansion
+    std::uint16_t   queue;      ///< open list index, for multi-queue searches
+    std::uint16_t   iteration;  ///< search iteration, for anytime searches
+};
+
+/// A bounded ring buffer of expansion records, the per-expansion counterpart
+/// to StatsRecorder. Recording an expansion is one clock read plus a handful
+/// of stores into preallocated storage, a negligible fraction of the successor
+/// generation it annotates, so tracing may be left enabled in production. When
+/// the buffer is full the oldest records are overwritten and counted as
+/// dropped. A dumped trace identifies expanded states by graph state id, so it
+/// may be replayed against the graph that produced it to reconstruct the
+/// sequence of expansions post-mortem.
+class ExpansionTrace
+{
+public:
+
+    explicit ExpansionTrace(size_t capacity = DefaultCapacity);
+
+    void record(
+        int state_id,
+        unsigned f,
+        unsigned g,
+        unsigned h,
+        std::uint16_t queue,
+        std::uint16_t iteration);
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_records.size(); }
+
+    /// Return the number of records overwritten since the last clear().
+    size_t dropped() const { return m_dropped; }
+
+    /// Copy the buffered records into \p records, oldest first.
+    void snapshot(std::vector<ExpansionRecord>& records) const;
+
+    /// Write the buffered records to a file, oldest first, as raw records.
+    bool dump(const char* path) const;
+
+    /// Read raw records dumped by dump() back from a file.
+    static bool load(const char* path, std::vector<ExpansionRecord>& records);
+
+    /// Discard all records and restart the trace clock.
+    void clear();
+
+private:
+
+    static const size_t DefaultCapacity = 1 << 16;
+
+    std::vector<ExpansionRecord> m_records;
+    size_t m_head;      // index of the oldest record
+    size_t m_size;
+    size_t m_dropped;
+    clock::time_point m_start;
+};
+
+/// Interface for components that can report the bytes held by their internal
+/// structures. Search, planning space, and heuristic implementations may
+/// implement this to participate in the per-subsystem memory accounting
+/// exposed through PlannerInterface. Reported counts are approximations of
+/// heap usage, intended for budget enforcement and capacity planning rather
+/// than exact profiling.
+class MemoryUsageProvider
+{
+public:
+
+    virtual ~MemoryUsageProvider();
+
+    /// Return the approximate number of bytes held by the component.
+    virtual auto memUsage() const -> size_t = 0;
+};
+
+} // namespace smpl
+
+#endif
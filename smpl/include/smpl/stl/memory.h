@@ -1,8 +1,16 @@
 #ifndef SMPL_MEMORY_H
 #define SMPL_MEMORY_H
 
+#include <stddef.h>
+#include <stdlib.h>
 #include <memory>
+#include <new>
 #include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 namespace smpl {
 
@@ -12,6 +20,253 @@ auto make_unique(Args&&... args) -> std::unique_ptr<T>
     return std::unique_ptr<T>(new T(args...));
 }
 
+/// Allocation path for grid-class containers (Grid3, bfs and distance map
+/// storage), whose backing arrays commonly span tens to hundreds of
+/// megabytes. On Linux the storage is mapped directly with mmap() and the
+/// mapping is advised MADV_HUGEPAGE, allowing the kernel to back it with
+/// transparent huge pages and cutting TLB pressure in propagation kernels.
+/// The pages are not touched at allocation time; under the default
+/// first-touch policy each page lands on the NUMA node of the thread that
+/// first writes it, so propagation engines that initialize their own
+/// partitions in parallel get node-local storage. On other platforms this
+/// is equivalent to operator new. Throws std::bad_alloc on failure.
+inline void* grid_alloc(size_t size)
+{
+#ifdef __linux__
+    // prefix the mapping with a size record for grid_free, offset by a full
+    // cache line to keep the data naturally aligned
+    const size_t header = 64;
+    size_t map_size = size + header;
+    void* base = mmap(
+            NULL, map_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0);
+    if (base == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    (void)madvise(base, map_size, MADV_HUGEPAGE);
+#endif
+    *static_cast<size_t*>(base) = map_size;
+    return static_cast<char*>(base) + header;
+#else
+    return ::operator new(size);
+#endif
+}
+
+/// Release storage returned by grid_alloc().
+inline void grid_free(void* p)
+{
+    if (p == NULL) {
+        return;
+    }
+#ifdef __linux__
+    const size_t header = 64;
+    void* base = static_cast<char*>(p) - header;
+    munmap(base, *static_cast<size_t*>(base));
+#else
+    ::operator delete(p);
+#endif
+}
+
+/// Allocate grid storage for \p count default-initialized elements, as by
+/// new T[count] but through grid_alloc(). Default-initialization writes
+/// nothing for trivial element types, preserving the first-touch behavior
+/// described on grid_alloc().
+template <class T>
+T* grid_new(size_t count)
+{
+    T* p = static_cast<T*>(grid_alloc(count * sizeof(T)));
+    for (size_t i = 0; i < count; ++i) {
+        new (p + i) T;
+    }
+    return p;
+}
+
+/// Destroy \p count elements and release their storage through grid_free().
+template <class T>
+void grid_delete(T* p, size_t count)
+{
+    if (p == NULL) {
+        return;
+    }
+    for (size_t i = count; i > 0; --i) {
+        (p + i - 1)->~T();
+    }
+    grid_free(p);
+}
+
+/// A chunked arena allocator for many small objects with a common lifetime.
+/// Allocations are bump-pointer allocations from large chunks and may not be
+/// freed individually; the entire arena is released at once. Objects with
+/// non-trivial destructors must be destroyed by the caller before the arena
+/// is cleared or released. Intended for search state allocations, where
+/// millions of small objects are allocated per episode and freed together.
+class ObjectArena
+{
+public:
+
+    static const size_t DefaultChunkSize = 64 * 1024;
+
+    explicit ObjectArena(size_t chunk_size = DefaultChunkSize) :
+        m_chunks(nullptr),
+        m_free(nullptr),
+        m_pos(0),
+        m_chunk_size(chunk_size)
+    { }
+
+    ~ObjectArena() { release(); }
+
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+
+    /// Return a pointer to uninitialized storage for \p size bytes, aligned
+    /// to \p align bytes. Allocations larger than the chunk size get their
+    /// own chunk.
+    void* allocate(size_t size, size_t align = sizeof(void*))
+    {
+        if (m_chunks != nullptr) {
+            size_t pos = (m_pos + align - 1) & ~(align - 1);
+            if (pos + size <= m_chunks->size) {
+                m_pos = pos + size;
+                return m_chunks->data() + pos;
+            }
+        }
+        return allocateSlow(size, align);
+    }
+
+    /// Retain all chunks for reuse, invalidating previous allocations. O(1)
+    /// in the number of allocations.
+    void clear()
+    {
+        // append the active list to the free list
+        if (m_chunks != nullptr) {
+            Chunk* last = m_chunks;
+            while (last->next != nullptr) {
+                last = last->next;
+            }
+            last->next = m_free;
+            m_free = m_chunks;
+            m_chunks = nullptr;
+        }
+        m_pos = 0;
+    }
+
+    /// Return all memory to the system, invalidating previous allocations.
+    void release()
+    {
+        clear();
+        while (m_free != nullptr) {
+            Chunk* next = m_free->next;
+            free(m_free);
+            m_free = next;
+        }
+    }
+
+private:
+
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    Chunk* m_chunks;    // active chunk list, allocations from the head
+    Chunk* m_free;      // retained chunks available for reuse
+    size_t m_pos;       // offset of the next allocation in the head chunk
+    size_t m_chunk_size;
+
+    void* allocateSlow(size_t size, size_t align)
+    {
+        size_t chunk_size = m_chunk_size;
+        if (size + align > chunk_size) {
+            chunk_size = size + align;
+        }
+
+        // reuse a retained chunk if the request fits in one
+        Chunk** prev = &m_free;
+        Chunk* chunk = m_free;
+        while (chunk != nullptr && chunk->size < chunk_size) {
+            prev = &chunk->next;
+            chunk = chunk->next;
+        }
+
+        if (chunk != nullptr) {
+            *prev = chunk->next;
+        } else {
+            chunk = (Chunk*)malloc(sizeof(Chunk) + chunk_size);
+            chunk->size = chunk_size;
+        }
+
+        chunk->next = m_chunks;
+        m_chunks = chunk;
+
+        size_t base = reinterpret_cast<size_t>(chunk->data());
+        size_t pos = ((base + align - 1) & ~(align - 1)) - base;
+        m_pos = pos + size;
+        return chunk->data() + pos;
+    }
+};
+
+/// A growable array with stable element addresses, stored as a sequence of
+/// fixed-size chunks, in the manner of a deque. Indexing costs one extra
+/// indirection over a flat array, but elements within a chunk are contiguous
+/// and growth never moves existing elements, so pointers and references
+/// remain valid. Intended for tables indexed by densely-allocated ids, such
+/// as search states indexed by graph state id, which are also referenced by
+/// address from open lists and back-pointers.
+///
+/// Elements are value-initialized upon growth. The container only grows;
+/// resize() with a smaller size reduces the logical size but retains storage
+/// until clear() is called.
+template <class T, size_t ChunkSize = 256>
+class StableVector
+{
+public:
+
+    static_assert((ChunkSize & (ChunkSize - 1)) == 0,
+            "ChunkSize must be a power of two");
+
+    size_t size() const { return m_size; }
+
+    T& operator[](size_t i) {
+        return m_chunks[i / ChunkSize][i & (ChunkSize - 1)];
+    }
+
+    const T& operator[](size_t i) const {
+        return m_chunks[i / ChunkSize][i & (ChunkSize - 1)];
+    }
+
+    void resize(size_t size)
+    {
+        size_t chunk_count = (size + ChunkSize - 1) / ChunkSize;
+        while (m_chunks.size() < chunk_count) {
+            m_chunks.emplace_back(new T[ChunkSize]());
+        }
+        m_size = size;
+    }
+
+    void clear()
+    {
+        m_chunks.clear();
+        m_size = 0;
+    }
+
+    /// Return the number of bytes of storage held by the container.
+    size_t mem_usage() const
+    {
+        return m_chunks.capacity() * sizeof(std::unique_ptr<T[]>) +
+                m_chunks.size() * ChunkSize * sizeof(T);
+    }
+
+private:
+
+    std::vector<std::unique_ptr<T[]>> m_chunks;
+    size_t m_size = 0;
+};
+
 } // namespace smpl
 
 #endif
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_THREAD_POOL_H
+#define SMPL_THREAD_POOL_H
+
+// standard includes
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smpl {
+
+/// A persistent pool of worker threads shared by the library's parallel
+/// sections, so that each parallel collision check, propagation, or search
+/// phase reuses the same workers instead of spawning threads per call.
+///
+/// Workers are started once, sized at construction, and receive tasks through
+/// a single lock-guarded queue. Parallel loops balance load by having every
+/// participant claim chunks of the index range from a shared atomic cursor,
+/// so threads that finish their chunks early steal the remaining iterations
+/// from slower ones without per-iteration scheduling.
+class ThreadPool
+{
+public:
+
+    /// Construct a pool with \p num_threads workers, or one worker per
+    /// available processor when \p num_threads is non-positive. When
+    /// \p pin_threads is set, worker i is pinned to processor i modulo the
+    /// processor count (POSIX systems only; a no-op elsewhere).
+    explicit ThreadPool(int num_threads = 0, bool pin_threads = false);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int numThreads() const { return (int)m_workers.size(); }
+
+    /// Enqueue a task for asynchronous execution on some worker.
+    void submit(std::function<void()> task);
+
+    /// Apply a function of an index range to disjoint subranges covering
+    /// [first, last), each at most \p grain indices long and claimed
+    /// dynamically by the workers and the calling thread. Blocks until the
+    /// whole range is complete. The calling thread always participates, so
+    /// the loop makes progress even when every worker is busy.
+    template <typename RangeFunction>
+    void forEachRange(
+        size_t first,
+        size_t last,
+        size_t grain,
+        RangeFunction fn);
+
+    /// Apply a function of a single index to every index in [first, last),
+    /// chunked and scheduled as in forEachRange().
+    template <typename IndexFunction>
+    void forEach(size_t first, size_t last, size_t grain, IndexFunction fn);
+
+private:
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_work_available;
+    bool m_shutdown = false;
+
+    void workerLoop(int index, bool pin);
+};
+
+/// A set of tasks submitted to a pool and awaited together. Submissions must
+/// not race with wait(), and tasks must not themselves wait on their own
+/// group.
+class TaskGroup
+{
+public:
+
+    explicit TaskGroup(ThreadPool* pool) : m_pool(pool) { }
+
+    /// Submit a task to the group's pool.
+    void run(std::function<void()> task);
+
+    /// Block until every submitted task has finished.
+    void wait();
+
+private:
+
+    ThreadPool* m_pool;
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+    int m_outstanding = 0;
+};
+
+/// Return the process-wide thread pool, creating it with one worker per
+/// available processor on first use.
+ThreadPool* GetDefaultThreadPool();
+
+/// Create the process-wide thread pool with an explicit size and pinning
+/// policy. Must be called before the first use of GetDefaultThreadPool();
+/// returns false, changing nothing, when the pool already exists.
+bool InitDefaultThreadPool(int num_threads, bool pin_threads = false);
+
+template <typename RangeFunction>
+void ThreadPool::forEachRange(
+    size_t first,
+    size_t last,
+    size_t grain,
+    RangeFunction fn)
+{
+    if (first >= last) {
+        return;
+    }
+    if (grain < 1) {
+        grain = 1;
+    }
+
+    std::atomic<size_t> cursor(first);
+    auto body = [&]() {
+        for (;;) {
+            const size_t begin = cursor.fetch_add(grain);
+            if (begin >= last) {
+                return;
+            }
+            fn(begin, std::min(last, begin + grain));
+        }
+    };
+
+    // enough helpers to occupy the pool, but never more than would leave the
+    // calling thread a chunk of its own
+    const size_t chunks = (last - first + grain - 1) / grain;
+    const size_t helpers =
+            std::min((size_t)numThreads(), chunks > 0 ? chunks - 1 : 0);
+
+    TaskGroup group(this);
+    for (size_t i = 0; i < helpers; ++i) {
+        group.run(body);
+    }
+    body();
+    group.wait();
+}
+
+template <typename IndexFunction>
+void ThreadPool::forEach(size_t first, size_t last, size_t grain, IndexFunction fn)
+{
+    forEachRange(first, last, grain, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            fn(i);
+        }
+    });
+}
+
+} // namespace smpl
+
+#endif
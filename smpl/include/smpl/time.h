@@ -135,6 +135,76 @@ inline clock::duration to_duration(double seconds)
             std::chrono::duration<double>(seconds));
 }
 
+/// Amortize clock queries over a stream of regular events, such as search
+/// expansions. The clock is sampled once every N events, with N adapted to
+/// the observed event rate so that samples land roughly once per target
+/// interval of wall time; between samples, the last sampled value is
+/// returned. Deadline checks in hot loops then pay for one clock query every
+/// few hundred events instead of one or more per event, while the reported
+/// elapsed time lags true elapsed time by less than the target interval.
+class coarse_timer
+{
+public:
+
+    explicit coarse_timer(double target_interval = 0.0005) :
+        m_target_interval(to_duration(target_interval))
+    { }
+
+    /// Begin timing, sampling the clock immediately.
+    void start()
+    {
+        m_start = m_last_sample = clock::now();
+        m_period = 1;
+        m_countdown = 0;
+    }
+
+    /// Record one event, sampling the clock if a sample is due. Returns the
+    /// duration elapsed since start() as of the most recent sample.
+    clock::duration tick()
+    {
+        if (m_countdown == 0) {
+            sample();
+        } else {
+            --m_countdown;
+        }
+        return m_last_sample - m_start;
+    }
+
+    /// The duration elapsed since start() as of the most recent sample.
+    clock::duration elapsed() const { return m_last_sample - m_start; }
+
+    /// Sample the clock immediately and return the exact elapsed duration.
+    clock::duration update()
+    {
+        m_last_sample = clock::now();
+        return m_last_sample - m_start;
+    }
+
+private:
+
+    clock::duration m_target_interval;
+    clock::time_point m_start;
+    clock::time_point m_last_sample;
+    std::uint32_t m_period = 1;     // events per sample
+    std::uint32_t m_countdown = 0;  // events until the next sample
+
+    void sample()
+    {
+        auto now = clock::now();
+        // adapt toward one sample per target interval: the previous period
+        // covered the time since the last sample
+        if (now - m_last_sample < m_target_interval / 2) {
+            if (m_period < (std::uint32_t(1) << 16)) {
+                m_period <<= 1;
+            }
+        } else if (now - m_last_sample > m_target_interval && m_period > 1) {
+            m_period >>= 1;
+        }
+        m_last_sample = now;
+        m_countdown = m_period - 1;
+    }
+};
+
 } // namespace smpl
 
 #endif
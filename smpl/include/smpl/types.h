@@ -38,6 +38,7 @@
 #include <vector>
 
 // system includes
+#include <boost/container/small_vector.hpp>
 #include <boost/functional/hash.hpp>
 
 namespace smpl {
@@ -83,6 +84,14 @@ struct VectorHash
 };
 
 #if 1
+// Joint variable vector with inline storage sized for typical manipulator
+// variable counts. States are copied heavily through the graph, action, and
+// search pipelines; inline storage keeps those copies off the heap until the
+// variable count exceeds the inline capacity, beyond which storage spills to
+// the heap with the usual vector semantics.
+const size_t RobotStateInlineCapacity = 8;
+using RobotState = boost::container::small_vector<double, RobotStateInlineCapacity>;
+#elif 0
 using RobotState = std::vector<double>;
 #else
 // This class is eventually meant to replace the above typedef to add type
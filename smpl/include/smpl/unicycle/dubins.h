@@ -69,6 +69,39 @@ int MakeDubinsPaths(
     double radius,
     DubinsMotion motions[6]);
 
+// Identifies the word class of a dubins path by the directions of its two
+// turns. None denotes a query for which no word class admits a path.
+enum class DubinsWord { RR, LL, LR, RL, None };
+
+// Compute the lengths of the shortest dubins paths for a batch of pose
+// pairs. Pose coordinates are passed as parallel arrays of count entries so
+// that the per-pair work runs over flat inputs, with the heading trig for
+// each pose evaluated once and shared between all word classes. Only the
+// path lengths are produced; lengths[i] receives the length of the shortest
+// dubins path for the i'th pair, or quiet NaN if no word class admits a
+// path, and words[i] the word class achieving it. The full path for a
+// chosen pair may be constructed afterwards with MakeDubinsPath.
+void ComputeDubinsLengths(
+    const double* start_x,
+    const double* start_y,
+    const double* start_theta,
+    const double* goal_x,
+    const double* goal_y,
+    const double* goal_theta,
+    int count,
+    double radius,
+    double* lengths,
+    DubinsWord* words);
+
+// Construct the dubins path of a single word class between two poses.
+// Returns a default-constructed motion if word is DubinsWord::None.
+auto MakeDubinsPath(
+    const Pose2D& start,
+    const Pose2D& goal,
+    double radius,
+    DubinsWord word)
+    -> DubinsMotion;
+
 } // namespace smpl
 
 #endif
@@ -0,0 +1,117 @@
+#ifndef SMPL_UNICYCLE_MPRIM_H
+#define SMPL_UNICYCLE_MPRIM_H
+
+// standard includes
+#include <utility>
+#include <vector>
+
+// project includes
+#include <smpl/spatial.h>
+#include <smpl/unicycle/dubins.h>
+#include <smpl/unicycle/pose_2d.h>
+
+namespace smpl {
+
+struct UnicycleCell
+{
+    int x;
+    int y;
+};
+
+inline bool operator==(const UnicycleCell& a, const UnicycleCell& b)
+{
+    return (a.x == b.x) & (a.y == b.y);
+}
+
+inline bool operator<(const UnicycleCell& a, const UnicycleCell& b)
+{
+    if (a.x != b.x) return a.x < b.x;
+    return a.y < b.y;
+}
+
+/// A single discretized base motion primitive. The start pose is the center
+/// of cell (0, 0) at discrete heading start_theta; the primitive moves the
+/// base by (dx, dy) cells and (dtheta) discrete heading steps. Waypoints and
+/// swept cells are expressed relative to the start cell so that applying the
+/// primitive at any lattice state is a translation.
+struct UnicyclePrim
+{
+    int start_theta = 0;            ///< discrete start heading
+    int dx = 0;                     ///< end-pose displacement, cells
+    int dy = 0;
+    int dtheta = 0;                 ///< end-heading displacement, heading steps
+
+    /// The dubins word class realizing the primitive, or DubinsWord::None
+    /// when an exact unicycle curve was used instead.
+    DubinsWord word = DubinsWord::None;
+
+    double length = 0.0;            ///< metric path length
+
+    /// Interpolated waypoints from the start pose to the end pose, inclusive.
+    std::vector<Pose2D> poses;
+
+    /// Cells swept by the footprint along the primitive, relative to the
+    /// start cell, sorted and unique. Precomputed here so that expansion
+    /// never rasterizes the footprint.
+    std::vector<UnicycleCell> swept_cells;
+};
+
+/// A table of base motion primitives compiled for one lattice resolution,
+/// grouped by discrete start heading.
+struct UnicyclePrimTable
+{
+    double resolution = 0.0;        ///< xy cell size, meters
+    int theta_count = 0;            ///< discrete headings per revolution
+    double turning_radius = 0.0;    ///< radius used for dubins fallbacks
+
+    std::vector<UnicyclePrim> prims;
+
+    /// prims is grouped by start heading; the primitives for heading t are
+    /// prims[begin[t]] up to prims[begin[t + 1]]. begin has theta_count + 1
+    /// entries.
+    std::vector<int> begin;
+};
+
+struct UnicyclePrimParams
+{
+    double resolution = 0.1;        ///< xy cell size, meters
+    int theta_count = 16;           ///< discrete headings per revolution
+    double turning_radius = 0.5;    ///< radius for dubins fallbacks, meters
+
+    int max_cell_radius = 8;        ///< sampled end-pose displacement, cells
+    double max_length = 2.0;        ///< discard longer primitives, meters
+    double sample_interval = 0.05;  ///< waypoint spacing along the path, meters
+
+    /// Footprint polygon in the base frame, counter-clockwise. An empty
+    /// footprint annotates only the cells under the sampled waypoints.
+    std::vector<Vector2> footprint;
+};
+
+/// Sample the discretized end-pose space within max_cell_radius and compile
+/// a motion primitive for every end pose reachable by an exact unicycle
+/// curve or, failing that, by the shortest dubins path at the configured
+/// turning radius. Returns false if the parameters are degenerate.
+bool CompileUnicyclePrims(
+    const UnicyclePrimParams& params,
+    UnicyclePrimTable* table);
+
+/// Return the primitives applicable at a given discrete start heading.
+inline auto PrimsForHeading(const UnicyclePrimTable& table, int theta)
+    -> std::pair<const UnicyclePrim*, const UnicyclePrim*>
+{
+    auto* base = table.prims.data();
+    return std::make_pair(
+            base + table.begin[theta], base + table.begin[theta + 1]);
+}
+
+/// Serialize a primitive table to a text file in the manner of .mprim files,
+/// so tables are generated once per resolution and loaded thereafter.
+bool SaveUnicyclePrims(const UnicyclePrimTable& table, const char* path);
+
+/// Load a primitive table written by SaveUnicyclePrims. Returns false if the
+/// file is missing or malformed.
+bool LoadUnicyclePrims(const char* path, UnicyclePrimTable* table);
+
+} // namespace smpl
+
+#endif
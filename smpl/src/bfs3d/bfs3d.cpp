@@ -32,7 +32,13 @@
 
 #include <smpl/bfs3d/bfs3d.h>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <utility>
+
 #include <smpl/console/console.h>
+#include <smpl/stl/memory.h>
 
 namespace smpl {
 
@@ -46,9 +52,12 @@ BFS_3D::BFS_3D(int width, int height, int length) :
     m_queue_head(),
     m_queue_tail(),
     m_running(false),
+    m_num_threads(1),
     m_neighbor_offsets(),
     m_closed(),
-    m_distances()
+    m_distances(),
+    m_comp_labels(nullptr),
+    m_comp_slab(0)
 {
     if (width <= 0 || height <= 0 || length <= 0) {
         return;
@@ -88,8 +97,8 @@ BFS_3D::BFS_3D(int width, int height, int length) :
     m_neighbor_offsets[24] = m_dim_x+1-m_dim_xy;
     m_neighbor_offsets[25] = m_dim_x-1-m_dim_xy;
 
-    m_distance_grid = new int[m_dim_xyz];
-    m_queue = new int[width * height * length];
+    m_distance_grid = grid_new<Cell>(m_dim_xyz);
+    m_queue = grid_new<int>(width * height * length);
 
     for (int node = 0; node < m_dim_xyz; node++) {
         int x = node % m_dim_x;
@@ -116,10 +125,13 @@ BFS_3D::~BFS_3D()
     }
 
     if (m_distance_grid) {
-        delete[] m_distance_grid;
+        grid_delete(const_cast<Cell*>(m_distance_grid), m_dim_xyz);
     }
     if (m_queue) {
-        delete[] m_queue;
+        grid_delete(m_queue, (m_dim_x - 2) * (m_dim_y - 2) * (m_dim_z - 2));
+    }
+    if (m_comp_labels) {
+        grid_delete(m_comp_labels, m_dim_xyz);
     }
 }
 
@@ -138,7 +150,31 @@ void BFS_3D::setWall(int x, int y, int z)
     }
 
     int node = getNode(x, y, z);
-    m_distance_grid[node] = WALL;
+    setWall(node);
+}
+
+bool BFS_3D::copyWalls(const BFS_3D& other)
+{
+    if (m_running || other.m_running) {
+        //error "Cannot modify grid while search is running"
+        return false;
+    }
+
+    if (m_dim_x != other.m_dim_x ||
+        m_dim_y != other.m_dim_y ||
+        m_dim_z != other.m_dim_z)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < m_dim_xyz; ++i) {
+        m_distance_grid[i] =
+                other.m_distance_grid[i] == WALL ? WALL : UNDISCOVERED;
+    }
+    if (m_comp_labels != NULL) {
+        std::fill(m_comp_dirty.begin(), m_comp_dirty.end(), 1);
+    }
+    return true;
 }
 
 bool BFS_3D::isWall(int x, int y, int z) const
@@ -154,6 +190,14 @@ bool BFS_3D::isUndiscovered(int x, int y, int z) const
     return m_distance_grid[node] == UNDISCOVERED;
 }
 
+void BFS_3D::setNumThreads(int num_threads)
+{
+    if (num_threads < 1) {
+        num_threads = 1;
+    }
+    m_num_threads = num_threads;
+}
+
 void BFS_3D::run(int x, int y, int z)
 {
     if (m_running) {
@@ -177,13 +221,34 @@ void BFS_3D::run(int x, int y, int z)
     // initialize starting distance
     m_distance_grid[origin] = 0;
 
-    // fire off background thread to compute bfs
-    m_search_thread = std::thread([&]()
-    {
-        this->search(m_dim_x, m_dim_xy, m_distance_grid, m_queue, m_queue_head, m_queue_tail);
-    });
+    launchSearch();
+}
 
+// Fire off a background thread to compute the bfs from the seeded queue.
+void BFS_3D::launchSearch()
+{
+    // raise the running flag before the thread starts so a search that
+    // finishes quickly cannot have its own clearing of the flag overwritten
     m_running = true;
+
+    if (m_num_threads > 1) {
+        m_search_thread = std::thread([&]()
+        {
+            this->searchParallel(m_num_threads);
+            if (m_completion_callback) {
+                m_completion_callback();
+            }
+        });
+    }
+    else {
+        m_search_thread = std::thread([&]()
+        {
+            this->search(m_dim_x, m_dim_xy, m_distance_grid, m_queue, m_queue_head, m_queue_tail);
+            if (m_completion_callback) {
+                m_completion_callback();
+            }
+        });
+    }
 }
 
 void BFS_3D::run_components(int gx, int gy, int gz)
@@ -219,12 +284,12 @@ void BFS_3D::run_components(int gx, int gy, int gz)
     wall_bfs.m_queue_head = 0;
     wall_bfs.m_queue_tail = 1;
 
-    int volatile* curr_distance_grid = m_distance_grid;
+    Cell volatile* curr_distance_grid = m_distance_grid;
     int* curr_queue = m_queue;
     int* curr_queue_head = &m_queue_head;
     int* curr_queue_tail = &m_queue_tail;
 
-    int volatile* next_distance_grid = wall_bfs.m_distance_grid;
+    Cell volatile* next_distance_grid = wall_bfs.m_distance_grid;
     int* next_queue = wall_bfs.m_queue;
     int* next_queue_head = &wall_bfs.m_queue_head;
     int* next_queue_tail = &wall_bfs.m_queue_tail;
@@ -274,6 +339,345 @@ void BFS_3D::run_components(int gx, int gy, int gz)
     }
 }
 
+// find with path halving over the union-find parents
+static int FindComponent(std::vector<int>& parents, int x)
+{
+    while (parents[x] != x) {
+        parents[x] = parents[parents[x]];
+        x = parents[x];
+    }
+    return x;
+}
+
+// Flood-fill the slab-local component labels of one z-slab; neighbors outside
+// the slab are ignored, to be reconciled by the interface merge. Returns the
+// number of labels assigned.
+int BFS_3D::labelSlab(int slab)
+{
+    const int zfirst = slab * m_comp_slab;
+    const int zlast = std::min(m_dim_z, zfirst + m_comp_slab);
+    const int nfirst = zfirst * m_dim_xy;
+    const int nlast = zlast * m_dim_xy;
+
+    for (int i = nfirst; i < nlast; ++i) {
+        m_comp_labels[i] = -1;
+    }
+
+    int count = 0;
+    std::vector<int> stack;
+    for (int i = nfirst; i < nlast; ++i) {
+        if (m_distance_grid[i] == WALL || m_comp_labels[i] != -1) {
+            continue;
+        }
+
+        m_comp_labels[i] = count;
+        stack.push_back(i);
+        while (!stack.empty()) {
+            const int n = stack.back();
+            stack.pop_back();
+            for (int nb = 0; nb < 26; ++nb) {
+                const int nn = n + m_neighbor_offsets[nb];
+                if (nn < nfirst || nn >= nlast) {
+                    continue;
+                }
+                if (m_distance_grid[nn] == WALL || m_comp_labels[nn] != -1) {
+                    continue;
+                }
+                m_comp_labels[nn] = count;
+                stack.push_back(nn);
+            }
+        }
+        ++count;
+    }
+
+    return count;
+}
+
+// Label the free-space components from scratch.
+void BFS_3D::computeComponentLabels()
+{
+    if (m_running) {
+        return;
+    }
+
+    if (m_comp_labels == NULL) {
+        m_comp_labels = grid_new<int>(m_dim_xyz);
+        m_comp_slab = 8;
+        const int num_slabs = (m_dim_z + m_comp_slab - 1) / m_comp_slab;
+        m_comp_counts.assign(num_slabs, 0);
+        m_comp_offsets.assign(num_slabs, 0);
+        m_comp_dirty.assign(num_slabs, 1);
+    } else {
+        std::fill(m_comp_dirty.begin(), m_comp_dirty.end(), 1);
+    }
+
+    updateComponentLabels();
+}
+
+// Bring the component labels up to date with the walls, relabeling only the
+// slabs whose cells changed since the last labeling and then repeating the
+// interface merge. The merge is repeated in full because the labels are
+// slab-local: a change within one slab may join or split components spanning
+// others, but the merge only walks the slab interface planes, a small
+// fraction of the grid.
+void BFS_3D::updateComponentLabels()
+{
+    if (m_running) {
+        return;
+    }
+
+    if (m_comp_labels == NULL) {
+        computeComponentLabels();
+        return;
+    }
+
+    const int num_slabs = (int)m_comp_counts.size();
+
+    // relabel dirty slabs across the wavefront threads
+    std::vector<int> dirty;
+    for (int s = 0; s < num_slabs; ++s) {
+        if (m_comp_dirty[s]) {
+            dirty.push_back(s);
+        }
+    }
+
+    if (dirty.empty()) {
+        return;
+    }
+
+    if (m_num_threads > 1 && dirty.size() > 1) {
+        std::atomic<int> next(0);
+        auto worker = [&]() {
+            for (;;) {
+                const int i = next.fetch_add(1, std::memory_order_relaxed);
+                if (i >= (int)dirty.size()) {
+                    break;
+                }
+                m_comp_counts[dirty[i]] = labelSlab(dirty[i]);
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(m_num_threads - 1);
+        for (int t = 1; t < m_num_threads; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    } else {
+        for (const int s : dirty) {
+            m_comp_counts[s] = labelSlab(s);
+        }
+    }
+
+    // assign each slab a contiguous range of global label ids
+    int total = 0;
+    for (int s = 0; s < num_slabs; ++s) {
+        m_comp_offsets[s] = total;
+        total += m_comp_counts[s];
+    }
+
+    m_comp_uf.resize(total);
+    for (int i = 0; i < total; ++i) {
+        m_comp_uf[i] = i;
+    }
+
+    // merge labels across each slab interface: every free cell on the first
+    // plane of a slab is unioned with its free 26-neighbors on the last
+    // plane of the slab below. Free cells never lie on the grid border, so
+    // the in-plane neighbor offsets cannot wrap
+    for (int s = 1; s < num_slabs; ++s) {
+        const int zface = s * m_comp_slab;
+        const int nfirst = zface * m_dim_xy;
+        for (int n = nfirst; n < nfirst + m_dim_xy; ++n) {
+            if (m_distance_grid[n] == WALL) {
+                continue;
+            }
+            const int a = m_comp_offsets[s] + m_comp_labels[n];
+            for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                const int nn = n - m_dim_xy + dy * m_dim_x + dx;
+                if (m_distance_grid[nn] == WALL) {
+                    continue;
+                }
+                const int b = m_comp_offsets[s - 1] + m_comp_labels[nn];
+                const int ra = FindComponent(m_comp_uf, a);
+                const int rb = FindComponent(m_comp_uf, b);
+                if (ra != rb) {
+                    m_comp_uf[ra] = rb;
+                }
+            }
+            }
+        }
+    }
+
+    // flatten the parents so that queries are single reads
+    for (int i = 0; i < total; ++i) {
+        m_comp_uf[i] = FindComponent(m_comp_uf, i);
+    }
+
+    std::fill(m_comp_dirty.begin(), m_comp_dirty.end(), 0);
+}
+
+int BFS_3D::getComponentLabel(int x, int y, int z) const
+{
+    if (m_comp_labels == NULL) {
+        return -1;
+    }
+    const int node = getNode(x, y, z);
+    if (node < 0) {
+        return -1;
+    }
+    const int label = m_comp_labels[node];
+    if (label < 0) {
+        return -1;
+    }
+    const int slab = (node / m_dim_xy) / m_comp_slab;
+    return m_comp_uf[m_comp_offsets[slab] + label];
+}
+
+bool BFS_3D::sameComponent(int x1, int y1, int z1, int x2, int y2, int z2) const
+{
+    const int l1 = getComponentLabel(x1, y1, z1);
+    return l1 != -1 && l1 == getComponentLabel(x2, y2, z2);
+}
+
+// Occupy a batch of cells and locally repair the distance grid. Distances are
+// repaired in two phases: a raise phase invalidates all cells whose shortest
+// path support was removed, processing cells in order of increasing distance,
+// and a lower phase re-propagates the wavefront into the invalidated region
+// from its valid boundary.
+void BFS_3D::addWallNodes(const std::vector<int>& nodes)
+{
+    if (m_running) {
+        return;
+    }
+
+    for (int node : nodes) {
+        setWall(node);
+    }
+
+    // seed the raise phase with all discovered neighbors of the new walls
+    typedef std::pair<int, int> DistNode; // (distance, node)
+    std::priority_queue<DistNode, std::vector<DistNode>, std::greater<DistNode>>
+            raise;
+    for (int node : nodes) {
+        for (int i = 0; i < 26; ++i) {
+            const int nn = neighbor(node, i);
+            const int nd = m_distance_grid[nn];
+            if (nd >= 0 && nd != WALL) {
+                raise.push(std::make_pair(nd, nn));
+            }
+        }
+    }
+
+    std::vector<int> cleared;
+    while (!raise.empty()) {
+        const int d = raise.top().first;
+        const int n = raise.top().second;
+        raise.pop();
+
+        if (m_distance_grid[n] != d) {
+            // already invalidated or re-queued with a stale distance
+            continue;
+        }
+        if (d == 0) {
+            // source cells justify themselves
+            continue;
+        }
+
+        // a cell remains valid if some neighbor still supports its distance
+        bool supported = false;
+        for (int i = 0; i < 26; ++i) {
+            const int nd = m_distance_grid[neighbor(n, i)];
+            if (nd >= 0 && nd != WALL && nd == d - 1) {
+                supported = true;
+                break;
+            }
+        }
+        if (supported) {
+            continue;
+        }
+
+        // invalidate this cell and queue the cells it may have supported
+        m_distance_grid[n] = UNDISCOVERED;
+        cleared.push_back(n);
+        for (int i = 0; i < 26; ++i) {
+            const int nn = neighbor(n, i);
+            const int nd = m_distance_grid[nn];
+            if (nd >= 0 && nd != WALL && nd == d + 1) {
+                raise.push(std::make_pair(nd, nn));
+            }
+        }
+    }
+
+    // seed the lower phase with the valid boundary of the invalidated region
+    std::vector<int> seeds;
+    for (int n : cleared) {
+        for (int i = 0; i < 26; ++i) {
+            const int nn = neighbor(n, i);
+            const int nd = m_distance_grid[nn];
+            if (nd >= 0 && nd != WALL) {
+                seeds.push_back(nn);
+            }
+        }
+    }
+
+    repairDistances(seeds);
+}
+
+// Free a batch of cells and locally repair the distance grid. Freed cells and
+// any cells reachable more cheaply through them are lowered by re-propagating
+// the wavefront from the discovered neighbors of the freed cells.
+void BFS_3D::removeWallNodes(const std::vector<int>& nodes)
+{
+    if (m_running) {
+        return;
+    }
+
+    std::vector<int> seeds;
+    for (int node : nodes) {
+        if (m_distance_grid[node] != WALL) {
+            continue;
+        }
+        unsetWall(node);
+        for (int i = 0; i < 26; ++i) {
+            const int nn = neighbor(node, i);
+            const int nd = m_distance_grid[nn];
+            if (nd >= 0 && nd != WALL) {
+                seeds.push_back(nn);
+            }
+        }
+    }
+
+    repairDistances(seeds);
+}
+
+// Propagate the wavefront outward from a set of valid seed cells, discovering
+// undiscovered cells and lowering cells whose distances are no longer tight.
+// Unlike the main search loop, already-discovered cells may be relaxed.
+void BFS_3D::repairDistances(std::vector<int>& seeds)
+{
+    size_t head = 0;
+    while (head < seeds.size()) {
+        const int n = seeds[head++];
+        const int cost = m_distance_grid[n] + 1;
+
+        for (int i = 0; i < 26; ++i) {
+            const int nn = neighbor(n, i);
+            const int nd = m_distance_grid[nn];
+            if (nd == WALL) {
+                continue;
+            }
+            if (nd < 0 || nd > cost) {
+                m_distance_grid[nn] = cost;
+                seeds.push_back(nn);
+            }
+        }
+    }
+}
+
 bool BFS_3D::escapeCell(int x, int y, int z)
 {
     if (!inBounds(x, y, z)) {
@@ -363,6 +767,23 @@ int BFS_3D::getDistance(int x, int y, int z) const
     return m_distance_grid[node];
 }
 
+int BFS_3D::tryGetDistance(int x, int y, int z) const
+{
+    int node = getNode(x, y, z);
+    Cell d = m_distance_grid[node];
+    // the cell may close between this read and the running check; report it
+    // undiscovered either way, the caller sees the final value next query
+    if (d < 0 && m_running) {
+        return UNDISCOVERED;
+    }
+    return d;
+}
+
+void BFS_3D::setCompletionCallback(std::function<void()> callback)
+{
+    m_completion_callback = std::move(callback);
+}
+
 int BFS_3D::getNearestFreeNodeDist(int x, int y, int z)
 {
     // initialize closed set and distances
@@ -493,7 +914,7 @@ int BFS_3D::countDiscovered() const
 void BFS_3D::search(
     int width,
     int planeSize,
-    int volatile* distance_grid,
+    Cell volatile* distance_grid,
     int* queue,
     int& queue_head,
     int& queue_tail)
@@ -551,11 +972,11 @@ void BFS_3D::search(
 void BFS_3D::search(
     int width,
     int planeSize,
-    int volatile* distance_grid,
+    Cell volatile* distance_grid,
     int* queue,
     int& queue_head,
     int& queue_tail,
-    int volatile* frontier_grid,
+    Cell volatile* frontier_grid,
     int* frontier_queue,
     int& frontier_queue_head,
     int& frontier_queue_tail)
@@ -596,4 +1017,68 @@ void BFS_3D::search(
 
 #undef EXPAND_NEIGHBOR_FRONTIER
 
+// Atomically claim an undiscovered cell for the given cost. Returns true if
+// this call transitioned the cell from UNDISCOVERED to cost, false if another
+// thread claimed it first. The release ordering makes the final distance
+// visible to threads spinning in getDistance().
+static bool ClaimCell(BFS_3D::Cell volatile* cell, int cost)
+{
+    auto expected = BFS_3D::UNDISCOVERED;
+    return __atomic_compare_exchange_n(
+            const_cast<BFS_3D::Cell*>(cell), &expected,
+            (BFS_3D::Cell)cost, false,
+            __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+// Level-synchronous parallel variant of search(). Each wavefront level is
+// partitioned across threads; every thread expands its share of the frontier,
+// claiming undiscovered neighbors with compare-and-swap and queueing its
+// claims locally, and the per-thread queues are concatenated into the next
+// frontier once all threads finish the level. All cells in one level share the
+// same distance, so the order in which threads claim them does not affect the
+// result, and each cell is claimed exactly once.
+void BFS_3D::searchParallel(int num_threads)
+{
+    std::vector<int> frontier(m_queue + m_queue_head, m_queue + m_queue_tail);
+    std::vector<std::vector<int>> next_queues(num_threads);
+
+    while (!frontier.empty()) {
+        auto expand_slice = [&](int tidx)
+        {
+            std::vector<int>& next = next_queues[tidx];
+            const size_t first = frontier.size() * tidx / num_threads;
+            const size_t last = frontier.size() * (tidx + 1) / num_threads;
+            for (size_t i = first; i < last; ++i) {
+                const int currentNode = frontier[i];
+                const int currentCost = m_distance_grid[currentNode] + 1;
+                for (int n = 0; n < 26; ++n) {
+                    const int neighborNode = neighbor(currentNode, n);
+                    if (m_distance_grid[neighborNode] < 0 &&
+                        ClaimCell(&m_distance_grid[neighborNode], currentCost))
+                    {
+                        next.push_back(neighborNode);
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads - 1);
+        for (int tidx = 1; tidx < num_threads; ++tidx) {
+            threads.emplace_back(expand_slice, tidx);
+        }
+        expand_slice(0);
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        frontier.clear();
+        for (std::vector<int>& next : next_queues) {
+            frontier.insert(frontier.end(), next.begin(), next.end());
+            next.clear();
+        }
+    }
+    m_running = false;
+}
+
 } // namespace smpl
@@ -2,10 +2,15 @@
 
 // standard includes
 #include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
@@ -25,6 +30,27 @@ static bool g_show_locations = false;
 static std::mutex g_init_mutex;
 static std::mutex g_locations_mutex;
 
+// Asynchronous sink. When enabled, print() deposits fully-formatted messages
+// into a bounded ring buffer drained by a background thread, so a burst of
+// messages costs the caller a string move rather than a write to a possibly
+// blocked stream. Messages arriving while the buffer is full are dropped and
+// counted rather than stalling the caller.
+struct AsyncMessage
+{
+    Level level;
+    std::string text;
+};
+
+static bool g_async = false;
+static std::mutex g_queue_mutex;
+static std::condition_variable g_queue_cond;
+static std::vector<AsyncMessage> g_queue;
+static size_t g_queue_head = 0;
+static size_t g_queue_size = 0;
+static size_t g_queue_dropped = 0;
+static bool g_sink_shutdown = false;
+static std::thread g_sink_thread;
+
 // map (fully-qualified logger name) -> (logger)
 static std::unordered_map<std::string, Logger> g_loggers;
 
@@ -52,6 +78,82 @@ Logger* GetLogger(const std::string& name)
     return &lit->second;
 }
 
+static void WriteMessage(Level level, const std::string& text)
+{
+    FILE* f = (level >= LEVEL_ERROR) ? stderr : stdout;
+    fwrite(text.data(), 1, text.size(), f);
+    if (g_unbuffered) {
+        fflush(f);
+    }
+}
+
+static void DrainSink()
+{
+    std::unique_lock<std::mutex> lock(g_queue_mutex);
+    for (;;) {
+        g_queue_cond.wait(lock, []() {
+            return g_queue_size > 0 || g_sink_shutdown;
+        });
+
+        while (g_queue_size > 0) {
+            AsyncMessage msg = std::move(g_queue[g_queue_head]);
+            g_queue_head = (g_queue_head + 1) % g_queue.size();
+            --g_queue_size;
+
+            lock.unlock();
+            WriteMessage(msg.level, msg.text);
+            lock.lock();
+        }
+
+        if (g_sink_shutdown) {
+            return;
+        }
+    }
+}
+
+static void ShutdownSink()
+{
+    {
+        std::unique_lock<std::mutex> lock(g_queue_mutex);
+        g_sink_shutdown = true;
+    }
+    g_queue_cond.notify_one();
+    if (g_sink_thread.joinable()) {
+        g_sink_thread.join();
+    }
+    if (g_queue_dropped > 0) {
+        fprintf(stderr, "[WARN]  console: dropped %zu messages\n", g_queue_dropped);
+    }
+    fflush(stdout);
+    fflush(stderr);
+}
+
+// Hand a formatted message to the configured sink.
+static void emit(Level level, std::string&& text)
+{
+    if (g_async) {
+        bool notify = false;
+        {
+            std::unique_lock<std::mutex> lock(g_queue_mutex);
+            if (g_queue_size == g_queue.size()) {
+                ++g_queue_dropped;
+            } else {
+                size_t tail = (g_queue_head + g_queue_size) % g_queue.size();
+                g_queue[tail].level = level;
+                g_queue[tail].text = std::move(text);
+                ++g_queue_size;
+                notify = true;
+            }
+        }
+        if (notify) {
+            g_queue_cond.notify_one();
+        }
+        return;
+    }
+
+    WriteMessage(level, text);
+}
+
 void initialize()
 {
     std::unique_lock<std::mutex> lock(g_init_mutex);
@@ -72,11 +174,14 @@ void initialize()
     // parse the config file
     namespace po = boost::program_options;
 
+    int async_capacity;
     po::options_description ops;
     ops.add_options()
             ("format.unbuffered", po::value<bool>(&g_unbuffered)->default_value(false))
             ("format.colored", po::value<bool>(&g_colored)->default_value(false))
             ("format.show_locations", po::value<bool>(&g_show_locations)->default_value(false))
+            ("format.async", po::value<bool>(&g_async)->default_value(false))
+            ("format.async_capacity", po::value<int>(&async_capacity)->default_value(1024))
             ;
 
     bool allow_unregistered = true;
@@ -110,6 +215,15 @@ void initialize()
         }
     }
 
+    if (g_async) {
+        if (async_capacity < 1) {
+            async_capacity = 1;
+        }
+        g_queue.resize(async_capacity);
+        g_sink_thread = std::thread(DrainSink);
+        atexit(ShutdownSink);
+    }
+
     g_initialized = true;
 }
 
@@ -130,34 +244,24 @@ void InitializeLogLocation(
     loc->initialized = true;
 }
 
-void print(Level level, const char* filename, int line, const char* fmt, ...)
+static void AppendPrefix(Level level, std::string& text)
 {
-    va_list args;
-    va_start(args, fmt);
-
-    FILE* f;
-    if (level >= LEVEL_ERROR) {
-        f = stderr;
-    } else {
-        f = stdout;
-    }
-
     if (g_colored) {
         switch (level) {
         case LEVEL_DEBUG:
-            fprintf(f, "%s", codes::green);
+            text += codes::green;
             break;
         case LEVEL_INFO:
-            fprintf(f, "%s", codes::white);
+            text += codes::white;
             break;
         case LEVEL_WARN:
-            fprintf(f, "%s", codes::yellow);
+            text += codes::yellow;
             break;
         case LEVEL_ERROR:
-            fprintf(f, "%s", codes::red);
+            text += codes::red;
             break;
         case LEVEL_FATAL:
-            fprintf(f, "%s", codes::red);
+            text += codes::red;
             break;
         default:
             break;
@@ -166,109 +270,76 @@ void print(Level level, const char* filename, int line, const char* fmt, ...)
 
     switch (level) {
     case LEVEL_DEBUG:
-        fprintf(f, "[DEBUG] ");
+        text += "[DEBUG] ";
         break;
     case LEVEL_INFO:
-        fprintf(f, "[INFO]  ");
+        text += "[INFO]  ";
         break;
     case LEVEL_WARN:
-        fprintf(f, "[WARN]  ");
+        text += "[WARN]  ";
         break;
     case LEVEL_ERROR:
-        fprintf(f, "[ERROR] ");
+        text += "[ERROR] ";
         break;
     case LEVEL_FATAL:
-        fprintf(f, "[FATAL] ");
+        text += "[FATAL] ";
         break;
     default:
         break;
     }
+}
 
-    vfprintf(f, fmt, args);
-
-    // print file and line
+static void AppendSuffix(const char* filename, int line, std::string& text)
+{
     if (g_show_locations) {
         const char* base = strrchr(filename, '\\');
         if (base) {
-            fprintf(f, " [%s:%d]", base + 1, line);
-        } else {
-            fprintf(f, " [%s:%d]", filename, line);
+            filename = base + 1;
         }
+        char loc[32];
+        snprintf(loc, sizeof(loc), ":%d]", line);
+        text += " [";
+        text += filename;
+        text += loc;
     }
 
     if (g_colored) {
-        fprintf(f, "%s", codes::reset);
-    }
-
-    fprintf(f, "\n");
-
-    if (g_unbuffered) {
-        fflush(f);
+        text += codes::reset;
     }
 
-    va_end(args);
+    text += '\n';
 }
 
-void print(Level level, const char* filename, int line, const std::stringstream& ss)
+void print(Level level, const char* filename, int line, const char* fmt, ...)
 {
-    auto& o = (level >= LEVEL_ERROR) ? std::cerr : std::cout;
-
-    if (g_colored) {
-        switch (level) {
-        case LEVEL_DEBUG:
-            o << green;
-            break;
-        case LEVEL_INFO:
-            o << white;
-            break;
-        case LEVEL_WARN:
-            o << yellow;
-            break;
-        case LEVEL_ERROR:
-            o << red;
-            break;
-        case LEVEL_FATAL:
-            o << red;
-            break;
-        default:
-            break;
-        }
-    }
+    std::string text;
+    AppendPrefix(level, text);
 
-    switch (level) {
-    case LEVEL_DEBUG:
-        o << "[DEBUG] ";
-        break;
-    case LEVEL_INFO:
-        o << "[INFO]  ";
-        break;
-    case LEVEL_WARN:
-        o << "[WARN]  ";
-        break;
-    case LEVEL_ERROR:
-        o << "[ERROR] ";
-        break;
-    case LEVEL_FATAL:
-        o << "[FATAL] ";
-        break;
-    default:
-        break;
-    }
-
-    o << ss.str();
-
-    if (g_show_locations) {
-        o << " [" << filename << ':' << line << ']';
+    va_list args;
+    va_start(args, fmt);
+    va_list measure_args;
+    va_copy(measure_args, args);
+    int len = vsnprintf(NULL, 0, fmt, measure_args);
+    va_end(measure_args);
+    if (len > 0) {
+        size_t off = text.size();
+        text.resize(off + len + 1);
+        vsnprintf(&text[off], len + 1, fmt, args);
+        text.resize(off + len); // drop the null terminator
     }
+    va_end(args);
 
-    if (g_colored) {
-        o << reset;
-    }
+    AppendSuffix(filename, line, text);
+    emit(level, std::move(text));
+}
 
-    o << '\n';
-    if (g_unbuffered) {
-        o << std::flush;
-    }
+void print(Level level, const char* filename, int line, const std::stringstream& ss)
+{
+    std::string text;
+    AppendPrefix(level, text);
+    text += ss.str();
+    AppendSuffix(filename, line, text);
+    emit(level, std::move(text));
 }
 
 } // namespace console
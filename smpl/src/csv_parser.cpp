@@ -32,7 +32,11 @@
 #include <smpl/csv_parser.h>
 
 // standard includes
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include <stdexcept>
+#include <thread>
 
 #define CSV_DEBUG 0
 #if CSV_DEBUG
@@ -395,4 +399,284 @@ bool CSVParser::parseName(
     return parseField(s, pos, name);
 }
 
+CSVStreamReader::~CSVStreamReader()
+{
+    close();
+}
+
+bool CSVStreamReader::open(const std::string& filepath)
+{
+    close();
+    m_file = fopen(filepath.c_str(), "rb");
+    return m_file != NULL;
+}
+
+void CSVStreamReader::close()
+{
+    if (m_file != NULL) {
+        fclose(m_file);
+        m_file = NULL;
+    }
+    m_line.clear();
+    m_views.clear();
+}
+
+// Append the next line of input, through its terminating LF, to the record
+// buffer, or replace the buffer with it. Returns false when the input is
+// exhausted.
+bool CSVStreamReader::readLine(bool append)
+{
+    if (!append) {
+        m_line.clear();
+    }
+
+    char buf[4096];
+    bool got = false;
+    while (fgets(buf, sizeof(buf), m_file) != NULL) {
+        got = true;
+        m_line.insert(m_line.end(), buf, buf + strlen(buf));
+        if (m_line.back() == '\n') {
+            break;
+        }
+    }
+    return got;
+}
+
+bool CSVStreamReader::nextRecord()
+{
+    if (m_file == NULL) {
+        return false;
+    }
+
+    // read one line, skipping blank records
+    do {
+        if (!readLine(false)) {
+            return false;
+        }
+
+        // a record with an unclosed quote continues on the following lines
+        while (std::count(m_line.begin(), m_line.end(), '"') % 2 != 0) {
+            if (!readLine(true)) {
+                return false;
+            }
+        }
+
+        while (!m_line.empty() &&
+                (m_line.back() == '\n' || m_line.back() == '\r'))
+        {
+            m_line.pop_back();
+        }
+    } while (m_line.empty());
+
+    // split the record into field views, unescaping quoted fields in place
+    m_views.clear();
+    char* p = m_line.data();
+    char* end = p + m_line.size();
+    for (;;) {
+        CSVFieldView view;
+        if (p != end && *p == '"') {
+            // compact the inner text over the enclosing and doubled quotes
+            char* out = p;
+            char* q = p + 1;
+            for (;;) {
+                if (q == end) {
+                    return false; // quotes were balanced above; malformed
+                }
+                if (*q == '"') {
+                    if (q + 1 != end && q[1] == '"') {
+                        *out++ = '"';
+                        q += 2;
+                    } else {
+                        ++q;
+                        break;
+                    }
+                } else {
+                    *out++ = *q++;
+                }
+            }
+            view.data = p;
+            view.size = out - p;
+            m_views.push_back(view);
+            p = q;
+            if (p != end && *p != ',') {
+                return false; // text after a closing quote
+            }
+        } else {
+            char* q = p;
+            while (q != end && *q != ',') {
+                ++q;
+            }
+            view.data = p;
+            view.size = q - p;
+            m_views.push_back(view);
+            p = q;
+        }
+
+        if (p == end) {
+            break;
+        }
+        ++p; // skip the comma
+        if (p == end) {
+            // trailing comma ends the record with an empty field
+            m_views.push_back(CSVFieldView());
+            m_views.back().data = p;
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool ParseNumericCSV(
+    const std::string& filepath,
+    std::vector<double>& values,
+    size_t& field_count,
+    int num_threads)
+{
+    values.clear();
+    field_count = 0;
+
+    FILE* f = fopen(filepath.c_str(), "rb");
+    if (f == NULL) {
+        return false;
+    }
+
+    fseek(f, 0, SEEK_END);
+    const long file_size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (file_size < 0) {
+        fclose(f);
+        return false;
+    }
+
+    // one flat buffer, NUL-terminated so strtod never runs off the end
+    std::vector<char> text(file_size + 1);
+    if (file_size > 0 &&
+        fread(text.data(), 1, file_size, f) != (size_t)file_size)
+    {
+        fclose(f);
+        return false;
+    }
+    fclose(f);
+    text[file_size] = '\0';
+
+    const char* begin = text.data();
+    const char* end = text.data() + file_size;
+
+    // skip an optional header record
+    {
+        char* e;
+        strtod(begin, &e);
+        if (e == begin && begin != end) {
+            while (begin != end && *begin != '\n') {
+                ++begin;
+            }
+            if (begin != end) {
+                ++begin;
+            }
+        }
+    }
+
+    // fields per record, from the first non-blank record
+    const char* p = begin;
+    while (p != end && (*p == '\n' || *p == '\r')) {
+        ++p;
+    }
+    if (p == end) {
+        return true; // no records
+    }
+    field_count = 1;
+    for (const char* q = p; q != end && *q != '\n'; ++q) {
+        if (*q == ',') {
+            ++field_count;
+        }
+    }
+
+    // parse every record between two boundaries into a flat value array
+    const size_t fc = field_count;
+    auto parse_range = [fc](
+        const char* p, const char* e, std::vector<double>& out) -> bool
+    {
+        while (p != e) {
+            if (*p == '\n' || *p == '\r') {
+                ++p;
+                continue;
+            }
+            for (size_t j = 0; j < fc; ++j) {
+                char* fe;
+                const double v = strtod(p, &fe);
+                if (fe == p) {
+                    return false;
+                }
+                out.push_back(v);
+                p = fe;
+                if (j + 1 < fc) {
+                    if (p == e || *p != ',') {
+                        return false;
+                    }
+                    ++p;
+                }
+            }
+            while (p != e && *p == '\r') {
+                ++p;
+            }
+            if (p != e) {
+                if (*p != '\n') {
+                    return false;
+                }
+                ++p;
+            }
+        }
+        return true;
+    };
+
+    // chunk boundaries snapped forward to the next record start; a record
+    // never spans a boundary so chunks parse independently
+    const int chunks = std::max(1, num_threads);
+    std::vector<const char*> bounds(chunks + 1);
+    bounds[0] = begin;
+    bounds[chunks] = end;
+    for (int i = 1; i < chunks; ++i) {
+        const char* b = begin + (size_t)(end - begin) * i / chunks;
+        while (b != end && *b != '\n') {
+            ++b;
+        }
+        if (b != end) {
+            ++b;
+        }
+        bounds[i] = std::max(b, bounds[i - 1]);
+    }
+
+    std::vector<std::vector<double>> chunk_values(chunks);
+    std::vector<char> chunk_ok(chunks, true);
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < chunks; ++i) {
+        threads.emplace_back([&, i]() {
+            chunk_ok[i] = parse_range(
+                    bounds[i], bounds[i + 1], chunk_values[i]);
+        });
+    }
+    chunk_ok[0] = parse_range(bounds[0], bounds[1], chunk_values[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t total = 0;
+    for (int i = 0; i < chunks; ++i) {
+        if (!chunk_ok[i]) {
+            values.clear();
+            return false;
+        }
+        total += chunk_values[i].size();
+    }
+
+    values.reserve(total);
+    for (auto& chunk : chunk_values) {
+        values.insert(values.end(), chunk.begin(), chunk.end());
+    }
+
+    return true;
+}
+
 } // namespace smpl
@@ -47,6 +47,12 @@ struct Channel
     Level                       severity = Level::Info;
     bool                        inherit = true;
 
+    // rate limit shared by all locations on this channel; a zero period
+    // means unthrottled
+    clock::duration             min_period = clock::duration::zero();
+    clock::time_point           last_hit;
+    bool                        inherit_rate = true;
+
     Channel() = default;
     Channel(std::string name) : name(std::move(name)) { }
 };
@@ -101,6 +107,7 @@ auto FindOrCreateChannel(Channel* channel, const std::string& fullname)
                 child->next = make_unique<Channel>();
                 child->next->name = name;
                 child->next->severity = visualizer->severity;
+                child->next->min_period = visualizer->min_period;
                 visualizer = child->next.get();
 
                 // and, recurse!
@@ -114,6 +121,7 @@ auto FindOrCreateChannel(Channel* channel, const std::string& fullname)
             visualizer->child = make_unique<Channel>();
             visualizer->child->name = name;
             visualizer->child->severity = visualizer->severity;
+            visualizer->child->min_period = visualizer->min_period;
 
             // TODO: do we need to create intermediate children with
             // default/inherited levels?
@@ -199,6 +207,63 @@ bool UpdateChannelLevel(
     return true;
 }
 
+static
+bool UpdateChannelRate(
+    Channels* channel,
+    const std::string& fullname,
+    double rate)
+{
+    SMPL_DEBUG_NAMED("__visual", "Update rate of channel '%s' to %f", fullname.c_str(), rate);
+    auto* visualizer = FindOrCreateChannel(channel->get(), fullname);
+
+    auto period = rate > 0.0 ?
+            std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(1.0 / rate)) :
+            clock::duration::zero();
+
+    if (visualizer->min_period == period) {
+        visualizer->inherit_rate = false;
+        return false;
+    }
+
+    // set the rate limit of this visualizer
+    visualizer->min_period = period;
+    visualizer->inherit_rate = false;
+
+    // propagate channel rate limit to children
+
+    std::vector<Channel*> channels;
+
+    for (auto* child = visualizer->child.get();
+        child != NULL;
+        child = child->next.get())
+    {
+        if (child->inherit_rate) {
+            channels.push_back(child);
+        }
+    }
+
+    while (!channels.empty()) {
+        auto* channel = channels.back();
+        channels.pop_back();
+
+        // update rate limit
+        channel->min_period = period;
+
+        // recurse on non-overridden children
+        for (auto* child = channel->child.get();
+            child != NULL;
+            child = child->next.get())
+        {
+            if (child->inherit_rate) {
+                channels.push_back(child);
+            }
+        }
+    }
+
+    return true;
+}
+
 static
 bool IsChannelEnabledFor(Channel* handle, Level level)
 {
@@ -328,6 +393,13 @@ bool SetVisualizationLevel(const std::string& name, Level level)
     return UpdateChannelLevel(&g_channels, name, level);
 }
 
+static
+bool SetVisualizationRate(const std::string& name, double rate)
+{
+    Initialize();
+    return UpdateChannelRate(&g_channels, name, rate);
+}
+
 /////////////////////////////////////
 // Global Channel System Interface //
 /////////////////////////////////////
@@ -355,6 +427,14 @@ bool set_visualization_level(const std::string& name, Level level)
     return changed;
 }
 
+bool set_visualization_rate(const std::string& name, double rate)
+{
+    // rate limits are tested at visualization time, so locations need not be
+    // notified here
+    std::unique_lock<std::mutex> lock(g_locations_mutex);
+    return SetVisualizationRate(name, rate);
+}
+
 ///////////////////////////////////////////////////
 // Visualization Locations System Implementation //
 ///////////////////////////////////////////////////
@@ -364,10 +444,15 @@ bool set_visualization_level(const std::string& name, Level level)
 static VizLocation* g_loc_head = nullptr;
 static VizLocation* g_loc_tail = nullptr;
 
+// whether a visualizer is attached, mirrored here (under g_locations_mutex)
+// so that locations are disabled, and marker construction skipped, while
+// nothing consumes visualizations
+static bool g_have_visualizer = false;
+
 static
 void UpdateLocationEnabledNoLock(VizLocation* loc)
 {
-    loc->enabled = IsEnabledFor(loc->handle, loc->level);
+    loc->enabled = g_have_visualizer && IsEnabledFor(loc->handle, loc->level);
 }
 
 void InitializeVizLocation(
@@ -407,6 +492,21 @@ void NotifyLevelsChanged()
     }
 }
 
+bool CheckVizRate(VizLocation* loc)
+{
+    std::unique_lock<std::mutex> lock(g_locations_mutex);
+    auto* channel = static_cast<impl::Channel*>(loc->handle);
+    if (channel->min_period == clock::duration::zero()) {
+        return true;
+    }
+    auto now = clock::now();
+    if (channel->last_hit + channel->min_period <= now) {
+        channel->last_hit = now;
+        return true;
+    }
+    return false;
+}
+
 // NOTE: The Visualization Locations System Interface is defined by the
 // visualization macros
 
@@ -458,14 +558,24 @@ static std::mutex g_viz_mutex;
 
 void set_visualizer(VisualizerBase* visualizer)
 {
-    std::unique_lock<std::mutex> lock(g_viz_mutex);
-    g_visualizer = visualizer;
+    {
+        std::unique_lock<std::mutex> lock(g_viz_mutex);
+        g_visualizer = visualizer;
+    }
+    std::unique_lock<std::mutex> lock(g_locations_mutex);
+    g_have_visualizer = visualizer != nullptr;
+    NotifyLevelsChanged();
 }
 
 void unset_visualizer()
 {
-    std::unique_lock<std::mutex> lock(g_viz_mutex);
-    g_visualizer = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(g_viz_mutex);
+        g_visualizer = nullptr;
+    }
+    std::unique_lock<std::mutex> lock(g_locations_mutex);
+    g_have_visualizer = false;
+    NotifyLevelsChanged();
 }
 
 auto visualizer() -> VisualizerBase*
@@ -31,6 +31,10 @@
 
 #include <smpl/distance_map/chessboard_distance_map.h>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace smpl {
 
 ChessboardDistanceMap::ChessboardDistanceMap(
@@ -55,4 +59,30 @@ int ChessboardDistanceMap::distance(const Cell& n, const Cell& s)
     return dx * dx + dy * dy + dz * dz + s.dist_new;
 }
 
+// The distance function depends on the neighbor only through its offset from
+// the source cell, whose squared length is precomputed per neighbor index, so
+// the batch kernel reduces to the constant table plus a broadcast source
+// distance.
+void ChessboardDistanceMap::distances(
+    const Cell& s,
+    int nfirst,
+    int nlast,
+    int* out)
+{
+    int i = nfirst;
+#ifdef __AVX2__
+    const __m256i base = _mm256_set1_epi32(s.dist_new);
+    for (; i + 8 <= nlast; i += 8) {
+        __m256i len2 = _mm256_loadu_si256(
+                (const __m256i*)&m_neighbor_off_len2[i]);
+        _mm256_storeu_si256(
+                (__m256i*)&out[i - nfirst],
+                _mm256_add_epi32(len2, base));
+    }
+#endif
+    for (; i != nlast; ++i) {
+        out[i - nfirst] = m_neighbor_off_len2[i] + s.dist_new;
+    }
+}
+
 } // namespace smpl
@@ -36,10 +36,16 @@ namespace smpl {
 /// \param[out] neighbors Precomputed array of possibly 27-connected directions.
 ///     A particular neighbor is indexed via the dirnum(x, y, z, 0) function.
 /// \param[out] indices
+/// \param[out] face_ends One-past-the-end of the face-adjacent prefix of each
+///     range. Each range lists its face-adjacent neighbors before its
+///     diagonal neighbors so propagation can run a compact pass over the
+///     faces, which account for nearly all successful improvements, before
+///     the diagonal remainder.
 void CreateNeighborUpdateList(
     std::array<Eigen::Vector3i, 27>& neighbors,
     std::array<int, NEIGHBOR_LIST_SIZE>& indices,
-    std::array<std::pair<int, int>, NUM_DIRECTIONS>& ranges)
+    std::array<std::pair<int, int>, NUM_DIRECTIONS>& ranges,
+    std::array<int, NUM_DIRECTIONS>& face_ends)
 {
     int i = 0;
     int n = 0;
@@ -52,28 +58,45 @@ void CreateNeighborUpdateList(
         }
         int d = dirnum(sx, sy, sz, edge);
         int nfirst = i;
+
+        int face_dirs[27];
+        int diag_dirs[27];
+        int nfaces = 0;
+        int ndiags = 0;
         for (int tx = -1; tx <= 1; ++tx) {
         for (int ty = -1; ty <= 1; ++ty) {
         for (int tz = -1; tz <= 1; ++tz) {
             if (tx == 0 && ty == 0 && tz == 0) {
                 continue;
             }
+            bool accept;
             if (edge) {
-                if (
+                accept =
                     !(((tx == -1 && sx == 1) || (tx == 1 && sx == -1)) ||
                     ((ty == -1 && sy == 1) || (ty == 1 && sy == -1)) ||
-                    ((tz == -1 && sz == 1) || (tz == 1 && sz == -1))))
-                {
-                    indices[i++] = dirnum(tx, ty, tz);
-                }
+                    ((tz == -1 && sz == 1) || (tz == 1 && sz == -1)));
             } else {
-                if (tx * sx + ty * sy + tz * sz >= 0) {
-                    indices[i++] = dirnum(tx, ty, tz);
+                accept = tx * sx + ty * sy + tz * sz >= 0;
+            }
+            if (accept) {
+                if (abs(tx) + abs(ty) + abs(tz) == 1) {
+                    face_dirs[nfaces++] = dirnum(tx, ty, tz);
+                } else {
+                    diag_dirs[ndiags++] = dirnum(tx, ty, tz);
                 }
             }
         }
         }
         }
+
+        for (int f = 0; f < nfaces; ++f) {
+            indices[i++] = face_dirs[f];
+        }
+        face_ends[d] = i;
+        for (int g = 0; g < ndiags; ++g) {
+            indices[i++] = diag_dirs[g];
+        }
+
         int nlast = i;
         ranges[d].first = nfirst;
         ranges[d].second = nlast;
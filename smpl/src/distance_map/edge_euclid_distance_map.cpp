@@ -31,6 +31,13 @@
 
 #include <smpl/distance_map/edge_euclid_distance_map.h>
 
+// standard includes
+#include <cstdlib>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace smpl {
 
 EdgeEuclidDistanceMap::EdgeEuclidDistanceMap(
@@ -73,4 +80,65 @@ int EdgeEuclidDistanceMap::distance(const Cell& n, const Cell& s)
     return dx * dx + dy * dy + dz * dz;
 }
 
+// The distance function depends on the neighbor only through its offset from
+// the source cell's nearest obstacle, so each candidate is computed from the
+// source's own obstacle offset plus a constant per-neighbor offset. Shrinking
+// a component toward zero by one cell is expressed branchlessly as
+// max(|d| - 1, 0), which preserves the squared value.
+void EdgeEuclidDistanceMap::distances(
+    const Cell& s,
+    int nfirst,
+    int nlast,
+    int* out)
+{
+    const int dx0 = s.x - s.obs->x;
+    const int dy0 = s.y - s.obs->y;
+    const int dz0 = s.z - s.obs->z;
+
+    int i = nfirst;
+#ifdef __AVX2__
+    const __m256i vdx0 = _mm256_set1_epi32(dx0);
+    const __m256i vdy0 = _mm256_set1_epi32(dy0);
+    const __m256i vdz0 = _mm256_set1_epi32(dz0);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 8 <= nlast; i += 8) {
+        __m256i dx = _mm256_add_epi32(
+                vdx0,
+                _mm256_loadu_si256((const __m256i*)&m_neighbor_dx[i]));
+        __m256i dy = _mm256_add_epi32(
+                vdy0,
+                _mm256_loadu_si256((const __m256i*)&m_neighbor_dy[i]));
+        __m256i dz = _mm256_add_epi32(
+                vdz0,
+                _mm256_loadu_si256((const __m256i*)&m_neighbor_dz[i]));
+
+        dx = _mm256_max_epi32(
+                _mm256_sub_epi32(_mm256_abs_epi32(dx), one), zero);
+        dy = _mm256_max_epi32(
+                _mm256_sub_epi32(_mm256_abs_epi32(dy), one), zero);
+        dz = _mm256_max_epi32(
+                _mm256_sub_epi32(_mm256_abs_epi32(dz), one), zero);
+
+        __m256i d = _mm256_add_epi32(
+                _mm256_add_epi32(
+                        _mm256_mullo_epi32(dx, dx),
+                        _mm256_mullo_epi32(dy, dy)),
+                _mm256_mullo_epi32(dz, dz));
+        _mm256_storeu_si256((__m256i*)&out[i - nfirst], d);
+    }
+#endif
+    for (; i != nlast; ++i) {
+        int dx = std::abs(dx0 + m_neighbor_dx[i]);
+        int dy = std::abs(dy0 + m_neighbor_dy[i]);
+        int dz = std::abs(dz0 + m_neighbor_dz[i]);
+
+        dx = dx > 0 ? dx - 1 : 0;
+        dy = dy > 0 ? dy - 1 : 0;
+        dz = dz > 0 ? dz - 1 : 0;
+
+        out[i - nfirst] = dx * dx + dy * dy + dz * dz;
+    }
+}
+
 } // namespace smpl
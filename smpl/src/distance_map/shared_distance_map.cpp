@@ -0,0 +1,368 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/distance_map/shared_distance_map.h>
+
+// standard includes
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+// Layout of a published segment: one header followed by a dense row-major
+// (x-major) array of single-precision cell distances. The version field is
+// written last, after a release fence, so that a nonzero version implies a
+// completely written body.
+struct SharedDistanceMapHeader
+{
+    std::uint64_t magic;
+    std::uint64_t version;
+
+    double origin_x;
+    double origin_y;
+    double origin_z;
+    double size_x;
+    double size_y;
+    double size_z;
+    double res;
+    double max_dist;
+
+    std::int32_t cell_count_x;
+    std::int32_t cell_count_y;
+    std::int32_t cell_count_z;
+    std::int32_t pad;
+};
+
+static const std::uint64_t SharedDistanceMapMagic = 0x736d706c64697374; // "smpldist"
+
+#ifdef __linux__
+
+bool PublishDistanceMap(
+    const DistanceMapInterface& map,
+    const std::string& name)
+{
+    const int cx = map.numCellsX();
+    const int cy = map.numCellsY();
+    const int cz = map.numCellsZ();
+    const size_t cell_count = (size_t)cx * (size_t)cy * (size_t)cz;
+    const size_t map_size =
+            sizeof(SharedDistanceMapHeader) + cell_count * sizeof(float);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        SMPL_ERROR("Failed to open shared memory segment '%s' (%s)",
+                name.c_str(), strerror(errno));
+        return false;
+    }
+
+    if (ftruncate(fd, (off_t)map_size) != 0) {
+        SMPL_ERROR("Failed to size shared memory segment '%s' (%s)",
+                name.c_str(), strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        SMPL_ERROR("Failed to map shared memory segment '%s' (%s)",
+                name.c_str(), strerror(errno));
+        return false;
+    }
+
+    auto* hdr = (SharedDistanceMapHeader*)addr;
+
+    // continue the counter of a republished segment
+    std::uint64_t next_version = 1;
+    if (hdr->magic == SharedDistanceMapMagic) {
+        next_version = hdr->version + 1;
+        if (next_version == 0) {
+            next_version = 1;
+        }
+    }
+
+    // mark the publication in progress
+    hdr->version = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    hdr->magic = SharedDistanceMapMagic;
+    hdr->origin_x = map.originX();
+    hdr->origin_y = map.originY();
+    hdr->origin_z = map.originZ();
+    hdr->size_x = map.sizeX();
+    hdr->size_y = map.sizeY();
+    hdr->size_z = map.sizeZ();
+    hdr->res = map.resolution();
+    hdr->max_dist = map.getUninitializedDistance();
+    hdr->cell_count_x = cx;
+    hdr->cell_count_y = cy;
+    hdr->cell_count_z = cz;
+    hdr->pad = 0;
+
+    float* data = (float*)(hdr + 1);
+    for (int x = 0; x < cx; ++x) {
+    for (int y = 0; y < cy; ++y) {
+    for (int z = 0; z < cz; ++z) {
+        *data++ = (float)map.getCellDistance(x, y, z);
+    }
+    }
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr->version = next_version;
+
+    munmap(addr, map_size);
+    return true;
+}
+
+bool UnlinkSharedDistanceMap(const std::string& name)
+{
+    return shm_unlink(name.c_str()) == 0;
+}
+
+bool SharedDistanceMap::open(const std::string& name)
+{
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        SMPL_ERROR("Failed to open shared memory segment '%s' (%s)",
+                name.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        (size_t)st.st_size < sizeof(SharedDistanceMapHeader))
+    {
+        SMPL_ERROR("Shared memory segment '%s' is malformed", name.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    const size_t map_size = (size_t)st.st_size;
+    void* addr = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        SMPL_ERROR("Failed to map shared memory segment '%s' (%s)",
+                name.c_str(), strerror(errno));
+        return false;
+    }
+
+    auto* hdr = (const SharedDistanceMapHeader*)addr;
+    const size_t cell_count = (size_t)hdr->cell_count_x *
+            (size_t)hdr->cell_count_y * (size_t)hdr->cell_count_z;
+    if (hdr->magic != SharedDistanceMapMagic ||
+        hdr->version == 0 ||
+        hdr->res <= 0.0 ||
+        map_size <
+                sizeof(SharedDistanceMapHeader) + cell_count * sizeof(float))
+    {
+        SMPL_ERROR("Shared memory segment '%s' holds no published distance map",
+                name.c_str());
+        munmap(addr, map_size);
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    m_name = name;
+    m_addr = addr;
+    m_map_size = map_size;
+    m_distances = (const float*)(hdr + 1);
+
+    m_cell_count_x = hdr->cell_count_x;
+    m_cell_count_y = hdr->cell_count_y;
+    m_cell_count_z = hdr->cell_count_z;
+
+    m_origin_x = hdr->origin_x;
+    m_origin_y = hdr->origin_y;
+    m_origin_z = hdr->origin_z;
+    m_size_x = hdr->size_x;
+    m_size_y = hdr->size_y;
+    m_size_z = hdr->size_z;
+    m_res = hdr->res;
+    m_max_dist = hdr->max_dist;
+    m_inv_res = 1.0 / hdr->res;
+
+    return true;
+}
+
+void SharedDistanceMap::close()
+{
+    if (m_addr != NULL) {
+        munmap(m_addr, m_map_size);
+    }
+    m_name.clear();
+    m_addr = NULL;
+    m_map_size = 0;
+    m_distances = NULL;
+    m_cell_count_x = 0;
+    m_cell_count_y = 0;
+    m_cell_count_z = 0;
+}
+
+std::uint64_t SharedDistanceMap::version() const
+{
+    if (m_addr == NULL) {
+        return 0;
+    }
+    return ((const SharedDistanceMapHeader*)m_addr)->version;
+}
+
+#else // !defined(__linux__)
+
+bool PublishDistanceMap(
+    const DistanceMapInterface& map,
+    const std::string& name)
+{
+    SMPL_ERROR("Shared distance maps are only available on Linux");
+    return false;
+}
+
+bool UnlinkSharedDistanceMap(const std::string& name)
+{
+    return false;
+}
+
+bool SharedDistanceMap::open(const std::string& name)
+{
+    SMPL_ERROR("Shared distance maps are only available on Linux");
+    return false;
+}
+
+void SharedDistanceMap::close()
+{
+}
+
+std::uint64_t SharedDistanceMap::version() const
+{
+    return 0;
+}
+
+#endif
+
+SharedDistanceMap::SharedDistanceMap() :
+    DistanceMapInterface(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0)
+{
+}
+
+SharedDistanceMap::~SharedDistanceMap()
+{
+    close();
+}
+
+DistanceMapInterface* SharedDistanceMap::clone() const
+{
+    auto* map = new SharedDistanceMap;
+    if (isOpen() && !map->open(m_name)) {
+        SMPL_ERROR("Failed to clone shared distance map '%s'", m_name.c_str());
+    }
+    return map;
+}
+
+void SharedDistanceMap::addPointsToMap(const std::vector<Vector3>& points)
+{
+    SMPL_ERROR("SharedDistanceMap is read-only");
+}
+
+void SharedDistanceMap::removePointsFromMap(const std::vector<Vector3>& points)
+{
+    SMPL_ERROR("SharedDistanceMap is read-only");
+}
+
+void SharedDistanceMap::updatePointsInMap(
+    const std::vector<Vector3>& old_points,
+    const std::vector<Vector3>& new_points)
+{
+    SMPL_ERROR("SharedDistanceMap is read-only");
+}
+
+void SharedDistanceMap::reset()
+{
+    SMPL_ERROR("SharedDistanceMap is read-only");
+}
+
+double SharedDistanceMap::getMetricDistance(double x, double y, double z) const
+{
+    int gx, gy, gz;
+    worldToGrid(x, y, z, gx, gy, gz);
+    if (!isCellValid(gx, gy, gz)) {
+        return m_max_dist;
+    }
+    return getCellDistance(gx, gy, gz);
+}
+
+double SharedDistanceMap::getCellDistance(int x, int y, int z) const
+{
+    return (double)m_distances[
+            ((size_t)x * m_cell_count_y + y) * m_cell_count_z + z];
+}
+
+/// Return the point in world coordinates marking the center of the cell at
+/// the given grid coordinates, using the convention of the DistanceMap
+/// family, whose published maps this class is expected to serve.
+void SharedDistanceMap::gridToWorld(
+    int x, int y, int z,
+    double& world_x, double& world_y, double& world_z) const
+{
+    world_x = m_origin_x + x * m_res;
+    world_y = m_origin_y + y * m_res;
+    world_z = m_origin_z + z * m_res;
+}
+
+void SharedDistanceMap::worldToGrid(
+    double world_x, double world_y, double world_z,
+    int& x, int& y, int& z) const
+{
+    x = (int)(m_inv_res * (world_x - (m_origin_x - m_res)) + 0.5) - 1;
+    y = (int)(m_inv_res * (world_y - (m_origin_y - m_res)) + 0.5) - 1;
+    z = (int)(m_inv_res * (world_z - (m_origin_z - m_res)) + 0.5) - 1;
+}
+
+bool SharedDistanceMap::isCellValid(int x, int y, int z) const
+{
+    return x >= 0 && x < m_cell_count_x &&
+            y >= 0 && y < m_cell_count_y &&
+            z >= 0 && z < m_cell_count_z;
+}
+
+} // namespace smpl
@@ -32,10 +32,26 @@
 #include <smpl/distance_map/sparse_distance_map.h>
 
 // standard includes
+#include <algorithm>
+#include <cstdint>
 #include <set>
 
 namespace smpl {
 
+// Interleave the bits of (x, y, z), with x the most significant, matching
+// the order in which cells are assigned to octree children at each depth, so
+// that sorting cells by code groups them by subtree at every level.
+static uint64_t MortonCode(int x, int y, int z)
+{
+    uint64_t code = 0;
+    for (int b = 0; b < 21; ++b) {
+        code |= (uint64_t)((x >> b) & 1) << (3 * b + 2);
+        code |= (uint64_t)((y >> b) & 1) << (3 * b + 1);
+        code |= (uint64_t)((z >> b) & 1) << (3 * b);
+    }
+    return code;
+}
+
 SparseDistanceMap::SparseDistanceMap(
     double origin_x, double origin_y, double origin_z,
     double size_x, double size_y, double size_z,
@@ -55,13 +71,20 @@ SparseDistanceMap::SparseDistanceMap(
     m_neighbors(),
     m_indices(),
     m_neighbor_ranges(),
+    m_neighbor_face_ends(),
     m_neighbor_dirs(),
     m_open(),
     m_rem_stack(),
-    m_error(std::sqrt(3.0) * resolution)
+    m_pending_additions(),
+    m_pending_removals(),
+    m_error(std::sqrt(3.0) * resolution),
+    m_leaf_cache(),
+    m_leaf_cache_count(0),
+    m_leaf_cache_next(0)
 {
     // init neighbors for forward propagation
-    CreateNeighborUpdateList(m_neighbors, m_indices, m_neighbor_ranges);
+    CreateNeighborUpdateList(
+            m_neighbors, m_indices, m_neighbor_ranges, m_neighbor_face_ends);
 
     for (size_t i = 0; i < m_indices.size(); ++i) {
         const Eigen::Vector3i& neighbor = m_neighbors[m_indices[i]];
@@ -114,8 +137,84 @@ double SparseDistanceMap::getDistance(int x, int y, int z) const
         return 0.0;
     }
 
-    int d2 = m_cells.get(x, y, z).dist;
-    return m_sqrt_table[d2];
+    return m_sqrt_table[leafCellDistance(x, y, z)];
+}
+
+/// Return the distances of a batch of cells from their nearest obstacle
+/// cells, as in getDistance(int, int, int). Each tree leaf is resolved at
+/// most once for all query cells falling inside it, rather than once per
+/// query, so spatially clustered batches, e.g. the sphere centers of a
+/// collision model link, cost a single tree descent per distinct leaf.
+void SparseDistanceMap::getCellDistances(
+    const std::vector<Eigen::Vector3i>& cells,
+    std::vector<double>& distances) const
+{
+    distances.resize(cells.size());
+    for (size_t i = 0; i < cells.size(); ++i) {
+        const Eigen::Vector3i& gp = cells[i];
+        if (!isCellValid(gp)) {
+            distances[i] = 0.0;
+        } else {
+            distances[i] = m_sqrt_table[leafCellDistance(gp.x(), gp.y(), gp.z())];
+        }
+    }
+}
+
+/// Return the squared cell distance of the cell at (x, y, z), consulting the
+/// leaf cache before descending the tree and recording the resolved leaf on a
+/// miss. The input cell must be valid.
+int SparseDistanceMap::leafCellDistance(int x, int y, int z) const
+{
+    for (int i = 0; i < m_leaf_cache_count; ++i) {
+        const LeafCacheEntry& e = m_leaf_cache[i];
+        if (x >= e.xfirst && x < e.xlast &&
+            y >= e.yfirst && y < e.ylast &&
+            z >= e.zfirst && z < e.zlast)
+        {
+            return e.dist;
+        }
+    }
+
+    LeafCacheEntry e;
+    e.dist = m_cells.get_leaf(
+            x, y, z,
+            e.xfirst, e.yfirst, e.zfirst,
+            e.xlast, e.ylast, e.zlast).dist;
+
+    m_leaf_cache[m_leaf_cache_next] = e;
+    if (++m_leaf_cache_next == LeafCacheSize) {
+        m_leaf_cache_next = 0;
+    }
+    if (m_leaf_cache_count < LeafCacheSize) {
+        ++m_leaf_cache_count;
+    }
+    return e.dist;
+}
+
+void SparseDistanceMap::invalidateLeafCache()
+{
+    m_leaf_cache_count = 0;
+    m_leaf_cache_next = 0;
+}
+
+// Order cells by morton code so that cells sharing an octree subtree at any
+// level are adjacent in the sequence.
+void SparseDistanceMap::sortCellsByMortonCode(
+    std::vector<GridCoord>& cells) const
+{
+    std::vector<std::pair<uint64_t, GridCoord>> keyed;
+    keyed.reserve(cells.size());
+    for (const GridCoord& p : cells) {
+        keyed.emplace_back(MortonCode(p.x, p.y, p.z), p);
+    }
+    std::sort(
+            keyed.begin(), keyed.end(),
+            [](const std::pair<uint64_t, GridCoord>& a,
+               const std::pair<uint64_t, GridCoord>& b)
+            { return a.first < b.first; });
+    for (size_t i = 0; i < cells.size(); ++i) {
+        cells[i] = keyed[i].second;
+    }
 }
 
 bool SparseDistanceMap::isCellValid(const Eigen::Vector3i& gp) const
@@ -136,22 +235,33 @@ DistanceMapInterface* SparseDistanceMap::clone() const
 void SparseDistanceMap::addPointsToMap(
     const std::vector<Vector3>& points)
 {
+    invalidateLeafCache();
+
+    // gather valid cells and order them by octree locality so that cells
+    // sharing a subtree are marked consecutively and tree descent is
+    // amortized across each subtree
+    std::vector<GridCoord> cells;
+    cells.reserve(points.size());
     for (const Vector3& p : points) {
         int gx, gy, gz;
         worldToGrid(p.x(), p.y(), p.z(), gx, gy, gz);
-        if (!isCellValid(gx, gy, gz)) {
-            continue;
+        if (isCellValid(gx, gy, gz)) {
+            cells.emplace_back(gx, gy, gz);
         }
+    }
+    sortCellsByMortonCode(cells);
 
-        Cell& c = m_cells(gx, gy, gz); // force stable
+    auto cursor = m_cells.make_unique_cursor();
+    for (const GridCoord& p : cells) {
+        Cell& c = cursor(p.x, p.y, p.z); // force stable
         if (c.dist_new > 0) {
             c.dir = NO_UPDATE_DIR;
             c.dist_new = 0;
             c.obs = &c;
-            c.ox = gx;
-            c.oy = gy;
-            c.oz = gz;
-            updateVertex(&c, gx, gy, gz);
+            c.ox = p.x;
+            c.oy = p.y;
+            c.oz = p.z;
+            updateVertex(&c, p.x, p.y, p.z);
         }
     }
 
@@ -164,14 +274,22 @@ void SparseDistanceMap::addPointsToMap(
 void SparseDistanceMap::removePointsFromMap(
     const std::vector<Vector3>& points)
 {
+    invalidateLeafCache();
+
+    std::vector<GridCoord> cells;
+    cells.reserve(points.size());
     for (const Vector3& p : points) {
         int gx, gy, gz;
         worldToGrid(p.x(), p.y(), p.z(), gx, gy, gz);
-        if (!isCellValid(gx, gy, gz)) {
-            continue;
+        if (isCellValid(gx, gy, gz)) {
+            cells.emplace_back(gx, gy, gz);
         }
+    }
+    sortCellsByMortonCode(cells);
 
-        Cell& c = m_cells(gx, gy, gz); // force stable
+    auto cursor = m_cells.make_unique_cursor();
+    for (const GridCoord& p : cells) {
+        Cell& c = cursor(p.x, p.y, p.z); // force stable
 
         if (c.obs != &c) {
             continue;
@@ -183,7 +301,7 @@ void SparseDistanceMap::removePointsFromMap(
 
         c.dist = m_dmax_sqrd_int;
         c.dir = NO_UPDATE_DIR;
-        m_rem_stack.emplace_back(gx, gy, gz);
+        m_rem_stack.emplace_back(p.x, p.y, p.z);
     }
 
     propagateRemovals();
@@ -196,6 +314,8 @@ void SparseDistanceMap::updatePointsInMap(
     const std::vector<Vector3>& old_points,
     const std::vector<Vector3>& new_points)
 {
+    invalidateLeafCache();
+
     std::set<Eigen::Vector3i, Eigen_Vector3i_compare> old_point_set;
     for (const Vector3& wp : old_points) {
         Eigen::Vector3i gp;
@@ -265,6 +385,84 @@ void SparseDistanceMap::updatePointsInMap(
     propagate();
 }
 
+/// Buffer a set of obstacle points to be added to the distance map on the next
+/// call to flushUpdates(). Points outside the map will be ignored.
+void SparseDistanceMap::bufferPointsToMap(const std::vector<Vector3>& points)
+{
+    for (const Vector3& p : points) {
+        int gx, gy, gz;
+        worldToGrid(p.x(), p.y(), p.z(), gx, gy, gz);
+        if (isCellValid(gx, gy, gz)) {
+            m_pending_additions.emplace_back(gx, gy, gz);
+        }
+    }
+}
+
+/// Buffer a set of obstacle points to be removed from the distance map on the
+/// next call to flushUpdates(). Points outside the map will be ignored.
+void SparseDistanceMap::bufferPointsFromMap(const std::vector<Vector3>& points)
+{
+    for (const Vector3& p : points) {
+        int gx, gy, gz;
+        worldToGrid(p.x(), p.y(), p.z(), gx, gy, gz);
+        if (isCellValid(gx, gy, gz)) {
+            m_pending_removals.emplace_back(gx, gy, gz);
+        }
+    }
+}
+
+/// Apply all buffered obstacle additions and removals and update the distance
+/// values of affected cells in one combined propagation pass over the union of
+/// the dirty regions. Removals are applied before additions, as in
+/// updatePointsInMap(), so cells both removed and re-added within the same
+/// batch remain obstacles.
+void SparseDistanceMap::flushUpdates()
+{
+    invalidateLeafCache();
+
+    if (!m_pending_removals.empty()) {
+        sortCellsByMortonCode(m_pending_removals);
+        auto cursor = m_cells.make_unique_cursor();
+        for (const GridCoord& p : m_pending_removals) {
+            Cell& c = cursor(p.x, p.y, p.z); // force stable
+            if (c.obs != &c) {
+                continue; // skip already-free cells
+            }
+            c.dir = NO_UPDATE_DIR;
+            c.dist_new = m_dmax_sqrd_int;
+            c.dist = m_dmax_sqrd_int;
+            c.obs = nullptr;
+            c.ox = c.oy = c.oz = -1;
+            m_rem_stack.emplace_back(p.x, p.y, p.z);
+        }
+        m_pending_removals.clear();
+
+        propagateRemovals();
+    }
+
+    if (!m_pending_additions.empty()) {
+        sortCellsByMortonCode(m_pending_additions);
+        auto cursor = m_cells.make_unique_cursor();
+        for (const GridCoord& p : m_pending_additions) {
+            Cell& c = cursor(p.x, p.y, p.z); // force stable
+            if (c.dist_new == 0) {
+                continue; // skip already-obstacle cells
+            }
+            c.dir = NO_UPDATE_DIR;
+            c.dist_new = 0;
+            c.obs = &c;
+            c.ox = p.x;
+            c.oy = p.y;
+            c.oz = p.z;
+
+            updateVertex(&c, p.x, p.y, p.z);
+        }
+        m_pending_additions.clear();
+
+        propagate();
+    }
+}
+
 /// Reset all points in the distance map to their uninitialized (free) values.
 void SparseDistanceMap::reset()
 {
@@ -280,6 +478,11 @@ void SparseDistanceMap::reset()
     initial.bucket = -1;
     initial.dir = NO_UPDATE_DIR;
 
+    m_pending_additions.clear();
+    m_pending_removals.clear();
+
+    invalidateLeafCache();
+
     m_cells.reset(initial);
 }
 
@@ -401,7 +604,11 @@ void SparseDistanceMap::lower(Cell* s, int sx, int sy, int sz)
 {
     int nfirst, nlast;
     std::tie(nfirst, nlast) = m_neighbor_ranges[s->dir];
-    for (int i = nfirst; i != nlast; ++i) {
+    const int nsplit = m_neighbor_face_ends[s->dir];
+
+    // fast pass over the face-adjacent prefix of the update list, which
+    // accounts for nearly all successful improvements
+    for (int i = nfirst; i != nsplit; ++i) {
         const Eigen::Vector3i& neighbor = m_neighbors[m_indices[i]];
         const Eigen::Vector3i& nx = Eigen::Vector3i(sx, sy, sz) + neighbor;
         if (!isCellValid(nx)) {
@@ -409,18 +616,45 @@ void SparseDistanceMap::lower(Cell* s, int sx, int sy, int sz)
         }
 
         Cell* n = &m_cells(nx.x(), nx.y(), nx.z()); // force stable
-//        if (n->dist_new > s->dist_new)
-        {
-            int dp = distance(nx.x(), nx.y(), nx.z(), *s);
-            if (dp < n->dist_new) {
-                n->dist_new = dp;
-                n->obs = s->obs;
-                n->ox = s->ox;
-                n->oy = s->oy;
-                n->oz = s->oz;
-                n->dir = m_neighbor_dirs[i];
-                updateVertex(n, nx.x(), nx.y(), nx.z());
-            }
+        int dp = distance(nx.x(), nx.y(), nx.z(), *s);
+        if (dp < n->dist_new) {
+            n->dist_new = dp;
+            n->obs = s->obs;
+            n->ox = s->ox;
+            n->oy = s->oy;
+            n->oz = s->oz;
+            n->dir = m_neighbor_dirs[i];
+            updateVertex(n, nx.x(), nx.y(), nx.z());
+        }
+    }
+
+    // Diagonal remainder. The pruned neighborhood of a directed update lies
+    // ahead of the wavefront, so by the bucket queue's monotone settlement no
+    // candidate can improve a neighbor already at or below the source
+    // distance; skip those without computing their candidates. Undirected
+    // updates (fresh obstacles and cells re-seeded by a raise wave) keep the
+    // full evaluation.
+    const bool directed = s->dir != NO_UPDATE_DIR;
+    for (int i = nsplit; i != nlast; ++i) {
+        const Eigen::Vector3i& neighbor = m_neighbors[m_indices[i]];
+        const Eigen::Vector3i& nx = Eigen::Vector3i(sx, sy, sz) + neighbor;
+        if (!isCellValid(nx)) {
+            continue;
+        }
+
+        Cell* n = &m_cells(nx.x(), nx.y(), nx.z()); // force stable
+        if (directed && n->dist_new <= s->dist_new) {
+            continue;
+        }
+        int dp = distance(nx.x(), nx.y(), nx.z(), *s);
+        if (dp < n->dist_new) {
+            n->dist_new = dp;
+            n->obs = s->obs;
+            n->ox = s->ox;
+            n->oy = s->oy;
+            n->oz = s->oz;
+            n->dir = m_neighbor_dirs[i];
+            updateVertex(n, nx.x(), nx.y(), nx.z());
         }
     }
 }
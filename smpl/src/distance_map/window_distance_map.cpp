@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/distance_map/window_distance_map.h>
+
+// standard includes
+#include <algorithm>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+static int ClampCell(int c, int count)
+{
+    return std::max(0, std::min(c, count - 1));
+}
+
+WindowDistanceMap::WindowDistanceMap(
+    const std::shared_ptr<DistanceMapInterface>& parent,
+    double origin_x, double origin_y, double origin_z,
+    double size_x, double size_y, double size_z)
+:
+    DistanceMapInterface(
+            origin_x, origin_y, origin_z,
+            size_x, size_y, size_z,
+            parent->resolution()),
+    m_parent(parent)
+{
+    // snap the requested bounds to the parent's cell grid and clamp to its
+    // extents
+    int min_x, min_y, min_z;
+    parent->worldToGrid(origin_x, origin_y, origin_z, min_x, min_y, min_z);
+    min_x = ClampCell(min_x, parent->numCellsX());
+    min_y = ClampCell(min_y, parent->numCellsY());
+    min_z = ClampCell(min_z, parent->numCellsZ());
+
+    int max_x, max_y, max_z;
+    parent->worldToGrid(
+            origin_x + size_x, origin_y + size_y, origin_z + size_z,
+            max_x, max_y, max_z);
+    max_x = ClampCell(max_x, parent->numCellsX());
+    max_y = ClampCell(max_y, parent->numCellsY());
+    max_z = ClampCell(max_z, parent->numCellsZ());
+
+    m_offset_x = min_x;
+    m_offset_y = min_y;
+    m_offset_z = min_z;
+
+    m_cell_count_x = max_x - min_x + 1;
+    m_cell_count_y = max_y - min_y + 1;
+    m_cell_count_z = max_z - min_z + 1;
+
+    // record the snapped metric bounds
+    parent->gridToWorld(
+            min_x, min_y, min_z, m_origin_x, m_origin_y, m_origin_z);
+    m_size_x = m_cell_count_x * m_res;
+    m_size_y = m_cell_count_y * m_res;
+    m_size_z = m_cell_count_z * m_res;
+}
+
+DistanceMapInterface* WindowDistanceMap::clone() const
+{
+    return new WindowDistanceMap(
+            m_parent,
+            m_origin_x, m_origin_y, m_origin_z,
+            m_size_x, m_size_y, m_size_z);
+}
+
+void WindowDistanceMap::addPointsToMap(const std::vector<Vector3>& points)
+{
+    m_parent->addPointsToMap(points);
+}
+
+void WindowDistanceMap::removePointsFromMap(const std::vector<Vector3>& points)
+{
+    m_parent->removePointsFromMap(points);
+}
+
+void WindowDistanceMap::updatePointsInMap(
+    const std::vector<Vector3>& old_points,
+    const std::vector<Vector3>& new_points)
+{
+    m_parent->updatePointsInMap(old_points, new_points);
+}
+
+void WindowDistanceMap::reset()
+{
+    SMPL_ERROR("WindowDistanceMap cannot reset a sub-volume of its parent");
+}
+
+double WindowDistanceMap::getMetricDistance(double x, double y, double z) const
+{
+    return m_parent->getMetricDistance(x, y, z);
+}
+
+double WindowDistanceMap::getCellDistance(int x, int y, int z) const
+{
+    return m_parent->getCellDistance(
+            x + m_offset_x, y + m_offset_y, z + m_offset_z);
+}
+
+void WindowDistanceMap::gridToWorld(
+    int x, int y, int z,
+    double& world_x, double& world_y, double& world_z) const
+{
+    m_parent->gridToWorld(
+            x + m_offset_x, y + m_offset_y, z + m_offset_z,
+            world_x, world_y, world_z);
+}
+
+void WindowDistanceMap::worldToGrid(
+    double world_x, double world_y, double world_z,
+    int& x, int& y, int& z) const
+{
+    m_parent->worldToGrid(world_x, world_y, world_z, x, y, z);
+    x -= m_offset_x;
+    y -= m_offset_y;
+    z -= m_offset_z;
+}
+
+bool WindowDistanceMap::isCellValid(int x, int y, int z) const
+{
+    return x >= 0 && x < m_cell_count_x &&
+            y >= 0 && y < m_cell_count_y &&
+            z >= 0 && z < m_cell_count_z;
+}
+
+void WindowDistanceMap::bufferPointsToMap(const std::vector<Vector3>& points)
+{
+    m_parent->bufferPointsToMap(points);
+}
+
+void WindowDistanceMap::bufferPointsFromMap(const std::vector<Vector3>& points)
+{
+    m_parent->bufferPointsFromMap(points);
+}
+
+void WindowDistanceMap::flushUpdates()
+{
+    m_parent->flushUpdates();
+}
+
+void WindowDistanceMap::getMetricDistances(
+    const std::vector<Vector3>& points,
+    std::vector<double>& distances,
+    double thresh) const
+{
+    m_parent->getMetricDistances(points, distances, thresh);
+}
+
+double WindowDistanceMap::getCellDistanceGradient(
+    int x, int y, int z,
+    Vector3& gradient) const
+{
+    return m_parent->getCellDistanceGradient(
+            x + m_offset_x, y + m_offset_y, z + m_offset_z, gradient);
+}
+
+} // namespace smpl
@@ -32,6 +32,7 @@
 // standard includes
 #include <cstdio>
 #include <algorithm>
+#include <cmath>
 
 // project includes
 #include <smpl/geometry/voxelize.h>
@@ -117,6 +118,93 @@ struct DoubleArrayVertexArrayIndexer {
     double z(int index) const { return arr[3 * index + 2]; }
 };
 
+// Cover a triangle too large for a single sphere at its circumcenter by
+// voxelizing it in its own plane and emitting one sphere per filled voxel.
+// \p p is the triangle's circumcenter and \p a2, \p b2, \p c2 are the squared
+// lengths of the edges opposite each vertex, already computed by the caller.
+template <class Callable>
+static void CoverLargeTriangle(
+    const Vector3& a,
+    const Vector3& b,
+    const Vector3& c,
+    const Vector3& p,
+    double a2, double b2, double c2,
+    double radius,
+    int tidx,
+    Callable& proc)
+{
+    Vector3 z = (c - b).cross(b - a);
+
+    // normalize or skip z
+    auto len = z.norm();
+    if (len < 1e-6) {
+        return;
+    }
+    z /= len;
+
+    Vector3 x;
+    if (a2 > b2 && a2 > c2) {
+        x = b - c;
+    }
+    else if (b2 > c2) {
+        x = a - c;
+    }
+    else {
+        x = a - b;
+    }
+
+    // normalize or skip
+    len = x.norm();
+    if (len < 1e-6) {
+        return;
+    }
+    x /= len;
+
+    Vector3 y = z.cross(x);
+
+    // transform the triangle vertices into the triangle frame; the frame is
+    // orthonormal, so the inverse transform is three dot products per vertex
+    Vector3 ra = a - p;
+    Vector3 rb = b - p;
+    Vector3 rc = c - p;
+    Vector3 at(ra.dot(x), ra.dot(y), ra.dot(z));
+    Vector3 bt(rb.dot(x), rb.dot(y), rb.dot(z));
+    Vector3 ct(rc.dot(x), rc.dot(y), rc.dot(z));
+
+    double minx = std::min(at.x(), std::min(bt.x(), ct.x()));
+    double miny = std::min(at.y(), std::min(bt.y(), ct.y()));
+    double maxx = std::max(at.x(), std::max(bt.x(), ct.x()));
+    double maxy = std::max(at.y(), std::max(bt.y(), ct.y()));
+
+    //  voxelize the triangle
+    PivotVoxelGrid vg(
+            Vector3(minx, miny, 0.0),
+            Vector3(maxx - minx, maxy - miny, 0.0),
+            Vector3(radius, radius, radius),
+            Vector3::Zero());
+    VoxelizeTriangle(at, bt, ct, vg);
+
+    // extract filled voxels and append as sphere centers
+    for (int vx = 0; vx < vg.sizeX(); ++vx) {
+        for (int vy = 0; vy < vg.sizeY(); ++vy) {
+            MemoryCoord mc(vx, vy, 0);
+            if (vg[mc]) {
+                WorldCoord wc = vg.memoryToWorld(mc);
+                proc(p + wc.x * x + wc.y * y + wc.z * z, tidx);
+            }
+        }
+    }
+}
+
+// Triangles are processed in fixed-size blocks: the vertex coordinates of a
+// block are gathered into flat per-coordinate arrays, then the circumcenters
+// and coverage tests for the whole block are computed in a branch-free
+// arithmetic loop the compiler can vectorize. In typical sphere models nearly
+// every triangle is smaller than the sphere radius, so the blocked loop does
+// all the work and only the rare oversized triangle takes the scalar
+// voxelization path.
+static const int TriangleBlockSize = 128;
+
 template <class VertexIndexer, class Callable>
 void ComputeMeshBoundingSpheresInternal(
     VertexIndexer indexer,
@@ -125,115 +213,91 @@ void ComputeMeshBoundingSpheresInternal(
     double radius,
     Callable proc)
 {
-    for (int tidx = 0; tidx < triangle_count; ++tidx) {
-        std::uint32_t iv1 = indices[3 * tidx];
-        std::uint32_t iv2 = indices[3 * tidx + 1];
-        std::uint32_t iv3 = indices[3 * tidx + 2];
-
-        Vector3 a(indexer.x(iv1), indexer.y(iv1), indexer.z(iv1));
-        Vector3 b(indexer.x(iv2), indexer.y(iv2), indexer.z(iv2));
-        Vector3 c(indexer.x(iv3), indexer.y(iv3), indexer.z(iv3));
-
-        //  compute the pose of the triangle
-        const double a2 = (b - c).squaredNorm();
-        const double b2 = (a - c).squaredNorm();
-        const double c2 = (a - b).squaredNorm();
-        double bc1 = a2 * (b2 + c2 - a2);
-        double bc2 = b2 * (c2 + a2 - b2);
-        double bc3 = c2 * (a2 + b2 - c2);
-        const double s = bc1 + bc2 + bc3;
-        bc1 /= s;
-        bc2 /= s;
-        bc3 /= s;
-
-        Vector3 p = bc1 * a + bc2 * b + bc3 * c;
-
-        if ((p - a).squaredNorm() <= radius * radius &&
-            (p - b).squaredNorm() <= radius * radius &&
-            (p - c).squaredNorm() <= radius * radius)
-        {
-            proc(p, tidx);
-            continue;
-        }
-
-        Vector3 z = (c - b).cross(b - a);
-
-        // normalize or skip z
-        auto len = z.norm();
-        if (len < 1e-6) {
-            continue;
+    const double radius2 = radius * radius;
+
+    double ax[TriangleBlockSize], ay[TriangleBlockSize], az[TriangleBlockSize];
+    double bx[TriangleBlockSize], by[TriangleBlockSize], bz[TriangleBlockSize];
+    double cx[TriangleBlockSize], cy[TriangleBlockSize], cz[TriangleBlockSize];
+    double px[TriangleBlockSize], py[TriangleBlockSize], pz[TriangleBlockSize];
+    double ea2[TriangleBlockSize], eb2[TriangleBlockSize], ec2[TriangleBlockSize];
+    bool covered[TriangleBlockSize];
+
+    for (size_t base = 0; base < triangle_count; base += TriangleBlockSize) {
+        const int count = (int)std::min(
+                (size_t)TriangleBlockSize, triangle_count - base);
+
+        // gather the block's vertex coordinates
+        for (int i = 0; i < count; ++i) {
+            const size_t tidx = base + i;
+            std::uint32_t iv1 = indices[3 * tidx];
+            std::uint32_t iv2 = indices[3 * tidx + 1];
+            std::uint32_t iv3 = indices[3 * tidx + 2];
+            ax[i] = indexer.x(iv1); ay[i] = indexer.y(iv1); az[i] = indexer.z(iv1);
+            bx[i] = indexer.x(iv2); by[i] = indexer.y(iv2); bz[i] = indexer.z(iv2);
+            cx[i] = indexer.x(iv3); cy[i] = indexer.y(iv3); cz[i] = indexer.z(iv3);
         }
-        z /= len;
 
-        Vector3 x;
-        if (a2 > b2 && a2 > c2) {
-            x = b - c;
-        }
-        else if (b2 > c2) {
-            x = a - c;
-        }
-        else {
-            x = a - b;
+        // compute the circumcenter of every triangle in the block and test
+        // whether a single sphere there covers all three vertices
+        for (int i = 0; i < count; ++i) {
+            const double bcx = bx[i] - cx[i];
+            const double bcy = by[i] - cy[i];
+            const double bcz = bz[i] - cz[i];
+            const double acx = ax[i] - cx[i];
+            const double acy = ay[i] - cy[i];
+            const double acz = az[i] - cz[i];
+            const double abx = ax[i] - bx[i];
+            const double aby = ay[i] - by[i];
+            const double abz = az[i] - bz[i];
+
+            const double a2 = bcx * bcx + bcy * bcy + bcz * bcz;
+            const double b2 = acx * acx + acy * acy + acz * acz;
+            const double c2 = abx * abx + aby * aby + abz * abz;
+
+            double bc1 = a2 * (b2 + c2 - a2);
+            double bc2 = b2 * (c2 + a2 - b2);
+            double bc3 = c2 * (a2 + b2 - c2);
+            const double inv_s = 1.0 / (bc1 + bc2 + bc3);
+            bc1 *= inv_s;
+            bc2 *= inv_s;
+            bc3 *= inv_s;
+
+            px[i] = bc1 * ax[i] + bc2 * bx[i] + bc3 * cx[i];
+            py[i] = bc1 * ay[i] + bc2 * by[i] + bc3 * cy[i];
+            pz[i] = bc1 * az[i] + bc2 * bz[i] + bc3 * cz[i];
+
+            const double dax = px[i] - ax[i];
+            const double day = py[i] - ay[i];
+            const double daz = pz[i] - az[i];
+            const double dbx = px[i] - bx[i];
+            const double dby = py[i] - by[i];
+            const double dbz = pz[i] - bz[i];
+            const double dcx = px[i] - cx[i];
+            const double dcy = py[i] - cy[i];
+            const double dcz = pz[i] - cz[i];
+
+            ea2[i] = a2;
+            eb2[i] = b2;
+            ec2[i] = c2;
+            covered[i] =
+                    dax * dax + day * day + daz * daz <= radius2 &&
+                    dbx * dbx + dby * dby + dbz * dbz <= radius2 &&
+                    dcx * dcx + dcy * dcy + dcz * dcz <= radius2;
         }
 
-        // normalize or skip
-        len = x.norm();
-        if (len < 1e-6) {
-            continue;
-        }
-        x /= len;
-
-        Vector3 y = z.cross(x);
-        Affine3 T_mesh_triangle;
-        T_mesh_triangle(0, 0) = x[0];
-        T_mesh_triangle(1, 0) = x[1];
-        T_mesh_triangle(2, 0) = x[2];
-        T_mesh_triangle(3, 0) = 0.0;
-
-        T_mesh_triangle(0, 1) = y[0];
-        T_mesh_triangle(1, 1) = y[1];
-        T_mesh_triangle(2, 1) = y[2];
-        T_mesh_triangle(3, 1) = 0.0;
-
-        T_mesh_triangle(0, 2) = z[0];
-        T_mesh_triangle(1, 2) = z[1];
-        T_mesh_triangle(2, 2) = z[2];
-        T_mesh_triangle(3, 2) = 0.0;
-
-        T_mesh_triangle(0, 3) = p[0];
-        T_mesh_triangle(1, 3) = p[1];
-        T_mesh_triangle(2, 3) = p[2];
-        T_mesh_triangle(3, 3) = 1.0;
-
-        Affine3 T_triangle_mesh = T_mesh_triangle.inverse();
-
-        //  transform the triangle vertices into the triangle frame
-        Vector3 at = T_triangle_mesh * a;
-        Vector3 bt = T_triangle_mesh * b;
-        Vector3 ct = T_triangle_mesh * c;
-
-        double minx = std::min(at.x(), std::min(bt.x(), ct.x()));
-        double miny = std::min(at.y(), std::min(bt.y(), ct.y()));
-        double maxx = std::max(at.x(), std::max(bt.x(), ct.x()));
-        double maxy = std::max(at.y(), std::max(bt.y(), ct.y()));
-
-        //  voxelize the triangle
-        PivotVoxelGrid vg(
-                Vector3(minx, miny, 0.0),
-                Vector3(maxx - minx, maxy - miny, 0.0),
-                Vector3(radius, radius, radius),
-                Vector3::Zero());
-        VoxelizeTriangle(at, bt, ct, vg);
-
-        // extract filled voxels and append as sphere centers
-        for (int x = 0; x < vg.sizeX(); ++x) {
-            for (int y = 0; y < vg.sizeY(); ++y) {
-                MemoryCoord mc(x, y, 0);
-                if (vg[mc]) {
-                    WorldCoord wc = vg.memoryToWorld(mc);
-                    proc(T_mesh_triangle * Vector3(wc.x, wc.y, wc.z),
-                            tidx);
-                }
+        // emit one sphere per covered triangle; voxelize the rest
+        for (int i = 0; i < count; ++i) {
+            const int tidx = (int)(base + i);
+            Vector3 p(px[i], py[i], pz[i]);
+            if (covered[i]) {
+                proc(p, tidx);
+            } else {
+                Vector3 a(ax[i], ay[i], az[i]);
+                Vector3 b(bx[i], by[i], bz[i]);
+                Vector3 c(cx[i], cy[i], cz[i]);
+                CoverLargeTriangle(
+                        a, b, c, p, ea2[i], eb2[i], ec2[i],
+                        radius, tidx, proc);
             }
         }
     }
@@ -314,5 +378,47 @@ void ComputeMeshBoundingSpheres(
             });
 }
 
+/// \brief Cover the surface of a mesh with at most \p max_spheres spheres.
+///
+/// The cover is first attempted per-triangle at the requested radius; when it
+/// produces more spheres than the budget, the mesh surface is instead
+/// voxelized at a coarsened resolution and one sphere emitted per surface
+/// voxel, since the per-triangle cover never produces fewer than one sphere
+/// per triangle. Surface voxel counts scale inversely with the squared
+/// resolution, so the radius is scaled by the square root of the overshoot
+/// each round and the process converges in a handful of rounds. This function
+/// will only append sphere centers to the output vector.
+///
+/// \return The radius of the spheres in the final cover
+double ComputeMeshBoundingSpheres(
+    const std::vector<Vector3>& vertices,
+    const std::vector<std::uint32_t>& indices,
+    double radius,
+    size_t max_spheres,
+    std::vector<Vector3>& centers)
+{
+    const int max_rounds = 8;
+
+    if (max_spheres < 1) {
+        max_spheres = 1;
+    }
+
+    std::vector<Vector3> cover;
+    ComputeMeshBoundingSpheres(vertices, indices, radius, cover);
+    for (int round = 0; cover.size() > max_spheres && round != max_rounds; ++round) {
+        // overshoot by a few percent to absorb estimation error; surface
+        // voxel counts do not thin out exactly quadratically
+        radius *= 1.05 * std::sqrt((double)cover.size() / (double)max_spheres);
+
+        // a voxel of size radius fits within a sphere of that radius centered
+        // on it, so spheres at the surface voxel centers cover the surface
+        cover.clear();
+        VoxelizeMesh(vertices, indices, radius, cover, false);
+    }
+
+    centers.insert(centers.end(), cover.begin(), cover.end());
+    return radius;
+}
+
 } // namespace geometry
 } // namespace smpl
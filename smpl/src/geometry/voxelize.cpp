@@ -33,6 +33,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <algorithm>
+#include <thread>
 #include <utility>
 
 // project includes
@@ -61,6 +62,13 @@ static void VoxelizeMeshAwesome(
     const std::vector<std::uint32_t>& indices,
     VoxelGrid<Discretizer>& vg);
 
+template <typename Discretizer>
+static void VoxelizeMeshParallel(
+    const std::vector<Vector3>& vertices,
+    const std::vector<std::uint32_t>& indices,
+    VoxelGrid<Discretizer>& vg,
+    int num_threads);
+
 template <typename Discretizer>
 void VoxelizeMeshNaive(
     const std::vector<Vector3>& vertices,
@@ -108,8 +116,19 @@ static void VoxelizeMesh(
     VoxelGrid<Discretizer>& vg,
     bool fill)
 {
+    // triangles above which scan-conversion is distributed across threads;
+    // below this the cost of cloning the occupancy grid per thread dominates
+    const size_t parallel_triangle_threshold = 0x10000;
+
     const bool awesome = true;
-    if (awesome) {
+    const int num_threads = (int)std::thread::hardware_concurrency();
+    if (awesome &&
+        num_threads > 1 &&
+        indices.size() / 3 >= parallel_triangle_threshold)
+    {
+        VoxelizeMeshParallel(vertices, indices, vg, num_threads);
+    }
+    else if (awesome) {
         VoxelizeMeshAwesome(vertices, indices, vg);
     }
     else {
@@ -135,6 +154,49 @@ void VoxelizeMeshAwesome(
     }
 }
 
+// Voxelize the surface of a mesh by scan-converting disjoint ranges of its
+// triangles on separate threads. Each thread rasterizes into its own clone of
+// the (empty) input grid, sharing its bounds and discretizer, and the
+// per-thread occupancy grids are or-ed together at the end.
+template <typename Discretizer>
+void VoxelizeMeshParallel(
+    const std::vector<Vector3>& vertices,
+    const std::vector<std::uint32_t>& indices,
+    VoxelGrid<Discretizer>& vg,
+    int num_threads)
+{
+    std::vector<VoxelGrid<Discretizer>> grids(num_threads, vg);
+
+    const size_t num_triangles = indices.size() / 3;
+    std::vector<std::thread> threads;
+    for (int tidx = 0; tidx < num_threads; ++tidx) {
+        threads.emplace_back([&, tidx]() {
+            auto& g = grids[tidx];
+            const size_t from = 3 * (num_triangles * tidx / num_threads);
+            const size_t to = 3 * (num_triangles * (tidx + 1) / num_threads);
+            for (size_t i = from; i < to; i += 3) {
+                auto& a = vertices[indices[i + 0]];
+                auto& b = vertices[indices[i + 1]];
+                auto& c = vertices[indices[i + 2]];
+                VoxelizeTriangle(a, b, c, g);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const int cell_count = vg.sizeX() * vg.sizeY() * vg.sizeZ();
+    for (auto& g : grids) {
+        for (int i = 0; i < cell_count; ++i) {
+            const MemoryIndex mi(i);
+            if (g[mi]) {
+                vg[mi] = true;
+            }
+        }
+    }
+}
+
 template <typename Discretizer>
 void VoxelizeMeshNaive(
     const std::vector<Vector3>& vertices,
@@ -261,48 +323,40 @@ bool IsInDiscreteBoundingBox(
 }
 
 
+// Fill the interior of a voxelized surface by scanning each (x, y) column for
+// occupied spans: the empty gap following an odd-numbered span is interior,
+// unless it runs to the end of the column. Cells are contiguous along z, so
+// interior gaps are filled with bulk run fills rather than per-cell writes.
 template <typename Discretizer>
 void ScanFill(VoxelGrid<Discretizer>& vg)
 {
+    const int size_z = vg.sizeZ();
     for (int x = 0; x < vg.sizeX(); x++) {
         for (int y = 0; y < vg.sizeY(); y++) {
-            const int OUTSIDE = 0;
-            const int ON_BOUNDARY_FROM_OUTSIDE = 1;
-            const int INSIDE = 2;
-            const int ON_BOUNDARY_FROM_INSIDE = 4;
-
-            int scan_state = OUTSIDE;
-
-            for (int z = 0; z < vg.sizeZ(); z++) {
-                if (scan_state == OUTSIDE && vg[MemoryCoord(x, y, z)]) {
-                    scan_state = ON_BOUNDARY_FROM_OUTSIDE;
-                }
-                else if (scan_state == ON_BOUNDARY_FROM_OUTSIDE &&
-                    !vg[MemoryCoord(x, y, z)])
-                {
-                    bool allEmpty = true;
-                    for (int l = z; l < vg.sizeZ(); l++) {
-                        allEmpty &= !vg[MemoryCoord(x, y, l)];
-                    }
-                    if (allEmpty) {
-                        scan_state = OUTSIDE;
-                    }
-                    else {
-                        scan_state = INSIDE;
-                        vg[MemoryCoord(x, y, z)] = true;
-                    }
+            VoxelGridBase::value_type* col =
+                    vg.data() + ((size_t)x * vg.sizeY() + y) * (size_t)size_z;
+
+            int z = 0;
+            bool interior = false;
+            while (z < size_z) {
+                // skip over the empty gap
+                int gap_start = z;
+                while (z < size_z && !col[z]) {
+                    z++;
                 }
-                else if (scan_state == INSIDE && !vg[MemoryCoord(x, y, z)]) {
-                    vg[MemoryCoord(x, y, z)] = true;
+                if (z == size_z) {
+                    break; // trailing gap is exterior
                 }
-                else if (scan_state == INSIDE && vg[MemoryCoord(x, y, z)]) {
-                    scan_state = ON_BOUNDARY_FROM_INSIDE;
+                if (interior) {
+                    std::fill(col + gap_start, col + z,
+                            VoxelGridBase::value_type(1));
                 }
-                else if (scan_state == ON_BOUNDARY_FROM_INSIDE &&
-                    !vg[MemoryCoord(x, y, z)])
-                {
-                    scan_state = OUTSIDE;
+
+                // skip over the occupied span
+                while (z < size_z && col[z]) {
+                    z++;
                 }
+                interior = !interior;
             }
         }
     }
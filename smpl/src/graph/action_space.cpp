@@ -50,4 +50,30 @@ bool ActionSpace::init(RobotPlanningSpace* space)
     return true;
 }
 
+auto ActionSpace::applyReusable(const RobotState& parent)
+    -> const std::vector<Action>*
+{
+    // retire the actions from the previous query, keeping their storage
+    // available to recycledAction()
+    for (auto& action : m_action_buf) {
+        m_action_pool.push_back(std::move(action));
+    }
+    m_action_buf.clear();
+
+    if (!apply(parent, m_action_buf)) {
+        return nullptr;
+    }
+    return &m_action_buf;
+}
+
+Action ActionSpace::recycledAction()
+{
+    if (m_action_pool.empty()) {
+        return Action();
+    }
+    Action action = std::move(m_action_pool.back());
+    m_action_pool.pop_back();
+    return action;
+}
+
 } // namespace smpl
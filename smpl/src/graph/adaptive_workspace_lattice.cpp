@@ -104,11 +104,12 @@ bool AdaptiveWorkspaceLattice::init(
 
     m_grid = grid;
 
-    m_dim_grid.assign(
+    m_dim_grid.resize(
             m_grid->numCellsX(),
             m_grid->numCellsY(),
             m_grid->numCellsZ(),
             AdaptiveGridCell());
+    m_tunnel_cells.clear();
 
     m_goal_state_id = reserveHashEntry(true);
     m_goal_state = getHashEntry(m_goal_state_id);
@@ -130,11 +131,9 @@ bool AdaptiveWorkspaceLattice::projectToPoint(
         pos = goal().pose.translation();
     } else if (state->hid) {
         AdaptiveWorkspaceState* hi_state = (AdaptiveWorkspaceState*)state;
-        WorkspaceState state;
-        stateCoordToWorkspace(hi_state->coord, state);
-        pos.x() = state[0];
-        pos.y() = state[1];
-        pos.z() = state[2];
+        pos.x() = hi_state->px;
+        pos.y() = hi_state->py;
+        pos.z() = hi_state->pz;
     } else {
         AdaptiveGridState* lo_state = (AdaptiveGridState*)state;
         pos.x() = lo_state->x;
@@ -161,11 +160,9 @@ bool AdaptiveWorkspaceLattice::addHighDimRegion(int state_id)
     } else if (state->hid) {
         SMPL_INFO_NAMED(G_LOG, "Grow high-dimensional region around hi state %d", state_id);
         AdaptiveWorkspaceState* hi_state = (AdaptiveWorkspaceState*)state;
-        WorkspaceState work_state;
-        stateCoordToWorkspace(hi_state->coord, work_state);
-        m_grid->worldToGrid(
-                work_state[0], work_state[1], work_state[2],
-                gp.x(), gp.y(), gp.z());
+        gp.x() = hi_state->gx;
+        gp.y() = hi_state->gy;
+        gp.z() = hi_state->gz;
     } else {
         SMPL_INFO_NAMED(G_LOG, "Add high-dimensional region around lo state %d", state_id);
         // add/grow hd region around ld state
@@ -180,18 +177,23 @@ bool AdaptiveWorkspaceLattice::addHighDimRegion(int state_id)
         return false;
     }
 
-    ++m_dim_grid(gp.x(), gp.y(), gp.z()).grow_count;
-    const int radius = m_region_radius * m_dim_grid(gp.x(), gp.y(), gp.z()).grow_count;
+    auto center = m_dim_grid.get(gp.x(), gp.y(), gp.z());
+    ++center.grow_count;
+    m_dim_grid.set(gp.x(), gp.y(), gp.z(), center);
+    const int radius = m_region_radius * center.grow_count;
     SMPL_INFO_NAMED(G_LOG, "  radius: %d", radius);
 
-    // TODO: mark cells as in high-dimensional region
     int marked = 0;
     for (int dx = -radius; dx <= radius; ++dx) {
     for (int dy = -radius; dy <= radius; ++dy) {
     for (int dz = -radius; dz <= radius; ++dz) {
         Eigen::Vector3i p = gp + Eigen::Vector3i(dx, dy, dz);
         if (m_grid->isInBounds(p.x(), p.y(), p.z())) {
-            m_dim_grid(p.x(), p.y(), p.z()).plan_hd = true;
+            auto cell = m_dim_grid.get(p.x(), p.y(), p.z());
+            if (!cell.plan_hd) {
+                cell.plan_hd = true;
+                m_dim_grid.set(p.x(), p.y(), p.z(), cell);
+            }
             ++marked;
         }
     }
@@ -205,40 +207,37 @@ bool AdaptiveWorkspaceLattice::addHighDimRegion(int state_id)
 
 bool AdaptiveWorkspaceLattice::setTunnel(const std::vector<int>& states)
 {
-    // clear the tunnel grid
-    // TODO: retain the list of points in the tunnel and clear only those points
-    for (auto it = m_dim_grid.begin(); it != m_dim_grid.end(); ++it) {
-        it->trak_hd = false;
+    // clear only the cells marked by the previous tunnel; a full-grid sweep
+    // per planner iteration dwarfs the searches themselves on large maps
+    for (auto& p : m_tunnel_cells) {
+        auto cell = m_dim_grid.get(p.x(), p.y(), p.z());
+        cell.trak_hd = false;
+        m_dim_grid.set(p.x(), p.y(), p.z(), cell);
     }
+    m_tunnel_cells.clear();
 
     std::vector<Eigen::Vector3i> tunnel;
     for (int state_id : states) {
-        double px, py, pz;
-
         AdaptiveState* state = m_states[state_id];
 
+        int gx, gy, gz;
         if (state_id == m_goal_state_id) {
-            px = goal().pose.translation()[0];
-            py = goal().pose.translation()[1];
-            pz = goal().pose.translation()[2];
+            m_grid->worldToGrid(
+                    goal().pose.translation()[0],
+                    goal().pose.translation()[1],
+                    goal().pose.translation()[2],
+                    gx, gy, gz);
         }
         else if (state->hid) {
             AdaptiveWorkspaceState* hi_state = (AdaptiveWorkspaceState*)state;
-            WorkspaceState wstate;
-            stateCoordToWorkspace(hi_state->coord, wstate);
-            px = wstate[0];
-            py = wstate[1];
-            pz = wstate[2];
+            gx = hi_state->gx;
+            gy = hi_state->gy;
+            gz = hi_state->gz;
         } else {
             AdaptiveGridState* lo_state = (AdaptiveGridState*)state;
-            px = lo_state->x;
-            py = lo_state->y;
-            pz = lo_state->z;
+            m_grid->worldToGrid(lo_state->x, lo_state->y, lo_state->z, gx, gy, gz);
         }
 
-        int gx, gy, gz;
-        m_grid->worldToGrid(px, py, pz, gx, gy, gz);
-
         if (!m_grid->isInBounds(gx, gy, gz)) {
             SMPL_ERROR_NAMED(G_LOG, "Failed to create tunnel. State (%d, %d, %d) out of bounds", gx, gy, gz);
             return false;
@@ -258,7 +257,12 @@ bool AdaptiveWorkspaceLattice::setTunnel(const std::vector<int>& states)
         for (int dz = -radius; dz <= radius; ++dz) {
             Eigen::Vector3i p = gp + Eigen::Vector3i(dx, dy, dz);
             if (m_grid->isInBounds(p.x(), p.y(), p.z())) {
-                m_dim_grid(p.x(), p.y(), p.z()).trak_hd = true;
+                auto cell = m_dim_grid.get(p.x(), p.y(), p.z());
+                if (!cell.trak_hd) {
+                    cell.trak_hd = true;
+                    m_dim_grid.set(p.x(), p.y(), p.z(), cell);
+                    m_tunnel_cells.push_back(p);
+                }
                 ++marked;
             }
         }
@@ -539,7 +543,7 @@ bool AdaptiveWorkspaceLattice::initMotionPrimitives()
                     continue;
                 }
 
-                std::vector<double> d(m_dof_count, 0.0);
+                RobotState d(m_dof_count, 0.0);
                 d[0] = m_res[0] * dx;
                 d[1] = m_res[1] * dy;
                 d[2] = m_res[2] * dz;
@@ -554,7 +558,7 @@ bool AdaptiveWorkspaceLattice::initMotionPrimitives()
 
     // create 2-connected motions for rotation and free angle motions
     for (int a = 3; a < m_dof_count; ++a) {
-        std::vector<double> d(m_dof_count, 0.0);
+        RobotState d(m_dof_count, 0.0);
 
         d[a] = m_res[a] * -1;
         prim.type = MotionPrimitive::Type::LONG_DISTANCE;
@@ -906,6 +910,18 @@ int AdaptiveWorkspaceLattice::createHiState(
     AdaptiveWorkspaceState* hi_state = getHiHashEntry(state_id);
     hi_state->coord = coord;
     hi_state->state = state;
+
+    // project to 3-d once at creation; the coord is immutable, so the cached
+    // position and cell stay valid for the lifetime of the state
+    WorkspaceState wstate;
+    stateCoordToWorkspace(coord, wstate);
+    hi_state->px = wstate[0];
+    hi_state->py = wstate[1];
+    hi_state->pz = wstate[2];
+    m_grid->worldToGrid(
+            wstate[0], wstate[1], wstate[2],
+            hi_state->gx, hi_state->gy, hi_state->gz);
+
     m_hi_to_id[hi_state] = state_id;
     return state_id;
 }
@@ -962,7 +978,7 @@ void AdaptiveWorkspaceLattice::getActions(
         double goal_dist = h->getMetricGoalDistance(
                 cont_state[0], cont_state[1], cont_state[2]);
         if (goal_dist < m_ik_amp_thresh) {
-            std::vector<double> ik_sol;
+            RobotState ik_sol;
             if (m_ik_iface->computeIK(goal().pose, state.state, ik_sol)) {
                 WorkspaceState final_state;
                 stateRobotToWorkspace(ik_sol, final_state);
@@ -0,0 +1,660 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <smpl/graph/experience_dedup.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+static void AppendFlat(const RobotState& state, std::vector<double>* flat)
+{
+    flat->insert(flat->end(), state.begin(), state.end());
+}
+
+// The constituent graph elements of an extracted path, recorded when the
+// caller intends to erase paths rather than just compare against them.
+struct ChainIds
+{
+    std::vector<ExperienceGraph::edge_id> edges;
+    std::vector<ExperienceGraph::node_id> nodes;
+};
+
+// Walk a maximal chain from node u across edge e, appending node states and
+// oriented edge waypoints to a flattened path, until a node of degree != 2
+// or an already-visited edge terminates the chain.
+static void WalkChain(
+    const ExperienceGraph& eg,
+    ExperienceGraph::node_id u,
+    ExperienceGraph::edge_id e,
+    std::vector<bool>* visited,
+    int path_index,
+    ExperiencePathSet* paths,
+    ChainIds* ids)
+{
+    std::vector<double> flat;
+    AppendFlat(eg.state(u), &flat);
+    paths->node_to_path[u] = path_index;
+    if (ids != NULL) {
+        ids->nodes.push_back(u);
+    }
+
+    for (;;) {
+        (*visited)[e] = true;
+        if (ids != NULL) {
+            ids->edges.push_back(e);
+        }
+
+        auto s = eg.source(e);
+        auto t = eg.target(e);
+        auto v = (s == u) ? t : s;
+
+        auto& waypoints = eg.waypoints(e);
+        if (s == u) {
+            for (auto it = begin(waypoints); it != end(waypoints); ++it) {
+                AppendFlat(*it, &flat);
+            }
+        } else {
+            // stored snode -> tnode; traverse in reverse
+            for (auto it = waypoints.rbegin(); it != waypoints.rend(); ++it) {
+                AppendFlat(*it, &flat);
+            }
+        }
+
+        AppendFlat(eg.state(v), &flat);
+        paths->node_to_path[v] = path_index;
+        if (ids != NULL) {
+            ids->nodes.push_back(v);
+        }
+
+        if (eg.degree(v) != 2) {
+            break;
+        }
+
+        auto next = std::make_pair(false, ExperienceGraph::edge_id());
+        auto ees = eg.edges(v);
+        for (auto eit = ees.first; eit != ees.second; ++eit) {
+            if (!(*visited)[*eit]) {
+                next = std::make_pair(true, *eit);
+                break;
+            }
+        }
+        if (!next.first) {
+            break;
+        }
+
+        u = v;
+        e = next.second;
+    }
+
+    paths->paths.push_back(std::move(flat));
+}
+
+static void ExtractPaths(
+    const ExperienceGraph& eg,
+    ExperiencePathSet* paths,
+    std::vector<ChainIds>* ids)
+{
+    ExperiencePathSet p;
+    p.node_to_path.assign(eg.num_nodes(), -1);
+
+    if (eg.num_nodes() > 0) {
+        p.dof = (int)eg.state(0).size();
+    }
+
+    std::vector<bool> visited(eg.num_edges(), false);
+
+    auto walk = [&](ExperienceGraph::node_id n, ExperienceGraph::edge_id e) {
+        ChainIds chain;
+        WalkChain(eg, n, e, &visited, (int)p.paths.size(), &p,
+                (ids != NULL) ? &chain : NULL);
+        if (ids != NULL) {
+            ids->push_back(std::move(chain));
+        }
+    };
+
+    // chains rooted at endpoints and junctions
+    auto ns = eg.nodes();
+    for (auto nit = ns.first; nit != ns.second; ++nit) {
+        auto n = *nit;
+        if (eg.degree(n) == 2) {
+            continue;
+        }
+        auto ees = eg.edges(n);
+        for (auto eit = ees.first; eit != ees.second; ++eit) {
+            if (!visited[*eit]) {
+                walk(n, *eit);
+            }
+        }
+    }
+
+    // remaining unvisited edges belong to pure cycles
+    for (auto nit = ns.first; nit != ns.second; ++nit) {
+        auto n = *nit;
+        auto ees = eg.edges(n);
+        for (auto eit = ees.first; eit != ees.second; ++eit) {
+            if (!visited[*eit]) {
+                walk(n, *eit);
+            }
+        }
+    }
+
+    *paths = std::move(p);
+}
+
+void ExtractExperiencePaths(
+    const ExperienceGraph& eg,
+    ExperiencePathSet* paths)
+{
+    ExtractPaths(eg, paths, NULL);
+}
+
+// Squared joint-space distances from waypoint a to every waypoint of b,
+// written as one flat row for the dynamic programs below.
+static void DistRow(
+    const double* a,
+    const double* b,
+    int m,
+    int dof,
+    double* row)
+{
+    for (auto j = 0; j < m; ++j) {
+        auto* bj = b + (size_t)j * dof;
+        auto sum = 0.0;
+        for (auto d = 0; d < dof; ++d) {
+            auto diff = a[d] - bj[d];
+            sum += diff * diff;
+        }
+        row[j] = sum;
+    }
+}
+
+double DynamicTimeWarpingCost(
+    const double* a, int n,
+    const double* b, int m,
+    int dof)
+{
+    if ((n <= 0) | (m <= 0)) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    auto inf = std::numeric_limits<double>::infinity();
+    std::vector<double> prev(m + 1, inf);
+    std::vector<double> curr(m + 1, inf);
+    std::vector<double> dist(m);
+    prev[0] = 0.0;
+
+    for (auto i = 0; i < n; ++i) {
+        DistRow(a + (size_t)i * dof, b, m, dof, dist.data());
+        curr[0] = inf;
+        for (auto j = 1; j <= m; ++j) {
+            auto best = std::min(std::min(prev[j], curr[j - 1]), prev[j - 1]);
+            curr[j] = std::sqrt(dist[j - 1]) + best;
+        }
+        prev.swap(curr);
+    }
+
+    return prev[m];
+}
+
+double DiscreteFrechetDistance(
+    const double* a, int n,
+    const double* b, int m,
+    int dof)
+{
+    if ((n <= 0) | (m <= 0)) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // min/max commute with sqrt, so run the recurrence on squared distances
+    // and take one root at the end
+    std::vector<double> prev(m);
+    std::vector<double> curr(m);
+    std::vector<double> dist(m);
+
+    DistRow(a, b, m, dof, dist.data());
+    prev[0] = dist[0];
+    for (auto j = 1; j < m; ++j) {
+        prev[j] = std::max(dist[j], prev[j - 1]);
+    }
+
+    for (auto i = 1; i < n; ++i) {
+        DistRow(a + (size_t)i * dof, b, m, dof, dist.data());
+        curr[0] = std::max(dist[0], prev[0]);
+        for (auto j = 1; j < m; ++j) {
+            auto reach = std::min(
+                    std::min(prev[j], curr[j - 1]), prev[j - 1]);
+            curr[j] = std::max(dist[j], reach);
+        }
+        prev.swap(curr);
+    }
+
+    return std::sqrt(prev[m - 1]);
+}
+
+static void FlattenPath(
+    const std::vector<RobotState>& path,
+    std::vector<double>* flat)
+{
+    for (auto& state : path) {
+        AppendFlat(state, flat);
+    }
+}
+
+double DynamicTimeWarpingCost(
+    const std::vector<RobotState>& a,
+    const std::vector<RobotState>& b)
+{
+    if (a.empty() || b.empty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    std::vector<double> fa, fb;
+    FlattenPath(a, &fa);
+    FlattenPath(b, &fb);
+    return DynamicTimeWarpingCost(
+            fa.data(), (int)a.size(),
+            fb.data(), (int)b.size(),
+            (int)a.front().size());
+}
+
+double DiscreteFrechetDistance(
+    const std::vector<RobotState>& a,
+    const std::vector<RobotState>& b)
+{
+    if (a.empty() || b.empty()) {
+        return std::numeric_limits<double>::infinity();
+    }
+    std::vector<double> fa, fb;
+    FlattenPath(a, &fa);
+    FlattenPath(b, &fb);
+    return DiscreteFrechetDistance(
+            fa.data(), (int)a.size(),
+            fb.data(), (int)b.size(),
+            (int)a.front().size());
+}
+
+// Test a flattened candidate against a selected reference path under the
+// threshold policy.
+static bool KernelsSayDuplicate(
+    const double* cand, int n,
+    const std::vector<double>& path,
+    int dof,
+    const PathDedupParams& params)
+{
+    auto m = (int)(path.size() / dof);
+    auto dtw = DynamicTimeWarpingCost(cand, n, path.data(), m, dof);
+    if (dtw / (double)(n + m) <= params.dtw_threshold) {
+        return true;
+    }
+    auto frechet = DiscreteFrechetDistance(cand, n, path.data(), m, dof);
+    return frechet <= params.frechet_threshold;
+}
+
+bool IsDuplicatePath(
+    const std::vector<RobotState>& candidate,
+    const ExperiencePathSet& paths,
+    ExperienceGraphIndex* index,
+    const PathDedupParams& params,
+    int* duplicate_of)
+{
+    if (candidate.empty() || paths.paths.empty()) {
+        return false;
+    }
+    auto dof = (int)candidate.front().size();
+    if (dof != paths.dof) {
+        return false;
+    }
+
+    auto n = (int)candidate.size();
+    std::vector<double> flat;
+    flat.reserve((size_t)n * dof);
+    FlattenPath(candidate, &flat);
+
+    // gather the reference paths the candidate overlaps spatially; without
+    // an index every path is a kernel candidate
+    std::vector<int> selected;
+    if (index != NULL) {
+        std::vector<int> hits(paths.paths.size(), 0);
+        std::vector<int> stamp(paths.paths.size(), -1);
+        std::vector<ExperienceGraphIndex::node_id> nearby;
+        for (auto i = 0; i < n; ++i) {
+            nearby.clear();
+            index->nodesInRadius(candidate[i], params.prune_radius, nearby);
+            for (auto nid : nearby) {
+                auto path = paths.node_to_path[nid];
+                if (path < 0 || stamp[path] == i) {
+                    continue;
+                }
+                stamp[path] = i;
+                ++hits[path];
+            }
+        }
+
+        auto required = params.min_overlap * (double)n;
+        for (auto i = 0; i < (int)paths.paths.size(); ++i) {
+            if ((double)hits[i] >= required) {
+                selected.push_back(i);
+            }
+        }
+    } else {
+        selected.resize(paths.paths.size());
+        for (auto i = 0; i < (int)paths.paths.size(); ++i) {
+            selected[i] = i;
+        }
+    }
+
+    for (auto i : selected) {
+        if (KernelsSayDuplicate(flat.data(), n, paths.paths[i], dof, params)) {
+            if (duplicate_of != NULL) {
+                *duplicate_of = i;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void FilterExperiencePaths(
+    std::vector<std::vector<RobotState>>* candidates,
+    const ExperienceGraph& eg,
+    ExperienceGraphIndex* index,
+    const PathDedupParams& params)
+{
+    if (candidates->empty()) {
+        return;
+    }
+
+    ExperiencePathSet paths;
+    ExtractExperiencePaths(eg, &paths);
+
+    auto num_threads = params.num_threads;
+    if (num_threads <= 0) {
+        num_threads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, (int)candidates->size());
+
+    // warm the index before sharing it read-only across threads, so its lazy
+    // rebuild happens here rather than racing inside the workers
+    if (index != NULL && eg.num_nodes() > 0) {
+        std::vector<ExperienceGraphIndex::node_id> scratch;
+        index->nodesInRadius(eg.state(0), 0.0, scratch);
+    }
+
+    std::vector<char> duplicate(candidates->size(), 0);
+
+    auto test_range = [&](int tidx) {
+        for (auto i = tidx; i < (int)candidates->size(); i += num_threads) {
+            if (IsDuplicatePath((*candidates)[i], paths, index, params)) {
+                duplicate[i] = 1;
+            }
+        }
+    };
+
+    if (num_threads == 1) {
+        test_range(0);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (auto t = 0; t < num_threads; ++t) {
+            threads.emplace_back(test_range, t);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // deduplicate the survivors against each other in submission order
+    std::vector<std::vector<double>> accepted;
+    std::vector<std::vector<RobotState>> kept;
+    for (size_t i = 0; i < candidates->size(); ++i) {
+        if (duplicate[i]) {
+            continue;
+        }
+        auto& candidate = (*candidates)[i];
+        auto dof = candidate.empty() ? 0 : (int)candidate.front().size();
+
+        std::vector<double> flat;
+        FlattenPath(candidate, &flat);
+
+        auto dup = false;
+        for (auto& other : accepted) {
+            if (dof > 0 && (int)other.size() % dof == 0 &&
+                KernelsSayDuplicate(
+                        flat.data(), (int)candidate.size(), other, dof, params))
+            {
+                dup = true;
+                break;
+            }
+        }
+        if (dup) {
+            continue;
+        }
+
+        accepted.push_back(std::move(flat));
+        kept.push_back(std::move(candidate));
+    }
+
+    if (kept.size() != candidates->size()) {
+        SMPL_INFO("Dropped %zu near-duplicate paths of %zu submitted",
+                candidates->size() - kept.size(), candidates->size());
+    }
+
+    *candidates = std::move(kept);
+}
+
+// Joint-space length of a flattened path, the cost that orders paths during
+// compaction.
+static double FlatPathLength(const std::vector<double>& path, int dof)
+{
+    auto n = (int)(path.size() / dof);
+    auto len = 0.0;
+    for (auto i = 1; i < n; ++i) {
+        auto* a = path.data() + (size_t)(i - 1) * dof;
+        auto* b = path.data() + (size_t)i * dof;
+        auto sum = 0.0;
+        for (auto d = 0; d < dof; ++d) {
+            auto diff = a[d] - b[d];
+            sum += diff * diff;
+        }
+        len += std::sqrt(sum);
+    }
+    return len;
+}
+
+int CompactExperienceGraph(
+    ExperienceGraph* eg,
+    ExperienceGraphIndex* index,
+    const PathDedupParams& params)
+{
+    ExperiencePathSet paths;
+    std::vector<ChainIds> ids;
+    ExtractPaths(*eg, &paths, &ids);
+
+    auto num_paths = (int)paths.paths.size();
+    if (num_paths < 2) {
+        return 0;
+    }
+    auto dof = paths.dof;
+
+    std::vector<double> costs(num_paths);
+    for (auto i = 0; i < num_paths; ++i) {
+        costs[i] = FlatPathLength(paths.paths[i], dof);
+    }
+
+    // visit paths cheapest-first so every kept path a candidate is tested
+    // against is no more expensive than the candidate itself
+    std::vector<int> order(num_paths);
+    for (auto i = 0; i < num_paths; ++i) {
+        order[i] = i;
+    }
+    std::sort(begin(order), end(order),
+            [&](int u, int v) { return costs[u] < costs[v]; });
+
+    std::vector<char> kept(num_paths, 0);
+    std::vector<char> dominated(num_paths, 0);
+
+    std::vector<int> hits, stamp;
+    std::vector<ExperienceGraphIndex::node_id> nearby;
+
+    for (auto i : order) {
+        auto& flat = paths.paths[i];
+        auto n = (int)(flat.size() / dof);
+
+        // gather the kept paths this one overlaps spatially; without an
+        // index every kept path is a kernel candidate
+        std::vector<int> selected;
+        if (index != NULL) {
+            hits.assign(num_paths, 0);
+            stamp.assign(num_paths, -1);
+            for (auto w = 0; w < n; ++w) {
+                RobotState state(
+                        flat.data() + (size_t)w * dof,
+                        flat.data() + (size_t)(w + 1) * dof);
+                nearby.clear();
+                index->nodesInRadius(state, params.prune_radius, nearby);
+                for (auto nid : nearby) {
+                    auto path = paths.node_to_path[nid];
+                    if (path < 0 || path == i || stamp[path] == w) {
+                        continue;
+                    }
+                    stamp[path] = w;
+                    ++hits[path];
+                }
+            }
+            auto required = params.min_overlap * (double)n;
+            for (auto j = 0; j < num_paths; ++j) {
+                if (kept[j] && (double)hits[j] >= required) {
+                    selected.push_back(j);
+                }
+            }
+        } else {
+            for (auto j = 0; j < num_paths; ++j) {
+                if (kept[j]) {
+                    selected.push_back(j);
+                }
+            }
+        }
+
+        auto dom = false;
+        for (auto j : selected) {
+            if (KernelsSayDuplicate(
+                    flat.data(), n, paths.paths[j], dof, params))
+            {
+                dom = true;
+                break;
+            }
+        }
+
+        if (dom) {
+            dominated[i] = 1;
+        } else {
+            kept[i] = 1;
+        }
+    }
+
+    std::vector<char> edge_doomed(eg->num_edges(), 0);
+    std::vector<char> node_candidate(eg->num_nodes(), 0);
+    auto removed = 0;
+    for (auto i = 0; i < num_paths; ++i) {
+        if (!dominated[i]) {
+            continue;
+        }
+        ++removed;
+        for (auto e : ids[i].edges) {
+            edge_doomed[e] = 1;
+        }
+        for (auto n : ids[i].nodes) {
+            node_candidate[n] = 1;
+        }
+    }
+    if (removed == 0) {
+        return 0;
+    }
+
+    // rebuild the graph from the survivors rather than erasing in place: one
+    // pass renumbers ids compactly and sidesteps the per-erase id fixups.
+    // nodes shared with surviving paths retain an incident edge and are
+    // kept; only the nodes the edge removal isolates are dropped
+    auto node_count = eg->num_nodes();
+    auto edge_count = eg->num_edges();
+
+    ExperienceGraph compact;
+    std::vector<ExperienceGraph::node_id> remap(node_count);
+    for (ExperienceGraph::node_id n = 0; n < node_count; ++n) {
+        auto survives = !node_candidate[n];
+        if (!survives) {
+            auto ees = eg->edges(n);
+            for (auto eit = ees.first; eit != ees.second; ++eit) {
+                if (!edge_doomed[*eit]) {
+                    survives = true;
+                    break;
+                }
+            }
+        }
+        if (survives) {
+            remap[n] = compact.insert_node(eg->state(n));
+        }
+    }
+
+    auto kept_edges = (size_t)0;
+    for (ExperienceGraph::edge_id e = 0; e < edge_count; ++e) {
+        if (!edge_doomed[e]) {
+            compact.insert_edge(
+                    remap[eg->source(e)],
+                    remap[eg->target(e)],
+                    eg->waypoints(e));
+            ++kept_edges;
+        }
+    }
+
+    auto erased_nodes = node_count - compact.num_nodes();
+    auto erased_edges = edge_count - kept_edges;
+    *eg = std::move(compact);
+
+    if (index != NULL) {
+        // node removal invalidates the index; force a rebuild over the
+        // renumbered survivors
+        index->attach(eg);
+    }
+
+    SMPL_INFO("Removed %d dominated paths (%zu edges, %zu nodes) during compaction",
+            removed, erased_edges, erased_nodes);
+
+    return removed;
+}
+
+} // namespace smpl
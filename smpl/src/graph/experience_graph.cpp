@@ -220,6 +220,13 @@ bool ExperienceGraph::incident_edge_iterator::operator!=(
 // ExperienceGraph //
 /////////////////////
 
+static
+void invalidate_adjacency(ExperienceGraph* egraph)
+{
+    egraph->m_csr_offsets.clear();
+    egraph->m_csr_adjacency.clear();
+}
+
 static
 void insert_incident_edge(
     ExperienceGraph* egraph,
@@ -255,6 +262,13 @@ auto ExperienceGraph::edges() const -> std::pair<edge_iterator, edge_iterator>
 auto ExperienceGraph::edges(node_id id) const
     -> std::pair<incident_edge_iterator, incident_edge_iterator>
 {
+    if (!m_csr_offsets.empty()) {
+        return std::make_pair(
+                incident_edge_iterator(
+                        m_csr_adjacency.begin() + m_csr_offsets[id]),
+                incident_edge_iterator(
+                        m_csr_adjacency.begin() + m_csr_offsets[id + 1]));
+    }
     return std::make_pair(
             incident_edge_iterator(m_nodes[id].edges.begin()),
             incident_edge_iterator(m_nodes[id].edges.end()));
@@ -264,6 +278,13 @@ auto ExperienceGraph::edges(node_id id) const
 auto ExperienceGraph::adjacent_nodes(node_id id) const
     -> std::pair<adjacency_iterator, adjacency_iterator>
 {
+    if (!m_csr_offsets.empty()) {
+        return std::make_pair(
+                adjacency_iterator(
+                        m_csr_adjacency.begin() + m_csr_offsets[id]),
+                adjacency_iterator(
+                        m_csr_adjacency.begin() + m_csr_offsets[id + 1]));
+    }
     return std::make_pair(
             adjacency_iterator(m_nodes[id].edges.begin()),
             adjacency_iterator(m_nodes[id].edges.end()));
@@ -313,10 +334,26 @@ bool ExperienceGraph::edge(node_id uid, node_id vid) const
 /// Insert a node.
 auto ExperienceGraph::insert_node(const RobotState& state) -> node_id
 {
+    invalidate_adjacency(this);
     m_nodes.emplace_back(state);
     return m_nodes.size() - 1;
 }
 
+/// Insert a batch of nodes. Node ids are assigned contiguously in input
+/// order.
+/// \return The ID of the first inserted node
+auto ExperienceGraph::insert_nodes(const std::vector<RobotState>& states)
+    -> node_id
+{
+    invalidate_adjacency(this);
+    const node_id first = m_nodes.size();
+    m_nodes.reserve(m_nodes.size() + states.size());
+    for (auto& state : states) {
+        m_nodes.emplace_back(state);
+    }
+    return first;
+}
+
 /// Erase a node. Node iterators and ids after the erased node are invalidated.
 /// Edge iterators and ids after the lowest removed incident edge are
 /// invalidated. All incident edge and adjacenct node iterators are invalidated.
@@ -326,6 +363,8 @@ void ExperienceGraph::erase_node(node_id id)
         throw std::out_of_range("ExperienceGraph::erase_node called with invalid node id");
     }
 
+    invalidate_adjacency(this);
+
     auto& rem_node = m_nodes[id];
 
     // the number of edges to be removed and the smallest id, for updating
@@ -407,12 +446,71 @@ auto ExperienceGraph::insert_edge(node_id uid, node_id vid) -> edge_id
         throw std::out_of_range("ExperienceGraph::insert_edge called with invalid node ids");
     }
 
+    invalidate_adjacency(this);
     m_edges.emplace_back(uid, vid);
     ExperienceGraph::edge_id eid = m_edges.size() - 1;
     insert_incident_edge(this, eid, uid, vid);
     return eid;
 }
 
+/// Insert a batch of waypoint-less edges, allowing parallel edges and
+/// self-loops. Edge ids are assigned contiguously in input order. Each
+/// node's adjacency list is grown at most once.
+void ExperienceGraph::insert_edges(
+    const std::vector<std::pair<node_id, node_id>>& edges)
+{
+    for (auto& e : edges) {
+        if (e.first >= m_nodes.size() || e.second >= m_nodes.size()) {
+            throw std::out_of_range("ExperienceGraph::insert_edges called with invalid node ids");
+        }
+    }
+
+    invalidate_adjacency(this);
+    m_edges.reserve(m_edges.size() + edges.size());
+
+    // pre-size the adjacency lists for their new incident edges
+    std::vector<degree_size_type> extra(m_nodes.size(), 0);
+    for (auto& e : edges) {
+        ++extra[e.first];
+        if (e.second != e.first) {
+            ++extra[e.second];
+        }
+    }
+    for (node_id id = 0; id < m_nodes.size(); ++id) {
+        if (extra[id] != 0) {
+            m_nodes[id].edges.reserve(m_nodes[id].edges.size() + extra[id]);
+        }
+    }
+
+    for (auto& e : edges) {
+        m_edges.emplace_back(e.first, e.second);
+        insert_incident_edge(this, m_edges.size() - 1, e.first, e.second);
+    }
+}
+
+/// Rebuild the compressed-sparse-row adjacency layout from the per-node
+/// adjacency lists. Until the next mutation, incident edge and adjacent node
+/// queries then read from one contiguous edge array, which the adjacency
+/// sweeps of heuristic preprocessing traverse at memory bandwidth. Call
+/// after bulk insertion; mutations fall back to the per-node lists.
+void ExperienceGraph::rebuild_adjacency()
+{
+    m_csr_offsets.resize(m_nodes.size() + 1);
+    degree_size_type count = 0;
+    for (nodes_size_type i = 0; i < m_nodes.size(); ++i) {
+        m_csr_offsets[i] = count;
+        count += m_nodes[i].edges.size();
+    }
+    m_csr_offsets[m_nodes.size()] = count;
+
+    m_csr_adjacency.clear();
+    m_csr_adjacency.reserve(count);
+    for (auto& node : m_nodes) {
+        m_csr_adjacency.insert(
+                m_csr_adjacency.end(), node.edges.begin(), node.edges.end());
+    }
+}
+
 /// Insert an edge, allowing parallel edges and self-loops.
 /// \return The ID of the inserted edge
 auto ExperienceGraph::insert_edge(
@@ -425,6 +523,7 @@ auto ExperienceGraph::insert_edge(
         throw std::out_of_range("ExperienceGraph::insert_edge called with invalid node ids");
     }
 
+    invalidate_adjacency(this);
     m_edges.emplace_back(path, uid, vid);
     ExperienceGraph::edge_id eid = m_edges.size() - 1;
     insert_incident_edge(this, eid, uid, vid);
@@ -477,6 +576,8 @@ void ExperienceGraph::erase_edge(edge_id id)
         throw std::out_of_range("ExperienceGraph::erase_edge called with invalid edge id");
     }
 
+    invalidate_adjacency(this);
+
     auto& e = m_edges[id];
 
     // remove incident edge from source node and update edge ids
@@ -518,9 +619,34 @@ void ExperienceGraph::clear()
 {
     m_nodes.clear();
     m_edges.clear();
+    m_csr_offsets.clear();
+    m_csr_adjacency.clear();
     m_shift.clear();
 }
 
+auto ExperienceGraph::mem_usage() const -> size_t
+{
+    size_t bytes = m_nodes.capacity() * sizeof(Node);
+    for (const Node& node : m_nodes) {
+        bytes += node.state.capacity() * sizeof(double) +
+                node.edges.capacity() * sizeof(Node::adjacency);
+    }
+
+    bytes += m_edges.capacity() * sizeof(Edge);
+    for (const Edge& edge : m_edges) {
+        bytes += edge.waypoints.capacity() * sizeof(RobotState);
+        for (const RobotState& waypoint : edge.waypoints) {
+            bytes += waypoint.capacity() * sizeof(double);
+        }
+    }
+
+    bytes += m_csr_offsets.capacity() * sizeof(degree_size_type) +
+            m_csr_adjacency.capacity() * sizeof(Node::adjacency) +
+            m_shift.capacity() * sizeof(std::ptrdiff_t);
+
+    return bytes;
+}
+
 auto ExperienceGraph::state(node_id id) const -> const RobotState&
 {
     return m_nodes[id].state;
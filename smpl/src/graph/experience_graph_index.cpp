@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/graph/experience_graph_index.h>
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace smpl {
+
+static double JointDistSq(const RobotState& a, const RobotState& b)
+{
+    assert(a.size() == b.size());
+    double dsum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const double d = a[i] - b[i];
+        dsum += d * d;
+    }
+    return dsum;
+}
+
+// Pack a (possibly negative) point cell coordinate into a 64-bit key, 21 bits
+// per axis.
+static uint64_t PackPointCell(int x, int y, int z)
+{
+    return  (((uint64_t)(uint32_t)x & 0x1FFFFF) << 42) |
+            (((uint64_t)(uint32_t)y & 0x1FFFFF) << 21) |
+            ((uint64_t)(uint32_t)z & 0x1FFFFF);
+}
+
+void ExperienceGraphIndex::attach(const ExperienceGraph* eg)
+{
+    m_eg = eg;
+    m_tree.clear();
+    m_indexed_nodes = 0;
+    m_point_cells.clear();
+    m_points.clear();
+    m_point_known.clear();
+}
+
+void ExperienceGraphIndex::nodesInRadius(
+    const RobotState& state,
+    double radius,
+    std::vector<node_id>& nodes)
+{
+    rebuildIfStale();
+    if (m_tree.empty()) {
+        return;
+    }
+    searchRadius(0, state, radius * radius, nodes);
+}
+
+void ExperienceGraphIndex::kNearestNodes(
+    const RobotState& state,
+    int k,
+    std::vector<node_id>& nodes)
+{
+    rebuildIfStale();
+    if (m_tree.empty() || k <= 0) {
+        return;
+    }
+
+    // max-heap of the k best (squared distance, node) pairs seen so far
+    std::vector<std::pair<double, node_id>> best;
+    best.reserve(k + 1);
+    searchNearest(0, state, k, best);
+
+    std::sort_heap(best.begin(), best.end());
+    nodes.reserve(nodes.size() + best.size());
+    for (auto& e : best) {
+        nodes.push_back(e.second);
+    }
+}
+
+void ExperienceGraphIndex::setPointCellSize(double size)
+{
+    assert(size > 0.0);
+    m_point_cell_size = size;
+    m_point_cells.clear();
+    m_points.clear();
+    m_point_known.clear();
+}
+
+void ExperienceGraphIndex::setNodePoint(node_id id, const Vector3& point)
+{
+    if (id >= m_points.size()) {
+        m_points.resize(id + 1);
+        m_point_known.resize(id + 1, false);
+    }
+
+    if (m_point_known[id]) {
+        // remove the stale entry from its old cell
+        const Vector3& old = m_points[id];
+        const int ox = (int)std::floor(old.x() / m_point_cell_size);
+        const int oy = (int)std::floor(old.y() / m_point_cell_size);
+        const int oz = (int)std::floor(old.z() / m_point_cell_size);
+        auto cit = m_point_cells.find(PackPointCell(ox, oy, oz));
+        if (cit != m_point_cells.end()) {
+            auto& cell = cit->second;
+            cell.erase(std::remove(cell.begin(), cell.end(), id), cell.end());
+        }
+    }
+
+    m_points[id] = point;
+    m_point_known[id] = true;
+
+    const int cx = (int)std::floor(point.x() / m_point_cell_size);
+    const int cy = (int)std::floor(point.y() / m_point_cell_size);
+    const int cz = (int)std::floor(point.z() / m_point_cell_size);
+    m_point_cells[PackPointCell(cx, cy, cz)].push_back(id);
+}
+
+void ExperienceGraphIndex::nodesInRadius(
+    const Vector3& point,
+    double radius,
+    std::vector<node_id>& nodes)
+{
+    if (m_point_cells.empty()) {
+        return;
+    }
+
+    const double radius_sq = radius * radius;
+    const int min_x = (int)std::floor((point.x() - radius) / m_point_cell_size);
+    const int min_y = (int)std::floor((point.y() - radius) / m_point_cell_size);
+    const int min_z = (int)std::floor((point.z() - radius) / m_point_cell_size);
+    const int max_x = (int)std::floor((point.x() + radius) / m_point_cell_size);
+    const int max_y = (int)std::floor((point.y() + radius) / m_point_cell_size);
+    const int max_z = (int)std::floor((point.z() + radius) / m_point_cell_size);
+
+    for (int x = min_x; x <= max_x; ++x) {
+    for (int y = min_y; y <= max_y; ++y) {
+    for (int z = min_z; z <= max_z; ++z) {
+        auto cit = m_point_cells.find(PackPointCell(x, y, z));
+        if (cit == m_point_cells.end()) {
+            continue;
+        }
+        for (node_id id : cit->second) {
+            if ((m_points[id] - point).squaredNorm() <= radius_sq) {
+                nodes.push_back(id);
+            }
+        }
+    }
+    }
+    }
+}
+
+void ExperienceGraphIndex::rebuildIfStale()
+{
+    if (!m_eg || m_eg->num_nodes() == m_indexed_nodes) {
+        return;
+    }
+
+    m_indexed_nodes = m_eg->num_nodes();
+    m_tree.clear();
+    if (m_indexed_nodes == 0) {
+        return;
+    }
+
+    std::vector<node_id> ids(m_indexed_nodes);
+    for (node_id i = 0; i < m_indexed_nodes; ++i) {
+        ids[i] = i;
+    }
+
+    m_tree.reserve(m_indexed_nodes);
+    buildTree(ids.data(), ids.size(), 0);
+}
+
+// Recursively build a balanced k-d tree over \p count node ids, splitting on
+// joint variable \p dim at this depth. Returns the index of the subtree root
+// in m_tree, or -1 for an empty span. The root of the whole tree is built
+// first and therefore lands at index 0.
+int ExperienceGraphIndex::buildTree(node_id* ids, size_t count, int dim)
+{
+    if (count == 0) {
+        return -1;
+    }
+
+    const size_t mid = count >> 1;
+    std::nth_element(
+            ids, ids + mid, ids + count,
+            [&](node_id a, node_id b) {
+                return m_eg->state(a)[dim] < m_eg->state(b)[dim];
+            });
+
+    const int n = (int)m_tree.size();
+    m_tree.push_back(TreeNode{ ids[mid], -1, -1, dim });
+
+    const int num_vars = (int)m_eg->state(ids[mid]).size();
+    const int next_dim = (dim + 1 == num_vars) ? 0 : dim + 1;
+
+    // children are built after the node is appended, so store their indices
+    // afterwards; note m_tree may reallocate during recursion
+    const int left = buildTree(ids, mid, next_dim);
+    const int right = buildTree(ids + mid + 1, count - mid - 1, next_dim);
+    m_tree[n].left = left;
+    m_tree[n].right = right;
+    return n;
+}
+
+void ExperienceGraphIndex::searchRadius(
+    int n,
+    const RobotState& q,
+    double radius_sq,
+    std::vector<node_id>& nodes) const
+{
+    const TreeNode& tn = m_tree[n];
+    const RobotState& s = m_eg->state(tn.node);
+
+    if (JointDistSq(q, s) <= radius_sq) {
+        nodes.push_back(tn.node);
+    }
+
+    const double d = q[tn.dim] - s[tn.dim];
+    const int near = d < 0.0 ? tn.left : tn.right;
+    const int far = d < 0.0 ? tn.right : tn.left;
+
+    if (near != -1) {
+        searchRadius(near, q, radius_sq, nodes);
+    }
+    if (far != -1 && d * d <= radius_sq) {
+        searchRadius(far, q, radius_sq, nodes);
+    }
+}
+
+void ExperienceGraphIndex::searchNearest(
+    int n,
+    const RobotState& q,
+    int k,
+    std::vector<std::pair<double, node_id>>& best) const
+{
+    const TreeNode& tn = m_tree[n];
+    const RobotState& s = m_eg->state(tn.node);
+
+    const double dist_sq = JointDistSq(q, s);
+    if ((int)best.size() < k) {
+        best.emplace_back(dist_sq, tn.node);
+        std::push_heap(best.begin(), best.end());
+    } else if (dist_sq < best.front().first) {
+        std::pop_heap(best.begin(), best.end());
+        best.back() = std::make_pair(dist_sq, tn.node);
+        std::push_heap(best.begin(), best.end());
+    }
+
+    const double d = q[tn.dim] - s[tn.dim];
+    const int near = d < 0.0 ? tn.left : tn.right;
+    const int far = d < 0.0 ? tn.right : tn.left;
+
+    if (near != -1) {
+        searchNearest(near, q, k, best);
+    }
+    if (far != -1 && ((int)best.size() < k || d * d < best.front().first)) {
+        searchNearest(far, q, k, best);
+    }
+}
+
+} // namespace smpl
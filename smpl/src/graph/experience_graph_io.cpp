@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <smpl/graph/experience_graph_io.h>
+
+// standard includes
+#include <stdint.h>
+#include <string.h>
+#include <cstdio>
+
+// system includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+static const char g_egraph_magic[8] = {
+    'S', 'M', 'P', 'L', 'E', 'G', 'P', 'H'
+};
+
+struct EgraphFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_variables;
+    uint64_t num_nodes;
+    uint64_t num_edges;
+};
+
+bool WriteExperienceGraph(const ExperienceGraph& eg, const std::string& path)
+{
+    uint32_t num_variables = 0;
+    if (eg.num_nodes() > 0) {
+        num_variables = (uint32_t)eg.state(0).size();
+    }
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == NULL) {
+        SMPL_ERROR("Failed to open '%s' for writing", path.c_str());
+        return false;
+    }
+
+    EgraphFileHeader header;
+    memcpy(header.magic, g_egraph_magic, sizeof(g_egraph_magic));
+    header.version = 1;
+    header.num_variables = num_variables;
+    header.num_nodes = eg.num_nodes();
+    header.num_edges = eg.num_edges();
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    for (ExperienceGraph::node_id nid = 0;
+        ok && nid < eg.num_nodes(); ++nid)
+    {
+        const RobotState& state = eg.state(nid);
+        if (state.size() != num_variables) {
+            SMPL_ERROR("Experience graph states have inconsistent sizes");
+            ok = false;
+            break;
+        }
+        ok = fwrite(state.data(), sizeof(double), state.size(), f) ==
+                state.size();
+    }
+
+    for (ExperienceGraph::edge_id eid = 0;
+        ok && eid < eg.num_edges(); ++eid)
+    {
+        uint64_t desc[3];
+        desc[0] = eg.source(eid);
+        desc[1] = eg.target(eid);
+        const std::vector<RobotState>& waypoints = eg.waypoints(eid);
+        desc[2] = waypoints.size();
+        ok = fwrite(desc, sizeof(desc), 1, f) == 1;
+        for (size_t i = 0; ok && i < waypoints.size(); ++i) {
+            if (waypoints[i].size() != num_variables) {
+                SMPL_ERROR("Experience graph waypoints have inconsistent sizes");
+                ok = false;
+                break;
+            }
+            ok = fwrite(waypoints[i].data(), sizeof(double),
+                    waypoints[i].size(), f) == waypoints[i].size();
+        }
+    }
+
+    fclose(f);
+    return ok;
+}
+
+bool ReadExperienceGraph(const std::string& path, ExperienceGraph& eg)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        SMPL_ERROR("Failed to open '%s' for reading", path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(EgraphFileHeader)) {
+        SMPL_ERROR("'%s' is not an experience graph file", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    const size_t file_size = (size_t)st.st_size;
+    void* mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        SMPL_ERROR("Failed to map '%s'", path.c_str());
+        return false;
+    }
+
+    const char* pos = (const char*)mapping;
+    const char* end = pos + file_size;
+
+    EgraphFileHeader header;
+    memcpy(&header, pos, sizeof(header));
+    pos += sizeof(header);
+
+    if (memcmp(header.magic, g_egraph_magic, sizeof(g_egraph_magic)) != 0 ||
+        header.version != 1)
+    {
+        SMPL_ERROR("'%s' is not an experience graph file", path.c_str());
+        munmap(mapping, file_size);
+        return false;
+    }
+
+    const size_t state_size = header.num_variables * sizeof(double);
+
+    bool ok = (size_t)(end - pos) >= header.num_nodes * state_size;
+
+    // remember ids so appending to a non-empty graph remains valid
+    std::vector<ExperienceGraph::node_id> node_ids;
+    node_ids.reserve(header.num_nodes);
+
+    RobotState state(header.num_variables);
+    for (uint64_t i = 0; ok && i < header.num_nodes; ++i) {
+        memcpy(state.data(), pos, state_size);
+        pos += state_size;
+        node_ids.push_back(eg.insert_node(state));
+    }
+
+    std::vector<RobotState> waypoints;
+    for (uint64_t i = 0; ok && i < header.num_edges; ++i) {
+        uint64_t desc[3];
+        if ((size_t)(end - pos) < sizeof(desc)) {
+            ok = false;
+            break;
+        }
+        memcpy(desc, pos, sizeof(desc));
+        pos += sizeof(desc);
+
+        if (desc[0] >= node_ids.size() || desc[1] >= node_ids.size() ||
+            (size_t)(end - pos) < desc[2] * state_size)
+        {
+            ok = false;
+            break;
+        }
+
+        waypoints.resize(desc[2], RobotState(header.num_variables));
+        for (uint64_t w = 0; w < desc[2]; ++w) {
+            memcpy(waypoints[w].data(), pos, state_size);
+            pos += state_size;
+        }
+
+        eg.insert_edge(node_ids[desc[0]], node_ids[desc[1]], waypoints);
+        waypoints.clear();
+    }
+
+    munmap(mapping, file_size);
+
+    if (!ok) {
+        SMPL_ERROR("'%s' is truncated or malformed", path.c_str());
+    }
+    return ok;
+}
+
+} // namespace smpl
@@ -0,0 +1,390 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/graph/factored_planning_space.h>
+
+// standard includes
+#include <assert.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+// project includes
+#include <smpl/console/console.h>
+#include <smpl/console/nonstd.h>
+
+namespace smpl {
+
+static std::uint64_t MakeStatePairKey(int first_id, int second_id)
+{
+    return ((std::uint64_t)(std::uint32_t)first_id << 32) |
+            (std::uint64_t)(std::uint32_t)second_id;
+}
+
+bool FactoredPlanningSpace::init(
+    RobotModel* robot,
+    CollisionChecker* checker,
+    ManipLattice* first,
+    ManipLattice* second)
+{
+    SMPL_DEBUG_NAMED(G_LOG, "Initialize Factored Planning Space");
+
+    if (!first || !second) {
+        SMPL_ERROR_NAMED(G_LOG, "Component lattice is null");
+        return false;
+    }
+
+    if (first->robot()->jointVariableCount() +
+            second->robot()->jointVariableCount() !=
+        robot->jointVariableCount())
+    {
+        SMPL_ERROR_NAMED(G_LOG, "Component lattices do not partition the composite robot's %zu variables", robot->jointVariableCount());
+        return false;
+    }
+
+    if (!RobotPlanningSpace::init(robot, checker)) {
+        SMPL_ERROR_NAMED(G_LOG, "Failed to initialize Robot Planning Space");
+        return false;
+    }
+
+    m_parts[0].lattice = first;
+    m_parts[1].lattice = second;
+    for (auto& part : m_parts) {
+        part.jvar_count = (int)part.lattice->robot()->jointVariableCount();
+        part.proj = part.lattice->Extension::getExtension<PointProjectionExtension>();
+    }
+
+    m_states.clear();
+    m_state_to_id.clear();
+
+    // reserve an entry for the virtual composite goal state
+    m_goal_state_id = (int)m_states.size();
+    m_states.push_back(FactoredState());
+    m_states.back().part_ids[0] = -1;
+    m_states.back().part_ids[1] = -1;
+    SMPL_DEBUG_NAMED(G_LOG, "  goal state has state ID %d", m_goal_state_id);
+
+    return true;
+}
+
+// Return the continuous state of a component lattice state, resolving the
+// component's virtual goal state to its joint goal configuration.
+auto FactoredPlanningSpace::componentState(int pidx, int part_state_id)
+    -> const RobotState&
+{
+    auto& part = m_parts[pidx];
+    if (part_state_id == part.lattice->getGoalStateID()) {
+        return part.goal_state;
+    }
+    return part.lattice->extractState(part_state_id);
+}
+
+int FactoredPlanningSpace::getOrCreateState(
+    int first_id,
+    int second_id,
+    const RobotState& state)
+{
+    const std::uint64_t key = MakeStatePairKey(first_id, second_id);
+    auto it = m_state_to_id.find(key);
+    if (it != end(m_state_to_id)) {
+        return it->second;
+    }
+
+    const int state_id = (int)m_states.size();
+    FactoredState entry;
+    entry.part_ids[0] = first_id;
+    entry.part_ids[1] = second_id;
+    entry.state = state;
+    m_states.push_back(std::move(entry));
+    m_state_to_id[key] = state_id;
+    return state_id;
+}
+
+// Lazily validate the interaction between the chains for a motion of chain
+// \p pidx, with the other chain holding its configuration. When an
+// interaction radius is configured and both component states project to
+// points, motions whose endpoints are separated by more than the radius are
+// accepted without consulting the composite collision checker.
+bool FactoredPlanningSpace::interactionValid(
+    const FactoredState& from,
+    int pidx,
+    int moved_part_id,
+    const RobotState& to)
+{
+    if (m_interaction_radius >= 0.0) {
+        auto* moved_proj = m_parts[pidx].proj;
+        auto* held_proj = m_parts[1 - pidx].proj;
+        Vector3 p, q;
+        if (moved_proj != NULL && held_proj != NULL &&
+            moved_proj->projectToPoint(moved_part_id, p) &&
+            held_proj->projectToPoint(from.part_ids[1 - pidx], q) &&
+            (p - q).norm() > m_interaction_radius)
+        {
+            return true;
+        }
+    }
+
+    return collisionChecker()->isStateToStateValid(from.state, to);
+}
+
+auto FactoredPlanningSpace::extractState(int state_id) -> const RobotState&
+{
+    assert(state_id >= 0 && state_id < (int)m_states.size());
+    return m_states[state_id].state;
+}
+
+bool FactoredPlanningSpace::setStart(const RobotState& state)
+{
+    if ((int)state.size() != m_parts[0].jvar_count + m_parts[1].jvar_count) {
+        SMPL_ERROR_NAMED(G_LOG, "start state has incorrect number of variables (expected: %d, actual: %zu)", m_parts[0].jvar_count + m_parts[1].jvar_count, state.size());
+        return false;
+    }
+
+    const RobotState first_state(
+            state.begin(), state.begin() + m_parts[0].jvar_count);
+    const RobotState second_state(
+            state.begin() + m_parts[0].jvar_count, state.end());
+
+    if (!m_parts[0].lattice->setStart(first_state) ||
+        !m_parts[1].lattice->setStart(second_state))
+    {
+        return false;
+    }
+
+    // the component lattices have validated each chain against the world;
+    // check the interaction between the chains at the start
+    if (!collisionChecker()->isStateValid(state, true)) {
+        SMPL_WARN("start state is in collision between the chains");
+        return false;
+    }
+
+    m_start_state_id = getOrCreateState(
+            m_parts[0].lattice->getStartStateID(),
+            m_parts[1].lattice->getStartStateID(),
+            state);
+
+    return RobotPlanningSpace::setStart(state);
+}
+
+bool FactoredPlanningSpace::setGoal(const GoalConstraint& goal)
+{
+    if (goal.type != GoalType::JOINT_STATE_GOAL) {
+        SMPL_ERROR_NAMED(G_LOG, "Factored Planning Space requires a joint state goal over the composite variables");
+        return false;
+    }
+
+    if ((int)goal.angles.size() != m_parts[0].jvar_count + m_parts[1].jvar_count) {
+        SMPL_ERROR_NAMED(G_LOG, "goal state has incorrect number of variables (expected: %d, actual: %zu)", m_parts[0].jvar_count + m_parts[1].jvar_count, goal.angles.size());
+        return false;
+    }
+
+    size_t offset = 0;
+    for (auto& part : m_parts) {
+        GoalConstraint part_goal;
+        part_goal.type = GoalType::JOINT_STATE_GOAL;
+        part_goal.angles.assign(
+                goal.angles.begin() + offset,
+                goal.angles.begin() + offset + part.jvar_count);
+        if (goal.angle_tolerances.size() == goal.angles.size()) {
+            part_goal.angle_tolerances.assign(
+                    goal.angle_tolerances.begin() + offset,
+                    goal.angle_tolerances.begin() + offset + part.jvar_count);
+        }
+
+        if (!part.lattice->setGoal(part_goal)) {
+            return false;
+        }
+
+        part.goal_state = part_goal.angles;
+        offset += part.jvar_count;
+    }
+
+    m_states[m_goal_state_id].state = goal.angles;
+
+    return RobotPlanningSpace::setGoal(goal);
+}
+
+int FactoredPlanningSpace::getStartStateID() const
+{
+    return m_start_state_id;
+}
+
+int FactoredPlanningSpace::getGoalStateID() const
+{
+    return m_goal_state_id;
+}
+
+bool FactoredPlanningSpace::extractPath(
+    const std::vector<int>& idpath,
+    std::vector<RobotState>& path)
+{
+    if (idpath.empty()) {
+        return true;
+    }
+
+    if (idpath.size() > 1 && idpath[0] == m_goal_state_id) {
+        SMPL_ERROR_NAMED(G_LOG, "Cannot extract a non-trivial path starting from the goal state");
+        return false;
+    }
+
+    std::vector<RobotState> opath;
+    for (const int state_id : idpath) {
+        if (state_id == m_goal_state_id &&
+            m_states[m_goal_state_id].state.empty())
+        {
+            SMPL_ERROR_NAMED(G_LOG, "No goal state to extract a path to");
+            return false;
+        }
+        opath.push_back(m_states[state_id].state);
+    }
+
+    path = std::move(opath);
+    return true;
+}
+
+Extension* FactoredPlanningSpace::getExtension(size_t class_code)
+{
+    if (class_code == GetClassCode<RobotPlanningSpace>() ||
+        class_code == GetClassCode<ExtractRobotStateExtension>())
+    {
+        return this;
+    }
+    return nullptr;
+}
+
+void FactoredPlanningSpace::GetSuccs(
+    int state_id,
+    std::vector<int>* succs,
+    std::vector<int>* costs)
+{
+    assert(state_id >= 0 && state_id < (int)m_states.size() && "state id out of bounds");
+    assert(succs && costs && "successor buffer is null");
+
+    SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "expanding state %d", state_id);
+
+    // goal state should be absorbing
+    if (state_id == m_goal_state_id) {
+        return;
+    }
+
+    // copy; m_states may grow while successors are created
+    const FactoredState state = m_states[state_id];
+
+    RobotState succ_state(state.state.size());
+    for (int pidx = 0; pidx < 2; ++pidx) {
+        auto& part = m_parts[pidx];
+        const int other = 1 - pidx;
+
+        // a component parked at its goal holds its configuration; its
+        // lattice's goal state is absorbing and yields no successors
+        m_succs.clear();
+        m_costs.clear();
+        part.lattice->GetSuccs(state.part_ids[pidx], &m_succs, &m_costs);
+
+        const size_t offset = (pidx == 0) ? 0 : (size_t)m_parts[0].jvar_count;
+        for (size_t sidx = 0; sidx < m_succs.size(); ++sidx) {
+            const int part_succ_id = m_succs[sidx];
+            auto& moved_state = componentState(pidx, part_succ_id);
+
+            succ_state = state.state;
+            std::copy(
+                    moved_state.begin(), moved_state.end(),
+                    succ_state.begin() + offset);
+
+            if (!interactionValid(state, pidx, part_succ_id, succ_state)) {
+                continue;
+            }
+
+            const bool at_goal =
+                    part_succ_id == part.lattice->getGoalStateID() &&
+                    state.part_ids[other] ==
+                            m_parts[other].lattice->getGoalStateID();
+
+            const int succ_id = at_goal ?
+                    m_goal_state_id :
+                    (pidx == 0) ?
+                            getOrCreateState(
+                                    part_succ_id,
+                                    state.part_ids[1],
+                                    succ_state) :
+                            getOrCreateState(
+                                    state.part_ids[0],
+                                    part_succ_id,
+                                    succ_state);
+
+            succs->push_back(succ_id);
+            costs->push_back(m_costs[sidx]);
+        }
+    }
+}
+
+void FactoredPlanningSpace::GetPreds(
+    int state_id,
+    std::vector<int>* preds,
+    std::vector<int>* costs)
+{
+    SMPL_ERROR_NAMED(G_LOG, "GetPreds unimplemented");
+}
+
+void FactoredPlanningSpace::PrintState(int state_id, bool verbose, FILE* fout)
+{
+    assert(state_id >= 0 && state_id < (int)m_states.size());
+
+    if (!fout) {
+        fout = stdout;
+    }
+
+    auto& entry = m_states[state_id];
+
+    std::stringstream ss;
+    if (state_id == m_goal_state_id) {
+        ss << "<goal state: { state: " << goal().angles << " }>";
+    } else {
+        ss << "{ ";
+        for (size_t i = 0; i < entry.state.size(); ++i) {
+            ss << std::setprecision(3) << entry.state[i];
+            if (i != entry.state.size() - 1) {
+                ss << ", ";
+            }
+        }
+        ss << " }";
+    }
+
+    if (fout == stdout) {
+        SMPL_DEBUG_NAMED(G_LOG, "%s", ss.str().c_str());
+    } else if (fout == stderr) {
+        SMPL_WARN("%s", ss.str().c_str());
+    } else {
+        fprintf(fout, "%s\n", ss.str().c_str());
+    }
+}
+
+} // namespace smpl
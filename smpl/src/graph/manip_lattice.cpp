@@ -33,7 +33,13 @@
 #include <smpl/graph/manip_lattice.h>
 
 // standard includes
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
 #include <iomanip>
+#include <limits>
+#include <numeric>
 #include <sstream>
 
 // system includes
@@ -58,6 +64,14 @@ auto std::hash<smpl::ManipLatticeState>::operator()(
 
 namespace smpl {
 
+// values of ManipLattice::m_coord_modes; see coordToState/stateToCoord
+enum
+{
+    VarModeContinuous = 0,
+    VarModeUnbounded = 1,
+    VarModeBounded = 2,
+};
+
 ManipLattice::~ManipLattice()
 {
     for (size_t i = 0; i < m_states.size(); i++) {
@@ -136,6 +150,35 @@ bool ManipLattice::init(
     m_coord_vals = std::move(discretization);
     m_coord_deltas = std::move(deltas);
 
+    m_coord_modes.resize(_robot->jointVariableCount());
+    m_coord_offsets.resize(_robot->jointVariableCount());
+    for (size_t vidx = 0; vidx < _robot->jointVariableCount(); ++vidx) {
+        if (m_continuous[vidx]) {
+            m_coord_modes[vidx] = VarModeContinuous;
+            m_coord_offsets[vidx] = 0.0;
+        } else if (!m_bounded[vidx]) {
+            m_coord_modes[vidx] = VarModeUnbounded;
+            m_coord_offsets[vidx] = 0.0;
+        } else {
+            m_coord_modes[vidx] = VarModeBounded;
+            m_coord_offsets[vidx] = m_min_limits[vidx];
+        }
+    }
+
+    // enable the packed-key state index when every coordinate is known to fit
+    // within 8 bits; unbounded variables admit negative coordinates and
+    // disqualify packing
+    m_packed_coords = _robot->jointVariableCount() <= 8;
+    for (int vidx = 0; vidx < _robot->jointVariableCount(); ++vidx) {
+        if ((!m_continuous[vidx] && !m_bounded[vidx]) ||
+            m_coord_vals[vidx] > 255)
+        {
+            m_packed_coords = false;
+            break;
+        }
+    }
+    SMPL_DEBUG_NAMED(G_LOG, "  packed coords: %s", m_packed_coords ? "true" : "false");
+
     m_actions = actions;
 
     return true;
@@ -149,8 +192,6 @@ void ManipLattice::PrintState(int stateID, bool verbose, FILE* fout)
         fout = stdout;
     }
 
-    ManipLatticeState* entry = m_states[stateID];
-
     std::stringstream ss;
 
     if (stateID == m_goal_state_id) {
@@ -176,9 +217,10 @@ void ManipLattice::PrintState(int stateID, bool verbose, FILE* fout)
         ss << " }>";
     } else {
         ss << "{ ";
-        for (size_t i = 0; i < entry->state.size(); ++i) {
-            ss << std::setprecision(3) << entry->state[i];
-            if (i != entry->state.size() - 1) {
+        auto& vars = contState(stateID);
+        for (size_t i = 0; i < vars.size(); ++i) {
+            ss << std::setprecision(3) << vars[i];
+            if (i != vars.size() - 1) {
                 ss << ", ";
             }
         }
@@ -210,37 +252,78 @@ void ManipLattice::GetSuccs(
         return;
     }
 
+    // serve the frozen adjacency row, if one exists for this state
+    if ((size_t)state_id + 1 < m_frozen_row.size()) {
+        getFrozenSuccs(state_id, succs, costs);
+        return;
+    }
+
     ManipLatticeState* parent_entry = m_states[state_id];
 
     assert(parent_entry);
     assert(parent_entry->coord.size() >= robot()->jointVariableCount());
 
+    auto& parent_state = contState(state_id);
+
     // log expanded state details
     SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  coord: " << parent_entry->coord);
-    SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  angles: " << parent_entry->state);
+    SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  angles: " << parent_state);
 
     auto* vis_name = "expansion";
-    SV_SHOW_DEBUG_NAMED(vis_name, getStateVisualization(parent_entry->state, vis_name));
+    SV_SHOW_DEBUG_NAMED(vis_name, getStateVisualization(parent_state, vis_name));
 
     int goal_succ_count = 0;
 
-    std::vector<Action> actions;
-    if (!m_actions->apply(parent_entry->state, actions)) {
+    const std::vector<Action>* actions_ptr =
+            m_actions->applyReusable(parent_state);
+    if (!actions_ptr) {
         SMPL_WARN("Failed to get actions");
         return;
     }
+    const std::vector<Action>& actions = *actions_ptr;
 
     SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "  actions: %zu", actions.size());
 
+    auto& action_validity = m_action_validity[state_id];
+    action_validity.resize(actions.size(), -1);
+
+    computeActionCosts(parent_state, actions);
+
+    // batch-compute the planning frame poses of the valid action endpoints
+    // for pose-based goal tests, sharing the fk setup across the batch
+    // instead of invoking fk once per successor
+    auto pose_goal =
+            goal().type == GoalType::XYZ_GOAL ||
+            goal().type == GoalType::XYZ_RPY_GOAL ||
+            goal().type == GoalType::MULTIPLE_POSE_GOAL;
+    if (pose_goal && m_fk_iface) {
+        m_fk_batch_states.clear();
+        for (size_t i = 0; i < actions.size(); ++i) {
+            signed char& valid = action_validity[i];
+            if (valid < 0) {
+                valid = checkAction(parent_state, actions[i]) ? 1 : 0;
+            }
+            if (valid) {
+                m_fk_batch_states.push_back(actions[i].back());
+            }
+        }
+        m_fk_iface->computeFKBatch(m_fk_batch_states, m_fk_batch_poses);
+    }
+
     // check actions for validity
     RobotCoord succ_coord(robot()->jointVariableCount(), 0);
+    size_t fk_idx = 0;
     for (size_t i = 0; i < actions.size(); ++i) {
         auto& action = actions[i];
 
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "    action %zu:", i);
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "      waypoints: %zu", action.size());
 
-        if (!checkAction(parent_entry->state, action)) {
+        signed char& valid = action_validity[i];
+        if (valid < 0) {
+            valid = checkAction(parent_state, action) ? 1 : 0;
+        }
+        if (!valid) {
             continue;
         }
 
@@ -250,14 +333,39 @@ void ManipLattice::GetSuccs(
         // get the successor
 
         // check if hash entry already exists, if not then create one
-        int succ_state_id = getOrCreateState(succ_coord, action.back());
-        ManipLatticeState* succ_entry = getHashEntry(succ_state_id);
+        int succ_state_id = getOrCreateState(succ_coord);
 
         // check if this state meets the goal criteria
-        auto is_goal_succ = isGoal(action.back());
+        bool is_goal_succ;
+        if (pose_goal && m_fk_iface) {
+            auto& succ_pose = m_fk_batch_poses[fk_idx++];
+            // the pose was computed anyway for the goal test; stash it for
+            // the heuristics which project this state later
+            m_pose_cache.insert(std::make_pair(succ_state_id, succ_pose));
+            is_goal_succ = isGoal(action.back(), succ_pose);
+        } else {
+            is_goal_succ = isGoal(action.back());
+        }
+        const int edge_cost = m_action_costs[i];
+
         if (is_goal_succ) {
             // update goal state
             ++goal_succ_count;
+
+            // pin the exact goal-satisfying endpoint so the extracted path
+            // terminates within the goal tolerance rather than at the
+            // coordinate center
+            setContState(succ_state_id, action.back());
+
+            // remember the concrete state behind the cheapest goal
+            // transition for path extraction
+            auto git = m_goal_succ_cache.find(state_id);
+            if (git == m_goal_succ_cache.end() ||
+                edge_cost < git->second.second)
+            {
+                m_goal_succ_cache[state_id] =
+                        std::make_pair(succ_state_id, edge_cost);
+            }
         }
 
         // put successor on successor list with the proper cost
@@ -266,14 +374,14 @@ void ManipLattice::GetSuccs(
         } else {
             succs->push_back(succ_state_id);
         }
-        costs->push_back(cost(parent_entry, succ_entry, is_goal_succ));
+        costs->push_back(edge_cost);
 
         // log successor details
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "      succ: %zu", i);
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        id: %5i", succ_state_id);
         SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        coord: " << succ_coord);
-        SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        state: " << succ_entry->state);
-        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        cost: %5d", cost(parent_entry, succ_entry, is_goal_succ));
+        SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        state: " << action.back());
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        cost: %5d", edge_cost);
     }
 
     if (goal_succ_count > 0) {
@@ -281,6 +389,128 @@ void ManipLattice::GetSuccs(
     }
 }
 
+// Streaming counterpart to GetSuccs. The actions and their optimistic costs
+// are computed up front (both are cheap), but collision checks and goal tests
+// are deferred until a successor is pulled, and successors are yielded
+// cheapest-first, so a search that stops pulling early skips the collision
+// checks of the remaining actions entirely. The stream shares the per-episode
+// action validity cache with GetSuccs and is invalidated by any subsequent
+// successor generation on the lattice.
+class ManipLattice::ActionSuccStream : public SuccessorStream
+{
+public:
+
+    ActionSuccStream(ManipLattice* lattice, int state_id) :
+        m_lattice(lattice),
+        m_state_id(state_id)
+    {
+        // goal state should be absorbing
+        if (state_id == lattice->m_goal_state_id) {
+            return;
+        }
+
+        m_parent_state = &lattice->contState(state_id);
+
+        const std::vector<Action>* actions_ptr =
+                lattice->m_actions->applyReusable(*m_parent_state);
+        if (!actions_ptr) {
+            SMPL_WARN("Failed to get actions");
+            return;
+        }
+        m_actions = actions_ptr;
+
+        lattice->computeActionCosts(*m_parent_state, *actions_ptr);
+        m_costs.assign(
+                lattice->m_action_costs.begin(),
+                lattice->m_action_costs.begin() + actions_ptr->size());
+
+        m_order.resize(actions_ptr->size());
+        std::iota(m_order.begin(), m_order.end(), 0);
+        std::sort(
+                m_order.begin(), m_order.end(),
+                [&](size_t i, size_t j) { return m_costs[i] < m_costs[j]; });
+
+        m_succ_coord.resize(lattice->robot()->jointVariableCount(), 0);
+    }
+
+    int minRemainingCost() const override
+    {
+        if (m_pos == m_order.size()) {
+            return std::numeric_limits<int>::max();
+        }
+        return m_costs[m_order[m_pos]];
+    }
+
+    bool next(int* succ_id, int* cost) override
+    {
+        while (m_pos != m_order.size()) {
+            const size_t i = m_order[m_pos++];
+            const Action& action = (*m_actions)[i];
+
+            auto& action_validity = m_lattice->m_action_validity[m_state_id];
+            action_validity.resize(m_actions->size(), -1);
+            signed char& valid = action_validity[i];
+            if (valid < 0) {
+                valid = m_lattice->checkAction(*m_parent_state, action) ? 1 : 0;
+            }
+            if (!valid) {
+                continue;
+            }
+
+            m_lattice->stateToCoord(action.back(), m_succ_coord);
+            const int succ_state_id =
+                    m_lattice->getOrCreateState(m_succ_coord);
+
+            const int edge_cost = m_costs[i];
+            if (m_lattice->isGoal(action.back())) {
+                // pin the exact goal-satisfying endpoint for path extraction
+                m_lattice->setContState(succ_state_id, action.back());
+
+                // remember the concrete state behind the cheapest goal
+                // transition for path extraction
+                auto git = m_lattice->m_goal_succ_cache.find(m_state_id);
+                if (git == m_lattice->m_goal_succ_cache.end() ||
+                    edge_cost < git->second.second)
+                {
+                    m_lattice->m_goal_succ_cache[m_state_id] =
+                            std::make_pair(succ_state_id, edge_cost);
+                }
+                *succ_id = m_lattice->m_goal_state_id;
+            } else {
+                *succ_id = succ_state_id;
+            }
+            *cost = edge_cost;
+            return true;
+        }
+        return false;
+    }
+
+private:
+
+    ManipLattice* m_lattice;
+    int m_state_id;
+    const RobotState* m_parent_state = nullptr;
+    const std::vector<Action>* m_actions = nullptr;
+    std::vector<int> m_costs;
+    std::vector<size_t> m_order;
+    size_t m_pos = 0;
+    RobotCoord m_succ_coord;
+};
+
+auto ManipLattice::succStream(int state_id) -> std::unique_ptr<SuccessorStream>
+{
+    assert(state_id >= 0 && state_id < m_states.size());
+    assert(m_actions);
+
+    // frozen successors are cheap to materialize eagerly; use the default
+    // stream over GetSuccs() rather than re-deferring validated edges
+    if ((size_t)state_id + 1 < m_frozen_row.size()) {
+        return RobotPlanningSpace::succStream(state_id);
+    }
+
+    return std::unique_ptr<SuccessorStream>(new ActionSuccStream(this, state_id));
+}
+
 Stopwatch GetLazySuccsStopwatch("GetLazySuccs", 10);
 
 void ManipLattice::GetLazySuccs(
@@ -306,22 +536,26 @@ void ManipLattice::GetLazySuccs(
     assert(state_entry);
     assert(state_entry->coord.size() >= robot()->jointVariableCount());
 
+    auto& source_angles = contState(state_id);
+
     // log expanded state details
     SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  coord: " << state_entry->coord);
-    SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  angles: " << state_entry->state);
+    SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  angles: " << source_angles);
 
-    auto& source_angles = state_entry->state;
     auto* vis_name = "expansion";
     SV_SHOW_DEBUG_NAMED(vis_name, getStateVisualization(source_angles, vis_name));
 
-    std::vector<Action> actions;
-    if (!m_actions->apply(source_angles, actions)) {
+    const std::vector<Action>* actions_ptr = m_actions->applyReusable(source_angles);
+    if (!actions_ptr) {
         SMPL_WARN("Failed to get successors");
         return;
     }
+    const std::vector<Action>& actions = *actions_ptr;
 
     SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "  actions: %zu", actions.size());
 
+    computeActionCosts(source_angles, actions);
+
     int goal_succ_count = 0;
     RobotCoord succ_coord(robot()->jointVariableCount());
     for (size_t i = 0; i < actions.size(); ++i) {
@@ -337,23 +571,24 @@ void ManipLattice::GetLazySuccs(
             ++goal_succ_count;
         }
 
-        int succ_state_id = getOrCreateState(succ_coord, action.back());
-        ManipLatticeState* succ_entry = getHashEntry(succ_state_id);
+        int succ_state_id = getOrCreateState(succ_coord);
 
         if (succ_is_goal_state) {
+            // pin the exact goal-satisfying endpoint for path extraction
+            setContState(succ_state_id, action.back());
             succs->push_back(m_goal_state_id);
         } else {
             succs->push_back(succ_state_id);
         }
-        costs->push_back(cost(state_entry, succ_entry, succ_is_goal_state));
+        costs->push_back(m_action_costs[i]);
         true_costs->push_back(false);
 
         // log successor details
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "      succ: %zu", i);
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        id: %5i", succ_state_id);
         SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        coord: " << succ_coord);
-        SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        state: " << succ_entry->state);
-        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        cost: %5d", cost(state_entry, succ_entry, succ_is_goal_state));
+        SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        state: " << action.back());
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        cost: %5d", m_action_costs[i]);
     }
 
     if (goal_succ_count > 0) {
@@ -361,6 +596,17 @@ void ManipLattice::GetLazySuccs(
     }
 }
 
+// ILazySuccFun variant of GetLazySuccs, for searches driven through the lazy
+// search interface rather than DiscreteSpaceInformation
+void ManipLattice::GetLazySuccs(
+    int state_id,
+    std::vector<int>& succs,
+    std::vector<int>& costs,
+    std::vector<bool>& true_costs)
+{
+    GetLazySuccs(state_id, &succs, &costs, &true_costs);
+}
+
 Stopwatch GetTrueCostStopwatch("GetTrueCost", 10);
 
 int ManipLattice::GetTrueCost(int parentID, int childID)
@@ -373,28 +619,32 @@ int ManipLattice::GetTrueCost(int parentID, int childID)
     assert(parentID >= 0 && parentID < (int)m_states.size());
     assert(childID >= 0 && childID < (int)m_states.size());
 
-    ManipLatticeState* parent_entry = m_states[parentID];
+    assert(m_states[parentID] && m_states[parentID]->coord.size() >= robot()->jointVariableCount());
     ManipLatticeState* child_entry = m_states[childID];
-    assert(parent_entry && parent_entry->coord.size() >= robot()->jointVariableCount());
     assert(child_entry && child_entry->coord.size() >= robot()->jointVariableCount());
 
-    auto& parent_angles = parent_entry->state;
+    auto& parent_angles = contState(parentID);
     auto* vis_name = "expansion";
     SV_SHOW_DEBUG_NAMED(vis_name, getStateVisualization(parent_angles, vis_name));
 
-    std::vector<Action> actions;
-    if (!m_actions->apply(parent_angles, actions)) {
+    const std::vector<Action>* actions_ptr = m_actions->applyReusable(parent_angles);
+    if (!actions_ptr) {
         SMPL_WARN("Failed to get actions");
         return -1;
     }
+    const std::vector<Action>& actions = *actions_ptr;
 
     auto goal_edge = (childID == m_goal_state_id);
 
+    auto& action_validity = m_action_validity[parentID];
+    action_validity.resize(actions.size(), -1);
+
     size_t num_actions = 0;
 
     // check actions for validity and find the valid action with the least cost
     RobotCoord succ_coord(robot()->jointVariableCount());
     int best_cost = std::numeric_limits<int>::max();
+    int best_succ_id = -1;
     for (size_t aidx = 0; aidx < actions.size(); ++aidx) {
         auto& action = actions[aidx];
 
@@ -416,31 +666,57 @@ int ManipLattice::GetTrueCost(int parentID, int childID)
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "    action %zu:", num_actions++);
         SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "      waypoints %zu:", action.size());
 
-        if (!checkAction(parent_angles, action)) {
+        signed char& valid = action_validity[aidx];
+        if (valid < 0) {
+            valid = checkAction(parent_angles, action) ? 1 : 0;
+        }
+        if (!valid) {
             continue;
         }
 
         // get the unique state
         int succ_state_id = goal_edge ? getHashEntry(succ_coord) : childID;
-        ManipLatticeState* succ_entry = getHashEntry(succ_state_id);
-        assert(succ_entry);
+        assert(succ_state_id >= 0);
+
+        if (goal_edge) {
+            // pin the exact goal-satisfying endpoint for path extraction
+            setContState(succ_state_id, action.back());
+        }
 
-        auto edge_cost = cost(parent_entry, succ_entry, goal_edge);
+        auto edge_cost = cost(parentID, succ_state_id, goal_edge);
         if (edge_cost < best_cost) {
             best_cost = edge_cost;
+            best_succ_id = succ_state_id;
         }
     }
 
     if (best_cost != std::numeric_limits<int>::max()) {
+        if (goal_edge) {
+            // remember the concrete state behind the cheapest goal
+            // transition for path extraction
+            auto git = m_goal_succ_cache.find(parentID);
+            if (git == m_goal_succ_cache.end() ||
+                best_cost < git->second.second)
+            {
+                m_goal_succ_cache[parentID] =
+                        std::make_pair(best_succ_id, best_cost);
+            }
+        }
         return best_cost;
     } else {
         return -1;
     }
 }
 
+// ILazySuccFun variant of GetTrueCost
+int ManipLattice::GetSuccTrueCost(int state_id, int succ_id)
+{
+    return GetTrueCost(state_id, succ_id);
+}
+
 const RobotState& ManipLattice::extractState(int state_id)
 {
-    return m_states[state_id]->state;
+    return contState(state_id);
 }
 
 bool ManipLattice::projectToPose(int state_id, Affine3& pose)
@@ -450,7 +726,13 @@ bool ManipLattice::projectToPose(int state_id, Affine3& pose)
         return true;
     }
 
-    pose = computePlanningFrameFK(m_states[state_id]->state);
+    auto pit = m_pose_cache.find(state_id);
+    if (pit == m_pose_cache.end()) {
+        pit = m_pose_cache.insert(std::make_pair(
+                state_id,
+                computePlanningFrameFK(contState(state_id)))).first;
+    }
+    pose = pit->second;
     return true;
 }
 
@@ -459,7 +741,132 @@ void ManipLattice::GetPreds(
     std::vector<int>* preds,
     std::vector<int>* costs)
 {
-    SMPL_WARN("GetPreds unimplemented");
+    assert(state_id >= 0 && state_id < m_states.size());
+    assert(preds && costs);
+
+    SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "expand state %d (backward)", state_id);
+
+    auto state_is_goal = (state_id == m_goal_state_id);
+
+    // the goal state is abstract; it may only be expanded backward when the
+    // goal names a concrete configuration, in which case expansion proceeds
+    // from the discretized goal configuration
+    int entry_id = state_id;
+    if (state_is_goal) {
+        if (goal().type != GoalType::JOINT_STATE_GOAL) {
+            SMPL_WARN_ONCE("GetPreds: only joint-space goals may be expanded backward");
+            return;
+        }
+
+        RobotCoord goal_coord(robot()->jointVariableCount());
+        stateToCoord(goal().angles, goal_coord);
+        entry_id = getOrCreateState(goal_coord);
+        setContState(entry_id, goal().angles);
+    }
+
+    ManipLatticeState* state_entry = m_states[entry_id];
+    assert(state_entry);
+    assert(state_entry->coord.size() >= robot()->jointVariableCount());
+
+    auto& state_vars = contState(entry_id);
+
+    // log expanded state details
+    SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  coord: " << state_entry->coord);
+    SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  angles: " << state_vars);
+
+    auto* vis_name = "expansion";
+    SV_SHOW_DEBUG_NAMED(vis_name, getStateVisualization(state_vars, vis_name));
+
+    std::vector<Action> actions;
+    if (!m_actions->applyInverse(state_vars, actions)) {
+        SMPL_WARN_ONCE("GetPreds: the action space does not support inverse application");
+        return;
+    }
+
+    SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "  actions: %zu", actions.size());
+
+    RobotCoord pred_coord(robot()->jointVariableCount(), 0);
+    for (size_t i = 0; i < actions.size(); ++i) {
+        auto& action = actions[i];
+
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "    action %zu:", i);
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "      waypoints: %zu", action.size());
+
+        // inverse actions are rooted at the expanded state; motion validity
+        // is symmetric, so checking them forward checks the converse action
+        // from the predecessor
+        if (!checkAction(state_vars, action)) {
+            continue;
+        }
+
+        stateToCoord(action.back(), pred_coord);
+
+        int pred_state_id = getOrCreateState(pred_coord);
+
+        preds->push_back(pred_state_id);
+        costs->push_back(cost(pred_state_id, entry_id, state_is_goal));
+
+        // log predecessor details
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "      pred: %zu", i);
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        id: %5i", pred_state_id);
+        SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        coord: " << pred_coord);
+        SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        state: " << action.back());
+        SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "        cost: %5d", cost(pred_state_id, entry_id, state_is_goal));
+    }
+}
+
+// Fixed-trip-count conversion kernels. The variable count of a lattice is
+// runtime data, but in practice it is one of a few small values; dispatching
+// to an instantiation with the count baked in lets the compiler unroll the
+// per-variable loops and schedule the loads from the flat discretization
+// arrays, which the generic loops below cannot achieve.
+
+template <int N>
+static void CoordToStateFixed(
+    const double* offsets,
+    const double* deltas,
+    const int* coord,
+    double* state)
+{
+    for (int i = 0; i < N; ++i) {
+        state[i] = offsets[i] + (double)coord[i] * deltas[i];
+    }
+}
+
+template <int N>
+static void StateToCoordFixed(
+    const unsigned char* modes,
+    const double* offsets,
+    const double* deltas,
+    const int* vals,
+    const double* state,
+    int* coord)
+{
+    for (int i = 0; i < N; ++i) {
+        switch (modes[i]) {
+        case VarModeContinuous:
+        {
+            auto pos_angle = normalize_angle_positive(state[i]);
+
+            coord[i] = (int)((pos_angle + deltas[i] * 0.5) / deltas[i]);
+
+            if (coord[i] == vals[i]) {
+                coord[i] = 0;
+            }
+            break;
+        }
+        case VarModeUnbounded:
+            if (state[i] >= 0.0) {
+                coord[i] = (int)(state[i] / deltas[i] + 0.5);
+            } else {
+                coord[i] = (int)(state[i] / deltas[i] - 0.5);
+            }
+            break;
+        default:
+            coord[i] = (int)(((state[i] - offsets[i]) / deltas[i]) + 0.5);
+            break;
+        }
+    }
 }
 
 // angles are counterclockwise from 0 to 360 in radians, 0 is the center of bin
@@ -471,14 +878,25 @@ void ManipLattice::coordToState(
     assert((int)state.size() == robot()->jointVariableCount() &&
             (int)coord.size() == robot()->jointVariableCount());
 
+    switch (coord.size()) {
+    case 6:
+        return CoordToStateFixed<6>(
+                m_coord_offsets.data(), m_coord_deltas.data(),
+                coord.data(), state.data());
+    case 7:
+        return CoordToStateFixed<7>(
+                m_coord_offsets.data(), m_coord_deltas.data(),
+                coord.data(), state.data());
+    case 8:
+        return CoordToStateFixed<8>(
+                m_coord_offsets.data(), m_coord_deltas.data(),
+                coord.data(), state.data());
+    default:
+        break;
+    }
+
     for (size_t i = 0; i < coord.size(); ++i) {
-        if (m_continuous[i]) {
-            state[i] = coord[i] * m_coord_deltas[i];
-        } else if (!m_bounded[i]) {
-            state[i] = (double)coord[i] * m_coord_deltas[i];
-        } else {
-            state[i] = m_min_limits[i] + coord[i] * m_coord_deltas[i];
-        }
+        state[i] = m_coord_offsets[i] + (double)coord[i] * m_coord_deltas[i];
     }
 }
 
@@ -489,8 +907,30 @@ void ManipLattice::stateToCoord(
     assert((int)state.size() == robot()->jointVariableCount() &&
             (int)coord.size() == robot()->jointVariableCount());
 
+    switch (state.size()) {
+    case 6:
+        return StateToCoordFixed<6>(
+                m_coord_modes.data(), m_coord_offsets.data(),
+                m_coord_deltas.data(), m_coord_vals.data(),
+                state.data(), coord.data());
+    case 7:
+        return StateToCoordFixed<7>(
+                m_coord_modes.data(), m_coord_offsets.data(),
+                m_coord_deltas.data(), m_coord_vals.data(),
+                state.data(), coord.data());
+    case 8:
+        return StateToCoordFixed<8>(
+                m_coord_modes.data(), m_coord_offsets.data(),
+                m_coord_deltas.data(), m_coord_vals.data(),
+                state.data(), coord.data());
+    default:
+        break;
+    }
+
     for (size_t i = 0; i < state.size(); ++i) {
-        if (m_continuous[i]) {
+        switch (m_coord_modes[i]) {
+        case VarModeContinuous:
+        {
             auto pos_angle = normalize_angle_positive(state[i]);
 
             coord[i] = (int)((pos_angle + m_coord_deltas[i] * 0.5) / m_coord_deltas[i]);
@@ -498,14 +938,18 @@ void ManipLattice::stateToCoord(
             if (coord[i] == m_coord_vals[i]) {
                 coord[i] = 0;
             }
-        } else if (!m_bounded[i]) {
+            break;
+        }
+        case VarModeUnbounded:
             if (state[i] >= 0.0) {
                 coord[i] = (int)(state[i] / m_coord_deltas[i] + 0.5);
             } else {
                 coord[i] = (int)(state[i] / m_coord_deltas[i] - 0.5);
             }
-        } else {
+            break;
+        default:
             coord[i] = (int)(((state[i] - m_min_limits[i]) / m_coord_deltas[i]) + 0.5);
+            break;
         }
     }
 }
@@ -523,6 +967,16 @@ ManipLatticeState* ManipLattice::getHashEntry(int state_id) const
 /// state has not yet been allocated.
 int ManipLattice::getHashEntry(const RobotCoord& coord)
 {
+    if (m_packed_coords) {
+        return packedGetState(packCoord(coord));
+    }
+
+    // the filter has no false negatives, so a miss here means the
+    // coordinate has never been allocated
+    if (!m_coord_filter.empty() && !coordFilterContains(coordFilterKey(coord))) {
+        return -1;
+    }
+
     ManipLatticeState state;
     state.coord = coord;
     auto sit = m_state_to_id.find(&state);
@@ -532,29 +986,29 @@ int ManipLattice::getHashEntry(const RobotCoord& coord)
     return sit->second;
 }
 
-int ManipLattice::createHashEntry(
-    const RobotCoord& coord,
-    const RobotState& state)
+int ManipLattice::createHashEntry(const RobotCoord& coord)
 {
     int state_id = reserveHashEntry();
     ManipLatticeState* entry = getHashEntry(state_id);
 
     entry->coord = coord;
-    entry->state = state;
 
     // map state -> state id
-    m_state_to_id[entry] = state_id;
+    if (m_packed_coords) {
+        packedInsertState(packCoord(coord), state_id);
+    } else {
+        m_state_to_id[entry] = state_id;
+        coordFilterInsert(coordFilterKey(coord));
+    }
 
     return state_id;
 }
 
-int ManipLattice::getOrCreateState(
-    const RobotCoord& coord,
-    const RobotState& state)
+int ManipLattice::getOrCreateState(const RobotCoord& coord)
 {
     int state_id = getHashEntry(coord);
     if (state_id < 0) {
-        state_id = createHashEntry(coord, state);
+        state_id = createHashEntry(coord);
     }
     return state_id;
 }
@@ -575,6 +1029,172 @@ int ManipLattice::reserveHashEntry()
     return state_id;
 }
 
+/// Return the continuous state of \p state_id, materializing it on first
+/// touch. States recorded with an explicit configuration via setContState()
+/// (the start state, experience waypoints, goal-satisfying action endpoints)
+/// return that configuration; all other states materialize the center of
+/// their discrete coordinate, computed once and memoized. The returned
+/// reference remains valid until clearStates().
+auto ManipLattice::contState(int state_id) -> const RobotState&
+{
+    auto eit = m_exact_states.find(state_id);
+    if (eit != m_exact_states.end()) {
+        return eit->second;
+    }
+
+    auto cit = m_cont_state_cache.find(state_id);
+    if (cit == m_cont_state_cache.end()) {
+        const RobotCoord& coord = m_states[state_id]->coord;
+        RobotState state;
+        if (!coord.empty()) {
+            state.resize(robot()->jointVariableCount());
+            coordToState(coord, state);
+        }
+        // reserved virtual entries (e.g. the goal state) have no coordinate
+        // and materialize an empty state
+        cit = m_cont_state_cache.insert(
+                std::make_pair(state_id, std::move(state))).first;
+    }
+    return cit->second;
+}
+
+/// Record the exact continuous state of \p state_id, overriding the
+/// coordinate center contState() would otherwise materialize.
+void ManipLattice::setContState(int state_id, const RobotState& state)
+{
+    // any stale entry in m_cont_state_cache is left in place: contState()
+    // consults the exact map first, so the new state shadows it, and erasing
+    // the node would invalidate references to it that expansion loops may
+    // still hold (e.g. the parent state when a goal successor lands in the
+    // parent's own cell)
+    m_exact_states[state_id] = state;
+}
+
+// Encode a discrete coordinate into a single 64-bit key, 8 bits per variable.
+uint64_t ManipLattice::packCoord(const RobotCoord& coord) const
+{
+    assert(m_packed_coords);
+
+    uint64_t key = 0;
+    for (size_t i = 0; i < coord.size(); ++i) {
+        assert(coord[i] >= 0 && coord[i] < 256);
+        key = (key << 8) | (uint64_t)(unsigned)coord[i];
+    }
+    return key;
+}
+
+// Return the state id mapped to a packed coordinate key or -1 if the state has
+// not yet been allocated.
+int ManipLattice::packedGetState(uint64_t key) const
+{
+    if (m_coord_to_id.empty()) {
+        return -1;
+    }
+
+    const size_t mask = m_coord_to_id.size() - 1;
+    // finalizer from splitmix64 to scatter packed keys
+    uint64_t h = key;
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27; h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+
+    for (size_t probe = h & mask; ; probe = (probe + 1) & mask) {
+        const auto& slot = m_coord_to_id[probe];
+        if (slot.second == -1) {
+            return -1;
+        }
+        if (slot.first == key) {
+            return slot.second;
+        }
+    }
+}
+
+// Insert a mapping from a packed coordinate key to a state id, growing the
+// table when it exceeds half capacity.
+void ManipLattice::packedInsertState(uint64_t key, int state_id)
+{
+    if (2 * (m_coord_to_id_count + 1) > m_coord_to_id.size()) {
+        size_t new_size = m_coord_to_id.empty() ? 1024 : 2 * m_coord_to_id.size();
+        std::vector<std::pair<uint64_t, int>> old_table(
+                new_size, std::make_pair((uint64_t)0, -1));
+        old_table.swap(m_coord_to_id);
+        m_coord_to_id_count = 0;
+        for (const auto& slot : old_table) {
+            if (slot.second != -1) {
+                packedInsertState(slot.first, slot.second);
+            }
+        }
+    }
+
+    const size_t mask = m_coord_to_id.size() - 1;
+    uint64_t h = key;
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ull;
+    h ^= h >> 27; h *= 0x94d049bb133111ebull;
+    h ^= h >> 31;
+
+    size_t probe = h & mask;
+    while (m_coord_to_id[probe].second != -1) {
+        probe = (probe + 1) & mask;
+    }
+    m_coord_to_id[probe] = std::make_pair(key, state_id);
+    ++m_coord_to_id_count;
+}
+
+// Hash a discrete coordinate into the 64-bit key tested against the bloom
+// filter front.
+uint64_t ManipLattice::coordFilterKey(const RobotCoord& coord) const
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < coord.size(); ++i) {
+        h ^= (uint64_t)(unsigned)coord[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// Return false if the coordinate hashing to \p key has definitely never been
+// allocated. A true return says nothing and the exact table decides.
+bool ManipLattice::coordFilterContains(uint64_t key) const
+{
+    const uint64_t mask = (uint64_t)m_coord_filter.size() * 64 - 1;
+    uint64_t h2 = key;
+    h2 ^= h2 >> 33; h2 *= 0xff51afd7ed558ccdull; h2 ^= h2 >> 33;
+
+    const uint64_t b1 = key & mask;
+    const uint64_t b2 = (key + h2) & mask;
+    return (m_coord_filter[b1 >> 6] & (1ull << (b1 & 63))) &&
+            (m_coord_filter[b2 >> 6] & (1ull << (b2 & 63)));
+}
+
+// Mark the coordinate hashing to \p key as allocated, rebuilding the filter
+// at double capacity when the state count outgrows the size it was built for.
+void ManipLattice::coordFilterInsert(uint64_t key)
+{
+    if (m_state_to_id.size() > m_coord_filter_cap) {
+        // ~16 bits per state at capacity keeps the two-probe false positive
+        // rate in the low percents
+        size_t words = 256;
+        while (64 * words < 16 * 2 * m_state_to_id.size()) {
+            words <<= 1;
+        }
+        m_coord_filter.assign(words, 0);
+        m_coord_filter_cap = 64 * words / 16;
+        for (const auto& e : m_state_to_id) {
+            coordFilterInsert(coordFilterKey(e.first->coord));
+        }
+        return;
+    }
+
+    const uint64_t mask = (uint64_t)m_coord_filter.size() * 64 - 1;
+    uint64_t h2 = key;
+    h2 ^= h2 >> 33; h2 *= 0xff51afd7ed558ccdull; h2 ^= h2 >> 33;
+
+    const uint64_t b1 = key & mask;
+    const uint64_t b2 = (key + h2) & mask;
+    m_coord_filter[b1 >> 6] |= 1ull << (b1 & 63);
+    m_coord_filter[b2 >> 6] |= 1ull << (b2 & 63);
+}
+
 /// NOTE: const although RobotModel::computeFK used underneath may
 /// not be
 auto ManipLattice::computePlanningFrameFK(const RobotState& state) const
@@ -586,13 +1206,33 @@ auto ManipLattice::computePlanningFrameFK(const RobotState& state) const
     return m_fk_iface->computeFK(state);
 }
 
-int ManipLattice::cost(
-    ManipLatticeState* HashEntry1,
-    ManipLatticeState* HashEntry2,
-    bool bState2IsGoal) const
+int ManipLattice::cost(int state_id1, int state_id2, bool bState2IsGoal)
 {
-    auto DefaultCostMultiplier = 1000;
-    return DefaultCostMultiplier;
+    if (m_cost_fun) {
+        return m_cost_fun->getCost(contState(state_id1), contState(state_id2));
+    }
+    return CostFunction::FixedPointRatio;
+}
+
+// Fill the per-expansion action cost table. Costs are evaluated over the
+// action endpoints, which are available from the action list itself, so the
+// table is built in one pass before successor generation and the
+// per-successor cost becomes an array load.
+void ManipLattice::computeActionCosts(
+    const RobotState& parent,
+    const std::vector<Action>& actions)
+{
+    m_action_costs.resize(actions.size());
+    if (m_cost_fun) {
+        for (size_t i = 0; i < actions.size(); ++i) {
+            m_action_costs[i] = m_cost_fun->getCost(parent, actions[i].back());
+        }
+    } else {
+        std::fill(
+                m_action_costs.begin(),
+                m_action_costs.end(),
+                CostFunction::FixedPointRatio);
+    }
 }
 
 bool ManipLattice::checkAction(const RobotState& state, const Action& action)
@@ -674,18 +1314,13 @@ bool WithinPositionTolerance(
 
 static
 bool WithinOrientationTolerance(
-    const Affine3& A,
-    const Affine3& B,
-    const double tol[3])
+    const Quaternion& q,
+    const Quaternion& qg,
+    double dot_thresh)
 {
-    Quaternion qg(B.rotation());
-    Quaternion q(A.rotation());
-    if (q.dot(qg) < 0.0) {
-        qg = Quaternion(-qg.w(), -qg.x(), -qg.y(), -qg.z());
-    }
-
-    auto theta = normalize_angle(2.0 * acos(q.dot(qg)));
-    return theta < tol[0];
+    // equivalent to 2 * acos(|q . qg|) < tol without the trigonometry; the
+    // absolute value folds the double cover of the rotation group
+    return std::fabs(q.dot(qg)) > dot_thresh;
 }
 
 static
@@ -693,11 +1328,15 @@ auto WithinTolerance(
     const Affine3& A,
     const Affine3& B,
     const double xyz_tolerance[3],
-    const double rpy_tolerance[3])
+    const Quaternion& qg,
+    double dot_thresh)
     -> std::pair<bool, bool>
 {
     if (WithinPositionTolerance(A, B, xyz_tolerance)) {
-        if (WithinOrientationTolerance(A, B, rpy_tolerance)) {
+        // fk poses are rigid, so read the quaternion off the linear part
+        // rather than decomposing a rotation out of the transform
+        Quaternion q(A.linear());
+        if (WithinOrientationTolerance(q, qg, dot_thresh)) {
             return std::make_pair(true, true);
         } else {
             return std::make_pair(true, false);
@@ -706,6 +1345,15 @@ auto WithinTolerance(
     return std::make_pair(false, false);
 }
 
+// Pack a (possibly negative) goal bin coordinate into a 64-bit key, 21 bits
+// per axis.
+static uint64_t PackGoalBin(int x, int y, int z)
+{
+    return  (((uint64_t)(uint32_t)x & 0x1FFFFF) << 42) |
+            (((uint64_t)(uint32_t)y & 0x1FFFFF) << 21) |
+            ((uint64_t)(uint32_t)z & 0x1FFFFF);
+}
+
 bool ManipLattice::isGoal(const RobotState& state)
 {
     switch (goal().type) {
@@ -719,24 +1367,73 @@ bool ManipLattice::isGoal(const RobotState& state)
         return true;
     }
     case GoalType::XYZ_RPY_GOAL:
+    case GoalType::MULTIPLE_POSE_GOAL:
+    case GoalType::XYZ_GOAL:
     {
-        // get pose of planning link
-        auto pose = computePlanningFrameFK(state);
+        return isGoal(state, computePlanningFrameFK(state));
+    }
+    case GoalType::USER_GOAL_CONSTRAINT_FN:
+    {
+        return goal().check_goal(goal().check_goal_user, state);
+    }
+    default:
+    {
+        SMPL_ERROR_NAMED(G_LOG, "Unknown goal type.");
+        return false;
+    }
+    }
+
+    return false;
+}
 
+// Variant of isGoal() for callers that have already computed the pose of the
+// planning link for \p state, e.g. with a batched fk query over several
+// states.
+bool ManipLattice::isGoal(const RobotState& state, const Affine3& pose)
+{
+    switch (goal().type) {
+    case GoalType::XYZ_RPY_GOAL:
+    {
         auto near = WithinTolerance(
                 pose,
                 goal().pose,
                 goal().xyz_tolerance,
-                goal().rpy_tolerance);
+                m_goal_quats[0],
+                m_goal_dot_thresh);
         return near.first & near.second;
     }
     case GoalType::MULTIPLE_POSE_GOAL:
     {
-        auto pose = computePlanningFrameFK(state);
-        for (auto& goal_pose : goal().poses) {
+        // probe the bucket of candidates binned near the query position; any
+        // candidate within its per-axis position tolerance of the query is
+        // guaranteed to appear there (see setGoalPoses)
+        if (m_goal_bin_res > 0.0) {
+            int gx = (int)std::floor(pose.translation().x() / m_goal_bin_res);
+            int gy = (int)std::floor(pose.translation().y() / m_goal_bin_res);
+            int gz = (int)std::floor(pose.translation().z() / m_goal_bin_res);
+            auto bit = m_goal_pose_bins.find(PackGoalBin(gx, gy, gz));
+            if (bit == m_goal_pose_bins.end()) {
+                return false;
+            }
+            for (int gidx : bit->second) {
+                auto near = WithinTolerance(
+                        pose, goal().poses[gidx],
+                        goal().xyz_tolerance,
+                        m_goal_quats[gidx],
+                        m_goal_dot_thresh);
+                if (near.first & near.second) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        for (size_t gidx = 0; gidx < goal().poses.size(); ++gidx) {
             auto near = WithinTolerance(
-                    pose, goal_pose,
-                    goal().xyz_tolerance, goal().rpy_tolerance);
+                    pose, goal().poses[gidx],
+                    goal().xyz_tolerance,
+                    m_goal_quats[gidx],
+                    m_goal_dot_thresh);
             if (near.first & near.second) {
                 return true;
             }
@@ -745,21 +1442,13 @@ bool ManipLattice::isGoal(const RobotState& state)
     }
     case GoalType::XYZ_GOAL:
     {
-        auto pose = computePlanningFrameFK(state);
         return WithinPositionTolerance(pose, goal().pose, goal().xyz_tolerance);
     }
-    case GoalType::USER_GOAL_CONSTRAINT_FN:
-    {
-        return goal().check_goal(goal().check_goal_user, state);
-    }
     default:
     {
-        SMPL_ERROR_NAMED(G_LOG, "Unknown goal type.");
-        return false;
+        return isGoal(state);
     }
     }
-
-    return false;
 }
 
 auto ManipLattice::getStateVisualization(
@@ -807,10 +1496,17 @@ bool ManipLattice::setStart(const RobotState& state)
     stateToCoord(state, start_coord);
     SMPL_DEBUG_STREAM_NAMED(G_LOG, "  coord: " << start_coord);
 
-    m_start_state_id = getOrCreateState(start_coord, state);
+    m_start_state_id = getOrCreateState(start_coord);
+
+    // extraction must begin at the robot's actual configuration, not the
+    // center of its coordinate
+    setContState(m_start_state_id, state);
 
     m_actions->updateStart(state);
 
+    // the set of applicable actions may change with the start state
+    invalidateActionCache();
+
     // notify observers of updated start state
     return RobotPlanningSpace::setStart(state);
 }
@@ -839,6 +1535,13 @@ bool ManipLattice::setGoal(const GoalConstraint& goal)
 
     if (success) {
         m_actions->updateGoal(goal);
+
+        // the set of applicable actions may change with the goal
+        invalidateActionCache();
+
+        // transitions to the virtual goal state recorded under the previous
+        // goal are no longer goal transitions
+        m_goal_succ_cache.clear();
     }
 
     return success;
@@ -870,11 +1573,290 @@ void ManipLattice::clearStates()
     }
     m_states.clear();
     m_state_to_id.clear();
+    m_coord_to_id.clear();
+    m_coord_to_id_count = 0;
+    m_coord_filter.clear();
+    m_coord_filter_cap = 0;
     m_states.shrink_to_fit();
+    m_exact_states.clear();
+    m_cont_state_cache.clear();
+    m_action_validity.clear();
+    m_pose_cache.clear();
+    m_goal_succ_cache.clear();
+
+    thawGraph();
 
     m_goal_state_id = reserveHashEntry();
 }
 
+void ManipLattice::invalidateActionCache()
+{
+    m_action_validity.clear();
+
+    // the frozen edges were validated against the old world model
+    thawGraph();
+}
+
+bool ManipLattice::freezeGraph()
+{
+    thawGraph();
+
+    const size_t frozen_count = m_states.size();
+    m_frozen_row.reserve(frozen_count + 1);
+    m_frozen_row.push_back(0);
+
+    RobotCoord succ_coord(robot()->jointVariableCount(), 0);
+    for (size_t sidx = 0; sidx < frozen_count; ++sidx) {
+        ManipLatticeState* entry = m_states[sidx];
+
+        // the virtual goal state is absorbing and reserved entries have no
+        // configuration to expand; give them empty rows
+        if ((int)sidx == m_goal_state_id || entry->coord.empty()) {
+            m_frozen_row.push_back((int)m_frozen_succs.size());
+            continue;
+        }
+
+        auto& state_vars = contState((int)sidx);
+
+        const std::vector<Action>* actions_ptr =
+                m_actions->applyReusable(state_vars);
+        if (!actions_ptr) {
+            m_frozen_row.push_back((int)m_frozen_succs.size());
+            continue;
+        }
+        const std::vector<Action>& actions = *actions_ptr;
+
+        auto& action_validity = m_action_validity[(int)sidx];
+        action_validity.resize(actions.size(), -1);
+
+        computeActionCosts(state_vars, actions);
+
+        for (size_t i = 0; i < actions.size(); ++i) {
+            signed char& valid = action_validity[i];
+            if (valid < 0) {
+                valid = checkAction(state_vars, actions[i]) ? 1 : 0;
+            }
+            if (!valid) {
+                continue;
+            }
+
+            stateToCoord(actions[i].back(), succ_coord);
+
+            // record the concrete successor id; goal substitution happens
+            // per query so the frozen graph outlives goal changes
+            const int succ_state_id = getOrCreateState(succ_coord);
+            m_frozen_succs.push_back(succ_state_id);
+            m_frozen_costs.push_back(m_action_costs[i]);
+        }
+
+        m_frozen_row.push_back((int)m_frozen_succs.size());
+    }
+
+    SMPL_INFO_NAMED(G_LOG, "Froze %zu states with %zu edges (%zu frontier states discovered)",
+            frozen_count,
+            m_frozen_succs.size(),
+            m_states.size() - frozen_count);
+    return true;
+}
+
+void ManipLattice::thawGraph()
+{
+    m_frozen_row.clear();
+    m_frozen_succs.clear();
+    m_frozen_costs.clear();
+}
+
+// Serve the successors of a frozen state from the explicit adjacency table.
+// The edges were validated at freeze time, so no actions are generated and no
+// collision checks run; only the goal test is evaluated per query, against
+// the pose cache for pose goals.
+void ManipLattice::getFrozenSuccs(
+    int state_id,
+    std::vector<int>* succs,
+    std::vector<int>* costs)
+{
+    auto pose_goal =
+            goal().type == GoalType::XYZ_GOAL ||
+            goal().type == GoalType::XYZ_RPY_GOAL ||
+            goal().type == GoalType::MULTIPLE_POSE_GOAL;
+
+    for (int e = m_frozen_row[state_id]; e != m_frozen_row[state_id + 1]; ++e) {
+        const int succ_state_id = m_frozen_succs[e];
+        const int edge_cost = m_frozen_costs[e];
+        auto& succ_state = contState(succ_state_id);
+
+        bool is_goal_succ;
+        Affine3 succ_pose;
+        if (pose_goal && m_fk_iface && projectToPose(succ_state_id, succ_pose)) {
+            is_goal_succ = isGoal(succ_state, succ_pose);
+        } else {
+            is_goal_succ = isGoal(succ_state);
+        }
+
+        if (is_goal_succ) {
+            // remember the concrete state behind the cheapest goal
+            // transition for path extraction
+            auto git = m_goal_succ_cache.find(state_id);
+            if (git == m_goal_succ_cache.end() ||
+                edge_cost < git->second.second)
+            {
+                m_goal_succ_cache[state_id] =
+                        std::make_pair(succ_state_id, edge_cost);
+            }
+            succs->push_back(m_goal_state_id);
+        } else {
+            succs->push_back(succ_state_id);
+        }
+        costs->push_back(edge_cost);
+    }
+}
+
+static const char FrozenGraphMagic[8] =
+        { 's', 'm', 'p', 'l', 'f', 'z', 'g', '1' };
+
+bool ManipLattice::saveFrozenGraph(const std::string& filepath) const
+{
+    if (!frozen()) {
+        SMPL_ERROR_NAMED(G_LOG, "No frozen graph to save");
+        return false;
+    }
+
+    FILE* f = fopen(filepath.c_str(), "wb");
+    if (!f) {
+        SMPL_ERROR_NAMED(G_LOG, "Failed to open '%s' for writing", filepath.c_str());
+        return false;
+    }
+
+    const uint32_t jvars = (uint32_t)robot()->jointVariableCount();
+    const uint32_t scount = (uint32_t)(m_frozen_row.size() - 1);
+    const uint64_t ecount = (uint64_t)m_frozen_succs.size();
+    const int32_t goal_id = (int32_t)m_goal_state_id;
+
+    bool ok = true;
+    ok = ok && fwrite(FrozenGraphMagic, sizeof(FrozenGraphMagic), 1, f) == 1;
+    ok = ok && fwrite(&jvars, sizeof(jvars), 1, f) == 1;
+    ok = ok && fwrite(&scount, sizeof(scount), 1, f) == 1;
+    ok = ok && fwrite(&ecount, sizeof(ecount), 1, f) == 1;
+    ok = ok && fwrite(&goal_id, sizeof(goal_id), 1, f) == 1;
+
+    RobotState vars(jvars, 0.0);
+    for (uint32_t i = 0; ok && i < scount; ++i) {
+        const ManipLatticeState* entry = m_states[i];
+        const uint8_t realized = entry->coord.empty() ? 0 : 1;
+        ok = fwrite(&realized, sizeof(realized), 1, f) == 1;
+        if (!ok || !realized) {
+            continue;
+        }
+
+        // write the exact continuous state where one is recorded, otherwise
+        // the coordinate center contState() would materialize
+        auto eit = m_exact_states.find((int)i);
+        if (eit != m_exact_states.end()) {
+            vars = eit->second;
+        } else {
+            coordToState(entry->coord, vars);
+        }
+
+        ok = ok && fwrite(entry->coord.data(), sizeof(int), jvars, f) == jvars;
+        ok = ok && fwrite(vars.data(), sizeof(double), jvars, f) == jvars;
+    }
+
+    ok = ok && fwrite(m_frozen_row.data(), sizeof(int), m_frozen_row.size(), f) ==
+            m_frozen_row.size();
+    ok = ok && fwrite(m_frozen_succs.data(), sizeof(int), ecount, f) == ecount;
+    ok = ok && fwrite(m_frozen_costs.data(), sizeof(int), ecount, f) == ecount;
+
+    fclose(f);
+    if (!ok) {
+        SMPL_ERROR_NAMED(G_LOG, "Failed to write frozen graph to '%s'", filepath.c_str());
+    }
+    return ok;
+}
+
+bool ManipLattice::loadFrozenGraph(const std::string& filepath)
+{
+    FILE* f = fopen(filepath.c_str(), "rb");
+    if (!f) {
+        SMPL_ERROR_NAMED(G_LOG, "Failed to open '%s' for reading", filepath.c_str());
+        return false;
+    }
+
+    char magic[8];
+    uint32_t jvars = 0;
+    uint32_t scount = 0;
+    uint64_t ecount = 0;
+    int32_t goal_id = -1;
+
+    bool ok = true;
+    ok = ok && fread(magic, sizeof(magic), 1, f) == 1 &&
+            memcmp(magic, FrozenGraphMagic, sizeof(magic)) == 0;
+    ok = ok && fread(&jvars, sizeof(jvars), 1, f) == 1 &&
+            jvars == (uint32_t)robot()->jointVariableCount();
+    ok = ok && fread(&scount, sizeof(scount), 1, f) == 1;
+    ok = ok && fread(&ecount, sizeof(ecount), 1, f) == 1;
+    ok = ok && fread(&goal_id, sizeof(goal_id), 1, f) == 1;
+
+    if (!ok) {
+        SMPL_ERROR_NAMED(G_LOG, "'%s' is not a frozen graph for this lattice", filepath.c_str());
+        fclose(f);
+        return false;
+    }
+
+    clearStates();
+
+    RobotCoord coord(jvars, 0);
+    RobotState state(jvars, 0.0);
+    RobotState center(jvars, 0.0);
+    for (uint32_t i = 0; ok && i < scount; ++i) {
+        uint8_t realized = 0;
+        ok = fread(&realized, sizeof(realized), 1, f) == 1;
+        if (!ok) {
+            break;
+        }
+
+        if (!realized) {
+            // re-reserve virtual entries so ids in the adjacency table stay
+            // aligned; slot 0 is already held by the goal state
+            if (i >= m_states.size()) {
+                reserveHashEntry();
+            }
+            continue;
+        }
+
+        ok = ok && fread(coord.data(), sizeof(int), jvars, f) == jvars;
+        ok = ok && fread(&state[0], sizeof(double), jvars, f) == jvars;
+        ok = ok && createHashEntry(coord) == (int)i;
+
+        // record the continuous state only when it differs from the center
+        // contState() materializes anyway, so re-loading a graph keeps the
+        // coord-only state table
+        coordToState(coord, center);
+        if (ok && state != center) {
+            setContState((int)i, state);
+        }
+    }
+
+    m_frozen_row.resize(scount + 1);
+    m_frozen_succs.resize(ecount);
+    m_frozen_costs.resize(ecount);
+    ok = ok && fread(m_frozen_row.data(), sizeof(int), scount + 1, f) == scount + 1;
+    ok = ok && fread(m_frozen_succs.data(), sizeof(int), ecount, f) == ecount;
+    ok = ok && fread(m_frozen_costs.data(), sizeof(int), ecount, f) == ecount;
+
+    fclose(f);
+
+    if (!ok) {
+        SMPL_ERROR_NAMED(G_LOG, "Failed to load frozen graph from '%s'", filepath.c_str());
+        clearStates();
+        return false;
+    }
+
+    m_goal_state_id = (int)goal_id;
+    SMPL_INFO_NAMED(G_LOG, "Loaded frozen graph: %u states, %zu edges",
+            scount, (size_t)ecount);
+    return true;
+}
+
 bool ManipLattice::extractPath(
     const std::vector<int>& idpath,
     std::vector<RobotState>& path)
@@ -896,14 +1878,14 @@ bool ManipLattice::extractPath(
                 SMPL_ERROR_NAMED(G_LOG, "Failed to get state entry for state %d", getStartStateID());
                 return false;
             }
-            opath.push_back(entry->state);
+            opath.push_back(contState(getStartStateID()));
         } else {
             auto* entry = getHashEntry(state_id);
             if (!entry) {
                 SMPL_ERROR_NAMED(G_LOG, "Failed to get state entry for state %d", state_id);
                 return false;
             }
-            opath.push_back(entry->state);
+            opath.push_back(contState(state_id));
         }
 
         auto* vis_name = "goal_config";
@@ -923,7 +1905,7 @@ bool ManipLattice::extractPath(
             SMPL_ERROR_NAMED(G_LOG, "Failed to get state entry for state %d", idpath[0]);
             return false;
         }
-        opath.push_back(entry->state);
+        opath.push_back(contState(idpath[0]));
     }
 
     // grab the rest of the points
@@ -940,8 +1922,17 @@ bool ManipLattice::extractPath(
         if (curr_id == getGoalStateID()) {
             SMPL_DEBUG_NAMED(G_LOG, "Search for transition to goal state");
 
-            ManipLatticeState* prev_entry = m_states[prev_id];
-            auto& prev_state = prev_entry->state;
+            // common case: the cheapest valid goal transition was recorded
+            // when this state was expanded
+            auto git = m_goal_succ_cache.find(prev_id);
+            if (git != m_goal_succ_cache.end()) {
+                // the goal successor's exact endpoint was pinned when the
+                // transition was discovered
+                opath.push_back(contState(git->second.first));
+                continue;
+            }
+
+            auto& prev_state = contState(prev_id);
 
             std::vector<Action> actions;
             if (!m_actions->apply(prev_state, actions)) {
@@ -950,7 +1941,7 @@ bool ManipLattice::extractPath(
             }
 
             // find the goal state corresponding to the cheapest valid action
-            ManipLatticeState* best_goal_state = nullptr;
+            RobotState best_goal_state;
             RobotCoord succ_coord(robot()->jointVariableCount());
             int best_cost = std::numeric_limits<int>::max();
             for (size_t aidx = 0; aidx < actions.size(); ++aidx) {
@@ -968,22 +1959,21 @@ bool ManipLattice::extractPath(
 
                 stateToCoord(action.back(), succ_coord);
                 int succ_state_id = getHashEntry(succ_coord);
-                ManipLatticeState* succ_entry = getHashEntry(succ_state_id);
-                assert(succ_entry);
+                assert(succ_state_id >= 0);
 
-                auto edge_cost = cost(prev_entry, succ_entry, true);
+                auto edge_cost = cost(prev_id, succ_state_id, true);
                 if (edge_cost < best_cost) {
                     best_cost = edge_cost;
-                    best_goal_state = succ_entry;
+                    best_goal_state = action.back();
                 }
             }
 
-            if (!best_goal_state) {
-                SMPL_ERROR_STREAM_NAMED(G_LOG, "Failed to find valid goal successor from state " << prev_entry->state << " during path extraction");
+            if (best_goal_state.empty()) {
+                SMPL_ERROR_STREAM_NAMED(G_LOG, "Failed to find valid goal successor from state " << prev_state << " during path extraction");
                 return false;
             }
 
-            opath.push_back(best_goal_state->state);
+            opath.push_back(best_goal_state);
         } else {
             auto* entry = getHashEntry(curr_id);
             if (!entry) {
@@ -991,8 +1981,9 @@ bool ManipLattice::extractPath(
                 return false;
             }
 
-            SMPL_DEBUG_STREAM_NAMED(G_LOG, "Extract successor state " << entry->state);
-            opath.push_back(entry->state);
+            auto& curr_state = contState(curr_id);
+            SMPL_DEBUG_STREAM_NAMED(G_LOG, "Extract successor state " << curr_state);
+            opath.push_back(curr_state);
         }
     }
 
@@ -1022,6 +2013,62 @@ Extension* ManipLattice::getExtension(size_t class_code)
     return nullptr;
 }
 
+/// \brief Return the approximate number of bytes held by the graph.
+///
+/// The count is dominated by the state table and the per-episode caches. Hash
+/// table node overheads are estimated at one pointer per node.
+auto ManipLattice::memUsage() const -> size_t
+{
+    size_t bytes = m_states.capacity() * sizeof(ManipLatticeState*);
+    for (const ManipLatticeState* entry : m_states) {
+        if (entry != NULL) {
+            bytes += sizeof(ManipLatticeState) +
+                    entry->coord.capacity() * sizeof(int);
+        }
+    }
+
+    bytes += m_exact_states.bucket_count() * sizeof(void*);
+    for (const auto& e : m_exact_states) {
+        bytes += sizeof(e) + sizeof(void*) +
+                e.second.capacity() * sizeof(double);
+    }
+
+    bytes += m_cont_state_cache.bucket_count() * sizeof(void*);
+    for (const auto& e : m_cont_state_cache) {
+        bytes += sizeof(e) + sizeof(void*) +
+                e.second.capacity() * sizeof(double);
+    }
+
+    if (m_packed_coords) {
+        bytes += m_coord_to_id.capacity() *
+                sizeof(std::pair<uint64_t, int>);
+    } else {
+        bytes += m_state_to_id.bucket_count() * sizeof(void*) +
+                m_state_to_id.size() *
+                (sizeof(std::pair<StateKey*, int>) + sizeof(void*));
+        bytes += m_coord_filter.capacity() * sizeof(uint64_t);
+    }
+
+    bytes += m_action_validity.bucket_count() * sizeof(void*);
+    for (const auto& e : m_action_validity) {
+        bytes += sizeof(e) + sizeof(void*) + e.second.capacity();
+    }
+
+    bytes += m_pose_cache.bucket_count() * sizeof(void*) +
+            m_pose_cache.size() *
+            (sizeof(std::pair<const int, Affine3>) + sizeof(void*));
+
+    bytes += m_goal_succ_cache.bucket_count() * sizeof(void*) +
+            m_goal_succ_cache.size() *
+            (sizeof(std::pair<const int, std::pair<int, int>>) + sizeof(void*));
+
+    bytes += (m_frozen_row.capacity() +
+            m_frozen_succs.capacity() +
+            m_frozen_costs.capacity()) * sizeof(int);
+
+    return bytes;
+}
+
 /// \brief Return the ID of the goal state or -1 if no goal has been set.
 int ManipLattice::getGoalStateID() const
 {
@@ -1042,10 +2089,13 @@ int ManipLattice::getStartStateID() const
 RobotState ManipLattice::getStartConfiguration() const
 {
     if (m_start_state_id >= 0) {
-        return getHashEntry(m_start_state_id)->state;
-    } else {
-        return RobotState();
+        // the exact start configuration is always recorded by setStart()
+        auto it = m_exact_states.find(m_start_state_id);
+        if (it != m_exact_states.end()) {
+            return it->second;
+        }
     }
+    return RobotState();
 }
 
 /// Set a 6-dof goal pose for the planning link
@@ -1066,14 +2116,54 @@ bool ManipLattice::setGoalPose(const GoalConstraint& gc)
     SMPL_DEBUG_NAMED(G_LOG, "    rpy (radians): (%0.2f, %0.2f, %0.2f)", roll, pitch, yaw);
     SMPL_DEBUG_NAMED(G_LOG, "    tol (radians): %0.3f", gc.rpy_tolerance[0]);
 
+    // precompute the orientation fast path: theta < tol, with
+    // theta = 2 * acos(|q . qg|), becomes |q . qg| > cos(tol / 2)
+    m_goal_quats.assign(1, Quaternion(gc.pose.rotation()).normalized());
+    m_goal_dot_thresh = std::cos(0.5 * gc.rpy_tolerance[0]);
 
     // set the (modified) goal
     return RobotPlanningSpace::setGoal(gc);
 }
 
+/// Set a set of candidate 6-dof goal poses for the planning link. The search
+/// terminates at the first (cheapest reachable) candidate satisfied.
 bool ManipLattice::setGoalPoses(const GoalConstraint& gc)
 {
     // TODO: a visualization would be nice
+
+    // index the candidate positions so goal tests are independent of the
+    // number of candidates; bins are sized by the largest per-axis tolerance
+    // and each candidate is spread over its cell and all neighboring cells,
+    // so a query position within its per-axis tolerance of a candidate on
+    // every axis always finds it in its own cell's bucket
+    m_goal_pose_bins.clear();
+    m_goal_bin_res = std::max(
+            gc.xyz_tolerance[0],
+            std::max(gc.xyz_tolerance[1], gc.xyz_tolerance[2]));
+    if (m_goal_bin_res > 0.0) {
+        for (size_t i = 0; i < gc.poses.size(); ++i) {
+            auto& pos = gc.poses[i].translation();
+            int gx = (int)std::floor(pos.x() / m_goal_bin_res);
+            int gy = (int)std::floor(pos.y() / m_goal_bin_res);
+            int gz = (int)std::floor(pos.z() / m_goal_bin_res);
+            for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                m_goal_pose_bins[PackGoalBin(gx + dx, gy + dy, gz + dz)]
+                        .push_back((int)i);
+            }
+            }
+            }
+        }
+    }
+
+    m_goal_quats.clear();
+    m_goal_quats.reserve(gc.poses.size());
+    for (auto& pose : gc.poses) {
+        m_goal_quats.push_back(Quaternion(pose.rotation()).normalized());
+    }
+    m_goal_dot_thresh = std::cos(0.5 * gc.rpy_tolerance[0]);
+
     return RobotPlanningSpace::setGoal(gc);
 }
 
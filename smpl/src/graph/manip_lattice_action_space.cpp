@@ -33,6 +33,9 @@
 #include <smpl/graph/manip_lattice_action_space.h>
 
 // standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <limits>
 #include <numeric>
 
@@ -152,6 +155,10 @@ bool ManipLatticeActionSpace::load(const std::string& action_filename)
     ManipLattice* lattice = static_cast<ManipLattice*>(planningSpace());
 
     for (int i = 0; i < nrows; ++i) {
+        // tag the primitives generated from this row so usage tallies can be
+        // aggregated per file row
+        m_load_row = i;
+
         // read joint delta
         for (int j = 0; j < ncols; ++j) {
             double d;
@@ -174,6 +181,8 @@ bool ManipLatticeActionSpace::load(const std::string& action_filename)
         }
     }
 
+    m_load_row = -1;
+
     fclose(fCfg);
     return true;
 }
@@ -196,8 +205,12 @@ void ManipLatticeActionSpace::addMotionPrim(
         m.type = MotionPrimitive::LONG_DISTANCE;
     }
 
-    m.action.push_back(mprim);
+    m.action.emplace_back(mprim.begin(), mprim.end());
     m_mprims.push_back(m);
+    packMotionPrim(m);
+    m_prim_expansions.push_back(0);
+    m_prim_path_uses.push_back(0);
+    m_prim_source_rows.push_back(m_load_row);
 
     if (add_converse) {
         for (RobotState& state : m.action) {
@@ -206,6 +219,10 @@ void ManipLatticeActionSpace::addMotionPrim(
             }
         }
         m_mprims.push_back(m);
+        packMotionPrim(m);
+        m_prim_expansions.push_back(0);
+        m_prim_path_uses.push_back(0);
+        m_prim_source_rows.push_back(m_load_row);
     }
 }
 
@@ -215,6 +232,9 @@ void ManipLatticeActionSpace::addMotionPrim(
 void ManipLatticeActionSpace::clear()
 {
     m_mprims.clear();
+    m_packed_prims.clear();
+    m_packed_deltas.clear();
+    m_ik_action_cache.clear();
 
     // add all amps to the motion primitive set
     MotionPrimitive mprim;
@@ -222,18 +242,25 @@ void ManipLatticeActionSpace::clear()
     mprim.type = MotionPrimitive::SNAP_TO_RPY;
     mprim.action.clear();
     m_mprims.push_back(mprim);
+    packMotionPrim(mprim);
 
     mprim.type = MotionPrimitive::SNAP_TO_XYZ;
     mprim.action.clear();
     m_mprims.push_back(mprim);
+    packMotionPrim(mprim);
 
     mprim.type = MotionPrimitive::SNAP_TO_XYZ_RPY;
     mprim.action.clear();
     m_mprims.push_back(mprim);
+    packMotionPrim(mprim);
 
     for (int i = 0; i < MotionPrimitive::NUMBER_OF_MPRIM_TYPES; ++i) {
         m_mprim_enabled[i] = (i == MotionPrimitive::Type::LONG_DISTANCE);
     }
+
+    m_prim_expansions.assign(m_mprims.size(), 0);
+    m_prim_path_uses.assign(m_mprims.size(), 0);
+    m_prim_source_rows.assign(m_mprims.size(), -1);
 }
 
 int ManipLatticeActionSpace::longDistCount() const
@@ -273,6 +300,11 @@ bool ManipLatticeActionSpace::useLongAndShortPrims() const
     return m_use_long_and_short_dist_mprims;
 }
 
+bool ManipLatticeActionSpace::useActionTiers() const
+{
+    return m_use_action_tiers;
+}
+
 double ManipLatticeActionSpace::ampThresh(MotionPrimitive::Type type) const
 {
     return m_mprim_thresh[type];
@@ -293,6 +325,11 @@ void ManipLatticeActionSpace::useLongAndShortPrims(bool enable)
     m_use_long_and_short_dist_mprims = enable;
 }
 
+void ManipLatticeActionSpace::useActionTiers(bool enable)
+{
+    m_use_action_tiers = enable;
+}
+
 void ManipLatticeActionSpace::ampThresh(
     MotionPrimitive::Type type,
     double thresh)
@@ -334,8 +371,47 @@ bool ManipLatticeActionSpace::apply(
     double goal_dist, start_dist;
     std::tie(start_dist, goal_dist) = getStartGoalDistances(parent);
 
+    for (size_t i = 0; i < m_mprims.size(); ++i) {
+        size_t before = actions.size();
+        (void)getAction(parent, goal_dist, start_dist, m_mprims[i], actions);
+        m_prim_expansions[i] += actions.size() - before;
+    }
+
+    if (actions.empty()) {
+        SMPL_WARN_ONCE("No motion primitives specified");
+    }
+
+    return true;
+}
+
+bool ManipLatticeActionSpace::applyInverse(
+    const RobotState& child,
+    std::vector<Action>& actions)
+{
+    double goal_dist, start_dist;
+    std::tie(start_dist, goal_dist) = getStartGoalDistances(child);
+
+    // The set of joint-space primitives contains the converse of each
+    // primitive (see addMotionPrim), so applying a primitive at the child
+    // state lands on a predecessor which reaches the child via the converse
+    // primitive. Adaptive ik-based motions are goal-directed and have no
+    // inverse.
     for (auto& prim : m_mprims) {
-        (void)getAction(parent, goal_dist, start_dist, prim, actions);
+        if (prim.type != MotionPrimitive::LONG_DISTANCE &&
+            prim.type != MotionPrimitive::SHORT_DISTANCE)
+        {
+            continue;
+        }
+
+        if (!mprimActive(start_dist, goal_dist, prim.type)) {
+            continue;
+        }
+
+        Action action = recycledAction();
+        if (!applyMotionPrimitive(child, prim, action)) {
+            continue;
+        }
+        actions.push_back(std::move(action));
     }
 
     if (actions.empty()) {
@@ -345,6 +421,12 @@ bool ManipLatticeActionSpace::apply(
     return true;
 }
 
+void ManipLatticeActionSpace::updateGoal(const GoalConstraint& goal)
+{
+    // snaps memoized against the previous goal are stale
+    m_ik_action_cache.clear();
+}
+
 bool ManipLatticeActionSpace::getAction(
     const RobotState& parent,
     double goal_dist,
@@ -363,7 +445,9 @@ bool ManipLatticeActionSpace::getAction(
     case MotionPrimitive::LONG_DISTANCE:  // fall-through
     case MotionPrimitive::SHORT_DISTANCE:
     {
-        Action action;
+        // the primitive is written into the action by assignment, reusing the
+        // waypoint storage of a retired action when one is available
+        Action action = recycledAction();
         if (!applyMotionPrimitive(parent, mp, action)) {
             return false;
         }
@@ -412,11 +496,50 @@ bool ManipLatticeActionSpace::getAction(
     }
 }
 
+/// \brief Append the waypoint deltas of a motion primitive to the flat delta
+///     table, keeping m_packed_prims parallel to m_mprims
+void ManipLatticeActionSpace::packMotionPrim(const MotionPrimitive& mp)
+{
+    PackedPrim pp;
+    pp.offset = m_packed_deltas.size();
+    pp.waypoints = mp.action.size();
+    pp.width = mp.action.empty() ? 0 : mp.action.front().size();
+    for (const RobotState& waypoint : mp.action) {
+        m_packed_deltas.insert(
+                m_packed_deltas.end(), waypoint.begin(), waypoint.end());
+    }
+    m_packed_prims.push_back(pp);
+}
+
 bool ManipLatticeActionSpace::applyMotionPrimitive(
     const RobotState& state,
     const MotionPrimitive& mp,
     Action& action)
 {
+    // primitives owned by the action set have their deltas compiled into the
+    // flat table at load time; applying one is then a single pass over
+    // contiguous deltas, writing into the (possibly recycled) waypoint storage
+    // of the output action without touching mp.action
+    size_t pidx = (size_t)(&mp - m_mprims.data());
+    if (pidx < m_packed_prims.size() && m_packed_prims[pidx].waypoints > 0) {
+        const PackedPrim& pp = m_packed_prims[pidx];
+        if (pp.width != state.size()) {
+            return false;
+        }
+
+        action.resize(pp.waypoints);
+        const double* delta = m_packed_deltas.data() + pp.offset;
+        for (size_t i = 0; i < pp.waypoints; ++i) {
+            action[i].resize(pp.width);
+            for (size_t j = 0; j < pp.width; ++j) {
+                action[i][j] = state[j] + *delta++;
+            }
+        }
+        return true;
+    }
+
+    // foreign primitives fall back to applying the deltas stored in the
+    // primitive itself
     action = mp.action;
     for (size_t i = 0; i < action.size(); ++i) {
         if (action[i].size() != state.size()) {
@@ -441,27 +564,148 @@ bool ManipLatticeActionSpace::computeIkAction(
         return false;
     }
 
-    if (m_use_multiple_ik_solutions) {
-        //get actions for multiple ik solutions
-        std::vector<RobotState> solutions;
-        if (!m_ik_iface->computeIK(goal, state, solutions, option)) {
-            return false;
+    // The dense end-game of a search expands many states near the goal, each
+    // attempting the same snap, and rejected snaps especially are retried on
+    // every nearby expansion. Results are memoized for the duration of the
+    // goal, including failures, so a repeated snap costs one hash lookup
+    // instead of an ik call.
+    RobotState key = state;
+    key.push_back((double)option);
+
+    auto it = m_ik_action_cache.find(key);
+    if (it == m_ik_action_cache.end()) {
+        std::vector<Action> ik_actions;
+        if (m_use_multiple_ik_solutions) {
+            //get actions for multiple ik solutions
+            std::vector<RobotState> solutions;
+            if (m_ik_iface->computeIK(goal, state, solutions, option)) {
+                for (auto& solution : solutions) {
+                    Action action = { std::move(solution) };
+                    ik_actions.push_back(std::move(action));
+                }
+            }
+        } else {
+            //get single action for single ik solution
+            RobotState ik_sol;
+            if (m_ik_iface->computeIK(goal, state, ik_sol)) {
+                Action action = { std::move(ik_sol) };
+                ik_actions.push_back(std::move(action));
+            }
         }
-        for (auto& solution : solutions) {
-            Action action = { std::move(solution) };
-            actions.push_back(std::move(action));
+
+        it = m_ik_action_cache.insert(
+                std::make_pair(std::move(key), std::move(ik_actions))).first;
+    }
+
+    if (it->second.empty()) {
+        return false;
+    }
+
+    for (const Action& action : it->second) {
+        actions.push_back(action);
+    }
+    return true;
+}
+
+/// \brief Return the index of the joint-space primitive whose final delta
+///     carries \p from to \p to, or -1 if no primitive matches
+///
+/// Deltas are compared against half the lattice resolution in each variable so
+/// that an edge matches the primitive it was discretized from; differences for
+/// continuous joints are normalized before comparison.
+int ManipLatticeActionSpace::matchPrimitive(
+    const RobotState& from,
+    const RobotState& to) const
+{
+    const RobotModel* robot = planningSpace()->robot();
+    auto& res = static_cast<const ManipLattice*>(planningSpace())->resolutions();
+
+    for (size_t i = 0; i < m_mprims.size(); ++i) {
+        const MotionPrimitive& mp = m_mprims[i];
+        if (mp.type != MotionPrimitive::LONG_DISTANCE &&
+            mp.type != MotionPrimitive::SHORT_DISTANCE)
+        {
+            continue;
         }
-    } else {
-        //get single action for single ik solution
-        RobotState ik_sol;
-        if (!m_ik_iface->computeIK(goal, state, ik_sol)) {
-            return false;
+        if (mp.action.empty() || mp.action.back().size() != from.size()) {
+            continue;
         }
 
-        Action action = { std::move(ik_sol) };
-        actions.push_back(std::move(action));
+        const RobotState& delta = mp.action.back();
+        bool match = true;
+        for (size_t j = 0; j < from.size(); ++j) {
+            double diff = to[j] - from[j] - delta[j];
+            if (robot->isContinuous(j)) {
+                diff = angles::normalize_angle(diff);
+            }
+            if (std::fabs(diff) > 0.5 * res[j]) {
+                match = false;
+                break;
+            }
+        }
+        if (match) {
+            return (int)i;
+        }
     }
 
+    return -1;
+}
+
+void ManipLatticeActionSpace::recordPathUsage(
+    const std::vector<RobotState>& path)
+{
+    for (size_t i = 1; i < path.size(); ++i) {
+        const int pidx = matchPrimitive(path[i - 1], path[i]);
+        if (pidx >= 0) {
+            ++m_prim_path_uses[pidx];
+        }
+    }
+}
+
+bool ManipLatticeActionSpace::writeUsageLog(const std::string& path)
+{
+    int nrows = 0;
+    for (int row : m_prim_source_rows) {
+        nrows = std::max(nrows, row + 1);
+    }
+    if (nrows == 0) {
+        SMPL_WARN("No motion primitives loaded from file. Skipping usage log");
+        return false;
+    }
+
+    // aggregate per-primitive tallies by source file row; a row and its
+    // converse contribute to the same entry
+    std::vector<std::uint64_t> expansions(nrows, 0);
+    std::vector<std::uint64_t> path_uses(nrows, 0);
+    for (size_t i = 0; i < m_mprims.size(); ++i) {
+        const int row = m_prim_source_rows[i];
+        if (row >= 0) {
+            expansions[row] += m_prim_expansions[i];
+            path_uses[row] += m_prim_path_uses[i];
+        }
+    }
+
+    FILE* f = fopen(path.c_str(), "a");
+    if (!f) {
+        SMPL_ERROR("Failed to open usage log for appending. (file: '%s')", path.c_str());
+        return false;
+    }
+
+    fprintf(f, "episode %d\n", nrows);
+    fprintf(f, "expansions");
+    for (int i = 0; i < nrows; ++i) {
+        fprintf(f, " %llu", (unsigned long long)expansions[i]);
+    }
+    fprintf(f, "\n");
+    fprintf(f, "path_uses");
+    for (int i = 0; i < nrows; ++i) {
+        fprintf(f, " %llu", (unsigned long long)path_uses[i]);
+    }
+    fprintf(f, "\n");
+    fclose(f);
+
+    std::fill(m_prim_expansions.begin(), m_prim_expansions.end(), 0);
+    std::fill(m_prim_path_uses.begin(), m_prim_path_uses.end(), 0);
     return true;
 }
 
@@ -475,6 +719,23 @@ bool ManipLatticeActionSpace::mprimActive(
     // an optimization in regions far from the start or goal, and often we
     // always need "short distance" motion primitives near the start and goal.
     // -Andrew
+    if (m_use_action_tiers) {
+        // tiered evaluation: the long-distance set is the backbone tier and
+        // is always active; the short-distance set switches on near the start
+        // or goal in addition to, rather than in place of, the backbone.
+        // Adaptive motions fall through to their usual goal-distance gate.
+        if (type == MotionPrimitive::LONG_DISTANCE) {
+            return true;
+        } else if (type == MotionPrimitive::SHORT_DISTANCE) {
+            const bool near_goal = goal_dist <= m_mprim_thresh[type];
+            const bool near_start = start_dist <= m_mprim_thresh[type];
+            const bool near_endpoint = near_goal || near_start;
+            return m_mprim_enabled[type] && near_endpoint;
+        } else {
+            return m_mprim_enabled[type] && goal_dist <= m_mprim_thresh[type];
+        }
+    }
+
     if (type == MotionPrimitive::LONG_DISTANCE) {
         if (m_use_long_and_short_dist_mprims) {
             return true;
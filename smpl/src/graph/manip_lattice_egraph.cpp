@@ -29,7 +29,9 @@
 
 #include <smpl/graph/manip_lattice_egraph.h>
 
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 #include <boost/filesystem.hpp>
 
@@ -37,6 +39,7 @@
 #include <smpl/console/nonstd.h>
 #include <smpl/csv_parser.h>
 #include <smpl/debug/visualize.h>
+#include <smpl/graph/experience_graph_io.h>
 #include <smpl/graph/manip_lattice_action_space.h>
 #include <smpl/heap/intrusive_heap.h>
 
@@ -50,6 +53,15 @@ auto ManipLatticeEgraph::RobotCoordHash::operator()(const argument_type& s) cons
     return seed;
 }
 
+auto ManipLatticeEgraph::StateIdPairHash::operator()(const argument_type& s) const ->
+    result_type
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, s.first);
+    boost::hash_combine(seed, s.second);
+    return seed;
+}
+
 bool ManipLatticeEgraph::extractPath(
     const std::vector<int>& idpath,
     std::vector<RobotState>& path)
@@ -70,14 +82,14 @@ bool ManipLatticeEgraph::extractPath(
                 SMPL_ERROR_NAMED(G_LOG, "Failed to get state entry for state %d", getStartStateID());
                 return false;
             }
-            path.push_back(entry->state);
+            path.push_back(contState(getStartStateID()));
         } else {
             auto* entry = getHashEntry(state_id);
             if (!entry) {
                 SMPL_ERROR_NAMED(G_LOG, "Failed to get state entry for state %d", state_id);
                 return false;
             }
-            path.push_back(entry->state);
+            path.push_back(contState(state_id));
         }
 
         auto* vis_name = "goal_config";
@@ -99,7 +111,7 @@ bool ManipLatticeEgraph::extractPath(
             SMPL_ERROR_NAMED(G_LOG, "Failed to get state entry for state %d", idpath[0]);
             return false;
         }
-        opath.push_back(entry->state);
+        opath.push_back(contState(idpath[0]));
     }
 
     // grab the rest of the points
@@ -115,8 +127,7 @@ bool ManipLatticeEgraph::extractPath(
 
         // find the successor state corresponding to the cheapest valid action
 
-        ManipLatticeState* prev_entry = getHashEntry(prev_id);
-        const RobotState& prev_state = prev_entry->state;
+        const RobotState& prev_state = contState(prev_id);
 
         std::vector<Action> actions;
         if (!actionSpace()->apply(prev_state, actions)) {
@@ -125,7 +136,7 @@ bool ManipLatticeEgraph::extractPath(
         }
 
         SMPL_DEBUG_NAMED(G_LOG, "Check for transition via normal successors");
-        ManipLatticeState* best_state = nullptr;
+        RobotState best_state;
         RobotCoord succ_coord(robot()->jointVariableCount());
         int best_cost = std::numeric_limits<int>::max();
         for (const Action& action : actions) {
@@ -144,34 +155,31 @@ bool ManipLatticeEgraph::extractPath(
 
                 stateToCoord(action.back(), succ_coord);
                 int succ_state_id = getHashEntry(succ_coord);
-                ManipLatticeState* succ_entry = getHashEntry(succ_state_id);
-                assert(succ_entry);
+                assert(succ_state_id >= 0);
 
-                const int edge_cost = cost(prev_entry, succ_entry, true);
+                const int edge_cost = cost(prev_id, succ_state_id, true);
                 if (edge_cost < best_cost) {
                     best_cost = edge_cost;
-                    best_state = succ_entry;
+                    best_state = action.back();
                 }
             } else {
                 stateToCoord(action.back(), succ_coord);
                 int succ_state_id = getHashEntry(succ_coord);
-                ManipLatticeState* succ_entry = getHashEntry(succ_state_id);
-                assert(succ_entry);
                 if (succ_state_id != curr_id) {
                     continue;
                 }
 
-                const int edge_cost = cost(prev_entry, succ_entry, false);
+                const int edge_cost = cost(prev_id, succ_state_id, false);
                 if (edge_cost < best_cost) {
                     best_cost = edge_cost;
-                    best_state = succ_entry;
+                    best_state = action.back();
                 }
             }
         }
 
-        if (best_state) {
-            SMPL_DEBUG_STREAM_NAMED(G_LOG, "Extract successor state " << best_state->state);
-            opath.push_back(best_state->state);
+        if (!best_state.empty()) {
+            SMPL_DEBUG_STREAM_NAMED(G_LOG, "Extract successor state " << best_state);
+            opath.push_back(best_state);
             continue;
         }
 
@@ -194,9 +202,8 @@ bool ManipLatticeEgraph::extractPath(
             if (found) {
                 for (ExperienceGraph::node_id n : node_path) {
                     int state_id = m_egraph_state_ids[n];
-                    ManipLatticeState* entry = getHashEntry(state_id);
-                    assert(entry);
-                    opath.push_back(entry->state);
+                    assert(getHashEntry(state_id));
+                    opath.push_back(contState(state_id));
                 }
             }
         }
@@ -209,9 +216,8 @@ bool ManipLatticeEgraph::extractPath(
         int cost;
         if (snap(prev_id, curr_id, cost)) {
             SMPL_ERROR("Snap from %d to %d with cost %d", prev_id, curr_id, cost);
-            ManipLatticeState* entry = getHashEntry(curr_id);
-            assert(entry);
-            opath.push_back(entry->state);
+            assert(getHashEntry(curr_id));
+            opath.push_back(contState(curr_id));
             continue;
         }
 
@@ -226,11 +232,46 @@ bool ManipLatticeEgraph::extractPath(
     return true;
 }
 
+bool ManipLatticeEgraph::saveExperienceGraph(const std::string& path) const
+{
+    return WriteExperienceGraph(m_egraph, path);
+}
+
 bool ManipLatticeEgraph::loadExperienceGraph(const std::string& path)
 {
     SMPL_INFO("Load Experience Graph at %s", path.c_str());
 
     boost::filesystem::path p(path);
+
+    // load a single demonstration library in the binary format
+    if (boost::filesystem::is_regular_file(p) && p.extension() == ".egraph") {
+        auto prev_num_nodes = m_egraph.num_nodes();
+        if (!ReadExperienceGraph(path, m_egraph)) {
+            return false;
+        }
+
+        SMPL_INFO("Create hash entries for experience graph states");
+        RobotCoord dp(robot()->jointVariableCount());
+        for (auto nid = prev_num_nodes; nid < m_egraph.num_nodes(); ++nid) {
+            auto& state = m_egraph.state(nid);
+            stateToCoord(state, dp);
+            m_coord_to_nodes[dp].push_back(nid);
+
+            int entry_id = reserveHashEntry();
+            auto* entry = getHashEntry(entry_id);
+            entry->coord = dp;
+            setContState(entry_id, state);
+
+            // map state id <-> experience graph state
+            m_egraph_state_ids.resize(nid + 1, -1);
+            m_egraph_state_ids[nid] = entry_id;
+            m_state_to_node[entry_id] = nid;
+        }
+
+        SMPL_INFO("Experience graph contains %zu nodes and %zu edges", m_egraph.num_nodes(), m_egraph.num_edges());
+        return true;
+    }
+
     if (!boost::filesystem::is_directory(p)) {
         SMPL_ERROR("'%s' is not a directory", path.c_str());
         return false;
@@ -251,58 +292,133 @@ bool ManipLatticeEgraph::loadExperienceGraph(const std::string& path)
 
         SMPL_INFO("Create hash entries for experience graph states");
 
-        auto& pp = egraph_states.front();  // previous robot state
-        RobotCoord pdp(robot()->jointVariableCount()); // previous robot coord
-        stateToCoord(egraph_states.front(), pdp);
-
-        auto pid = m_egraph.insert_node(pp);
-        m_coord_to_nodes[pdp].push_back(pid);
-
-        int entry_id = reserveHashEntry();
-        auto* entry = getHashEntry(entry_id);
-        entry->coord = pdp;
-        entry->state = pp;
-
-        // map state id <-> experience graph state
-        m_egraph_state_ids.resize(pid + 1, -1);
-        m_egraph_state_ids[pid] = entry_id;
-        m_state_to_node[entry_id] = pid;
-
-        std::vector<RobotState> edge_data;
-        for (size_t i = 1; i < egraph_states.size(); ++i) {
-            auto& p = egraph_states[i];
-            RobotCoord dp(robot()->jointVariableCount());
-            stateToCoord(p, dp);
-            if (dp != pdp) {
-                // found a new discrete state along the path
-
-                auto id = m_egraph.insert_node(p);
-                m_coord_to_nodes[dp].push_back(id);
-
-                int entry_id = reserveHashEntry();
-                auto* entry = getHashEntry(entry_id);
-                entry->coord = dp;
-                entry->state = p;
-
-                m_egraph_state_ids.resize(id + 1, -1);
-                m_egraph_state_ids[id] = entry_id;
-                m_state_to_node[entry_id] = id;
-                m_egraph.insert_edge(pid, id, edge_data);
-
-                pdp = dp;
-                pid = id;
-                edge_data.clear();
-            } else {
-                // gather intermediate robot states
-                edge_data.push_back(p);
-            }
-        }
+        appendExperiencePath(egraph_states);
     }
 
+    // lay out adjacency in compressed-sparse-row form for the sweeps of
+    // heuristic preprocessing and shortcut searches
+    m_egraph.rebuild_adjacency();
+
     SMPL_INFO("Experience graph contains %zu nodes and %zu edges", m_egraph.num_nodes(), m_egraph.num_edges());
     return true;
 }
 
+// Splice a continuous path into the experience graph: a node for each new
+// discrete state along the path, an edge between consecutive nodes carrying
+// the intermediate waypoints, and a graph state in the lattice for each new
+// node. Does not rebuild the adjacency layout; the caller does that once
+// after a batch of paths.
+void ManipLatticeEgraph::appendExperiencePath(
+    const std::vector<RobotState>& egraph_states)
+{
+    if (egraph_states.empty()) {
+        return;
+    }
+
+    auto& pp = egraph_states.front();  // previous robot state
+    RobotCoord pdp(robot()->jointVariableCount()); // previous robot coord
+    stateToCoord(egraph_states.front(), pdp);
+
+    auto pid = m_egraph.insert_node(pp);
+    m_coord_to_nodes[pdp].push_back(pid);
+
+    int entry_id = reserveHashEntry();
+    auto* entry = getHashEntry(entry_id);
+    entry->coord = pdp;
+    setContState(entry_id, pp);
+
+    // map state id <-> experience graph state
+    m_egraph_state_ids.resize(pid + 1, -1);
+    m_egraph_state_ids[pid] = entry_id;
+    m_state_to_node[entry_id] = pid;
+
+    std::vector<RobotState> edge_data;
+    for (size_t i = 1; i < egraph_states.size(); ++i) {
+        auto& p = egraph_states[i];
+        RobotCoord dp(robot()->jointVariableCount());
+        stateToCoord(p, dp);
+        if (dp != pdp) {
+            // found a new discrete state along the path
+
+            auto id = m_egraph.insert_node(p);
+            m_coord_to_nodes[dp].push_back(id);
+
+            int entry_id = reserveHashEntry();
+            auto* entry = getHashEntry(entry_id);
+            entry->coord = dp;
+            setContState(entry_id, p);
+
+            m_egraph_state_ids.resize(id + 1, -1);
+            m_egraph_state_ids[id] = entry_id;
+            m_state_to_node[entry_id] = id;
+            m_egraph.insert_edge(pid, id, edge_data);
+
+            pdp = dp;
+            pid = id;
+            edge_data.clear();
+        } else {
+            // gather intermediate robot states
+            edge_data.push_back(p);
+        }
+    }
+}
+
+void ManipLatticeEgraph::submitExperiencePath(std::vector<RobotState> path)
+{
+    std::lock_guard<std::mutex> lock(m_pending_mutex);
+    m_pending_paths.push_back(std::move(path));
+}
+
+void ManipLatticeEgraph::syncExperienceGraph()
+{
+    std::vector<std::vector<RobotState>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        pending.swap(m_pending_paths);
+    }
+
+    if (pending.empty()) {
+        return;
+    }
+
+    if (m_dedup_enabled) {
+        if (m_dedup_index.graph() != &m_egraph) {
+            m_dedup_index.attach(&m_egraph);
+        }
+        FilterExperiencePaths(
+                &pending, m_egraph, &m_dedup_index, m_dedup_params);
+        if (pending.empty()) {
+            return;
+        }
+    }
+
+    for (auto& path : pending) {
+        appendExperiencePath(path);
+    }
+    m_egraph.rebuild_adjacency();
+
+    SMPL_INFO("Spliced %zu executed paths into the experience graph (%zu nodes, %zu edges)", pending.size(), m_egraph.num_nodes(), m_egraph.num_edges());
+}
+
+void ManipLatticeEgraph::setExperienceDedup(const PathDedupParams& params)
+{
+    m_dedup_params = params;
+    m_dedup_enabled = true;
+}
+
+void ManipLatticeEgraph::disableExperienceDedup()
+{
+    m_dedup_enabled = false;
+}
+
+bool ManipLatticeEgraph::setGoal(const GoalConstraint& goal)
+{
+    // fold staged experience in before the heuristics are notified of the
+    // goal, so their preprocessing sees the up-to-date graph
+    syncExperienceGraph();
+    return ManipLattice::setGoal(goal);
+}
+
 void ManipLatticeEgraph::getExperienceGraphNodes(
     int state_id,
     std::vector<ExperienceGraph::node_id>& nodes)
@@ -325,10 +441,12 @@ bool ManipLatticeEgraph::shortcut(
         return false;
     }
 
-    SMPL_INFO_STREAM("Shortcut " << first_entry->state << " -> " << second_entry->state);
+    auto& first_state = contState(first_id);
+    auto& second_state = contState(second_id);
+    SMPL_INFO_STREAM("Shortcut " << first_state << " -> " << second_state);
     auto* vis_name = "shortcut";
-    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(first_entry->state, "shortcut_from"));
-    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(second_entry->state, "shortcut_to"));
+    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(first_state, "shortcut_from"));
+    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(second_state, "shortcut_to"));
 
     SMPL_INFO("  Shortcut %d -> %d!", first_id, second_id);
     cost = 1000;
@@ -340,6 +458,18 @@ bool ManipLatticeEgraph::snap(
     int second_id,
     int& cost)
 {
+    auto key = std::make_pair(first_id, second_id);
+    auto cit = m_snap_cache.find(key);
+    if (cit != m_snap_cache.end() &&
+        cit->second.version == m_snap_cache_version)
+    {
+        if (!cit->second.valid) {
+            return false;
+        }
+        cost = cit->second.cost;
+        return true;
+    }
+
     auto* first_entry = getHashEntry(first_id);
     auto* second_entry = getHashEntry(second_id);
     if (!first_entry | !second_entry) {
@@ -347,23 +477,63 @@ bool ManipLatticeEgraph::snap(
         return false;
     }
 
-    SMPL_INFO_STREAM("Snap " << first_entry->state << " -> " << second_entry->state);
+    auto& first_state = contState(first_id);
+    auto& second_state = contState(second_id);
+    SMPL_INFO_STREAM("Snap " << first_state << " -> " << second_state);
     auto* vis_name = "snap";
-    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(first_entry->state, "snap_from"));
-    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(second_entry->state, "snap_to"));
+    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(first_state, "snap_from"));
+    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(second_state, "snap_to"));
+
+    SnapCacheEntry& entry = m_snap_cache[key];
+    entry.version = m_snap_cache_version;
 
     if (!collisionChecker()->isStateToStateValid(
-            first_entry->state, second_entry->state))
+            first_state, second_state))
     {
         SMPL_WARN("Failed snap!");
+        entry.valid = false;
         return false;
     }
 
     SMPL_INFO("  Snap %d -> %d!", first_id, second_id);
     cost = 1000;
+    entry.valid = true;
+    entry.cost = cost;
     return true;
 }
 
+void ManipLatticeEgraph::invalidateSnapCache()
+{
+    ++m_snap_cache_version;
+}
+
+auto ManipLatticeEgraph::memUsage() const -> size_t
+{
+    size_t bytes = ManipLattice::memUsage();
+
+    bytes += m_egraph.mem_usage();
+    bytes += m_egraph_state_ids.capacity() * sizeof(int);
+
+    bytes += m_coord_to_nodes.bucket_count() * sizeof(void*);
+    for (const auto& e : m_coord_to_nodes) {
+        bytes += sizeof(e) + sizeof(void*) +
+                e.first.capacity() * sizeof(int) +
+                e.second.capacity() * sizeof(ExperienceGraph::node_id);
+    }
+
+    bytes += m_state_to_node.bucket_count() * sizeof(void*) +
+            m_state_to_node.size() *
+            (sizeof(std::pair<const int, ExperienceGraph::node_id>) +
+                    sizeof(void*));
+
+    bytes += m_snap_cache.bucket_count() * sizeof(void*) +
+            m_snap_cache.size() *
+            (sizeof(std::pair<const std::pair<int, int>, SnapCacheEntry>) +
+                    sizeof(void*));
+
+    return bytes;
+}
+
 const ExperienceGraph* ManipLatticeEgraph::getExperienceGraph() const
 {
     return &m_egraph;
@@ -484,6 +654,32 @@ bool ManipLatticeEgraph::parseExperienceGraphFile(
         return false;
     }
 
+    // fast path: parse well-formed numeric files in parallel chunks, without
+    // materializing a string per field
+    {
+        const size_t jvar_count = robot()->getPlanningJoints().size();
+        std::vector<double> values;
+        size_t field_count;
+        const int num_threads =
+                std::max(1, (int)std::thread::hardware_concurrency());
+        if (ParseNumericCSV(filepath, values, field_count, num_threads) &&
+            field_count == jvar_count)
+        {
+            const size_t record_count = values.size() / field_count;
+            SMPL_INFO("Parsed experience graph file");
+            SMPL_INFO("  %zu records", record_count);
+            SMPL_INFO("  %zu fields", field_count);
+            egraph_states.reserve(record_count);
+            for (size_t i = 0; i < record_count; ++i) {
+                egraph_states.push_back(RobotState(
+                        values.begin() + i * field_count,
+                        values.begin() + (i + 1) * field_count));
+            }
+            SMPL_INFO("Read %zu states from experience graph file", egraph_states.size());
+            return true;
+        }
+    }
+
     CSVParser parser;
     const bool with_header = true;
     if (!parser.parseStream(fin, with_header)) {
@@ -0,0 +1,219 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/graph/mprim_profile.h>
+
+// standard includes
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+bool LoadMotionPrimitiveUsageLog(
+    const std::string& path,
+    MotionPrimitiveUsage& usage)
+{
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        SMPL_ERROR("Failed to open usage log. (file: '%s')", path.c_str());
+        return false;
+    }
+
+    usage.episodes = 0;
+    usage.expansions.clear();
+    usage.path_uses.clear();
+
+    char sTemp[1024] = { 0 };
+    while (fscanf(f, "%1023s", sTemp) == 1) {
+        if (strcmp(sTemp, "episode") != 0) {
+            SMPL_ERROR("Expected 'episode' record in usage log. (parsed string: %s)", sTemp);
+            fclose(f);
+            return false;
+        }
+
+        int nrows;
+        if (fscanf(f, "%d", &nrows) < 1 || nrows <= 0) {
+            SMPL_ERROR("Failed to parse row count from usage log");
+            fclose(f);
+            return false;
+        }
+
+        if (usage.episodes == 0) {
+            usage.expansions.assign(nrows, 0);
+            usage.path_uses.assign(nrows, 0);
+        } else if ((size_t)nrows != usage.expansions.size()) {
+            SMPL_ERROR("Usage log records disagree on row count (%d vs %zu)", nrows, usage.expansions.size());
+            fclose(f);
+            return false;
+        }
+
+        for (auto* tallies : { &usage.expansions, &usage.path_uses }) {
+            const char* label =
+                    tallies == &usage.expansions ? "expansions" : "path_uses";
+            if (fscanf(f, "%1023s", sTemp) < 1 || strcmp(sTemp, label) != 0) {
+                SMPL_ERROR("Expected '%s' record in usage log", label);
+                fclose(f);
+                return false;
+            }
+            for (int i = 0; i < nrows; ++i) {
+                unsigned long long count;
+                if (fscanf(f, "%llu", &count) < 1) {
+                    SMPL_ERROR("Failed to parse '%s' tally from usage log", label);
+                    fclose(f);
+                    return false;
+                }
+                (*tallies)[i] += count;
+            }
+        }
+
+        ++usage.episodes;
+    }
+
+    fclose(f);
+    return usage.episodes > 0;
+}
+
+bool CompileMotionPrimitiveSet(
+    const std::string& mprim_in_path,
+    const MotionPrimitiveUsage& usage,
+    const MotionPrimitiveCompileOptions& options,
+    const std::string& mprim_out_path)
+{
+    FILE* fCfg = fopen(mprim_in_path.c_str(), "r");
+    if (!fCfg) {
+        SMPL_ERROR("Failed to open action set file. (file: '%s')", mprim_in_path.c_str());
+        return false;
+    }
+
+    char sTemp[1024] = { 0 };
+    int nrows = 0;
+    int ncols = 0;
+    int short_mprims = 0;
+
+    if (fscanf(fCfg, "%1023s", sTemp) < 1 ||
+        strcmp(sTemp, "Motion_Primitives(degrees):") != 0)
+    {
+        SMPL_ERROR("First line of motion primitive file should be 'Motion_Primitives(degrees):'. (parsed string: %s)", sTemp);
+        fclose(fCfg);
+        return false;
+    }
+
+    if (fscanf(fCfg, "%d %d %d", &nrows, &ncols, &short_mprims) < 3) {
+        SMPL_ERROR("Failed to parse action set file header");
+        fclose(fCfg);
+        return false;
+    }
+
+    if ((size_t)nrows != usage.path_uses.size()) {
+        SMPL_ERROR("Usage record covers %zu rows but action set has %d", usage.path_uses.size(), nrows);
+        fclose(fCfg);
+        return false;
+    }
+
+    // read the deltas as raw tokens so the authored formatting survives
+    // compilation
+    std::vector<std::vector<std::string>> rows(nrows);
+    for (int i = 0; i < nrows; ++i) {
+        rows[i].resize(ncols);
+        for (int j = 0; j < ncols; ++j) {
+            if (fscanf(fCfg, "%1023s", sTemp) < 1) {
+                SMPL_ERROR("End of action set file reached prematurely");
+                fclose(fCfg);
+                return false;
+            }
+            rows[i][j] = sTemp;
+        }
+    }
+
+    fclose(fCfg);
+
+    // partition into the long- and short-distance groups (short rows trail in
+    // the file), prune rows below the usage threshold, and order each group
+    // by descending on-path usage
+    const int nlong = nrows - short_mprims;
+    std::vector<int> long_rows;
+    std::vector<int> short_rows;
+    for (int i = 0; i < nrows; ++i) {
+        if (usage.path_uses[i] < options.min_path_uses) {
+            continue;
+        }
+        if (i < nlong) {
+            long_rows.push_back(i);
+        } else {
+            short_rows.push_back(i);
+        }
+    }
+
+    if (long_rows.empty()) {
+        SMPL_ERROR("No long distance motion primitives survive pruning. Refusing to compile an empty action set");
+        return false;
+    }
+
+    auto by_usage = [&](int u, int v) {
+        if (usage.path_uses[u] != usage.path_uses[v]) {
+            return usage.path_uses[u] > usage.path_uses[v];
+        }
+        if (usage.expansions[u] != usage.expansions[v]) {
+            return usage.expansions[u] > usage.expansions[v];
+        }
+        return u < v;
+    };
+    std::sort(long_rows.begin(), long_rows.end(), by_usage);
+    std::sort(short_rows.begin(), short_rows.end(), by_usage);
+
+    FILE* fOut = fopen(mprim_out_path.c_str(), "w");
+    if (!fOut) {
+        SMPL_ERROR("Failed to open output action set file. (file: '%s')", mprim_out_path.c_str());
+        return false;
+    }
+
+    const int kept = (int)(long_rows.size() + short_rows.size());
+    fprintf(fOut, "Motion_Primitives(degrees): %d %d %d\n",
+            kept, ncols, (int)short_rows.size());
+    for (auto* group : { &long_rows, &short_rows }) {
+        for (int row : *group) {
+            for (int j = 0; j < ncols; ++j) {
+                fprintf(fOut, "%s%s", j == 0 ? "" : " ", rows[row][j].c_str());
+            }
+            fprintf(fOut, "\n");
+        }
+    }
+    fclose(fOut);
+
+    return true;
+}
+
+} // namespace smpl
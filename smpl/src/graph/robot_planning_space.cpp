@@ -31,12 +31,75 @@
 
 #include <smpl/graph/robot_planning_space.h>
 
+// standard includes
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 // project includes
 #include <smpl/console/console.h>
 #include <smpl/heuristic/robot_heuristic.h>
 
 namespace smpl {
 
+SuccessorStream::~SuccessorStream()
+{
+}
+
+namespace {
+
+// Fallback successor stream which materializes all successor edges up front
+// through GetSuccs and replays them in ascending cost order.
+class BufferedSuccessorStream : public SuccessorStream
+{
+public:
+
+    BufferedSuccessorStream(RobotPlanningSpace* space, int state_id)
+    {
+        space->GetSuccs(state_id, &m_succs, &m_costs);
+        m_order.resize(m_succs.size());
+        std::iota(m_order.begin(), m_order.end(), 0);
+        std::sort(
+                m_order.begin(), m_order.end(),
+                [&](size_t i, size_t j) { return m_costs[i] < m_costs[j]; });
+    }
+
+    int minRemainingCost() const override
+    {
+        if (m_pos == m_order.size()) {
+            return std::numeric_limits<int>::max();
+        }
+        return m_costs[m_order[m_pos]];
+    }
+
+    bool next(int* succ_id, int* cost) override
+    {
+        if (m_pos == m_order.size()) {
+            return false;
+        }
+        *succ_id = m_succs[m_order[m_pos]];
+        *cost = m_costs[m_order[m_pos]];
+        ++m_pos;
+        return true;
+    }
+
+private:
+
+    std::vector<int> m_succs;
+    std::vector<int> m_costs;
+    std::vector<size_t> m_order;
+    size_t m_pos = 0;
+};
+
+} // namespace
+
+auto RobotPlanningSpace::succStream(int state_id)
+    -> std::unique_ptr<SuccessorStream>
+{
+    return std::unique_ptr<SuccessorStream>(
+            new BufferedSuccessorStream(this, state_id));
+}
+
 RobotPlanningSpace::~RobotPlanningSpace()
 {
 }
@@ -89,6 +152,7 @@ bool RobotPlanningSpace::setStart(const RobotState& start)
 bool RobotPlanningSpace::setGoal(const GoalConstraint& goal)
 {
     m_goal = goal;
+    ++m_goal_epoch;
     return true;
 }
 
@@ -22,7 +22,7 @@ bool InitSimpleWorkspaceLatticeActions(
 
     auto add_xyz_prim = [&](int dx, int dy, int dz)
     {
-        std::vector<double> d(space->dofCount(), 0.0);
+        RobotState d(space->dofCount(), 0.0);
         d[FK_PX] = space->resolution()[FK_PX] * dx;
         d[FK_PY] = space->resolution()[FK_PY] * dy;
         d[FK_PZ] = space->resolution()[FK_PZ] * dz;
@@ -56,7 +56,7 @@ bool InitSimpleWorkspaceLatticeActions(
 
     // create 2-connected motions for rotation and free angle motions
     for (int a = 3; a < space->dofCount(); ++a) {
-        std::vector<double> d(space->dofCount(), 0.0);
+        RobotState d(space->dofCount(), 0.0);
 
         d[a] = space->resolution()[a] * -1;
         prim.type = MotionPrimitive::Type::LONG_DISTANCE;
@@ -73,6 +73,25 @@ bool InitSimpleWorkspaceLatticeActions(
         actions->m_prims.push_back(prim);
     }
 
+    // compile the primitives into the flat delta table
+    actions->m_packed_prims.clear();
+    actions->m_packed_deltas.clear();
+    for (auto& p : actions->m_prims) {
+        SimpleWorkspaceLatticeActionSpace::PackedPrim pp;
+        pp.offset = (int)actions->m_packed_deltas.size();
+        pp.waypoints = (int)p.action.size();
+        pp.rotates = false;
+        for (auto& delta : p.action) {
+            for (size_t d = 0; d < delta.size(); ++d) {
+                if (d >= 3 && d < 6 && delta[d] != 0.0) {
+                    pp.rotates = true;
+                }
+                actions->m_packed_deltas.push_back(delta[d]);
+            }
+        }
+        actions->m_packed_prims.push_back(pp);
+    }
+
     return true;
 }
 
@@ -87,18 +106,26 @@ void SimpleWorkspaceLatticeActionSpace::apply(
 
     SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "  create actions for workspace state: " << cont_state);
 
-    for (auto& prim : m_prims) {
+    // sweep the flat delta table compiled at init; orientation angles are
+    // only renormalized for primitives that move them, since the source
+    // state's angles arrive normalized from the discretization
+    const size_t dofs = space->dofCount();
+    const double* deltas = m_packed_deltas.data();
+    for (auto& pp : m_packed_prims) {
         WorkspaceAction action;
-        action.reserve(prim.action.size());
+        action.reserve(pp.waypoints);
 
         auto final_state = cont_state;
-        for (auto& delta_state : prim.action) {
+        const double* delta = deltas + pp.offset;
+        for (int w = 0; w < pp.waypoints; ++w) {
             // increment the state
-            for (size_t d = 0; d < space->dofCount(); ++d) {
-                final_state[d] += delta_state[d];
+            for (size_t d = 0; d < dofs; ++d) {
+                final_state[d] += *delta++;
             }
 
-            angles::normalize_euler_zyx(&final_state[3]);
+            if (pp.rotates) {
+                angles::normalize_euler_zyx(&final_state[3]);
+            }
 
             action.push_back(final_state);
         }
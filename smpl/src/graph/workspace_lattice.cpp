@@ -42,6 +42,7 @@
 #include <smpl/debug/visualize.h>
 #include <smpl/debug/marker_utils.h>
 #include <smpl/heuristic/robot_heuristic.h>
+#include <smpl/spatial_batch.h>
 #include <smpl/graph/workspace_lattice_action_space.h>
 
 auto std::hash<smpl::WorkspaceLatticeState>::operator()(
@@ -124,13 +125,7 @@ bool WorkspaceLattice::projectToPose(int state_id, Affine3& pose)
 
     WorkspaceLatticeState* state = getState(state_id);
 
-    double p[6];
-    poseCoordToWorkspace(&state->coord[0], &p[0]);
-
-    pose = Translation3(p[FK_PX], p[FK_PY], p[FK_PZ]) *
-            AngleAxis(p[FK_QZ], Vector3::UnitZ()) *
-            AngleAxis(p[FK_QY], Vector3::UnitY()) *
-            AngleAxis(p[FK_QX], Vector3::UnitX());
+    poseCoordToPose(&state->coord[0], pose);
     return true;
 }
 
@@ -571,10 +566,34 @@ bool WorkspaceLattice::setGoalPose(const GoalConstraint& goal)
     SMPL_DEBUG_NAMED(G_LOG, "set the goal state");
 
     // check if an IK solution exists for the goal pose before we do
-    // the search we plan even if there is no solution
-    RobotState seed(robot()->jointVariableCount(), 0);
-    RobotState ik_solution;
-    if (!m_ik_iface->computeIK(goal.pose, seed, ik_solution)) {
+    // the search we plan even if there is no solution; probe several seeds
+    // spread across the joint ranges and accept the first solution found
+    auto seed_count = 4;
+    std::vector<RobotState> seeds(
+            seed_count, RobotState(robot()->jointVariableCount(), 0));
+    for (auto s = 1; s < seed_count; ++s) {
+        auto t = (double)s / (double)seed_count;
+        for (size_t v = 0; v < robot()->jointVariableCount(); ++v) {
+            if (robot()->hasPosLimit(v)) {
+                seeds[s][v] = robot()->minPosLimit(v) +
+                        t * (robot()->maxPosLimit(v) - robot()->minPosLimit(v));
+            } else {
+                seeds[s][v] = -M_PI + t * 2.0 * M_PI;
+            }
+        }
+    }
+    std::vector<Affine3, Eigen::aligned_allocator<Affine3>> goal_poses(
+            seed_count, goal.pose);
+    std::vector<RobotState> ik_solutions;
+    std::vector<bool> ik_valid;
+    if (m_ik_iface->computeIKBatch(
+            goal_poses.data(),
+            seeds.data(),
+            seed_count,
+            ik_solutions,
+            ik_valid,
+            true) < 0)
+    {
         SMPL_WARN("No valid IK solution for the goal pose.");
     }
 
@@ -738,6 +757,23 @@ bool WorkspaceLattice::checkAction(
     std::vector<RobotState> wptraj;
     wptraj.reserve(action.size());
 
+    // convert the waypoint orientations to quaternions in one batch
+    const int nwp = (int)action.size();
+    m_wp_rot_scratch.resize(7 * nwp);
+    double* yaws = m_wp_rot_scratch.data();
+    double* pitches = yaws + nwp;
+    double* rolls = pitches + nwp;
+    double* qw = rolls + nwp;
+    double* qx = qw + nwp;
+    double* qy = qx + nwp;
+    double* qz = qy + nwp;
+    for (int w = 0; w < nwp; ++w) {
+        yaws[w] = action[w][5];
+        pitches[w] = action[w][4];
+        rolls[w] = action[w][3];
+    }
+    RotationsFromEulerZYX(yaws, pitches, rolls, qw, qx, qy, qz, nwp);
+
     // check waypoints for ik solutions and joint limits
     for (size_t widx = 0; widx < action.size(); ++widx) {
         auto& waypoint = action[widx];
@@ -751,7 +787,8 @@ bool WorkspaceLattice::checkAction(
         }
 
         RobotState irstate;
-        if (!stateWorkspaceToRobot(waypoint, seed, irstate)) {
+        auto rot = Quaternion(qw[widx], qx[widx], qy[widx], qz[widx]);
+        if (!stateWorkspaceToRobot(waypoint, rot, seed, irstate)) {
             SMPL_DEBUG_NAMED(G_SUCCESSORS_LOG, "         -> failed to find ik solution");
             return false;
         }
@@ -803,6 +840,23 @@ bool WorkspaceLattice::checkLazyAction(
     std::vector<RobotState> wptraj;
     wptraj.reserve(action.size());
 
+    // convert the waypoint orientations to quaternions in one batch
+    const int nwp = (int)action.size();
+    m_wp_rot_scratch.resize(7 * nwp);
+    double* yaws = m_wp_rot_scratch.data();
+    double* pitches = yaws + nwp;
+    double* rolls = pitches + nwp;
+    double* qw = rolls + nwp;
+    double* qx = qw + nwp;
+    double* qy = qx + nwp;
+    double* qz = qy + nwp;
+    for (int w = 0; w < nwp; ++w) {
+        yaws[w] = action[w][5];
+        pitches[w] = action[w][4];
+        rolls[w] = action[w][3];
+    }
+    RotationsFromEulerZYX(yaws, pitches, rolls, qw, qx, qy, qz, nwp);
+
     // check waypoints for ik solutions and joint limits
     for (size_t widx = 0; widx < action.size(); ++widx) {
         auto& istate = action[widx];
@@ -810,7 +864,8 @@ bool WorkspaceLattice::checkLazyAction(
         SMPL_DEBUG_STREAM_NAMED(G_EXPANSIONS_LOG, "        " << widx << ": " << istate);
 
         RobotState irstate;
-        if (!stateWorkspaceToRobot(istate, state, irstate)) {
+        auto rot = Quaternion(qw[widx], qx[widx], qy[widx], qz[widx]);
+        if (!stateWorkspaceToRobot(istate, rot, state, irstate)) {
             SMPL_DEBUG_NAMED(G_EXPANSIONS_LOG, "         -> failed to find ik solution");
             return false;
         }
@@ -31,6 +31,9 @@
 
 #include <smpl/graph/workspace_lattice_base.h>
 
+// standard includes
+#include <cmath>
+
 // project includes
 #include <smpl/angles.h>
 #include <smpl/console/console.h>
@@ -128,6 +131,48 @@ bool WorkspaceLatticeBase::init(
         }
     }
 
+    m_res_inv.resize(m_dof_count);
+    for (int i = 0; i < m_dof_count; ++i) {
+        m_res_inv[i] = 1.0 / m_res[i];
+    }
+
+    // tabulate the continuous value and rotation terms at each rotation bin
+    for (int a = 0; a < 3; ++a) {
+        m_rot_vals[a].resize(m_val_count[3 + a]);
+        m_rot_sins[a].resize(m_val_count[3 + a]);
+        m_rot_coss[a].resize(m_val_count[3 + a]);
+        for (int gr = 0; gr < m_val_count[3 + a]; ++gr) {
+            double val;
+            if (a == 1) {
+                val = angles::normalize_angle(-0.5 * M_PI + (double)gr * m_res[4]);
+            } else {
+                val = angles::normalize_angle((double)gr * m_res[3 + a]);
+            }
+            m_rot_vals[a][gr] = val;
+            m_rot_sins[a][gr] = std::sin(val);
+            m_rot_coss[a][gr] = std::cos(val);
+        }
+    }
+
+    // tabulate the continuous value at each bin of the discretized free
+    // angles; bounded angles gain one extra bin since values at the max
+    // limit round up to it
+    m_fav_vals.resize(m_fangle_indices.size());
+    for (int i = 0; i < m_fangle_indices.size(); ++i) {
+        if (m_fangle_continuous[i]) {
+            m_fav_vals[i].resize(m_val_count[6 + i]);
+            for (int ga = 0; ga < m_val_count[6 + i]; ++ga) {
+                m_fav_vals[i][ga] = (double)ga * m_res[6 + i];
+            }
+        } else if (m_fangle_bounded[i]) {
+            m_fav_vals[i].resize(m_val_count[6 + i] + 1);
+            for (int ga = 0; ga <= m_val_count[6 + i]; ++ga) {
+                m_fav_vals[i][ga] =
+                        m_fangle_min_limits[i] + (double)ga * m_res[6 + i];
+            }
+        }
+    }
+
     SMPL_DEBUG_NAMED(G_LOG, "discretization of workspace lattice:");
     SMPL_DEBUG_NAMED(G_LOG, "  x: { res: %f, count: %d }", m_res[0], m_val_count[0]);
     SMPL_DEBUG_NAMED(G_LOG, "  y: { res: %f, count: %d }", m_res[1], m_val_count[1]);
@@ -234,6 +279,16 @@ bool WorkspaceLatticeBase::stateWorkspaceToRobot(
     return m_rm_iface->computeFastIK(pose, seed, ostate);
 }
 
+bool WorkspaceLatticeBase::stateWorkspaceToRobot(
+    const WorkspaceState& state,
+    const Quaternion& rot,
+    const RobotState& seed,
+    RobotState& ostate) const
+{
+    Affine3 pose = Translation3(state[0], state[1], state[2]) * rot;
+    return m_rm_iface->computeFastIK(pose, seed, ostate);
+}
+
 void WorkspaceLatticeBase::posWorkspaceToCoord(const double* wp, int* gp) const
 {
     if (wp[0] >= 0.0) {
@@ -264,17 +319,16 @@ void WorkspaceLatticeBase::posCoordToWorkspace(const int* gp, double* wp) const
 
 void WorkspaceLatticeBase::rotWorkspaceToCoord(const double* wr, int* gr) const
 {
-    gr[0] = (int)((angles::normalize_angle_positive(wr[0]) + m_res[3] * 0.5) / m_res[3]) % m_val_count[3];
-    gr[1] = (int)((angles::normalize_angle(wr[1]) + (0.5 * M_PI) + m_res[4] * 0.5) / m_res[4]) % m_val_count[4];
-    gr[2] = (int)((angles::normalize_angle_positive(wr[2]) + m_res[5] * 0.5) / m_res[5]) % m_val_count[5];
+    gr[0] = (int)((angles::normalize_angle_positive(wr[0]) + m_res[3] * 0.5) * m_res_inv[3]) % m_val_count[3];
+    gr[1] = (int)((angles::normalize_angle(wr[1]) + (0.5 * M_PI) + m_res[4] * 0.5) * m_res_inv[4]) % m_val_count[4];
+    gr[2] = (int)((angles::normalize_angle_positive(wr[2]) + m_res[5] * 0.5) * m_res_inv[5]) % m_val_count[5];
 }
 
 void WorkspaceLatticeBase::rotCoordToWorkspace(const int* gr, double* wr) const
 {
-    // TODO: this normalize is probably not necessary
-    wr[0] = angles::normalize_angle((double)gr[0] * m_res[3]);
-    wr[1] = angles::normalize_angle(-0.5 * M_PI + (double)gr[1] * m_res[4]);
-    wr[2] = angles::normalize_angle((double)gr[2] * m_res[5]);
+    wr[0] = m_rot_vals[0][gr[0]];
+    wr[1] = m_rot_vals[1][gr[1]];
+    wr[2] = m_rot_vals[2][gr[2]];
 }
 
 void WorkspaceLatticeBase::poseWorkspaceToCoord(const double* wp, int* gp) const
@@ -289,25 +343,54 @@ void WorkspaceLatticeBase::poseCoordToWorkspace(const int* gp, double* wp) const
     rotCoordToWorkspace(gp + 3, wp + 3);
 }
 
+void WorkspaceLatticeBase::poseCoordToPose(const int* gp, Affine3& pose) const
+{
+    double wp[3];
+    posCoordToWorkspace(gp, wp);
+
+    const double sr = m_rot_sins[0][gp[3]];
+    const double cr = m_rot_coss[0][gp[3]];
+    const double sp = m_rot_sins[1][gp[4]];
+    const double cp = m_rot_coss[1][gp[4]];
+    const double sy = m_rot_sins[2][gp[5]];
+    const double cy = m_rot_coss[2][gp[5]];
+
+    // R = Rz(yaw) * Ry(pitch) * Rx(roll), expanded from the tabulated terms
+    Matrix3 R;
+    R(0, 0) = cy * cp;
+    R(0, 1) = cy * sp * sr - sy * cr;
+    R(0, 2) = cy * sp * cr + sy * sr;
+    R(1, 0) = sy * cp;
+    R(1, 1) = sy * sp * sr + cy * cr;
+    R(1, 2) = sy * sp * cr - cy * sr;
+    R(2, 0) = -sp;
+    R(2, 1) = cp * sr;
+    R(2, 2) = cp * cr;
+
+    pose.setIdentity();
+    pose.linear() = R;
+    pose.translation() = Vector3(wp[0], wp[1], wp[2]);
+}
+
 void WorkspaceLatticeBase::favWorkspaceToCoord(const double* wa, int* ga) const
 {
     for (size_t fai = 0; fai < freeAngleCount(); ++fai) {
         if (m_fangle_continuous[fai]) {
             auto pos_angle = angles::normalize_angle_positive(wa[fai]);
 
-            ga[fai] = (int)((pos_angle + m_res[6 + fai] * 0.5) / m_res[6 + fai]);
+            ga[fai] = (int)((pos_angle + m_res[6 + fai] * 0.5) * m_res_inv[6 + fai]);
 
             if (ga[fai] == m_val_count[6 + fai]) {
                 ga[fai] = 0;
             }
         } else if (!m_fangle_bounded[fai]) {
             if (wa[fai] >= 0.0) {
-                ga[fai] = (int)(wa[fai] / m_res[6 + fai] + 0.5);
+                ga[fai] = (int)(wa[fai] * m_res_inv[6 + fai] + 0.5);
             } else {
-                ga[fai] = (int)(wa[fai] / m_res[6 + fai] - 0.5);
+                ga[fai] = (int)(wa[fai] * m_res_inv[6 + fai] - 0.5);
             }
         } else {
-            ga[fai] = (int)(((wa[fai] - m_fangle_min_limits[fai]) / m_res[6 + fai]) + 0.5);
+            ga[fai] = (int)(((wa[fai] - m_fangle_min_limits[fai]) * m_res_inv[6 + fai]) + 0.5);
         }
     }
 }
@@ -315,12 +398,11 @@ void WorkspaceLatticeBase::favWorkspaceToCoord(const double* wa, int* ga) const
 void WorkspaceLatticeBase::favCoordToWorkspace(const int* ga, double* wa) const
 {
     for (size_t i = 0; i < freeAngleCount(); ++i) {
-        if (m_fangle_continuous[i]) {
-            wa[i] = (double)ga[i] * m_res[6 + i];
-        } else if (!m_fangle_bounded[i]) {
-            wa[i] = (double)ga[i] * m_res[6 + i];// + 0.5 * m_res[6 + i];
+        if (!m_fav_vals[i].empty()) {
+            wa[i] = m_fav_vals[i][ga[i]];
         } else {
-            wa[i] = m_fangle_min_limits[i] + ga[i] * m_res[6 + i];
+            // unbounded free angle with an unbounded bin count
+            wa[i] = (double)ga[i] * m_res[6 + i];// + 0.5 * m_res[6 + i];
         }
     }
 }
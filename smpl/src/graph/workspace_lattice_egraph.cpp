@@ -1,7 +1,9 @@
 #include <smpl/graph/workspace_lattice_egraph.h>
 
 // standard includes
+#include <algorithm>
 #include <fstream>
+#include <thread>
 
 // system includes
 #include <boost/filesystem.hpp>
@@ -30,6 +32,33 @@ bool ParseExperienceGraphFile(
 
     SMPL_DEBUG_NAMED(G_LOG, "Parse experience graph at '%s'", filepath.c_str());
 
+    // fast path: parse well-formed numeric files in parallel chunks, without
+    // materializing a string per field
+    {
+        auto jvar_count = robot_model->getPlanningJoints().size();
+        std::vector<double> values;
+        size_t field_count;
+        auto num_threads =
+                std::max(1, (int)std::thread::hardware_concurrency());
+        if (ParseNumericCSV(filepath, values, field_count, num_threads) &&
+            field_count >= jvar_count)
+        {
+            if (field_count > jvar_count) {
+                SMPL_WARN("Parsed experience graph contains superflous many joint variables (%zu > %zu)", field_count, jvar_count);
+            }
+            auto record_count = values.size() / field_count;
+            SMPL_DEBUG_NAMED(G_LOG, "Read %zu records of %zu fields", record_count, field_count);
+            egraph_states.reserve(record_count);
+            for (size_t i = 0; i < record_count; ++i) {
+                egraph_states.push_back(RobotState(
+                        values.begin() + i * field_count,
+                        values.begin() + i * field_count + jvar_count));
+            }
+            SMPL_DEBUG_NAMED(G_LOG, "Read %zu states from experience graph file", egraph_states.size());
+            return true;
+        }
+    }
+
     CSVParser parser;
     auto with_header = true;
     if (!parser.parseStream(fin, with_header)) {
@@ -461,6 +490,59 @@ bool WorkspaceLatticeEGraph::snap(int src_id, int dst_id, int& cost)
     return true;
 }
 
+// Evaluate a burst of snap candidates with one call into the collision
+// checker. The snap motion here is a pure motion validity check, so the
+// whole burst reduces to independent state-to-state sweeps from a common
+// source, which a checker with concurrent motion validation may evaluate
+// together.
+void WorkspaceLatticeEGraph::snap(
+    int src_id,
+    const std::vector<int>& dst_ids,
+    std::vector<int>& costs)
+{
+    costs.assign(dst_ids.size(), -1);
+
+    auto* src_state = getState(src_id);
+    if (src_state == NULL) {
+        SMPL_WARN("No state entry for state %d", src_id);
+        return;
+    }
+
+    auto* vis_name = "snap";
+    SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(src_state->state, "snap_from"));
+
+    std::vector<RobotState> dst_states;
+    std::vector<size_t> dst_indices;
+    dst_states.reserve(dst_ids.size());
+    dst_indices.reserve(dst_ids.size());
+    for (size_t i = 0; i < dst_ids.size(); ++i) {
+        auto* dst_state = getState(dst_ids[i]);
+        if (dst_state == NULL) {
+            SMPL_WARN("No state entry for state %d", dst_ids[i]);
+            continue;
+        }
+
+        SMPL_DEBUG_STREAM("Snap " << src_state->coord << " -> " << dst_state->coord);
+        SV_SHOW_INFO_NAMED(vis_name, getStateVisualization(dst_state->state, "snap_to"));
+
+        dst_states.push_back(dst_state->state);
+        dst_indices.push_back(i);
+    }
+
+    std::vector<bool> valid;
+    collisionChecker()->isStateToStatesValid(src_state->state, dst_states, valid);
+
+    for (size_t i = 0; i < dst_states.size(); ++i) {
+        if (!valid[i]) {
+            SMPL_WARN("Failed snap!");
+            continue;
+        }
+
+        SMPL_DEBUG_NAMED(G_LOG, "  Snap %d -> %d!", src_id, dst_ids[dst_indices[i]]);
+        costs[dst_indices[i]] = 1000;
+    }
+}
+
 auto WorkspaceLatticeEGraph::getExperienceGraph() const -> const ExperienceGraph*
 {
     return &m_egraph;
@@ -48,7 +48,7 @@ bool AttractorHeuristic::init(
     }
 
     m_grid = grid;
-    m_ers = space->getExtension<ExtractRobotStateExtension>();
+    m_ers = extractRobotState();
     return true;
 }
 
@@ -31,6 +31,10 @@
 
 #include <smpl/heuristic/bfs_heuristic.h>
 
+// standard includes
+#include <algorithm>
+#include <cstdlib>
+
 // project includes
 #include <smpl/bfs3d/bfs3d.h>
 #include <smpl/console/console.h>
@@ -60,7 +64,7 @@ bool BfsHeuristic::init(RobotPlanningSpace* space, const OccupancyGrid* grid)
 
     m_grid = grid;
 
-    m_pp = space->getExtension<PointProjectionExtension>();
+    m_pp = pointProjection();
     if (m_pp != NULL) {
         SMPL_INFO_NAMED(LOG, "Got Point Projection Extension!");
     }
@@ -79,6 +83,67 @@ void BfsHeuristic::setCostPerCell(int cost_per_cell)
     m_cost_per_cell = cost_per_cell;
 }
 
+void BfsHeuristic::setCooperativeRefinement(bool enable)
+{
+    m_coop_refinement = enable;
+}
+
+void BfsHeuristic::setWavefrontCompletionCallback(std::function<void()> callback)
+{
+    m_wavefront_callback = std::move(callback);
+}
+
+void BfsHeuristic::setBfsStoreCapacity(size_t capacity)
+{
+    m_bfs_store_capacity = capacity;
+    while (m_bfs_store.size() > m_bfs_store_capacity) {
+        m_bfs_store.pop_back();
+    }
+}
+
+void BfsHeuristic::updateStart(const RobotState& state)
+{
+    m_start_cell_valid = false;
+
+    if (m_pp == NULL) {
+        return;
+    }
+
+    Vector3 p;
+    if (!m_pp->projectToPoint(planningSpace()->getStartStateID(), p)) {
+        return;
+    }
+
+    int sx, sy, sz;
+    grid()->worldToGrid(p.x(), p.y(), p.z(), sx, sy, sz);
+
+    SMPL_DEBUG_NAMED(LOG, "Setting the BFS heuristic start (%d, %d, %d)", sx, sy, sz);
+
+    m_start_cell = CellCoord(sx, sy, sz);
+    m_start_cell_valid = true;
+
+    if (m_start_bfs == NULL) {
+        // the goal bfs already compiled the wall pattern for this obstacle
+        // snapshot; copy it instead of rescanning the occupancy grid
+        if (m_bfs != NULL) {
+            m_start_bfs.reset(new BFS_3D(
+                    grid()->numCellsX(),
+                    grid()->numCellsY(),
+                    grid()->numCellsZ()));
+            m_start_bfs->copyWalls(*m_bfs);
+        } else {
+            m_start_bfs = makeBfs();
+        }
+    }
+
+    if (!m_start_bfs->inBounds(sx, sy, sz)) {
+        SMPL_ERROR_NAMED(LOG, "Heuristic start is out of BFS bounds");
+        return;
+    }
+
+    m_start_bfs->run(sx, sy, sz);
+}
+
 void BfsHeuristic::updateGoal(const GoalConstraint& goal)
 {
     switch (goal.type) {
@@ -104,14 +169,16 @@ void BfsHeuristic::updateGoal(const GoalConstraint& goal)
             break;
         }
 
-        m_goal_cells.emplace_back(gx, gy, gz);
-
-        m_bfs->run(gx, gy, gz);
+        if (!loadStoredBfs({ CellCoord(gx, gy, gz) })) {
+            m_bfs->setCompletionCallback(m_wavefront_callback);
+            m_bfs->run(gx, gy, gz);
+        }
         break;
     }
     case GoalType::MULTIPLE_POSE_GOAL:
     {
         std::vector<int> cell_coords;
+        std::vector<CellCoord> cells;
         for (auto& goal_pose : goal.poses) {
             int gx, gy, gz;
             grid()->worldToGrid(
@@ -131,9 +198,12 @@ void BfsHeuristic::updateGoal(const GoalConstraint& goal)
             cell_coords.push_back(gy);
             cell_coords.push_back(gz);
 
-            m_goal_cells.emplace_back(gx, gy, gz);
+            cells.emplace_back(gx, gy, gz);
+        }
+        if (!loadStoredBfs(cells)) {
+            m_bfs->setCompletionCallback(m_wavefront_callback);
+            m_bfs->run(begin(cell_coords), end(cell_coords));
         }
-        m_bfs->run(begin(cell_coords), end(cell_coords));
         break;
     }
     case GoalType::USER_GOAL_CONSTRAINT_FN:
@@ -143,6 +213,22 @@ void BfsHeuristic::updateGoal(const GoalConstraint& goal)
     }
 }
 
+bool BfsHeuristic::startUnreachable() const
+{
+    // only answer when a goal wavefront has been seeded and the start cell
+    // is known; m_goal_cells is cleared whenever the walls are rescanned
+    if (m_bfs == NULL || m_goal_cells.empty() || !m_start_cell_valid) {
+        return false;
+    }
+    auto& c = m_start_cell;
+    if (!m_bfs->inBounds(c.x, c.y, c.z)) {
+        return false;
+    }
+    // remains undiscovered after the wavefront finishes only if no free-cell
+    // corridor connects it to the goal region; walls report discovered
+    return m_bfs->isUndiscovered(c.x, c.y, c.z);
+}
+
 double BfsHeuristic::getMetricStartDistance(double x, double y, double z)
 {
     int start_id = planningSpace()->getStartStateID();
@@ -199,16 +285,51 @@ int BfsHeuristic::GetGoalHeuristic(int state_id)
         return 0;
     }
 
+    return GetGoalHeuristic(state_id, p);
+}
+
+int BfsHeuristic::GetStartHeuristic(int state_id)
+{
+    if (m_pp == NULL || m_start_bfs == NULL) {
+        return 0;
+    }
+
+    Vector3 p;
+    if (!m_pp->projectToPoint(state_id, p)) {
+        return 0;
+    }
+
+    Eigen::Vector3i dp;
+    grid()->worldToGrid(p.x(), p.y(), p.z(), dp.x(), dp.y(), dp.z());
+
+    return getBfsCostToGoal(*m_start_bfs, dp.x(), dp.y(), dp.z());
+}
+
+int BfsHeuristic::GetGoalHeuristic(int state_id, const Vector3& p)
+{
     Eigen::Vector3i dp;
     grid()->worldToGrid(p.x(), p.y(), p.z(), dp.x(), dp.y(), dp.z());
 
     return getBfsCostToGoal(*m_bfs, dp.x(), dp.y(), dp.z());
 }
 
-int BfsHeuristic::GetStartHeuristic(int state_id)
+auto BfsHeuristic::memUsage() const -> size_t
 {
-    SMPL_WARN_ONCE("BfsHeuristic::GetStartHeuristic unimplemented");
-    return 0;
+    size_t bytes = 0;
+    if (m_bfs) {
+        bytes += m_bfs->memUsage();
+    }
+    if (m_start_bfs) {
+        bytes += m_start_bfs->memUsage();
+    }
+    bytes += m_goal_cells.capacity() * sizeof(CellCoord);
+    for (auto& stored : m_bfs_store) {
+        if (stored.bfs) {
+            bytes += stored.bfs->memUsage();
+        }
+        bytes += stored.goal_cells.capacity() * sizeof(CellCoord);
+    }
+    return bytes;
 }
 
 int BfsHeuristic::GetFromToHeuristic(int from_id, int to_id)
@@ -384,28 +505,81 @@ auto BfsHeuristic::getValuesVisualization() -> visual::Marker
             "bfs_values");
 }
 
-void BfsHeuristic::syncGridAndBfs()
+auto BfsHeuristic::makeBfs() const -> std::unique_ptr<BFS_3D>
 {
     const int xc = grid()->numCellsX();
     const int yc = grid()->numCellsY();
     const int zc = grid()->numCellsZ();
 //    SMPL_DEBUG_NAMED(LOG, "Initializing BFS of size %d x %d x %d = %d", xc, yc, zc, xc * yc * zc);
-    m_bfs.reset(new BFS_3D(xc, yc, zc));
+    std::unique_ptr<BFS_3D> bfs(new BFS_3D(xc, yc, zc));
     const int cell_count = xc * yc * zc;
-    int wall_count = 0;
-    for (int x = 0; x < xc; ++x) {
-    for (int y = 0; y < yc; ++y) {
-    for (int z = 0; z < zc; ++z) {
-        const double radius = m_inflation_radius;
-        if (grid()->getDistance(x, y, z) <= radius) {
-            m_bfs->setWall(x, y, z);
-            ++wall_count;
+
+    // gather all cells within the inflation radius in one pass over the
+    // distance map rather than one distance lookup per cell
+    std::vector<int> walls;
+    grid()->getCellsWithinDistance(m_inflation_radius, walls);
+    for (size_t i = 0; i < walls.size(); i += 3) {
+        bfs->setWall(walls[i], walls[i + 1], walls[i + 2]);
+    }
+    const int wall_count = (int)(walls.size() / 3);
+
+    SMPL_DEBUG_NAMED(LOG, "%d/%d (%0.3f%%) walls in the bfs heuristic", wall_count, cell_count, 100.0 * (double)wall_count / cell_count);
+    return bfs;
+}
+
+void BfsHeuristic::syncGridAndBfs()
+{
+    m_bfs = makeBfs();
+    m_start_bfs.reset();
+
+    // the wall pattern changed; stored wavefronts no longer match this map
+    m_bfs_store.clear();
+    m_goal_cells.clear();
+}
+
+// Make m_bfs the wavefront for the given goal cells. The current wavefront is
+// retired to the store so that a later return to its goal is a swap rather
+// than a new BFS. Returns true if a wavefront for these cells has already
+// been run; otherwise m_bfs holds a fresh wavefront for the caller to run.
+bool BfsHeuristic::loadStoredBfs(const std::vector<CellCoord>& cells)
+{
+    if (!m_goal_cells.empty() && cells == m_goal_cells) {
+        return true;
+    }
+
+    // retire the current wavefront, most recently used first
+    if (!m_goal_cells.empty() && m_bfs != NULL) {
+        StoredBfs retired;
+        retired.goal_cells = std::move(m_goal_cells);
+        retired.bfs = std::move(m_bfs);
+        m_bfs_store.insert(begin(m_bfs_store), std::move(retired));
+    }
+
+    m_goal_cells = cells;
+
+    for (auto it = begin(m_bfs_store); it != end(m_bfs_store); ++it) {
+        if (it->goal_cells == cells) {
+            m_bfs = std::move(it->bfs);
+            m_bfs_store.erase(it);
+            return true;
         }
     }
+
+    if (m_bfs == NULL) {
+        // the retired wavefront already compiled the wall pattern for this
+        // obstacle snapshot; copy it instead of rescanning the occupancy grid
+        m_bfs.reset(new BFS_3D(
+                grid()->numCellsX(),
+                grid()->numCellsY(),
+                grid()->numCellsZ()));
+        m_bfs->copyWalls(*m_bfs_store.front().bfs);
     }
+
+    while (m_bfs_store.size() > m_bfs_store_capacity) {
+        m_bfs_store.pop_back();
     }
 
-    SMPL_DEBUG_NAMED(LOG, "%d/%d (%0.3f%%) walls in the bfs heuristic", wall_count, cell_count, 100.0 * (double)wall_count / cell_count);
+    return false;
 }
 
 int BfsHeuristic::getBfsCostToGoal(const BFS_3D& bfs, int x, int y, int z) const
@@ -413,7 +587,22 @@ int BfsHeuristic::getBfsCostToGoal(const BFS_3D& bfs, int x, int y, int z) const
     if (!bfs.inBounds(x, y, z)) {
         return Infinity;
     }
-    else if (bfs.getDistance(x, y, z) == BFS_3D::WALL) {
+
+    // under cooperative refinement, queries against a still-running goal
+    // wavefront do not block on unclosed cells; they report a lower bound
+    // and the consuming search refreshes once the wavefront completes
+    if (m_coop_refinement && &bfs == m_bfs.get() && bfs.isRunning()) {
+        const int d = bfs.tryGetDistance(x, y, z);
+        if (d == BFS_3D::WALL) {
+            return Infinity;
+        }
+        if (d == BFS_3D::UNDISCOVERED) {
+            return getUndiscoveredCostToGoal(x, y, z);
+        }
+        return m_cost_per_cell * d;
+    }
+
+    if (bfs.getDistance(x, y, z) == BFS_3D::WALL) {
         return Infinity;
     }
     else {
@@ -421,4 +610,23 @@ int BfsHeuristic::getBfsCostToGoal(const BFS_3D& bfs, int x, int y, int z) const
     }
 }
 
+// Lower bound on the cost from a cell the goal wavefront has not yet closed.
+// The wavefront advances at most one cell along each axis per step, so the
+// Chebyshev distance to the nearest goal cell never overestimates the
+// eventual BFS distance.
+int BfsHeuristic::getUndiscoveredCostToGoal(int x, int y, int z) const
+{
+    int best = Infinity;
+    for (const CellCoord& c : m_goal_cells) {
+        const int dx = std::abs(x - c.x);
+        const int dy = std::abs(y - c.y);
+        const int dz = std::abs(z - c.z);
+        best = std::min(best, std::max(dx, std::max(dy, dz)));
+    }
+    if (best == Infinity) {
+        return Infinity;
+    }
+    return m_cost_per_cell * best;
+}
+
 } // namespace smpl
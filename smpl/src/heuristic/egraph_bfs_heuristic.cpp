@@ -54,6 +54,56 @@ auto DijkstraEgraphHeuristic3D::Vector3iHash::operator()(const argument_type& s)
     return seed;
 }
 
+void DijkstraEgraphHeuristic3D::OpenList::init(int max_edge_cost)
+{
+    // all queued distances lie within [min, min + max_edge_cost], so one
+    // bucket per possible edge cost suffices for the cyclic array
+    this->buckets.assign(max_edge_cost + 1, std::vector<Cell*>());
+    this->min = 0;
+    this->count = 0;
+}
+
+void DijkstraEgraphHeuristic3D::OpenList::clear()
+{
+    for (auto& bucket : this->buckets) {
+        bucket.clear();
+    }
+    this->min = 0;
+    this->count = 0;
+}
+
+void DijkstraEgraphHeuristic3D::OpenList::push(Cell* cell)
+{
+    this->buckets[cell->dist % this->buckets.size()].push_back(cell);
+    ++this->count;
+}
+
+auto DijkstraEgraphHeuristic3D::OpenList::pop() -> Cell*
+{
+    while (this->count > 0) {
+        auto& bucket = this->buckets[this->min % this->buckets.size()];
+        if (bucket.empty()) {
+            ++this->min;
+            continue;
+        }
+        auto* cell = bucket.back();
+        bucket.pop_back();
+        --this->count;
+        // skip stale entries from cells relaxed after this entry was queued
+        if (cell->dist == this->min) {
+            return cell;
+        }
+    }
+    return nullptr;
+}
+
+DijkstraEgraphHeuristic3D::~DijkstraEgraphHeuristic3D()
+{
+    if (m_grid != nullptr && m_change_callback_handle != -1) {
+        m_grid->removeChangeCallback(m_change_callback_handle);
+    }
+}
+
 bool DijkstraEgraphHeuristic3D::init(
     RobotPlanningSpace* space,
     const OccupancyGrid* grid)
@@ -68,7 +118,7 @@ bool DijkstraEgraphHeuristic3D::init(
 
     m_grid = grid;
 
-    m_pp = space->getExtension<PointProjectionExtension>();
+    m_pp = pointProjection();
     m_eg = space->getExtension<ExperienceGraphExtension>();
 
     if (!m_pp) {
@@ -112,6 +162,11 @@ bool DijkstraEgraphHeuristic3D::init(
         }
     }
 
+    m_change_callback_handle = m_grid->addChangeCallback(
+            [this](const OccupancyGrid::OccupancyChanges& changes) {
+                repairChangedCells(changes);
+            });
+
     return true;
 }
 
@@ -368,15 +423,30 @@ void DijkstraEgraphHeuristic3D::updateGoal(const GoalConstraint& goal)
 
     if (!grid()->isInBounds(dgp.x(), dgp.y(), dgp.z())) {
         SMPL_WARN("Cell (%d, %d, %d) is outside heuristic bounds", dgp.x(), dgp.y(), dgp.z());
+        m_have_goal = false;
         return;
     }
 
     dgp += Eigen::Vector3i::Ones();
 
-    m_open.clear();
+    // size the bucket queue to span the largest edge cost in the graph; the
+    // 26-connected neighbor costs are bounded by eps_E * sqrt(3), but the
+    // projected experience graph edges may connect arbitrarily distant cells
+    int max_edge_cost = (int)(m_eg_eps * 1000.0 * std::sqrt(3.0)) + 1;
+    for (auto& entry : m_heur_nodes) {
+        for (auto& adj : entry.second.edges) {
+            Eigen::Vector3i de = adj - entry.first;
+            auto cost = (int)(1000.0 * std::sqrt((double)de.squaredNorm()));
+            max_edge_cost = std::max(max_edge_cost, cost);
+        }
+    }
+
+    m_max_edge_cost = max_edge_cost;
+    m_open.init(max_edge_cost);
     auto* c = &m_dist_grid(dgp.x(), dgp.y(), dgp.z());
     c->dist = 0;
     m_open.push(c);
+    m_have_goal = true;
 
     SMPL_INFO_NAMED(LOG, "Updated EGraphBfsHeuristic goal");
 }
@@ -563,9 +633,11 @@ int DijkstraEgraphHeuristic3D::getGoalHeuristic(const Eigen::Vector3i& dp)
     int expand_count = 0;
     static int repeat_count = 1;
     while (cell->dist == Unknown && !m_open.empty()) {
+        Cell* curr_cell = m_open.pop();
+        if (curr_cell == nullptr) {
+            break;
+        }
         ++expand_count;
-        Cell* curr_cell = m_open.min();
-        m_open.pop();
 
         int cidx = std::distance(m_dist_grid.data(), curr_cell);
         size_t cx, cy, cz;
@@ -586,14 +658,9 @@ int DijkstraEgraphHeuristic3D::getGoalHeuristic(const Eigen::Vector3i& dp)
                 auto cost = (int)(1000.0 * std::sqrt((double)(dx * dx + dy * dy + dz * dz)));
                 auto new_cost = curr_cell->dist + cost;
                 if (new_cost < ncell->dist) {
+                    SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with egraph edge (-> %d)", adj.x(), adj.y(), adj.z(), new_cost);
                     ncell->dist = new_cost;
-                    if (m_open.contains(ncell)) {
-                        SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with egraph edge (-> %d)", adj.x(), adj.y(), adj.z(), new_cost);
-                        m_open.decrease(ncell);
-                    } else {
-                        SMPL_DEBUG_NAMED(LOG, "  Insert cell (%d, %d, %d) with egraph edge (-> %d)", adj.x(), adj.y(), adj.z(), new_cost);
-                        m_open.push(ncell);
-                    }
+                    m_open.push(ncell);
                 }
             }
         }
@@ -621,14 +688,9 @@ int DijkstraEgraphHeuristic3D::getGoalHeuristic(const Eigen::Vector3i& dp)
             auto new_cost = curr_cell->dist + cost;
 
             if (new_cost < ncell->dist) {
+                SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with normal edge (-> %d)", (int)sx, (int)sy, (int)sz, new_cost);
                 ncell->dist = new_cost;
-                if (m_open.contains(ncell)) {
-                    SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with normal edge (-> %d)", (int)sx, (int)sy, (int)sz, new_cost);
-                    m_open.decrease(ncell);
-                } else {
-                    SMPL_DEBUG_NAMED(LOG, "  Insert cell (%d, %d, %d) with normal edge (-> %d)", (int)sx, (int)sy, (int)sz, new_cost);
-                    m_open.push(ncell);
-                }
+                m_open.push(ncell);
             }
         }
         }
@@ -673,4 +735,175 @@ void DijkstraEgraphHeuristic3D::syncGridAndDijkstra()
     SMPL_INFO_NAMED(LOG, "%d/%d (%0.3f%%) walls in the bfs heuristic", wall_count, cell_count, 100.0 * (double)wall_count / cell_count);
 }
 
+// Repair the distance grid in response to an occupancy change instead of
+// recomputing it from scratch. Wall status is re-derived within the changed
+// region dilated by the inflation radius, the only distance at which wall
+// status can flip. A raise wave then resets every cell whose distance may
+// have routed through a changed cell, and the surviving frontier around the
+// reset region is re-queued so the lazy Dijkstra recomputes only the affected
+// cells on the next lookup. The experience graph projection, component, and
+// shortcut tables are untouched; they depend on the graph and the goal, not
+// on occupancy. Values outside the reset region remain costs of paths valid
+// in the new map; paths shortened by freed space are folded in as the
+// resumed search relaxes through them.
+void DijkstraEgraphHeuristic3D::repairChangedCells(
+    const OccupancyGrid::OccupancyChanges& changes)
+{
+    const int dilation =
+            (int)std::ceil(m_inflation_radius / grid()->resolution()) + 1;
+
+    // dilated changed region in distance grid coordinates, clamped to the
+    // interior of the wall border
+    const int xmin = std::max(changes.min_cell[0] - dilation + 1, 1);
+    const int ymin = std::max(changes.min_cell[1] - dilation + 1, 1);
+    const int zmin = std::max(changes.min_cell[2] - dilation + 1, 1);
+    const int xmax = std::min(changes.max_cell[0] + dilation + 1, (int)m_dist_grid.xsize() - 2);
+    const int ymax = std::min(changes.max_cell[1] + dilation + 1, (int)m_dist_grid.ysize() - 2);
+    const int zmax = std::min(changes.max_cell[2] + dilation + 1, (int)m_dist_grid.zsize() - 2);
+
+    // cells reset to Unknown during this repair
+    std::vector<Eigen::Vector3i> stale;
+
+    // cells that became walls or were reset, paired with their former
+    // distances, whose dependents must be found
+    std::vector<std::pair<Eigen::Vector3i, int>> raise;
+
+    for (int x = xmin; x <= xmax; ++x) {
+    for (int y = ymin; y <= ymax; ++y) {
+    for (int z = zmin; z <= zmax; ++z) {
+        auto& c = m_dist_grid(x, y, z);
+        const bool wall =
+                grid()->getDistance(x - 1, y - 1, z - 1) <= m_inflation_radius;
+        if (wall && c.dist != Wall) {
+            if (c.dist != Unknown) {
+                raise.emplace_back(Eigen::Vector3i(x, y, z), c.dist);
+            }
+            c.dist = Wall;
+        } else if (!wall && c.dist == Wall) {
+            c.dist = Unknown;
+            stale.push_back(Eigen::Vector3i(x, y, z));
+        }
+    }
+    }
+    }
+
+    if (raise.empty() && stale.empty()) {
+        return; // no wall flipped; all distances remain valid
+    }
+
+    SMPL_DEBUG_NAMED(LOG, "Repair heuristic for %zu raised and %zu freed cells", raise.size(), stale.size());
+
+    if (!m_have_goal) {
+        return; // distances not seeded yet; wall status is all there is
+    }
+
+    // reset every cell that may have derived its distance from a raised cell
+    auto raise_test = [&](const Eigen::Vector3i& n, int sdist, int cost) {
+        auto& nc = m_dist_grid(n.x(), n.y(), n.z());
+        if (nc.dist == Wall || nc.dist == Unknown) {
+            return;
+        }
+        if (nc.dist == sdist + cost) {
+            const int old = nc.dist;
+            nc.dist = Unknown;
+            stale.push_back(n);
+            raise.emplace_back(n, old);
+        }
+    };
+
+    while (!raise.empty()) {
+        const auto entry = raise.back();
+        raise.pop_back();
+        const Eigen::Vector3i& s = entry.first;
+        const int sdist = entry.second;
+
+        for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            if (dx == 0 & dy == 0 & dz == 0) {
+                continue;
+            }
+            auto cost = (int)(m_eg_eps * 1000.0 * std::sqrt((double)(dx * dx + dy * dy + dz * dz)));
+            raise_test(s + Eigen::Vector3i(dx, dy, dz), sdist, cost);
+        }
+        }
+        }
+
+        // experience graph adjacency is symmetric, so the cells that may have
+        // derived their distances through s over graph edges are its own
+        // adjacent cells
+        auto it = m_heur_nodes.find(s);
+        if (it != end(m_heur_nodes)) {
+            for (auto& adj : it->second.edges) {
+                const Eigen::Vector3i de = adj - s;
+                auto cost = (int)(1000.0 * std::sqrt((double)de.squaredNorm()));
+                raise_test(adj, sdist, cost);
+            }
+        }
+    }
+
+    // gather the intact cells bordering the reset region; resuming the
+    // search from them recomputes exactly the reset cells still reachable
+    std::vector<Cell*> seeds;
+    auto add_seed = [&](const Eigen::Vector3i& n) {
+        auto& nc = m_dist_grid(n.x(), n.y(), n.z());
+        if (nc.dist != Wall && nc.dist != Unknown) {
+            seeds.push_back(&nc);
+        }
+    };
+
+    for (const auto& sp : stale) {
+        for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            if (dx == 0 & dy == 0 & dz == 0) {
+                continue;
+            }
+            add_seed(sp + Eigen::Vector3i(dx, dy, dz));
+        }
+        }
+        }
+
+        auto it = m_heur_nodes.find(sp);
+        if (it != end(m_heur_nodes)) {
+            for (auto& adj : it->second.edges) {
+                add_seed(adj);
+            }
+        }
+    }
+
+    // retain the frontier of the interrupted search
+    for (auto& bucket : m_open.buckets) {
+        for (Cell* c : bucket) {
+            if (c->dist != Wall && c->dist != Unknown) {
+                seeds.push_back(c);
+            }
+        }
+    }
+
+    std::sort(begin(seeds), end(seeds));
+    seeds.erase(std::unique(begin(seeds), end(seeds)), end(seeds));
+
+    if (seeds.empty()) {
+        m_open.clear();
+        return;
+    }
+
+    // Rebuild the bucket queue around the seed distances. Unlike the
+    // single-source case, seed distances may span more than one edge cost, so
+    // the cyclic array must cover their spread as well.
+    int min_seed = seeds.front()->dist;
+    int max_seed = seeds.front()->dist;
+    for (Cell* c : seeds) {
+        min_seed = std::min(min_seed, c->dist);
+        max_seed = std::max(max_seed, c->dist);
+    }
+
+    m_open.init(max_seed - min_seed + m_max_edge_cost);
+    m_open.min = min_seed;
+    for (Cell* c : seeds) {
+        m_open.push(c);
+    }
+}
+
 } // namespace smpl
@@ -34,6 +34,10 @@
 // standard includes
 #include <cmath>
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
 // project includes
 #include <smpl/angles.h>
 #include <smpl/console/console.h>
@@ -42,6 +46,10 @@ namespace smpl {
 
 static const char* LOG = "heuristic.euclid_dist";
 
+// resolution of the goal-region distance field; coarse relative to typical
+// planning grids since the field only guides states toward the region
+static const double GoalRegionFieldRes = 0.05;
+
 static inline
 double EuclideanDistance(
     double x1, double y1, double z1,
@@ -59,11 +67,11 @@ bool EuclidDistHeuristic::init(RobotPlanningSpace* space)
         return false;
     }
 
-    m_point_ext = space->getExtension<PointProjectionExtension>();
+    m_point_ext = pointProjection();
     if (m_point_ext) {
         SMPL_INFO_NAMED(LOG, "Got Point Projection Extension!");
     }
-    m_pose_ext = space->getExtension<PoseProjectionExtension>();
+    m_pose_ext = poseProjection();
     if (m_pose_ext) {
         SMPL_INFO_NAMED(LOG, "Got Pose Projection Extension!");
     }
@@ -94,8 +102,27 @@ void EuclidDistHeuristic::setWeightRot(double wr)
     m_rot_coeff = wr;
 }
 
+void EuclidDistHeuristic::updateGoal(const GoalConstraint& goal)
+{
+    if (goal.type == GoalType::MULTIPLE_POSE_GOAL && goal.poses.size() > 1) {
+        std::vector<Vector3> positions;
+        positions.reserve(goal.poses.size());
+        for (auto& pose : goal.poses) {
+            positions.push_back(Vector3(pose.translation()));
+        }
+        m_goal_oracle.build(positions, GoalRegionFieldRes);
+        SMPL_DEBUG_NAMED(LOG, "Built goal region distance oracle over %zu poses", positions.size());
+    } else {
+        m_goal_oracle.clear();
+    }
+}
+
 double EuclidDistHeuristic::getMetricGoalDistance(double x, double y, double z)
 {
+    if (m_goal_oracle.initialized()) {
+        return m_goal_oracle.dist(x, y, z);
+    }
+
     auto& goal_pose = planningSpace()->goal().pose;
     return EuclideanDistance(
             x, y, z,
@@ -124,6 +151,30 @@ int EuclidDistHeuristic::GetGoalHeuristic(int state_id)
         return 0;
     }
 
+    // a goal region is scored positionally through the oracle; the axis
+    // weights do not apply through a scalar field and orientation is left to
+    // the goal test, which checks each candidate pose
+    if (m_goal_oracle.initialized()) {
+        Vector3 p;
+        if (m_point_ext) {
+            if (!m_point_ext->projectToPoint(state_id, p)) {
+                return 0;
+            }
+        } else if (m_pose_ext) {
+            Affine3 pose;
+            if (!m_pose_ext->projectToPose(state_id, pose)) {
+                return 0;
+            }
+            p = pose.translation();
+        } else {
+            return 0;
+        }
+
+        const int h = FIXED_POINT_RATIO * m_goal_oracle.dist(p.x(), p.y(), p.z());
+        SMPL_DEBUG_NAMED(LOG, "h(%d) = %d", state_id, h);
+        return h;
+    }
+
     if (m_pose_ext) {
         Affine3 p;
         if (!m_pose_ext->projectToPose(state_id, p)) {
@@ -160,6 +211,77 @@ int EuclidDistHeuristic::GetGoalHeuristic(int state_id)
     }
 }
 
+void EuclidDistHeuristic::GetGoalHeuristics(
+    const int* state_ids,
+    int state_count,
+    int* values)
+{
+    // the pose-aware path pays for quaternion extraction per state; only the
+    // single-goal position-only path gathers into flat arrays worth
+    // vectorizing over
+    if (m_pose_ext || !m_point_ext || m_goal_oracle.initialized()) {
+        RobotHeuristic::GetGoalHeuristics(state_ids, state_count, values);
+        return;
+    }
+
+    auto& goal_pose = planningSpace()->goal().pose;
+    const double gx = goal_pose.translation()[0];
+    const double gy = goal_pose.translation()[1];
+    const double gz = goal_pose.translation()[2];
+
+    // gather the projected positions as three contiguous coordinate blocks
+    m_batch_pts.resize(3 * state_count);
+    double* xs = m_batch_pts.data();
+    double* ys = xs + state_count;
+    double* zs = ys + state_count;
+    for (int i = 0; i < state_count; ++i) {
+        Vector3 p;
+        if (state_ids[i] == planningSpace()->getGoalStateID() ||
+            !m_point_ext->projectToPoint(state_ids[i], p))
+        {
+            p = Vector3(gx, gy, gz);
+        }
+        xs[i] = p.x();
+        ys[i] = p.y();
+        zs[i] = p.z();
+    }
+
+    int i = 0;
+#ifdef __AVX__
+    const __m256d vgx = _mm256_set1_pd(gx);
+    const __m256d vgy = _mm256_set1_pd(gy);
+    const __m256d vgz = _mm256_set1_pd(gz);
+    const __m256d vcx = _mm256_set1_pd(m_x_coeff);
+    const __m256d vcy = _mm256_set1_pd(m_y_coeff);
+    const __m256d vcz = _mm256_set1_pd(m_z_coeff);
+    const __m256d vratio = _mm256_set1_pd(FIXED_POINT_RATIO);
+    for (; i + 4 <= state_count; i += 4) {
+        const __m256d dx = _mm256_sub_pd(vgx, _mm256_loadu_pd(xs + i));
+        const __m256d dy = _mm256_sub_pd(vgy, _mm256_loadu_pd(ys + i));
+        const __m256d dz = _mm256_sub_pd(vgz, _mm256_loadu_pd(zs + i));
+        __m256d d2 = _mm256_mul_pd(vcx, _mm256_mul_pd(dx, dx));
+        d2 = _mm256_add_pd(d2, _mm256_mul_pd(vcy, _mm256_mul_pd(dy, dy)));
+        d2 = _mm256_add_pd(d2, _mm256_mul_pd(vcz, _mm256_mul_pd(dz, dz)));
+        double h[4];
+        _mm256_storeu_pd(h, _mm256_mul_pd(vratio, d2));
+        values[i + 0] = (int)h[0];
+        values[i + 1] = (int)h[1];
+        values[i + 2] = (int)h[2];
+        values[i + 3] = (int)h[3];
+    }
+#endif
+    for (; i < state_count; ++i) {
+        const double dx = gx - xs[i];
+        const double dy = gy - ys[i];
+        const double dz = gz - zs[i];
+        const double d2 =
+                m_x_coeff * dx * dx +
+                m_y_coeff * dy * dy +
+                m_z_coeff * dz * dz;
+        values[i] = (int)(FIXED_POINT_RATIO * d2);
+    }
+}
+
 int EuclidDistHeuristic::GetStartHeuristic(int state_id)
 {
     return 0;
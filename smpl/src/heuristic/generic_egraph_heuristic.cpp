@@ -32,6 +32,7 @@
 // project includes
 #include <smpl/console/console.h>
 #include <smpl/heuristic/generic_egraph_heuristic.h>
+#include <smpl/heuristic/joint_dist_heuristic.h>
 
 namespace smpl {
 
@@ -48,6 +49,7 @@ bool GenericEgraphHeuristic::init(RobotPlanningSpace* space, RobotHeuristic* h)
     }
 
     m_orig_h = h;
+    m_jd_h = dynamic_cast<JointDistHeuristic*>(h);
 
     m_eg = space->getExtension<ExperienceGraphExtension>();
     if (!m_eg) {
@@ -68,8 +70,34 @@ void GenericEgraphHeuristic::getEquivalentStates(
     std::vector<int>& ids)
 {
     ExperienceGraph* eg = m_eg->getExperienceGraph();
-    auto nodes = eg->nodes();
     const int equiv_thresh = 100;
+
+    auto* ers = extractRobotState();
+    if (m_jd_h && ers && state_id != planningSpace()->getGoalStateID()) {
+        // the original heuristic measures euclidean joint distance, so
+        // equivalent nodes lie within a fixed radius of the query state and
+        // the index finds them without touching the rest of the graph; the
+        // exact threshold test is repeated per candidate to match the
+        // heuristic's integer truncation
+        if (m_index.graph() != eg) {
+            m_index.attach(eg);
+        }
+        const double radius =
+                (double)(equiv_thresh + 1) / JointDistHeuristic::FIXED_POINT_RATIO;
+        m_nearby_nodes.clear();
+        m_index.nodesInRadius(
+                ers->extractState(state_id), radius, m_nearby_nodes);
+        for (ExperienceGraph::node_id n : m_nearby_nodes) {
+            int egraph_state_id = m_eg->getStateID(n);
+            int h = m_orig_h->GetFromToHeuristic(state_id, egraph_state_id);
+            if (h <= equiv_thresh) {
+                ids.push_back(egraph_state_id);
+            }
+        }
+        return;
+    }
+
+    auto nodes = eg->nodes();
     for (auto nit = nodes.first; nit != nodes.second; ++nit) {
         int egraph_state_id = m_eg->getStateID(*nit);
         int h = m_orig_h->GetFromToHeuristic(state_id, egraph_state_id);
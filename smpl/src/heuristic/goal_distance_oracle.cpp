@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/heuristic/goal_distance_oracle.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// project includes
+#include <smpl/distance_map/euclid_distance_map.h>
+
+namespace smpl {
+
+GoalDistanceOracle::GoalDistanceOracle() = default;
+
+GoalDistanceOracle::~GoalDistanceOracle() = default;
+
+void GoalDistanceOracle::build(const std::vector<Vector3>& goals, double res)
+{
+    clear();
+
+    if (goals.empty() || res <= 0.0) {
+        return;
+    }
+
+    m_goals = goals;
+
+    Vector3 min = goals.front();
+    Vector3 max = goals.front();
+    for (const Vector3& goal : goals) {
+        min = min.cwiseMin(goal);
+        max = max.cwiseMax(goal);
+    }
+
+    // the map's border ring sources the propagation alongside the goals, so
+    // pad the box generously; cells whose value could have come from the
+    // boundary are detected at query time and re-answered exactly
+    const double pad = 0.25 * (max - min).norm() + 2.0 * res;
+    min -= Vector3(pad, pad, pad);
+    max += Vector3(pad, pad, pad);
+    const Vector3 size = max - min;
+    const double max_dist = size.norm() + res;
+
+    m_map.reset(new EuclidDistanceMap(
+            min.x(), min.y(), min.z(),
+            size.x(), size.y(), size.z(),
+            res,
+            max_dist));
+    m_map->addPointsToMap(m_goals);
+
+    m_min = min;
+    m_max = max;
+    m_cell_diag = res * std::sqrt(3.0);
+}
+
+void GoalDistanceOracle::clear()
+{
+    m_goals.clear();
+    m_map.reset();
+}
+
+double GoalDistanceOracle::dist(double x, double y, double z) const
+{
+    if (!m_map) {
+        return 0.0;
+    }
+
+    int gx, gy, gz;
+    m_map->worldToGrid(x, y, z, gx, gy, gz);
+    if (gx >= 1 && gx < m_map->numCellsX() - 1 &&
+        gy >= 1 && gy < m_map->numCellsY() - 1 &&
+        gz >= 1 && gz < m_map->numCellsZ() - 1)
+    {
+        const double d = m_map->getCellDistance(gx, gy, gz);
+
+        // trust the field only when the nearest source must have been a
+        // goal; a value reaching within a cell diagonal of the boundary
+        // distance may have been sourced by the border ring
+        const double border_dist = std::min(
+                (Vector3(x, y, z) - m_min).minCoeff(),
+                (m_max - Vector3(x, y, z)).minCoeff());
+        if (d + m_cell_diag < border_dist) {
+            return d;
+        }
+    }
+
+    return exactDist(x, y, z);
+}
+
+// The exact min over the goal set, paid by positions off the field or close
+// enough to its boundary for the field value to be ambiguous.
+double GoalDistanceOracle::exactDist(double x, double y, double z) const
+{
+    double min_dist = std::numeric_limits<double>::infinity();
+    for (const Vector3& goal : m_goals) {
+        const double dx = x - goal.x();
+        const double dy = y - goal.y();
+        const double dz = z - goal.z();
+        min_dist = std::min(min_dist, dx * dx + dy * dy + dz * dz);
+    }
+    return std::sqrt(min_dist);
+}
+
+} // namespace smpl
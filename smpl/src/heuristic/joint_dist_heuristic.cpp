@@ -32,8 +32,14 @@
 #include <smpl/heuristic/joint_dist_heuristic.h>
 
 // standard includes
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
 #include <smpl/console/console.h>
 
 namespace smpl {
@@ -44,7 +50,7 @@ bool JointDistHeuristic::init(RobotPlanningSpace* space)
         return false;
     }
 
-    m_ers = space->getExtension<ExtractRobotStateExtension>();
+    m_ers = extractRobotState();
     return true;
 }
 
@@ -122,6 +128,58 @@ int JointDistHeuristic::GetFromToHeuristic(int from_id, int to_id)
     }
 }
 
+void JointDistHeuristic::GetGoalHeuristics(
+    const int* state_ids,
+    int state_count,
+    int* values)
+{
+    if (!m_ers || planningSpace()->goal().type != GoalType::JOINT_STATE_GOAL) {
+        RobotHeuristic::GetGoalHeuristics(state_ids, state_count, values);
+        return;
+    }
+
+    const RobotState& goal_state = planningSpace()->goal().angles;
+    const size_t width = goal_state.size();
+
+    // gather the batch into one contiguous row-major array; extracted states
+    // are scattered through the planning space and the distance loop below
+    // wants flat doubles
+    m_batch_joints.resize(state_count * width);
+    double* row = m_batch_joints.data();
+    for (int i = 0; i < state_count; ++i, row += width) {
+        if (state_ids[i] == planningSpace()->getGoalStateID()) {
+            std::copy(goal_state.begin(), goal_state.end(), row);
+            continue;
+        }
+        const RobotState& state = m_ers->extractState(state_ids[i]);
+        assert(state.size() == width);
+        std::copy(state.begin(), state.end(), row);
+    }
+
+    const double* goal = goal_state.data();
+    row = m_batch_joints.data();
+    for (int i = 0; i < state_count; ++i, row += width) {
+        double dsum = 0.0;
+        size_t j = 0;
+#ifdef __AVX__
+        __m256d vsum = _mm256_setzero_pd();
+        for (; j + 4 <= width; j += 4) {
+            __m256d dj = _mm256_sub_pd(
+                    _mm256_loadu_pd(row + j), _mm256_loadu_pd(goal + j));
+            vsum = _mm256_add_pd(vsum, _mm256_mul_pd(dj, dj));
+        }
+        double part[4];
+        _mm256_storeu_pd(part, vsum);
+        dsum = part[0] + part[1] + part[2] + part[3];
+#endif
+        for (; j < width; ++j) {
+            double dj = row[j] - goal[j];
+            dsum += dj * dj;
+        }
+        values[i] = (int)(FIXED_POINT_RATIO * std::sqrt(dsum));
+    }
+}
+
 double JointDistHeuristic::computeJointDistance(
     const RobotState& s,
     const RobotState& t) const
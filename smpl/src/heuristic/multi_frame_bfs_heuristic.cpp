@@ -62,11 +62,11 @@ bool MultiFrameBfsHeuristic::init(
 
     m_grid = grid;
 
-    m_pp = space->getExtension<PointProjectionExtension>();
+    m_pp = pointProjection();
     if (m_pp) {
         SMPL_INFO_NAMED(LOG, "Got Point Projection Extension!");
     }
-    m_ers = space->getExtension<ExtractRobotStateExtension>();
+    m_ers = extractRobotState();
     if (m_ers) {
         SMPL_INFO_NAMED(LOG, "Got Extract Robot State Extension!");
     }
@@ -135,6 +135,11 @@ void MultiFrameBfsHeuristic::updateGoal(const GoalConstraint& goal)
         return;
     }
 
+    // the searches restart; queries fall back to the direct BFS path until
+    // both wavefronts complete again
+    m_costs.clear();
+    m_ee_costs.clear();
+
     m_bfs->run(ogx, ogy, ogz);
     m_ee_bfs->run(plgx, plgy, plgz);
 }
@@ -180,7 +185,8 @@ double MultiFrameBfsHeuristic::getMetricGoalDistance(
 
 int MultiFrameBfsHeuristic::GetGoalHeuristic(int state_id)
 {
-    return getGoalHeuristic(state_id, true);
+    materializeCostGrids();
+    return getGoalHeuristic(state_id, NULL, true);
 }
 
 int MultiFrameBfsHeuristic::GetStartHeuristic(int state_id)
@@ -189,6 +195,12 @@ int MultiFrameBfsHeuristic::GetStartHeuristic(int state_id)
     return 0;
 }
 
+int MultiFrameBfsHeuristic::GetGoalHeuristic(int state_id, const Vector3& p)
+{
+    materializeCostGrids();
+    return getGoalHeuristic(state_id, &p, true);
+}
+
 int MultiFrameBfsHeuristic::GetFromToHeuristic(int from_id, int to_id)
 {
     if (to_id == planningSpace()->getGoalStateID()) {
@@ -242,7 +254,8 @@ auto MultiFrameBfsHeuristic::getValuesVisualization() const -> visual::Marker
     // hopefully this doesn't screw anything up too badly...this will flush the
     // bfs to a little past the start, but this would be done by the search
     // hereafter anyway
-    int start_heur = getGoalHeuristic(planningSpace()->getStartStateID(), factor_ee);
+    int start_heur = getGoalHeuristic(
+            planningSpace()->getStartStateID(), NULL, factor_ee);
 
     const int edge_cost = m_cost_per_cell;
 
@@ -301,18 +314,27 @@ auto MultiFrameBfsHeuristic::getValuesVisualization() const -> visual::Marker
             "bfs_values");
 }
 
-int MultiFrameBfsHeuristic::getGoalHeuristic(int state_id, bool use_ee) const
+int MultiFrameBfsHeuristic::getGoalHeuristic(
+    int state_id,
+    const Vector3* p,
+    bool use_ee) const
 {
     if (state_id == planningSpace()->getGoalStateID()) {
         return 0;
     }
 
     int h_planning_frame = 0;
-    if (m_pp) {
-        Vector3 p;
-        if (m_pp->projectToPoint(state_id, p)) {
-            Eigen::Vector3i dp;
-            grid()->worldToGrid(p.x(), p.y(), p.z(), dp.x(), dp.y(), dp.z());
+    Vector3 proj;
+    if (p == NULL && m_pp && m_pp->projectToPoint(state_id, proj)) {
+        p = &proj;
+    }
+    if (p != NULL) {
+        Eigen::Vector3i dp;
+        grid()->worldToGrid(p->x(), p->y(), p->z(), dp.x(), dp.y(), dp.z());
+        if (!m_costs.empty()) {
+            h_planning_frame = getPrecombinedCostToGoal(
+                    m_costs, dp.x(), dp.y(), dp.z());
+        } else {
             h_planning_frame = getBfsCostToGoal(*m_bfs, dp.x(), dp.y(), dp.z());
         }
     }
@@ -327,7 +349,12 @@ int MultiFrameBfsHeuristic::getGoalHeuristic(int state_id, bool use_ee) const
                 pose.translation()[1],
                 pose.translation()[2],
                 eex[0], eex[1], eex[2]);
-        h_planning_link = getBfsCostToGoal(*m_ee_bfs, eex[0], eex[1], eex[2]);
+        if (!m_ee_costs.empty()) {
+            h_planning_link = getPrecombinedCostToGoal(
+                    m_ee_costs, eex[0], eex[1], eex[2]);
+        } else {
+            h_planning_link = getBfsCostToGoal(*m_ee_bfs, eex[0], eex[1], eex[2]);
+        }
     }
 
     return combine_costs(h_planning_frame, h_planning_link);
@@ -341,21 +368,60 @@ void MultiFrameBfsHeuristic::syncGridAndBfs()
     m_bfs.reset(new BFS_3D(xc, yc, zc));
     m_ee_bfs.reset(new BFS_3D(xc, yc, zc));
     const int cell_count = xc * yc * zc;
-    int wall_count = 0;
+
+    // export the inflated wall set from the distance map in a single pass
+    std::vector<int> walls;
+    grid()->getCellsWithinDistance(m_inflation_radius, walls);
+    for (size_t i = 0; i < walls.size(); i += 3) {
+        m_bfs->setWall(walls[i], walls[i + 1], walls[i + 2]);
+    }
+    const int wall_count = (int)(walls.size() / 3);
+
+    // the end effector bfs sees the same obstacle snapshot; copy the compiled
+    // wall pattern rather than scanning the occupancy grid a second time
+    m_ee_bfs->copyWalls(*m_bfs);
+
+    m_costs.clear();
+    m_ee_costs.clear();
+
+    SMPL_DEBUG_NAMED(LOG, "%d/%d (%0.3f%%) walls in the bfs heuristic", wall_count, cell_count, 100.0 * (double)wall_count / cell_count);
+}
+
+// Fold the wall handling and cost scaling of getBfsCostToGoal() into one
+// value per cell for both frames. A no-op until both wavefronts have
+// completed, so expansions issued while the searches are still running never
+// block here, and a no-op once the grids are filled, so the steady-state
+// overhead is two cheap flag tests per expansion.
+void MultiFrameBfsHeuristic::materializeCostGrids()
+{
+    if (!m_costs.empty()) {
+        return;
+    }
+    if (m_bfs->isRunning() || m_ee_bfs->isRunning()) {
+        return;
+    }
+
+    const int xc = grid()->numCellsX();
+    const int yc = grid()->numCellsY();
+    const int zc = grid()->numCellsZ();
+    m_cost_dims[0] = xc;
+    m_cost_dims[1] = yc;
+    m_cost_dims[2] = zc;
+
+    m_costs.resize((size_t)xc * yc * zc);
+    m_ee_costs.resize((size_t)xc * yc * zc);
+    size_t i = 0;
     for (int z = 0; z < zc; ++z) {
     for (int y = 0; y < yc; ++y) {
     for (int x = 0; x < xc; ++x) {
-        const double radius = m_inflation_radius;
-        if (grid()->getDistance(x, y, z) <= radius) {
-            m_bfs->setWall(x, y, z);
-            m_ee_bfs->setWall(x, y, z);
-            ++wall_count;
-        }
+        m_costs[i] = getBfsCostToGoal(*m_bfs, x, y, z);
+        m_ee_costs[i] = getBfsCostToGoal(*m_ee_bfs, x, y, z);
+        ++i;
     }
     }
     }
 
-    SMPL_DEBUG_NAMED(LOG, "%d/%d (%0.3f%%) walls in the bfs heuristic", wall_count, cell_count, 100.0 * (double)wall_count / cell_count);
+    SMPL_DEBUG_NAMED(LOG, "materialized precombined cost grids (%zu cells)", m_costs.size());
 }
 
 int MultiFrameBfsHeuristic::getBfsCostToGoal(
@@ -372,6 +438,17 @@ int MultiFrameBfsHeuristic::getBfsCostToGoal(
     }
 }
 
+int MultiFrameBfsHeuristic::getPrecombinedCostToGoal(
+    const std::vector<int>& costs, int x, int y, int z) const
+{
+    if (x < 0 || y < 0 || z < 0 ||
+        x >= m_cost_dims[0] || y >= m_cost_dims[1] || z >= m_cost_dims[2])
+    {
+        return Infinity;
+    }
+    return costs[x + m_cost_dims[0] * (y + m_cost_dims[1] * z)];
+}
+
 int MultiFrameBfsHeuristic::combine_costs(int c1, int c2) const
 {
     return c1 + c2;
@@ -43,11 +43,43 @@ bool RobotHeuristic::init(RobotPlanningSpace* space)
     }
 
     m_space = space;
+    refreshExtensions();
     return true;
 }
 
+void RobotHeuristic::refreshExtensions()
+{
+    m_point_ext = m_space->getExtension<PointProjectionExtension>();
+    m_pose_ext = m_space->getExtension<PoseProjectionExtension>();
+    m_ers_ext = m_space->getExtension<ExtractRobotStateExtension>();
+}
+
 RobotHeuristic::~RobotHeuristic()
 {
 }
 
+void GetGoalHeuristics(
+    RobotHeuristic* const* heurs,
+    int heur_count,
+    int state_id,
+    int* values)
+{
+    if (heur_count < 1) {
+        return;
+    }
+
+    auto* pp = heurs[0]->pointProjection();
+
+    Vector3 p;
+    if (pp != NULL && pp->projectToPoint(state_id, p)) {
+        for (int i = 0; i < heur_count; ++i) {
+            values[i] = heurs[i]->GetGoalHeuristic(state_id, p);
+        }
+    } else {
+        for (int i = 0; i < heur_count; ++i) {
+            values[i] = heurs[i]->GetGoalHeuristic(state_id);
+        }
+    }
+}
+
 } // namespace smpl
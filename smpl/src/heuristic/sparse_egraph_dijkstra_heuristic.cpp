@@ -58,6 +58,49 @@ auto SparseEGraphDijkstra3DHeuristic::Vector3iHash::operator()(
     return seed;
 }
 
+void SparseEGraphDijkstra3DHeuristic::OpenList::init(int max_edge_cost)
+{
+    // all queued distances lie within [min, min + max_edge_cost], so one
+    // bucket per possible edge cost suffices for the cyclic array
+    this->buckets.assign(max_edge_cost + 1, std::vector<Cell*>());
+    this->min = 0;
+    this->count = 0;
+}
+
+void SparseEGraphDijkstra3DHeuristic::OpenList::clear()
+{
+    for (auto& bucket : this->buckets) {
+        bucket.clear();
+    }
+    this->min = 0;
+    this->count = 0;
+}
+
+void SparseEGraphDijkstra3DHeuristic::OpenList::push(Cell* cell)
+{
+    this->buckets[cell->dist % this->buckets.size()].push_back(cell);
+    ++this->count;
+}
+
+auto SparseEGraphDijkstra3DHeuristic::OpenList::pop() -> Cell*
+{
+    while (this->count > 0) {
+        auto& bucket = this->buckets[this->min % this->buckets.size()];
+        if (bucket.empty()) {
+            ++this->min;
+            continue;
+        }
+        Cell* cell = bucket.back();
+        bucket.pop_back();
+        --this->count;
+        // skip stale entries from cells relaxed after this entry was queued
+        if (cell->dist == this->min) {
+            return cell;
+        }
+    }
+    return nullptr;
+}
+
 bool SparseEGraphDijkstra3DHeuristic::init(
     RobotPlanningSpace* space,
     const OccupancyGrid* grid)
@@ -72,7 +115,7 @@ bool SparseEGraphDijkstra3DHeuristic::init(
 
     m_grid = grid;
 
-    m_pp = space->getExtension<PointProjectionExtension>();
+    m_pp = pointProjection();
     m_eg = space->getExtension<ExperienceGraphExtension>();
 
     if (!m_pp) {
@@ -378,7 +421,19 @@ void SparseEGraphDijkstra3DHeuristic::updateGoal(const GoalConstraint& goal)
 
     dgp += Eigen::Vector3i::Ones();
 
-    m_open.clear();
+    // size the bucket queue to span the largest edge cost in the graph; the
+    // 26-connected neighbor costs are bounded by eps_E * sqrt(3), but the
+    // projected experience graph edges may connect arbitrarily distant cells
+    int max_edge_cost = (int)(m_eg_eps * 1000.0 * std::sqrt(3.0)) + 1;
+    for (auto& entry : m_heur_nodes) {
+        for (auto& adj : entry.second.edges) {
+            Eigen::Vector3i de = adj - entry.first;
+            int cost = (int)(1000.0 * std::sqrt((double)de.squaredNorm()));
+            max_edge_cost = std::max(max_edge_cost, cost);
+        }
+    }
+
+    m_open.init(max_edge_cost);
     Cell* c = &m_dist_grid(dgp.x(), dgp.y(), dgp.z());
     c->dist = 0;
     m_open.push(c);
@@ -569,9 +624,11 @@ int SparseEGraphDijkstra3DHeuristic::getGoalHeuristic(const Eigen::Vector3i& dp)
     int expand_count = 0;
     static int repeat_count = 1;
     while (cell->dist == Unknown && !m_open.empty()) {
+        Cell* curr_cell = m_open.pop();
+        if (curr_cell == nullptr) {
+            break;
+        }
         ++expand_count;
-        Cell* curr_cell = m_open.min();
-        m_open.pop();
 
         auto pit = m_open_cell_to_pos.find(curr_cell);
         assert(pit != end(m_open_cell_to_pos));
@@ -593,15 +650,10 @@ int SparseEGraphDijkstra3DHeuristic::getGoalHeuristic(const Eigen::Vector3i& dp)
                 int cost = (int)(1000.0 * std::sqrt((double)dp.squaredNorm()));
                 int new_cost = curr_cell->dist + cost;
                 if (new_cost < ncell->dist) {
+                    SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with egraph edge (-> %d)", adj.x(), adj.y(), adj.z(), new_cost);
                     ncell->dist = new_cost;
-                    if (m_open.contains(ncell)) {
-                        SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with egraph edge (-> %d)", adj.x(), adj.y(), adj.z(), new_cost);
-                        m_open.decrease(ncell);
-                    } else {
-                        SMPL_DEBUG_NAMED(LOG, "  Insert cell (%d, %d, %d) with egraph edge (-> %d)", adj.x(), adj.y(), adj.z(), new_cost);
-                        m_open.push(ncell);
-                        m_open_cell_to_pos[ncell] = adj;
-                    }
+                    m_open.push(ncell);
+                    m_open_cell_to_pos[ncell] = adj;
                 }
             }
         }
@@ -627,15 +679,10 @@ int SparseEGraphDijkstra3DHeuristic::getGoalHeuristic(const Eigen::Vector3i& dp)
             int new_cost = curr_cell->dist + cost;
 
             if (new_cost < ncell->dist) {
+                SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with normal edge (-> %d)", spos.x(), spos.y(), spos.z(), new_cost);
                 ncell->dist = new_cost;
-                if (m_open.contains(ncell)) {
-                    SMPL_DEBUG_NAMED(LOG, "  Update cell (%d, %d, %d) with normal edge (-> %d)", spos.x(), spos.y(), spos.z(), new_cost);
-                    m_open.decrease(ncell);
-                } else {
-                    SMPL_DEBUG_NAMED(LOG, "  Insert cell (%d, %d, %d) with normal edge (-> %d)", spos.x(), spos.y(), spos.z(), new_cost);
-                    m_open.push(ncell);
-                    m_open_cell_to_pos[ncell] = spos;
-                }
+                m_open.push(ncell);
+                m_open_cell_to_pos[ncell] = spos;
             }
         }
         }
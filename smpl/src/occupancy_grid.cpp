@@ -33,12 +33,14 @@
 #include <smpl/occupancy_grid.h>
 
 // standard includes
+#include <limits>
 #include <memory>
 
 // project includes
 #include <smpl/debug/marker_utils.h>
 #include <smpl/debug/colors.h>
 #include <smpl/distance_map/euclid_distance_map.h>
+#include <smpl/distance_map/sparse_distance_map.h>
 
 namespace smpl {
 
@@ -71,6 +73,7 @@ namespace smpl {
 OccupancyGrid::OccupancyGrid()
 {
     m_ref_counted = false;
+    m_buffer_updates = false;
     m_x_stride = 0;
     m_y_stride = 0;
 }
@@ -103,6 +106,7 @@ OccupancyGrid::OccupancyGrid(
             max_dist)),
     reference_frame_(),
     m_ref_counted(ref_counted),
+    m_buffer_updates(false),
     m_x_stride(m_grid->numCellsY() * m_grid->numCellsZ()),
     m_y_stride(m_grid->numCellsZ()),
     m_counts()
@@ -124,6 +128,7 @@ OccupancyGrid::OccupancyGrid(
     m_grid(df),
     reference_frame_(),
     m_ref_counted(ref_counted),
+    m_buffer_updates(false),
     m_x_stride(m_grid->numCellsY() * m_grid->numCellsZ()),
     m_y_stride(m_grid->numCellsZ()),
     m_counts()
@@ -137,6 +142,7 @@ OccupancyGrid::OccupancyGrid(const OccupancyGrid& o) :
     m_grid(o.m_grid->clone()),
     reference_frame_(o.reference_frame_),
     m_ref_counted(o.m_ref_counted),
+    m_buffer_updates(o.m_buffer_updates),
     m_x_stride(o.m_x_stride),
     m_y_stride(o.m_y_stride),
     m_counts(o.m_counts)
@@ -149,9 +155,23 @@ OccupancyGrid& OccupancyGrid::operator=(const OccupancyGrid& rhs)
         m_grid.reset(rhs.m_grid->clone());
         reference_frame_ = rhs.reference_frame_;
         m_ref_counted = rhs.m_ref_counted;
+        m_buffer_updates = rhs.m_buffer_updates;
         m_x_stride = rhs.m_x_stride;
         m_y_stride = rhs.m_y_stride;
         m_counts = rhs.m_counts;
+
+        // the published snapshot no longer reflects the map's contents
+        m_read_grid.reset();
+        m_pending_changes.clear();
+        m_pending_reset = false;
+
+        // recount the pyramid from the assigned map's contents
+        if (!m_pyramid.empty()) {
+            rebuildOccupancyPyramid();
+        }
+
+        // the counters are no longer aligned with the assigned map
+        m_query_counts = std::vector<std::atomic<std::uint32_t>>();
     }
     return *this;
 }
@@ -160,23 +180,80 @@ OccupancyGrid& OccupancyGrid::operator=(const OccupancyGrid& rhs)
 /// uninitialized values.
 void OccupancyGrid::reset()
 {
+    ++m_epoch;
     m_grid->reset();
+    if (m_read_grid != NULL) {
+        // a reset cannot be expressed as a change batch; flag it for replay
+        m_pending_changes.clear();
+        m_pending_reset = true;
+    }
     if (m_ref_counted) {
         m_counts.assign(getCellCount(), 0);
     }
+    if (!m_pyramid.empty()) {
+        std::fill(m_pyramid_occ.begin(), m_pyramid_occ.end(), 0);
+        for (auto& level : m_pyramid) {
+            std::fill(level.begin(), level.end(), 0);
+        }
+    }
 }
 
 /// Count the number of obstacles in the occupancy grid.
 size_t OccupancyGrid::getOccupiedVoxelCount() const
 {
     size_t count = 0;
+    iterateOccupiedVoxels([&](const Vector3&) { ++count; });
+    return count;
+}
+
+/// Stream the world-frame centers of all occupied voxels through a visitor.
+void OccupancyGrid::iterateOccupiedVoxels(
+    const std::function<void(const Vector3&)>& f) const
+{
+    auto* sparse = dynamic_cast<SparseDistanceMap*>(readGrid());
+    if (sparse != NULL) {
+        // walk the leaves of the sparse map's octree; free regions collapse
+        // to single leaves and are skipped without visiting their cells
+        auto max_x = (size_t)sparse->numCellsX();
+        auto max_y = (size_t)sparse->numCellsY();
+        auto max_z = (size_t)sparse->numCellsZ();
+        sparse->m_cells.accept_coords([&](
+            const SparseDistanceMap::Cell& c,
+            size_t first_x, size_t first_y, size_t first_z,
+            size_t last_x, size_t last_y, size_t last_z)
+        {
+            if (c.dist != 0) {
+                return; // free leaf
+            }
+
+            // the octree is padded out to a power of two; cells beyond the
+            // map bounds hold uninitialized values
+            last_x = std::min(last_x, max_x);
+            last_y = std::min(last_y, max_y);
+            last_z = std::min(last_z, max_z);
+
+            Vector3 p;
+            for (auto x = first_x; x < last_x; ++x) {
+            for (auto y = first_y; y < last_y; ++y) {
+            for (auto z = first_z; z < last_z; ++z) {
+                sparse->gridToWorld(
+                        (int)x, (int)y, (int)z, p.x(), p.y(), p.z());
+                f(p);
+            }
+            }
+            }
+        });
+        return;
+    }
+
     iterateCells([&](int x, int y, int z)
     {
-        if (m_grid->getCellDistance(x, y, z) <= 0.0) {
-            ++count;
+        if (readGrid()->getCellDistance(x, y, z) <= 0.0) {
+            Vector3 p;
+            m_grid->gridToWorld(x, y, z, p.x(), p.y(), p.z());
+            f(p);
         }
     });
-    return count;
 }
 
 /// Get all occupied voxels within an oriented cube region of the grid.
@@ -224,18 +301,48 @@ void OccupancyGrid::getOccupiedVoxels(
             });
 }
 
-/// Gather all the obstacle points in the occupancy grid.
+/// Gather all the obstacle points in the occupancy grid. Prefer
+/// iterateOccupiedVoxels() where the voxels are consumed one at a time; this
+/// materializes one point per obstacle cell.
 void OccupancyGrid::getOccupiedVoxels(
     std::vector<Vector3>& voxels) const
 {
-    iterateCells([&](int x, int y, int z)
-    {
-        if (m_grid->getCellDistance(x, y, z) <= 0.0) {
-            double wx, wy, wz;
-            m_grid->gridToWorld(x, y, z, wx, wy, wz);
-            voxels.emplace_back(wx, wy, wz);
-        }
-    });
+    iterateOccupiedVoxels([&](const Vector3& p) { voxels.push_back(p); });
+}
+
+/// Enable or disable query profiling. Enabling allocates one zeroed counter
+/// per aligned block of cells; disabling releases the counters, returning
+/// distance lookups to their unprofiled cost.
+void OccupancyGrid::setQueryProfiling(bool enable)
+{
+    if (!enable) {
+        m_query_counts = std::vector<std::atomic<std::uint32_t>>();
+        return;
+    }
+
+    m_query_blocks_x = (numCellsX() + QueryBlockEdge - 1) / QueryBlockEdge;
+    m_query_blocks_y = (numCellsY() + QueryBlockEdge - 1) / QueryBlockEdge;
+    m_query_blocks_z = (numCellsZ() + QueryBlockEdge - 1) / QueryBlockEdge;
+    const size_t num_blocks = (size_t)m_query_blocks_x *
+            (size_t)m_query_blocks_y * (size_t)m_query_blocks_z;
+    m_query_counts = std::vector<std::atomic<std::uint32_t>>(num_blocks);
+}
+
+/// Zero the recorded query counts, e.g. between planning episodes.
+void OccupancyGrid::resetQueryCounts()
+{
+    for (auto& count : m_query_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::uint32_t OccupancyGrid::getQueryCount(int x, int y, int z) const
+{
+    if (m_query_counts.empty() || !isInBounds(x, y, z)) {
+        return 0;
+    }
+    return m_query_counts[queryBlockIndex(x, y, z)].load(
+            std::memory_order_relaxed);
 }
 
 /// Return a visualization of the bounding box of the distance map.
@@ -324,7 +431,7 @@ auto OccupancyGrid::getDistanceFieldVisualization(double max_dist) const
     std::vector<visual::Color> colors;
     iterateCells([&](int x, int y, int z)
     {
-        const double d = m_grid->getCellDistance(x, y, z);
+        const double d = readGrid()->getCellDistance(x, y, z);
         if (d >= min_value && d <= max_value) {
             Vector3 p;
             m_grid->gridToWorld(x, y, z, p.x(), p.y(), p.z());
@@ -346,8 +453,11 @@ auto OccupancyGrid::getDistanceFieldVisualization(double max_dist) const
 /// Return a visualization of the obstacle cells stored in the distance map.
 auto OccupancyGrid::getOccupiedVoxelsVisualization() const -> visual::Marker
 {
+    // the marker needs the points materialized, but counting first sizes the
+    // single allocation exactly instead of growing it through reallocations
     std::vector<Vector3> voxels;
-    getOccupiedVoxels(voxels);
+    voxels.reserve(getOccupiedVoxelCount());
+    iterateOccupiedVoxels([&](const Vector3& p) { voxels.push_back(p); });
 
     return MakeCubesMarker(
             std::move(voxels),
@@ -357,10 +467,58 @@ auto OccupancyGrid::getOccupiedVoxelsVisualization() const -> visual::Marker
             "occupied_voxels");
 }
 
+/// Return a visualization of the recorded query counts: one cube per queried
+/// block, colored by its share of the maximum block count.
+auto OccupancyGrid::getQueryHeatmapVisualization() const -> visual::Marker
+{
+    std::uint32_t max_count = 0;
+    for (auto& count : m_query_counts) {
+        max_count = std::max(
+                max_count, count.load(std::memory_order_relaxed));
+    }
+
+    std::vector<Vector3> points;
+    std::vector<visual::Color> colors;
+    if (max_count > 0) {
+        for (int bx = 0; bx < m_query_blocks_x; ++bx) {
+        for (int by = 0; by < m_query_blocks_y; ++by) {
+        for (int bz = 0; bz < m_query_blocks_z; ++bz) {
+            const int bidx =
+                    (bx * m_query_blocks_y + by) * m_query_blocks_z + bz;
+            const std::uint32_t count =
+                    m_query_counts[bidx].load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+
+            Vector3 p;
+            m_grid->gridToWorld(
+                    bx * QueryBlockEdge + QueryBlockEdge / 2,
+                    by * QueryBlockEdge + QueryBlockEdge / 2,
+                    bz * QueryBlockEdge + QueryBlockEdge / 2,
+                    p.x(), p.y(), p.z());
+            points.push_back(p);
+
+            const double alpha = (double)count / (double)max_count;
+            colors.push_back(visual::MakeColorHSV(240.0 - alpha * 240.0));
+        }
+        }
+        }
+    }
+
+    return MakeCubesMarker(
+            std::move(points),
+            QueryBlockEdge * m_grid->resolution(),
+            std::move(colors),
+            getReferenceFrame(),
+            "query_heatmap");
+}
+
 /// Add a set of obstacle cells to the occupancy grid.
 void OccupancyGrid::addPointsToField(
     const std::vector<Vector3>& points)
 {
+    ++m_epoch;
     if (m_ref_counted) {
         std::vector<Vector3> pts;
         pts.reserve(points.size());
@@ -378,17 +536,75 @@ void OccupancyGrid::addPointsToField(
                 ++m_counts[idx];
             }
         }
-        m_grid->addPointsToMap(pts);
+        if (m_buffer_updates) {
+            m_grid->bufferPointsToMap(pts);
+        } else {
+            m_grid->addPointsToMap(pts);
+        }
+        notifyChanges(pts, true);
+        return;
     }
-    else {
+
+    if (m_buffer_updates) {
+        m_grid->bufferPointsToMap(points);
+    } else {
         m_grid->addPointsToMap(points);
     }
+    notifyChanges(points, true);
+}
+
+/// Add a set of obstacle cells to the occupancy grid from a strided view over
+/// a raw point buffer, e.g. the data array of a sensor_msgs::PointCloud2. Each
+/// point is read as three consecutive floats beginning every \p stride bytes.
+/// Invalid (NaN) and out-of-bounds points are skipped. Points are converted
+/// directly into the batch handed to the distance map, avoiding an
+/// intermediate copy of the input cloud.
+void OccupancyGrid::addPointsToField(
+    const float* points,
+    size_t count,
+    size_t stride)
+{
+    ++m_epoch;
+
+    std::vector<Vector3> pts;
+    pts.reserve(count);
+
+    const char* data = reinterpret_cast<const char*>(points);
+    int gx, gy, gz;
+    for (size_t i = 0; i < count; ++i, data += stride) {
+        const float* p = reinterpret_cast<const float*>(data);
+        if (p[0] != p[0] || p[1] != p[1] || p[2] != p[2]) {
+            continue; // invalid sensor return
+        }
+
+        worldToGrid((double)p[0], (double)p[1], (double)p[2], gx, gy, gz);
+        if (!isInBounds(gx, gy, gz)) {
+            continue;
+        }
+
+        if (m_ref_counted) {
+            const int idx = coordToIndex(gx, gy, gz);
+            if (m_counts[idx]++ > 0) {
+                continue;
+            }
+        }
+
+        pts.emplace_back((double)p[0], (double)p[1], (double)p[2]);
+    }
+
+    if (m_buffer_updates) {
+        m_grid->bufferPointsToMap(pts);
+    } else {
+        m_grid->addPointsToMap(pts);
+    }
+    notifyChanges(pts, true);
 }
 
 /// Remove a set of obstacle cells from the occupancy grid.
 void OccupancyGrid::removePointsFromField(
     const std::vector<Vector3>& points)
 {
+    ++m_epoch;
     if (m_ref_counted) {
         std::vector<Vector3> pts;
         pts.reserve(points.size());
@@ -407,11 +623,21 @@ void OccupancyGrid::removePointsFromField(
                 }
             }
         }
-        m_grid->removePointsFromMap(pts);
+        if (m_buffer_updates) {
+            m_grid->bufferPointsFromMap(pts);
+        } else {
+            m_grid->removePointsFromMap(pts);
+        }
+        notifyChanges(pts, false);
+        return;
     }
-    else {
+
+    if (m_buffer_updates) {
+        m_grid->bufferPointsFromMap(points);
+    } else {
         m_grid->removePointsFromMap(points);
     }
+    notifyChanges(points, false);
 }
 
 /// Update the occupancy grid, removing obstacles that exist in the old obstacle
@@ -421,8 +647,388 @@ void OccupancyGrid::updatePointsInField(
     const std::vector<Vector3>& old_points,
     const std::vector<Vector3>& new_points)
 {
+    ++m_epoch;
+
     // TODO: ref counting
     m_grid->updatePointsInMap(old_points, new_points);
+
+    // conservative: points common to both sets are reported twice
+    notifyChanges(old_points, false);
+    notifyChanges(new_points, true);
+}
+
+void OccupancyGrid::setDoubleBuffered(bool enable)
+{
+    if (enable == (m_read_grid != NULL)) {
+        return;
+    }
+
+    if (enable) {
+        std::atomic_store(
+                &m_read_grid,
+                std::shared_ptr<DistanceMapInterface>(m_grid->clone()));
+    } else {
+        std::atomic_store(&m_read_grid, std::shared_ptr<DistanceMapInterface>());
+        m_pending_changes.clear();
+        m_pending_reset = false;
+    }
+}
+
+void OccupancyGrid::publishUpdates()
+{
+    if (m_read_grid == NULL) {
+        return;
+    }
+
+    if (m_buffer_updates) {
+        m_grid->flushUpdates();
+    }
+
+    // swap roles: the write map becomes the published snapshot and the old
+    // snapshot becomes the write map
+    auto read = m_read_grid;
+    std::atomic_store(&m_read_grid, m_grid);
+    m_grid = read;
+
+    // catch the new write map up with everything applied to the published
+    // map since the last publication
+    if (m_pending_reset) {
+        m_grid->reset();
+        m_pending_reset = false;
+    }
+    for (auto& change : m_pending_changes) {
+        if (change.second) {
+            m_grid->addPointsToMap(change.first);
+        } else {
+            m_grid->removePointsFromMap(change.first);
+        }
+    }
+    m_pending_changes.clear();
+}
+
+auto OccupancyGrid::getReadDistanceField() const
+    -> std::shared_ptr<const DistanceMapInterface>
+{
+    auto read = std::atomic_load(&m_read_grid);
+    if (read != NULL) {
+        return read;
+    }
+    return m_grid;
+}
+
+void OccupancyGrid::enableOccupancyPyramid(bool enable)
+{
+    if (enable) {
+        rebuildOccupancyPyramid();
+    } else {
+        m_pyramid_occ.clear();
+        m_pyramid.clear();
+    }
+}
+
+bool OccupancyGrid::isRegionFree(
+    int xmin, int ymin, int zmin,
+    int xmax, int ymax, int zmax) const
+{
+    xmin = std::max(xmin, 0);
+    ymin = std::max(ymin, 0);
+    zmin = std::max(zmin, 0);
+    xmax = std::min(xmax, numCellsX() - 1);
+    ymax = std::min(ymax, numCellsY() - 1);
+    zmax = std::min(zmax, numCellsZ() - 1);
+    if (xmin > xmax || ymin > ymax || zmin > zmax) {
+        return true;
+    }
+
+    if (m_pyramid.empty()) {
+        for (int x = xmin; x <= xmax; ++x) {
+        for (int y = ymin; y <= ymax; ++y) {
+        for (int z = zmin; z <= zmax; ++z) {
+            if (m_grid->getCellDistance(x, y, z) <= 0.0) {
+                return false;
+            }
+        }
+        }
+        }
+        return true;
+    }
+
+    return pyramidRegionFree(
+            (int)m_pyramid.size() - 1, xmin, ymin, zmin, xmax, ymax, zmax);
+}
+
+bool OccupancyGrid::isRegionOccupied(
+    int xmin, int ymin, int zmin,
+    int xmax, int ymax, int zmax) const
+{
+    xmin = std::max(xmin, 0);
+    ymin = std::max(ymin, 0);
+    zmin = std::max(zmin, 0);
+    xmax = std::min(xmax, numCellsX() - 1);
+    ymax = std::min(ymax, numCellsY() - 1);
+    zmax = std::min(zmax, numCellsZ() - 1);
+    if (xmin > xmax || ymin > ymax || zmin > zmax) {
+        return true;
+    }
+
+    if (m_pyramid.empty()) {
+        for (int x = xmin; x <= xmax; ++x) {
+        for (int y = ymin; y <= ymax; ++y) {
+        for (int z = zmin; z <= zmax; ++z) {
+            if (m_grid->getCellDistance(x, y, z) > 0.0) {
+                return false;
+            }
+        }
+        }
+        }
+        return true;
+    }
+
+    return pyramidRegionOccupied(
+            (int)m_pyramid.size() - 1, xmin, ymin, zmin, xmax, ymax, zmax);
+}
+
+int OccupancyGrid::addChangeCallback(const ChangeCallback& callback) const
+{
+    auto handle = m_next_change_callback_handle++;
+    m_change_callbacks.emplace_back(handle, callback);
+    return handle;
+}
+
+void OccupancyGrid::removeChangeCallback(int handle) const
+{
+    auto match = [handle](const std::pair<int, ChangeCallback>& entry) {
+        return entry.first == handle;
+    };
+    m_change_callbacks.erase(
+            std::remove_if(
+                    m_change_callbacks.begin(),
+                    m_change_callbacks.end(),
+                    match),
+            m_change_callbacks.end());
+}
+
+// Report a batch of occupancy changes to the registered callbacks, along with
+// the cell-space bounding box of the changed points.
+void OccupancyGrid::notifyChanges(
+    const std::vector<Vector3>& points,
+    bool added)
+{
+    if (points.empty()) {
+        return;
+    }
+
+    if (m_read_grid != NULL) {
+        m_pending_changes.emplace_back(points, added);
+    }
+
+    if (!m_pyramid.empty()) {
+        int gx, gy, gz;
+        for (const Vector3& v : points) {
+            worldToGrid(v.x(), v.y(), v.z(), gx, gy, gz);
+            if (isInBounds(gx, gy, gz)) {
+                updatePyramidCell(gx, gy, gz, added);
+            }
+        }
+    }
+
+    if (m_change_callbacks.empty()) {
+        return;
+    }
+
+    OccupancyChanges changes;
+    changes.added = added;
+    changes.points = points;
+    for (int i = 0; i < 3; ++i) {
+        changes.min_cell[i] = std::numeric_limits<int>::max();
+        changes.max_cell[i] = std::numeric_limits<int>::min();
+    }
+
+    int gx, gy, gz;
+    for (const Vector3& v : points) {
+        worldToGrid(v.x(), v.y(), v.z(), gx, gy, gz);
+        if (!isInBounds(gx, gy, gz)) {
+            continue;
+        }
+        changes.min_cell[0] = std::min(changes.min_cell[0], gx);
+        changes.min_cell[1] = std::min(changes.min_cell[1], gy);
+        changes.min_cell[2] = std::min(changes.min_cell[2], gz);
+        changes.max_cell[0] = std::max(changes.max_cell[0], gx);
+        changes.max_cell[1] = std::max(changes.max_cell[1], gy);
+        changes.max_cell[2] = std::max(changes.max_cell[2], gz);
+    }
+
+    for (auto& entry : m_change_callbacks) {
+        entry.second(changes);
+    }
+}
+
+// Size the pyramid levels for the current grid dimensions and recount
+// occupancy from the write map. Each level halves the resolution of the
+// previous; the coarsest level covers the grid with a single block.
+void OccupancyGrid::rebuildOccupancyPyramid()
+{
+    const int cx = numCellsX();
+    const int cy = numCellsY();
+    const int cz = numCellsZ();
+    const int max_dim = std::max(cx, std::max(cy, cz));
+
+    m_pyramid_occ.assign((size_t)cx * cy * cz, 0);
+    m_pyramid.clear();
+    for (int s = 2; s < 2 * max_dim; s <<= 1) {
+        const size_t lx = (cx + s - 1) / s;
+        const size_t ly = (cy + s - 1) / s;
+        const size_t lz = (cz + s - 1) / s;
+        m_pyramid.emplace_back(lx * ly * lz, 0);
+    }
+
+    iterateCells([&](int x, int y, int z)
+    {
+        if (m_grid->getCellDistance(x, y, z) <= 0.0) {
+            m_pyramid_occ[coordToIndex(x, y, z)] = 1;
+            for (size_t l = 0; l < m_pyramid.size(); ++l) {
+                ++m_pyramid[l][pyramidIndex((int)l, x, y, z)];
+            }
+        }
+    });
+}
+
+// Reconcile the pyramid with a reported occupancy change at one cell,
+// adjusting the block counts at every level. Redundant reports for a cell
+// already in the reported state are ignored.
+void OccupancyGrid::updatePyramidCell(int x, int y, int z, bool occupied)
+{
+    const std::uint8_t occ = occupied ? 1 : 0;
+    auto& cell = m_pyramid_occ[coordToIndex(x, y, z)];
+    if (cell == occ) {
+        return;
+    }
+    cell = occ;
+    for (size_t l = 0; l < m_pyramid.size(); ++l) {
+        auto& count = m_pyramid[l][pyramidIndex((int)l, x, y, z)];
+        if (occupied) {
+            ++count;
+        } else {
+            --count;
+        }
+    }
+}
+
+int OccupancyGrid::pyramidIndex(int level, int x, int y, int z) const
+{
+    const int s = 2 << level;
+    const int ly = (numCellsY() + s - 1) / s;
+    const int lz = (numCellsZ() + s - 1) / s;
+    return ((x / s) * ly + (y / s)) * lz + (z / s);
+}
+
+// Return true if no cell in the region is occupied, descending only into
+// blocks that overlap the region boundary and contain occupied cells.
+bool OccupancyGrid::pyramidRegionFree(
+    int level,
+    int xmin, int ymin, int zmin,
+    int xmax, int ymax, int zmax) const
+{
+    if (level < 0) {
+        for (int x = xmin; x <= xmax; ++x) {
+        for (int y = ymin; y <= ymax; ++y) {
+        for (int z = zmin; z <= zmax; ++z) {
+            if (m_pyramid_occ[coordToIndex(x, y, z)]) {
+                return false;
+            }
+        }
+        }
+        }
+        return true;
+    }
+
+    const int s = 2 << level;
+    for (int bx = xmin / s; bx <= xmax / s; ++bx) {
+    for (int by = ymin / s; by <= ymax / s; ++by) {
+    for (int bz = zmin / s; bz <= zmax / s; ++bz) {
+        if (m_pyramid[level][pyramidIndex(level, bx * s, by * s, bz * s)] == 0) {
+            continue;
+        }
+
+        if (bx * s >= xmin && (bx + 1) * s - 1 <= xmax &&
+            by * s >= ymin && (by + 1) * s - 1 <= ymax &&
+            bz * s >= zmin && (bz + 1) * s - 1 <= zmax)
+        {
+            // the block lies within the region, so its occupied cells do too
+            return false;
+        }
+
+        if (!pyramidRegionFree(
+                level - 1,
+                std::max(xmin, bx * s),
+                std::max(ymin, by * s),
+                std::max(zmin, bz * s),
+                std::min(xmax, (bx + 1) * s - 1),
+                std::min(ymax, (by + 1) * s - 1),
+                std::min(zmax, (bz + 1) * s - 1)))
+        {
+            return false;
+        }
+    }
+    }
+    }
+    return true;
+}
+
+// Return true if every cell in the region is occupied, descending only into
+// blocks that are partially occupied.
+bool OccupancyGrid::pyramidRegionOccupied(
+    int level,
+    int xmin, int ymin, int zmin,
+    int xmax, int ymax, int zmax) const
+{
+    if (level < 0) {
+        for (int x = xmin; x <= xmax; ++x) {
+        for (int y = ymin; y <= ymax; ++y) {
+        for (int z = zmin; z <= zmax; ++z) {
+            if (!m_pyramid_occ[coordToIndex(x, y, z)]) {
+                return false;
+            }
+        }
+        }
+        }
+        return true;
+    }
+
+    const int s = 2 << level;
+    for (int bx = xmin / s; bx <= xmax / s; ++bx) {
+    for (int by = ymin / s; by <= ymax / s; ++by) {
+    for (int bz = zmin / s; bz <= zmax / s; ++bz) {
+        const auto count =
+                m_pyramid[level][pyramidIndex(level, bx * s, by * s, bz * s)];
+        if (count == 0) {
+            return false;
+        }
+
+        // the block's in-bounds volume, clipped at the grid boundary
+        const std::uint32_t vol =
+                (std::uint32_t)std::min(s, numCellsX() - bx * s) *
+                (std::uint32_t)std::min(s, numCellsY() - by * s) *
+                (std::uint32_t)std::min(s, numCellsZ() - bz * s);
+        if (count == vol) {
+            continue; // the block is entirely occupied
+        }
+
+        if (!pyramidRegionOccupied(
+                level - 1,
+                std::max(xmin, bx * s),
+                std::max(ymin, by * s),
+                std::max(zmin, bz * s),
+                std::min(xmax, (bx + 1) * s - 1),
+                std::min(ymax, (by + 1) * s - 1),
+                std::min(zmax, (bz + 1) * s - 1)))
+        {
+            return false;
+        }
+    }
+    }
+    }
+    return true;
 }
 
 void OccupancyGrid::initRefCounts()
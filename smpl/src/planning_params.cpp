@@ -61,6 +61,7 @@ PlanningParams::PlanningParams() :
 
     shortcut_path(DefaultShortcutPath),
     interpolate_path(DefaultInterpolatePath),
+    profile_accelerations(DefaultProfileAccelerations),
     shortcut_type(DefaultShortcutType),
 
     m_warn_defaults(false)
@@ -78,21 +79,25 @@ std::string construct_warn_string(const std::string& name, T def)
 void PlanningParams::addParam(const std::string& name, bool val)
 {
     params[name] = val;
+    parameterChanged(name);
 }
 
 void PlanningParams::addParam(const std::string& name, int val)
 {
     params[name] = val;
+    parameterChanged(name);
 }
 
 void PlanningParams::addParam(const std::string& name, double val)
 {
     params[name] = val;
+    parameterChanged(name);
 }
 
 void PlanningParams::addParam(const std::string& name, const std::string& val)
 {
     params[name] = val;
+    parameterChanged(name);
 }
 
 void PlanningParams::param(const std::string& name, bool& val, bool def) const
@@ -204,6 +209,82 @@ bool PlanningParams::hasParam(const std::string& name) const
     return it != params.end();
 }
 
+const CompiledConfig& PlanningParams::compiled() const
+{
+    if (!m_compiled_dirty) {
+        return m_compiled;
+    }
+
+    // start from the documented defaults
+    m_compiled = CompiledConfig();
+
+    GraphConfig& g = m_compiled.graph;
+    g.has_discretization = getParam("discretization", g.discretization);
+    g.has_mprim_filename = getParam("mprim_filename", g.mprim_filename);
+    g.has_egraph_path = getParam("egraph_path", g.egraph_path);
+    // quiet getParam() fills; the struct members already hold the defaults
+    getParam("use_multiple_ik_solutions", g.use_multiple_ik_solutions);
+    getParam("use_xyz_snap_mprim", g.use_xyz_snap_mprim);
+    getParam("use_rpy_snap_mprim", g.use_rpy_snap_mprim);
+    getParam("use_xyzrpy_snap_mprim", g.use_xyzrpy_snap_mprim);
+    getParam("use_short_dist_mprims", g.use_short_dist_mprims);
+    getParam("use_action_tiers", g.use_action_tiers);
+    getParam("xyz_snap_dist_thresh", g.xyz_snap_thresh);
+    getParam("rpy_snap_dist_thresh", g.rpy_snap_thresh);
+    getParam("xyzrpy_snap_dist_thresh", g.xyzrpy_snap_thresh);
+    getParam("short_dist_mprims_thresh", g.short_dist_mprims_thresh);
+
+    HeuristicConfig& h = m_compiled.heuristic;
+    getParam("bfs_inflation_radius", h.bfs_inflation_radius);
+    getParam("bfs_store_capacity", h.bfs_store_capacity);
+    getParam("offset_x", h.offset_x);
+    getParam("offset_y", h.offset_y);
+    getParam("offset_z", h.offset_z);
+    getParam("x_coeff", h.x_coeff);
+    getParam("y_coeff", h.y_coeff);
+    getParam("z_coeff", h.z_coeff);
+    getParam("rot_coeff", h.rot_coeff);
+    getParam("egraph_epsilon", h.egraph_epsilon);
+
+    SearchConfig& s = m_compiled.search;
+    getParam("epsilon", s.epsilon);
+    getParam("epsilon_mha", s.epsilon_mha);
+    getParam("epsilon_plan", s.epsilon_plan);
+    getParam("epsilon_track", s.epsilon_track);
+    getParam("search_mode", s.search_mode);
+    s.has_allow_partial_solutions =
+            getParam("allow_partial_solutions", s.allow_partial_solutions);
+    s.has_target_epsilon = getParam("target_epsilon", s.target_epsilon);
+    s.has_delta_epsilon = getParam("delta_epsilon", s.delta_epsilon);
+    s.has_improve_solution = getParam("improve_solution", s.improve_solution);
+    s.has_bound_expansions = getParam("bound_expansions", s.bound_expansions);
+    s.has_repair_time = getParam("repair_time", s.repair_time);
+    s.has_reuse_search_tree =
+            getParam("reuse_search_tree", s.reuse_search_tree);
+    s.has_memory_budget_mb = getParam("memory_budget_mb", s.memory_budget_mb);
+    s.has_cost_bound = getParam("cost_bound", s.cost_bound);
+
+    m_compiled_dirty = false;
+    return m_compiled;
+}
+
+void PlanningParams::subscribe(
+    const std::string& name,
+    std::function<void()> callback)
+{
+    m_subscribers.emplace_back(name, std::move(callback));
+}
+
+void PlanningParams::parameterChanged(const std::string& name)
+{
+    m_compiled_dirty = true;
+    for (const auto& sub : m_subscribers) {
+        if (sub.first == name) {
+            sub.second();
+        }
+    }
+}
+
 void PlanningParams::convertToBool(const Parameter& p, bool& val) const
 {
     struct bool_converter : public boost::static_visitor<bool> {
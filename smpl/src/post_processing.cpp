@@ -33,8 +33,11 @@
 #include <smpl/post_processing.h>
 
 // standard includes
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <numeric>
+#include <thread>
 
 // project includes
 #include <smpl/angles.h>
@@ -355,6 +358,193 @@ void ShortcutPath(
     SMPL_INFO("Shortcutted path: waypount_count: %zu, cost: %0.3f", pout.size(), next_cost);
 }
 
+// Shortcut a waypoint path by evaluating candidate shortcuts in parallel
+// rounds. Each round proposes candidate (start, end) waypoint pairs at
+// geometrically decreasing spans, evaluates all candidates concurrently
+// (each thread drives its own generator instance, so only the collision
+// checker is shared between threads), and greedily commits the
+// non-overlapping candidates with the greatest savings. Repeats until a
+// round commits nothing.
+template <typename Generator, typename CostsFn>
+static void ParallelShortcutPoints(
+    RobotModel* rm,
+    CollisionChecker* cc,
+    std::vector<RobotState>& path,
+    const CostsFn& compute_costs,
+    int num_threads)
+{
+    struct Candidate
+    {
+        size_t first;   // index of the first waypoint, inclusive
+        size_t last;    // index of the last waypoint, inclusive
+        bool valid;
+        double savings;
+        std::vector<RobotState> pts;
+    };
+
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+    }
+    if (num_threads <= 0) {
+        num_threads = 1;
+    }
+
+    std::vector<double> costs;
+    compute_costs(path, costs);
+
+    while (path.size() > 2) {
+        // propose candidate shortcuts between waypoint pairs, widest first
+        std::vector<Candidate> candidates;
+        for (size_t span = path.size() - 1; span >= 2; span >>= 1) {
+            for (size_t i = 0; i + span < path.size(); i += span) {
+                Candidate c;
+                c.first = i;
+                c.last = i + span;
+                c.valid = false;
+                c.savings = 0.0;
+                candidates.push_back(std::move(c));
+            }
+        }
+
+        // evaluate all candidates concurrently
+        std::atomic<size_t> next(0);
+        auto evaluate = [&]() {
+            Generator gen(rm, cc);
+            size_t k;
+            while ((k = next.fetch_add(1)) < candidates.size()) {
+                Candidate& c = candidates[k];
+                std::vector<RobotState> pts;
+                double cost;
+                if (!gen(path[c.first], path[c.last],
+                        std::back_inserter(pts), cost))
+                {
+                    continue;
+                }
+                const double orig_cost = std::accumulate(
+                        costs.begin() + c.first, costs.begin() + c.last, 0.0);
+                if (cost < orig_cost) {
+                    c.valid = true;
+                    c.savings = orig_cost - cost;
+                    c.pts = std::move(pts);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads - 1);
+        for (int i = 1; i < num_threads; ++i) {
+            threads.emplace_back(evaluate);
+        }
+        evaluate();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        // commit non-overlapping winners, greatest savings first; shortcuts
+        // may share an endpoint waypoint but not interior waypoints
+        std::vector<Candidate*> winners;
+        for (Candidate& c : candidates) {
+            if (c.valid) {
+                winners.push_back(&c);
+            }
+        }
+        std::sort(winners.begin(), winners.end(),
+                [](const Candidate* a, const Candidate* b) {
+                    return a->savings > b->savings;
+                });
+
+        std::vector<Candidate*> accepted;
+        for (Candidate* c : winners) {
+            auto overlaps = [&](const Candidate* a) {
+                return c->first < a->last && a->first < c->last;
+            };
+            if (std::none_of(accepted.begin(), accepted.end(), overlaps)) {
+                accepted.push_back(c);
+            }
+        }
+
+        if (accepted.empty()) {
+            break;
+        }
+
+        // splice from the back so earlier indices stay valid
+        std::sort(accepted.begin(), accepted.end(),
+                [](const Candidate* a, const Candidate* b) {
+                    return a->first > b->first;
+                });
+        for (Candidate* c : accepted) {
+            path.erase(path.begin() + c->first, path.begin() + c->last + 1);
+            path.insert(
+                    path.begin() + c->first,
+                    std::make_move_iterator(c->pts.begin()),
+                    std::make_move_iterator(c->pts.end()));
+        }
+
+        compute_costs(path, costs);
+    }
+}
+
+void ShortcutPathParallel(
+    RobotModel* rm,
+    CollisionChecker* cc,
+    const std::vector<RobotState>& pin,
+    std::vector<RobotState>& pout,
+    ShortcutType type,
+    int num_threads)
+{
+    if (pin.size() < 2) {
+        pout = pin;
+        return;
+    }
+
+    auto then = clock::now();
+
+    auto position_costs = [rm](
+        const std::vector<RobotState>& path, std::vector<double>& costs)
+    {
+        ComputePositionPathCosts(rm, path, costs);
+    };
+
+    switch (type) {
+    case ShortcutType::JOINT_SPACE:
+    {
+        pout = pin;
+        ParallelShortcutPoints<JointPositionShortcutPathGenerator>(
+                rm, cc, pout, position_costs, num_threads);
+    }   break;
+    case ShortcutType::EUCLID_SPACE:
+    {
+        pout = pin;
+        ParallelShortcutPoints<EuclidShortcutPathGenerator>(
+                rm, cc, pout, position_costs, num_threads);
+    }   break;
+    case ShortcutType::JOINT_POSITION_VELOCITY_SPACE:
+    {
+        std::vector<RobotState> pv_path;
+        CreatePositionVelocityPath(rm, pin, pv_path);
+
+        auto pv_costs = [rm](
+            const std::vector<RobotState>& path, std::vector<double>& costs)
+        {
+            ComputePositionVelocityPathCosts(rm, path, costs);
+        };
+
+        ParallelShortcutPoints<JointPositionVelocityShortcutPathGenerator>(
+                rm, cc, pv_path, pv_costs, num_threads);
+
+        ExtractPositionPath(rm, pv_path, pout);
+    }   break;
+    default:
+        pout = pin;
+        break;
+    }
+
+    auto now = clock::now();
+    SMPL_INFO("Parallel path shortcutting took %0.3f seconds", std::chrono::duration<double>(now - then).count());
+    SMPL_INFO("Original path: waypoint count: %zu", pin.size());
+    SMPL_INFO("Shortcutted path: waypoint count: %zu", pout.size());
+}
+
 bool CreatePositionVelocityPath(
     RobotModel* rm,
     const std::vector<RobotState>& path,
@@ -441,6 +631,20 @@ bool ComputePositionVelocityPathCosts(
 
 bool InterpolatePath(CollisionChecker& cc, std::vector<RobotState>& path)
 {
+    PathMatrix opath;
+    if (!InterpolatePath(cc, path, opath)) {
+        return false;
+    }
+    opath.extract_path(path);
+    return true;
+}
+
+bool InterpolatePath(
+    CollisionChecker& cc,
+    const std::vector<RobotState>& path,
+    PathMatrix& opath)
+{
+    opath.init(path.empty() ? 0 : path.front().size());
     if (path.empty()) {
         return true;
     }
@@ -453,11 +657,15 @@ bool InterpolatePath(CollisionChecker& cc, std::vector<RobotState>& path)
         }
     }
 
-    std::vector<RobotState> opath;
+    opath.reserve(path.size());
 
     // tack on the first point of the trajectory
     opath.push_back(path.front());
 
+    // segment buffer, reused between segments so that interpolating each
+    // segment does not reallocate its waypoints
+    std::vector<RobotState> ipath;
+
     // iterate over path segments
     for (auto i = size_t(0); i < path.size() - 1; ++i) {
         auto& curr = path[i];
@@ -465,7 +673,7 @@ bool InterpolatePath(CollisionChecker& cc, std::vector<RobotState>& path)
 
         SMPL_DEBUG_STREAM("Interpolating between " << curr << " and " << next);
 
-        std::vector<RobotState> ipath;
+        ipath.clear();
         if (!cc.interpolatePath(curr, next, ipath)) {
             SMPL_ERROR("Failed to interpolate between waypoint %zu and %zu because it's infeasible given the limits.", i, i + 1);
             return false;
@@ -487,17 +695,16 @@ bool InterpolatePath(CollisionChecker& cc, std::vector<RobotState>& path)
             continue;
         }
 
-        if (!ipath.empty()) {
-            // concatenate current path and the intermediate path (we already
-            // have the first waypoint in the path from last iteration)
-            opath.insert(end(opath), std::next(begin(ipath)), end(ipath));
+        // concatenate current path and the intermediate path (we already
+        // have the first waypoint in the path from last iteration)
+        for (auto j = size_t(1); j < ipath.size(); ++j) {
+            opath.push_back(ipath[j]);
         }
 
         SMPL_DEBUG("[%zu] path length: %zu", i, opath.size());
     }
 
     SMPL_INFO("Original path length: %zu   Interpolated path length: %zu", path.size(), opath.size());
-    path = std::move(opath);
     return true;
 }
 
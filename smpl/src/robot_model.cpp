@@ -80,8 +80,44 @@ ForwardKinematicsInterface::~ForwardKinematicsInterface()
 {
 }
 
+void ForwardKinematicsInterface::computeFKBatch(
+    const std::vector<RobotState>& states,
+    std::vector<Affine3, Eigen::aligned_allocator<Affine3>>& poses)
+{
+    poses.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        poses[i] = computeFK(states[i]);
+    }
+}
+
 InverseKinematicsInterface::~InverseKinematicsInterface()
 {
 }
 
+int InverseKinematicsInterface::computeIKBatch(
+    const Affine3* poses,
+    const RobotState* seeds,
+    int count,
+    std::vector<RobotState>& solutions,
+    std::vector<bool>& valid,
+    bool first_success,
+    ik_option::IkOption option)
+{
+    solutions.resize(count);
+    valid.assign(count, false);
+    auto result = -1;
+    for (auto i = 0; i < count; ++i) {
+        if (computeIK(poses[i], seeds[i], solutions[i], option)) {
+            valid[i] = true;
+            if (result == -1) {
+                result = i;
+            }
+            if (first_success) {
+                break;
+            }
+        }
+    }
+    return result;
+}
+
 } // namespace smpl
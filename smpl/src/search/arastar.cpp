@@ -32,11 +32,16 @@
 #include <smpl/search/arastar.h>
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 // system includes
 #include <sbpl/utils/key.h>
 
 // project includes
+#include <smpl/thread_pool.h>
 #include <smpl/time.h>
 #include <smpl/console/console.h>
 
@@ -45,6 +50,28 @@ namespace smpl {
 static const char* SLOG = "search";
 static const char* SELOG = "search.expansions";
 
+// minimum number of states before recomputeHeuristics() and reorderOpen()
+// fan their updates across the expansion threads
+static const size_t MinParallelReorderStates = 16384;
+
+// Apply \p f, a callable over an index range, to [0, count), scheduled on
+// the shared thread pool when parallelism is requested and the range is
+// large enough to amortize the handoff.
+template <typename RangeFunction>
+static void ForEachIndexRange(size_t count, int num_threads, RangeFunction f)
+{
+    if (num_threads <= 1 || count < MinParallelReorderStates) {
+        f((size_t)0, count);
+        return;
+    }
+
+    auto* pool = GetDefaultThreadPool();
+    const size_t grain = std::max(
+            MinParallelReorderStates / 16,
+            count / (size_t)(4 * pool->numThreads()));
+    pool->forEachRange((size_t)0, count, grain, f);
+}
+
 ARAStar::ARAStar(
     DiscreteSpaceInformation* space,
     Heuristic* heur)
@@ -57,6 +84,9 @@ ARAStar::ARAStar(
     m_final_eps(1.0),
     m_delta_eps(1.0),
     m_allow_partial_solutions(false),
+    m_on_improved_solution(),
+    m_stats(nullptr),
+    m_trace(nullptr),
     m_states(),
     m_start_state_id(-1),
     m_goal_state_id(-1),
@@ -64,6 +94,12 @@ ARAStar::ARAStar(
     m_incons(),
     m_curr_eps(1.0),
     m_iteration(1),
+    m_parallel_expansions(false),
+    m_num_expansion_threads(1),
+    m_partial_expansions(false),
+    m_pipelined_expansions(false),
+    m_reuse_search_tree(false),
+    m_goal_changed(false),
     m_call_number(0),
     m_last_start_state_id(-1),
     m_last_goal_state_id(-1),
@@ -72,7 +108,10 @@ ARAStar::ARAStar(
     m_expand_count(0),
     m_search_time_init(clock::duration::zero()),
     m_search_time(clock::duration::zero()),
-    m_satisfied_eps(std::numeric_limits<double>::infinity())
+    m_satisfied_eps(std::numeric_limits<double>::infinity()),
+    m_cancel_requested(false),
+    m_heur_refresh_requested(false),
+    m_mem_budget(0)
 {
     environment_ = space;
 
@@ -87,11 +126,7 @@ ARAStar::ARAStar(
 
 ARAStar::~ARAStar()
 {
-    for (SearchState* s : m_states) {
-        if (s != NULL) {
-            delete s;
-        }
-    }
+    // search states are trivially destructible and are freed with the arena
 }
 
 enum ReplanResultCode
@@ -122,10 +157,15 @@ int ARAStar::replan(
 
     m_time_params = params;
 
+    m_cancel_requested.store(false, std::memory_order_relaxed);
+    m_heur_refresh_requested.store(false, std::memory_order_relaxed);
+
     SearchState* start_state = getSearchState(m_start_state_id);
     SearchState* goal_state = getSearchState(m_goal_state_id);
 
-    if (m_start_state_id != m_last_start_state_id) {
+    bool start_changed = m_start_state_id != m_last_start_state_id;
+
+    if (start_changed) {
         SMPL_DEBUG_NAMED(SLOG, "Reinitialize search");
         m_open.clear();
         m_incons.clear();
@@ -153,15 +193,50 @@ int ARAStar::replan(
         m_last_start_state_id = m_start_state_id;
     }
 
-    if (m_goal_state_id != m_last_goal_state_id) {
+    if (m_goal_state_id != m_last_goal_state_id || m_goal_changed) {
+        if (m_reuse_search_tree && m_last_goal_state_id != -1 && !start_changed) {
+            // Warm-start the search toward the new goal over the retained
+            // tree. The g-values of closed states are goal-independent and
+            // remain valid, so only the frontier needs to be re-keyed by the
+            // new heuristic. Begin a new search iteration so states closed
+            // for the previous goal may be re-expanded, and restart the
+            // epsilon schedule since the previous satisfied bound says
+            // nothing about the new goal.
+            SMPL_DEBUG_NAMED(SLOG, "Reuse search tree for new goal");
+            ++m_iteration;
+            for (SearchState* s : m_incons) {
+                s->incons = false;
+                m_open.push(s);
+            }
+            m_incons.clear();
+
+            // the cost-to-come of the goal search state applied to the
+            // previous goal constraint; the new goal must be relaxed from
+            // scratch, even when it is funneled into the same state id
+            if (m_open.contains(goal_state)) {
+                m_open.erase(goal_state);
+            }
+            reinitSearchState(goal_state);
+            goal_state->g = INFINITECOST;
+            goal_state->f = INFINITECOST;
+            goal_state->eg = INFINITECOST;
+            goal_state->iteration_closed = 0;
+            goal_state->bp = nullptr;
+            goal_state->incons = false;
+
+            m_curr_eps = m_initial_eps;
+            m_satisfied_eps = std::numeric_limits<double>::infinity();
+        }
+
         SMPL_DEBUG_NAMED(SLOG, "Refresh heuristics, keys, and reorder open list");
         recomputeHeuristics();
         reorderOpen();
 
         m_last_goal_state_id = m_goal_state_id;
+        m_goal_changed = false;
     }
 
-    auto start_time = clock::now();
+    m_timer.start();
     int num_expansions = 0;
     clock::duration elapsed_time = clock::duration::zero();
 
@@ -183,7 +258,7 @@ int ARAStar::replan(
             m_incons.clear();
             SMPL_DEBUG_NAMED(SLOG, "Begin new search iteration %d with epsilon = %0.3f", m_iteration, m_curr_eps);
         }
-        err = improvePath(start_time, goal_state, num_expansions, elapsed_time);
+        err = improvePath(goal_state, num_expansions, elapsed_time);
         if (m_curr_eps == m_initial_eps) {
             m_expand_count_init += num_expansions;
             m_search_time_init += elapsed_time;
@@ -193,6 +268,28 @@ int ARAStar::replan(
         }
         SMPL_DEBUG_NAMED(SLOG, "Improved solution");
         m_satisfied_eps = m_curr_eps;
+
+        if (m_stats) {
+            m_stats->record(
+                    STAT_EVENT_SEARCH_ITER,
+                    (std::uint16_t)m_iteration,
+                    (std::uint32_t)(m_expand_count + num_expansions),
+                    m_satisfied_eps);
+            m_stats->record(
+                    STAT_EVENT_COUNTER,
+                    (std::uint16_t)m_iteration,
+                    (std::uint32_t)m_open.size(),
+                    0.0);
+        }
+
+        // stream the incumbent solution to the caller without stopping the
+        // search
+        if (m_on_improved_solution) {
+            std::vector<int> path;
+            int path_cost;
+            extractPath(goal_state, path, path_cost);
+            m_on_improved_solution(path, path_cost, m_satisfied_eps);
+        }
     }
 
     m_search_time += elapsed_time;
@@ -289,13 +386,7 @@ int ARAStar::force_planning_from_scratch_and_free_memory()
 {
     force_planning_from_scratch();
     m_open.clear();
-    for (SearchState* s : m_states) {
-        if (s != NULL) {
-            delete s;
-        }
-    }
     m_states.clear();
-    m_states.shrink_to_fit();
     return 0;
 }
 
@@ -394,14 +485,56 @@ void ARAStar::costs_changed(const StateChangeQuery& changes)
     force_planning_from_scratch();
 }
 
-// Recompute heuristics for all states.
-void ARAStar::recomputeHeuristics()
+/// Enable or disable parallel expansions. When enabled, the search removes a
+/// batch of states from OPEN on each cycle and queries their successors
+/// concurrently across \p num_threads threads, serializing only the open list
+/// updates. The planning space must support concurrent calls to GetSuccs()
+/// (e.g. its collision checker and kinematics must be thread-safe) for this
+/// mode to be safe. A \p num_threads value of 0 selects the hardware
+/// concurrency.
+void ARAStar::setParallelExpansions(bool enabled, int num_threads)
 {
-    for (SearchState* s : m_states) {
-        if (s != NULL) {
-            s->h = m_heur->GetGoalHeuristic(s->state_id);
+    m_parallel_expansions = enabled;
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+        if (num_threads <= 0) {
+            num_threads = 1;
         }
     }
+    m_num_expansion_threads = num_threads;
+}
+
+/// Enable or disable pipelined expansions. When enabled, a single worker
+/// thread generates successors (the collision-checking-dominated phase) while
+/// the search thread relaxes the previously generated successors into OPEN
+/// (the heap-maintenance phase), overlapping the two costs on one extra core.
+/// As with parallel expansions, the planning space and heuristic must support
+/// calls concurrent with GetSuccs() for this mode to be safe. Pipelining is
+/// ignored when parallel or partial expansions are enabled.
+void ARAStar::setPipelinedExpansions(bool enabled)
+{
+    m_pipelined_expansions = enabled;
+}
+
+// Recompute heuristics for all states.
+void ARAStar::recomputeHeuristics()
+{
+    // states from previous episodes receive fresh heuristic values upon
+    // reinitialization, so only states touched this episode need updating.
+    // When parallel expansions are enabled, the refresh fans across the
+    // expansion threads; this additionally requires the heuristic to support
+    // concurrent queries, in line with the thread-safety contract of that
+    // mode
+    const int num_threads = m_parallel_expansions ? m_num_expansion_threads : 1;
+    ForEachIndexRange(m_states.size(), num_threads,
+            [this](size_t first, size_t last) {
+                for (size_t i = first; i != last; ++i) {
+                    SearchState& s = m_states[i];
+                    if (s.call_number == m_call_number) {
+                        s.h = m_heur->GetGoalHeuristic(s.state_id);
+                    }
+                }
+            });
 }
 
 // Convert TimeParameters to ReplanParams. Uses the current epsilon values
@@ -446,11 +579,37 @@ void ARAStar::convertReplanParamsToTimeParams(
     m_delta_eps = r.dec_eps;
 }
 
-// Test whether the search has run out of time.
+/// Return the approximate number of bytes held by the search, dominated by
+/// the state table. The count covers only memory owned by the search itself,
+/// not by the graph or heuristic.
+auto ARAStar::memUsage() const -> size_t
+{
+    size_t bytes = m_states.mem_usage();
+    bytes += m_incons.capacity() * sizeof(SearchState*);
+    bytes += m_succs.capacity() * sizeof(int);
+    bytes += m_costs.capacity() * sizeof(int);
+    bytes += m_batch.capacity() * sizeof(SearchState*);
+    for (const auto& succs : m_batch_succs) {
+        bytes += succs.capacity() * sizeof(int);
+    }
+    for (const auto& costs : m_batch_costs) {
+        bytes += costs.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+// Test whether the search has run out of time or memory.
 bool ARAStar::timedOut(
     int elapsed_expansions,
     const clock::duration& elapsed_time) const
 {
+    // treat an exhausted memory budget like an expired deadline so the usual
+    // partial solution handling applies
+    if (m_mem_budget != 0 && memUsage() >= m_mem_budget) {
+        SMPL_DEBUG_NAMED(SLOG, "Memory budget of %zu bytes exhausted", m_mem_budget);
+        return true;
+    }
+
     if (!m_time_params.bounded) {
         return false;
     }
@@ -478,19 +637,229 @@ bool ARAStar::timedOut(
     return true;
 }
 
+// maximum number of expansions in flight between the pipeline stages; see
+// improvePathPipelined()
+static const int PipelineDepth = 2;
+
+namespace {
+
+// Single-producer, single-consumer pipeline between the search thread and a
+// successor generation worker. The search thread bounds the number of
+// outstanding submissions itself; submissions complete in order.
+class ExpansionPipeline
+{
+public:
+
+    explicit ExpansionPipeline(DiscreteSpaceInformation* space) : m_space(space)
+    {
+        m_worker = std::thread([this]() { this->run(); });
+    }
+
+    ~ExpansionPipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_shutdown = true;
+        }
+        m_cv.notify_all();
+        m_worker.join();
+    }
+
+    // Submit a state for successor generation.
+    void submit(int state_id)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.push_back(state_id);
+        }
+        m_cv.notify_all();
+    }
+
+    // Move the successors of the oldest submission not yet retrieved into
+    // the given buffers, blocking until its generation completes.
+    void retrieve(std::vector<int>& succs, std::vector<int>& costs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() { return !m_results.empty(); });
+        succs = std::move(m_results.front().succs);
+        costs = std::move(m_results.front().costs);
+        m_results.pop_front();
+    }
+
+private:
+
+    struct Result
+    {
+        std::vector<int> succs;
+        std::vector<int> costs;
+    };
+
+    DiscreteSpaceInformation* m_space;
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<int> m_requests;
+    std::deque<Result> m_results;
+    bool m_shutdown = false;
+
+    void run()
+    {
+        for (;;) {
+            int state_id;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this]() {
+                    return m_shutdown || !m_requests.empty();
+                });
+                if (m_requests.empty()) {
+                    return;
+                }
+                state_id = m_requests.front();
+                m_requests.pop_front();
+            }
+
+            Result result;
+            m_space->GetSuccs(state_id, &result.succs, &result.costs);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_results.push_back(std::move(result));
+            }
+            m_cv.notify_all();
+        }
+    }
+};
+
+} // namespace
+
+// Two-stage pipelined variant of improvePath(): a worker thread generates the
+// successors of up to PipelineDepth removed states while this thread relaxes
+// the successors of the oldest completed expansion into OPEN. Like batch
+// parallel expansions, states are removed from OPEN before the relaxations of
+// the expansions still in flight are applied, so the expansion order may
+// deviate slightly from strict best-first order; the pipeline is fully
+// drained before any termination test is honored.
+int ARAStar::improvePathPipelined(
+    SearchState* goal_state,
+    int& elapsed_expansions,
+    clock::duration& elapsed_time)
+{
+    ExpansionPipeline pipeline(m_space);
+    std::deque<SearchState*> in_flight;
+    std::vector<int> succs;
+    std::vector<int> costs;
+
+    int result = -1;
+    while (result < 0) {
+        // keep the worker busy: remove states from OPEN until the pipeline
+        // is full or OPEN cannot supply another state below the goal's
+        // f-value
+        while ((int)in_flight.size() < PipelineDepth && !m_open.empty()) {
+            SearchState* min_state = m_open.min();
+            if (min_state->f >= goal_state->f || min_state == goal_state) {
+                break;
+            }
+
+            SMPL_DEBUG_NAMED(SELOG, "Expand state %d", min_state->state_id);
+
+            m_open.pop();
+
+            assert(min_state->iteration_closed != m_iteration);
+            assert(min_state->g != INFINITECOST);
+
+            if (m_trace) {
+                m_trace->record(
+                        min_state->state_id,
+                        min_state->f, min_state->g, min_state->h,
+                        0, (std::uint16_t)m_iteration);
+            }
+
+            min_state->iteration_closed = m_iteration;
+            min_state->eg = min_state->g;
+
+            pipeline.submit(min_state->state_id);
+            in_flight.push_back(min_state);
+        }
+
+        if (in_flight.empty()) {
+            // every relaxation has been applied; honor the serial loop's
+            // termination tests
+            elapsed_time = m_timer.tick();
+            if (m_open.empty()) {
+                return EXHAUSTED_OPEN_LIST;
+            }
+            SMPL_DEBUG_NAMED(SLOG, "Found path to goal");
+            return SUCCESS;
+        }
+
+        // relax the oldest completed expansion while the worker generates
+        // the successors of the states behind it
+        pipeline.retrieve(succs, costs);
+        SearchState* s = in_flight.front();
+        in_flight.pop_front();
+
+        SMPL_DEBUG_NAMED(SELOG, "  %zu successors", succs.size());
+        updateSuccs(s, succs, costs);
+        ++elapsed_expansions;
+
+        elapsed_time = m_timer.tick();
+        if (timedOut(elapsed_expansions, elapsed_time)) {
+            SMPL_DEBUG_NAMED(SLOG, "Ran out of time");
+            result = TIMED_OUT;
+        } else if (m_cancel_requested.load(std::memory_order_relaxed)) {
+            SMPL_DEBUG_NAMED(SLOG, "Search cancelled");
+            result = TIMED_OUT;
+        } else if (m_heur_refresh_requested.exchange(
+                false, std::memory_order_relaxed))
+        {
+            // safe while the worker generates successors: the worker touches
+            // neither OPEN nor the search states
+            SMPL_DEBUG_NAMED(SLOG, "Refresh heuristics on external request");
+            recomputeHeuristics();
+            reorderOpen();
+        }
+    }
+
+    // apply the relaxations of the expansions still in flight so their
+    // results are not lost
+    while (!in_flight.empty()) {
+        pipeline.retrieve(succs, costs);
+        SearchState* s = in_flight.front();
+        in_flight.pop_front();
+        updateSuccs(s, succs, costs);
+        ++elapsed_expansions;
+    }
+
+    return result;
+}
+
 // Expand states to improve the current solution until a solution within the
 // current suboptimality bound is found, time runs out, or no solution exists.
 int ARAStar::improvePath(
-    const clock::time_point& start_time,
     SearchState* goal_state,
     int& elapsed_expansions,
     clock::duration& elapsed_time)
 {
+    if (m_pipelined_expansions &&
+        !m_parallel_expansions &&
+        !m_partial_expansions)
+    {
+        return improvePathPipelined(
+                goal_state, elapsed_expansions, elapsed_time);
+    }
+
     while (!m_open.empty()) {
+        // apply an externally requested heuristic refresh between expansions,
+        // picking up h-values a background heuristic has since refined
+        if (m_heur_refresh_requested.exchange(false, std::memory_order_relaxed)) {
+            SMPL_DEBUG_NAMED(SLOG, "Refresh heuristics on external request");
+            recomputeHeuristics();
+            reorderOpen();
+        }
+
         SearchState* min_state = m_open.min();
 
-        auto now = clock::now();
-        elapsed_time = now - start_time;
+        elapsed_time = m_timer.tick();
 
         // path to goal found
         if (min_state->f >= goal_state->f || min_state == goal_state) {
@@ -503,6 +872,17 @@ int ARAStar::improvePath(
             return TIMED_OUT;
         }
 
+        if (m_cancel_requested.load(std::memory_order_relaxed)) {
+            SMPL_DEBUG_NAMED(SLOG, "Search cancelled");
+            return TIMED_OUT;
+        }
+
+        if (m_parallel_expansions && m_num_expansion_threads > 1) {
+            expandBatch(goal_state);
+            elapsed_expansions += (int)m_batch.size();
+            continue;
+        }
+
         SMPL_DEBUG_NAMED(SELOG, "Expand state %d", min_state->state_id);
 
         m_open.pop();
@@ -510,10 +890,21 @@ int ARAStar::improvePath(
         assert(min_state->iteration_closed != m_iteration);
         assert(min_state->g != INFINITECOST);
 
-        min_state->iteration_closed = m_iteration;
+        if (m_trace) {
+            m_trace->record(
+                    min_state->state_id,
+                    min_state->f, min_state->g, min_state->h,
+                    0, (std::uint16_t)m_iteration);
+        }
+
         min_state->eg = min_state->g;
 
-        expand(min_state);
+        if (m_partial_expansions) {
+            expandPartial(min_state);
+        } else {
+            min_state->iteration_closed = m_iteration;
+            expand(min_state);
+        }
 
         ++elapsed_expansions;
     }
@@ -531,6 +922,25 @@ void ARAStar::expand(SearchState* s)
 
     SMPL_DEBUG_NAMED(SELOG, "  %zu successors", m_succs.size());
 
+    updateSuccs(s, m_succs, m_costs);
+}
+
+// Partially expand a state (PEA*): relax only the successors whose f-values
+// fall at or below the key the state was selected with, and defer the rest by
+// reopening the state keyed by their minimum f-value. The state is closed for
+// this iteration once no successors remain deferred, so that high-branching
+// expansions do not flood OPEN with successors that are never selected.
+void ARAStar::expandPartial(SearchState* s)
+{
+    m_succs.clear();
+    m_costs.clear();
+    m_space->GetSuccs(s->state_id, &m_succs, &m_costs);
+
+    SMPL_DEBUG_NAMED(SELOG, "  %zu successors", m_succs.size());
+
+    const unsigned int bound_f = s->f;
+    unsigned int next_f = INFINITECOST;
+
     for (size_t sidx = 0; sidx < m_succs.size(); ++sidx) {
         int succ_state_id = m_succs[sidx];
         int cost = m_costs[sidx];
@@ -538,6 +948,125 @@ void ARAStar::expand(SearchState* s)
         SearchState* succ_state = getSearchState(succ_state_id);
         reinitSearchState(succ_state);
 
+        int new_cost = s->eg + cost;
+        if (new_cost < succ_state->g) {
+            unsigned int succ_f =
+                    (unsigned int)new_cost +
+                    (unsigned int)(m_curr_eps * succ_state->h);
+            if (succ_f > bound_f) {
+                // defer to a later partial expansion of this state
+                next_f = std::min(next_f, succ_f);
+                continue;
+            }
+
+            succ_state->g = new_cost;
+            succ_state->bp = s;
+            if (succ_state->iteration_closed != m_iteration) {
+                succ_state->f = computeKey(succ_state);
+                if (m_open.contains(succ_state)) {
+                    m_open.decrease(succ_state);
+                } else if (std::find(
+                        m_new_open.begin(), m_new_open.end(), succ_state) ==
+                                m_new_open.end())
+                {
+                    m_new_open.push_back(succ_state);
+                }
+            } else if (!succ_state->incons) {
+                m_incons.push_back(succ_state);
+            }
+        }
+    }
+
+    if (next_f == INFINITECOST) {
+        // no successors deferred; the state is fully expanded
+        s->iteration_closed = m_iteration;
+    } else {
+        s->f = next_f;
+        m_new_open.push_back(s);
+    }
+
+    m_open.push(m_new_open.begin(), m_new_open.end());
+    m_new_open.clear();
+}
+
+// Remove up to one state per expansion thread from OPEN, generate their
+// successors concurrently, and then serially update OPEN, CLOSED, and INCONS
+// with the results. States whose f-values already meet the goal's f-value are
+// left in OPEN so the termination test in improvePath() sees them.
+void ARAStar::expandBatch(SearchState* goal_state)
+{
+    m_batch.clear();
+    while (!m_open.empty() && (int)m_batch.size() < m_num_expansion_threads) {
+        SearchState* s = m_open.min();
+        if (s->f >= goal_state->f || s == goal_state) {
+            break;
+        }
+
+        m_open.pop();
+
+        assert(s->iteration_closed != m_iteration);
+        assert(s->g != INFINITECOST);
+
+        if (m_trace) {
+            m_trace->record(
+                    s->state_id,
+                    s->f, s->g, s->h,
+                    0, (std::uint16_t)m_iteration);
+        }
+
+        s->iteration_closed = m_iteration;
+        s->eg = s->g;
+        m_batch.push_back(s);
+    }
+
+    if (m_batch.empty()) {
+        return;
+    }
+
+    m_batch_succs.resize(m_batch.size());
+    m_batch_costs.resize(m_batch.size());
+
+    std::vector<std::thread> threads;
+    threads.reserve(m_batch.size() - 1);
+    for (size_t i = 1; i < m_batch.size(); ++i) {
+        m_batch_succs[i].clear();
+        m_batch_costs[i].clear();
+        threads.emplace_back([this, i]() {
+            m_space->GetSuccs(
+                    m_batch[i]->state_id, &m_batch_succs[i], &m_batch_costs[i]);
+        });
+    }
+
+    // generate successors for the first state on this thread
+    m_batch_succs[0].clear();
+    m_batch_costs[0].clear();
+    m_space->GetSuccs(m_batch[0]->state_id, &m_batch_succs[0], &m_batch_costs[0]);
+
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (size_t i = 0; i < m_batch.size(); ++i) {
+        SMPL_DEBUG_NAMED(SELOG, "Expand state %d", m_batch[i]->state_id);
+        SMPL_DEBUG_NAMED(SELOG, "  %zu successors", m_batch_succs[i].size());
+        updateSuccs(m_batch[i], m_batch_succs[i], m_batch_costs[i]);
+    }
+}
+
+// Relax the costs of a batch of successors of an expanded state, placing them
+// into OPEN and INCONS as appropriate.
+void ARAStar::updateSuccs(
+    SearchState* s,
+    const std::vector<int>& succs,
+    const std::vector<int>& costs)
+{
+    for (size_t sidx = 0; sidx < succs.size(); ++sidx) {
+        int succ_state_id = succs[sidx];
+        int cost = costs[sidx];
+
+        SearchState* succ_state = getSearchState(succ_state_id);
+        reinitSearchState(succ_state);
+
         int new_cost = s->eg + cost;
         SMPL_DEBUG_NAMED(SELOG, "Compare new cost %d vs old cost %d", new_cost, succ_state->g);
         if (new_cost < succ_state->g) {
@@ -547,22 +1076,39 @@ void ARAStar::expand(SearchState* s)
                 succ_state->f = computeKey(succ_state);
                 if (m_open.contains(succ_state)) {
                     m_open.decrease(succ_state);
-                } else {
-                    m_open.push(succ_state);
+                } else if (std::find(
+                        m_new_open.begin(), m_new_open.end(), succ_state) ==
+                                m_new_open.end())
+                {
+                    // defer the insertion; duplicate successors update the
+                    // deferred state in place
+                    m_new_open.push_back(succ_state);
                 }
             } else if (!succ_state->incons) {
                 m_incons.push_back(succ_state);
             }
         }
     }
+
+    m_open.push(m_new_open.begin(), m_new_open.end());
+    m_new_open.clear();
 }
 
-// Recompute the f-values of all states in OPEN and reorder OPEN.
+// Recompute the f-values of all states in OPEN and reorder OPEN. The keys
+// are pure arithmetic over each state, so they are evaluated concurrently
+// when parallel expansions are enabled, and the heap is then rebuilt
+// bottom-up in O(n) rather than reordered element by element.
 void ARAStar::reorderOpen()
 {
-    for (auto it = m_open.begin(); it != m_open.end(); ++it) {
-        (*it)->f = computeKey(*it);
-    }
+    const int num_threads = m_parallel_expansions ? m_num_expansion_threads : 1;
+    const auto states = m_open.begin();
+    ForEachIndexRange(m_open.size(), num_threads,
+            [this, states](size_t first, size_t last) {
+                for (size_t i = first; i != last; ++i) {
+                    SearchState* s = *(states + i);
+                    s->f = computeKey(s);
+                }
+            });
     m_open.make();
 }
 
@@ -571,32 +1117,20 @@ int ARAStar::computeKey(SearchState* s) const
     return s->g + (unsigned int)(m_curr_eps * s->h);
 }
 
-// Get the search state corresponding to a graph state, creating a new state if
-// one has not been created yet.
+// Get the search state corresponding to a graph state, growing the state
+// table if one has not been created yet.
 ARAStar::SearchState* ARAStar::getSearchState(int state_id)
 {
-    if (m_states.size() <= state_id) {
-        m_states.resize(state_id + 1, nullptr);
-    }
-
-    auto& state = m_states[state_id];
-    if (state == NULL) {
-        state = createState(state_id);
+    if (m_states.size() <= (size_t)state_id) {
+        size_t old_size = m_states.size();
+        m_states.resize(state_id + 1);
+        for (size_t i = old_size; i < m_states.size(); ++i) {
+            m_states[i].state_id = (int)i;
+            m_states[i].call_number = 0;
+        }
     }
 
-    return state;
-}
-
-// Create a new search state for a graph state.
-ARAStar::SearchState* ARAStar::createState(int state_id)
-{
-    assert(state_id < m_states.size());
-
-    SearchState* ss = new SearchState;
-    ss->state_id = state_id;
-    ss->call_number = 0;
-
-    return ss;
+    return &m_states[state_id];
 }
 
 // Lazily (re)initialize a search state.
@@ -117,7 +117,8 @@ int AWAStar::replan(
 
     int best_sol = INFINITECOST;
 
-    auto start_time = smpl::clock::now();
+    coarse_timer timer;
+    timer.start();
 
     std::vector<int> succs;
     std::vector<int> costs;
@@ -130,8 +131,7 @@ int AWAStar::replan(
             m_min_sus = INFINITECOST;
 
             while (!m_open.empty()) {
-                auto now = smpl::clock::now();
-                auto elapsed = now - start_time;
+                auto elapsed = timer.tick();
                 if (elapsed > allowed_time) {
                     // ugh!
                     if (best_sol != INFINITECOST) {
@@ -181,6 +181,14 @@ int AWAStar::replan(
                     SMPL_DEBUG_NAMED(SLOG, "Peeked the goal state");
                     // TODO: return best solution
                     best_sol = min_state->f;
+                    // stream the incumbent solution to the caller without
+                    // stopping the search
+                    if (m_on_improved_solution) {
+                        std::vector<int> path;
+                        int path_cost;
+                        extractPath(goal_state, path, path_cost);
+                        m_on_improved_solution(path, path_cost, (double)m_sus_eps);
+                    }
                     break;
                 }
 
@@ -0,0 +1,377 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/search/bounded_cost_search.h>
+
+// standard includes
+#include <algorithm>
+
+// project includes
+#include <smpl/console/console.h>
+#include <smpl/graph/robot_planning_space.h>
+
+namespace smpl {
+
+static const char* SLOG = "search";
+static const char* SELOG = "search.expansions";
+
+BoundedCostSearch::BoundedCostSearch(
+    DiscreteSpaceInformation* space,
+    Heuristic* heuristic)
+:
+    m_open(SearchStateCompare{ this })
+{
+    environment_ = space;
+    m_space = space;
+    m_stream_space = dynamic_cast<RobotPlanningSpace*>(space);
+    m_heur = heuristic;
+}
+
+BoundedCostSearch::~BoundedCostSearch()
+{
+    for (SearchState* s : m_states) {
+        delete s;
+    }
+}
+
+enum ReplanResultCode
+{
+    SUCCESS             =  0,
+    START_NOT_SET       = -2,
+    GOAL_NOT_SET        = -3,
+    TIMED_OUT           = -4,
+    EXHAUSTED_OPEN_LIST = -5,
+};
+
+int BoundedCostSearch::replan(
+    double allowed_time_secs,
+    std::vector<int>* solution,
+    int* cost)
+{
+    auto allowed_time = to_duration(allowed_time_secs);
+    SMPL_DEBUG_NAMED(SLOG, "Find path to goal with cost <= %d", m_cost_bound);
+
+    if (m_start_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Start state not set");
+        return !START_NOT_SET;
+    }
+    if (m_goal_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Goal state not set");
+        return !GOAL_NOT_SET;
+    }
+
+    SearchState* start_state = getSearchState(m_start_state_id);
+    SearchState* goal_state = getSearchState(m_goal_state_id);
+
+    if (m_last_start_id != m_start_state_id ||
+        m_last_goal_id != m_goal_state_id ||
+        m_last_bound != m_cost_bound)
+    {
+        SMPL_DEBUG_NAMED(SLOG, "Begin new search");
+        m_open.clear();
+        m_call_number++;
+
+        reinitSearchState(start_state);
+        reinitSearchState(goal_state);
+
+        start_state->g = 0;
+        if (start_state->h <= m_cost_bound) {
+            m_open.push(start_state);
+        }
+
+        m_expands = 0;
+        m_search_time = 0.0;
+
+        m_last_start_id = m_start_state_id;
+        m_last_goal_id = m_goal_state_id;
+        m_last_bound = m_cost_bound;
+    }
+
+    // the goal was already expanded on a previous call for this query =>
+    // return the existing solution
+    if (goal_state->call_number == m_call_number && goal_state->closed) {
+        int sol_cost;
+        extractPath(goal_state, *solution, sol_cost);
+        if (cost != NULL) {
+            *cost = sol_cost;
+        }
+        return !SUCCESS;
+    }
+
+    coarse_timer timer;
+    timer.start();
+
+    std::vector<int> succs;
+    std::vector<int> costs;
+    while (!m_open.empty()) {
+        auto elapsed = timer.tick();
+        if (elapsed > allowed_time) {
+            m_search_time += to_seconds(elapsed);
+            return !TIMED_OUT;
+        }
+
+        SearchState* min_state = m_open.min();
+        m_open.pop();
+        min_state->closed = true;
+
+        SMPL_DEBUG_NAMED(SELOG, "Expand state %d", min_state->state_id);
+
+        if (min_state == goal_state) {
+            SMPL_DEBUG_NAMED(SLOG, "Found solution with cost %d <= %d", min_state->g, m_cost_bound);
+            m_search_time += to_seconds(timer.tick());
+            int sol_cost;
+            extractPath(min_state, *solution, sol_cost);
+            if (cost != NULL) {
+                *cost = sol_cost;
+            }
+            return !SUCCESS;
+        }
+
+        ++m_expands;
+
+        if (m_stream_space) {
+            // pull successors in ascending cost order and stop once even the
+            // cheapest remaining edge cannot fit within the cost bound; the
+            // graph then never evaluates the remaining edges at all
+            auto stream = m_stream_space->succStream(min_state->state_id);
+            int succ_id, succ_cost;
+            for (;;) {
+                if ((int64_t)min_state->g +
+                        (int64_t)stream->minRemainingCost() >
+                    (int64_t)m_cost_bound)
+                {
+                    break;
+                }
+                if (!stream->next(&succ_id, &succ_cost)) {
+                    break;
+                }
+                updateSuccessor(min_state, succ_id, succ_cost);
+            }
+        } else {
+            succs.clear();
+            costs.clear();
+            m_space->GetSuccs(min_state->state_id, &succs, &costs);
+            for (size_t sidx = 0; sidx < succs.size(); ++sidx) {
+                updateSuccessor(min_state, succs[sidx], costs[sidx]);
+            }
+        }
+    }
+
+    SMPL_DEBUG_NAMED(SLOG, "No solution with cost <= %d", m_cost_bound);
+    m_search_time += to_seconds(timer.tick());
+    return !EXHAUSTED_OPEN_LIST;
+}
+
+int BoundedCostSearch::replan(std::vector<int>* solution, ReplanParams params)
+{
+    return replan(params.max_time, solution, NULL);
+}
+
+int BoundedCostSearch::replan(
+    std::vector<int>* solution,
+    ReplanParams params,
+    int* cost)
+{
+    return replan(params.max_time, solution, cost);
+}
+
+/// Force the planner to forget previous search efforts, begin from scratch,
+/// and free all memory allocated by the planner during previous searches.
+int BoundedCostSearch::force_planning_from_scratch_and_free_memory()
+{
+    force_planning_from_scratch();
+    m_open.clear();
+    for (SearchState* s : m_states) {
+        delete s;
+    }
+    m_states.clear();
+    m_states.shrink_to_fit();
+    return 0;
+}
+
+/// Return the suboptimality bound of the current solution for the current search.
+double BoundedCostSearch::get_solution_eps() const
+{
+    return 0.0;
+}
+
+/// Return the initial suboptimality bound
+double BoundedCostSearch::get_initial_eps()
+{
+    return 0.0;
+}
+
+/// Return the time consumed by the search in progress to the initial solution.
+double BoundedCostSearch::get_initial_eps_planning_time()
+{
+    return m_search_time;
+}
+
+/// Return the time consumed by the search in progress to the final solution.
+double BoundedCostSearch::get_final_eps_planning_time()
+{
+    return m_search_time;
+}
+
+/// Return the number of expansions made in progress to the initial solution.
+int BoundedCostSearch::get_n_expands_init_solution()
+{
+    return m_expands;
+}
+
+/// Return the final suboptimality bound.
+double BoundedCostSearch::get_final_epsilon()
+{
+    return 0.0;
+}
+
+/// Return statistics for each completed search iteration.
+void BoundedCostSearch::get_search_stats(std::vector<PlannerStats>* s)
+{
+    PlannerStats stats;
+    stats.eps = 0.0;
+    stats.cost = 0;
+    stats.expands = m_expands;
+    stats.time = m_search_time;
+    s->push_back(stats);
+}
+
+/// Set the goal state.
+int BoundedCostSearch::set_goal(int goal_state_id)
+{
+    m_goal_state_id = goal_state_id;
+    return 1;
+}
+
+/// Set the start state.
+int BoundedCostSearch::set_start(int start_state_id)
+{
+    m_start_state_id = start_state_id;
+    return 1;
+}
+
+/// Force the search to forget previous search efforts and start from scratch.
+int BoundedCostSearch::force_planning_from_scratch()
+{
+    m_last_start_id = -1;
+    m_last_goal_id = -1;
+    m_last_bound = -1;
+    return 0;
+}
+
+/// Set whether the number of expansions is bounded by time or total expansions
+/// per call to replan().
+int BoundedCostSearch::set_search_mode(bool first_solution_unbounded)
+{
+    return 0;
+}
+
+/// Notify the search of changes to edge costs in the graph.
+void BoundedCostSearch::costs_changed(const StateChangeQuery& changes)
+{
+    force_planning_from_scratch();
+}
+
+// Get the search state corresponding to a graph state, creating a new state if
+// one has not been created yet.
+BoundedCostSearch::SearchState* BoundedCostSearch::getSearchState(int state_id)
+{
+    if (state_id >= m_states.size()) {
+        m_states.resize(state_id + 1, nullptr);
+    }
+
+    if (m_states[state_id] == nullptr) {
+        m_states[state_id] = new SearchState;
+        m_states[state_id]->call_number = 0;
+        m_states[state_id]->state_id = state_id;
+    }
+
+    return m_states[state_id];
+}
+
+// Relax the edge from an expanded state to one of its successors.
+void BoundedCostSearch::updateSuccessor(
+    SearchState* state,
+    int succ_id,
+    int cost)
+{
+    SearchState* succ_state = getSearchState(succ_id);
+    reinitSearchState(succ_state);
+
+    int new_g = state->g + cost;
+
+    // with an admissible heuristic, no path through this state fits within
+    // the cost bound
+    if (new_g + succ_state->h > m_cost_bound) {
+        return;
+    }
+
+    if (new_g < succ_state->g) {
+        succ_state->g = new_g;
+        succ_state->bp = state;
+        if (m_open.contains(succ_state)) {
+            // decreasing g increases the state's potential
+            m_open.decrease(succ_state);
+        } else {
+            // insert, or reopen if the state was closed with a higher
+            // cost-to-come
+            succ_state->closed = false;
+            m_open.push(succ_state);
+        }
+    }
+}
+
+// Lazily (re)initialize a search state.
+void BoundedCostSearch::reinitSearchState(SearchState* state)
+{
+    if (state->call_number != m_call_number) {
+        state->g = INFINITECOST;
+        state->h = m_heur->GetGoalHeuristic(state->state_id);
+        state->call_number = m_call_number;
+        state->closed = false;
+        state->bp = nullptr;
+    }
+}
+
+// Extract the path from the start state up to a new state.
+void BoundedCostSearch::extractPath(
+    SearchState* to_state,
+    std::vector<int>& solution,
+    int& cost) const
+{
+    for (SearchState* s = to_state; s; s = s->bp) {
+        solution.push_back(s->state_id);
+    }
+    std::reverse(solution.begin(), solution.end());
+    cost = to_state->g;
+}
+
+} // namespace smpl
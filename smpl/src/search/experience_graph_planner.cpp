@@ -1,6 +1,7 @@
 #include <smpl/search/experience_graph_planner.h>
 
 // standard includes
+#include <algorithm>
 #include <chrono>
 
 // system includes
@@ -156,17 +157,50 @@ int ExperienceGraphPlanner::replan(
             std::vector<int> snap_succs;
             m_egh->getEquivalentStates(min_state->state_id, snap_succs);
 
+            // Defer snap evaluation (IK + collision sweep) until a candidate
+            // could actually improve its successor: successors that are
+            // closed, or whose cost-to-come would not improve even via a
+            // zero-cost snap motion, are skipped without evaluation, and the
+            // remainder are evaluated in order of estimated cost-to-go so
+            // the most promising snaps are attempted first.
+            std::vector<SearchState*> snap_states;
+            snap_states.reserve(snap_succs.size());
             for (size_t sidx = 0; sidx < snap_succs.size(); ++sidx) {
-                int snap_id = snap_succs[sidx];
-                int cost;
-                if (!m_ege->snap(min_state->state_id, snap_id, cost)) {
+                SearchState* snap_state = getSearchState(snap_succs[sidx]);
+                reinitSearchState(snap_state);
+
+                if (snap_state->iteration_closed != 0) {
                     continue;
                 }
 
-                SearchState* snap_state = getSearchState(snap_id);
-                reinitSearchState(snap_state);
+                if (min_state->g >= snap_state->g) {
+                    continue;
+                }
 
-                if (snap_state->iteration_closed != 0) {
+                snap_states.push_back(snap_state);
+            }
+
+            std::sort(snap_states.begin(), snap_states.end(),
+                    [](const SearchState* s1, const SearchState* s2) {
+                        return s1->h < s2->h;
+                    });
+
+            // Evaluate the surviving candidates as one batch so that graphs
+            // whose snap evaluations are independent may process them
+            // concurrently, then apply the results in heuristic order.
+            std::vector<int> snap_ids;
+            snap_ids.reserve(snap_states.size());
+            for (SearchState* snap_state : snap_states) {
+                snap_ids.push_back(snap_state->state_id);
+            }
+
+            std::vector<int> snap_costs;
+            m_ege->snap(min_state->state_id, snap_ids, snap_costs);
+
+            for (size_t sidx = 0; sidx < snap_states.size(); ++sidx) {
+                SearchState* snap_state = snap_states[sidx];
+                int cost = snap_costs[sidx];
+                if (cost < 0) {
                     continue;
                 }
 
@@ -11,6 +11,10 @@ using CandidatePred = LazySMHAStar::CandidatePred;
 static const int g_infinite = 1000000000;
 static const double g_w_mha = 5.0;
 
+// the number of unevaluated candidate edges whose true costs are requested
+// together when a lazy state is popped
+static const size_t g_true_cost_batch = 4;
+
 static const char* LOG = "search";
 
 static size_t NumHeuristics(LazySMHAStar& search)
@@ -226,36 +230,69 @@ static void EvaluateState(LazySMHAStar& search, State* s, size_t hidx)
     auto better_cand = [&](const CandidatePred& a, const CandidatePred& b) {
         return a.g < b.g;
     };
-    auto best_it = std::min_element(begin(cands), end(cands), better_cand);
-
-    assert(!best_it->true_cost);
+    // gather the cheapest unevaluated candidates, up to the batch size; their
+    // edges are independent, so the graph may evaluate them concurrently,
+    // overlapping the collision latency the lazy search deferred rather than
+    // serializing it one pop at a time
+    std::vector<size_t> batch;
+    for (size_t i = 0; i < cands.size(); ++i) {
+        if (!cands[i].true_cost) {
+            batch.push_back(i);
+        }
+    }
+    assert(!batch.empty());
+    std::sort(begin(batch), end(batch), [&](size_t a, size_t b) {
+        return cands[a].g < cands[b].g;
+    });
+    if (batch.size() > g_true_cost_batch) {
+        batch.resize(g_true_cost_batch);
+    }
 
-    SMPL_DEBUG_NAMED(LOG, "Evaluate transitions %d -> %d", s->bp->graph_state, s->graph_state);
+    std::vector<int> pred_ids;
+    pred_ids.reserve(batch.size());
+    for (auto i : batch) {
+        SMPL_DEBUG_NAMED(LOG, "Evaluate transitions %d -> %d", cands[i].pred->graph_state, s->graph_state);
+        pred_ids.push_back(cands[i].pred->graph_state);
+    }
 
-    int32_t cost = search.succ_fun_->GetSuccTrueCost(
-            s->bp->graph_state, s->graph_state);
+    std::vector<int> true_costs;
+    search.succ_fun_->GetSuccTrueCosts(pred_ids, s->graph_state, true_costs);
 
-    // remove invalid or now-dominated candidate preds
-    if (cost < 0) {
-        cands.erase(best_it);
-    } else {
-        best_it->true_cost = true;
-        best_it->g = best_it->pred->g + cost;
-        if (IsPredDominated(*best_it, s)) {
-            cands.erase(best_it);
+    // commit the evaluated costs, marking invalid transitions for removal
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto& cand = cands[batch[i]];
+        cand.true_cost = true;
+        if (true_costs[i] < 0) {
+            cand.g = -1;
+        } else {
+            cand.g = cand.pred->g + true_costs[i];
         }
     }
 
-    best_it = std::min_element(begin(cands), end(cands), better_cand);
-    s->bp = best_it->pred;
-    s->g = best_it->g;
-    s->true_cost = best_it->true_cost;
+    // remove invalid candidate preds
+    auto invalid = [](const CandidatePred& c) {
+        return c.true_cost && c.g < 0;
+    };
+    cands.erase(std::remove_if(begin(cands), end(cands), invalid), end(cands));
+
+    // remove now-dominated candidate preds
+    for (size_t i = 0; i < cands.size(); ) {
+        if (cands[i].true_cost && IsPredDominated(cands[i], s)) {
+            cands.erase(begin(cands) + i);
+        } else {
+            ++i;
+        }
+    }
 
     // OPTIMIZATION if this element is the best, remove all elements except this
     // one from the lazy list. Also, we can probably also remove this element
     // and maintain the s's (bp,g,true) as the current best candidate
 
+    auto best_it = std::min_element(begin(cands), end(cands), better_cand);
     if (best_it != end(cands)) {
+        s->bp = best_it->pred;
+        s->g = best_it->g;
+        s->true_cost = best_it->true_cost;
         search.open_lists_[hidx].push(&s->open_data[hidx]);
     }
 }
@@ -0,0 +1,519 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <smpl/search/lpastar.h>
+
+#include <algorithm>
+
+// system includes
+#include <sbpl/utils/key.h>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+static const char* SLOG = "search";
+static const char* SELOG = "search.expansions";
+
+enum ReplanResultCode
+{
+    SUCCESS = 0,
+    START_NOT_SET,
+    GOAL_NOT_SET,
+    TIMED_OUT,
+    EXHAUSTED_OPEN_LIST
+};
+
+LPAStar::LPAStar(
+    DiscreteSpaceInformation* space,
+    Heuristic* heur)
+:
+    SBPLPlanner(),
+    m_space(space),
+    m_heur(heur),
+    m_states(),
+    m_start_state_id(-1),
+    m_goal_state_id(-1),
+    m_open(),
+    m_call_number(0),
+    m_last_start_state_id(-1),
+    m_last_goal_state_id(-1),
+    m_succs(),
+    m_costs(),
+    m_expand_count(0),
+    m_search_time(clock::duration::zero()),
+    m_first_solution_unbounded(false)
+{
+    environment_ = space;
+}
+
+LPAStar::~LPAStar()
+{
+    for (SearchState* s : m_states) {
+        if (s != NULL) {
+            delete s;
+        }
+    }
+}
+
+int LPAStar::replan(
+    double allowed_time_secs,
+    std::vector<int>* solution)
+{
+    int cost;
+    return replan(allowed_time_secs, solution, &cost);
+}
+
+int LPAStar::replan(
+    double allowed_time_secs,
+    std::vector<int>* solution,
+    int* solcost)
+{
+    SMPL_DEBUG_NAMED(SLOG, "Find path to goal");
+
+    if (m_start_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Start state not set");
+        return !START_NOT_SET;
+    }
+    if (m_goal_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Goal state not set");
+        return !GOAL_NOT_SET;
+    }
+
+    if (m_start_state_id != m_last_start_state_id) {
+        SMPL_DEBUG_NAMED(SLOG, "Reinitialize search");
+        reinitSearch();
+        m_last_start_state_id = m_start_state_id;
+        m_last_goal_state_id = m_goal_state_id;
+    } else if (m_goal_state_id != m_last_goal_state_id) {
+        SMPL_DEBUG_NAMED(SLOG, "Refresh heuristics, keys, and reorder open list");
+        recomputeHeuristics();
+        m_last_goal_state_id = m_goal_state_id;
+    }
+
+    SearchState* goal_state = getSearchState(m_goal_state_id);
+    reinitSearchState(goal_state);
+
+    auto start_time = clock::now();
+
+    int err = computeShortestPath(
+            goal_state, start_time, to_duration(allowed_time_secs));
+
+    m_search_time += clock::now() - start_time;
+
+    if (err) {
+        return !err;
+    }
+
+    extractPath(goal_state, *solution, *solcost);
+    return !SUCCESS;
+}
+
+/// Set the goal state.
+int LPAStar::set_goal(int goal_state_id)
+{
+    m_goal_state_id = goal_state_id;
+    return 1;
+}
+
+/// Set the start state.
+int LPAStar::set_start(int start_state_id)
+{
+    m_start_state_id = start_state_id;
+    return 1;
+}
+
+/// Force the search to forget previous search efforts and start from scratch.
+int LPAStar::force_planning_from_scratch()
+{
+    m_last_start_state_id = -1;
+    m_last_goal_state_id = -1;
+    return 0;
+}
+
+int LPAStar::set_search_mode(bool bSearchUntilFirstSolution)
+{
+    m_first_solution_unbounded = bSearchUntilFirstSolution;
+    return 0;
+}
+
+/// Notify the search of changes to edge costs in the graph. The search expects
+/// the set of states whose outgoing edges have changed, available through
+/// StateChangeQuery::getPredecessors(). The outgoing edges of each changed
+/// state that the search has discovered are re-evaluated and the affected
+/// successors are repaired during the next call to replan(). If the set of
+/// changed states is unavailable, the search falls back to replanning from
+/// scratch.
+void LPAStar::costs_changed(const StateChangeQuery& changes)
+{
+    const std::vector<int>* changed = changes.getPredecessors();
+    if (changed == NULL) {
+        SMPL_WARN_NAMED(SLOG, "Unknown changed states. Replan from scratch");
+        force_planning_from_scratch();
+        return;
+    }
+
+    for (int state_id : *changed) {
+        if (state_id < 0 || state_id >= (int)m_states.size()) {
+            continue;
+        }
+        SearchState* s = m_states[state_id];
+        if (s == NULL || s->call_number != m_call_number || !s->expanded) {
+            // edges from this state have not been discovered yet
+            continue;
+        }
+
+        SMPL_DEBUG_NAMED(SLOG, "Re-evaluate outgoing edges of state %d", state_id);
+
+        m_succs.clear();
+        m_costs.clear();
+        m_space->GetSuccs(s->state_id, &m_succs, &m_costs);
+
+        for (size_t sidx = 0; sidx < m_succs.size(); ++sidx) {
+            SearchState* succ_state = getSearchState(m_succs[sidx]);
+            reinitSearchState(succ_state);
+
+            bool found = false;
+            for (InEdge& e : succ_state->preds) {
+                if (e.pred == s) {
+                    e.cost = m_costs[sidx];
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                succ_state->preds.push_back({ s, m_costs[sidx] });
+            }
+
+            updateState(succ_state);
+        }
+    }
+}
+
+/// Force the planner to forget previous search efforts, begin from scratch,
+/// and free all memory allocated by the planner during previous searches.
+int LPAStar::force_planning_from_scratch_and_free_memory()
+{
+    force_planning_from_scratch();
+    m_open.clear();
+    for (SearchState* s : m_states) {
+        if (s != NULL) {
+            delete s;
+        }
+    }
+    m_states.clear();
+    m_states.shrink_to_fit();
+    return 0;
+}
+
+double LPAStar::get_solution_eps() const
+{
+    return 1.0;
+}
+
+int LPAStar::get_n_expands() const
+{
+    return m_expand_count;
+}
+
+double LPAStar::get_initial_eps()
+{
+    return 1.0;
+}
+
+double LPAStar::get_initial_eps_planning_time()
+{
+    return to_seconds(m_search_time);
+}
+
+double LPAStar::get_final_eps_planning_time()
+{
+    return to_seconds(m_search_time);
+}
+
+int LPAStar::get_n_expands_init_solution()
+{
+    return m_expand_count;
+}
+
+double LPAStar::get_final_epsilon()
+{
+    return 1.0;
+}
+
+void LPAStar::get_search_stats(std::vector<PlannerStats>* s)
+{
+    PlannerStats stats;
+    stats.eps = 1.0;
+    stats.expands = m_expand_count;
+    stats.time = to_seconds(m_search_time);
+    s->push_back(stats);
+}
+
+void LPAStar::set_initialsolution_eps(double eps)
+{
+    if (eps != 1.0) {
+        SMPL_WARN_NAMED(SLOG, "LPA* does not support inflated heuristics");
+    }
+}
+
+// Expand states until the goal state is locally consistent and its key is no
+// greater than the minimum key in OPEN, time runs out, or no solution exists.
+int LPAStar::computeShortestPath(
+    SearchState* goal_state,
+    const clock::time_point& start_time,
+    clock::duration allowed_time)
+{
+    while (!m_open.empty()) {
+        SearchState* min_state = m_open.min();
+
+        if (!keyLess(min_state, goal_state) && goal_state->rhs == goal_state->g)
+        {
+            if (goal_state->rhs == INFINITECOST) {
+                SMPL_DEBUG_NAMED(SLOG, "Goal is unreachable");
+                return EXHAUSTED_OPEN_LIST;
+            }
+            SMPL_DEBUG_NAMED(SLOG, "Found path to goal");
+            return SUCCESS;
+        }
+
+        if (!m_first_solution_unbounded &&
+            clock::now() - start_time >= allowed_time)
+        {
+            SMPL_DEBUG_NAMED(SLOG, "Ran out of time");
+            return TIMED_OUT;
+        }
+
+        m_open.pop();
+
+        SMPL_DEBUG_NAMED(SELOG, "Expand state %d (g: %u, rhs: %u)",
+                min_state->state_id, min_state->g, min_state->rhs);
+
+        if (min_state->g > min_state->rhs) {
+            // overconsistent -> locally consistent
+            min_state->g = min_state->rhs;
+            expand(min_state);
+        } else {
+            // underconsistent -> overconsistent; repair this state and its
+            // discovered successors
+            min_state->g = INFINITECOST;
+            updateState(min_state);
+            expand(min_state);
+        }
+
+        ++m_expand_count;
+    }
+
+    if (goal_state->rhs == goal_state->g && goal_state->rhs != INFINITECOST) {
+        SMPL_DEBUG_NAMED(SLOG, "Found path to goal");
+        return SUCCESS;
+    }
+
+    return EXHAUSTED_OPEN_LIST;
+}
+
+// Generate the successors of a state, record the traversed edges in the
+// transpose graph, and repair the rhs-values of the successors.
+void LPAStar::expand(SearchState* s)
+{
+    m_succs.clear();
+    m_costs.clear();
+    m_space->GetSuccs(s->state_id, &m_succs, &m_costs);
+    s->expanded = true;
+
+    SMPL_DEBUG_NAMED(SELOG, "  %zu successors", m_succs.size());
+
+    for (size_t sidx = 0; sidx < m_succs.size(); ++sidx) {
+        SearchState* succ_state = getSearchState(m_succs[sidx]);
+        reinitSearchState(succ_state);
+
+        bool found = false;
+        for (InEdge& e : succ_state->preds) {
+            if (e.pred == s) {
+                e.cost = m_costs[sidx];
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            succ_state->preds.push_back({ s, m_costs[sidx] });
+        }
+
+        updateState(succ_state);
+    }
+}
+
+// Recompute the rhs-value of a state from its discovered in-edges and insert,
+// update, or remove the state from OPEN according to its local consistency.
+void LPAStar::updateState(SearchState* s)
+{
+    if (s->state_id != m_start_state_id) {
+        unsigned int rhs = INFINITECOST;
+        for (const InEdge& e : s->preds) {
+            if (e.pred->g != INFINITECOST && e.pred->g + e.cost < rhs) {
+                rhs = e.pred->g + e.cost;
+            }
+        }
+        s->rhs = rhs;
+    }
+
+    if (s->g != s->rhs) {
+        computeKeys(s);
+        if (m_open.contains(s)) {
+            m_open.update(s);
+        } else {
+            m_open.push(s);
+        }
+    } else if (m_open.contains(s)) {
+        m_open.erase(s);
+    }
+}
+
+void LPAStar::computeKeys(SearchState* s) const
+{
+    s->k2 = std::min(s->g, s->rhs);
+    s->k1 = (s->k2 == INFINITECOST) ? INFINITECOST : s->k2 + s->h;
+}
+
+bool LPAStar::keyLess(const SearchState* s, const SearchState* t) const
+{
+    unsigned int tk2 = std::min(t->g, t->rhs);
+    unsigned int tk1 = (tk2 == INFINITECOST) ? INFINITECOST : tk2 + t->h;
+    return (s->k1 < tk1) || (s->k1 == tk1 && s->k2 < tk2);
+}
+
+// Drop all search efforts and reroot the search at the current start state.
+void LPAStar::reinitSearch()
+{
+    m_open.clear();
+    ++m_call_number;
+
+    m_expand_count = 0;
+    m_search_time = clock::duration::zero();
+
+    SearchState* start_state = getSearchState(m_start_state_id);
+    reinitSearchState(start_state);
+    start_state->rhs = 0;
+    computeKeys(start_state);
+    m_open.push(start_state);
+}
+
+// Recompute heuristics for all states and reorder the open list.
+void LPAStar::recomputeHeuristics()
+{
+    for (SearchState* s : m_states) {
+        if (s != NULL && s->call_number == m_call_number) {
+            s->h = m_heur->GetGoalHeuristic(s->state_id);
+        }
+    }
+    for (auto it = m_open.begin(); it != m_open.end(); ++it) {
+        computeKeys(*it);
+    }
+    m_open.make();
+}
+
+// Get the search state corresponding to a graph state, creating a new state if
+// one has not been created yet.
+LPAStar::SearchState* LPAStar::getSearchState(int state_id)
+{
+    if (m_states.size() <= state_id) {
+        m_states.resize(state_id + 1, nullptr);
+    }
+
+    auto& state = m_states[state_id];
+    if (state == NULL) {
+        state = createState(state_id);
+    }
+
+    return state;
+}
+
+// Create a new search state for a graph state.
+LPAStar::SearchState* LPAStar::createState(int state_id)
+{
+    assert(state_id < m_states.size());
+
+    SearchState* ss = new SearchState;
+    ss->state_id = state_id;
+    ss->call_number = 0;
+
+    return ss;
+}
+
+// Lazily (re)initialize a search state.
+void LPAStar::reinitSearchState(SearchState* state)
+{
+    if (state->call_number != m_call_number) {
+        SMPL_DEBUG_NAMED(SELOG, "Reinitialize state %d", state->state_id);
+        state->g = INFINITECOST;
+        state->rhs = INFINITECOST;
+        state->h = m_heur->GetGoalHeuristic(state->state_id);
+        state->k1 = INFINITECOST;
+        state->k2 = INFINITECOST;
+        state->call_number = m_call_number;
+        state->expanded = false;
+        state->preds.clear();
+    }
+}
+
+// Extract the path from the start state to the goal state by greedily
+// descending g-values through the discovered in-edges of each state.
+void LPAStar::extractPath(
+    SearchState* goal_state,
+    std::vector<int>& solution,
+    int& cost) const
+{
+    solution.clear();
+    cost = (int)goal_state->g;
+
+    const SearchState* s = goal_state;
+    solution.push_back(s->state_id);
+    while (s->state_id != m_start_state_id) {
+        const SearchState* best_pred = NULL;
+        unsigned int best_g = INFINITECOST;
+        for (const InEdge& e : s->preds) {
+            if (e.pred->g != INFINITECOST && e.pred->g + e.cost < best_g) {
+                best_g = e.pred->g + e.cost;
+                best_pred = e.pred;
+            }
+        }
+        if (best_pred == NULL) {
+            SMPL_ERROR_NAMED(SLOG, "Failed to trace path to start");
+            solution.clear();
+            return;
+        }
+        s = best_pred;
+        solution.push_back(s->state_id);
+    }
+
+    std::reverse(solution.begin(), solution.end());
+}
+
+} // namespace smpl
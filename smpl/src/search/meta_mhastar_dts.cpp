@@ -69,6 +69,12 @@ MetaMHAstarDTS::MetaMHAstarDTS(
     m_goal_state(nullptr),
     m_rng(),
     m_uniform(0.0, 1.0),
+    m_seed_alphas(),
+    m_seed_betas(),
+    m_seed_decay(0.0),
+    m_rng_seed(0),
+    m_replay_decisions(),
+    m_replay_pos(0),
     m_search_states(),
     m_open(nullptr)
 {
@@ -201,9 +207,20 @@ int MetaMHAstarDTS::replan(
         m_open[hidx].push(&m_start_state->od[hidx]);
         SMPL_INFO("Inserted start state %d into search %d with f = %d", m_start_state->state_id, hidx, m_start_state->od[hidx].f);
     }
-    std::fill(m_alphas.begin(), m_alphas.end(), 1.0);
-    std::fill(m_betas.begin(), m_betas.end(), 1.0);
-    m_rng.seed(0);
+    if (m_seed_alphas.size() == (size_t)m_hcount &&
+        m_seed_betas.size() == (size_t)m_hcount)
+    {
+        // resume from the seed posterior, decayed toward the uniform prior,
+        // to skip re-exploring queue preferences learned on similar queries
+        for (int i = 0; i < m_hcount; ++i) {
+            m_alphas[i] = 1.0 + m_seed_decay * (m_seed_alphas[i] - 1.0);
+            m_betas[i] = 1.0 + m_seed_decay * (m_seed_betas[i] - 1.0);
+        }
+    } else {
+        std::fill(m_alphas.begin(), m_alphas.end(), 1.0);
+        std::fill(m_betas.begin(), m_betas.end(), 1.0);
+    }
+    m_rng.seed(m_rng_seed);
 
     auto end_time = smpl::clock::now();
     m_elapsed += to_seconds(end_time - start_time);
@@ -368,6 +385,83 @@ double MetaMHAstarDTS::get_max_time() const
     return m_params.max_time;
 }
 
+void MetaMHAstarDTS::get_dts_posterior(
+    std::vector<double>& alphas,
+    std::vector<double>& betas) const
+{
+    alphas = m_alphas;
+    betas = m_betas;
+}
+
+void MetaMHAstarDTS::seed_dts_posterior(
+    const std::vector<double>& alphas,
+    const std::vector<double>& betas,
+    double decay)
+{
+    if (alphas.size() != (size_t)m_hcount || betas.size() != (size_t)m_hcount) {
+        SMPL_ERROR("Seed posterior must have one (alpha, beta) pair per additional heuristic");
+        return;
+    }
+
+    m_seed_alphas = alphas;
+    m_seed_betas = betas;
+    m_seed_decay = std::max(0.0, std::min(1.0, decay));
+}
+
+void MetaMHAstarDTS::clear_dts_posterior_seed()
+{
+    m_seed_alphas.clear();
+    m_seed_betas.clear();
+    m_seed_decay = 0.0;
+}
+
+void MetaMHAstarDTS::set_rng_seed(unsigned int seed)
+{
+    m_rng_seed = seed;
+}
+
+bool MetaMHAstarDTS::record_decisions(const std::string& path)
+{
+    m_record_file.close();
+    m_record_file.clear();
+    m_record_file.open(path, std::ofstream::out | std::ofstream::trunc);
+    if (!m_record_file.is_open()) {
+        SMPL_ERROR("Failed to open decision log '%s' for writing", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool MetaMHAstarDTS::replay_decisions(const std::string& path)
+{
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        SMPL_ERROR("Failed to open decision log '%s' for reading", path.c_str());
+        return false;
+    }
+
+    std::vector<int> decisions;
+    int hidx;
+    while (f >> hidx) {
+        if (hidx < 1 || hidx > m_hcount) {
+            SMPL_ERROR("Decision log '%s' holds out-of-range queue index %d", path.c_str(), hidx);
+            return false;
+        }
+        decisions.push_back(hidx);
+    }
+
+    m_replay_decisions = std::move(decisions);
+    m_replay_pos = 0;
+    return true;
+}
+
+void MetaMHAstarDTS::clear_decision_io()
+{
+    m_record_file.close();
+    m_replay_decisions.clear();
+    m_replay_pos = 0;
+}
+
 bool MetaMHAstarDTS::check_params(const ReplanParams& params)
 {
     if (params.initial_eps < 1.0) {
@@ -533,13 +627,25 @@ int MetaMHAstarDTS::compute_key(MHASearchState* state, int hidx)
 
 int MetaMHAstarDTS::choose_search()
 {
+    if (m_replay_pos < m_replay_decisions.size()) {
+        const int hidx = m_replay_decisions[m_replay_pos++];
+        SMPL_INFO("Replay Search Choice: %d", hidx);
+        return hidx;
+    }
+
     std::vector<double> r(m_hcount);
     for (int hidx = 0; hidx < m_hcount; ++hidx) {
         boost::math::beta_distribution<double> dist(m_alphas[hidx], m_betas[hidx]);
         r[hidx] = quantile(dist, m_uniform(m_rng));
     }
     SMPL_INFO_STREAM("Choose Search from: " << r);
-    return std::distance(r.begin(), std::max_element(r.begin(), r.end())) + 1;
+    const int chosen =
+            std::distance(r.begin(), std::max_element(r.begin(), r.end())) + 1;
+    if (m_record_file.is_open()) {
+        m_record_file << chosen << '\n';
+        m_record_file.flush();
+    }
+    return chosen;
 }
 
 void MetaMHAstarDTS::update_meta_method(int hidx)
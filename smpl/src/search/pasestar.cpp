@@ -0,0 +1,444 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <smpl/search/pasestar.h>
+
+#include <algorithm>
+#include <thread>
+
+// system includes
+#include <sbpl/utils/key.h>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+static const char* SLOG = "search";
+static const char* SELOG = "search.expansions";
+
+enum ReplanResultCode
+{
+    SUCCESS = 0,
+    PARTIAL_SUCCESS,
+    START_NOT_SET,
+    GOAL_NOT_SET,
+    TIMED_OUT,
+    EXHAUSTED_OPEN_LIST
+};
+
+PASEStar::PASEStar(
+    DiscreteSpaceInformation* space,
+    Heuristic* heuristic,
+    int num_threads)
+:
+    SBPLPlanner(),
+    m_space(space),
+    m_heur(heuristic),
+    m_states()
+{
+    environment_ = space;
+
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+        if (num_threads <= 0) {
+            num_threads = 1;
+        }
+    }
+    m_num_threads = num_threads;
+}
+
+PASEStar::~PASEStar()
+{
+    for (SearchState* s : m_states) {
+        if (s != NULL) {
+            delete s;
+        }
+    }
+}
+
+int PASEStar::replan(double allowed_time_secs, std::vector<int>* solution)
+{
+    int cost;
+    return replan(allowed_time_secs, solution, &cost);
+}
+
+int PASEStar::replan(
+    double allowed_time_secs,
+    std::vector<int>* solution,
+    int* solcost)
+{
+    SMPL_DEBUG_NAMED(SLOG, "Find path to goal");
+
+    if (m_start_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Start state not set");
+        return !START_NOT_SET;
+    }
+    if (m_goal_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Goal state not set");
+        return !GOAL_NOT_SET;
+    }
+
+    // the search tree is not reused between queries; every query searches
+    // from scratch with the current suboptimality bound
+    reinitSearch();
+    m_last_start_state_id = m_start_state_id;
+    m_last_goal_state_id = m_goal_state_id;
+
+    SearchState* start_state = getSearchState(m_start_state_id);
+    SearchState* goal_state = getSearchState(m_goal_state_id);
+
+    reinitSearchState(start_state);
+    reinitSearchState(goal_state);
+
+    start_state->g = 0;
+    start_state->f = computeFval(start_state);
+    m_open.push(start_state);
+
+    m_done = false;
+    m_found = false;
+    m_timed_out = false;
+
+    auto start_time = clock::now();
+    auto deadline = start_time +
+            std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(allowed_time_secs));
+
+    std::vector<std::thread> threads;
+    threads.reserve(m_num_threads - 1);
+    for (int i = 1; i < m_num_threads; ++i) {
+        threads.emplace_back(&PASEStar::workerLoop, this, deadline);
+    }
+    workerLoop(deadline);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    m_search_time = clock::now() - start_time;
+
+    if (!m_found) {
+        if (m_timed_out) {
+            SMPL_DEBUG_NAMED(SLOG, "Ran out of time");
+            return !TIMED_OUT;
+        }
+        SMPL_DEBUG_NAMED(SLOG, "Exhausted open list");
+        return !EXHAUSTED_OPEN_LIST;
+    }
+
+    extractPath(goal_state, *solution, *solcost);
+    SMPL_DEBUG_NAMED(SLOG, "Found path to goal (cost = %d, expansions = %d)",
+            *solcost, m_expand_count);
+    return !SUCCESS;
+}
+
+int PASEStar::replan(std::vector<int>* solution, ReplanParams params)
+{
+    int cost;
+    return replan(solution, params, &cost);
+}
+
+int PASEStar::replan(
+    std::vector<int>* solution,
+    ReplanParams params,
+    int* solcost)
+{
+    m_eps = params.initial_eps;
+    return replan(params.max_time, solution, solcost);
+}
+
+int PASEStar::set_goal(int state_id)
+{
+    m_goal_state_id = state_id;
+    return 1;
+}
+
+int PASEStar::set_start(int state_id)
+{
+    m_start_state_id = state_id;
+    return 1;
+}
+
+int PASEStar::force_planning_from_scratch()
+{
+    m_last_start_state_id = -1;
+    m_last_goal_state_id = -1;
+    return 0;
+}
+
+int PASEStar::set_search_mode(bool bSearchUntilFirstSolution)
+{
+    return 0;
+}
+
+void PASEStar::costs_changed(const StateChangeQuery& stateChange)
+{
+    force_planning_from_scratch();
+}
+
+int PASEStar::force_planning_from_scratch_and_free_memory()
+{
+    force_planning_from_scratch();
+    m_open.clear();
+    m_being_expanded.clear();
+    for (SearchState* s : m_states) {
+        if (s != NULL) {
+            delete s;
+        }
+    }
+    m_states.clear();
+    m_states.shrink_to_fit();
+    return 0;
+}
+
+double PASEStar::get_solution_eps() const
+{
+    return m_eps;
+}
+
+int PASEStar::get_n_expands() const
+{
+    return m_expand_count;
+}
+
+double PASEStar::get_initial_eps()
+{
+    return m_eps;
+}
+
+double PASEStar::get_initial_eps_planning_time()
+{
+    return to_seconds(m_search_time);
+}
+
+double PASEStar::get_final_eps_planning_time()
+{
+    return to_seconds(m_search_time);
+}
+
+int PASEStar::get_n_expands_init_solution()
+{
+    return m_expand_count;
+}
+
+double PASEStar::get_final_epsilon()
+{
+    return m_eps;
+}
+
+void PASEStar::get_search_stats(std::vector<PlannerStats>* s)
+{
+    PlannerStats stats;
+    stats.eps = m_eps;
+    stats.cost = getSearchState(m_goal_state_id)->g;
+    stats.expands = m_expand_count;
+    stats.time = to_seconds(m_search_time);
+    s->push_back(stats);
+}
+
+void PASEStar::set_initialsolution_eps(double eps)
+{
+    m_eps = eps;
+}
+
+// The main loop run by every expansion thread, including the calling thread.
+// Threads claim the best queued state, evaluate its outgoing edges with the
+// mutex released, and apply the successor updates under the mutex. A state
+// whose g-value improves is (re)inserted into OPEN even if it was expanded
+// before or is currently in flight on another thread; monotonically
+// decreasing g-values guarantee termination.
+void PASEStar::workerLoop(clock::time_point deadline)
+{
+    std::vector<int> succs;
+    std::vector<int> costs;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_done) {
+        if (clock::now() >= deadline) {
+            m_timed_out = true;
+            m_done = true;
+            break;
+        }
+
+        if (m_open.empty()) {
+            if (m_being_expanded.empty()) {
+                // no queued states and no expansion that might queue more
+                m_done = true;
+                break;
+            }
+            // wait for an in-flight expansion to queue new states; wake up
+            // periodically to check the deadline
+            m_cv.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        SearchState* s = m_open.min();
+
+        if (goalConditionMet(s)) {
+            m_found = true;
+            m_done = true;
+            break;
+        }
+
+        // never expand the goal state: it can only be the queue minimum
+        // while the bound is unmet when an in-flight expansion with a
+        // smaller priority might still improve it, so wait for those
+        // expansions to settle rather than popping the goal and risking
+        // draining OPEN without a verdict on a solved instance
+        if (s->state_id == m_goal_state_id) {
+            m_cv.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        m_open.pop();
+        m_being_expanded.push_back(s);
+
+        const int expand_g = s->g;
+
+        lock.unlock();
+
+        SMPL_DEBUG_NAMED(SELOG, "Expand state %d", s->state_id);
+        succs.clear();
+        costs.clear();
+        m_space->GetSuccs(s->state_id, &succs, &costs);
+
+        lock.lock();
+
+        for (size_t sidx = 0; sidx < succs.size(); ++sidx) {
+            SearchState* succ_state = getSearchState(succs[sidx]);
+            reinitSearchState(succ_state);
+
+            const int new_cost = expand_g + costs[sidx];
+            if (new_cost < succ_state->g) {
+                succ_state->g = new_cost;
+                succ_state->bp = s;
+                succ_state->f = computeFval(succ_state);
+                if (m_open.contains(succ_state)) {
+                    m_open.decrease(succ_state);
+                } else {
+                    m_open.push(succ_state);
+                }
+            }
+        }
+
+        ++m_expand_count;
+
+        auto it = std::find(
+                m_being_expanded.begin(), m_being_expanded.end(), s);
+        m_being_expanded.erase(it);
+
+        m_cv.notify_all();
+    }
+
+    m_cv.notify_all();
+}
+
+// Test whether the best solution found so far is within the suboptimality
+// bound, i.e. its cost is no greater than the priority of the best queued
+// state or of any in-flight state. Called with the mutex held.
+bool PASEStar::goalConditionMet(const SearchState* min_state) const
+{
+    const SearchState* goal_state = m_states[m_goal_state_id];
+    if (goal_state == NULL || goal_state->call_number != m_call_number) {
+        return false;
+    }
+    if (goal_state->g > min_state->f) {
+        return false;
+    }
+    for (const SearchState* b : m_being_expanded) {
+        if (goal_state->g > b->f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PASEStar::reinitSearch()
+{
+    m_open.clear();
+    m_being_expanded.clear();
+    ++m_call_number;
+    m_expand_count = 0;
+    m_search_time = clock::duration::zero();
+}
+
+PASEStar::SearchState* PASEStar::getSearchState(int state_id)
+{
+    if (m_states.size() <= (size_t)state_id) {
+        m_states.resize(state_id + 1, nullptr);
+    }
+
+    auto& state = m_states[state_id];
+    if (state == NULL) {
+        state = createState(state_id);
+    }
+
+    return state;
+}
+
+PASEStar::SearchState* PASEStar::createState(int state_id)
+{
+    assert(state_id < (int)m_states.size());
+
+    SearchState* ss = new SearchState;
+    ss->state_id = state_id;
+    ss->call_number = 0;
+
+    return ss;
+}
+
+void PASEStar::reinitSearchState(SearchState* state)
+{
+    if (state->call_number != (short)m_call_number) {
+        SMPL_DEBUG_NAMED(SELOG, "Reinitialize state %d", state->state_id);
+        state->g = INFINITECOST;
+        state->h = m_heur->GetGoalHeuristic(state->state_id);
+        state->f = INFINITECOST;
+        state->call_number = (short)m_call_number;
+        state->bp = nullptr;
+    }
+}
+
+int PASEStar::computeFval(const SearchState* s) const
+{
+    return s->g + (int)(m_eps * (double)s->h);
+}
+
+void PASEStar::extractPath(
+    SearchState* goal_state,
+    std::vector<int>& solution,
+    int& cost) const
+{
+    for (SearchState* s = goal_state; s; s = s->bp) {
+        solution.push_back(s->state_id);
+    }
+    std::reverse(solution.begin(), solution.end());
+    cost = goal_state->g;
+}
+
+} // namespace smpl
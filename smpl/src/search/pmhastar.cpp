@@ -0,0 +1,557 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <smpl/search/pmhastar.h>
+
+// standard includes
+#include <stdlib.h>
+#include <algorithm>
+#include <thread>
+
+// system includes
+#include <sbpl/utils/key.h>
+
+// project includes
+#include <smpl/console/console.h>
+
+namespace smpl {
+
+static const char* SLOG = "search";
+static const char* SELOG = "search.expansions";
+
+enum ReplanResultCode
+{
+    SUCCESS = 0,
+    PARTIAL_SUCCESS,
+    START_NOT_SET,
+    GOAL_NOT_SET,
+    TIMED_OUT,
+    EXHAUSTED_OPEN_LIST
+};
+
+PMHAStar::PMHAStar(
+    DiscreteSpaceInformation* space,
+    Heuristic* hanchor,
+    Heuristic** heurs,
+    int hcount,
+    int num_threads)
+:
+    SBPLPlanner(),
+    m_space(space),
+    m_hanchor(hanchor),
+    m_heurs(heurs),
+    m_hcount(hcount),
+    m_states(),
+    m_open(hcount + 1)
+{
+    environment_ = space;
+
+    if (num_threads <= 0) {
+        num_threads = (int)std::thread::hardware_concurrency();
+    }
+    if (num_threads <= 0) {
+        num_threads = 1;
+    }
+    // additional threads beyond one per inadmissible queue have no queue of
+    // their own to drain
+    if (num_threads > hcount && hcount > 0) {
+        num_threads = hcount;
+    }
+    m_num_threads = num_threads;
+}
+
+PMHAStar::~PMHAStar()
+{
+    for (SearchState* s : m_states) {
+        if (s != NULL) {
+            free(s);
+        }
+    }
+}
+
+int PMHAStar::replan(double allowed_time_secs, std::vector<int>* solution)
+{
+    int cost;
+    return replan(allowed_time_secs, solution, &cost);
+}
+
+int PMHAStar::replan(
+    double allowed_time_secs,
+    std::vector<int>* solution,
+    int* solcost)
+{
+    SMPL_DEBUG_NAMED(SLOG, "Find path to goal");
+
+    if (m_start_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Start state not set");
+        return !START_NOT_SET;
+    }
+    if (m_goal_state_id < 0) {
+        SMPL_ERROR_NAMED(SLOG, "Goal state not set");
+        return !GOAL_NOT_SET;
+    }
+
+    // the search tree is not reused between queries; every query searches
+    // from scratch with the current suboptimality bounds
+    reinitSearch();
+
+    SearchState* start_state = getSearchState(m_start_state_id);
+    SearchState* goal_state = getSearchState(m_goal_state_id);
+
+    reinitSearchState(start_state);
+    reinitSearchState(goal_state);
+
+    start_state->g = 0;
+    for (int i = 0; i < m_hcount + 1; ++i) {
+        start_state->od[i].f = computeFval(start_state, i);
+        m_open[i].push(&start_state->od[i]);
+    }
+
+    m_done = false;
+    m_found = false;
+    m_timed_out = false;
+
+    auto start_time = clock::now();
+    auto deadline = start_time +
+            std::chrono::duration_cast<clock::duration>(
+                    std::chrono::duration<double>(allowed_time_secs));
+
+    std::vector<std::thread> threads;
+    threads.reserve(m_num_threads - 1);
+    for (int i = 1; i < m_num_threads; ++i) {
+        threads.emplace_back(&PMHAStar::workerLoop, this, i, deadline);
+    }
+    workerLoop(0, deadline);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    m_search_time = clock::now() - start_time;
+
+    if (!m_found) {
+        if (m_timed_out) {
+            SMPL_DEBUG_NAMED(SLOG, "Ran out of time");
+            return !TIMED_OUT;
+        }
+        SMPL_DEBUG_NAMED(SLOG, "Exhausted open lists");
+        return !EXHAUSTED_OPEN_LIST;
+    }
+
+    extractPath(goal_state, *solution, *solcost);
+    SMPL_DEBUG_NAMED(SLOG, "Found path to goal (cost = %d, expansions = %d)",
+            *solcost, m_expand_count);
+    return !SUCCESS;
+}
+
+int PMHAStar::replan(std::vector<int>* solution, ReplanParams params)
+{
+    int cost;
+    return replan(solution, params, &cost);
+}
+
+int PMHAStar::replan(
+    std::vector<int>* solution,
+    ReplanParams params,
+    int* solcost)
+{
+    m_eps = params.initial_eps;
+    return replan(params.max_time, solution, solcost);
+}
+
+int PMHAStar::set_goal(int state_id)
+{
+    m_goal_state_id = state_id;
+    return 1;
+}
+
+int PMHAStar::set_start(int state_id)
+{
+    m_start_state_id = state_id;
+    return 1;
+}
+
+int PMHAStar::force_planning_from_scratch()
+{
+    return 0;
+}
+
+int PMHAStar::set_search_mode(bool bSearchUntilFirstSolution)
+{
+    return 0;
+}
+
+void PMHAStar::costs_changed(const StateChangeQuery& stateChange)
+{
+    force_planning_from_scratch();
+}
+
+int PMHAStar::force_planning_from_scratch_and_free_memory()
+{
+    for (OpenList& open : m_open) {
+        open.clear();
+    }
+    m_being_expanded.clear();
+    for (SearchState* s : m_states) {
+        if (s != NULL) {
+            free(s);
+        }
+    }
+    m_states.clear();
+    m_states.shrink_to_fit();
+    return 0;
+}
+
+double PMHAStar::get_solution_eps() const
+{
+    return m_eps * m_eps_mha;
+}
+
+int PMHAStar::get_n_expands() const
+{
+    return m_expand_count;
+}
+
+double PMHAStar::get_initial_eps()
+{
+    return m_eps * m_eps_mha;
+}
+
+double PMHAStar::get_initial_eps_planning_time()
+{
+    return to_seconds(m_search_time);
+}
+
+double PMHAStar::get_final_eps_planning_time()
+{
+    return to_seconds(m_search_time);
+}
+
+int PMHAStar::get_n_expands_init_solution()
+{
+    return m_expand_count;
+}
+
+double PMHAStar::get_final_epsilon()
+{
+    return m_eps * m_eps_mha;
+}
+
+void PMHAStar::get_search_stats(std::vector<PlannerStats>* s)
+{
+    PlannerStats stats;
+    stats.eps = m_eps * m_eps_mha;
+    stats.cost = getSearchState(m_goal_state_id)->g;
+    stats.expands = m_expand_count;
+    stats.time = to_seconds(m_search_time);
+    s->push_back(stats);
+}
+
+void PMHAStar::set_initialsolution_eps(double eps)
+{
+    m_eps = eps;
+}
+
+// The main loop run by every expansion thread, including the calling thread.
+// A thread drains the inadmissible queues it owns, stealing the best
+// admissible state from another queue when its own are empty or suspended by
+// the anchor bound, and falling back to the anchor queue when no inadmissible
+// queue may expand. Claims are made under the mutex by setting the closed
+// flags; edge evaluations run with the mutex released.
+void PMHAStar::workerLoop(int rank, clock::time_point deadline)
+{
+    std::vector<int> succs;
+    std::vector<int> costs;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_done) {
+        if (clock::now() >= deadline) {
+            m_timed_out = true;
+            m_done = true;
+            break;
+        }
+
+        if (goalConditionMet()) {
+            m_found = true;
+            m_done = true;
+            break;
+        }
+
+        int qidx;
+        SearchState* s = selectState(rank, qidx);
+        if (s == NULL) {
+            if (m_being_expanded.empty()) {
+                // no queued states and no expansion that might queue more
+                m_done = true;
+                break;
+            }
+            // wait for an in-flight expansion to queue new states; wake up
+            // periodically to check the deadline
+            m_cv.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        // claim the state for this thread; an anchor expansion finishes the
+        // state entirely while an inadmissible expansion leaves it in the
+        // anchor queue, as in SMHA*
+        if (qidx == 0) {
+            s->closed_in_anc = true;
+            for (int i = 0; i < m_hcount + 1; ++i) {
+                if (m_open[i].contains(&s->od[i])) {
+                    m_open[i].erase(&s->od[i]);
+                }
+            }
+        } else {
+            s->closed_in_add = true;
+            for (int i = 1; i < m_hcount + 1; ++i) {
+                if (m_open[i].contains(&s->od[i])) {
+                    m_open[i].erase(&s->od[i]);
+                }
+            }
+        }
+        m_being_expanded.push_back(s);
+
+        const int expand_g = s->g;
+
+        lock.unlock();
+
+        SMPL_DEBUG_NAMED(SELOG, "Expand state %d from queue %d", s->state_id, qidx);
+        succs.clear();
+        costs.clear();
+        m_space->GetSuccs(s->state_id, &succs, &costs);
+
+        lock.lock();
+
+        for (size_t sidx = 0; sidx < succs.size(); ++sidx) {
+            SearchState* succ_state = getSearchState(succs[sidx]);
+            reinitSearchState(succ_state);
+
+            const int new_cost = expand_g + costs[sidx];
+            if (new_cost < succ_state->g) {
+                succ_state->g = new_cost;
+                succ_state->bp = s;
+                for (int i = 0; i < m_hcount + 1; ++i) {
+                    if (i == 0 ? succ_state->closed_in_anc
+                               : succ_state->closed_in_add)
+                    {
+                        continue;
+                    }
+                    succ_state->od[i].f = computeFval(succ_state, i);
+                    if (m_open[i].contains(&succ_state->od[i])) {
+                        m_open[i].decrease(&succ_state->od[i]);
+                    } else {
+                        m_open[i].push(&succ_state->od[i]);
+                    }
+                }
+            }
+        }
+
+        ++m_expand_count;
+
+        auto it = std::find(
+                m_being_expanded.begin(), m_being_expanded.end(), s);
+        m_being_expanded.erase(it);
+
+        m_cv.notify_all();
+    }
+
+    m_cv.notify_all();
+}
+
+// Select the next state for this thread to expand, preferring the thread's
+// own queues, then the other inadmissible queues (work stealing), then the
+// anchor queue. Inadmissible queues may only serve states whose priority is
+// within the anchor bound. Called with the mutex held; returns NULL when no
+// queue has a state to expand.
+PMHAStar::SearchState* PMHAStar::selectState(int rank, int& qidx)
+{
+    const int bound = anchorBound();
+
+    SearchState::HeapData* best = NULL;
+    int best_q = -1;
+
+    for (int i = 1; i < m_hcount + 1; ++i) {
+        if ((i - 1) % m_num_threads != rank || m_open[i].empty()) {
+            continue;
+        }
+        SearchState::HeapData* d = m_open[i].min();
+        if (d->f <= bound && (best == NULL || d->f < best->f)) {
+            best = d;
+            best_q = i;
+        }
+    }
+
+    if (best == NULL) {
+        for (int i = 1; i < m_hcount + 1; ++i) {
+            if ((i - 1) % m_num_threads == rank || m_open[i].empty()) {
+                continue;
+            }
+            SearchState::HeapData* d = m_open[i].min();
+            if (d->f <= bound && (best == NULL || d->f < best->f)) {
+                best = d;
+                best_q = i;
+            }
+        }
+    }
+
+    if (best == NULL && !m_open[0].empty()) {
+        best = m_open[0].min();
+        best_q = 0;
+    }
+
+    if (best == NULL) {
+        return NULL;
+    }
+
+    qidx = best_q;
+    return best->me;
+}
+
+// Test whether the best solution found so far is within the anchor
+// suboptimality factor of the minimum anchor priority, accounting for
+// in-flight expansions. Called with the mutex held.
+bool PMHAStar::goalConditionMet() const
+{
+    const SearchState* goal_state = (size_t)m_goal_state_id < m_states.size() ?
+            m_states[m_goal_state_id] : NULL;
+    if (goal_state == NULL ||
+        goal_state->call_number != m_call_number ||
+        goal_state->g == INFINITECOST)
+    {
+        return false;
+    }
+    return goal_state->g <= anchorBound();
+}
+
+// Return the anchor suboptimality bound: the anchor suboptimality factor
+// times the minimum anchor priority over queued and in-flight states. Called
+// with the mutex held.
+int PMHAStar::anchorBound() const
+{
+    int min_f = INFINITECOST;
+    if (!m_open[0].empty()) {
+        min_f = m_open[0].min()->f;
+    }
+    for (const SearchState* s : m_being_expanded) {
+        min_f = std::min(min_f, s->od[0].f);
+    }
+    if (min_f == INFINITECOST) {
+        return INFINITECOST;
+    }
+    return (int)std::min((double)INFINITECOST, m_eps_mha * (double)min_f);
+}
+
+void PMHAStar::reinitSearch()
+{
+    for (OpenList& open : m_open) {
+        open.clear();
+    }
+    m_being_expanded.clear();
+    ++m_call_number;
+    m_expand_count = 0;
+    m_search_time = clock::duration::zero();
+}
+
+PMHAStar::SearchState* PMHAStar::getSearchState(int state_id)
+{
+    if (m_states.size() <= (size_t)state_id) {
+        m_states.resize(state_id + 1, nullptr);
+    }
+
+    auto& state = m_states[state_id];
+    if (state == NULL) {
+        state = createState(state_id);
+    }
+
+    return state;
+}
+
+PMHAStar::SearchState* PMHAStar::createState(int state_id)
+{
+    assert(state_id < (int)m_states.size());
+
+    // states embed one heap entry per queue beyond the anchor entry
+    size_t state_size =
+            sizeof(SearchState) +
+            m_hcount * sizeof(SearchState::HeapData);
+    SearchState* ss = (SearchState*)malloc(state_size);
+
+    new (ss) SearchState;
+    for (int i = 1; i < m_hcount + 1; ++i) {
+        new (&ss->od[i]) SearchState::HeapData;
+    }
+
+    ss->state_id = state_id;
+    ss->call_number = 0;
+
+    return ss;
+}
+
+void PMHAStar::reinitSearchState(SearchState* state)
+{
+    if (state->call_number != m_call_number) {
+        SMPL_DEBUG_NAMED(SELOG, "Reinitialize state %d", state->state_id);
+        state->g = INFINITECOST;
+        state->call_number = m_call_number;
+        state->bp = nullptr;
+        state->closed_in_anc = false;
+        state->closed_in_add = false;
+        for (int i = 0; i < m_hcount + 1; ++i) {
+            state->od[i].me = state;
+            state->od[i].h = computeHeuristic(state->state_id, i);
+            state->od[i].f = INFINITECOST;
+        }
+    }
+}
+
+int PMHAStar::computeHeuristic(int state_id, int hidx) const
+{
+    if (hidx == 0) {
+        return m_hanchor->GetGoalHeuristic(state_id);
+    }
+    return m_heurs[hidx - 1]->GetGoalHeuristic(state_id);
+}
+
+int PMHAStar::computeFval(const SearchState* s, int hidx) const
+{
+    return s->g + (int)(m_eps * (double)s->od[hidx].h);
+}
+
+void PMHAStar::extractPath(
+    SearchState* goal_state,
+    std::vector<int>& solution,
+    int& cost) const
+{
+    for (SearchState* s = goal_state; s; s = s->bp) {
+        solution.push_back(s->state_id);
+    }
+    std::reverse(solution.begin(), solution.end());
+    cost = goal_state->g;
+}
+
+} // namespace smpl
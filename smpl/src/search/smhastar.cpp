@@ -40,6 +40,7 @@
 #include <sbpl/utils/key.h>
 
 #include <smpl/console/console.h>
+#include <smpl/heuristic/robot_heuristic.h>
 #include <smpl/time.h>
 
 namespace smpl {
@@ -48,11 +49,6 @@ static const char* LOG = "search.smhastar";
 static const char* ELOG = "search.smhastar.expansions";
 static const char* SLOG = "search.smhastar.successors";
 
-static double GetTime()
-{
-    return to_seconds(clock::now().time_since_epoch());
-}
-
 SMHAStar::SMHAStar() : SBPLPlanner()
 {
     // Overwrite default members for ReplanParams to represent a single optimal
@@ -85,6 +81,20 @@ bool SMHAStar::Init(
     m_heurs = heurs;
     m_heur_count = heur_count;
     m_open = new OpenList[heur_count + 1];
+
+    // if every heuristic is a RobotHeuristic, per-state values may be
+    // evaluated in one batch, sharing intermediate results between searches
+    m_robot_heurs.clear();
+    m_robot_heurs.push_back(dynamic_cast<RobotHeuristic*>(anchor));
+    for (int i = 0; i < heur_count; ++i) {
+        m_robot_heurs.push_back(dynamic_cast<RobotHeuristic*>(heurs[i]));
+    }
+    auto is_null = [](const RobotHeuristic* h) { return h == NULL; };
+    if (std::any_of(m_robot_heurs.begin(), m_robot_heurs.end(), is_null)) {
+        m_robot_heurs.clear();
+    }
+    m_h_values.resize(num_heuristics());
+
     return true;
 }
 
@@ -164,7 +174,7 @@ int SMHAStar::replan(std::vector<int>* solution, ReplanParams params, int* solco
     m_num_expansions = 0;
     m_elapsed = 0.0;
 
-    double start_time = GetTime();
+    m_timer.start();
 
     ++m_call_number;
     reinit_state(m_goal_state);
@@ -179,15 +189,14 @@ int SMHAStar::replan(std::vector<int>* solution, ReplanParams params, int* solco
         SMPL_DEBUG_NAMED(LOG, "Inserted start state %d into search %d with f = %d", m_start_state->state_id, i, key);
     }
 
-    double end_time = GetTime();
-    m_elapsed += (end_time - start_time);
+    m_elapsed = to_seconds(m_timer.update());
 
     while (!m_open[0].empty() && !time_limit_reached()) {
-        start_time = GetTime();
 
         // special case for mha* without additional heuristics
         if (num_heuristics() == 1) {
             SMPL_WARN_ONCE("Running SMHA* with only the anchor search?");
+            sync_anchor_open();
             if (m_goal_state->g <= get_minf(m_open[0])) {
                 m_eps_satisfied = m_eps * m_eps_mha;
                 extract_path(solution, solcost);
@@ -199,6 +208,10 @@ int SMHAStar::replan(std::vector<int>* solution, ReplanParams params, int* solco
         }
 
         for (int hidx = 1; hidx < num_heuristics(); ++hidx) {
+            // the anchor queue is about to be consulted for the bound check;
+            // apply the insertions buffered by the previous expansion in batch
+            sync_anchor_open();
+
             if (m_open[0].empty()) {
                 break;
             }
@@ -229,10 +242,12 @@ int SMHAStar::replan(std::vector<int>* solution, ReplanParams params, int* solco
                 }
             }
         }
-        end_time = GetTime();
-        m_elapsed += (end_time - start_time);
+        sync_anchor_open(); // keep the loop condition accurate
+        m_elapsed = to_seconds(m_timer.tick());
     }
 
+    m_elapsed = to_seconds(m_timer.update());
+
     if (m_open[0].empty()) {
         SMPL_DEBUG_NAMED(LOG, "Anchor search exhausted");
     }
@@ -464,10 +479,12 @@ void SMHAStar::init_state(SMHAState* state, size_t mha_state_idx, int state_id)
     state->state_id = state_id;
     state->closed_in_anc = false;
     state->closed_in_add = false;
+    state->anchor_deferred = false;
     for (int i = 0; i < num_heuristics(); ++i) {
         state->od[i].me = state;
-        state->od[i].h = compute_heuristic(state->state_id, i);
     }
+    // heuristic values are filled in by reinit_state when the state is first
+    // touched during a search iteration
 }
 
 void SMHAStar::reinit_state(SMHAState* state)
@@ -479,9 +496,26 @@ void SMHAStar::reinit_state(SMHAState* state)
 
         state->closed_in_anc = false;
         state->closed_in_add = false;
+        state->anchor_deferred = false;
+
+        if (!m_robot_heurs.empty()) {
+            // batched evaluation shares the state's projection between
+            // heuristics instead of recomputing it for every queue
+            GetGoalHeuristics(
+                    m_robot_heurs.data(),
+                    num_heuristics(),
+                    state->state_id,
+                    m_h_values.data());
+            for (int i = 0; i < num_heuristics(); ++i) {
+                state->od[i].h = m_h_values[i];
+            }
+        } else {
+            for (int i = 0; i < num_heuristics(); ++i) {
+                state->od[i].h = compute_heuristic(state->state_id, i);
+            }
+        }
 
         for (int i = 0; i < num_heuristics(); ++i) {
-            state->od[i].h = compute_heuristic(state->state_id, i);
             state->od[i].f = INFINITECOST;
         }
     }
@@ -494,6 +528,11 @@ void SMHAStar::reinit_search()
 
 void SMHAStar::clear_open_lists()
 {
+    for (size_t i = 0; i < m_anchor_deferred.size(); ++i) {
+        m_anchor_deferred[i]->me->anchor_deferred = false;
+    }
+    m_anchor_deferred.clear();
+
     for (int i = 0; i < num_heuristics(); ++i) {
         m_open[i].clear();
     }
@@ -510,6 +549,13 @@ void SMHAStar::expand(SMHAState* state, int hidx)
 
     assert(!closed_in_add_search(state) || !closed_in_anc_search(state));
 
+    if (m_trace) {
+        m_trace->record(
+                state->state_id,
+                state->od[hidx].f, state->g, state->od[hidx].h,
+                (std::uint16_t)hidx, 0);
+    }
+
     if (hidx == 0) {
         state->closed_in_anc = true;
     } else {
@@ -517,12 +563,13 @@ void SMHAStar::expand(SMHAState* state, int hidx)
     }
     ++m_num_expansions;
 
-    // remove s from all open lists
+    // remove s from all open lists, including any buffered anchor insertion
     for (int i = 0; i < num_heuristics(); ++i) {
         if (m_open[i].contains(&state->od[i])) {
             m_open[i].erase(&state->od[i]);
         }
     }
+    state->anchor_deferred = false;
 
     std::vector<int> succ_ids;
     std::vector<int> costs;
@@ -543,7 +590,7 @@ void SMHAStar::expand(SMHAState* state, int hidx)
             if (!closed_in_anc_search(succ_state)) {
                 int fanchor = compute_key(succ_state, 0);
                 succ_state->od[0].f = fanchor;
-                insert_or_update(succ_state, 0);
+                defer_anchor_insert(succ_state);
                 SMPL_DEBUG_NAMED(LOG, "  Update in search %d with f = %d", 0, fanchor);
 
                 if (!closed_in_add_search(succ_state)) {
@@ -593,6 +640,43 @@ void SMHAStar::insert_or_update(SMHAState* state, int hidx)
     }
 }
 
+// States already in the anchor open list are repositioned immediately; new
+// states are buffered for the batch push in sync_anchor_open(). The state's
+// anchor key is up to date before this call, so re-deferring an already
+// buffered state requires no work.
+void SMHAStar::defer_anchor_insert(SMHAState* state)
+{
+    if (m_open[0].contains(&state->od[0])) {
+        m_open[0].update(&state->od[0]);
+    } else if (!state->anchor_deferred) {
+        state->anchor_deferred = true;
+        m_anchor_deferred.push_back(&state->od[0]);
+    }
+}
+
+// Apply buffered anchor open list insertions in one batch push. States
+// expanded since they were buffered have had their deferred flag cleared and
+// are dropped here.
+void SMHAStar::sync_anchor_open()
+{
+    if (m_anchor_deferred.empty()) {
+        return;
+    }
+
+    auto expanded = [](const SMHAState::HeapData* od) {
+        return !od->me->anchor_deferred;
+    };
+    auto last = std::remove_if(
+            m_anchor_deferred.begin(), m_anchor_deferred.end(), expanded);
+
+    for (auto it = m_anchor_deferred.begin(); it != last; ++it) {
+        (*it)->me->anchor_deferred = false;
+    }
+
+    m_open[0].push(m_anchor_deferred.begin(), last);
+    m_anchor_deferred.clear();
+}
+
 void SMHAStar::extract_path(std::vector<int>* solution_path, int* solcost)
 {
     SMPL_DEBUG_NAMED(LOG, "Extracting path");
@@ -0,0 +1,342 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/spatial_batch.h>
+
+// standard includes
+#include <cmath>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace smpl {
+
+void ComposePoses(
+    const ConstPoseArrayView& a,
+    const ConstPoseArrayView& b,
+    const PoseArrayView& out,
+    int count)
+{
+    int i = 0;
+#ifdef __AVX__
+    const __m256d two = _mm256_set1_pd(2.0);
+    for (; i + 4 <= count; i += 4) {
+        const __m256d aw = _mm256_loadu_pd(a.qw + i);
+        const __m256d ax = _mm256_loadu_pd(a.qx + i);
+        const __m256d ay = _mm256_loadu_pd(a.qy + i);
+        const __m256d az = _mm256_loadu_pd(a.qz + i);
+        const __m256d bw = _mm256_loadu_pd(b.qw + i);
+        const __m256d bx = _mm256_loadu_pd(b.qx + i);
+        const __m256d by = _mm256_loadu_pd(b.qy + i);
+        const __m256d bz = _mm256_loadu_pd(b.qz + i);
+
+        const __m256d qw = _mm256_sub_pd(
+                _mm256_sub_pd(_mm256_mul_pd(aw, bw), _mm256_mul_pd(ax, bx)),
+                _mm256_add_pd(_mm256_mul_pd(ay, by), _mm256_mul_pd(az, bz)));
+        const __m256d qx = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(aw, bx), _mm256_mul_pd(ax, bw)),
+                _mm256_sub_pd(_mm256_mul_pd(ay, bz), _mm256_mul_pd(az, by)));
+        const __m256d qy = _mm256_add_pd(
+                _mm256_sub_pd(_mm256_mul_pd(aw, by), _mm256_mul_pd(ax, bz)),
+                _mm256_add_pd(_mm256_mul_pd(ay, bw), _mm256_mul_pd(az, bx)));
+        const __m256d qz = _mm256_add_pd(
+                _mm256_add_pd(_mm256_mul_pd(aw, bz), _mm256_mul_pd(ax, by)),
+                _mm256_sub_pd(_mm256_mul_pd(az, bw), _mm256_mul_pd(ay, bx)));
+
+        // rotate b's translation by a's quaternion,
+        // v' = v + qw * t + qv x t, t = 2 * (qv x v)
+        const __m256d vx = _mm256_loadu_pd(b.tx + i);
+        const __m256d vy = _mm256_loadu_pd(b.ty + i);
+        const __m256d vz = _mm256_loadu_pd(b.tz + i);
+        const __m256d cx = _mm256_mul_pd(two,
+                _mm256_sub_pd(_mm256_mul_pd(ay, vz), _mm256_mul_pd(az, vy)));
+        const __m256d cy = _mm256_mul_pd(two,
+                _mm256_sub_pd(_mm256_mul_pd(az, vx), _mm256_mul_pd(ax, vz)));
+        const __m256d cz = _mm256_mul_pd(two,
+                _mm256_sub_pd(_mm256_mul_pd(ax, vy), _mm256_mul_pd(ay, vx)));
+        const __m256d rx = _mm256_add_pd(
+                _mm256_add_pd(vx, _mm256_mul_pd(aw, cx)),
+                _mm256_sub_pd(_mm256_mul_pd(ay, cz), _mm256_mul_pd(az, cy)));
+        const __m256d ry = _mm256_add_pd(
+                _mm256_add_pd(vy, _mm256_mul_pd(aw, cy)),
+                _mm256_sub_pd(_mm256_mul_pd(az, cx), _mm256_mul_pd(ax, cz)));
+        const __m256d rz = _mm256_add_pd(
+                _mm256_add_pd(vz, _mm256_mul_pd(aw, cz)),
+                _mm256_sub_pd(_mm256_mul_pd(ax, cy), _mm256_mul_pd(ay, cx)));
+
+        const __m256d tx = _mm256_add_pd(_mm256_loadu_pd(a.tx + i), rx);
+        const __m256d ty = _mm256_add_pd(_mm256_loadu_pd(a.ty + i), ry);
+        const __m256d tz = _mm256_add_pd(_mm256_loadu_pd(a.tz + i), rz);
+
+        _mm256_storeu_pd(out.qw + i, qw);
+        _mm256_storeu_pd(out.qx + i, qx);
+        _mm256_storeu_pd(out.qy + i, qy);
+        _mm256_storeu_pd(out.qz + i, qz);
+        _mm256_storeu_pd(out.tx + i, tx);
+        _mm256_storeu_pd(out.ty + i, ty);
+        _mm256_storeu_pd(out.tz + i, tz);
+    }
+#endif
+    for (; i < count; ++i) {
+        const double aw = a.qw[i], ax = a.qx[i], ay = a.qy[i], az = a.qz[i];
+        const double bw = b.qw[i], bx = b.qx[i], by = b.qy[i], bz = b.qz[i];
+
+        const double qw = aw * bw - ax * bx - ay * by - az * bz;
+        const double qx = aw * bx + ax * bw + ay * bz - az * by;
+        const double qy = aw * by - ax * bz + ay * bw + az * bx;
+        const double qz = aw * bz + ax * by - ay * bx + az * bw;
+
+        const double vx = b.tx[i], vy = b.ty[i], vz = b.tz[i];
+        const double cx = 2.0 * (ay * vz - az * vy);
+        const double cy = 2.0 * (az * vx - ax * vz);
+        const double cz = 2.0 * (ax * vy - ay * vx);
+        const double rx = vx + aw * cx + ay * cz - az * cy;
+        const double ry = vy + aw * cy + az * cx - ax * cz;
+        const double rz = vz + aw * cz + ax * cy - ay * cx;
+
+        out.qw[i] = qw;
+        out.qx[i] = qx;
+        out.qy[i] = qy;
+        out.qz[i] = qz;
+        out.tx[i] = a.tx[i] + rx;
+        out.ty[i] = a.ty[i] + ry;
+        out.tz[i] = a.tz[i] + rz;
+    }
+}
+
+void InvertPoses(
+    const ConstPoseArrayView& poses,
+    const PoseArrayView& out,
+    int count)
+{
+    int i = 0;
+#ifdef __AVX__
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d two = _mm256_set1_pd(2.0);
+    for (; i + 4 <= count; i += 4) {
+        const __m256d qw = _mm256_loadu_pd(poses.qw + i);
+        // the conjugate's vector part
+        const __m256d qx = _mm256_sub_pd(zero, _mm256_loadu_pd(poses.qx + i));
+        const __m256d qy = _mm256_sub_pd(zero, _mm256_loadu_pd(poses.qy + i));
+        const __m256d qz = _mm256_sub_pd(zero, _mm256_loadu_pd(poses.qz + i));
+
+        // t' = -(q^-1 * t)
+        const __m256d vx = _mm256_loadu_pd(poses.tx + i);
+        const __m256d vy = _mm256_loadu_pd(poses.ty + i);
+        const __m256d vz = _mm256_loadu_pd(poses.tz + i);
+        const __m256d cx = _mm256_mul_pd(two,
+                _mm256_sub_pd(_mm256_mul_pd(qy, vz), _mm256_mul_pd(qz, vy)));
+        const __m256d cy = _mm256_mul_pd(two,
+                _mm256_sub_pd(_mm256_mul_pd(qz, vx), _mm256_mul_pd(qx, vz)));
+        const __m256d cz = _mm256_mul_pd(two,
+                _mm256_sub_pd(_mm256_mul_pd(qx, vy), _mm256_mul_pd(qy, vx)));
+        const __m256d rx = _mm256_add_pd(
+                _mm256_add_pd(vx, _mm256_mul_pd(qw, cx)),
+                _mm256_sub_pd(_mm256_mul_pd(qy, cz), _mm256_mul_pd(qz, cy)));
+        const __m256d ry = _mm256_add_pd(
+                _mm256_add_pd(vy, _mm256_mul_pd(qw, cy)),
+                _mm256_sub_pd(_mm256_mul_pd(qz, cx), _mm256_mul_pd(qx, cz)));
+        const __m256d rz = _mm256_add_pd(
+                _mm256_add_pd(vz, _mm256_mul_pd(qw, cz)),
+                _mm256_sub_pd(_mm256_mul_pd(qx, cy), _mm256_mul_pd(qy, cx)));
+
+        _mm256_storeu_pd(out.qw + i, qw);
+        _mm256_storeu_pd(out.qx + i, qx);
+        _mm256_storeu_pd(out.qy + i, qy);
+        _mm256_storeu_pd(out.qz + i, qz);
+        _mm256_storeu_pd(out.tx + i, _mm256_sub_pd(zero, rx));
+        _mm256_storeu_pd(out.ty + i, _mm256_sub_pd(zero, ry));
+        _mm256_storeu_pd(out.tz + i, _mm256_sub_pd(zero, rz));
+    }
+#endif
+    for (; i < count; ++i) {
+        const double qw = poses.qw[i];
+        const double qx = -poses.qx[i];
+        const double qy = -poses.qy[i];
+        const double qz = -poses.qz[i];
+
+        const double vx = poses.tx[i], vy = poses.ty[i], vz = poses.tz[i];
+        const double cx = 2.0 * (qy * vz - qz * vy);
+        const double cy = 2.0 * (qz * vx - qx * vz);
+        const double cz = 2.0 * (qx * vy - qy * vx);
+        const double rx = vx + qw * cx + qy * cz - qz * cy;
+        const double ry = vy + qw * cy + qz * cx - qx * cz;
+        const double rz = vz + qw * cz + qx * cy - qy * cx;
+
+        out.qw[i] = qw;
+        out.qx[i] = qx;
+        out.qy[i] = qy;
+        out.qz[i] = qz;
+        out.tx[i] = -rx;
+        out.ty[i] = -ry;
+        out.tz[i] = -rz;
+    }
+}
+
+void NormalizeQuaternions(double* qw, double* qx, double* qy, double* qz, int count)
+{
+    int i = 0;
+#ifdef __AVX__
+    const __m256d one = _mm256_set1_pd(1.0);
+    for (; i + 4 <= count; i += 4) {
+        const __m256d w = _mm256_loadu_pd(qw + i);
+        const __m256d x = _mm256_loadu_pd(qx + i);
+        const __m256d y = _mm256_loadu_pd(qy + i);
+        const __m256d z = _mm256_loadu_pd(qz + i);
+        __m256d n2 = _mm256_mul_pd(w, w);
+        n2 = _mm256_add_pd(n2, _mm256_mul_pd(x, x));
+        n2 = _mm256_add_pd(n2, _mm256_mul_pd(y, y));
+        n2 = _mm256_add_pd(n2, _mm256_mul_pd(z, z));
+        const __m256d s = _mm256_div_pd(one, _mm256_sqrt_pd(n2));
+        _mm256_storeu_pd(qw + i, _mm256_mul_pd(w, s));
+        _mm256_storeu_pd(qx + i, _mm256_mul_pd(x, s));
+        _mm256_storeu_pd(qy + i, _mm256_mul_pd(y, s));
+        _mm256_storeu_pd(qz + i, _mm256_mul_pd(z, s));
+    }
+#endif
+    for (; i < count; ++i) {
+        const double w = qw[i], x = qx[i], y = qy[i], z = qz[i];
+        const double s = 1.0 / std::sqrt(w * w + x * x + y * y + z * z);
+        qw[i] = w * s;
+        qx[i] = x * s;
+        qy[i] = y * s;
+        qz[i] = z * s;
+    }
+}
+
+void RotationsFromEulerZYX(
+    const double* yaw,
+    const double* pitch,
+    const double* roll,
+    double* qw, double* qx, double* qy, double* qz,
+    int count)
+{
+    int i = 0;
+#ifdef __AVX__
+    // the half-angle trigonometry stays scalar; the product assembly runs on
+    // full blocks
+    for (; i + 4 <= count; i += 4) {
+        double cy[4], sy[4], cp[4], sp[4], cr[4], sr[4];
+        for (int l = 0; l < 4; ++l) {
+            cy[l] = std::cos(0.5 * yaw[i + l]);
+            sy[l] = std::sin(0.5 * yaw[i + l]);
+            cp[l] = std::cos(0.5 * pitch[i + l]);
+            sp[l] = std::sin(0.5 * pitch[i + l]);
+            cr[l] = std::cos(0.5 * roll[i + l]);
+            sr[l] = std::sin(0.5 * roll[i + l]);
+        }
+        const __m256d vcy = _mm256_loadu_pd(cy);
+        const __m256d vsy = _mm256_loadu_pd(sy);
+        const __m256d vcp = _mm256_loadu_pd(cp);
+        const __m256d vsp = _mm256_loadu_pd(sp);
+        const __m256d vcr = _mm256_loadu_pd(cr);
+        const __m256d vsr = _mm256_loadu_pd(sr);
+
+        const __m256d cc = _mm256_mul_pd(vcr, vcp);
+        const __m256d cs = _mm256_mul_pd(vcr, vsp);
+        const __m256d sc = _mm256_mul_pd(vsr, vcp);
+        const __m256d ss = _mm256_mul_pd(vsr, vsp);
+
+        _mm256_storeu_pd(qw + i, _mm256_add_pd(
+                _mm256_mul_pd(cc, vcy), _mm256_mul_pd(ss, vsy)));
+        _mm256_storeu_pd(qx + i, _mm256_sub_pd(
+                _mm256_mul_pd(sc, vcy), _mm256_mul_pd(cs, vsy)));
+        _mm256_storeu_pd(qy + i, _mm256_add_pd(
+                _mm256_mul_pd(cs, vcy), _mm256_mul_pd(sc, vsy)));
+        _mm256_storeu_pd(qz + i, _mm256_sub_pd(
+                _mm256_mul_pd(cc, vsy), _mm256_mul_pd(ss, vcy)));
+    }
+#endif
+    for (; i < count; ++i) {
+        const double cy = std::cos(0.5 * yaw[i]);
+        const double sy = std::sin(0.5 * yaw[i]);
+        const double cp = std::cos(0.5 * pitch[i]);
+        const double sp = std::sin(0.5 * pitch[i]);
+        const double cr = std::cos(0.5 * roll[i]);
+        const double sr = std::sin(0.5 * roll[i]);
+        qw[i] = cr * cp * cy + sr * sp * sy;
+        qx[i] = sr * cp * cy - cr * sp * sy;
+        qy[i] = cr * sp * cy + sr * cp * sy;
+        qz[i] = cr * cp * sy - sr * sp * cy;
+    }
+}
+
+void TransformPoints(
+    const Affine3& transform,
+    const double* x, const double* y, const double* z,
+    double* ox, double* oy, double* oz,
+    int count)
+{
+    const Matrix3 R = transform.linear();
+    const Vector3 t = transform.translation();
+
+    int i = 0;
+#ifdef __AVX__
+    const __m256d r00 = _mm256_set1_pd(R(0, 0));
+    const __m256d r01 = _mm256_set1_pd(R(0, 1));
+    const __m256d r02 = _mm256_set1_pd(R(0, 2));
+    const __m256d r10 = _mm256_set1_pd(R(1, 0));
+    const __m256d r11 = _mm256_set1_pd(R(1, 1));
+    const __m256d r12 = _mm256_set1_pd(R(1, 2));
+    const __m256d r20 = _mm256_set1_pd(R(2, 0));
+    const __m256d r21 = _mm256_set1_pd(R(2, 1));
+    const __m256d r22 = _mm256_set1_pd(R(2, 2));
+    const __m256d vtx = _mm256_set1_pd(t.x());
+    const __m256d vty = _mm256_set1_pd(t.y());
+    const __m256d vtz = _mm256_set1_pd(t.z());
+    for (; i + 4 <= count; i += 4) {
+        const __m256d px = _mm256_loadu_pd(x + i);
+        const __m256d py = _mm256_loadu_pd(y + i);
+        const __m256d pz = _mm256_loadu_pd(z + i);
+        const __m256d rx = _mm256_add_pd(vtx, _mm256_add_pd(
+                _mm256_mul_pd(r00, px),
+                _mm256_add_pd(_mm256_mul_pd(r01, py), _mm256_mul_pd(r02, pz))));
+        const __m256d ry = _mm256_add_pd(vty, _mm256_add_pd(
+                _mm256_mul_pd(r10, px),
+                _mm256_add_pd(_mm256_mul_pd(r11, py), _mm256_mul_pd(r12, pz))));
+        const __m256d rz = _mm256_add_pd(vtz, _mm256_add_pd(
+                _mm256_mul_pd(r20, px),
+                _mm256_add_pd(_mm256_mul_pd(r21, py), _mm256_mul_pd(r22, pz))));
+        _mm256_storeu_pd(ox + i, rx);
+        _mm256_storeu_pd(oy + i, ry);
+        _mm256_storeu_pd(oz + i, rz);
+    }
+#endif
+    for (; i < count; ++i) {
+        const double px = x[i], py = y[i], pz = z[i];
+        ox[i] = R(0, 0) * px + R(0, 1) * py + R(0, 2) * pz + t.x();
+        oy[i] = R(1, 0) * px + R(1, 1) * py + R(1, 2) * pz + t.y();
+        oz[i] = R(2, 0) * px + R(2, 1) * py + R(2, 2) * pz + t.z();
+    }
+}
+
+} // namespace smpl
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/stats.h>
+
+// standard includes
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+
+namespace smpl {
+
+StatsRecorder::StatsRecorder(size_t capacity) :
+    m_events(capacity ? capacity : 1),
+    m_head(0),
+    m_size(0),
+    m_dropped(0),
+    m_start(clock::now())
+{
+}
+
+void StatsRecorder::record(
+    std::uint16_t kind,
+    std::uint16_t tag,
+    std::uint32_t count,
+    double value)
+{
+    StatEvent& e = m_events[(m_head + m_size) % m_events.size()];
+    e.time = to_seconds(clock::now() - m_start);
+    e.value = value;
+    e.count = count;
+    e.kind = kind;
+    e.tag = tag;
+
+    if (m_size < m_events.size()) {
+        ++m_size;
+    } else {
+        // overwrote the oldest event
+        m_head = (m_head + 1) % m_events.size();
+        ++m_dropped;
+    }
+}
+
+void StatsRecorder::snapshot(std::vector<StatEvent>& events) const
+{
+    events.resize(m_size);
+    for (size_t i = 0; i < m_size; ++i) {
+        events[i] = m_events[(m_head + i) % m_events.size()];
+    }
+}
+
+bool StatsRecorder::dump(const char* path) const
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+
+    // the buffered events occupy at most two contiguous runs
+    size_t first_run = std::min(m_size, m_events.size() - m_head);
+    size_t second_run = m_size - first_run;
+    bool ok =
+            fwrite(&m_events[m_head], sizeof(StatEvent), first_run, f) ==
+                    first_run &&
+            (second_run == 0 ||
+            fwrite(&m_events[0], sizeof(StatEvent), second_run, f) ==
+                    second_run);
+
+    fclose(f);
+    return ok;
+}
+
+void StatsRecorder::clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_dropped = 0;
+    m_start = clock::now();
+}
+
+ExpansionTrace::ExpansionTrace(size_t capacity) :
+    m_records(capacity ? capacity : 1),
+    m_head(0),
+    m_size(0),
+    m_dropped(0),
+    m_start(clock::now())
+{
+}
+
+void ExpansionTrace::record(
+    int state_id,
+    unsigned f,
+    unsigned g,
+    unsigned h,
+    std::uint16_t queue,
+    std::uint16_t iteration)
+{
+    ExpansionRecord& e = m_records[(m_head + m_size) % m_records.size()];
+    e.time_us = (std::uint32_t)std::chrono::duration_cast<
+            std::chrono::microseconds>(clock::now() - m_start).count();
+    e.state_id = state_id;
+    e.f = f;
+    e.g = g;
+    e.h = h;
+    e.queue = queue;
+    e.iteration = iteration;
+
+    if (m_size < m_records.size()) {
+        ++m_size;
+    } else {
+        // overwrote the oldest record
+        m_head = (m_head + 1) % m_records.size();
+        ++m_dropped;
+    }
+}
+
+void ExpansionTrace::snapshot(std::vector<ExpansionRecord>& records) const
+{
+    records.resize(m_size);
+    for (size_t i = 0; i < m_size; ++i) {
+        records[i] = m_records[(m_head + i) % m_records.size()];
+    }
+}
+
+bool ExpansionTrace::dump(const char* path) const
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        return false;
+    }
+
+    // the buffered records occupy at most two contiguous runs
+    size_t first_run = std::min(m_size, m_records.size() - m_head);
+    size_t second_run = m_size - first_run;
+    bool ok =
+            fwrite(&m_records[m_head], sizeof(ExpansionRecord), first_run, f) ==
+                    first_run &&
+            (second_run == 0 ||
+            fwrite(&m_records[0], sizeof(ExpansionRecord), second_run, f) ==
+                    second_run);
+
+    fclose(f);
+    return ok;
+}
+
+bool ExpansionTrace::load(const char* path, std::vector<ExpansionRecord>& records)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        return false;
+    }
+
+    ExpansionRecord e;
+    while (fread(&e, sizeof(ExpansionRecord), 1, f) == 1) {
+        records.push_back(e);
+    }
+
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+void ExpansionTrace::clear()
+{
+    m_head = 0;
+    m_size = 0;
+    m_dropped = 0;
+    m_start = clock::now();
+}
+
+MemoryUsageProvider::~MemoryUsageProvider()
+{
+}
+
+} // namespace smpl
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/thread_pool.h>
+
+// standard includes
+#include <memory>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace smpl {
+
+ThreadPool::ThreadPool(int num_threads, bool pin_threads)
+{
+    if (num_threads <= 0) {
+        num_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this, i, pin_threads);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_work_available.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_work_available.notify_one();
+}
+
+void ThreadPool::workerLoop(int index, bool pin)
+{
+#if defined(__linux__)
+    if (pin) {
+        const int cpus = (int)std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % cpus, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_available.wait(lock, [&]() {
+                return m_shutdown || !m_tasks.empty();
+            });
+            if (m_tasks.empty()) {
+                return; // shutting down and drained
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void TaskGroup::run(std::function<void()> task)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_outstanding;
+    }
+    m_pool->submit([this, task]() {
+        task();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (--m_outstanding == 0) {
+            m_done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&]() { return m_outstanding == 0; });
+}
+
+static std::unique_ptr<ThreadPool> g_default_pool;
+static std::mutex g_default_pool_mutex;
+
+ThreadPool* GetDefaultThreadPool()
+{
+    std::lock_guard<std::mutex> lock(g_default_pool_mutex);
+    if (!g_default_pool) {
+        g_default_pool.reset(new ThreadPool);
+    }
+    return g_default_pool.get();
+}
+
+bool InitDefaultThreadPool(int num_threads, bool pin_threads)
+{
+    std::lock_guard<std::mutex> lock(g_default_pool_mutex);
+    if (g_default_pool) {
+        return false;
+    }
+    g_default_pool.reset(new ThreadPool(num_threads, pin_threads));
+    return true;
+}
+
+} // namespace smpl
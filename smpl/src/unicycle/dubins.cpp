@@ -833,4 +833,183 @@ int MakeDubinsPaths(
     return count;
 }
 
+// Arc length, in radians, swept on a unit circle from start_angle to
+// end_angle in the given direction (-1 for left, 1 for right). Equivalent to
+// ComputeArcLength with the tangent point positions elided.
+static
+auto ArcSweep(double start_angle, double end_angle, int direction) -> double
+{
+    auto theta = normalize_angle(end_angle) - normalize_angle(start_angle);
+    if (theta < 0 && direction == -1) {
+        theta += 2.0 * M_PI;
+    } else if (theta > 0 && direction == 1) {
+        theta -= 2.0 * M_PI;
+    }
+    return fabs(theta);
+}
+
+void ComputeDubinsLengths(
+    const double* start_x,
+    const double* start_y,
+    const double* start_theta,
+    const double* goal_x,
+    const double* goal_y,
+    const double* goal_theta,
+    int count,
+    double radius,
+    double* lengths,
+    DubinsWord* words)
+{
+    auto half_pi = 0.5 * M_PI;
+
+    for (auto i = 0; i < count; ++i) {
+        // hoist the heading trig for both poses, shared by all word classes
+        auto cs = cos(start_theta[i]);
+        auto ss = sin(start_theta[i]);
+        auto cg = cos(goal_theta[i]);
+        auto sg = sin(goal_theta[i]);
+
+        // the four turning circle centers
+        auto slx = start_x[i] - radius * ss;
+        auto sly = start_y[i] + radius * cs;
+        auto srx = start_x[i] + radius * ss;
+        auto sry = start_y[i] - radius * cs;
+        auto glx = goal_x[i] - radius * sg;
+        auto gly = goal_y[i] + radius * cg;
+        auto grx = goal_x[i] + radius * sg;
+        auto gry = goal_y[i] - radius * cg;
+
+        // the angles of the start and goal positions about their circle
+        // centers
+        auto sa_l = start_theta[i] - half_pi;
+        auto sa_r = start_theta[i] + half_pi;
+        auto ga_l = goal_theta[i] - half_pi;
+        auto ga_r = goal_theta[i] + half_pi;
+
+        auto best_len = std::numeric_limits<double>::quiet_NaN();
+        auto best_word = DubinsWord::None;
+
+        // RR: outer tangent between the right turning circles at angle
+        // phi + pi/2 about both centers
+        {
+            auto dx = grx - srx;
+            auto dy = gry - sry;
+            auto D = sqrt(dx * dx + dy * dy);
+            if (D > 0.0) {
+                auto ta = atan2(dy, dx) + half_pi;
+                auto arcs = ArcSweep(sa_r, ta, 1) + ArcSweep(ta, ga_r, 1);
+                auto len = radius * arcs + D;
+                if (!(best_len <= len)) {
+                    best_len = len;
+                    best_word = DubinsWord::RR;
+                }
+            }
+        }
+
+        // LL: outer tangent between the left turning circles at angle
+        // phi - pi/2 about both centers
+        {
+            auto dx = glx - slx;
+            auto dy = gly - sly;
+            auto D = sqrt(dx * dx + dy * dy);
+            if (D > 0.0) {
+                auto ta = atan2(dy, dx) - half_pi;
+                auto arcs = ArcSweep(sa_l, ta, -1) + ArcSweep(ta, ga_l, -1);
+                auto len = radius * arcs + D;
+                if (!(best_len <= len)) {
+                    best_len = len;
+                    best_word = DubinsWord::LL;
+                }
+            }
+        }
+
+        // LR: inner tangent from the left start circle to the right goal
+        // circle, leaving the start circle at angle phi - gamma
+        {
+            auto dx = grx - slx;
+            auto dy = gry - sly;
+            auto D = sqrt(dx * dx + dy * dy);
+            if (D >= 2.0 * radius) {
+                auto gamma = acos(2.0 * radius / D);
+                auto ta = atan2(dy, dx) - gamma;
+                auto arcs = ArcSweep(sa_l, ta, -1) +
+                        ArcSweep(ta + M_PI, ga_r, 1);
+                auto len = radius * arcs +
+                        sqrt(D * D - 4.0 * radius * radius);
+                if (!(best_len <= len)) {
+                    best_len = len;
+                    best_word = DubinsWord::LR;
+                }
+            }
+        }
+
+        // RL: inner tangent from the right start circle to the left goal
+        // circle, leaving the start circle at angle phi + gamma
+        {
+            auto dx = glx - srx;
+            auto dy = gly - sry;
+            auto D = sqrt(dx * dx + dy * dy);
+            if (D >= 2.0 * radius) {
+                auto gamma = acos(2.0 * radius / D);
+                auto ta = atan2(dy, dx) + gamma;
+                auto arcs = ArcSweep(sa_r, ta, 1) +
+                        ArcSweep(ta + M_PI, ga_l, -1);
+                auto len = radius * arcs +
+                        sqrt(D * D - 4.0 * radius * radius);
+                if (!(best_len <= len)) {
+                    best_len = len;
+                    best_word = DubinsWord::RL;
+                }
+            }
+        }
+
+        lengths[i] = best_len;
+        words[i] = best_word;
+    }
+}
+
+auto MakeDubinsPath(
+    const Pose2D& start,
+    const Pose2D& goal,
+    double radius,
+    DubinsWord word)
+    -> DubinsMotion
+{
+    auto start_circle_l = DirectionalCircle2d();
+    auto start_circle_r = DirectionalCircle2d();
+    auto goal_circle_l = DirectionalCircle2d();
+    auto goal_circle_r = DirectionalCircle2d();
+    ComputeTurningCircles(start, radius, start_circle_l, start_circle_r);
+    ComputeTurningCircles(goal, radius, goal_circle_l, goal_circle_r);
+
+    switch (word) {
+    case DubinsWord::RR:
+    {
+        auto tangent = ComputeOuterTangent(start_circle_r, goal_circle_r);
+        return ConstructRRPath(
+                start, goal, radius, start_circle_r, goal_circle_r, tangent);
+    }
+    case DubinsWord::LL:
+    {
+        auto tangent = ComputeOuterTangent(start_circle_l, goal_circle_l);
+        return ConstructLLPath(
+                start, goal, radius, start_circle_l, goal_circle_l, tangent);
+    }
+    case DubinsWord::LR:
+    {
+        auto tangent = ComputeInnerTangent(start_circle_l, goal_circle_r);
+        return ConstructLRPath(
+                start, goal, radius, start_circle_l, goal_circle_r, tangent);
+    }
+    case DubinsWord::RL:
+    {
+        auto tangent = ComputeInnerTangent(start_circle_r, goal_circle_l);
+        return ConstructRLPath(
+                start, goal, radius, start_circle_r, goal_circle_l, tangent);
+    }
+    default:
+        return DubinsMotion();
+    }
+}
+
 } // namespace smpl
@@ -0,0 +1,329 @@
+#include <smpl/unicycle/unicycle_mprim.h>
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// project includes
+#include <smpl/angles.h>
+#include <smpl/console/console.h>
+#include <smpl/unicycle/unicycle.h>
+
+namespace smpl {
+
+// Cell centers sit at integer multiples of the resolution, with the start
+// pose of every primitive at the center of cell (0, 0).
+static int PosToCell(double x, double res)
+{
+    return (int)std::floor(x / res + 0.5);
+}
+
+static bool ContainsPoint(
+    const std::vector<Vector2>& poly,
+    double x,
+    double y)
+{
+    auto inside = false;
+    for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+        if (((poly[i].y() > y) != (poly[j].y() > y)) &&
+            (x < (poly[j].x() - poly[i].x()) * (y - poly[i].y()) /
+                    (poly[j].y() - poly[i].y()) + poly[i].x()))
+        {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// Append the cells covered by the footprint posed at a waypoint. Cells whose
+// centers fall within the transformed polygon are covered, along with the
+// cells under the polygon vertices so that footprints thinner than a cell
+// still annotate their outline.
+static void AppendFootprintCells(
+    const std::vector<Vector2>& footprint,
+    const Pose2D& pose,
+    double res,
+    std::vector<UnicycleCell>* cells)
+{
+    if (footprint.empty()) {
+        cells->push_back(
+                UnicycleCell{ PosToCell(pose.x, res), PosToCell(pose.y, res) });
+        return;
+    }
+
+    auto ct = std::cos(pose.theta);
+    auto st = std::sin(pose.theta);
+
+    std::vector<Vector2> poly(footprint.size());
+    auto min_x = std::numeric_limits<double>::infinity();
+    auto min_y = std::numeric_limits<double>::infinity();
+    auto max_x = -std::numeric_limits<double>::infinity();
+    auto max_y = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < footprint.size(); ++i) {
+        auto x = pose.x + ct * footprint[i].x() - st * footprint[i].y();
+        auto y = pose.y + st * footprint[i].x() + ct * footprint[i].y();
+        poly[i] = Vector2(x, y);
+        min_x = std::min(min_x, x);
+        min_y = std::min(min_y, y);
+        max_x = std::max(max_x, x);
+        max_y = std::max(max_y, y);
+        cells->push_back(UnicycleCell{ PosToCell(x, res), PosToCell(y, res) });
+    }
+
+    for (auto gx = PosToCell(min_x, res); gx <= PosToCell(max_x, res); ++gx) {
+        for (auto gy = PosToCell(min_y, res); gy <= PosToCell(max_y, res); ++gy) {
+            if (ContainsPoint(poly, gx * res, gy * res)) {
+                cells->push_back(UnicycleCell{ gx, gy });
+            }
+        }
+    }
+}
+
+// Sample waypoints along a motion and annotate the cells swept by the
+// footprint at each waypoint. Motion is any of the curve types providing
+// operator()(t) over t in [0, 1].
+template <class Motion>
+static void SamplePrimGeometry(
+    const Motion& motion,
+    double length,
+    const UnicyclePrimParams& params,
+    UnicyclePrim* prim)
+{
+    auto samples = std::max(
+            2, (int)std::ceil(length / params.sample_interval) + 1);
+
+    prim->poses.reserve(samples);
+    for (auto i = 0; i < samples; ++i) {
+        auto t = (double)i / (double)(samples - 1);
+        auto pose = motion(t);
+        pose.theta = normalize_angle(pose.theta);
+        prim->poses.push_back(pose);
+        AppendFootprintCells(
+                params.footprint, pose, params.resolution, &prim->swept_cells);
+    }
+
+    std::sort(begin(prim->swept_cells), end(prim->swept_cells));
+    prim->swept_cells.erase(
+            std::unique(begin(prim->swept_cells), end(prim->swept_cells)),
+            end(prim->swept_cells));
+}
+
+bool CompileUnicyclePrims(
+    const UnicyclePrimParams& params,
+    UnicyclePrimTable* table)
+{
+    if ((params.resolution <= 0.0) |
+        (params.theta_count <= 0) |
+        (params.turning_radius <= 0.0) |
+        (params.sample_interval <= 0.0))
+    {
+        return false;
+    }
+
+    UnicyclePrimTable t;
+    t.resolution = params.resolution;
+    t.theta_count = params.theta_count;
+    t.turning_radius = params.turning_radius;
+    t.begin.reserve(params.theta_count + 1);
+
+    auto theta_res = 2.0 * M_PI / (double)params.theta_count;
+
+    for (auto itheta = 0; itheta < params.theta_count; ++itheta) {
+        t.begin.push_back((int)t.prims.size());
+
+        auto start = Pose2D{ 0.0, 0.0, (double)itheta * theta_res };
+
+        for (auto dx = -params.max_cell_radius; dx <= params.max_cell_radius; ++dx) {
+        for (auto dy = -params.max_cell_radius; dy <= params.max_cell_radius; ++dy) {
+            if ((dx == 0) & (dy == 0)) continue; // no turn-in-place curves
+
+            for (auto dtheta = 0; dtheta < params.theta_count; ++dtheta) {
+                auto goal = Pose2D{
+                    (double)dx * params.resolution,
+                    (double)dy * params.resolution,
+                    normalize_angle(start.theta + (double)dtheta * theta_res)
+                };
+
+                UnicyclePrim prim;
+                prim.start_theta = itheta;
+                prim.dx = dx;
+                prim.dy = dy;
+                prim.dtheta = dtheta;
+
+                // prefer the exact unicycle curve, fall back to the shortest
+                // dubins path at the configured turning radius
+                auto um = MakeUnicycleMotion(start, goal);
+                if (um.is_valid() && um.length() <= params.max_length) {
+                    prim.word = DubinsWord::None;
+                    prim.length = um.length();
+                    SamplePrimGeometry(um, prim.length, params, &prim);
+                } else {
+                    double length;
+                    DubinsWord word;
+                    ComputeDubinsLengths(
+                            &start.x, &start.y, &start.theta,
+                            &goal.x, &goal.y, &goal.theta,
+                            1, params.turning_radius, &length, &word);
+                    if (std::isnan(length) || (length > params.max_length)) {
+                        continue;
+                    }
+
+                    auto dm = MakeDubinsPath(
+                            start, goal, params.turning_radius, word);
+                    prim.word = word;
+                    prim.length = length;
+                    SamplePrimGeometry(dm, prim.length, params, &prim);
+                }
+
+                t.prims.push_back(std::move(prim));
+            }
+        }
+        }
+    }
+
+    t.begin.push_back((int)t.prims.size());
+
+    *table = std::move(t);
+    return true;
+}
+
+bool SaveUnicyclePrims(const UnicyclePrimTable& table, const char* path)
+{
+    auto* f = std::fopen(path, "w");
+    if (f == NULL) {
+        SMPL_ERROR("Failed to open '%s' for writing", path);
+        return false;
+    }
+
+    std::fprintf(f, "resolution_m: %f\n", table.resolution);
+    std::fprintf(f, "numberofangles: %d\n", table.theta_count);
+    std::fprintf(f, "turning_radius_m: %f\n", table.turning_radius);
+    std::fprintf(f, "totalprims: %d\n", (int)table.prims.size());
+
+    for (size_t i = 0; i < table.prims.size(); ++i) {
+        auto& prim = table.prims[i];
+        std::fprintf(f, "prim: %d\n", (int)i);
+        std::fprintf(f, "startangle_c: %d\n", prim.start_theta);
+        std::fprintf(f, "endpose_c: %d %d %d\n", prim.dx, prim.dy, prim.dtheta);
+        std::fprintf(f, "word: %d\n", (int)prim.word);
+        std::fprintf(f, "length_m: %f\n", prim.length);
+        std::fprintf(f, "intermediateposes: %d\n", (int)prim.poses.size());
+        for (auto& pose : prim.poses) {
+            std::fprintf(f, "%f %f %f\n", pose.x, pose.y, pose.theta);
+        }
+        std::fprintf(f, "sweptcells: %d\n", (int)prim.swept_cells.size());
+        for (auto& cell : prim.swept_cells) {
+            std::fprintf(f, "%d %d\n", cell.x, cell.y);
+        }
+    }
+
+    std::fclose(f);
+    return true;
+}
+
+bool LoadUnicyclePrims(const char* path, UnicyclePrimTable* table)
+{
+    auto* f = std::fopen(path, "r");
+    if (f == NULL) {
+        SMPL_ERROR("Failed to open '%s' for reading", path);
+        return false;
+    }
+
+    UnicyclePrimTable t;
+    auto prim_count = 0;
+    if (std::fscanf(f, "resolution_m: %lf\n", &t.resolution) != 1 ||
+        std::fscanf(f, "numberofangles: %d\n", &t.theta_count) != 1 ||
+        std::fscanf(f, "turning_radius_m: %lf\n", &t.turning_radius) != 1 ||
+        std::fscanf(f, "totalprims: %d\n", &prim_count) != 1)
+    {
+        SMPL_ERROR("Failed to parse primitive table header from '%s'", path);
+        std::fclose(f);
+        return false;
+    }
+
+    if ((t.resolution <= 0.0) | (t.theta_count <= 0) | (prim_count < 0)) {
+        SMPL_ERROR("Degenerate primitive table header in '%s'", path);
+        std::fclose(f);
+        return false;
+    }
+
+    t.prims.resize(prim_count);
+    for (auto i = 0; i < prim_count; ++i) {
+        auto& prim = t.prims[i];
+        auto index = 0;
+        auto word = 0;
+        auto pose_count = 0;
+        auto cell_count = 0;
+        if (std::fscanf(f, "prim: %d\n", &index) != 1 ||
+            std::fscanf(f, "startangle_c: %d\n", &prim.start_theta) != 1 ||
+            std::fscanf(f, "endpose_c: %d %d %d\n",
+                    &prim.dx, &prim.dy, &prim.dtheta) != 3 ||
+            std::fscanf(f, "word: %d\n", &word) != 1 ||
+            std::fscanf(f, "length_m: %lf\n", &prim.length) != 1 ||
+            std::fscanf(f, "intermediateposes: %d\n", &pose_count) != 1)
+        {
+            SMPL_ERROR("Failed to parse primitive %d from '%s'", i, path);
+            std::fclose(f);
+            return false;
+        }
+
+        if ((word < (int)DubinsWord::RR) | (word > (int)DubinsWord::None) |
+            (prim.start_theta < 0) | (prim.start_theta >= t.theta_count) |
+            (pose_count < 0))
+        {
+            SMPL_ERROR("Malformed primitive %d in '%s'", i, path);
+            std::fclose(f);
+            return false;
+        }
+        prim.word = (DubinsWord)word;
+
+        prim.poses.resize(pose_count);
+        for (auto& pose : prim.poses) {
+            if (std::fscanf(f, "%lf %lf %lf\n",
+                    &pose.x, &pose.y, &pose.theta) != 3)
+            {
+                SMPL_ERROR("Failed to parse waypoints of primitive %d from '%s'", i, path);
+                std::fclose(f);
+                return false;
+            }
+        }
+
+        if (std::fscanf(f, "sweptcells: %d\n", &cell_count) != 1 ||
+            cell_count < 0)
+        {
+            SMPL_ERROR("Failed to parse swept cells of primitive %d from '%s'", i, path);
+            std::fclose(f);
+            return false;
+        }
+        prim.swept_cells.resize(cell_count);
+        for (auto& cell : prim.swept_cells) {
+            if (std::fscanf(f, "%d %d\n", &cell.x, &cell.y) != 2) {
+                SMPL_ERROR("Failed to parse swept cells of primitive %d from '%s'", i, path);
+                std::fclose(f);
+                return false;
+            }
+        }
+    }
+
+    std::fclose(f);
+
+    // rebuild the per-heading grouping; the writer emits primitives grouped
+    // by start heading
+    t.begin.assign(t.theta_count + 1, 0);
+    for (auto i = 0; i < prim_count; ++i) {
+        if (i > 0 && t.prims[i].start_theta < t.prims[i - 1].start_theta) {
+            SMPL_ERROR("Primitives in '%s' are not grouped by start heading", path);
+            return false;
+        }
+        ++t.begin[t.prims[i].start_theta + 1];
+    }
+    for (auto i = 1; i <= t.theta_count; ++i) {
+        t.begin[i] += t.begin[i - 1];
+    }
+
+    *table = std::move(t);
+    return true;
+}
+
+} // namespace smpl
@@ -177,6 +177,12 @@ private:
 
     const moveit::core::LinkModel* m_tip_link = nullptr;
 
+    // ancestor link chain from the model root to the planning link, compiled
+    // whenever the planning link changes; empty when the planning link is
+    // unset. computeFK() composes joint origins and joint transforms along
+    // this chain instead of updating every link transform in the robot.
+    std::vector<const moveit::core::LinkModel*> m_fk_chain;
+
     bool m_redundant_ik_group = false;
     int m_redundant_var_count = 0;
     std::vector<int> m_redundant_var_indices;
@@ -206,6 +212,8 @@ private:
 
     bool transformToPlanningFrame(Eigen::Affine3d& T_model_link) const;
     bool transformToModelFrame(Eigen::Affine3d& T_planning_link) const;
+
+    void compileFkChain();
 };
 
 } // namespace sbpl_interface
@@ -724,9 +724,22 @@ void CollisionWorldSBPL::processWorldUpdateCreate(
     op.world_object = object;
     ConvertObjectToCollisionObjectShallow(object, op.shapes, op.collision_object);
 
-    // attempt insertion into the world collision model
-    auto inserted = m_wcm->insertObject(op.collision_object.get());
-    assert(inserted);
+    // Diff against an inherited representation of this object. When a new
+    // planning scene replays CREATE for every world object, unchanged objects
+    // keep their cached voxels, purely translated objects have their voxel
+    // sets shifted, and only genuinely changed objects are re-voxelized.
+    auto synced = m_wcm->syncObject(op.collision_object.get());
+    assert(synced);
+
+    // release any stale representation of this object from a previous world
+    auto sit = std::find_if(
+            begin(m_collision_objects), end(m_collision_objects),
+            [&](const ObjectRepPair& o) {
+                return o.world_object->id_ == object->id_;
+            });
+    if (sit != end(m_collision_objects)) {
+        m_collision_objects.erase(sit);
+    }
 
     m_collision_objects.push_back(std::move(op));
 }
@@ -759,6 +772,11 @@ void CollisionWorldSBPL::processWorldUpdateMoveShape(
         return;
     }
 
+    // refresh the shape poses copied at creation time so the collision model
+    // can diff them against the object's new poses
+    it->collision_object->shape_poses.assign(
+            begin(object->shape_poses_), end(object->shape_poses_));
+
     auto res = m_wcm->moveShapes(it->collision_object.get());
     assert(res);
 }
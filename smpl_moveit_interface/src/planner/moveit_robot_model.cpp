@@ -35,6 +35,7 @@
 
 // standard includes
 #include <math.h>
+#include <algorithm>
 
 // system includes
 #include <eigen_conversions/eigen_kdl.h>
@@ -398,6 +399,7 @@ bool MoveItRobotModel::init(
     m_var_acc_limits = std::move(var_acc_limits);
 
     m_tip_link = tip_link;
+    compileFkChain();
 
     m_redundant_ik_group = redundant_ik_group;
     m_redundant_var_count = redundant_var_count;
@@ -480,6 +482,7 @@ bool MoveItRobotModel::setPlanningLink(const std::string& name)
     if (name.empty()) {
         // clear the planning link
         m_tip_link = nullptr;
+        compileFkChain();
         return true;
     }
 
@@ -490,9 +493,29 @@ bool MoveItRobotModel::setPlanningLink(const std::string& name)
 
     m_tip_link = m_robot_model->getLinkModel(name);
     assert(m_tip_link);
+    compileFkChain();
     return true;
 }
 
+// Gather the ancestor link chain from the model root to the planning link.
+// The tip's global transform is the composition of each link's joint origin
+// and joint transform along this chain, which lets computeFK() skip the
+// full-robot link transform update for the common single-link query.
+void MoveItRobotModel::compileFkChain()
+{
+    m_fk_chain.clear();
+    if (m_tip_link == NULL) {
+        return;
+    }
+
+    for (auto* link = m_tip_link; link != NULL;
+        link = link->getParentJointModel()->getParentLinkModel())
+    {
+        m_fk_chain.push_back(link);
+    }
+    std::reverse(m_fk_chain.begin(), m_fk_chain.end());
+}
+
 auto MoveItRobotModel::planningLink() const -> const moveit::core::LinkModel*
 {
     return m_tip_link;
@@ -577,6 +600,33 @@ auto MoveItRobotModel::computeFK(
 //    // robot state when we call setJointVariablePosition?
 //    m_robot_state->setJointGroupPositions(m_joint_group, state.data());
 
+    // the common query is for the planning link; compose the compiled
+    // root-to-tip chain directly rather than updating every link transform
+    // in the robot. The robot state keeps its dirty flags, so full updates
+    // elsewhere remain correct.
+    if (!m_fk_chain.empty() && m_tip_link != NULL &&
+        name == m_tip_link->getName())
+    {
+        auto* positions = m_robot_state->getVariablePositions();
+        auto T_model_link = Eigen::Affine3d(Eigen::Affine3d::Identity());
+        Eigen::Affine3d T_joint;
+        for (auto* link : m_fk_chain) {
+            T_model_link = T_model_link * link->getJointOriginTransform();
+            auto* joint = link->getParentJointModel();
+            if (joint->getVariableCount() > 0) {
+                joint->computeTransform(
+                        positions + joint->getFirstVariableIndex(), T_joint);
+                T_model_link = T_model_link * T_joint;
+            }
+        }
+
+        if (!transformToPlanningFrame(T_model_link)) {
+            return Eigen::Affine3d::Identity(); // errors printed within
+        }
+
+        return T_model_link; // actually, T_planning_link
+    }
+
     m_robot_state->updateLinkTransforms();
 
     auto T_model_link = m_robot_state->getGlobalLinkTransform(name);
@@ -550,54 +550,57 @@ bool LoadPlannerConfigurationMapping(
     return true;
 }
 
-// retrive an already-initialized model for a given group
-auto GetModelForGroup(
+// Check out a context for a given (group, planner id) pair, reusing an idle
+// initialized context when one is available and constructing a fresh one,
+// with its own robot model and planner pipeline, when every existing context
+// is held by an outstanding request. Thread-safe; the returned context is
+// exclusive to the caller until the caller drops its reference.
+auto CheckOutPlanningContext(
     SBPLPlannerManager* manager,
-    const std::string& group_name)
-    -> MoveItRobotModel*
+    const std::string& group_name,
+    const std::string& planner_id)
+    -> SBPLPlanningContextPtr
 {
-    auto it = manager->m_sbpl_models.find(group_name);
-    if (it != end(manager->m_sbpl_models)) {
-        ROS_DEBUG_NAMED(PP_LOGGER, "Use existing SBPL Robot Model for group '%s'", group_name.c_str());
-        return it->second.get();
+    SBPLPlanningContextPtr null_context;
+
+    auto key = std::make_pair(group_name, planner_id);
+
+    {
+        std::lock_guard<std::mutex> lock(manager->m_contexts_mutex);
+        auto it = manager->m_contexts.find(key);
+        if (it != end(manager->m_contexts)) {
+            for (auto& entry : it->second) {
+                // the manager holds the only reference => no request is
+                // using this context; handing out a second reference under
+                // the lock marks it busy for concurrent checkouts
+                if (entry.context.use_count() == 1) {
+                    ROS_DEBUG_NAMED(PP_LOGGER, "Reuse SBPL Planning Context for group '%s' and planner '%s'", group_name.c_str(), planner_id.c_str());
+                    return entry.context;
+                }
+            }
+        }
     }
 
+    // all existing contexts are busy => build a new entry, outside the lock
+    // so concurrent checkouts aren't serialized behind model and context
+    // initialization
+
     auto model = smpl::make_unique<MoveItRobotModel>();
     if (!model->init(manager->m_robot_model, group_name)) {
         ROS_WARN_NAMED(PP_LOGGER, "Failed to initialize SBPL Robot Model");
-        return NULL;
-    }
-
-    ROS_INFO_NAMED(PP_LOGGER, "Created SBPL Robot Model for group '%s'", group_name.c_str());
-    auto ent = manager->m_sbpl_models.insert(std::make_pair(group_name, std::move(model)));
-    return ent.first->second.get();
-}
-
-auto GetPlanningContextForPlanner(
-    SBPLPlannerManager* manager,
-    MoveItRobotModel* model,
-    const std::string& planner_id)
-    -> SBPLPlanningContextPtr
-{
-    SBPLPlanningContextPtr null_context;
-    auto it = manager->m_contexts.find(planner_id);
-    if (it != end(manager->m_contexts)) {
-        return it->second;
+        return null_context;
     }
 
     auto context = SBPLPlanningContextPtr(new SBPLPlanningContext(
-            model, "sbpl_planning_context", model->planningGroupName()));
-
-    // find a configuration for this group + planner_id
-    auto& configs = manager->getPlannerConfigurations();
+            model.get(), "sbpl_planning_context", group_name));
 
     // merge parameters from global group parameters and parameters for the
     // selected planning configuration
+    auto& configs = manager->getPlannerConfigurations();
     auto all_params = std::map<std::string, std::string>();
     for (auto& config : configs) {
         auto& name = config.first;
         auto& settings = config.second;
-        auto& group_name = model->planningGroupName();
         if (name == group_name) {
             all_params.insert(begin(settings.config), end(settings.config));
         } else if (name == planner_id) {
@@ -610,7 +613,16 @@ auto GetPlanningContextForPlanner(
         return null_context;
     }
 
-    manager->m_contexts.insert(std::make_pair(planner_id, context));
+    ROS_INFO_NAMED(PP_LOGGER, "Created SBPL Planning Context for group '%s' and planner '%s'", group_name.c_str(), planner_id.c_str());
+
+    {
+        std::lock_guard<std::mutex> lock(manager->m_contexts_mutex);
+        SBPLPlannerManager::ContextEntry entry;
+        entry.model = std::move(model);
+        entry.context = context;
+        manager->m_contexts[key].push_back(std::move(entry));
+    }
+
     return context;
 }
 
@@ -730,17 +742,26 @@ auto SBPLPlannerManager::getPlanningContext(
         return null_context;
     }
 
-    ////////////////////////////////////////
-    // Initialize/Update SBPL Robot Model //
-    ////////////////////////////////////////
+    //////////////////////////////////////
+    // Check out SBPL Planning Context  //
+    //////////////////////////////////////
 
     auto* mutable_me = const_cast<SBPLPlannerManager*>(this);
-    auto* sbpl_model = GetModelForGroup(mutable_me, req.group_name);
-    if (!sbpl_model) {
-        ROS_WARN_NAMED(PP_LOGGER, "No SBPL Robot Model available for group '%s'", req.group_name.c_str());
+    auto sbpl_context = CheckOutPlanningContext(
+            mutable_me, req.group_name, req.planner_id);
+    if (!sbpl_context) {
+        ROS_WARN_NAMED(PP_LOGGER, "No SBPL Planning Context available for group '%s'", req.group_name.c_str());
         return null_context;
     }
 
+    /////////////////////////////
+    // Update SBPL Robot Model //
+    /////////////////////////////
+
+    // the checked-out context owns this model exclusively, so per-request
+    // updates here don't race with concurrent contexts for the same group
+    auto* sbpl_model = sbpl_context->m_robot_model;
+
     auto planning_link = SelectPlanningLink(this, req);
     if (planning_link.empty()) {
         ROS_INFO_NAMED(PP_LOGGER, "Clear the planning link");
@@ -761,17 +782,14 @@ auto SBPLPlannerManager::getPlanningContext(
         return null_context;
     }
 
-    /////////////////////////////////////////////
-    // Initialize/Update SBPL Planning Context //
-    /////////////////////////////////////////////
+    //////////////////////////////////
+    // Update SBPL Planning Context //
+    //////////////////////////////////
 
 #if 0
     LogPlanningScene(*planning_scene);
 #endif
 
-    auto sbpl_context = GetPlanningContextForPlanner(
-            mutable_me, sbpl_model, req.planner_id);
-
     sbpl_context->setPlanningScene(planning_scene);
     sbpl_context->setMotionPlanRequest(req);
 
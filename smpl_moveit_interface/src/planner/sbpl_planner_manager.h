@@ -1,6 +1,14 @@
 #ifndef sbpl_interface_sbpl_planner_manager_h
 #define sbpl_interface_sbpl_planner_manager_h
 
+// standard includes
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
 // system includes
 #include <XmlRpcValue.h>
 #include <moveit/macros/class_forward.h>
@@ -61,12 +69,25 @@ public:
 
     moveit::core::RobotModelConstPtr m_robot_model;
 
-    // per-group sbpl robot model
-    // TODO: make unique per context instance
-    std::map<std::string, std::unique_ptr<MoveItRobotModel>> m_sbpl_models;
-
-    // per-configuration context
-    std::map<std::string, SBPLPlanningContextPtr> m_contexts;
+    // A context together with the sbpl robot model it exclusively owns. The
+    // model is reconfigured per-request (planning scene, frame, and link), so
+    // it is never shared between contexts.
+    struct ContextEntry
+    {
+        std::unique_ptr<MoveItRobotModel> model;
+        SBPLPlanningContextPtr context;
+    };
+
+    // Initialized contexts, keyed by (group name, planner id). An entry is
+    // idle when the manager holds the only reference to its context;
+    // otherwise an outstanding request is still using it and
+    // getPlanningContext() constructs an additional entry, so concurrent
+    // requests receive distinct contexts with distinct planner pipelines.
+    // Guarded by m_contexts_mutex.
+    std::map<std::pair<std::string, std::string>, std::vector<ContextEntry>>
+            m_contexts;
+
+    mutable std::mutex m_contexts_mutex;
 
     smpl::VisualizerROS m_viz;
 
@@ -275,6 +275,12 @@ bool InitPlanningParams(
     }
     pp->interpolate_path = config.at("interpolate_path") == "true";
 
+    {
+        // optional; constant-velocity profiling when unset
+        auto it = config.find("profile_accelerations");
+        pp->profile_accelerations = it != end(config) && it->second == "true";
+    }
+
     //////////////////////////////
     // parse logging parameters //
     //////////////////////////////
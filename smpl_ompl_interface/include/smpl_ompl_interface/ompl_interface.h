@@ -9,6 +9,9 @@
 #include <Eigen/Dense>
 #include <ompl/base/Planner.h>
 
+// project includes
+#include <smpl/types.h>
+
 namespace smpl {
 
 class OccupancyGrid;
@@ -47,7 +50,7 @@ struct OMPLPlanner : public ompl::base::Planner
     ~OMPLPlanner();
 
     using VisualizerFun = std::function<
-            std::vector<smpl::visual::Marker>(const std::vector<double>& state)>;
+            std::vector<smpl::visual::Marker>(const RobotState& state)>;
     void setStateVisualizer(const VisualizerFun& fun);
 
     void setOccupancyGrid(OccupancyGrid* grid);
@@ -71,16 +74,16 @@ struct OMPLPlanner : public ompl::base::Planner
 auto MakeStateSMPL(
     const ompl::base::StateSpace* space,
     const ompl::base::State* state)
-    -> std::vector<double>;
+    -> RobotState;
 
 auto MakeStateOMPL(
     const ompl::base::StateSpace* space,
-    const std::vector<double>& state)
+    const RobotState& state)
     -> ompl::base::State*;
 
 auto MakeStateOMPL(
     const ompl::base::StateSpacePtr& space,
-    const std::vector<double>& state)
+    const RobotState& state)
     -> ompl::base::ScopedState<>;
 
 } // namespace smpl
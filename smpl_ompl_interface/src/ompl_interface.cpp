@@ -1,5 +1,8 @@
 #include <smpl_ompl_interface/ompl_interface.h>
 
+// standard includes
+#include <algorithm>
+
 // system includes
 #include <ompl/base/Planner.h>
 #include <ompl/base/goals/GoalLazySamples.h>
@@ -55,6 +58,47 @@ CallOnDestruct<Callable> MakeCallOnDestruct(Callable c) {
 // executes the given statement sequence
 #define DEFER(fun) auto MAKE_LINE_IDENT(tmp_call_on_destruct_) = ::smpl::detail::MakeCallOnDestruct([&](){ fun; })
 
+//////////////////////////
+// State Space Bridging //
+//////////////////////////
+
+// Copy an smpl state into a preallocated ompl state. Flat real vector spaces,
+// the common case for manipulators, are written straight into the contiguous
+// value array; other spaces fall back to the generic copyFromReals machinery,
+// which walks the substate hierarchy.
+static
+void CopyStateSMPLToOMPL(
+    const ompl::base::StateSpace* space,
+    const smpl::RobotState& state,
+    ompl::base::State* out)
+{
+    if (space->getType() == ompl::base::STATE_SPACE_REAL_VECTOR) {
+        auto* rvs = out->as<ompl::base::RealVectorStateSpace::StateType>();
+        std::copy(state.begin(), state.end(), rvs->values);
+    } else {
+        space->copyFromReals(
+                out, std::vector<double>(state.begin(), state.end()));
+    }
+}
+
+// Copy an ompl state into an smpl state, reading the contiguous value array
+// directly for flat real vector spaces.
+static
+void CopyStateOMPLToSMPL(
+    const ompl::base::StateSpace* space,
+    const ompl::base::State* state,
+    smpl::RobotState& out)
+{
+    if (space->getType() == ompl::base::STATE_SPACE_REAL_VECTOR) {
+        auto* rvs = state->as<ompl::base::RealVectorStateSpace::StateType>();
+        out.assign(rvs->values, rvs->values + space->getDimension());
+    } else {
+        std::vector<double> reals;
+        space->copyToReals(reals, state);
+        out.assign(reals.begin(), reals.end());
+    }
+}
+
 ///////////////////////////////
 // RobotModel Implementation //
 ///////////////////////////////
@@ -82,6 +126,12 @@ struct RobotModel :
     ompl::base::SpaceInformation* si = NULL;
     ompl::base::ProjectionEvaluator* projection = NULL;
 
+    // preallocated state reused by computeFK so the bridge does not allocate
+    // on every projection
+    ompl::base::State* scratch_state = NULL;
+
+    ~RobotModel();
+
     double minPosLimit(int vidx) const override;
     double maxPosLimit(int vidx) const override;
     bool hasPosLimit(int vidx) const override;
@@ -95,6 +145,13 @@ struct RobotModel :
     auto getExtension(size_t class_code) -> smpl::Extension* override;
 };
 
+RobotModel::~RobotModel()
+{
+    if (this->scratch_state != NULL) {
+        this->si->getStateSpace()->freeState(this->scratch_state);
+    }
+}
+
 double RobotModel::minPosLimit(int vidx) const
 {
     return variables[vidx].min_position;
@@ -133,9 +190,13 @@ bool RobotModel::checkJointLimits(const smpl::RobotState& state, bool verbose)
 
 auto RobotModel::computeFK(const smpl::RobotState& state) -> Eigen::Affine3d
 {
-    auto s = MakeStateOMPL(this->si->getStateSpace(), state);
+    auto* space = this->si->getStateSpace().get();
+    if (this->scratch_state == NULL) {
+        this->scratch_state = space->allocState();
+    }
+    CopyStateSMPLToOMPL(space, state, this->scratch_state);
     ompl::base::EuclideanProjection projected;
-    this->projection->project(s.get(), projected);
+    this->projection->project(this->scratch_state, projected);
     return Eigen::Translation3d(projected[0], projected[1], projected[2]) *
             Eigen::AngleAxisd(projected[3], Eigen::Vector3d::UnitZ()) *
             Eigen::AngleAxisd(projected[4], Eigen::Vector3d::UnitY()) *
@@ -169,6 +230,13 @@ struct CollisionChecker : public smpl::CollisionChecker
     ompl::base::MotionValidator* validator;
     OMPLPlanner::VisualizerFun visualizer;
 
+    // preallocated states reused by the validity queries so the bridge does
+    // not allocate per call
+    ompl::base::State* scratch_s = NULL;
+    ompl::base::State* scratch_f = NULL;
+
+    ~CollisionChecker();
+
     /// \name smpl::CollisionChecker Interface
     ///@{
     bool isStateValid(
@@ -195,13 +263,25 @@ struct CollisionChecker : public smpl::CollisionChecker
     ///@}
 };
 
+CollisionChecker::~CollisionChecker()
+{
+    if (this->scratch_s != NULL) {
+        this->space->freeState(this->scratch_s);
+    }
+    if (this->scratch_f != NULL) {
+        this->space->freeState(this->scratch_f);
+    }
+}
+
 bool CollisionChecker::isStateValid(
     const smpl::RobotState& state,
     bool verbose)
 {
-    auto* s = MakeStateOMPL(this->space, state);
-    DEFER(this->space->freeState(s));
-    return this->checker->isValid(s);
+    if (this->scratch_s == NULL) {
+        this->scratch_s = this->space->allocState();
+    }
+    CopyStateSMPLToOMPL(this->space, state, this->scratch_s);
+    return this->checker->isValid(this->scratch_s);
 }
 
 bool CollisionChecker::isStateToStateValid(
@@ -209,11 +289,15 @@ bool CollisionChecker::isStateToStateValid(
     const smpl::RobotState& finish,
     bool verbose)
 {
-    auto* s = MakeStateOMPL(this->space, start);
-    auto* f = MakeStateOMPL(this->space, finish);
-    DEFER(this->space->freeState(s));
-    DEFER(this->space->freeState(f));
-    return this->validator->checkMotion(s, f);
+    if (this->scratch_s == NULL) {
+        this->scratch_s = this->space->allocState();
+    }
+    if (this->scratch_f == NULL) {
+        this->scratch_f = this->space->allocState();
+    }
+    CopyStateSMPLToOMPL(this->space, start, this->scratch_s);
+    CopyStateSMPLToOMPL(this->space, finish, this->scratch_f);
+    return this->validator->checkMotion(this->scratch_s, this->scratch_f);
 }
 
 bool CollisionChecker::interpolatePath(
@@ -1041,7 +1125,7 @@ auto MakeStateSMPL(
     -> smpl::RobotState
 {
     smpl::RobotState s;
-    space->copyToReals(s, state);
+    detail::CopyStateOMPLToSMPL(space, state, s);
     return s;
 };
 
@@ -1051,7 +1135,7 @@ auto MakeStateOMPL(
     -> ompl::base::State*
 {
     auto* s = space->allocState();
-    space->copyFromReals(s, state);
+    detail::CopyStateSMPLToOMPL(space, state, s);
     return s;
 }
 
@@ -1061,7 +1145,7 @@ auto MakeStateOMPL(
     -> ompl::base::ScopedState<>
 {
     auto s = ompl::base::ScopedState<>(space);
-    space->copyFromReals(s.get(), state);
+    detail::CopyStateSMPLToOMPL(space.get(), state, s.get());
     return std::move(s);
 }
 
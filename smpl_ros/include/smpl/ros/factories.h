@@ -107,12 +107,24 @@ auto MakeARAStar(
     const PlanningParams& params)
     -> std::unique_ptr<SBPLPlanner>;
 
+auto MakeBARAStar(
+    RobotPlanningSpace* space,
+    RobotHeuristic* heuristic,
+    const PlanningParams& params)
+    -> std::unique_ptr<SBPLPlanner>;
+
 auto MakeAWAStar(
     RobotPlanningSpace* space,
     RobotHeuristic* heuristic,
     const PlanningParams& params)
     -> std::unique_ptr<SBPLPlanner>;
 
+auto MakeBoundedCostSearch(
+    RobotPlanningSpace* space,
+    RobotHeuristic* heuristic,
+    const PlanningParams& params)
+    -> std::unique_ptr<SBPLPlanner>;
+
 auto MakeMHAStar(
     RobotPlanningSpace* space,
     RobotHeuristic* heuristic,
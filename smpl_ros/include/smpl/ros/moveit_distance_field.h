@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#ifndef SMPL_MOVEIT_DISTANCE_FIELD_H
+#define SMPL_MOVEIT_DISTANCE_FIELD_H
+
+// standard includes
+#include <memory>
+
+// system includes
+#include <moveit/distance_field/distance_field.h>
+
+// project includes
+#include <smpl/distance_map/distance_map_interface.h>
+
+namespace smpl {
+
+/// Exposes a smpl distance map through the moveit distance_field::DistanceField
+/// interface, the reverse direction of PropagationDistanceField. The adapted
+/// map is shared rather than copied, so one propagated field serves both smpl
+/// consumers (OccupancyGrid, CollisionSpace) and MoveIt consumers without a
+/// second copy of the volume or a second propagation per update; modifications
+/// through either interface are visible through both.
+class MoveItDistanceField : public distance_field::DistanceField
+{
+public:
+
+    explicit MoveItDistanceField(
+        const std::shared_ptr<DistanceMapInterface>& dm);
+
+    auto distanceMap() const -> const std::shared_ptr<DistanceMapInterface>&
+    { return m_dm; }
+
+    /// \name Required Public Functions from distance_field::DistanceField
+    ///@{
+    void addPointsToField(const EigenSTL::vector_Vector3d& points) override;
+
+    void removePointsFromField(
+        const EigenSTL::vector_Vector3d& points) override;
+
+    void updatePointsInField(
+        const EigenSTL::vector_Vector3d& old_points,
+        const EigenSTL::vector_Vector3d& new_points) override;
+
+    void reset() override;
+
+    double getDistance(double x, double y, double z) const override;
+    double getDistance(int x, int y, int z) const override;
+
+    bool isCellValid(int x, int y, int z) const override;
+
+    int getXNumCells() const override;
+    int getYNumCells() const override;
+    int getZNumCells() const override;
+
+    bool gridToWorld(
+        int x, int y, int z,
+        double& world_x, double& world_y, double& world_z) const override;
+
+    bool worldToGrid(
+        double world_x, double world_y, double world_z,
+        int& x, int& y, int& z) const override;
+
+    bool writeToStream(std::ostream& stream) const override;
+    bool readFromStream(std::istream& stream) override;
+
+    double getUninitializedDistance() const override;
+    ///@}
+
+private:
+
+    std::shared_ptr<DistanceMapInterface> m_dm;
+
+    std::vector<Eigen::Vector3d> toUnalignedVector(
+        const EigenSTL::vector_Vector3d& v) const;
+};
+
+} // namespace smpl
+
+#endif
@@ -34,9 +34,14 @@
 #define SMPL_PLANNER_INTERFACE_H
 
 // standard includes
+#include <atomic>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // system includes
@@ -56,6 +61,7 @@
 #include <smpl/occupancy_grid.h>
 #include <smpl/planning_params.h>
 #include <smpl/robot_model.h>
+#include <smpl/stats.h>
 #include <smpl/debug/marker.h>
 #include <smpl/graph/robot_planning_space.h>
 #include <smpl/heuristic/robot_heuristic.h>
@@ -96,6 +102,73 @@ public:
         const moveit_msgs::MotionPlanRequest& req,
         moveit_msgs::MotionPlanResponse& res);
 
+    /// \name Asynchronous Planning
+    ///@{
+
+    using SolveCompletionCallback =
+            std::function<void(const moveit_msgs::MotionPlanResponse&)>;
+
+    /// Submit a planning request to be solved on a background thread and
+    /// return a future for the response. At most one request may be in
+    /// flight at a time; if one is already running, an invalid future is
+    /// returned. The optional callback is invoked from the background thread
+    /// once the response is ready, before the future becomes ready. The
+    /// caller must not call solve(), submit(), or init() until the in-flight
+    /// request completes.
+    auto submit(
+        const moveit_msgs::PlanningScene& planning_scene,
+        const moveit_msgs::MotionPlanRequest& req,
+        SolveCompletionCallback callback = SolveCompletionCallback())
+        -> std::future<moveit_msgs::MotionPlanResponse>;
+
+    /// Preempt the in-flight asynchronous request. Searches that support
+    /// cancellation are interrupted at expansion granularity; otherwise the
+    /// search runs out its time budget. The response carries the error code
+    /// PREEMPTED unless a solution had already been found. No-op when no
+    /// request is in flight.
+    void cancel();
+
+    /// Return true if an asynchronous request is currently in flight.
+    bool busy() const { return m_solve_in_flight.load(); }
+
+    ///@}
+
+    /// \name Streaming Trajectory Output
+    ///@{
+
+    using TrajectoryChunkCallback = std::function<
+            void(const moveit_msgs::RobotTrajectory& chunk, bool done)>;
+
+    /// Install a callback to receive the planned trajectory in chunks as it
+    /// is post-processed. With a positive commit horizon, solve() splits the
+    /// raw search path at the horizon, smooths and time-profiles the leading
+    /// waypoints on their own, and hands them to the callback before the
+    /// tail is post-processed, so execution can begin while the remainder is
+    /// smoothed. Smoothing never crosses the committed boundary and the
+    /// profile brings the robot to rest there. Chunk timestamps are relative
+    /// to the start of the whole trajectory and the callback is invoked from
+    /// the planning thread. A null callback disables streaming.
+    void setTrajectoryChunkCallback(
+        TrajectoryChunkCallback callback,
+        int commit_horizon);
+    ///@}
+
+    /// \name Solution Path Cache
+    ///@{
+
+    /// Set the number of recent solution paths retained for reuse. Cached
+    /// paths are keyed by occupancy grid epoch, start configuration, and
+    /// goal pose cell; when a request matches a cached entry, the cached
+    /// path is revalidated with state-to-state sweeps instead of searching.
+    /// Paths that fail revalidation are dropped from the cache and, when the
+    /// active planning space accumulates experience, staged with it as a
+    /// one-path experience for subsequent episodes. 0 disables the cache.
+    void setPathCacheCapacity(size_t capacity);
+    size_t pathCacheCapacity() const { return m_path_cache_capacity; }
+
+    void clearPathCache() { m_path_cache.clear(); }
+    ///@}
+
     static
     bool SupportsGoalConstraints(
         const GoalConstraints& constraints,
@@ -130,6 +203,40 @@ public:
     /// @return The statistics
     auto getPlannerStats() -> std::map<std::string, double>;
 
+    /// @brief Return the approximate bytes held by each planner component.
+    ///
+    /// Components that implement MemoryUsageProvider are reported under the
+    /// keys "search" and "graph" and "heuristic.<name>" for each heuristic;
+    /// components that do not are omitted.
+    ///
+    /// @return Map from component name to approximate bytes held
+    auto getMemoryUsage() const -> std::map<std::string, size_t>;
+
+    /// \name Instrumentation
+    ///@{
+
+    /// Tags of the STAT_EVENT_PHASE events recorded during solve()
+    enum PhaseTag
+    {
+        PHASE_SET_GOAL = 0,
+        PHASE_SET_START,
+        PHASE_SEARCH,
+        PHASE_POST_PROCESS,
+    };
+
+    /// Return the event recorder accumulating per-phase timings from solve()
+    /// and per-iteration search records. The buffer persists across calls to
+    /// solve() and may be snapshotted or dumped at any time.
+    auto stats() -> StatsRecorder& { return m_stats; }
+    auto stats() const -> const StatsRecorder& { return m_stats; }
+
+    /// Return the per-expansion trace recorded by searches that support it.
+    /// The buffer persists across calls to solve() and may be snapshotted or
+    /// dumped at any time.
+    auto expansionTrace() -> ExpansionTrace& { return m_trace; }
+    auto expansionTrace() const -> const ExpansionTrace& { return m_trace; }
+    ///@}
+
     /// \name Visualization
     ///@{
 
@@ -165,8 +272,56 @@ protected:
 
     int m_sol_cost;
 
+    StatsRecorder m_stats;
+    ExpansionTrace m_trace;
+
     std::string m_planner_id;
 
+    /// A constructed (planning space, heuristics, search) triple, retained
+    /// between solve() calls so that switching planner ids swaps pipelines
+    /// instead of reconstructing them
+    struct PlannerPipeline
+    {
+        std::unique_ptr<RobotPlanningSpace> pspace;
+        std::map<std::string, std::unique_ptr<RobotHeuristic>> heuristics;
+        std::unique_ptr<SBPLPlanner> planner;
+    };
+
+    // Warm pipelines from previous requests, keyed by planner id; only the
+    // start and goal are updated when one is reactivated. Invalidated by
+    // init(), since the components capture the planning parameters at
+    // construction.
+    std::map<std::string, PlannerPipeline> m_pipelines;
+
+    // asynchronous solve state; see submit()
+    std::thread m_solve_thread;
+    std::atomic<bool> m_solve_in_flight;
+    std::atomic<bool> m_cancel_requested;
+
+    // the search servicing the current request, for forwarding cancellation
+    // requests at expansion granularity; guarded by m_cancel_mutex
+    std::mutex m_cancel_mutex;
+    SBPLPlanner* m_active_search;
+
+    // streaming trajectory output; see setTrajectoryChunkCallback()
+    TrajectoryChunkCallback m_chunk_callback;
+    int m_commit_horizon;
+
+    // recent solution paths, most recently used first; see
+    // setPathCacheCapacity()
+    struct CachedSolution
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+        Epoch grid_epoch;
+        RobotState start;
+        GoalConstraint goal;
+        std::vector<RobotState> path;
+    };
+    std::vector<CachedSolution, Eigen::aligned_allocator<CachedSolution>>
+            m_path_cache;
+    size_t m_path_cache_capacity = 8;
+
     // Set start configuration
     bool setGoal(const GoalConstraints& v_goal_constraints);
     bool setStart(const moveit_msgs::RobotState& state);
@@ -182,6 +337,9 @@ protected:
 
     bool reinitPlanner(const std::string& planner_id);
 
+    bool lookupCachedPath(std::vector<RobotState>& path);
+    void storeCachedPath(const std::vector<RobotState>& path);
+
     void postProcessPath(std::vector<RobotState>& path) const;
 };
 
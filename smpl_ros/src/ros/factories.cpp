@@ -1,6 +1,7 @@
 #include <smpl/ros/factories.h>
 
 // system includes
+#include <sbpl/planners/araplanner.h>
 #include <smpl/console/console.h>
 #include <smpl/console/nonstd.h>
 #include <smpl/graph/adaptive_workspace_lattice.h>
@@ -22,6 +23,7 @@
 #include <smpl/search/adaptive_planner.h>
 #include <smpl/search/arastar.h>
 #include <smpl/search/awastar.h>
+#include <smpl/search/bounded_cost_search.h>
 #include <smpl/search/experience_graph_planner.h>
 #include <smpl/stl/memory.h>
 
@@ -37,6 +39,7 @@ struct ManipLatticeActionSpaceParams
     bool use_rpy_snap_mprim;
     bool use_xyzrpy_snap_mprim;
     bool use_short_dist_mprims;
+    bool use_action_tiers;
     double xyz_snap_thresh;
     double rpy_snap_thresh;
     double xyzrpy_snap_thresh;
@@ -50,22 +53,25 @@ bool GetManipLatticeActionSpaceParams(
     ManipLatticeActionSpaceParams& params,
     const PlanningParams& pp)
 {
-    if (!pp.getParam("mprim_filename", params.mprim_filename)) {
+    const GraphConfig& config = pp.compiled().graph;
+    if (!config.has_mprim_filename) {
         SMPL_ERROR_NAMED(PI_LOGGER, "Parameter 'mprim_filename' not found in planning params");
         return false;
     }
+    params.mprim_filename = config.mprim_filename;
 
-    pp.param("use_multiple_ik_solutions", params.use_multiple_ik_solutions, false);
+    params.use_multiple_ik_solutions = config.use_multiple_ik_solutions;
 
-    pp.param("use_xyz_snap_mprim", params.use_xyz_snap_mprim, false);
-    pp.param("use_rpy_snap_mprim", params.use_rpy_snap_mprim, false);
-    pp.param("use_xyzrpy_snap_mprim", params.use_xyzrpy_snap_mprim, false);
-    pp.param("use_short_dist_mprims", params.use_short_dist_mprims, false);
+    params.use_xyz_snap_mprim = config.use_xyz_snap_mprim;
+    params.use_rpy_snap_mprim = config.use_rpy_snap_mprim;
+    params.use_xyzrpy_snap_mprim = config.use_xyzrpy_snap_mprim;
+    params.use_short_dist_mprims = config.use_short_dist_mprims;
+    params.use_action_tiers = config.use_action_tiers;
 
-    pp.param("xyz_snap_dist_thresh", params.xyz_snap_thresh, 0.0);
-    pp.param("rpy_snap_dist_thresh", params.rpy_snap_thresh, 0.0);
-    pp.param("xyzrpy_snap_dist_thresh", params.xyzrpy_snap_thresh, 0.0);
-    pp.param("short_dist_mprims_thresh", params.short_dist_mprims_thresh, 0.0);
+    params.xyz_snap_thresh = config.xyz_snap_thresh;
+    params.rpy_snap_thresh = config.rpy_snap_thresh;
+    params.xyzrpy_snap_thresh = config.xyzrpy_snap_thresh;
+    params.short_dist_mprims_thresh = config.short_dist_mprims_thresh;
     return true;
 }
 
@@ -117,13 +123,12 @@ auto MakeManipLattice(
 
     auto resolutions = std::vector<double>(robot->jointVariableCount());
 
-    std::string disc_string;
-    if (!params.getParam("discretization", disc_string)) {
+    if (!params.compiled().graph.has_discretization) {
         SMPL_ERROR_NAMED(PI_LOGGER, "Parameter 'discretization' not found in planning params");
         return nullptr;
     }
 
-    auto disc = ParseMapFromString<double>(disc_string);
+    auto disc = ParseMapFromString<double>(params.compiled().graph.discretization);
     SMPL_DEBUG_NAMED(PI_LOGGER, "Parsed discretization for %zu joints", disc.size());
 
     for (size_t vidx = 0; vidx < robot->jointVariableCount(); ++vidx) {
@@ -187,6 +192,7 @@ auto MakeManipLattice(
     actions.useAmp(MotionPrimitive::SNAP_TO_RPY, action_params.use_rpy_snap_mprim);
     actions.useAmp(MotionPrimitive::SNAP_TO_XYZ_RPY, action_params.use_xyzrpy_snap_mprim);
     actions.useAmp(MotionPrimitive::SHORT_DISTANCE, action_params.use_short_dist_mprims);
+    actions.useActionTiers(action_params.use_action_tiers);
     actions.ampThresh(MotionPrimitive::SNAP_TO_XYZ, action_params.xyz_snap_thresh);
     actions.ampThresh(MotionPrimitive::SNAP_TO_RPY, action_params.rpy_snap_thresh);
     actions.ampThresh(MotionPrimitive::SNAP_TO_XYZ_RPY, action_params.xyzrpy_snap_thresh);
@@ -232,12 +238,11 @@ auto MakeManipLatticeEGraph(
 
     std::vector<double> resolutions(robot->jointVariableCount());
 
-    std::string disc_string;
-    if (!params.getParam("discretization", disc_string)) {
+    if (!params.compiled().graph.has_discretization) {
         SMPL_ERROR_NAMED(PI_LOGGER, "Parameter 'discretization' not found in planning params");
         return nullptr;
     }
-    auto disc = ParseMapFromString<double>(disc_string);
+    auto disc = ParseMapFromString<double>(params.compiled().graph.discretization);
     SMPL_DEBUG_NAMED(PI_LOGGER, "Parsed discretization for %zu joints", disc.size());
 
     for (size_t vidx = 0; vidx < robot->jointVariableCount(); ++vidx) {
@@ -283,6 +288,7 @@ auto MakeManipLatticeEGraph(
     actions.useAmp(MotionPrimitive::SNAP_TO_RPY, action_params.use_rpy_snap_mprim);
     actions.useAmp(MotionPrimitive::SNAP_TO_XYZ_RPY, action_params.use_xyzrpy_snap_mprim);
     actions.useAmp(MotionPrimitive::SHORT_DISTANCE, action_params.use_short_dist_mprims);
+    actions.useActionTiers(action_params.use_action_tiers);
     actions.ampThresh(MotionPrimitive::SNAP_TO_XYZ, action_params.xyz_snap_thresh);
     actions.ampThresh(MotionPrimitive::SNAP_TO_RPY, action_params.rpy_snap_thresh);
     actions.ampThresh(MotionPrimitive::SNAP_TO_XYZ_RPY, action_params.xyzrpy_snap_thresh);
@@ -292,10 +298,9 @@ auto MakeManipLatticeEGraph(
         return nullptr;
     }
 
-    std::string egraph_path;
-    if (params.getParam("egraph_path", egraph_path)) {
+    if (params.compiled().graph.has_egraph_path) {
         // warning printed within, allow to fail silently
-        (void)space->loadExperienceGraph(egraph_path);
+        (void)space->loadExperienceGraph(params.compiled().graph.egraph_path);
     } else {
         SMPL_WARN("No experience graph file parameter");
     }
@@ -310,13 +315,12 @@ bool GetWorkspaceLatticeParams(
     const RedundantManipulatorInterface* rmi,
     WorkspaceLatticeBase::Params* wsp)
 {
-    std::string disc_string;
-    if (!params.getParam("discretization", disc_string)) {
+    if (!params.compiled().graph.has_discretization) {
         SMPL_ERROR_NAMED(PI_LOGGER, "Parameter 'discretization' not found in planning params");
         return false;
     }
 
-    auto disc = ParseMapFromString<double>(disc_string);
+    auto disc = ParseMapFromString<double>(params.compiled().graph.discretization);
     SMPL_DEBUG_NAMED(PI_LOGGER, "Parsed discretization for %zu variables", disc.size());
 
     auto extract_disc = [&](const char* name, double* d)
@@ -439,10 +443,9 @@ auto MakeWorkspaceLatticeEGraph(
 
     space->setVisualizationFrameId(grid->getReferenceFrame());
 
-    std::string egraph_path;
-    if (params.getParam("egraph_path", egraph_path)) {
+    if (params.compiled().graph.has_egraph_path) {
         // warning printed within, allow to fail silently
-        (void)space->loadExperienceGraph(egraph_path);
+        (void)space->loadExperienceGraph(params.compiled().graph.egraph_path);
     } else {
         SMPL_WARN("No experience graph file parameter");
     }
@@ -488,20 +491,15 @@ auto MakeMultiFrameBFSHeuristic(
     const OccupancyGrid* grid)
     -> std::unique_ptr<RobotHeuristic>
 {
+    const HeuristicConfig& config = params.compiled().heuristic;
     auto h = make_unique<MultiFrameBfsHeuristic>();
     h->setCostPerCell(params.cost_per_cell);
-    double inflation_radius;
-    params.param("bfs_inflation_radius", inflation_radius, 0.0);
-    h->setInflationRadius(inflation_radius);
+    h->setInflationRadius(config.bfs_inflation_radius);
     if (!h->init(space, grid)) {
         return nullptr;
     }
 
-    double offset_x, offset_y, offset_z;
-    params.param("offset_x", offset_x, 0.0);
-    params.param("offset_y", offset_y, 0.0);
-    params.param("offset_z", offset_z, 0.0);
-    h->setOffset(offset_x, offset_y, offset_z);
+    h->setOffset(config.offset_x, config.offset_y, config.offset_z);
 
     return std::move(h);
 }
@@ -514,9 +512,12 @@ auto MakeBFSHeuristic(
 {
     auto h = make_unique<BfsHeuristic>();
     h->setCostPerCell(params.cost_per_cell);
-    double inflation_radius;
-    params.param("bfs_inflation_radius", inflation_radius, 0.0);
-    h->setInflationRadius(inflation_radius);
+    h->setInflationRadius(params.compiled().heuristic.bfs_inflation_radius);
+    int store_capacity = params.compiled().heuristic.bfs_store_capacity;
+    if (store_capacity < 0) {
+        store_capacity = 0;
+    }
+    h->setBfsStoreCapacity((size_t)store_capacity);
     if (!h->init(space, grid)) {
         return nullptr;
     }
@@ -534,16 +535,11 @@ auto MakeEuclidDistHeuristic(
         return nullptr;
     }
 
-    double wx, wy, wz, wr;
-    params.param("x_coeff", wx, 1.0);
-    params.param("y_coeff", wy, 1.0);
-    params.param("z_coeff", wz, 1.0);
-    params.param("rot_coeff", wr, 1.0);
-
-    h->setWeightX(wx);
-    h->setWeightY(wy);
-    h->setWeightZ(wz);
-    h->setWeightRot(wr);
+    const HeuristicConfig& config = params.compiled().heuristic;
+    h->setWeightX(config.x_coeff);
+    h->setWeightY(config.y_coeff);
+    h->setWeightZ(config.z_coeff);
+    h->setWeightRot(config.rot_coeff);
     return std::move(h);
 };
 
@@ -568,16 +564,12 @@ auto MakeDijkstraEgraphHeuristic3D(
     auto h = make_unique<DijkstraEgraphHeuristic3D>();
 
 //    h->setCostPerCell(params.cost_per_cell);
-    double inflation_radius;
-    params.param("bfs_inflation_radius", inflation_radius, 0.0);
-    h->setInflationRadius(inflation_radius);
+    h->setInflationRadius(params.compiled().heuristic.bfs_inflation_radius);
     if (!h->init(space, grid)) {
         return nullptr;
     }
 
-    double egw;
-    params.param("egraph_epsilon", egw, 1.0);
-    h->setWeightEGraph(egw);
+    h->setWeightEGraph(params.compiled().heuristic.egraph_epsilon);
 
     return std::move(h);
 };
@@ -596,9 +588,7 @@ auto MakeJointDistEGraphHeuristic(
         return nullptr;
     }
 
-    double egw;
-    params.param("egraph_epsilon", egw, 1.0);
-    h->setWeightEGraph(egw);
+    h->setWeightEGraph(params.compiled().heuristic.egraph_epsilon);
     return std::move(h);
 };
 
@@ -610,47 +600,66 @@ auto MakeARAStar(
 {
     auto search = make_unique<ARAStar>(space, heuristic);
 
-    double epsilon;
-    params.param("epsilon", epsilon, 1.0);
-    search->set_initialsolution_eps(epsilon);
+    const SearchConfig& config = params.compiled().search;
+    search->set_initialsolution_eps(config.epsilon);
+    search->set_search_mode(config.search_mode);
+
+    if (config.has_allow_partial_solutions) {
+        search->allowPartialSolutions(config.allow_partial_solutions);
+    }
 
-    bool search_mode;
-    params.param("search_mode", search_mode, false);
-    search->set_search_mode(search_mode);
+    if (config.has_target_epsilon) {
+        search->setTargetEpsilon(config.target_epsilon);
+    }
 
-    bool allow_partial_solutions;
-    if (params.getParam("allow_partial_solutions", allow_partial_solutions)) {
-        search->allowPartialSolutions(allow_partial_solutions);
+    if (config.has_delta_epsilon) {
+        search->setDeltaEpsilon(config.delta_epsilon);
     }
 
-    double target_eps;
-    if (params.getParam("target_epsilon", target_eps)) {
-        search->setTargetEpsilon(target_eps);
+    if (config.has_improve_solution) {
+        search->setImproveSolution(config.improve_solution);
     }
 
-    double delta_eps;
-    if (params.getParam("delta_epsilon", delta_eps)) {
-        search->setDeltaEpsilon(delta_eps);
+    if (config.has_bound_expansions) {
+        search->setBoundExpansions(config.bound_expansions);
     }
 
-    bool improve_solution;
-    if (params.getParam("improve_solution", improve_solution)) {
-        search->setImproveSolution(improve_solution);
+    if (config.has_repair_time) {
+        search->setAllowedRepairTime(config.repair_time);
     }
 
-    bool bound_expansions;
-    if (params.getParam("bound_expansions", bound_expansions)) {
-        search->setBoundExpansions(bound_expansions);
+    if (config.has_reuse_search_tree) {
+        search->setSearchTreeReuse(config.reuse_search_tree);
     }
 
-    double repair_time;
-    if (params.getParam("repair_time", repair_time)) {
-        search->setAllowedRepairTime(repair_time);
+    if (config.has_memory_budget_mb) {
+        search->setMemoryBudget(
+                (size_t)(config.memory_budget_mb * 1024.0 * 1024.0));
     }
 
     return std::move(search);
 }
 
+auto MakeBARAStar(
+    RobotPlanningSpace* space,
+    RobotHeuristic* heuristic,
+    const PlanningParams& params)
+    -> std::unique_ptr<SBPLPlanner>
+{
+    // Backward weighted A*: expands predecessors from the goal toward the
+    // start, letting a heuristic wavefront rooted at the start region serve
+    // many queries against a fixed goal. Requires the planning space to
+    // implement GetPreds() (see ManipLattice) and a concrete joint-space
+    // goal state.
+    auto forward_search = false;
+    auto search = make_unique<ARAPlanner>(space, forward_search);
+
+    search->set_initialsolution_eps(params.compiled().search.epsilon);
+    search->set_search_mode(params.compiled().search.search_mode);
+
+    return std::move(search);
+}
+
 auto MakeAWAStar(
     RobotPlanningSpace* space,
     RobotHeuristic* heuristic,
@@ -658,9 +667,24 @@ auto MakeAWAStar(
     -> std::unique_ptr<SBPLPlanner>
 {
     auto search = make_unique<AWAStar>(space, heuristic);
-    double epsilon;
-    params.param("epsilon", epsilon, 1.0);
-    search->set_initialsolution_eps(epsilon);
+    search->set_initialsolution_eps(params.compiled().search.epsilon);
+    return std::move(search);
+}
+
+auto MakeBoundedCostSearch(
+    RobotPlanningSpace* space,
+    RobotHeuristic* heuristic,
+    const PlanningParams& params)
+    -> std::unique_ptr<SBPLPlanner>
+{
+    auto search = make_unique<BoundedCostSearch>(space, heuristic);
+
+    // absolute bound on solution cost, in the same units reported by the
+    // planning space; without it the search degenerates to uniform-cost
+    if (params.compiled().search.has_cost_bound) {
+        search->setCostBound(params.compiled().search.cost_bound);
+    }
+
     return std::move(search);
 }
 
@@ -691,17 +715,10 @@ auto MakeMHAStar(
 
     search->heuristics = std::move(heuristics);
 
-    double mha_eps;
-    params.param("epsilon_mha", mha_eps, 1.0);
-    search->set_initial_mha_eps(mha_eps);
-
-    double epsilon;
-    params.param("epsilon", epsilon, 1.0);
-    search->set_initialsolution_eps(epsilon);
-
-    bool search_mode;
-    params.param("search_mode", search_mode, false);
-    search->set_search_mode(search_mode);
+    const SearchConfig& config = params.compiled().search;
+    search->set_initial_mha_eps(config.epsilon_mha);
+    search->set_initialsolution_eps(config.epsilon);
+    search->set_search_mode(config.search_mode);
 
     return std::move(search);
 }
@@ -714,12 +731,8 @@ auto MakeLARAStar(
 {
     auto forward_search = true;
     auto search = make_unique<LazyARAPlanner>(space, forward_search);
-    double epsilon;
-    params.param("epsilon", epsilon, 1.0);
-    search->set_initialsolution_eps(epsilon);
-    bool search_mode;
-    params.param("search_mode", search_mode, false);
-    search->set_search_mode(search_mode);
+    search->set_initialsolution_eps(params.compiled().search.epsilon);
+    search->set_search_mode(params.compiled().search.search_mode);
     return std::move(search);
 }
 
@@ -731,9 +744,7 @@ auto MakeEGWAStar(
 {
     auto search = make_unique<ExperienceGraphPlanner>(space, heuristic);
 
-    double epsilon;
-    params.param("epsilon", epsilon, 1.0);
-    search->set_initialsolution_eps(epsilon);
+    search->set_initialsolution_eps(params.compiled().search.epsilon);
 
     return std::move(search);
 }
@@ -746,13 +757,8 @@ auto MakePADAStar(
 {
     auto search = make_unique<AdaptivePlanner>(space, heuristic);
 
-    double epsilon_plan;
-    params.param("epsilon_plan", epsilon_plan, 1.0);
-    search->set_plan_eps(epsilon_plan);
-
-    double epsilon_track;
-    params.param("epsilon_track", epsilon_track, 1.0);
-    search->set_track_eps(epsilon_track);
+    search->set_plan_eps(params.compiled().search.epsilon_plan);
+    search->set_track_eps(params.compiled().search.epsilon_track);
 
     AdaptivePlanner::TimeParameters tparams;
     tparams.planning.bounded = true;
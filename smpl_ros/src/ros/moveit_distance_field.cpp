@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+#include <smpl/ros/moveit_distance_field.h>
+
+// standard includes
+#include <algorithm>
+#include <cassert>
+
+namespace smpl {
+
+MoveItDistanceField::MoveItDistanceField(
+    const std::shared_ptr<DistanceMapInterface>& dm)
+:
+    DistanceField(
+            dm->sizeX(), dm->sizeY(), dm->sizeZ(),
+            dm->resolution(),
+            dm->originX(), dm->originY(), dm->originZ()),
+    m_dm(dm)
+{
+    assert(m_dm);
+}
+
+void MoveItDistanceField::addPointsToField(
+    const EigenSTL::vector_Vector3d& points)
+{
+    m_dm->addPointsToMap(toUnalignedVector(points));
+}
+
+void MoveItDistanceField::removePointsFromField(
+    const EigenSTL::vector_Vector3d& points)
+{
+    m_dm->removePointsFromMap(toUnalignedVector(points));
+}
+
+void MoveItDistanceField::updatePointsInField(
+    const EigenSTL::vector_Vector3d& old_points,
+    const EigenSTL::vector_Vector3d& new_points)
+{
+    m_dm->updatePointsInMap(
+            toUnalignedVector(old_points),
+            toUnalignedVector(new_points));
+}
+
+void MoveItDistanceField::reset()
+{
+    m_dm->reset();
+}
+
+double MoveItDistanceField::getDistance(double x, double y, double z) const
+{
+    return m_dm->getMetricDistance(x, y, z);
+}
+
+double MoveItDistanceField::getDistance(int x, int y, int z) const
+{
+    return m_dm->getCellDistance(x, y, z);
+}
+
+bool MoveItDistanceField::isCellValid(int x, int y, int z) const
+{
+    return m_dm->isCellValid(x, y, z);
+}
+
+int MoveItDistanceField::getXNumCells() const
+{
+    return m_dm->numCellsX();
+}
+
+int MoveItDistanceField::getYNumCells() const
+{
+    return m_dm->numCellsY();
+}
+
+int MoveItDistanceField::getZNumCells() const
+{
+    return m_dm->numCellsZ();
+}
+
+bool MoveItDistanceField::gridToWorld(
+    int x, int y, int z,
+    double& world_x, double& world_y, double& world_z) const
+{
+    m_dm->gridToWorld(x, y, z, world_x, world_y, world_z);
+    return true;
+}
+
+bool MoveItDistanceField::worldToGrid(
+    double world_x, double world_y, double world_z,
+    int& x, int& y, int& z) const
+{
+    m_dm->worldToGrid(world_x, world_y, world_z, x, y, z);
+    return m_dm->isCellValid(x, y, z);
+}
+
+bool MoveItDistanceField::writeToStream(std::ostream& stream) const
+{
+    // no common serialization across distance map implementations
+    return false;
+}
+
+bool MoveItDistanceField::readFromStream(std::istream& stream)
+{
+    return false;
+}
+
+double MoveItDistanceField::getUninitializedDistance() const
+{
+    return m_dm->getUninitializedDistance();
+}
+
+std::vector<Eigen::Vector3d> MoveItDistanceField::toUnalignedVector(
+    const EigenSTL::vector_Vector3d& vin) const
+{
+    std::vector<Eigen::Vector3d> vout(vin.size());
+    std::copy(vin.begin(), vin.end(), vout.begin());
+    return vout;
+}
+
+} // namespace smpl
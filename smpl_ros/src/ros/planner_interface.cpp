@@ -35,6 +35,7 @@
 // standard includes
 #include <assert.h>
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <chrono>
 #include <utility>
@@ -51,9 +52,12 @@
 #include <smpl/console/nonstd.h>
 #include <smpl/debug/visualize.h>
 #include <smpl/heuristic/bfs_heuristic.h>
+#include <smpl/graph/manip_lattice_egraph.h>
 #include <smpl/heuristic/egraph_bfs_heuristic.h>
 #include <smpl/heuristic/multi_frame_bfs_heuristic.h>
 #include <smpl/post_processing.h>
+#include <smpl/search/arastar.h>
+#include <smpl/search/smhastar.h>
 #include <smpl/stl/memory.h>
 #include <smpl/time.h>
 #include <smpl/types.h>
@@ -192,7 +196,12 @@ PlannerInterface::PlannerInterface(
     m_heuristics(),
     m_planner(),
     m_sol_cost(INFINITECOST),
-    m_planner_id()
+    m_planner_id(),
+    m_solve_in_flight(false),
+    m_cancel_requested(false),
+    m_active_search(nullptr),
+    m_chunk_callback(),
+    m_commit_horizon(0)
 {
     if (m_robot) {
         m_fk_iface = m_robot->getExtension<ForwardKinematicsInterface>();
@@ -278,7 +287,9 @@ PlannerInterface::PlannerInterface(
     /////////////////////////////
 
     m_planner_factories["arastar"] = MakeARAStar;
+    m_planner_factories["barastar"] = MakeBARAStar;
     m_planner_factories["awastar"] = MakeAWAStar;
+    m_planner_factories["pts"] = MakeBoundedCostSearch;
     m_planner_factories["mhastar"] = MakeMHAStar;
     m_planner_factories["larastar"] = MakeLARAStar;
     m_planner_factories["egwastar"] = MakeEGWAStar;
@@ -287,6 +298,10 @@ PlannerInterface::PlannerInterface(
 
 PlannerInterface::~PlannerInterface()
 {
+    cancel();
+    if (m_solve_thread.joinable()) {
+        m_solve_thread.join();
+    }
 }
 
 bool PlannerInterface::init(const PlanningParams& params)
@@ -296,6 +311,7 @@ bool PlannerInterface::init(const PlanningParams& params)
     SMPL_INFO_NAMED(PI_LOGGER, "  Shortcut Path: %s", params.shortcut_path ? "true" : "false");
     SMPL_INFO_NAMED(PI_LOGGER, "  Shortcut Type: %s", to_string(params.shortcut_type).c_str());
     SMPL_INFO_NAMED(PI_LOGGER, "  Interpolate Path: %s", params.interpolate_path ? "true" : "false");
+    SMPL_INFO_NAMED(PI_LOGGER, "  Profile Accelerations: %s", params.profile_accelerations ? "true" : "false");
 
     if (!m_robot) {
         SMPL_ERROR("Robot Model given to Arm Planner Interface must be non-null");
@@ -318,6 +334,9 @@ bool PlannerInterface::init(const PlanningParams& params)
 
     m_params = params;
 
+    // cached pipelines were built against the previous parameters
+    m_pipelines.clear();
+
     m_initialized = true;
 
     SMPL_INFO_NAMED(PI_LOGGER, "Initialized planner interface");
@@ -471,14 +490,80 @@ void ConvertJointVariablePathToJointTrajectory(
     }
 }
 
+// Per-joint kinematic limits hoisted out of the per-waypoint profiling loops.
+// Joints are split by variable type so the per-waypoint time computation runs
+// branch-free over flat arrays; joints without a velocity limit never enter
+// the arrays and cannot constrain the profile.
+struct ProfileLimits
+{
+    std::vector<int> lin_joints;    // bounded/unbounded variable indices
+    std::vector<double> lin_inv_vel;
+    std::vector<double> lin_vel;
+    std::vector<double> lin_acc;    // 0 = no acceleration limit
+
+    std::vector<int> ang_joints;    // continuous variable indices
+    std::vector<double> ang_inv_vel;
+    std::vector<double> ang_vel;
+    std::vector<double> ang_acc;
+};
+
 static
-void ProfilePath(RobotModel* robot, trajectory_msgs::JointTrajectory& traj)
+void BuildProfileLimits(
+    RobotModel* robot,
+    size_t joint_count,
+    ProfileLimits& limits)
+{
+    for (size_t jidx = 0; jidx < joint_count; ++jidx) {
+        auto vel = robot->velLimit(jidx);
+        if (vel <= 0.0) {
+            continue;
+        }
+        auto acc = robot->accLimit(jidx);
+        if (robot->isContinuous(jidx)) {
+            limits.ang_joints.push_back((int)jidx);
+            limits.ang_inv_vel.push_back(1.0 / vel);
+            limits.ang_vel.push_back(vel);
+            limits.ang_acc.push_back(acc);
+        } else {
+            limits.lin_joints.push_back((int)jidx);
+            limits.lin_inv_vel.push_back(1.0 / vel);
+            limits.lin_vel.push_back(vel);
+            limits.lin_acc.push_back(acc);
+        }
+    }
+}
+
+// Minimum time for a joint to traverse \p dist, coming to rest at both ends,
+// under its velocity and acceleration limits: the trapezoidal profile time
+// when the joint reaches its velocity limit and the triangular profile time
+// otherwise. A non-positive acceleration limit reduces to the
+// constant-velocity time.
+static
+double ProfileSegmentTime(double dist, double vel, double acc)
+{
+    if (acc <= 0.0) {
+        return dist / vel;
+    }
+    if (dist * acc >= vel * vel) {
+        return dist / vel + vel / acc;
+    }
+    return 2.0 * std::sqrt(dist / acc);
+}
+
+static
+void ProfilePath(
+    RobotModel* robot,
+    trajectory_msgs::JointTrajectory& traj,
+    bool profile_accelerations)
 {
     if (traj.points.empty()) {
         return;
     }
 
-    auto& joint_names = traj.joint_names;
+    // hoist the limits out of the waypoint loop; velLimit() and friends are
+    // virtual calls otherwise repeated for every waypoint/joint pair
+    ProfileLimits limits;
+    BuildProfileLimits(robot, traj.joint_names.size(), limits);
 
     for (size_t i = 1; i < traj.points.size(); ++i) {
         auto& prev_point = traj.points[i - 1];
@@ -487,27 +572,82 @@ void ProfilePath(RobotModel* robot, trajectory_msgs::JointTrajectory& traj)
         // find the maximum time required for any joint to reach the next
         // waypoint
         double max_time = 0.0;
-        for (size_t jidx = 0; jidx < joint_names.size(); ++jidx) {
-            auto from_pos = prev_point.positions[jidx];
-            auto to_pos = curr_point.positions[jidx];
-            auto vel = robot->velLimit(jidx);
-            if (vel <= 0.0) {
-                continue;
+        if (profile_accelerations) {
+            for (size_t k = 0; k < limits.lin_joints.size(); ++k) {
+                const int jidx = limits.lin_joints[k];
+                auto dist = fabs(curr_point.positions[jidx] - prev_point.positions[jidx]);
+                max_time = std::max(
+                        max_time,
+                        ProfileSegmentTime(
+                                dist, limits.lin_vel[k], limits.lin_acc[k]));
             }
-            auto t = 0.0;
-            if (robot->isContinuous(jidx)) {
-                t = angles::shortest_angle_dist(from_pos, to_pos) / vel;
-            } else {
-                t = fabs(to_pos - from_pos) / vel;
+            for (size_t k = 0; k < limits.ang_joints.size(); ++k) {
+                const int jidx = limits.ang_joints[k];
+                auto dist = angles::shortest_angle_dist(
+                        prev_point.positions[jidx], curr_point.positions[jidx]);
+                max_time = std::max(
+                        max_time,
+                        ProfileSegmentTime(
+                                dist, limits.ang_vel[k], limits.ang_acc[k]));
+            }
+        } else {
+            for (size_t k = 0; k < limits.lin_joints.size(); ++k) {
+                const int jidx = limits.lin_joints[k];
+                auto dist = fabs(curr_point.positions[jidx] - prev_point.positions[jidx]);
+                max_time = std::max(max_time, dist * limits.lin_inv_vel[k]);
+            }
+            for (size_t k = 0; k < limits.ang_joints.size(); ++k) {
+                const int jidx = limits.ang_joints[k];
+                auto dist = angles::shortest_angle_dist(
+                        prev_point.positions[jidx], curr_point.positions[jidx]);
+                max_time = std::max(max_time, dist * limits.ang_inv_vel[k]);
             }
-
-            max_time = std::max(max_time, t);
         }
 
         curr_point.time_from_start = prev_point.time_from_start + ros::Duration(max_time);
     }
 }
 
+// Shift the points of a profiled trajectory forward in time by the duration
+// of another, drop the boundary waypoint it shares with it, and append the
+// remainder, yielding a single consistently-timed trajectory.
+static
+void AppendProfiledTrajectory(
+    moveit_msgs::RobotTrajectory& traj,
+    moveit_msgs::RobotTrajectory& tail)
+{
+    if (!tail.joint_trajectory.points.empty()) {
+        auto offset = ros::Duration(0.0);
+        if (!traj.joint_trajectory.points.empty()) {
+            offset = traj.joint_trajectory.points.back().time_from_start;
+        }
+        for (auto& point : tail.joint_trajectory.points) {
+            point.time_from_start += offset;
+        }
+        tail.joint_trajectory.points.erase(begin(tail.joint_trajectory.points));
+        traj.joint_trajectory.points.insert(
+                end(traj.joint_trajectory.points),
+                begin(tail.joint_trajectory.points),
+                end(tail.joint_trajectory.points));
+    }
+
+    if (!tail.multi_dof_joint_trajectory.points.empty()) {
+        auto offset = ros::Duration(0.0);
+        if (!traj.multi_dof_joint_trajectory.points.empty()) {
+            offset = traj.multi_dof_joint_trajectory.points.back().time_from_start;
+        }
+        for (auto& point : tail.multi_dof_joint_trajectory.points) {
+            point.time_from_start += offset;
+        }
+        tail.multi_dof_joint_trajectory.points.erase(
+                begin(tail.multi_dof_joint_trajectory.points));
+        traj.multi_dof_joint_trajectory.points.insert(
+                end(traj.multi_dof_joint_trajectory.points),
+                begin(tail.multi_dof_joint_trajectory.points),
+                end(tail.multi_dof_joint_trajectory.points));
+    }
+}
+
 static
 void RemoveZeroDurationSegments(trajectory_msgs::JointTrajectory& traj)
 {
@@ -723,22 +863,81 @@ bool PlannerInterface::solve(
 
     auto then = clock::now();
 
-    if (!setGoal(req.goal_constraints)) {
+    auto phase_began = then;
+    auto goal_set = setGoal(req.goal_constraints);
+    m_stats.record(
+            STAT_EVENT_PHASE, PHASE_SET_GOAL,
+            0, to_seconds(clock::now() - phase_began));
+    if (!goal_set) {
         SMPL_ERROR("Failed to set goal");
         res.planning_time = to_seconds(clock::now() - then);
         res.error_code.val = moveit_msgs::MoveItErrorCodes::GOAL_IN_COLLISION;
         return false;
     }
 
-    if (!setStart(req.start_state)) {
+    phase_began = clock::now();
+    auto start_set = setStart(req.start_state);
+    m_stats.record(
+            STAT_EVENT_PHASE, PHASE_SET_START,
+            0, to_seconds(clock::now() - phase_began));
+    if (!start_set) {
         SMPL_ERROR("Failed to set initial configuration of robot");
         res.planning_time = to_seconds(clock::now() - then);
         res.error_code.val = moveit_msgs::MoveItErrorCodes::START_STATE_IN_COLLISION;
         return false;
     }
 
+    if (m_cancel_requested.load()) {
+        SMPL_INFO_NAMED(PI_LOGGER, "Planning request cancelled before search");
+        res.planning_time = to_seconds(clock::now() - then);
+        res.error_code.val = moveit_msgs::MoveItErrorCodes::PREEMPTED;
+        return false;
+    }
+
+    // reachability prepass: if a bfs heuristic's goal wavefront exhausted its
+    // free-space component without discovering the start cell, no path exists
+    // at the grid resolution and the search would only burn its time budget
+    // proving it
+    for (auto& entry : m_heuristics) {
+        auto* bfs_heur = dynamic_cast<BfsHeuristic*>(entry.second.get());
+        if (bfs_heur != NULL && bfs_heur->startUnreachable()) {
+            SMPL_WARN("Goal region is disconnected from the start cell; refusing to search");
+            res.planning_time = to_seconds(clock::now() - then);
+            res.error_code.val = moveit_msgs::MoveItErrorCodes::GOAL_IN_COLLISION;
+            return false;
+        }
+    }
+
     std::vector<RobotState> path;
-    if (!plan(req.allowed_planning_time, path)) {
+    phase_began = clock::now();
+
+    // a cached solution for this (map, start, goal) that survives
+    // revalidation stands in for the search
+    auto planned = lookupCachedPath(path);
+    if (planned) {
+        SMPL_INFO_NAMED(PI_LOGGER, "Reusing cached solution path (%zu waypoints)", path.size());
+        m_stats.record(
+                STAT_EVENT_PHASE, PHASE_SEARCH,
+                0, to_seconds(clock::now() - phase_began));
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(m_cancel_mutex);
+            m_active_search = m_planner.get();
+        }
+        planned = plan(req.allowed_planning_time, path);
+        {
+            std::lock_guard<std::mutex> lock(m_cancel_mutex);
+            m_active_search = nullptr;
+        }
+        m_stats.record(
+                STAT_EVENT_PHASE, PHASE_SEARCH,
+                (std::uint32_t)m_planner->get_n_expands(),
+                to_seconds(clock::now() - phase_began));
+        if (planned) {
+            storeCachedPath(path);
+        }
+    }
+    if (!planned) {
         SMPL_ERROR("Failed to plan within alotted time frame (%0.2f seconds, %d expansions)", req.allowed_planning_time, m_planner->get_n_expands());
         res.planning_time = to_seconds(clock::now() - then);
         res.error_code.val = moveit_msgs::MoveItErrorCodes::PLANNING_FAILED;
@@ -762,7 +961,66 @@ bool PlannerInterface::solve(
         SMPL_ERROR("Planned path is invalid");
     }
 
+    auto stream_chunks = m_chunk_callback && m_commit_horizon > 0 &&
+            (int)path.size() > m_commit_horizon + 1;
+
+    if (stream_chunks) {
+        // Split the raw search path at the commit horizon and finish the
+        // head first: it is smoothed, converted, and time-profiled on its
+        // own and handed to the chunk callback while the tail is still
+        // being post-processed. The boundary waypoint is shared between the
+        // pieces, so the tail departs exactly from the last committed
+        // waypoint; smoothing never crosses the boundary and the profile
+        // brings the robot to rest there.
+        std::vector<RobotState> head(
+                begin(path), begin(path) + m_commit_horizon + 1);
+        std::vector<RobotState> tail(
+                begin(path) + m_commit_horizon, end(path));
+
+        phase_began = clock::now();
+        postProcessPath(head);
+
+        ConvertJointVariablePathToJointTrajectory(
+                m_robot,
+                head,
+                req.start_state.joint_state.header.frame_id,
+                req.start_state.multi_dof_joint_state.header.frame_id,
+                res.trajectory);
+        res.trajectory.joint_trajectory.header.stamp = ros::Time::now();
+        ProfilePath(m_robot, res.trajectory.joint_trajectory, m_params.profile_accelerations);
+        m_chunk_callback(res.trajectory, false);
+
+        postProcessPath(tail);
+        m_stats.record(
+                STAT_EVENT_PHASE, PHASE_POST_PROCESS,
+                0, to_seconds(clock::now() - phase_began));
+
+        moveit_msgs::RobotTrajectory tail_traj;
+        ConvertJointVariablePathToJointTrajectory(
+                m_robot,
+                tail,
+                req.start_state.joint_state.header.frame_id,
+                req.start_state.multi_dof_joint_state.header.frame_id,
+                tail_traj);
+        ProfilePath(m_robot, tail_traj.joint_trajectory, m_params.profile_accelerations);
+        AppendProfiledTrajectory(res.trajectory, tail_traj);
+        m_chunk_callback(tail_traj, true);
+
+        SV_SHOW_INFO_NAMED("trajectory", makePathVisualization(head));
+
+        if (!m_params.plan_output_dir.empty()) {
+            WritePath(m_robot, res.trajectory_start, res.trajectory, m_params.plan_output_dir);
+        }
+
+        res.planning_time = to_seconds(clock::now() - then);
+        return true;
+    }
+
+    phase_began = clock::now();
     postProcessPath(path);
+    m_stats.record(
+            STAT_EVENT_PHASE, PHASE_POST_PROCESS,
+            0, to_seconds(clock::now() - phase_began));
     SV_SHOW_INFO_NAMED("trajectory", makePathVisualization(path));
 
     SMPL_DEBUG_NAMED(PI_LOGGER, "smoothed path:");
@@ -783,13 +1041,241 @@ bool PlannerInterface::solve(
         WritePath(m_robot, res.trajectory_start, res.trajectory, m_params.plan_output_dir);
     }
 
-    ProfilePath(m_robot, res.trajectory.joint_trajectory);
+    ProfilePath(m_robot, res.trajectory.joint_trajectory, m_params.profile_accelerations);
 //    RemoveZeroDurationSegments(traj);
 
+    if (m_chunk_callback) {
+        m_chunk_callback(res.trajectory, true);
+    }
+
     res.planning_time = to_seconds(clock::now() - then);
     return true;
 }
 
+void PlannerInterface::setTrajectoryChunkCallback(
+    TrajectoryChunkCallback callback,
+    int commit_horizon)
+{
+    if (m_solve_in_flight.load()) {
+        SMPL_ERROR("Cannot change the trajectory chunk callback while a request is in flight");
+        return;
+    }
+    m_chunk_callback = std::move(callback);
+    m_commit_horizon = commit_horizon;
+}
+
+// maximum per-variable difference for a cached start to match the current
+// one; the cached path departs from its own first waypoint, so this also
+// bounds the discontinuity introduced by snapping it to the current start
+static const double PathCacheStartTolerance = 1e-3;
+
+static
+bool StartsMatch(
+    RobotModel* robot,
+    const RobotState& a,
+    const RobotState& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        auto d = robot->isContinuous((int)i) ?
+                std::fabs(angles::shortest_angle_dist(a[i], b[i])) :
+                std::fabs(a[i] - b[i]);
+        if (d > PathCacheStartTolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A cached goal matches when both goals name the same cell of the occupancy
+// grid and the goal displacement plus the cached tolerance fits within the
+// requested tolerance on every axis. The cached path's final waypoint is only
+// guaranteed to lie within the cached tolerances of the cached goal, so the
+// slack term is what lets the triangle inequality carry that guarantee over
+// to the new constraint.
+static
+bool GoalsMatch(
+    const OccupancyGrid* grid,
+    const GoalConstraint& a,
+    const GoalConstraint& b)
+{
+    if (a.type != b.type) {
+        return false;
+    }
+    if (a.type != GoalType::XYZ_GOAL && a.type != GoalType::XYZ_RPY_GOAL) {
+        return false; // only pose goals are cached
+    }
+
+    int axc, ayc, azc, bxc, byc, bzc;
+    grid->worldToGrid(
+            a.pose.translation().x(),
+            a.pose.translation().y(),
+            a.pose.translation().z(),
+            axc, ayc, azc);
+    grid->worldToGrid(
+            b.pose.translation().x(),
+            b.pose.translation().y(),
+            b.pose.translation().z(),
+            bxc, byc, bzc);
+    if (axc != bxc || ayc != byc || azc != bzc) {
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        auto d = std::fabs(a.pose.translation()[i] - b.pose.translation()[i]);
+        if (d + a.xyz_tolerance[i] > b.xyz_tolerance[i]) {
+            return false;
+        }
+    }
+
+    if (a.type == GoalType::XYZ_RPY_GOAL) {
+        Eigen::Quaterniond qa(a.pose.rotation());
+        Eigen::Quaterniond qb(b.pose.rotation());
+        // the cached waypoint's orientation may be off by up to the most
+        // permissive cached tolerance
+        auto max_cached_rpy_tolerance = std::max(
+                a.rpy_tolerance[0],
+                std::max(a.rpy_tolerance[1], a.rpy_tolerance[2]));
+        auto min_rpy_tolerance = std::min(
+                b.rpy_tolerance[0],
+                std::min(b.rpy_tolerance[1], b.rpy_tolerance[2]));
+        if (qa.angularDistance(qb) + max_cached_rpy_tolerance > min_rpy_tolerance) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Look for a cached solution matching the current grid epoch, start, and
+// goal. On a match, the cached path is snapped to the current start and
+// revalidated with state-to-state sweeps; a path that fails revalidation is
+// dropped from the cache and offered to the planning space as a one-path
+// experience when it accumulates them.
+bool PlannerInterface::lookupCachedPath(std::vector<RobotState>& path)
+{
+    auto grid_epoch = m_grid->epoch();
+    auto& start = m_pspace->startState();
+    auto& goal = m_pspace->goal();
+
+    for (auto it = begin(m_path_cache); it != end(m_path_cache); ++it) {
+        if (it->grid_epoch != grid_epoch ||
+            !StartsMatch(m_robot, it->start, start) ||
+            !GoalsMatch(m_grid, it->goal, goal))
+        {
+            continue;
+        }
+
+        auto cached = it->path;
+        cached.front() = start;
+        if (IsPathValid(m_checker, cached)) {
+            // move the entry to the front of the cache
+            std::rotate(begin(m_path_cache), it, it + 1);
+            path = std::move(cached);
+            return true;
+        }
+
+        SMPL_INFO_NAMED(PI_LOGGER, "Cached path failed revalidation");
+        auto* egraph_space = dynamic_cast<ManipLatticeEgraph*>(m_pspace.get());
+        if (egraph_space != NULL) {
+            // the search can still exploit the valid portions
+            egraph_space->submitExperiencePath(std::move(it->path));
+        }
+        m_path_cache.erase(it);
+        return false;
+    }
+
+    return false;
+}
+
+void PlannerInterface::storeCachedPath(const std::vector<RobotState>& path)
+{
+    if (m_path_cache_capacity == 0 || path.empty()) {
+        return;
+    }
+    auto& goal = m_pspace->goal();
+    if (goal.type != GoalType::XYZ_GOAL && goal.type != GoalType::XYZ_RPY_GOAL) {
+        return; // only pose goals are cached
+    }
+
+    CachedSolution entry;
+    entry.grid_epoch = m_grid->epoch();
+    entry.start = m_pspace->startState();
+    entry.goal = goal;
+    entry.path = path;
+
+    m_path_cache.insert(begin(m_path_cache), std::move(entry));
+    while (m_path_cache.size() > m_path_cache_capacity) {
+        m_path_cache.pop_back();
+    }
+}
+
+void PlannerInterface::setPathCacheCapacity(size_t capacity)
+{
+    m_path_cache_capacity = capacity;
+    while (m_path_cache.size() > m_path_cache_capacity) {
+        m_path_cache.pop_back();
+    }
+}
+
+auto PlannerInterface::submit(
+    const moveit_msgs::PlanningScene& planning_scene,
+    const moveit_msgs::MotionPlanRequest& req,
+    SolveCompletionCallback callback)
+    -> std::future<moveit_msgs::MotionPlanResponse>
+{
+    if (m_solve_in_flight.exchange(true)) {
+        SMPL_ERROR("Cannot submit a planning request while another is in flight");
+        return std::future<moveit_msgs::MotionPlanResponse>();
+    }
+
+    // reap the thread from a completed request
+    if (m_solve_thread.joinable()) {
+        m_solve_thread.join();
+    }
+
+    m_cancel_requested.store(false);
+
+    std::promise<moveit_msgs::MotionPlanResponse> promise;
+    auto future = promise.get_future();
+    m_solve_thread = std::thread(
+            [this, planning_scene, req, callback](
+                std::promise<moveit_msgs::MotionPlanResponse> p)
+            {
+                moveit_msgs::MotionPlanResponse res;
+                auto solved = solve(planning_scene, req, res);
+                if (!solved && m_cancel_requested.load()) {
+                    res.error_code.val =
+                            moveit_msgs::MoveItErrorCodes::PREEMPTED;
+                }
+                if (callback) {
+                    callback(res);
+                }
+                m_solve_in_flight.store(false);
+                p.set_value(std::move(res));
+            },
+            std::move(promise));
+
+    return future;
+}
+
+void PlannerInterface::cancel()
+{
+    if (!m_solve_in_flight.load()) {
+        return;
+    }
+
+    m_cancel_requested.store(true);
+
+    std::lock_guard<std::mutex> lock(m_cancel_mutex);
+    if (m_active_search) {
+        if (auto* search = dynamic_cast<ARAStar*>(m_active_search)) {
+            search->cancel();
+        }
+    }
+}
+
 static
 bool ExtractJointStateGoal(
     RobotModel* model,
@@ -1100,7 +1586,7 @@ bool PlannerInterface::setStart(const moveit_msgs::RobotState& state)
         }
     }
 
-    RobotState initial_positions;
+    std::vector<double> initial_positions;
     std::vector<std::string> missing;
     if (!leatherman::getJointPositions(
             state.joint_state,
@@ -1133,7 +1619,9 @@ bool PlannerInterface::setStart(const moveit_msgs::RobotState& state)
 
     SMPL_INFO_STREAM_NAMED(PI_LOGGER, "  joint variables: " << initial_positions);
 
-    if (!m_pspace->setStart(initial_positions)) {
+    if (!m_pspace->setStart(
+            RobotState(initial_positions.begin(), initial_positions.end())))
+    {
         SMPL_ERROR("Failed to set start state");
         return false;
     }
@@ -1168,8 +1656,16 @@ bool PlannerInterface::plan(double allowed_time, std::vector<RobotState>& path)
     bool b_ret = false;
     std::vector<int> solution_state_ids;
 
-    // reinitialize the search space
-    m_planner->force_planning_from_scratch();
+    // reinitialize the search space, or resume over the retained search tree
+    // when the search supports reuse between queries; the goal constraint may
+    // have changed behind an unchanged goal state id, so the search must be
+    // told explicitly
+    auto* ara = dynamic_cast<ARAStar*>(m_planner.get());
+    if (ara && ara->searchTreeReuse()) {
+        ara->notifyGoalChanged();
+    } else {
+        m_planner->force_planning_from_scratch();
+    }
 
     // plan
     b_ret = m_planner->replan(allowed_time, &solution_state_ids, &m_sol_cost);
@@ -1266,6 +1762,31 @@ auto PlannerInterface::getPlannerStats() -> std::map<std::string, double>
     return stats;
 }
 
+auto PlannerInterface::getMemoryUsage() const -> std::map<std::string, size_t>
+{
+    std::map<std::string, size_t> usage;
+
+    auto* search = dynamic_cast<const MemoryUsageProvider*>(m_planner.get());
+    if (search) {
+        usage["search"] = search->memUsage();
+    }
+
+    auto* graph = dynamic_cast<const MemoryUsageProvider*>(m_pspace.get());
+    if (graph) {
+        usage["graph"] = graph->memUsage();
+    }
+
+    for (const auto& entry : m_heuristics) {
+        auto* heuristic =
+                dynamic_cast<const MemoryUsageProvider*>(entry.second.get());
+        if (heuristic) {
+            usage["heuristic." + entry.first] = heuristic->memUsage();
+        }
+    }
+
+    return usage;
+}
+
 auto PlannerInterface::makePathVisualization(
     const std::vector<RobotState>& path) const
     -> std::vector<visual::Marker>
@@ -1387,6 +1908,26 @@ bool PlannerInterface::reinitPlanner(const std::string& planner_id)
         return true;
     }
 
+    // retire the active pipeline so a later request may reactivate it
+    if (m_planner) {
+        PlannerPipeline& retired = m_pipelines[m_planner_id];
+        retired.pspace = std::move(m_pspace);
+        retired.heuristics = std::move(m_heuristics);
+        retired.planner = std::move(m_planner);
+        m_planner_id.clear();
+    }
+
+    auto ppit = m_pipelines.find(planner_id);
+    if (ppit != end(m_pipelines)) {
+        SMPL_INFO_NAMED(PI_LOGGER, "Reactivate cached pipeline for planner '%s'", planner_id.c_str());
+        m_pspace = std::move(ppit->second.pspace);
+        m_heuristics = std::move(ppit->second.heuristics);
+        m_planner = std::move(ppit->second.planner);
+        m_pipelines.erase(ppit);
+        m_planner_id = planner_id;
+        return true;
+    }
+
     SMPL_INFO_NAMED(PI_LOGGER, "Initialize planner");
 
     std::string search_name;
@@ -1445,6 +1986,17 @@ bool PlannerInterface::reinitPlanner(const std::string& planner_id)
         SMPL_ERROR("Failed to build planner '%s'", search_name.c_str());
         return false;
     }
+
+    // route per-iteration search records into the shared event recorder and
+    // per-expansion records into the shared expansion trace
+    if (auto* ara = dynamic_cast<ARAStar*>(m_planner.get())) {
+        ara->setStatsRecorder(&m_stats);
+        ara->setExpansionTrace(&m_trace);
+    }
+    if (auto* mha = dynamic_cast<SMHAStar*>(m_planner.get())) {
+        mha->set_expansion_trace(&m_trace);
+    }
+
     m_planner_id = planner_id;
     return true;
 }
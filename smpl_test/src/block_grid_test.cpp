@@ -0,0 +1,269 @@
+#include <iostream>
+#include <utility>
+
+#define BOOST_TEST_MODULE BlockGridTest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <smpl/grid/block_grid.h>
+
+BOOST_AUTO_TEST_CASE(DefaultConstructorTest)
+{
+    smpl::BlockGrid<int> g;
+    BOOST_CHECK_EQUAL(g.size(), 64 * 64 * 64);
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ValueConstructorTest)
+{
+    smpl::BlockGrid<int> g(8);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 8);
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SetSingleCellTest)
+{
+    smpl::BlockGrid<int> g(0);
+
+    g.set(0, 0, 0, 8);
+
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 8);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 1), 0);
+    BOOST_CHECK_EQUAL(g.get(0, 1, 0), 0);
+    BOOST_CHECK_EQUAL(g.get(1, 0, 0), 0);
+
+    // cells outside the written block still read the background value
+    BOOST_CHECK_EQUAL(g.get(63, 63, 63), 0);
+
+    // only the containing block was allocated
+    BOOST_CHECK_EQUAL(g.num_blocks(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(SetBackgroundValueAllocatesNothingTest)
+{
+    smpl::BlockGrid<int> g(0);
+    g.set(4, 4, 4, 0);
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(CopyConstructorTest)
+{
+    smpl::BlockGrid<int> g(0);
+    g.set(0, 0, 0, 8);
+
+    smpl::BlockGrid<int> cg(g);
+    BOOST_CHECK_EQUAL(cg.get(0, 0, 0), 8);
+
+    BOOST_CHECK_EQUAL(cg.size_x(), g.size_x());
+    BOOST_CHECK_EQUAL(cg.size_y(), g.size_y());
+    BOOST_CHECK_EQUAL(cg.size_z(), g.size_z());
+    BOOST_CHECK_EQUAL(cg.size(), g.size());
+    BOOST_CHECK_EQUAL(cg.num_blocks(), g.num_blocks());
+
+    // copies do not share blocks
+    cg.set(0, 0, 0, 4);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 8);
+}
+
+BOOST_AUTO_TEST_CASE(MoveConstructorTest)
+{
+    smpl::BlockGrid<int> g(10);
+    g.set(0, 0, 0, 8);
+
+    smpl::BlockGrid<int> g2(std::move(g));
+
+    BOOST_CHECK_EQUAL(g2.get(0, 0, 0), 8);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
+{
+    smpl::BlockGrid<int> g1(10);
+
+    smpl::BlockGrid<int> g2(8);
+    g2.set(0, 0, 0, 6);
+
+    g1 = g2;
+
+    BOOST_CHECK_EQUAL(g1.get(0, 0, 0), g2.get(0, 0, 0));
+    BOOST_CHECK_EQUAL(g1.get(1, 1, 1), 8);
+    BOOST_CHECK_EQUAL(g1.num_blocks(), g2.num_blocks());
+}
+
+BOOST_AUTO_TEST_CASE(MoveAssignmentTest)
+{
+    smpl::BlockGrid<int> t1(10);
+
+    smpl::BlockGrid<int> t2(8);
+    t2.set(0, 0, 0, 6); // allocate a block to create an interesting memory scenario
+
+    t1 = std::move(t2);
+
+    BOOST_CHECK_EQUAL(t1.get(0, 0, 0), 6);
+}
+
+BOOST_AUTO_TEST_CASE(SetAndUnsetCellTest)
+{
+    smpl::BlockGrid<int> g(0);
+
+    g.set(0, 0, 0, 8);
+    g.set(0, 0, 0, 0);
+
+    // blocks are reclaimed by prune(), not by set()
+    BOOST_CHECK_EQUAL(g.num_blocks(), 1);
+
+    g.prune();
+
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ResetTest)
+{
+    smpl::BlockGrid<int> g(8);
+    g.set(0, 0, 0, 6);
+
+    g.reset(4);
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 4);
+}
+
+BOOST_AUTO_TEST_CASE(ReferenceStabilityTest)
+{
+    smpl::BlockGrid<int> g(64, 64, 64, 0);
+
+    int* ref = &g(0, 0, 0);
+    *ref = 8;
+
+    // writes into other blocks must not move previously referenced cells
+    for (int x = 0; x < 64; x += 8) {
+    for (int y = 0; y < 64; y += 8) {
+    for (int z = 0; z < 64; z += 8) {
+        g(x, y, z) = 1;
+    }
+    }
+    }
+
+    BOOST_CHECK_EQUAL(ref, &g(0, 0, 0));
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 1);
+}
+
+BOOST_AUTO_TEST_CASE(PredicatePruneTest)
+{
+    smpl::BlockGrid<int> g(64, 64, 64, 0);
+
+    for (int x = 0; x < 8; ++x) {
+    for (int y = 0; y < 8; ++y) {
+    for (int z = 0; z < 8; ++z) {
+        g.set(x, y, z, 3);
+    }
+    }
+    }
+    g.set(8, 0, 0, 3);
+
+    BOOST_CHECK_EQUAL(g.num_blocks(), 2);
+
+    // pruned cells read back as the background value, so no block may be
+    // reclaimed unless the background value also satisfies the predicate
+    g.prune([](int val) { return val == 3; });
+
+    BOOST_CHECK_EQUAL(g.num_blocks(), 2);
+
+    g.prune([](int val) { return val == 3 || val == 0; });
+
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ResizeTest)
+{
+    smpl::BlockGrid<int> g;
+    g.resize(16, 16, 16);
+    BOOST_CHECK_EQUAL(g.size(), 16 * 16 * 16);
+    BOOST_CHECK_EQUAL(g.num_blocks(), 0);
+
+    g.resize(8, 8, 8, 2);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), 2);
+}
+
+BOOST_AUTO_TEST_CASE(CoordsVisitorTest)
+{
+    smpl::BlockGrid<int> g(16, 16, 16, 0);
+    g.set(0, 0, 0, 1);
+
+    std::uint64_t volume = 0;
+    int hits = 0;
+    g.accept_coords([&](
+        int value,
+        int first_x, int first_y, int first_z,
+        int last_x, int last_y, int last_z)
+    {
+        volume += (std::uint64_t)(last_x - first_x) *
+                (std::uint64_t)(last_y - first_y) *
+                (std::uint64_t)(last_z - first_z);
+        if (value == 1) {
+            ++hits;
+            BOOST_CHECK_EQUAL(first_x, 0);
+            BOOST_CHECK_EQUAL(first_y, 0);
+            BOOST_CHECK_EQUAL(first_z, 0);
+        }
+    });
+
+    BOOST_CHECK_EQUAL(volume, g.size());
+    BOOST_CHECK_EQUAL(hits, 1);
+}
+
+BOOST_AUTO_TEST_CASE(MemUsageTest)
+{
+    smpl::BlockGrid<int> g(64, 64, 64, 0);
+    auto base = g.mem_usage();
+    g.set(0, 0, 0, 1);
+    BOOST_CHECK_EQUAL(g.mem_usage(), base + 8 * 8 * 8 * sizeof(int));
+}
+
+BOOST_AUTO_TEST_CASE(BinaryGridTest)
+{
+    smpl::BlockBinaryGrid<> g(64, 64, 64, false);
+
+    BOOST_CHECK_EQUAL(g.size_x(), 64);
+    BOOST_CHECK_EQUAL(g.size_y(), 64);
+    BOOST_CHECK_EQUAL(g.size_z(), 64);
+
+    g.set(0, 0, 0, true);
+    g.set(1, 1, 1, true);
+
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), true);
+    BOOST_CHECK_EQUAL(g.get(1, 1, 1), true);
+    BOOST_CHECK_EQUAL(g.get(0, 0, 1), false);
+    BOOST_CHECK_EQUAL(g.get(2, 2, 2), false);
+
+    g(2, 2, 2) = true;
+    BOOST_CHECK_EQUAL(g.get(2, 2, 2), true);
+    g(2, 2, 2) = false;
+    BOOST_CHECK_EQUAL(g.get(2, 2, 2), false);
+
+    g.set(0, 0, 0, false);
+    g.set(1, 1, 1, false);
+    g.prune();
+    BOOST_CHECK_EQUAL(g.get(0, 0, 0), false);
+}
+
+BOOST_AUTO_TEST_CASE(BinaryGridVisitorTest)
+{
+    smpl::BlockBinaryGrid<> g(16, 16, 16, false);
+    g.set(0, 0, 0, true);
+
+    std::uint64_t set_volume = 0;
+    g.accept_coords([&](
+        bool value,
+        int first_x, int first_y, int first_z,
+        int last_x, int last_y, int last_z)
+    {
+        if (value) {
+            set_volume += (std::uint64_t)(last_x - first_x) *
+                    (std::uint64_t)(last_y - first_y) *
+                    (std::uint64_t)(last_z - first_z);
+        }
+    });
+
+    BOOST_CHECK_EQUAL(set_volume, 1);
+}
@@ -724,7 +724,7 @@ int main(int argc, char* argv[])
     planner->params().setParam("bfs_cost_per_cell", "100");
 
     planner->setStateVisualizer(
-            [&](const std::vector<double>& state)
+            [&](const smpl::RobotState& state)
                 -> std::vector<smpl::visual::Marker>
             {
                 return cc.getCollisionModelVisualization(state);
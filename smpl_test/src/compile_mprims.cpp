@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <smpl/graph/mprim_profile.h>
+
+// Compile a pruned and usage-ordered action set file from a hand-authored
+// action set and the usage log recorded while planning with it (see
+// ManipLatticeActionSpace::writeUsageLog).
+int main(int argc, char* argv[])
+{
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <usage log> <mprim file> <output mprim file> [min path uses]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string log_path(argv[1]);
+    const std::string mprim_in_path(argv[2]);
+    const std::string mprim_out_path(argv[3]);
+
+    smpl::MotionPrimitiveCompileOptions options;
+    if (argc > 4) {
+        options.min_path_uses = strtoull(argv[4], NULL, 10);
+    }
+
+    smpl::MotionPrimitiveUsage usage;
+    if (!smpl::LoadMotionPrimitiveUsageLog(log_path, usage)) {
+        fprintf(stderr, "Failed to load usage log from '%s'\n", log_path.c_str());
+        return 1;
+    }
+
+    printf("Loaded usage for %zu primitives over %zu episodes\n",
+            usage.path_uses.size(), usage.episodes);
+
+    if (!smpl::CompileMotionPrimitiveSet(
+            mprim_in_path, usage, options, mprim_out_path))
+    {
+        fprintf(stderr, "Failed to compile motion primitive set\n");
+        return 1;
+    }
+
+    printf("Wrote compiled action set to '%s'\n", mprim_out_path.c_str());
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <iomanip>
 #include <iostream>
 #include <ostream>
+#include <random>
 #include <utility>
 
 #include <smpl/distance_map/euclid_distance_map.h>
@@ -153,9 +154,55 @@ void TestSpecialMemberFunctions()
     }
 }
 
+template <class DistanceMap>
+void TestBufferedUpdates()
+{
+    const double origin_x = 0.0;
+    const double origin_y = 0.0;
+    const double origin_z = 0.0;
+    const double size_x = 10.0;
+    const double size_y = 10.0;
+    const double size_z = 10.0;
+    const double res = 0.5;
+    const double max_dist = 2.0;
+
+    DistanceMap d1(
+            origin_x, origin_y, origin_z,
+            size_x, size_y, size_z,
+            res, max_dist);
+    DistanceMap d2(d1);
+
+    std::vector<Eigen::Vector3d> points;
+    std::default_random_engine rng;
+    std::uniform_real_distribution<double> dist(0.0, 10.0);
+    for (int i = 0; i < 10; ++i) {
+        points.emplace_back(dist(rng), dist(rng), dist(rng));
+    }
+
+    // immediate updates in d1, buffered updates in d2
+    d1.addPointsToMap(points);
+    d2.bufferPointsToMap(points);
+    d2.flushUpdates();
+
+    if (d1 != d2) {
+        printf("Buffered insertions do not match immediate insertions\n");
+    }
+
+    std::vector<Eigen::Vector3d> removed(
+            points.begin(), points.begin() + (points.size() >> 1));
+    d1.removePointsFromMap(removed);
+    d2.bufferPointsFromMap(removed);
+    d2.flushUpdates();
+
+    if (d1 != d2) {
+        printf("Buffered removals do not match immediate removals\n");
+    }
+}
+
 int main(int argc, char* argv[])
 {
     TestSpecialMemberFunctions<smpl::SparseDistanceMap>();
 //    TestSpecialMemberFunctions<smpl::EuclidDistanceMap>();
+    TestBufferedUpdates<smpl::SparseDistanceMap>();
     return 0;
 }
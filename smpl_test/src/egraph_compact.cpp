@@ -0,0 +1,58 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <smpl/graph/experience_dedup.h>
+#include <smpl/graph/experience_graph.h>
+#include <smpl/graph/experience_graph_index.h>
+#include <smpl/graph/experience_graph_io.h>
+
+// Offline compaction pass over a serialized experience graph: drop the paths
+// dominated within tolerance by cheaper alternatives and rewrite the binary
+// file with renumbered ids. Run periodically, this bounds the graph size
+// that every heuristic rebuild and snap enumeration must process.
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <input egraph> <output egraph> [dtw threshold] [frechet threshold] [prune radius]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string in_path(argv[1]);
+    const std::string out_path(argv[2]);
+
+    smpl::PathDedupParams params;
+    if (argc > 3) {
+        params.dtw_threshold = strtod(argv[3], NULL);
+    }
+    if (argc > 4) {
+        params.frechet_threshold = strtod(argv[4], NULL);
+    }
+    if (argc > 5) {
+        params.prune_radius = strtod(argv[5], NULL);
+    }
+
+    smpl::ExperienceGraph eg;
+    if (!smpl::ReadExperienceGraph(in_path, eg)) {
+        fprintf(stderr, "Failed to read experience graph from '%s'\n", in_path.c_str());
+        return 1;
+    }
+
+    printf("Loaded %zu nodes and %zu edges\n", eg.num_nodes(), eg.num_edges());
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+
+    auto removed = smpl::CompactExperienceGraph(&eg, &index, params);
+
+    printf("Removed %d dominated paths; %zu nodes and %zu edges remain\n",
+            removed, eg.num_nodes(), eg.num_edges());
+
+    if (!smpl::WriteExperienceGraph(eg, out_path)) {
+        fprintf(stderr, "Failed to write experience graph to '%s'\n", out_path.c_str());
+        return 1;
+    }
+
+    printf("Wrote compacted experience graph to '%s'\n", out_path.c_str());
+    return 0;
+}
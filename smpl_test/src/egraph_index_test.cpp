@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+// standard includes
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#define BOOST_TEST_MODULE ExperienceGraphIndexTest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+// system includes
+#include <smpl/graph/experience_graph_index.h>
+
+namespace {
+
+double JointDist(const smpl::RobotState& a, const smpl::RobotState& b)
+{
+    double dsum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const double d = a[i] - b[i];
+        dsum += d * d;
+    }
+    return std::sqrt(dsum);
+}
+
+auto MakeRandomGraph(int count, int dims, unsigned seed)
+    -> smpl::ExperienceGraph
+{
+    std::default_random_engine rng(seed);
+    std::uniform_real_distribution<double> dist(-3.0, 3.0);
+
+    smpl::ExperienceGraph eg;
+    for (int i = 0; i < count; ++i) {
+        smpl::RobotState state(dims);
+        for (int j = 0; j < dims; ++j) {
+            state[j] = dist(rng);
+        }
+        eg.insert_node(state);
+    }
+    return eg;
+}
+
+auto BruteForceRadius(
+    const smpl::ExperienceGraph& eg,
+    const smpl::RobotState& q,
+    double radius)
+    -> std::vector<smpl::ExperienceGraph::node_id>
+{
+    std::vector<smpl::ExperienceGraph::node_id> nodes;
+    for (smpl::ExperienceGraph::node_id n = 0; n < eg.num_nodes(); ++n) {
+        if (JointDist(q, eg.state(n)) <= radius) {
+            nodes.push_back(n);
+        }
+    }
+    return nodes;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(RadiusQueryMatchesBruteForce)
+{
+    auto eg = MakeRandomGraph(500, 6, 0xE61);
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+
+    std::default_random_engine rng(0xE62);
+    std::uniform_real_distribution<double> dist(-3.0, 3.0);
+    for (int t = 0; t < 50; ++t) {
+        smpl::RobotState q(6);
+        for (auto& v : q) {
+            v = dist(rng);
+        }
+
+        std::vector<smpl::ExperienceGraph::node_id> nodes;
+        index.nodesInRadius(q, 1.0, nodes);
+        std::sort(nodes.begin(), nodes.end());
+
+        auto expected = BruteForceRadius(eg, q, 1.0);
+        BOOST_CHECK_EQUAL_COLLECTIONS(
+                nodes.begin(), nodes.end(),
+                expected.begin(), expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KNearestReturnsNearestInOrder)
+{
+    auto eg = MakeRandomGraph(200, 4, 0xE63);
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+
+    const smpl::RobotState q(4, 0.0);
+    const int k = 10;
+
+    std::vector<smpl::ExperienceGraph::node_id> nodes;
+    index.kNearestNodes(q, k, nodes);
+    BOOST_REQUIRE_EQUAL(nodes.size(), k);
+
+    // returned nodes are ordered nearest-first
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        BOOST_CHECK_LE(
+                JointDist(q, eg.state(nodes[i - 1])),
+                JointDist(q, eg.state(nodes[i])));
+    }
+
+    // the k-th distance bounds every node outside the result set
+    const double kth = JointDist(q, eg.state(nodes.back()));
+    for (smpl::ExperienceGraph::node_id n = 0; n < eg.num_nodes(); ++n) {
+        if (std::find(nodes.begin(), nodes.end(), n) == nodes.end()) {
+            BOOST_CHECK_GE(JointDist(q, eg.state(n)), kth);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(KNearestOnSmallGraph)
+{
+    auto eg = MakeRandomGraph(3, 2, 0xE64);
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+
+    std::vector<smpl::ExperienceGraph::node_id> nodes;
+    index.kNearestNodes(smpl::RobotState(2, 0.0), 10, nodes);
+    BOOST_CHECK_EQUAL(nodes.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(RebuildsAfterAppend)
+{
+    auto eg = MakeRandomGraph(100, 3, 0xE65);
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+
+    const smpl::RobotState q(3, 0.0);
+
+    std::vector<smpl::ExperienceGraph::node_id> nodes;
+    index.nodesInRadius(q, 1.0, nodes);
+
+    // nodes appended after the first query are found by the next query
+    auto added = eg.insert_node(q);
+
+    nodes.clear();
+    index.nodesInRadius(q, 1.0, nodes);
+    BOOST_CHECK(std::find(nodes.begin(), nodes.end(), added) != nodes.end());
+
+    std::sort(nodes.begin(), nodes.end());
+    auto expected = BruteForceRadius(eg, q, 1.0);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+            nodes.begin(), nodes.end(),
+            expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(PointRadiusQuery)
+{
+    auto eg = MakeRandomGraph(100, 3, 0xE66);
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+    index.setPointCellSize(0.25);
+
+    std::default_random_engine rng(0xE67);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<smpl::Vector3> points(eg.num_nodes());
+    for (smpl::ExperienceGraph::node_id n = 0; n < eg.num_nodes(); ++n) {
+        points[n] = smpl::Vector3(dist(rng), dist(rng), dist(rng));
+        index.setNodePoint(n, points[n]);
+    }
+
+    const smpl::Vector3 q(0.0, 0.0, 0.0);
+    const double radius = 0.5;
+
+    std::vector<smpl::ExperienceGraph::node_id> nodes;
+    index.nodesInRadius(q, radius, nodes);
+    std::sort(nodes.begin(), nodes.end());
+
+    std::vector<smpl::ExperienceGraph::node_id> expected;
+    for (smpl::ExperienceGraph::node_id n = 0; n < eg.num_nodes(); ++n) {
+        if ((points[n] - q).norm() <= radius) {
+            expected.push_back(n);
+        }
+    }
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+            nodes.begin(), nodes.end(),
+            expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(PointUpdateMovesNode)
+{
+    smpl::ExperienceGraph eg;
+    eg.insert_node(smpl::RobotState(2, 0.0));
+
+    smpl::ExperienceGraphIndex index;
+    index.attach(&eg);
+    index.setPointCellSize(0.25);
+
+    index.setNodePoint(0, smpl::Vector3(0.0, 0.0, 0.0));
+    index.setNodePoint(0, smpl::Vector3(2.0, 2.0, 2.0));
+
+    std::vector<smpl::ExperienceGraph::node_id> nodes;
+    index.nodesInRadius(smpl::Vector3(0.0, 0.0, 0.0), 0.5, nodes);
+    BOOST_CHECK(nodes.empty());
+
+    index.nodesInRadius(smpl::Vector3(2.0, 2.0, 2.0), 0.5, nodes);
+    BOOST_REQUIRE_EQUAL(nodes.size(), 1);
+    BOOST_CHECK_EQUAL(nodes[0], 0);
+}
@@ -371,3 +371,43 @@ BOOST_AUTO_TEST_CASE(ParallelEdgeTest)
 //
 //    BOOST_CHECK_EQUAL(eg.degree(n1), 1);
 }
+
+BOOST_AUTO_TEST_CASE(BulkInsertRebuildAdjacencyTest)
+{
+    smpl::ExperienceGraph eg;
+    smpl::RobotState zero_state;
+
+    std::vector<smpl::RobotState> states(4, zero_state);
+    smpl::ExperienceGraph::node_id n1 = eg.insert_nodes(states);
+
+    BOOST_CHECK_EQUAL(eg.num_nodes(), 4);
+    BOOST_CHECK(IteratedAllNodes(eg));
+
+    std::vector<std::pair<smpl::ExperienceGraph::node_id, smpl::ExperienceGraph::node_id>> edges;
+    edges.emplace_back(n1, n1 + 1);
+    edges.emplace_back(n1 + 1, n1 + 2);
+    edges.emplace_back(n1 + 2, n1 + 3);
+    edges.emplace_back(n1, n1 + 2);
+    eg.insert_edges(edges);
+
+    BOOST_CHECK_EQUAL(eg.num_edges(), 4);
+    BOOST_CHECK(IteratedAllEdges(eg));
+
+    eg.rebuild_adjacency();
+
+    // adjacency queries served from the csr layout match the per-node lists
+    BOOST_CHECK_EQUAL(eg.degree(n1), 2);
+    BOOST_CHECK_EQUAL(eg.degree(n1 + 1), 2);
+    BOOST_CHECK_EQUAL(eg.degree(n1 + 2), 3);
+    BOOST_CHECK_EQUAL(eg.degree(n1 + 3), 1);
+    BOOST_CHECK_EQUAL(std::distance(eg.edges(n1).first, eg.edges(n1).second), 2);
+    BOOST_CHECK_EQUAL(std::distance(eg.adjacent_nodes(n1 + 2).first, eg.adjacent_nodes(n1 + 2).second), 3);
+    BOOST_CHECK_EQUAL(*eg.adjacent_nodes(n1 + 3).first, n1 + 2);
+    BOOST_CHECK(eg.edge(n1, n1 + 2));
+
+    // mutation falls back to the per-node lists
+    smpl::ExperienceGraph::node_id n5 = eg.insert_node(zero_state);
+    eg.insert_edge(n1 + 3, n5);
+    BOOST_CHECK_EQUAL(eg.degree(n1 + 3), 2);
+    BOOST_CHECK_EQUAL(std::distance(eg.edges(n1 + 3).first, eg.edges(n1 + 3).second), 2);
+}
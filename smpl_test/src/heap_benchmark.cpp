@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+// Compare the available OPEN list implementations on two synthetic workloads:
+//
+// (1) expansion-heavy: push all elements, then alternate pops with a handful
+//     of pushes, approximating a weighted A* search where most successors are
+//     new states
+// (2) decrease-key-heavy: push all elements, then repeatedly decrease the key
+//     of random elements between pops, approximating Dijkstra-like searches
+//     over dense graphs
+
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <smpl/heap/intrusive_heap.h>
+#include <smpl/heap/intrusive_dary_heap.h>
+#include <smpl/heap/pairing_heap.h>
+
+namespace {
+
+template <class Base>
+struct open_element : Base
+{
+    int priority;
+
+    open_element() = default;
+    open_element(int p) : priority(p) { }
+};
+
+template <class Base>
+struct open_element_compare
+{
+    bool operator()(
+        const open_element<Base>& a,
+        const open_element<Base>& b) const
+    {
+        return a.priority < b.priority;
+    }
+};
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+double to_ms(bench_clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+template <class Heap, class Base>
+double BenchExpansions(std::vector<open_element<Base>>& elements)
+{
+    std::default_random_engine rng;
+    std::uniform_int_distribution<int> prio(0, 1 << 20);
+
+    Heap h;
+    auto start = bench_clock::now();
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+
+    // pop everything, reinserting a few popped elements with worse
+    // priorities, as successors of an expansion would be
+    size_t reinserted = 0;
+    while (!h.empty()) {
+        auto* e = h.min();
+        h.pop();
+        if (reinserted < elements.size() / 4) {
+            e->priority += prio(rng);
+            h.push(e);
+            ++reinserted;
+        }
+    }
+    return to_ms(bench_clock::now() - start);
+}
+
+template <class Heap, class Base>
+double BenchDecreaseKey(std::vector<open_element<Base>>& elements)
+{
+    std::default_random_engine rng;
+    std::uniform_int_distribution<int> pick(0, (int)elements.size() - 1);
+
+    Heap h;
+    auto start = bench_clock::now();
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+
+    // several rounds of random decreases, as edge relaxations would cause
+    for (int round = 0; round < 8; ++round) {
+        for (size_t i = 0; i < elements.size(); ++i) {
+            auto& e = elements[pick(rng)];
+            if (h.contains(&e) && e.priority > 0) {
+                e.priority /= 2;
+                h.decrease(&e);
+            }
+        }
+    }
+
+    while (!h.empty()) {
+        h.pop();
+    }
+    return to_ms(bench_clock::now() - start);
+}
+
+template <class Base>
+void FillRandom(std::vector<open_element<Base>>& elements)
+{
+    // default-seeded so every heap type sees the same priority sequence
+    std::default_random_engine rng;
+    std::uniform_int_distribution<int> prio(0, 1 << 20);
+    for (auto& e : elements) {
+        e = open_element<Base>(prio(rng));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    size_t num_elements = 1000000;
+    if (argc > 1) {
+        num_elements = (size_t)atol(argv[1]);
+    }
+
+    typedef open_element<smpl::heap_element> array_element;
+    typedef open_element<smpl::pairing_heap_element> node_element;
+    typedef open_element_compare<smpl::heap_element> array_compare;
+    typedef open_element_compare<smpl::pairing_heap_element> node_compare;
+
+    typedef smpl::intrusive_heap<array_element, array_compare> binary_heap;
+    typedef smpl::intrusive_dary_heap<array_element, 4, array_compare> quad_heap;
+    typedef smpl::intrusive_dary_heap<array_element, 8, array_compare> oct_heap;
+    typedef smpl::pairing_heap<node_element, node_compare> pair_heap;
+
+    std::vector<array_element> array_elements(num_elements);
+    std::vector<node_element> node_elements(num_elements);
+
+    printf("expansion-heavy workload (%zu elements):\n", num_elements);
+    FillRandom(array_elements);
+    printf("  binary heap:  %8.3f ms\n", BenchExpansions<binary_heap>(array_elements));
+    FillRandom(array_elements);
+    printf("  4-ary heap:   %8.3f ms\n", BenchExpansions<quad_heap>(array_elements));
+    FillRandom(array_elements);
+    printf("  8-ary heap:   %8.3f ms\n", BenchExpansions<oct_heap>(array_elements));
+    FillRandom(node_elements);
+    printf("  pairing heap: %8.3f ms\n", BenchExpansions<pair_heap>(node_elements));
+
+    printf("decrease-key-heavy workload (%zu elements):\n", num_elements);
+    FillRandom(array_elements);
+    printf("  binary heap:  %8.3f ms\n", BenchDecreaseKey<binary_heap>(array_elements));
+    FillRandom(array_elements);
+    printf("  4-ary heap:   %8.3f ms\n", BenchDecreaseKey<quad_heap>(array_elements));
+    FillRandom(array_elements);
+    printf("  8-ary heap:   %8.3f ms\n", BenchDecreaseKey<oct_heap>(array_elements));
+    FillRandom(node_elements);
+    printf("  pairing heap: %8.3f ms\n", BenchDecreaseKey<pair_heap>(node_elements));
+
+    return 0;
+}
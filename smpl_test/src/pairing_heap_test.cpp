@@ -0,0 +1,287 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <assert.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE PairingHeapTest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <smpl/heap/pairing_heap.h>
+
+struct open_element : smpl::pairing_heap_element
+{
+    int priority;
+
+    open_element() = default;
+    open_element(int p) : priority(p) { }
+};
+
+struct open_element_compare
+{
+    bool operator()(const open_element& a, const open_element& b)
+    {
+        return a.priority < b.priority;
+    }
+};
+
+typedef smpl::pairing_heap<open_element, open_element_compare> heap_type;
+
+BOOST_AUTO_TEST_CASE(DefaultConstructTest)
+{
+    heap_type h;
+    BOOST_CHECK(h.empty());
+    BOOST_CHECK(h.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(PushPopTest)
+{
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12 };
+
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+    BOOST_CHECK(!h.empty());
+    BOOST_CHECK(h.size() == 5);
+    BOOST_CHECK(h.min() == &elements[3]);
+
+    h.pop();
+    BOOST_CHECK(h.min() == &elements[2]);
+    h.pop();
+    BOOST_CHECK(h.min() == &elements[0]);
+    h.pop();
+    BOOST_CHECK(h.min() == &elements[1]);
+    h.pop();
+    BOOST_CHECK(h.min() == &elements[4]);
+    h.pop();
+    BOOST_CHECK(h.empty());
+}
+
+BOOST_AUTO_TEST_CASE(ContainsTest)
+{
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12 };
+
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+        BOOST_CHECK(h.contains(&e));
+    }
+
+    h.erase(&elements[2]);
+    BOOST_CHECK(!h.contains(&elements[2]));
+    BOOST_CHECK(h.size() == 4);
+
+    h.pop();
+    BOOST_CHECK(!h.contains(&elements[3]));
+}
+
+BOOST_AUTO_TEST_CASE(ClearTest)
+{
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12 };
+
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+    h.clear();
+    BOOST_CHECK(h.empty());
+    BOOST_CHECK(h.size() == 0);
+    for (auto& e : elements) {
+        BOOST_CHECK(!h.contains(&e));
+    }
+
+    // elements must be reusable after clear()
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+    BOOST_CHECK(h.size() == 5);
+    BOOST_CHECK(h.min() == &elements[3]);
+}
+
+BOOST_AUTO_TEST_CASE(MoveConstructorTest)
+{
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12 };
+
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+
+    heap_type h2(std::move(h));
+    BOOST_CHECK(h2.size() == 5);
+    BOOST_CHECK(h2.min() == &elements[3]);
+}
+
+BOOST_AUTO_TEST_CASE(UpdateTest)
+{
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12 };
+
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+
+    BOOST_CHECK(h.min() == &elements[3]);
+    elements[3].priority = 6;
+    h.update(&elements[3]);
+    BOOST_CHECK(h.min() == &elements[2]);
+
+    elements[3].priority = 2;
+    h.update(&elements[3]);
+    BOOST_CHECK(h.min() == &elements[3]);
+}
+
+BOOST_AUTO_TEST_CASE(MutabilityTest)
+{
+    // Test a variety of increases, decreases, and updates
+
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12, 6, 3, 6, 10 };
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+
+    std::default_random_engine rng;
+    std::uniform_int_distribution<int> dist(0, elements.size() - 1);
+    std::uniform_int_distribution<int> mod_dist(-10, 10);
+
+    auto comp = [](const open_element& e1, const open_element& e2) {
+        return e1.priority < e2.priority;
+    };
+
+    int num_trials = 100;
+    for (int i = 0; i < num_trials; ++i) {
+        int r = dist(rng);
+        int mod = abs(mod_dist(rng));
+
+        elements[r].priority += mod;
+        h.increase(&elements[r]);
+
+        auto min = std::min_element(elements.begin(), elements.end(), comp);
+        open_element* pmin = &elements[0] + std::distance(elements.begin(), min);
+        BOOST_CHECK(!comp(*h.min(), *pmin) && !comp(*pmin, *h.min()));
+
+        r = dist(rng);
+        mod = abs(mod_dist(rng));
+
+        elements[r].priority -= mod;
+        h.decrease(&elements[r]);
+
+        min = std::min_element(elements.begin(), elements.end(), comp);
+        pmin = &elements[0] + std::distance(elements.begin(), min);
+        BOOST_CHECK(!comp(*h.min(), *pmin) && !comp(*pmin, *h.min()));
+
+        r = dist(rng);
+        mod = mod_dist(rng);
+
+        elements[r].priority += mod;
+        h.update(&elements[r]);
+
+        min = std::min_element(elements.begin(), elements.end(), comp);
+        pmin = &elements[0] + std::distance(elements.begin(), min);
+        BOOST_CHECK(!comp(*h.min(), *pmin) && !comp(*pmin, *h.min()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(PushEraseTest)
+{
+    // Test a variety of interleaved pushes and erasures
+
+    std::vector<open_element> elements = { 8, 10, 4, 2, 12, 6, 3, 6, 10 };
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+    std::vector<bool> inheap(elements.size(), true);
+
+    std::default_random_engine rng;
+    std::uniform_int_distribution<int> dist(0, elements.size() - 1);
+
+    open_element_compare comp;
+
+    int num_trials = 100;
+    for (int i = 0; i < num_trials; ++i) {
+        int r = dist(rng);
+        if (inheap[r]) {
+            h.erase(&elements[r]);
+        } else {
+            h.push(&elements[r]);
+        }
+        inheap[r] = !inheap[r];
+
+        auto is_true = [](bool b) { return b; };
+        if (std::any_of(inheap.begin(), inheap.end(), is_true)) {
+            open_element* emin = nullptr;
+            int min_priority = std::numeric_limits<int>::max();
+            for (size_t ei = 0; ei < elements.size(); ++ei) {
+                if (inheap[ei]) {
+                    if (elements[ei].priority < min_priority) {
+                        min_priority = elements[ei].priority;
+                        emin = &elements[ei];
+                    }
+                }
+            }
+
+            assert(emin);
+
+            BOOST_CHECK(!comp(*h.min(), *emin) && !comp(*emin, *h.min()));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(HeapSortTest)
+{
+    // popping every element must yield a non-decreasing priority sequence
+
+    std::default_random_engine rng;
+    std::uniform_int_distribution<int> dist(0, 1000);
+
+    std::vector<open_element> elements(1000);
+    for (auto& e : elements) {
+        e.priority = dist(rng);
+    }
+
+    heap_type h;
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+
+    int prev = h.min()->priority;
+    while (!h.empty()) {
+        int curr = h.min()->priority;
+        BOOST_CHECK(prev <= curr);
+        prev = curr;
+        h.pop();
+    }
+}
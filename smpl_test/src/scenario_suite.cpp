@@ -0,0 +1,763 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2017, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+/// \author Andrew Dornbush
+
+// A batch runner for planning scenario suites. Scenarios (a start state and a
+// goal, in the format of the configs under smpl_test/experiments) are loaded
+// onto the parameter server under the ~suite namespace, one child namespace
+// per scenario. Each scenario is run for a configurable number of trials,
+// distributed across worker threads that each own a fully isolated robot
+// model, collision space, and planner instance. Per-trial planner statistics
+// and per-iteration search records are aggregated into CSV files for offline
+// analysis, replacing the one-roscore-per-trial shell loops previously used
+// for evaluation sweeps.
+//
+// Parameters:
+//     ~suite: map of scenario name -> { initial_configuration, goal }
+//     ~trials: number of trials per scenario (default 1)
+//     ~workers: number of worker threads; 0 = hardware concurrency (default 1)
+//     ~output: output path prefix for <prefix>_trials.csv and
+//         <prefix>_iterations.csv (default "scenario_suite")
+//
+// The robot model, collision model, planner configuration, and world are read
+// from the same parameters as callPlanner and are shared by all scenarios.
+
+// standard includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// system includes
+#include <eigen_conversions/eigen_msg.h>
+#include <moveit_msgs/MotionPlanRequest.h>
+#include <moveit_msgs/MotionPlanResponse.h>
+#include <moveit_msgs/PlanningScene.h>
+#include <ros/ros.h>
+#include <sbpl_collision_checking/collision_space.h>
+#include <sbpl_kdl_robot_model/kdl_robot_model.h>
+#include <smpl/angles.h>
+#include <smpl/stats.h>
+#include <smpl/distance_map/euclid_distance_map.h>
+#include <smpl/ros/planner_interface.h>
+
+#include "collision_space_scene.h"
+#include "pr2_allowed_collision_pairs.h"
+
+struct Scenario
+{
+    std::string name;
+    moveit_msgs::RobotState start_state;
+    std::vector<double> goal; // (x, y, z, roll, pitch, yaw)
+    double allowed_planning_time;
+};
+
+struct TrialResult
+{
+    std::string scenario;
+    int trial;
+    bool success;
+    double wall_time;
+    std::map<std::string, double> stats;
+    std::vector<smpl::StatEvent> events;
+};
+
+struct RobotModelConfig
+{
+    std::string group_name;
+    std::vector<std::string> planning_joints;
+    std::string kinematics_frame;
+    std::string chain_tip_link;
+};
+
+// Configuration shared by all workers; read once from the parameter server
+// before any worker starts and immutable afterwards.
+struct SuiteConfig
+{
+    std::string robot_description;
+    std::string planning_frame;
+    std::string object_filename;
+    RobotModelConfig robot_config;
+    smpl::collision::CollisionModelConfig cc_conf;
+    smpl::PlanningParams params;
+    std::string planner_id;
+};
+
+void FillGoalConstraint(
+    const std::vector<double>& pose,
+    std::string frame_id,
+    moveit_msgs::Constraints& goals)
+{
+    if (pose.size() < 6) {
+        return;
+    }
+
+    goals.position_constraints.resize(1);
+    goals.orientation_constraints.resize(1);
+    goals.position_constraints[0].header.frame_id = frame_id;
+
+    goals.position_constraints[0].constraint_region.primitives.resize(1);
+    goals.position_constraints[0].constraint_region.primitive_poses.resize(1);
+    goals.position_constraints[0].constraint_region.primitives[0].type = shape_msgs::SolidPrimitive::BOX;
+    goals.position_constraints[0].constraint_region.primitive_poses[0].position.x = pose[0];
+    goals.position_constraints[0].constraint_region.primitive_poses[0].position.y = pose[1];
+    goals.position_constraints[0].constraint_region.primitive_poses[0].position.z = pose[2];
+
+    Eigen::Quaterniond q;
+    smpl::angles::from_euler_zyx(pose[5], pose[4], pose[3], q);
+    tf::quaternionEigenToMsg(q, goals.orientation_constraints[0].orientation);
+
+    goals.position_constraints[0].constraint_region.primitives[0].dimensions.resize(3, 0.015);
+    goals.orientation_constraints[0].absolute_x_axis_tolerance = 0.05;
+    goals.orientation_constraints[0].absolute_y_axis_tolerance = 0.05;
+    goals.orientation_constraints[0].absolute_z_axis_tolerance = 0.05;
+}
+
+auto GetCollisionCube(
+    const geometry_msgs::Pose& pose,
+    std::vector<double>& dims,
+    const std::string& frame_id,
+    const std::string& id)
+    -> moveit_msgs::CollisionObject
+{
+    moveit_msgs::CollisionObject object;
+    object.id = id;
+    object.operation = moveit_msgs::CollisionObject::ADD;
+    object.header.frame_id = frame_id;
+    object.header.stamp = ros::Time::now();
+
+    shape_msgs::SolidPrimitive box_object;
+    box_object.type = shape_msgs::SolidPrimitive::BOX;
+    box_object.dimensions.resize(3);
+    box_object.dimensions[0] = dims[0];
+    box_object.dimensions[1] = dims[1];
+    box_object.dimensions[2] = dims[2];
+
+    object.primitives.push_back(box_object);
+    object.primitive_poses.push_back(pose);
+    return object;
+}
+
+auto GetCollisionObjects(
+    const std::string& filename,
+    const std::string& frame_id)
+    -> std::vector<moveit_msgs::CollisionObject>
+{
+    char sTemp[1024];
+    int num_obs = 0;
+    std::vector<moveit_msgs::CollisionObject> objs;
+
+    FILE* fCfg = fopen(filename.c_str(), "r");
+
+    if (fCfg == NULL) {
+        ROS_ERROR("Failed to open objects file '%s'", filename.c_str());
+        return objs;
+    }
+
+    if (fscanf(fCfg, "%s", sTemp) < 1) {
+        printf("Parsed string has length < 1.\n");
+    }
+
+    num_obs = atoi(sTemp);
+
+    ROS_INFO("%i objects in file", num_obs);
+
+    geometry_msgs::Pose pose;
+    pose.orientation.x = 0;
+    pose.orientation.y = 0;
+    pose.orientation.z = 0;
+    pose.orientation.w = 1;
+    std::vector<double> dims(3, 0);
+
+    for (int i = 0; i < num_obs; ++i) {
+        if (fscanf(fCfg, "%s", sTemp) < 1) {
+            printf("Parsed string has length < 1.\n");
+        }
+        std::string object_id = sTemp;
+
+        double vals[6] = { 0 };
+        for (int j = 0; j < 6; ++j) {
+            if (fscanf(fCfg, "%s", sTemp) < 1) {
+                printf("Parsed string has length < 1.\n");
+            }
+            if (!feof(fCfg) && strlen(sTemp) != 0) {
+                vals[j] = atof(sTemp);
+            }
+        }
+
+        pose.position.x = vals[0];
+        pose.position.y = vals[1];
+        pose.position.z = vals[2];
+        dims[0] = vals[3];
+        dims[1] = vals[4];
+        dims[2] = vals[5];
+
+        objs.push_back(GetCollisionCube(pose, dims, frame_id, object_id));
+    }
+
+    fclose(fCfg);
+    return objs;
+}
+
+bool ReadJointStateXml(
+    XmlRpc::XmlRpcValue& xlist,
+    moveit_msgs::RobotState& state)
+{
+    if (xlist.getType() != XmlRpc::XmlRpcValue::TypeArray) {
+        ROS_WARN("initial_configuration/joint_state is not an array");
+        return false;
+    }
+
+    for (int i = 0; i < xlist.size(); ++i) {
+        state.joint_state.name.push_back(std::string(xlist[i]["name"]));
+
+        if (xlist[i]["position"].getType() == XmlRpc::XmlRpcValue::TypeDouble) {
+            state.joint_state.position.push_back(double(xlist[i]["position"]));
+        } else if (xlist[i]["position"].getType() == XmlRpc::XmlRpcValue::TypeInt) {
+            int pos = xlist[i]["position"];
+            state.joint_state.position.push_back(double(pos));
+        }
+    }
+
+    return true;
+}
+
+// Read a scenario (start state and goal pose) from one child namespace of
+// ~suite, in the format of the configs under smpl_test/experiments.
+bool ReadScenario(
+    const std::string& name,
+    XmlRpc::XmlRpcValue& xscen,
+    double default_planning_time,
+    Scenario& scenario)
+{
+    scenario.name = name;
+
+    if (!xscen.hasMember("initial_configuration") ||
+        !xscen["initial_configuration"].hasMember("joint_state"))
+    {
+        ROS_ERROR("Scenario '%s' is missing initial_configuration/joint_state", name.c_str());
+        return false;
+    }
+
+    if (!ReadJointStateXml(
+            xscen["initial_configuration"]["joint_state"],
+            scenario.start_state))
+    {
+        return false;
+    }
+
+    if (!xscen.hasMember("goal")) {
+        ROS_ERROR("Scenario '%s' is missing goal", name.c_str());
+        return false;
+    }
+
+    XmlRpc::XmlRpcValue& xgoal = xscen["goal"];
+    const char* goal_vars[] = { "x", "y", "z", "roll", "pitch", "yaw" };
+    scenario.goal.assign(6, 0.0);
+    for (int i = 0; i < 6; ++i) {
+        if (xgoal.hasMember(goal_vars[i])) {
+            if (xgoal[goal_vars[i]].getType() == XmlRpc::XmlRpcValue::TypeInt) {
+                scenario.goal[i] = (double)(int)xgoal[goal_vars[i]];
+            } else {
+                scenario.goal[i] = (double)xgoal[goal_vars[i]];
+            }
+        }
+    }
+
+    scenario.allowed_planning_time = default_planning_time;
+    if (xscen.hasMember("allowed_planning_time")) {
+        scenario.allowed_planning_time = (double)xscen["allowed_planning_time"];
+    }
+
+    return true;
+}
+
+bool ReadRobotModelConfig(const ros::NodeHandle& nh, RobotModelConfig& config)
+{
+    if (!nh.getParam("group_name", config.group_name)) {
+        ROS_ERROR("Failed to read 'group_name' from the param server");
+        return false;
+    }
+
+    std::string planning_joint_list;
+    if (!nh.getParam("planning_joints", planning_joint_list)) {
+        ROS_ERROR("Failed to read 'planning_joints' from the param server");
+        return false;
+    }
+
+    std::stringstream joint_name_stream(planning_joint_list);
+    while (joint_name_stream.good() && !joint_name_stream.eof()) {
+        std::string jname;
+        joint_name_stream >> jname;
+        if (jname.empty()) {
+            continue;
+        }
+        config.planning_joints.push_back(jname);
+    }
+
+    nh.getParam("kinematics_frame", config.kinematics_frame);
+    nh.getParam("chain_tip_link", config.chain_tip_link);
+    return true;
+}
+
+bool ReadPlanningParams(const ros::NodeHandle& nh, smpl::PlanningParams& params)
+{
+    std::string discretization;
+    std::string mprim_filename;
+    bool use_xyz_snap_mprim;
+    bool use_rpy_snap_mprim;
+    bool use_xyzrpy_snap_mprim;
+    bool use_short_dist_mprims;
+    double xyz_snap_dist_thresh;
+    double rpy_snap_dist_thresh;
+    double xyzrpy_snap_dist_thresh;
+    double short_dist_mprims_thresh;
+
+    if (!nh.getParam("discretization", discretization) ||
+        !nh.getParam("mprim_filename", mprim_filename) ||
+        !nh.getParam("use_xyz_snap_mprim", use_xyz_snap_mprim) ||
+        !nh.getParam("use_rpy_snap_mprim", use_rpy_snap_mprim) ||
+        !nh.getParam("use_xyzrpy_snap_mprim", use_xyzrpy_snap_mprim) ||
+        !nh.getParam("use_short_dist_mprims", use_short_dist_mprims) ||
+        !nh.getParam("xyz_snap_dist_thresh", xyz_snap_dist_thresh) ||
+        !nh.getParam("rpy_snap_dist_thresh", rpy_snap_dist_thresh) ||
+        !nh.getParam("xyzrpy_snap_dist_thresh", xyzrpy_snap_dist_thresh) ||
+        !nh.getParam("short_dist_mprims_thresh", short_dist_mprims_thresh))
+    {
+        ROS_ERROR("Failed to read planner config from the param server");
+        return false;
+    }
+
+    params.addParam("discretization", discretization);
+    params.addParam("mprim_filename", mprim_filename);
+    params.addParam("use_xyz_snap_mprim", use_xyz_snap_mprim);
+    params.addParam("use_rpy_snap_mprim", use_rpy_snap_mprim);
+    params.addParam("use_xyzrpy_snap_mprim", use_xyzrpy_snap_mprim);
+    params.addParam("use_short_dist_mprims", use_short_dist_mprims);
+    params.addParam("xyz_snap_dist_thresh", xyz_snap_dist_thresh);
+    params.addParam("rpy_snap_dist_thresh", rpy_snap_dist_thresh);
+    params.addParam("xyzrpy_snap_dist_thresh", xyzrpy_snap_dist_thresh);
+    params.addParam("short_dist_mprims_thresh", short_dist_mprims_thresh);
+    params.addParam("epsilon", 100.0);
+    params.addParam("search_mode", false);
+    params.addParam("allow_partial_solutions", false);
+    params.addParam("target_epsilon", 1.0);
+    params.addParam("delta_epsilon", 1.0);
+    params.addParam("improve_solution", false);
+    params.addParam("bound_expansions", true);
+    params.addParam("repair_time", 1.0);
+    params.addParam("bfs_inflation_radius", 0.02);
+    params.addParam("bfs_cost_per_cell", 100);
+    return true;
+}
+
+// A fully isolated planning pipeline: robot model, occupancy grid, collision
+// space, scene, and planner interface. Workers never share mutable state, so
+// trials on different workers may run concurrently.
+struct Worker
+{
+    std::unique_ptr<smpl::KDLRobotModel> rm;
+    std::shared_ptr<smpl::EuclidDistanceMap> df;
+    std::unique_ptr<smpl::OccupancyGrid> grid;
+    std::unique_ptr<CollisionSpaceScene> scene;
+    std::unique_ptr<smpl::collision::CollisionSpace> cc;
+    std::unique_ptr<smpl::PlannerInterface> planner;
+
+    bool init(const SuiteConfig& config);
+    bool runTrial(const SuiteConfig& config, const Scenario& scenario, TrialResult& result);
+};
+
+bool Worker::init(const SuiteConfig& config)
+{
+    if (config.robot_config.kinematics_frame.empty() ||
+        config.robot_config.chain_tip_link.empty())
+    {
+        ROS_ERROR("Robot model config is missing 'kinematics_frame' or 'chain_tip_link'");
+        return false;
+    }
+
+    rm.reset(new smpl::KDLRobotModel);
+    if (!rm->init(
+            config.robot_description,
+            config.robot_config.kinematics_frame,
+            config.robot_config.chain_tip_link))
+    {
+        ROS_ERROR("Failed to initialize robot model");
+        return false;
+    }
+
+    auto df_size_x = 3.0;
+    auto df_size_y = 3.0;
+    auto df_size_z = 3.0;
+    auto df_res = 0.02;
+    auto df_origin_x = -0.75;
+    auto df_origin_y = -1.5;
+    auto df_origin_z = 0.0;
+    auto max_distance = 1.8;
+
+    df = std::make_shared<smpl::EuclidDistanceMap>(
+            df_origin_x, df_origin_y, df_origin_z,
+            df_size_x, df_size_y, df_size_z,
+            df_res,
+            max_distance);
+
+    auto ref_counted = false;
+    grid.reset(new smpl::OccupancyGrid(df, ref_counted));
+    grid->setReferenceFrame(config.planning_frame);
+
+    scene.reset(new CollisionSpaceScene);
+
+    cc.reset(new smpl::collision::CollisionSpace);
+    if (!cc->init(
+            grid.get(),
+            config.robot_description,
+            config.cc_conf,
+            config.robot_config.group_name,
+            config.robot_config.planning_joints))
+    {
+        ROS_ERROR("Failed to initialize collision space");
+        return false;
+    }
+
+    if (cc->robotCollisionModel()->name() == "pr2") {
+        smpl::collision::AllowedCollisionMatrix acm;
+        for (auto& pair : PR2AllowedCollisionPairs) {
+            acm.setEntry(pair.first, pair.second, true);
+        }
+        cc->setAllowedCollisionMatrix(acm);
+    }
+
+    scene->SetCollisionSpace(cc.get());
+
+    if (!config.object_filename.empty()) {
+        auto objects = GetCollisionObjects(
+                config.object_filename, config.planning_frame);
+        for (auto& object : objects) {
+            scene->ProcessCollisionObjectMsg(object);
+        }
+    }
+
+    cc->setWorldToModelTransform(Eigen::Affine3d::Identity());
+
+    planner.reset(new smpl::PlannerInterface(rm.get(), cc.get(), grid.get()));
+    if (!planner->init(config.params)) {
+        ROS_ERROR("Failed to initialize planner interface");
+        return false;
+    }
+
+    return true;
+}
+
+bool Worker::runTrial(
+    const SuiteConfig& config,
+    const Scenario& scenario,
+    TrialResult& result)
+{
+    // seed the reference state of the robot model and the collision model
+    // with the scenario start state
+    smpl::urdf::RobotState reference_state;
+    InitRobotState(&reference_state, &rm->m_robot_model);
+    for (size_t i = 0; i < scenario.start_state.joint_state.name.size(); ++i) {
+        auto* var = GetVariable(
+                &rm->m_robot_model, &scenario.start_state.joint_state.name[i]);
+        if (var == NULL) {
+            continue;
+        }
+        SetVariablePosition(
+                &reference_state,
+                var,
+                scenario.start_state.joint_state.position[i]);
+    }
+    SetReferenceState(rm.get(), GetVariablePositions(&reference_state));
+
+    if (!scene->SetRobotState(scenario.start_state)) {
+        ROS_ERROR("Failed to set start state on collision space scene");
+        return false;
+    }
+
+    moveit_msgs::MotionPlanRequest req;
+    moveit_msgs::MotionPlanResponse res;
+
+    req.allowed_planning_time = scenario.allowed_planning_time;
+    req.goal_constraints.resize(1);
+    FillGoalConstraint(scenario.goal, config.planning_frame, req.goal_constraints[0]);
+    req.group_name = config.robot_config.group_name;
+    req.max_acceleration_scaling_factor = 1.0;
+    req.max_velocity_scaling_factor = 1.0;
+    req.num_planning_attempts = 1;
+    req.planner_id = config.planner_id;
+    req.start_state = scenario.start_state;
+
+    moveit_msgs::PlanningScene planning_scene;
+    planning_scene.robot_state = scenario.start_state;
+
+    planner->stats().clear();
+
+    auto before = std::chrono::high_resolution_clock::now();
+    result.success = planner->solve(planning_scene, req, res);
+    auto after = std::chrono::high_resolution_clock::now();
+
+    result.wall_time = std::chrono::duration<double>(after - before).count();
+    result.stats = planner->getPlannerStats();
+    planner->stats().snapshot(result.events);
+    return true;
+}
+
+// Write one row per trial with the union of statistics reported by the
+// planner across all trials; trials missing a statistic leave the field
+// empty.
+void WriteTrialsCsv(
+    const std::string& path,
+    const std::vector<TrialResult>& results)
+{
+    std::set<std::string> stat_keys;
+    for (const TrialResult& r : results) {
+        for (const auto& entry : r.stats) {
+            stat_keys.insert(entry.first);
+        }
+    }
+
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == NULL) {
+        ROS_ERROR("Failed to open '%s' for writing", path.c_str());
+        return;
+    }
+
+    fprintf(f, "scenario,trial,success,wall_time");
+    for (const std::string& key : stat_keys) {
+        fprintf(f, ",%s", key.c_str());
+    }
+    fprintf(f, "\n");
+
+    for (const TrialResult& r : results) {
+        fprintf(f, "%s,%d,%d,%f",
+                r.scenario.c_str(), r.trial, (int)r.success, r.wall_time);
+        for (const std::string& key : stat_keys) {
+            auto it = r.stats.find(key);
+            if (it != r.stats.end()) {
+                fprintf(f, ",%f", it->second);
+            } else {
+                fprintf(f, ",");
+            }
+        }
+        fprintf(f, "\n");
+    }
+
+    fclose(f);
+}
+
+// Write one row per search iteration event recorded during each trial: the
+// time the iteration finished, the epsilon it satisfied, and the cumulative
+// expansion count, forming the cost/bound trajectory of the trial.
+void WriteIterationsCsv(
+    const std::string& path,
+    const std::vector<TrialResult>& results)
+{
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == NULL) {
+        ROS_ERROR("Failed to open '%s' for writing", path.c_str());
+        return;
+    }
+
+    fprintf(f, "scenario,trial,time,epsilon,expansions\n");
+    for (const TrialResult& r : results) {
+        for (const smpl::StatEvent& e : r.events) {
+            if (e.kind != smpl::STAT_EVENT_SEARCH_ITER) {
+                continue;
+            }
+            fprintf(f, "%s,%d,%f,%f,%u\n",
+                    r.scenario.c_str(), r.trial, e.time, e.value, e.count);
+        }
+    }
+
+    fclose(f);
+}
+
+int main(int argc, char* argv[])
+{
+    ros::init(argc, argv, "scenario_suite");
+    ros::NodeHandle nh;
+    ros::NodeHandle ph("~");
+
+    SuiteConfig config;
+
+    auto robot_description_key = "robot_description";
+    std::string robot_description_param;
+    if (!nh.searchParam(robot_description_key, robot_description_param)) {
+        ROS_ERROR("Failed to find 'robot_description' key on the param server");
+        return 1;
+    }
+
+    if (!nh.getParam(robot_description_param, config.robot_description)) {
+        ROS_ERROR("Failed to retrieve param 'robot_description' from the param server");
+        return 1;
+    }
+
+    if (!ReadRobotModelConfig(ros::NodeHandle("~robot_model"), config.robot_config)) {
+        ROS_ERROR("Failed to read robot model config from param server");
+        return 1;
+    }
+
+    if (!ph.getParam("planning_frame", config.planning_frame)) {
+        ROS_ERROR("Failed to retrieve param 'planning_frame' from the param server");
+        return 1;
+    }
+
+    if (!smpl::collision::CollisionModelConfig::Load(ph, config.cc_conf)) {
+        ROS_ERROR("Failed to load Collision Model Config");
+        return 1;
+    }
+
+    if (!ReadPlanningParams(ros::NodeHandle("~planning"), config.params)) {
+        ROS_ERROR("Failed to read planner config");
+        return 1;
+    }
+
+    ph.param<std::string>("object_filename", config.object_filename, "");
+    ph.param<std::string>("planner_id", config.planner_id, "arastar.bfs.manip");
+
+    double default_planning_time;
+    ph.param("allowed_planning_time", default_planning_time, 10.0);
+
+    int trials;
+    ph.param("trials", trials, 1);
+
+    int workers;
+    ph.param("workers", workers, 1);
+    if (workers <= 0) {
+        workers = (int)std::thread::hardware_concurrency();
+        if (workers <= 0) {
+            workers = 1;
+        }
+    }
+
+    std::string output;
+    ph.param<std::string>("output", output, "scenario_suite");
+
+    ///////////////////
+    // Load Scenarios //
+    ///////////////////
+
+    XmlRpc::XmlRpcValue xsuite;
+    if (!ph.getParam("suite", xsuite) ||
+        xsuite.getType() != XmlRpc::XmlRpcValue::TypeStruct)
+    {
+        ROS_ERROR("Failed to retrieve scenario map from param '~suite'");
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    for (auto it = xsuite.begin(); it != xsuite.end(); ++it) {
+        Scenario scenario;
+        if (!ReadScenario(it->first, it->second, default_planning_time, scenario)) {
+            return 1;
+        }
+        scenarios.push_back(std::move(scenario));
+    }
+
+    ROS_INFO("Run %d trials for each of %zu scenarios across %d workers",
+            trials, scenarios.size(), workers);
+
+    /////////////////
+    // Run Trials //
+    /////////////////
+
+    const int trial_count = (int)scenarios.size() * trials;
+    std::vector<TrialResult> results(trial_count);
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+
+    auto work = [&]() {
+        Worker worker;
+        if (!worker.init(config)) {
+            failed.store(true);
+            return;
+        }
+
+        while (!failed.load()) {
+            const int i = next.fetch_add(1);
+            if (i >= trial_count) {
+                break;
+            }
+
+            const Scenario& scenario = scenarios[i / trials];
+            TrialResult& result = results[i];
+            result.scenario = scenario.name;
+            result.trial = i % trials;
+
+            ROS_INFO("Run scenario '%s' trial %d", scenario.name.c_str(), result.trial);
+            if (!worker.runTrial(config, scenario, result)) {
+                failed.store(true);
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < workers; ++i) {
+        threads.emplace_back(work);
+    }
+    work();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (failed.load()) {
+        ROS_ERROR("Suite aborted");
+        return 1;
+    }
+
+    /////////////////////
+    // Write Results //
+    /////////////////////
+
+    WriteTrialsCsv(output + "_trials.csv", results);
+    WriteIterationsCsv(output + "_iterations.csv", results);
+
+    int successes = 0;
+    for (const TrialResult& r : results) {
+        if (r.success) {
+            ++successes;
+        }
+    }
+    ROS_INFO("%d/%d trials succeeded; results written to %s_trials.csv and %s_iterations.csv",
+            successes, trial_count, output.c_str(), output.c_str());
+
+    return 0;
+}
@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2016, Andrew Dornbush
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     1. Redistributions of source code must retain the above copyright notice
+//        this list of conditions and the following disclaimer.
+//     2. Redistributions in binary form must reproduce the above copyright
+//        notice, this list of conditions and the following disclaimer in the
+//        documentation and/or other materials provided with the distribution.
+//     3. Neither the name of the copyright holder nor the names of its
+//        contributors may be used to endorse or promote products derived from
+//        this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+////////////////////////////////////////////////////////////////////////////////
+
+// Timed microbenchmarks for the library's proven hot paths, on synthetic
+// workloads with fixed seeds so that runs are repeatable across machines and
+// releases. Results are printed as CSV (benchmark,size,iterations,total_ms,
+// per_iter_us) for consumption by regression-tracking scripts; pass a file
+// name to redirect the CSV while keeping diagnostics on stderr.
+//
+// Covered here are the hot paths reachable from the core smpl library alone:
+// OPEN list operations, BFS_3D wavefronts, distance map propagation,
+// occupancy grid region queries, and path interpolation against a synthetic
+// collision checker. Graph successor generation and sphere collision checks
+// require a robot model and collision model; those are exercised end-to-end
+// by the planning drivers in this package.
+
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <smpl/bfs3d/bfs3d.h>
+#include <smpl/collision_checker.h>
+#include <smpl/distance_map/euclid_distance_map.h>
+#include <smpl/heap/intrusive_heap.h>
+#include <smpl/occupancy_grid.h>
+#include <smpl/post_processing.h>
+
+namespace {
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+const unsigned kSeed = 0xB35Cu;
+
+FILE* g_out = stdout;
+
+double to_ms(bench_clock::duration d)
+{
+    return std::chrono::duration<double, std::milli>(d).count();
+}
+
+void Report(const char* name, size_t size, size_t iters, double total_ms)
+{
+    fprintf(g_out, "%s,%zu,%zu,%0.3f,%0.3f\n",
+            name, size, iters, total_ms, 1000.0 * total_ms / (double)iters);
+}
+
+////////////////////
+// OPEN list ops  //
+////////////////////
+
+struct HeapElement : smpl::heap_element
+{
+    int priority;
+};
+
+struct HeapElementCompare
+{
+    bool operator()(const HeapElement& a, const HeapElement& b) const {
+        return a.priority < b.priority;
+    }
+};
+
+void BenchHeap(size_t count)
+{
+    std::default_random_engine rng(kSeed);
+    std::uniform_int_distribution<int> prio(0, 1 << 20);
+
+    std::vector<HeapElement> elements(count);
+    for (auto& e : elements) {
+        e.priority = prio(rng);
+    }
+
+    smpl::intrusive_heap<HeapElement, HeapElementCompare> h;
+
+    auto start = bench_clock::now();
+    for (auto& e : elements) {
+        h.push(&e);
+    }
+    Report("heap_push", count, count, to_ms(bench_clock::now() - start));
+
+    std::uniform_int_distribution<int> pick(0, (int)count - 1);
+    start = bench_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        auto& e = elements[pick(rng)];
+        if (e.priority > 0) {
+            e.priority /= 2;
+            h.decrease(&e);
+        }
+    }
+    Report("heap_decrease", count, count, to_ms(bench_clock::now() - start));
+
+    start = bench_clock::now();
+    while (!h.empty()) {
+        h.pop();
+    }
+    Report("heap_pop", count, count, to_ms(bench_clock::now() - start));
+}
+
+////////////////////////
+// BFS_3D wavefronts  //
+////////////////////////
+
+void BenchBFS(int dim)
+{
+    std::default_random_engine rng(kSeed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    smpl::BFS_3D bfs(dim, dim, dim);
+
+    // ~10% scattered walls; the center cell stays free as the source
+    for (int x = 0; x < dim; ++x) {
+    for (int y = 0; y < dim; ++y) {
+    for (int z = 0; z < dim; ++z) {
+        if (coin(rng) < 0.1 && !(x == dim / 2 && y == dim / 2 && z == dim / 2)) {
+            bfs.setWall(x, y, z);
+        }
+    }
+    }
+    }
+
+    const size_t cells = (size_t)dim * dim * dim;
+    auto start = bench_clock::now();
+    bfs.run(dim / 2, dim / 2, dim / 2);
+    // getDistance() waits on the wavefront, so sample the far corner to time
+    // the full flood
+    bfs.getDistance(0, 0, 0);
+    bfs.getDistance(dim - 1, dim - 1, dim - 1);
+    Report("bfs3d_run", cells, cells, to_ms(bench_clock::now() - start));
+
+    std::uniform_int_distribution<int> cell(0, dim - 1);
+    const size_t num_queries = 1000000;
+    volatile int sink = 0;
+    start = bench_clock::now();
+    for (size_t i = 0; i < num_queries; ++i) {
+        sink = bfs.getDistance(cell(rng), cell(rng), cell(rng));
+    }
+    (void)sink;
+    Report("bfs3d_query", cells, num_queries, to_ms(bench_clock::now() - start));
+}
+
+//////////////////////////////////
+// distance map propagation     //
+//////////////////////////////////
+
+void BenchDistanceMap(size_t num_points)
+{
+    std::default_random_engine rng(kSeed);
+    std::uniform_real_distribution<double> pos(0.05, 1.95);
+
+    smpl::EuclidDistanceMap dmap(0.0, 0.0, 0.0, 2.0, 2.0, 2.0, 0.02, 0.2);
+
+    std::vector<smpl::Vector3> points(num_points);
+    for (auto& p : points) {
+        p = smpl::Vector3(pos(rng), pos(rng), pos(rng));
+    }
+
+    auto start = bench_clock::now();
+    dmap.addPointsToMap(points);
+    Report("dmap_add", num_points, num_points,
+            to_ms(bench_clock::now() - start));
+
+    std::vector<smpl::Vector3> removed(
+            points.begin(), points.begin() + points.size() / 2);
+    start = bench_clock::now();
+    dmap.removePointsFromMap(removed);
+    Report("dmap_remove", num_points, removed.size(),
+            to_ms(bench_clock::now() - start));
+}
+
+//////////////////////////////////
+// occupancy grid region probes //
+//////////////////////////////////
+
+void BenchGridRegionQueries(size_t num_queries)
+{
+    std::default_random_engine rng(kSeed);
+    std::uniform_real_distribution<double> pos(0.05, 1.95);
+
+    smpl::OccupancyGrid grid(2.0, 2.0, 2.0, 0.02, 0.0, 0.0, 0.0, 0.2);
+
+    std::vector<smpl::Vector3> points(5000);
+    for (auto& p : points) {
+        p = smpl::Vector3(pos(rng), pos(rng), pos(rng));
+    }
+    grid.addPointsToField(points);
+
+    std::uniform_int_distribution<int> cell(0, grid.numCellsX() - 9);
+    volatile bool sink = false;
+
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < num_queries; ++i) {
+        const int x = cell(rng), y = cell(rng), z = cell(rng);
+        sink = grid.isRegionFree(x, y, z, x + 7, y + 7, z + 7);
+    }
+    Report("grid_region_dense", 8, num_queries,
+            to_ms(bench_clock::now() - start));
+
+    grid.enableOccupancyPyramid(true);
+    start = bench_clock::now();
+    for (size_t i = 0; i < num_queries; ++i) {
+        const int x = cell(rng), y = cell(rng), z = cell(rng);
+        sink = grid.isRegionFree(x, y, z, x + 7, y + 7, z + 7);
+    }
+    (void)sink;
+    Report("grid_region_pyramid", 8, num_queries,
+            to_ms(bench_clock::now() - start));
+}
+
+//////////////////////////
+// path interpolation   //
+//////////////////////////
+
+// joint-space collision checker stub: every state is valid and paths
+// interpolate linearly at a fixed resolution, so the benchmark times the
+// interpolation machinery rather than any collision model
+class LerpCollisionChecker : public smpl::CollisionChecker
+{
+public:
+
+    bool isStateValid(const smpl::RobotState& state, bool verbose) override
+    {
+        return true;
+    }
+
+    bool isStateToStateValid(
+        const smpl::RobotState& start,
+        const smpl::RobotState& finish,
+        bool verbose) override
+    {
+        return true;
+    }
+
+    bool interpolatePath(
+        const smpl::RobotState& start,
+        const smpl::RobotState& finish,
+        std::vector<smpl::RobotState>& path) override
+    {
+        const double res = 0.02;
+        double max_diff = 0.0;
+        for (size_t v = 0; v < start.size(); ++v) {
+            max_diff = std::max(max_diff, fabs(finish[v] - start[v]));
+        }
+        const int num_waypoints = std::max(2, (int)ceil(max_diff / res) + 1);
+
+        path.resize(num_waypoints);
+        for (int i = 0; i < num_waypoints; ++i) {
+            const double a = (double)i / (double)(num_waypoints - 1);
+            auto& wp = path[i];
+            wp.resize(start.size());
+            for (size_t v = 0; v < start.size(); ++v) {
+                wp[v] = start[v] + a * (finish[v] - start[v]);
+            }
+        }
+        return true;
+    }
+
+    smpl::Extension* getExtension(size_t class_code) override
+    {
+        if (class_code == smpl::GetClassCode<smpl::CollisionChecker>()) {
+            return this;
+        }
+        return nullptr;
+    }
+};
+
+void BenchInterpolatePath(size_t num_waypoints)
+{
+    const size_t num_joints = 7;
+
+    std::default_random_engine rng(kSeed);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+
+    std::vector<smpl::RobotState> path(num_waypoints);
+    for (auto& wp : path) {
+        wp.resize(num_joints);
+        for (auto& v : wp) {
+            v = angle(rng);
+        }
+    }
+
+    LerpCollisionChecker cc;
+
+    const size_t num_iters = 100;
+    auto start = bench_clock::now();
+    for (size_t i = 0; i < num_iters; ++i) {
+        smpl::PathMatrix opath;
+        smpl::InterpolatePath(cc, path, opath);
+    }
+    Report("interpolate_path", num_waypoints, num_iters,
+            to_ms(bench_clock::now() - start));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1) {
+        g_out = fopen(argv[1], "w");
+        if (!g_out) {
+            fprintf(stderr, "Failed to open '%s' for writing\n", argv[1]);
+            return 1;
+        }
+    }
+
+    fprintf(g_out, "benchmark,size,iterations,total_ms,per_iter_us\n");
+
+    BenchHeap(1000000);
+    BenchBFS(128);
+    BenchDistanceMap(20000);
+    BenchGridRegionQueries(1000000);
+    BenchInterpolatePath(50);
+
+    if (g_out != stdout) {
+        fclose(g_out);
+    }
+    return 0;
+}
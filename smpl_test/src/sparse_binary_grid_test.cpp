@@ -304,4 +304,64 @@ BOOST_AUTO_TEST_CASE(ResizeTest)
     BOOST_CHECK_EQUAL(g.max_depth(), 2);
 }
 
+/// Repeated queries within the same region must remain consistent once the
+/// region's block has been materialized in the query cache
+BOOST_AUTO_TEST_CASE(CachedQueryTest)
+{
+    smpl::SparseBinaryGrid<> g(false);
+
+    g.set(1, 2, 3, true);
+
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK_EQUAL(g.get(1, 2, 3), true);
+        BOOST_CHECK_EQUAL(g.get(3, 2, 1), false);
+    }
+}
+
+/// Modifications after a query must be visible through the query cache
+BOOST_AUTO_TEST_CASE(CacheWriteThroughTest)
+{
+    smpl::SparseBinaryGrid<> g(false);
+
+    BOOST_CHECK_EQUAL(g.get(4, 4, 4), false);
+
+    g.set(4, 4, 4, true);
+    BOOST_CHECK_EQUAL(g.get(4, 4, 4), true);
+
+    g.set_lazy(4, 4, 4, false);
+    BOOST_CHECK_EQUAL(g.get(4, 4, 4), false);
+
+    // writes through the unpacked reference bypass set() and must still be
+    // observed by later queries
+    BOOST_CHECK_EQUAL(g.get(5, 5, 5), false);
+    g(5, 5, 5) = true;
+    BOOST_CHECK_EQUAL(g.get(5, 5, 5), true);
+
+    g.reset(true);
+    BOOST_CHECK_EQUAL(g.get(4, 4, 4), true);
+}
+
+/// Query many distinct regions to force lru eviction, then re-check values
+BOOST_AUTO_TEST_CASE(CacheEvictionTest)
+{
+    smpl::SparseBinaryGrid<> g(false);
+
+    // one marked cell per 16^3 voxel region, spanning more regions than the
+    // cache retains
+    const int regions = 80;
+    for (int i = 0; i < regions; ++i) {
+        g.set(16 * i, 8, 8, true);
+    }
+
+    for (int i = 0; i < regions; ++i) {
+        BOOST_CHECK_EQUAL(g.get(16 * i, 8, 8), true);
+        BOOST_CHECK_EQUAL(g.get(16 * i + 1, 8, 8), false);
+    }
+
+    g.clear_query_cache();
+    for (int i = 0; i < regions; ++i) {
+        BOOST_CHECK_EQUAL(g.get(16 * i, 8, 8), true);
+    }
+}
+
 // TODO: Test throwing constructor/destructor
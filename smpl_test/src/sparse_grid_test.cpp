@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
 #include <Eigen/Dense>
 #define BOOST_TEST_MODULE OcTreeTest
@@ -355,4 +357,118 @@ BOOST_AUTO_TEST_CASE(ResizeTest)
     BOOST_CHECK_EQUAL(g.max_depth(), 3);
 }
 
+BOOST_AUTO_TEST_CASE(GetLeafTest)
+{
+    smpl::SparseGrid<int> g(8, 8, 8, 0);
+
+    int xfirst, yfirst, zfirst, xlast, ylast, zlast;
+
+    // a fully-pruned grid resolves every cell to the root leaf
+    BOOST_CHECK_EQUAL(g.get_leaf(3, 3, 3, xfirst, yfirst, zfirst, xlast, ylast, zlast), 0);
+    BOOST_CHECK_EQUAL(xfirst, 0);
+    BOOST_CHECK_EQUAL(yfirst, 0);
+    BOOST_CHECK_EQUAL(zfirst, 0);
+    BOOST_CHECK_EQUAL(xlast, 8);
+    BOOST_CHECK_EQUAL(ylast, 8);
+    BOOST_CHECK_EQUAL(zlast, 8);
+
+    g.set(7, 7, 7, 1);
+
+    // the modified cell resolves to a single-cell leaf
+    BOOST_CHECK_EQUAL(g.get_leaf(7, 7, 7, xfirst, yfirst, zfirst, xlast, ylast, zlast), 1);
+    BOOST_CHECK_EQUAL(xfirst, 7);
+    BOOST_CHECK_EQUAL(yfirst, 7);
+    BOOST_CHECK_EQUAL(zfirst, 7);
+    BOOST_CHECK_EQUAL(xlast, 8);
+    BOOST_CHECK_EQUAL(ylast, 8);
+    BOOST_CHECK_EQUAL(zlast, 8);
+
+    // cells in an untouched subtree resolve to a pruned interior leaf
+    BOOST_CHECK_EQUAL(g.get_leaf(1, 2, 3, xfirst, yfirst, zfirst, xlast, ylast, zlast), 0);
+    BOOST_CHECK_EQUAL(xfirst, 0);
+    BOOST_CHECK_EQUAL(yfirst, 0);
+    BOOST_CHECK_EQUAL(zfirst, 0);
+    BOOST_CHECK_EQUAL(xlast, 4);
+    BOOST_CHECK_EQUAL(ylast, 4);
+    BOOST_CHECK_EQUAL(zlast, 4);
+}
+
+BOOST_AUTO_TEST_CASE(UniqueCursorTest)
+{
+    smpl::SparseGrid<int> g(8, 8, 8, 0);
+    smpl::SparseGrid<int> expect(8, 8, 8, 0);
+
+    auto cursor = g.make_unique_cursor();
+    int val = 1;
+    for (int x = 0; x < 8; x += 2) {
+    for (int y = 0; y < 8; y += 3) {
+    for (int z = 7; z >= 0; z -= 2) {
+        cursor(x, y, z) = val;
+        expect(x, y, z) = val;
+        ++val;
+    }
+    }
+    }
+
+    for (int x = 0; x < 8; ++x) {
+    for (int y = 0; y < 8; ++y) {
+    for (int z = 0; z < 8; ++z) {
+        BOOST_CHECK_EQUAL(g.get(x, y, z), expect.get(x, y, z));
+    }
+    }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AssignSortedTest)
+{
+    struct Cell { int x, y, z; };
+
+    auto morton_less = [](const Cell& a, const Cell& b)
+    {
+        for (int b_ = 15; b_ >= 0; --b_) {
+            int ca = ((a.x >> b_) & 1) << 2 | ((a.y >> b_) & 1) << 1 | ((a.z >> b_) & 1);
+            int cb = ((b.x >> b_) & 1) << 2 | ((b.y >> b_) & 1) << 1 | ((b.z >> b_) & 1);
+            if (ca != cb) {
+                return ca < cb;
+            }
+        }
+        return false;
+    };
+
+    // a solid 4^3 block plus scattered cells
+    std::vector<Cell> cells;
+    for (int x = 0; x < 4; ++x) {
+    for (int y = 0; y < 4; ++y) {
+    for (int z = 0; z < 4; ++z) {
+        cells.push_back({ x, y, z });
+    }
+    }
+    }
+    cells.push_back({ 7, 0, 3 });
+    cells.push_back({ 5, 6, 7 });
+    cells.push_back({ 0, 7, 7 });
+    std::sort(cells.begin(), cells.end(), morton_less);
+
+    smpl::SparseGrid<int> g(8, 8, 8, 0);
+    g.assign_sorted(cells.begin(), cells.end(), 0, 1);
+
+    smpl::SparseGrid<int> expect(8, 8, 8, 0);
+    for (const Cell& c : cells) {
+        expect.set(c.x, c.y, c.z, 1);
+    }
+
+    for (int x = 0; x < 8; ++x) {
+    for (int y = 0; y < 8; ++y) {
+    for (int z = 0; z < 8; ++z) {
+        BOOST_CHECK_EQUAL(g.get(x, y, z), expect.get(x, y, z));
+    }
+    }
+    }
+
+    // the covered octant is represented by a single leaf and the result is as
+    // compressed as an incrementally built and pruned tree
+    BOOST_CHECK_EQUAL(g.tree().num_nodes(), expect.tree().num_nodes());
+    BOOST_CHECK_EQUAL(g.tree().num_leaves(), expect.tree().num_leaves());
+}
+
 // TODO: Test throwing constructor/destructor
@@ -0,0 +1,62 @@
+#ifndef SMPL_URDF_ROBOT_MODEL_ROBOT_MODEL_IO_H
+#define SMPL_URDF_ROBOT_MODEL_ROBOT_MODEL_IO_H
+
+// standard includes
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// project includes
+#include <smpl_urdf_robot_model/robot_model.h>
+
+namespace smpl {
+namespace urdf {
+
+// Serialize a constructed RobotModel to a flat binary file. All internal
+// references are stored as array indices so the model may be reconstructed
+// without re-parsing the URDF it came from.
+bool SaveRobotModel(const RobotModel* model, const std::string& path);
+
+// Reconstruct a RobotModel from a file written by SaveRobotModel. Returns
+// false if the file does not exist, was written by an incompatible version,
+// or is malformed, in which case the caller should fall back to
+// InitRobotModel.
+bool LoadRobotModel(RobotModel* model, const std::string& path);
+
+// Fingerprint of the inputs to InitRobotModel: the URDF description text,
+// the world joint specification, and the safety limits flag. Models built
+// from equal inputs receive equal keys.
+auto HashRobotModelInputs(
+    const std::string& urdf_string,
+    const JointSpec* world_joint = NULL,
+    bool use_safety_limits = true)
+    -> uint64_t;
+
+// The path of the cache entry for a given input fingerprint.
+auto GetCachedRobotModelPath(const std::string& cache_dir, uint64_t key)
+    -> std::string;
+
+// Attempt to load the cached model built from the given inputs. Returns
+// false, without complaint, when no cache entry exists; the caller should
+// then parse the URDF, build the model with InitRobotModel, and store it
+// with StoreCachedRobotModel.
+bool LoadCachedRobotModel(
+    RobotModel* model,
+    const std::string& cache_dir,
+    const std::string& urdf_string,
+    const JointSpec* world_joint = NULL,
+    bool use_safety_limits = true);
+
+// Store a constructed model as the cache entry for the inputs it was built
+// from. The cache directory is created if it does not exist.
+bool StoreCachedRobotModel(
+    const RobotModel* model,
+    const std::string& cache_dir,
+    const std::string& urdf_string,
+    const JointSpec* world_joint = NULL,
+    bool use_safety_limits = true);
+
+} // namespace urdf
+} // namespace smpl
+
+#endif
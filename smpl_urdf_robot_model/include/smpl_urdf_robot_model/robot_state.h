@@ -35,6 +35,23 @@ auto GetRobotModel(const RobotState* state) -> const RobotModel*;
 void SetToDefaultValues(RobotState* state);
 
 void SetVariablePositions(RobotState* state, const double* positions);
+
+// Set the positions of the first count variables in one pass, folding the
+// dirty bookkeeping of all changed variables into a single invalidation step
+// rather than paying it per variable.
+void SetVariablePositions(
+    RobotState* state,
+    const double* positions,
+    int count);
+
+// As above, but positions[i] addresses the variable at indices[i], for
+// callers that update a scattered subset such as a planning group.
+void SetVariablePositions(
+    RobotState* state,
+    const int* indices,
+    const double* positions,
+    int count);
+
 void SetVariablePosition(RobotState* state, const JointVariable* variable, double position);
 void SetVariablePosition(RobotState* state, int index, double position);
 
@@ -166,6 +183,13 @@ struct RobotState
     const Joint*            dirty_collisions_joint = NULL;
     const Joint*            dirty_visuals_joint = NULL;
 
+    // precise dirty set: one flag byte per joint with one bit per transform
+    // channel (links/collisions/visuals) and the roots of the dirtied
+    // subtrees; the dirty_*_joint members above remain the common roots of
+    // this set and back the conservative per-body dirtiness queries
+    std::vector<const Joint*>   dirty_joints;
+    std::vector<unsigned char>  joint_dirty;
+
     // self-references => non-copyable
     RobotState() = default;
     RobotState(const RobotState&) = delete;
@@ -38,6 +38,11 @@ struct URDFRobotModel :
     auto computeFK(const smpl::RobotState& state)
         -> Eigen::Affine3d override;
 
+    void computeFKBatch(
+        const std::vector<smpl::RobotState>& states,
+        std::vector<Eigen::Affine3d, Eigen::aligned_allocator<Eigen::Affine3d>>& poses)
+        override;
+
     double minPosLimit(int jidx) const override;
     double maxPosLimit(int jidx) const override;
     bool hasPosLimit(int jidx) const override;
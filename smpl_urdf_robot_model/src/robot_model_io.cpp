@@ -0,0 +1,571 @@
+#include <smpl_urdf_robot_model/robot_model_io.h>
+
+// standard includes
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+// system includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace smpl {
+namespace urdf {
+
+static const char g_model_magic[8] = {
+    'S', 'M', 'P', 'L', 'U', 'R', 'D', 'M'
+};
+
+struct ModelFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t num_links;
+    uint64_t num_joints;
+    uint64_t num_variables;
+    uint64_t num_spheres;
+    uint64_t num_boxes;
+    uint64_t num_cylinders;
+    uint64_t num_meshes;
+    uint64_t num_collisions;
+    uint64_t num_visuals;
+    uint64_t ancestor_map_size;
+    int64_t root_link;
+    int64_t root_joint;
+};
+
+/////////////
+// Writing //
+/////////////
+
+static
+bool WriteRaw(FILE* f, const void* data, size_t size)
+{
+    return fwrite(data, 1, size, f) == size;
+}
+
+static
+bool WriteString(FILE* f, const std::string& s)
+{
+    uint64_t size = s.size();
+    return WriteRaw(f, &size, sizeof(size)) && WriteRaw(f, s.data(), s.size());
+}
+
+static
+bool WriteIndex(FILE* f, int64_t index)
+{
+    return WriteRaw(f, &index, sizeof(index));
+}
+
+static
+bool WritePose(FILE* f, const Affine3& pose)
+{
+    return WriteRaw(f, pose.matrix().data(), 16 * sizeof(double));
+}
+
+// ...pointer-to-index conversions, -1 encodes a null reference
+
+static
+auto LinkIndex(const RobotModel* model, const Link* link) -> int64_t
+{
+    return link != NULL ? link - model->links.data() : -1;
+}
+
+static
+auto JointIndex(const RobotModel* model, const Joint* joint) -> int64_t
+{
+    return joint != NULL ? joint - model->joints.data() : -1;
+}
+
+static
+auto VariableIndex(const RobotModel* model, const JointVariable* v) -> int64_t
+{
+    return v != NULL ? v - model->variables.data() : -1;
+}
+
+// Encode a shape reference as its type and its index within the model's
+// array of shapes of that type.
+static
+bool WriteShapeRef(FILE* f, const RobotModel* model, const Shape* shape)
+{
+    int64_t index;
+    uint32_t type;
+    if (shape == NULL) {
+        type = (uint32_t)-1;
+        index = -1;
+    } else {
+        type = (uint32_t)shape->type;
+        switch (shape->type) {
+        case ShapeType::Sphere:
+            index = static_cast<const Sphere*>(shape) - model->spheres.data();
+            break;
+        case ShapeType::Box:
+            index = static_cast<const Box*>(shape) - model->boxes.data();
+            break;
+        case ShapeType::Cylinder:
+            index = static_cast<const Cylinder*>(shape) - model->cylinders.data();
+            break;
+        case ShapeType::Mesh:
+            index = static_cast<const Mesh*>(shape) - model->meshes.data();
+            break;
+        default:
+            return false;
+        }
+    }
+    return WriteRaw(f, &type, sizeof(type)) && WriteIndex(f, index);
+}
+
+bool SaveRobotModel(const RobotModel* model, const std::string& path)
+{
+    FILE* f = fopen(path.c_str(), "wb");
+    if (f == NULL) {
+        fprintf(stderr, "Failed to open '%s' for writing\n", path.c_str());
+        return false;
+    }
+
+    ModelFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, g_model_magic, sizeof(g_model_magic));
+    header.version = 1;
+    header.num_links = model->links.size();
+    header.num_joints = model->joints.size();
+    header.num_variables = model->variables.size();
+    header.num_spheres = model->spheres.size();
+    header.num_boxes = model->boxes.size();
+    header.num_cylinders = model->cylinders.size();
+    header.num_meshes = model->meshes.size();
+    header.num_collisions = model->collisions.size();
+    header.num_visuals = model->visuals.size();
+    header.ancestor_map_size = model->ancestor_map.size();
+    header.root_link = LinkIndex(model, model->root_link);
+    header.root_joint = JointIndex(model, model->root_joint);
+
+    bool ok = WriteRaw(f, &header, sizeof(header));
+
+    ok = ok && WriteString(f, model->name);
+
+    for (size_t i = 0; ok && i < model->links.size(); ++i) {
+        const Link& link = model->links[i];
+        ok = WriteString(f, link.name) &&
+                WriteIndex(f, JointIndex(model, link.parent)) &&
+                WriteIndex(f, JointIndex(model, link.children)) &&
+                WriteIndex(f, link.visual.p.first - model->visuals.data()) &&
+                WriteIndex(f, link.visual.p.second - link.visual.p.first) &&
+                WriteIndex(f, link.collision.p.first - model->collisions.data()) &&
+                WriteIndex(f, link.collision.p.second - link.collision.p.first);
+    }
+
+    for (size_t i = 0; ok && i < model->joints.size(); ++i) {
+        const Joint& joint = model->joints[i];
+        uint32_t type = (uint32_t)joint.type;
+        ok = WriteString(f, joint.name) &&
+                WriteRaw(f, &type, sizeof(type)) &&
+                WritePose(f, joint.origin) &&
+                WriteRaw(f, joint.axis.data(), 3 * sizeof(double)) &&
+                WriteIndex(f, VariableIndex(model, joint.vfirst)) &&
+                WriteIndex(f, VariableIndex(model, joint.vlast)) &&
+                WriteIndex(f, LinkIndex(model, joint.child)) &&
+                WriteIndex(f, LinkIndex(model, joint.parent)) &&
+                WriteIndex(f, JointIndex(model, joint.sibling));
+    }
+
+    for (size_t i = 0; ok && i < model->variables.size(); ++i) {
+        const JointVariable& v = model->variables[i];
+        uint8_t has_limits = v.limits.has_position_limits ? 1 : 0;
+        ok = WriteString(f, v.name) &&
+                WriteRaw(f, &has_limits, sizeof(has_limits)) &&
+                WriteRaw(f, &v.limits.min_position, sizeof(double)) &&
+                WriteRaw(f, &v.limits.max_position, sizeof(double)) &&
+                WriteRaw(f, &v.limits.max_velocity, sizeof(double)) &&
+                WriteRaw(f, &v.limits.max_effort, sizeof(double)) &&
+                WriteIndex(f, JointIndex(model, v.joint));
+    }
+
+    for (size_t i = 0; ok && i < model->spheres.size(); ++i) {
+        ok = WriteRaw(f, &model->spheres[i].radius, sizeof(double));
+    }
+    for (size_t i = 0; ok && i < model->boxes.size(); ++i) {
+        ok = WriteRaw(f, model->boxes[i].size.data(), 3 * sizeof(double));
+    }
+    for (size_t i = 0; ok && i < model->cylinders.size(); ++i) {
+        ok = WriteRaw(f, &model->cylinders[i].height, sizeof(double)) &&
+                WriteRaw(f, &model->cylinders[i].radius, sizeof(double));
+    }
+    for (size_t i = 0; ok && i < model->meshes.size(); ++i) {
+        ok = WriteString(f, model->meshes[i].filename) &&
+                WriteRaw(f, model->meshes[i].scale.data(), 3 * sizeof(double));
+    }
+
+    for (size_t i = 0; ok && i < model->collisions.size(); ++i) {
+        const LinkCollision& c = model->collisions[i];
+        ok = WritePose(f, c.origin) &&
+                WriteShapeRef(f, model, c.shape) &&
+                WriteIndex(f, LinkIndex(model, c.link));
+    }
+    for (size_t i = 0; ok && i < model->visuals.size(); ++i) {
+        const LinkVisual& v = model->visuals[i];
+        ok = WritePose(f, v.origin) &&
+                WriteShapeRef(f, model, v.shape) &&
+                WriteIndex(f, LinkIndex(model, v.link));
+    }
+
+    for (size_t i = 0; ok && i < model->ancestor_map.size(); ++i) {
+        ok = WriteIndex(f, JointIndex(model, model->ancestor_map[i]));
+    }
+
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Failed to write robot model to '%s'\n", path.c_str());
+        remove(path.c_str());
+    }
+    return ok;
+}
+
+/////////////
+// Reading //
+/////////////
+
+struct Cursor
+{
+    const char* pos;
+    const char* end;
+};
+
+static
+bool ReadRaw(Cursor* c, void* dst, size_t size)
+{
+    if ((size_t)(c->end - c->pos) < size) {
+        return false;
+    }
+    memcpy(dst, c->pos, size);
+    c->pos += size;
+    return true;
+}
+
+static
+bool ReadString(Cursor* c, std::string* s)
+{
+    uint64_t size;
+    if (!ReadRaw(c, &size, sizeof(size)) ||
+        (size_t)(c->end - c->pos) < size)
+    {
+        return false;
+    }
+    s->assign(c->pos, size);
+    c->pos += size;
+    return true;
+}
+
+static
+bool ReadIndex(Cursor* c, int64_t* index)
+{
+    return ReadRaw(c, index, sizeof(*index));
+}
+
+static
+bool ReadPose(Cursor* c, Affine3* pose)
+{
+    return ReadRaw(c, pose->matrix().data(), 16 * sizeof(double));
+}
+
+// Read an index and convert it to a pointer into an array of \p size
+// elements starting at \p base. -1 decodes to null; anything else out of
+// bounds fails.
+template <class T>
+static
+bool ReadRef(Cursor* c, T* base, uint64_t size, T** out)
+{
+    int64_t index;
+    if (!ReadIndex(c, &index) || index < -1 || index >= (int64_t)size) {
+        return false;
+    }
+    *out = index == -1 ? NULL : base + index;
+    return true;
+}
+
+static
+bool ReadShapeRef(Cursor* c, RobotModel* model, Shape** out)
+{
+    uint32_t type;
+    int64_t index;
+    if (!ReadRaw(c, &type, sizeof(type)) || !ReadIndex(c, &index)) {
+        return false;
+    }
+    if (type == (uint32_t)-1) {
+        *out = NULL;
+        return index == -1;
+    }
+    if (index < 0) {
+        return false;
+    }
+    switch ((ShapeType)type) {
+    case ShapeType::Sphere:
+        if (index >= (int64_t)model->spheres.size()) return false;
+        *out = &model->spheres[index];
+        return true;
+    case ShapeType::Box:
+        if (index >= (int64_t)model->boxes.size()) return false;
+        *out = &model->boxes[index];
+        return true;
+    case ShapeType::Cylinder:
+        if (index >= (int64_t)model->cylinders.size()) return false;
+        *out = &model->cylinders[index];
+        return true;
+    case ShapeType::Mesh:
+        if (index >= (int64_t)model->meshes.size()) return false;
+        *out = &model->meshes[index];
+        return true;
+    default:
+        return false;
+    }
+}
+
+static
+bool ReadRobotModel(Cursor* c, RobotModel* out)
+{
+    ModelFileHeader header;
+    if (!ReadRaw(c, &header, sizeof(header))) {
+        return false;
+    }
+    if (memcmp(header.magic, g_model_magic, sizeof(g_model_magic)) != 0 ||
+        header.version != 1)
+    {
+        return false;
+    }
+
+    RobotModel model;
+
+    // size all arrays up front so references into them remain stable
+    model.links.resize(header.num_links);
+    model.joints.resize(header.num_joints);
+    model.variables.resize(header.num_variables);
+    model.spheres.resize(header.num_spheres);
+    model.boxes.resize(header.num_boxes);
+    model.cylinders.resize(header.num_cylinders);
+    model.meshes.resize(header.num_meshes);
+    model.collisions.resize(header.num_collisions);
+    model.visuals.resize(header.num_visuals);
+    model.ancestor_map.resize(header.ancestor_map_size);
+
+    bool ok = ReadString(c, &model.name);
+
+    for (size_t i = 0; ok && i < model.links.size(); ++i) {
+        Link& link = model.links[i];
+        int64_t vfirst, vcount, cfirst, ccount;
+        ok = ReadString(c, &link.name) &&
+                ReadRef(c, model.joints.data(), header.num_joints, &link.parent) &&
+                ReadRef(c, model.joints.data(), header.num_joints, &link.children) &&
+                ReadIndex(c, &vfirst) && ReadIndex(c, &vcount) &&
+                ReadIndex(c, &cfirst) && ReadIndex(c, &ccount);
+        ok = ok && vfirst >= 0 && vcount >= 0 &&
+                (uint64_t)(vfirst + vcount) <= header.num_visuals &&
+                cfirst >= 0 && ccount >= 0 &&
+                (uint64_t)(cfirst + ccount) <= header.num_collisions;
+        if (ok) {
+            LinkVisual* v = model.visuals.data() + vfirst;
+            LinkCollision* cb = model.collisions.data() + cfirst;
+            link.visual = make_range(v, v + vcount);
+            link.collision = make_range(cb, cb + ccount);
+        }
+    }
+
+    for (size_t i = 0; ok && i < model.joints.size(); ++i) {
+        Joint& joint = model.joints[i];
+        uint32_t type;
+        ok = ReadString(c, &joint.name) &&
+                ReadRaw(c, &type, sizeof(type)) &&
+                ReadPose(c, &joint.origin) &&
+                ReadRaw(c, joint.axis.data(), 3 * sizeof(double)) &&
+                ReadRef(c, model.variables.data(), header.num_variables + 1, &joint.vfirst) &&
+                ReadRef(c, model.variables.data(), header.num_variables + 1, &joint.vlast) &&
+                ReadRef(c, model.links.data(), header.num_links, &joint.child) &&
+                ReadRef(c, model.links.data(), header.num_links, &joint.parent) &&
+                ReadRef(c, model.joints.data(), header.num_joints, &joint.sibling);
+        joint.type = (JointType)type;
+    }
+
+    for (size_t i = 0; ok && i < model.variables.size(); ++i) {
+        JointVariable& v = model.variables[i];
+        uint8_t has_limits;
+        ok = ReadString(c, &v.name) &&
+                ReadRaw(c, &has_limits, sizeof(has_limits)) &&
+                ReadRaw(c, &v.limits.min_position, sizeof(double)) &&
+                ReadRaw(c, &v.limits.max_position, sizeof(double)) &&
+                ReadRaw(c, &v.limits.max_velocity, sizeof(double)) &&
+                ReadRaw(c, &v.limits.max_effort, sizeof(double)) &&
+                ReadRef(c, model.joints.data(), header.num_joints, &v.joint);
+        v.limits.has_position_limits = has_limits != 0;
+    }
+
+    for (size_t i = 0; ok && i < model.spheres.size(); ++i) {
+        ok = ReadRaw(c, &model.spheres[i].radius, sizeof(double));
+    }
+    for (size_t i = 0; ok && i < model.boxes.size(); ++i) {
+        ok = ReadRaw(c, model.boxes[i].size.data(), 3 * sizeof(double));
+    }
+    for (size_t i = 0; ok && i < model.cylinders.size(); ++i) {
+        ok = ReadRaw(c, &model.cylinders[i].height, sizeof(double)) &&
+                ReadRaw(c, &model.cylinders[i].radius, sizeof(double));
+    }
+    for (size_t i = 0; ok && i < model.meshes.size(); ++i) {
+        ok = ReadString(c, &model.meshes[i].filename) &&
+                ReadRaw(c, model.meshes[i].scale.data(), 3 * sizeof(double));
+    }
+
+    for (size_t i = 0; ok && i < model.collisions.size(); ++i) {
+        LinkCollision& cb = model.collisions[i];
+        ok = ReadPose(c, &cb.origin) &&
+                ReadShapeRef(c, &model, &cb.shape) &&
+                ReadRef(c, model.links.data(), header.num_links, &cb.link);
+    }
+    for (size_t i = 0; ok && i < model.visuals.size(); ++i) {
+        LinkVisual& v = model.visuals[i];
+        ok = ReadPose(c, &v.origin) &&
+                ReadShapeRef(c, &model, &v.shape) &&
+                ReadRef(c, model.links.data(), header.num_links, &v.link);
+    }
+
+    for (size_t i = 0; ok && i < model.ancestor_map.size(); ++i) {
+        Joint* joint;
+        ok = ReadRef(c, model.joints.data(), header.num_joints, &joint);
+        model.ancestor_map[i] = joint;
+    }
+
+    if (ok) {
+        ok = header.root_link >= -1 &&
+                header.root_link < (int64_t)header.num_links &&
+                header.root_joint >= -1 &&
+                header.root_joint < (int64_t)header.num_joints;
+    }
+    if (ok) {
+        model.root_link = header.root_link == -1 ?
+                NULL : &model.links[header.root_link];
+        model.root_joint = header.root_joint == -1 ?
+                NULL : &model.joints[header.root_joint];
+        *out = std::move(model);
+    }
+    return ok;
+}
+
+bool LoadRobotModel(RobotModel* model, const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ModelFileHeader)) {
+        fprintf(stderr, "'%s' is not a robot model file\n", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    const size_t file_size = (size_t)st.st_size;
+    void* mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "Failed to map '%s'\n", path.c_str());
+        return false;
+    }
+
+    Cursor cursor;
+    cursor.pos = (const char*)mapping;
+    cursor.end = cursor.pos + file_size;
+
+    bool ok = ReadRobotModel(&cursor, model);
+    munmap(mapping, file_size);
+
+    if (!ok) {
+        fprintf(stderr, "'%s' is truncated or malformed\n", path.c_str());
+    }
+    return ok;
+}
+
+/////////////
+// Caching //
+/////////////
+
+static
+auto HashBytes(uint64_t h, const void* data, size_t size) -> uint64_t
+{
+    // FNV-1a
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= (uint64_t)p[i];
+        h *= UINT64_C(0x100000001B3);
+    }
+    return h;
+}
+
+auto HashRobotModelInputs(
+    const std::string& urdf_string,
+    const JointSpec* world_joint,
+    bool use_safety_limits)
+    -> uint64_t
+{
+    uint64_t h = UINT64_C(0xCBF29CE484222325);
+    h = HashBytes(h, urdf_string.data(), urdf_string.size());
+
+    const uint8_t have_world_joint = world_joint != NULL ? 1 : 0;
+    h = HashBytes(h, &have_world_joint, sizeof(have_world_joint));
+    if (world_joint != NULL) {
+        h = HashBytes(h, world_joint->name.data(), world_joint->name.size());
+        const uint32_t type = (uint32_t)world_joint->type;
+        h = HashBytes(h, &type, sizeof(type));
+        h = HashBytes(h, world_joint->origin.matrix().data(), 16 * sizeof(double));
+        h = HashBytes(h, world_joint->axis.data(), 3 * sizeof(double));
+    }
+
+    const uint8_t safety = use_safety_limits ? 1 : 0;
+    h = HashBytes(h, &safety, sizeof(safety));
+    return h;
+}
+
+auto GetCachedRobotModelPath(const std::string& cache_dir, uint64_t key)
+    -> std::string
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".model", key);
+    return cache_dir + "/" + name;
+}
+
+bool LoadCachedRobotModel(
+    RobotModel* model,
+    const std::string& cache_dir,
+    const std::string& urdf_string,
+    const JointSpec* world_joint,
+    bool use_safety_limits)
+{
+    const uint64_t key =
+            HashRobotModelInputs(urdf_string, world_joint, use_safety_limits);
+    const std::string path = GetCachedRobotModelPath(cache_dir, key);
+
+    // a missing entry is an ordinary cache miss
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+
+    return LoadRobotModel(model, path);
+}
+
+bool StoreCachedRobotModel(
+    const RobotModel* model,
+    const std::string& cache_dir,
+    const std::string& urdf_string,
+    const JointSpec* world_joint,
+    bool use_safety_limits)
+{
+    (void)mkdir(cache_dir.c_str(), 0755);
+
+    const uint64_t key =
+            HashRobotModelInputs(urdf_string, world_joint, use_safety_limits);
+    return SaveRobotModel(model, GetCachedRobotModelPath(cache_dir, key));
+}
+
+} // namespace urdf
+} // namespace smpl
@@ -90,6 +90,41 @@ void GetTransformVariables(
     }
 }
 
+enum DirtyChannel
+{
+    DIRTY_LINKS         = 1,
+    DIRTY_COLLISIONS    = 2,
+    DIRTY_VISUALS       = 4,
+    DIRTY_ALL           = DIRTY_LINKS | DIRTY_COLLISIONS | DIRTY_VISUALS,
+};
+
+// Record a joint as dirty on all transform channels.
+static
+void MarkJointDirty(RobotState* state, const Joint* joint)
+{
+    auto& bits = state->joint_dirty[GetJointIndex(state->model, joint)];
+    if (bits == 0) {
+        state->dirty_joints.push_back(joint);
+    }
+    bits = DIRTY_ALL;
+}
+
+// Drop joints whose flags have been cleared on every channel from the dirty
+// set.
+static
+void PruneCleanJoints(RobotState* state)
+{
+    auto clean = [state](const Joint* joint) {
+        return state->joint_dirty[GetJointIndex(state->model, joint)] == 0;
+    };
+    state->dirty_joints.erase(
+            std::remove_if(
+                    state->dirty_joints.begin(),
+                    state->dirty_joints.end(),
+                    clean),
+            state->dirty_joints.end());
+}
+
 bool InitRobotState(
     RobotState* out,
     const RobotModel* model,
@@ -139,6 +174,10 @@ bool InitRobotState(
     out->dirty_collisions_joint = model->root_joint;
     out->dirty_visuals_joint = model->root_joint;
 
+    out->dirty_joints.clear();
+    out->joint_dirty.assign(GetJointCount(model), 0);
+    MarkJointDirty(out, model->root_joint);
+
     return true;
 }
 
@@ -161,9 +200,80 @@ void SetToDefaultValues(RobotState* state)
 // 3 dirty joints...for collision bodies, visual bodies, and links.
 void SetVariablePositions(RobotState* state, const double* positions)
 {
-    for (int i = 0; i < GetVariableCount(state->model); ++i) {
-        SetVariablePosition(state, i, positions[i]);
+    SetVariablePositions(state, positions, GetVariableCount(state->model));
+}
+
+// Write a batch of variable positions in one pass, gathering the common root
+// of all joints with changed variables, then fold that union into each dirty
+// transform channel once instead of once per variable. When indices is null,
+// the positions address the first count variables in order.
+static
+void SetVariablePositionsBulk(
+    RobotState* state,
+    const int* indices,
+    const double* positions,
+    int count)
+{
+    const Joint* changed = NULL;
+    const Joint* prev = NULL;
+    for (int i = 0; i < count; ++i) {
+        const int vidx = indices ? indices[i] : i;
+        if (state->positions[vidx] == positions[i]) {
+            continue;
+        }
+        state->positions[vidx] = positions[i];
+
+        auto* vj = GetJointOfVariable(GetVariable(state->model, vidx));
+        if (vj == prev) {
+            continue; // consecutive variables of a multi-dof joint
+        }
+        prev = vj;
+
+        MarkJointDirty(state, vj);
+
+        if (changed == NULL) {
+            changed = vj;
+        } else if (changed != vj) {
+            changed = GetCommonRoot(state->model, changed, vj);
+        }
     }
+
+    if (changed == NULL) {
+        return; // no variable changed value
+    }
+
+    if (state->dirty_links_joint == NULL) {
+        state->dirty_links_joint = changed;
+    } else {
+        state->dirty_links_joint = GetCommonRoot(state->model, state->dirty_links_joint, changed);
+    }
+    if (state->dirty_collisions_joint == NULL) {
+        state->dirty_collisions_joint = changed;
+    } else {
+        state->dirty_collisions_joint = GetCommonRoot(state->model, state->dirty_collisions_joint, changed);
+    }
+    if (state->dirty_visuals_joint == NULL) {
+        state->dirty_visuals_joint = changed;
+    } else {
+        state->dirty_visuals_joint = GetCommonRoot(state->model, state->dirty_visuals_joint, changed);
+    }
+}
+
+void SetVariablePositions(
+    RobotState* state,
+    const double* positions,
+    int count)
+{
+    SetVariablePositionsBulk(state, NULL, positions, count);
+}
+
+void SetVariablePositions(
+    RobotState* state,
+    const int* indices,
+    const double* positions,
+    int count)
+{
+    SetVariablePositionsBulk(state, indices, positions, count);
 }
 
 void SetVariablePosition(
@@ -203,6 +313,8 @@ void SetVariablePosition(
         } else {
             state->dirty_visuals_joint = GetCommonRoot(state->model, state->dirty_visuals_joint, vj);
         }
+
+        MarkJointDirty(state, vj);
     }
 }
 
@@ -419,39 +531,51 @@ void UpdateLinkTransforms(RobotState* state, std::vector<const Joint*>* q)
 {
     assert(state->dirty_links_joint != NULL);
 
-    q->push_back(state->dirty_links_joint);
-
-    while (!q->empty()) {
-        auto* joint = q->back();
-        q->pop_back();
-
-        auto* child_link = joint->child;
-
-        // update the joint transform
-        auto& joint_transform =
-                state->joint_transforms[GetJointIndex(state->model, joint)];
-        joint_transform =
-                ComputeJointTransform(joint, GetJointPositions(state, joint));
-
-        // update the child link transform
-        auto& link_transform =
-                state->link_transforms[GetLinkIndex(state->model, child_link)];
-        if (joint->parent != NULL) {
-            // parent_link * origin * joint transform
-            auto& parent_transform =
-                    state->link_transforms[
-                            GetLinkIndex(state->model, joint->parent)];
-            link_transform = parent_transform * joint->origin * joint_transform;
-        } else {
-            link_transform = joint->origin * joint_transform;
+    // visit each dirtied subtree; a subtree rooted beneath another dirty
+    // joint has its flags cleared during that joint's traversal and is
+    // skipped when its own turn comes
+    for (auto* dirty : state->dirty_joints) {
+        if (!(state->joint_dirty[GetJointIndex(state->model, dirty)] & DIRTY_LINKS)) {
+            continue;
         }
 
-        // recurse on children
-        for (auto* child = child_link->children; child != NULL; child = child->sibling) {
-            q->push_back(child);
+        q->push_back(dirty);
+
+        while (!q->empty()) {
+            auto* joint = q->back();
+            q->pop_back();
+
+            auto jidx = GetJointIndex(state->model, joint);
+            state->joint_dirty[jidx] &= ~DIRTY_LINKS;
+
+            auto* child_link = joint->child;
+
+            // update the joint transform
+            auto& joint_transform = state->joint_transforms[jidx];
+            joint_transform =
+                    ComputeJointTransform(joint, GetJointPositions(state, joint));
+
+            // update the child link transform
+            auto& link_transform =
+                    state->link_transforms[GetLinkIndex(state->model, child_link)];
+            if (joint->parent != NULL) {
+                // parent_link * origin * joint transform
+                auto& parent_transform =
+                        state->link_transforms[
+                                GetLinkIndex(state->model, joint->parent)];
+                link_transform = parent_transform * joint->origin * joint_transform;
+            } else {
+                link_transform = joint->origin * joint_transform;
+            }
+
+            // recurse on children
+            for (auto* child = child_link->children; child != NULL; child = child->sibling) {
+                q->push_back(child);
+            }
         }
     }
 
+    PruneCleanJoints(state);
     state->dirty_links_joint = NULL;
 }
 
@@ -461,25 +585,34 @@ void UpdateOnlyCollisionBodyTransforms(
     std::vector<const Joint*>* q)
 {
     assert(state->dirty_collisions_joint != NULL);
-    q->push_back(state->dirty_collisions_joint);
-    while (!q->empty()) {
-        auto* joint = q->back();
-        q->pop_back();
-
-        auto* child_link = joint->child;
-
-        auto& link_transform =
-                state->link_transforms[GetLinkIndex(state->model, child_link)];
-        for (auto& collision : CollisionBodies(child_link)) {
-            auto& collision_transform =
-                    state->link_collision_transforms[
-                            GetCollisionBodyIndex(state->model, &collision)];
-            collision_transform = link_transform * collision.origin;
+    for (auto* dirty : state->dirty_joints) {
+        if (!(state->joint_dirty[GetJointIndex(state->model, dirty)] & DIRTY_COLLISIONS)) {
+            continue;
         }
-        for (auto* child = child_link->children; child != NULL; child = child->sibling) {
-            q->push_back(child);
+        q->push_back(dirty);
+        while (!q->empty()) {
+            auto* joint = q->back();
+            q->pop_back();
+
+            state->joint_dirty[GetJointIndex(state->model, joint)] &=
+                    ~DIRTY_COLLISIONS;
+
+            auto* child_link = joint->child;
+
+            auto& link_transform =
+                    state->link_transforms[GetLinkIndex(state->model, child_link)];
+            for (auto& collision : CollisionBodies(child_link)) {
+                auto& collision_transform =
+                        state->link_collision_transforms[
+                                GetCollisionBodyIndex(state->model, &collision)];
+                collision_transform = link_transform * collision.origin;
+            }
+            for (auto* child = child_link->children; child != NULL; child = child->sibling) {
+                q->push_back(child);
+            }
         }
     }
+    PruneCleanJoints(state);
     state->dirty_collisions_joint = NULL;
 }
 
@@ -489,25 +622,34 @@ void UpdateOnlyVisualBodyTransforms(
     std::vector<const Joint*>* q)
 {
     assert(state->dirty_visuals_joint != NULL);
-    q->push_back(state->dirty_visuals_joint);
-    while (!q->empty()) {
-        auto* joint = q->back();
-        q->pop_back();
-
-        auto* child_link = joint->child;
-
-        auto& link_transform =
-                state->link_transforms[GetLinkIndex(state->model, child_link)];
-        for (auto& visual : VisualBodies(child_link)) {
-            auto& visual_transform =
-                    state->link_visual_transforms[
-                            GetVisualBodyIndex(state->model, &visual)];
-            visual_transform = link_transform * visual.origin;
+    for (auto* dirty : state->dirty_joints) {
+        if (!(state->joint_dirty[GetJointIndex(state->model, dirty)] & DIRTY_VISUALS)) {
+            continue;
         }
-        for (auto* child = child_link->children; child != NULL; child = child->sibling) {
-            q->push_back(child);
+        q->push_back(dirty);
+        while (!q->empty()) {
+            auto* joint = q->back();
+            q->pop_back();
+
+            state->joint_dirty[GetJointIndex(state->model, joint)] &=
+                    ~DIRTY_VISUALS;
+
+            auto* child_link = joint->child;
+
+            auto& link_transform =
+                    state->link_transforms[GetLinkIndex(state->model, child_link)];
+            for (auto& visual : VisualBodies(child_link)) {
+                auto& visual_transform =
+                        state->link_visual_transforms[
+                                GetVisualBodyIndex(state->model, &visual)];
+                visual_transform = link_transform * visual.origin;
+            }
+            for (auto* child = child_link->children; child != NULL; child = child->sibling) {
+                q->push_back(child);
+            }
         }
     }
+    PruneCleanJoints(state);
     state->dirty_visuals_joint = NULL;
 }
 
@@ -84,12 +84,13 @@ void SetReferenceState(URDFRobotModel* model, const double* positions)
 static
 void UpdateState(URDFRobotModel* model, const smpl::RobotState* state)
 {
-    for (auto i = 0; i < model->jointVariableCount(); ++i) {
-        SetVariablePosition(
-                &model->robot_state,
-                model->planning_to_state_variable[i],
-                (*state)[i]);
-    }
+    // one bulk write with a single dirty propagation step for the whole
+    // configuration
+    SetVariablePositions(
+            &model->robot_state,
+            model->planning_to_state_variable.data(),
+            state->data(),
+            model->jointVariableCount());
 }
 
 auto URDFRobotModel::computeFK(const smpl::RobotState& state)
@@ -100,6 +101,18 @@ auto URDFRobotModel::computeFK(const smpl::RobotState& state)
     return *GetLinkTransform(&this->robot_state, this->planning_link);
 }
 
+void URDFRobotModel::computeFKBatch(
+    const std::vector<smpl::RobotState>& states,
+    std::vector<Eigen::Affine3d, Eigen::aligned_allocator<Eigen::Affine3d>>& poses)
+{
+    poses.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        UpdateState(this, &states[i]);
+        UpdateLinkTransform(&this->robot_state, this->planning_link);
+        poses[i] = *GetLinkTransform(&this->robot_state, this->planning_link);
+    }
+}
+
 double URDFRobotModel::minPosLimit(int jidx) const
 {
     return this->vprops[jidx].min_position;